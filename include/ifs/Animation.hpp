@@ -0,0 +1,122 @@
+#pragma once
+
+#include "Sweep.hpp"
+#include "backends/AffineIFS.hpp"
+#include <glm/glm.hpp>
+#include <expected>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ifs {
+
+class Camera3D;
+
+/**
+ * @brief Orbit camera state of a keyframe
+ */
+struct CameraPose {
+    glm::vec3 target{0.5f, 0.5f, 0.0f};  ///< Camera3D's defaults
+    float distance = 1.5f;
+    float azimuth = -90.0f;               ///< Degrees
+    float elevation = -35.0f;             ///< Degrees
+
+    bool operator==(const CameraPose&) const = default;
+
+    [[nodiscard]] static CameraPose from(const Camera3D& camera);
+    void apply(Camera3D& camera) const;
+
+    /// The pose as sweep overrides (for HeadlessSession::render)
+    [[nodiscard]] SweepCamera sweep_camera() const;
+};
+
+/**
+ * @brief Full state of the animation at one time
+ */
+struct AnimationFrame {
+    AffineIFSDefinition ifs;
+    CameraPose camera;
+    float scale = 1.0f;  ///< IFSParameters::scale
+};
+
+/**
+ * @brief State pinned at a point in time
+ */
+struct Keyframe {
+    float time = 0.0f;  ///< Seconds
+    AnimationFrame frame;
+};
+
+/**
+ * @brief Keyframes interpolated with Catmull-Rom splines
+ *
+ * Every map coefficient, weight and color, the scale and the camera pose are
+ * interpolated independently through the neighbouring keyframes, so motion is
+ * C1-continuous across keyframes. The curve is clamped at both ends.
+ *
+ * Keyframes may have different map counts: a map missing from a keyframe is
+ * taken from a neighbour with weight 0, so it fades in or out instead of
+ * popping. Azimuths take the short way around.
+ */
+class Timeline {
+public:
+    /**
+     * @brief Insert a keyframe, replacing one at the same time
+     */
+    void add(Keyframe keyframe);
+
+    /**
+     * @brief Remove the keyframe at an index (ignored if out of range)
+     */
+    void remove(size_t index);
+
+    void clear() { m_keyframes.clear(); }
+
+    [[nodiscard]] const std::vector<Keyframe>& keyframes() const { return m_keyframes; }
+    [[nodiscard]] bool empty() const { return m_keyframes.empty(); }
+
+    /// Time of the last keyframe (0 when empty)
+    [[nodiscard]] float duration() const { return m_keyframes.empty() ? 0.0f : m_keyframes.back().time; }
+
+    /**
+     * @brief Interpolated state at a time (clamped to the keyframe range)
+     *
+     * @return Frame, or nothing if the timeline has no keyframes
+     */
+    [[nodiscard]] std::optional<AnimationFrame> sample(float time) const;
+
+    /**
+     * @brief Write the timeline in the format parse_timeline() reads
+     */
+    [[nodiscard]] std::string serialize() const;
+
+private:
+    std::vector<Keyframe> m_keyframes;  ///< Sorted by time
+};
+
+/**
+ * @brief Parse a timeline description
+ *
+ * One keyframe per line; blank lines and lines starting with '#' are skipped.
+ * A line is a list of whitespace-separated key=value pairs and starts from
+ * the previous keyframe, so only what changes needs to be written:
+ *
+ *   t=0 preset=sierpinski_triangle camera.azimuth=-90
+ *   t=4 map1=0.5,0.1,0,0,0.5,0,0,0,0.5,0.5,0,0 camera.azimuth=0
+ *
+ * Keys:
+ * - t: keyframe time in seconds (required, increasing)
+ * - preset: replace all maps with a preset (see AffineIFSDefinition::preset_names())
+ * - scale: IFSParameters scale
+ * - mapN: 12 comma-separated numbers, the row-major 3x3 linear part followed by
+ *   the offset; N may equal the current map count to append a map
+ * - weightN, colorN (r,g,b): weight and color of an existing map
+ * - maps: truncate to this many maps
+ * - camera.distance, camera.azimuth, camera.elevation, camera.target (x,y,z)
+ *
+ * @return Timeline or an error naming the offending line
+ */
+[[nodiscard]] std::expected<Timeline, std::string> parse_timeline(std::string_view text);
+
+} // namespace ifs
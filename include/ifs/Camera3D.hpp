@@ -6,6 +6,7 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <cstdint>
+#include <utility>
 
 namespace ifs {
 
@@ -19,6 +20,8 @@ namespace ifs {
  * - Perspective projection
  * - Automatic aspect ratio handling
  * - Lazy matrix computation with dirty flags
+ * - A double-precision frame for deep zoom: everything the camera handles is
+ *   local, world = anchor + extent * local
  */
 class Camera3D : public Camera {
 public:
@@ -55,6 +58,15 @@ public:
      */
     [[nodiscard]] glm::vec3 position();
 
+    /**
+     * @brief World-space ray through a pixel (e.g. the mouse cursor)
+     *
+     * @param pixel Pixel position, origin at the top-left corner of the viewport
+     * @param viewport Viewport size in pixels
+     * @return Ray origin (camera position) and normalized direction
+     */
+    [[nodiscard]] std::pair<glm::vec3, glm::vec3> screen_ray(const glm::vec2& pixel, const glm::vec2& viewport);
+
     /**
      * @brief Handle mouse drag for orbit rotation
      *
@@ -132,7 +144,32 @@ public:
     void set_move_speed(float speed);
 
     /**
-     * @brief Reset camera to default parameters
+     * @brief Set the high-precision frame the camera's coordinates are relative to
+     *
+     * Renderers get positions in the same local frame (AffineIFS deep zoom),
+     * so float precision only has to resolve the view, not the world.
+     *
+     * @param anchor World position of the local origin
+     * @param extent World size of one local unit
+     */
+    void set_frame(const glm::dvec3& anchor, double extent);
+
+    /**
+     * @brief Zoom the frame by `factor` around the target
+     *
+     * The target becomes the anchor (local origin) and one local unit shrinks
+     * by `factor`, so the view magnifies by `factor` without moving the camera.
+     */
+    void zoom_frame(double factor);
+
+    /// World position of a local point, in double precision
+    [[nodiscard]] glm::dvec3 to_world(const glm::vec3& local) const;
+
+    /// Local position of a world point
+    [[nodiscard]] glm::vec3 to_local(const glm::dvec3& world) const;
+
+    /**
+     * @brief Reset camera to default parameters (and the identity frame)
      */
     void reset();
 
@@ -142,7 +179,10 @@ public:
     [[nodiscard]] float distance() const;
     [[nodiscard]] float azimuth() const;
     [[nodiscard]] float elevation() const;
+    [[nodiscard]] float fov() const;  ///< Vertical field of view (degrees)
     [[nodiscard]] float move_speed() const;
+    [[nodiscard]] glm::dvec3 anchor() const;
+    [[nodiscard]] double extent() const;
 
 private:
     /**
@@ -161,6 +201,10 @@ private:
     float m_azimuth;          ///< Horizontal rotation (degrees)
     float m_elevation;        ///< Vertical rotation (degrees)
 
+    // High-precision frame: world = anchor + extent * local
+    glm::dvec3 m_anchor;
+    double m_extent;
+
     // Movement parameters
     float m_move_speed;       ///< Movement speed in units per second
 
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "Animation.hpp"
+#include "IFSBackend.hpp"
+#include "UICallback.hpp"
+#include <expected>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ifs {
+
+class HeadlessSession;
+
+/**
+ * @brief Everything that determined one recorded frame
+ */
+struct CameraPathFrame {
+    double time = 0.0;         ///< Seconds since the recording started (informational; replay is not paced)
+    CameraPose camera;
+    float scale = 1.0f;        ///< IFSParameters::scale
+    uint32_t random_seed = 0;  ///< IFSParameters::random_seed
+    /// UI parameters changed since the previous frame, in the order they were set (find_ui_callback() names)
+    std::vector<std::pair<std::string, float>> parameters;
+
+    bool operator==(const CameraPathFrame&) const = default;
+};
+
+/**
+ * @brief A recorded interactive session: one entry per presented frame
+ *
+ * The first frame holds every UI parameter, so a replay starts from the
+ * recorded state rather than whatever the replaying session was left in.
+ */
+class CameraPath {
+public:
+    void add(CameraPathFrame frame) { m_frames.push_back(std::move(frame)); }
+    void clear() { m_frames.clear(); }
+
+    [[nodiscard]] const std::vector<CameraPathFrame>& frames() const { return m_frames; }
+    [[nodiscard]] bool empty() const { return m_frames.empty(); }
+    [[nodiscard]] double duration() const { return m_frames.empty() ? 0.0 : m_frames.back().time; }
+
+    /**
+     * @brief Write the path in the format parse_camera_path() reads
+     */
+    [[nodiscard]] std::string serialize() const;
+
+private:
+    std::vector<CameraPathFrame> m_frames;
+};
+
+/**
+ * @brief Parse a recorded camera path
+ *
+ * One frame per line; blank lines and lines starting with '#' are skipped.
+ * A line is a list of whitespace-separated key=value pairs and starts from
+ * the previous frame's camera, scale and seed, so only what changes needs to
+ * be written:
+ *
+ *   t=0 seed=1 scale=1 camera.distance=1.5 param.Iteration_Count=40
+ *   t=0.016 camera.azimuth=-88.5
+ *
+ * Keys:
+ * - t: seconds since the recording started (required, non-decreasing)
+ * - seed, scale: IFSParameters fields
+ * - camera.distance, camera.azimuth, camera.elevation, camera.target (x,y,z)
+ * - param.<Field>: UI parameter set before the frame ('_' matches a space)
+ *
+ * @return Path or an error naming the offending line
+ */
+[[nodiscard]] std::expected<CameraPath, std::string> parse_camera_path(std::string_view text);
+
+/**
+ * @brief Records camera poses and parameter changes frame by frame
+ *
+ * Parameters are compared against their values at the previous frame, so
+ * changes are captured whatever made them (UI, animation, scripts).
+ */
+class CameraPathRecorder {
+public:
+    /**
+     * @brief Append a frame
+     *
+     * @param time Seconds since the recording started
+     * @param camera Camera pose of the frame
+     * @param params Seed and scale of the frame
+     * @param callbacks UI parameters of the backend and frontend
+     */
+    void record(double time, const CameraPose& camera, const IFSParameters& params, const std::vector<UICallback>& callbacks);
+
+    [[nodiscard]] const CameraPath& path() const { return m_path; }
+
+    /// Hand over the path and start a new recording
+    [[nodiscard]] CameraPath take();
+
+private:
+    CameraPath m_path;
+    std::vector<std::pair<std::string, float>> m_values;  ///< Parameters at the previous frame
+};
+
+/**
+ * @brief Timings of one replayed frame
+ */
+struct FrameTiming {
+    uint32_t frame = 0;
+    bool recomputed = false;      ///< The backend ran for this frame (seed, scale or a parameter changed)
+    double frame_ms = 0.0;        ///< CPU wall time of the whole frame
+    double compute_ms = 0.0;      ///< CPU wall time of the backend compute (0 if not recomputed)
+    double compute_gpu_ms = 0.0;  ///< ComputeStats::gpu_ms of the compute (0 if unavailable)
+};
+
+/**
+ * @brief Percentiles of the frame times of a replay
+ */
+struct ReplaySummary {
+    size_t frames = 0;
+    size_t recomputes = 0;
+    double mean_ms = 0.0;
+    double p50_ms = 0.0;
+    double p95_ms = 0.0;
+    double p99_ms = 0.0;
+    double max_ms = 0.0;
+};
+
+[[nodiscard]] ReplaySummary summarize_replay(const std::vector<FrameTiming>& timings);
+
+/**
+ * @brief Write one CSV row per frame (frame, recomputed, frame_ms, compute_ms, compute_gpu_ms)
+ */
+[[nodiscard]] bool write_frame_timings(const std::filesystem::path& path, const std::vector<FrameTiming>& timings);
+
+/**
+ * @brief Set recorded parameters through the matching callbacks, in order
+ *
+ * @return The parameters that matched no callback
+ */
+std::vector<std::pair<std::string, float>> apply_path_parameters(
+    std::span<const std::pair<std::string, float>> parameters,
+    const std::vector<UICallback>& callbacks
+);
+
+/**
+ * @brief Replay a path offscreen, as fast as the GPU allows
+ *
+ * Every frame applies the recorded parameters, computes when the seed, scale
+ * or a parameter changed, and renders at the recorded camera. Calls block
+ * until the GPU is done, so each frame's time is its full cost and runs of
+ * the same path are comparable across builds.
+ *
+ * @return One timing per frame, or the first error
+ */
+[[nodiscard]] std::expected<std::vector<FrameTiming>, std::string> replay_camera_path(HeadlessSession& session, const CameraPath& path);
+
+} // namespace ifs
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "VulkanContext.hpp"
+#include "TimestampProfiler.hpp"
+#include <expected>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ifs {
+
+/**
+ * @brief Contiguous range of work items handled by one dispatch
+ *
+ * Layout matches the `DispatchChunk` push constant in shaders/ifs_modular/common.slang.
+ */
+struct ComputeChunk {
+    uint32_t first;  ///< Index of the first work item
+    uint32_t count;  ///< Number of work items in this chunk
+};
+
+/**
+ * @brief Timing of the last scheduled workload (from the timestamp profiler)
+ */
+struct ComputeStats {
+    uint32_t queue_count = 0;            ///< Queues that received at least one chunk
+    uint32_t chunk_count = 0;            ///< Chunks the workload was split into
+    double gpu_ms = 0.0;                 ///< First chunk start to last chunk end, across all queues
+    std::vector<double> queue_busy_ms;   ///< Summed chunk time per queue
+};
+
+/**
+ * @brief Splits chunked compute dispatches across all queues of the compute family
+ *
+ * Owns one command pool, command buffer and semaphore per compute queue
+ * (see VulkanContext::compute_queues()). A workload of N items is cut into
+ * chunks which are distributed round-robin over the queues and submitted
+ * without host synchronization between them. Queue 0 joins the others with a
+ * semaphore wait and then records the caller's finalize commands (e.g. the
+ * ownership release barrier), so the fence signalled by submit() covers the
+ * whole workload. Prepare commands (e.g. an ownership acquire barrier) run
+ * once on queue 0 before any chunk; the other queues wait for them.
+ *
+ * On devices that expose a single compute queue this degenerates to the old
+ * "one command buffer, one fence" path.
+ */
+class ComputeScheduler {
+public:
+    /// Records the dispatch for one chunk (push constants + vkCmdDispatch)
+    using RecordChunkFn = std::function<void(vk::CommandBuffer, const ComputeChunk&)>;
+    /// Records commands that must run after every chunk has finished
+    using FinalizeFn = std::function<void(vk::CommandBuffer)>;
+    /// Records commands that must run before any chunk starts
+    using PrepareFn = std::function<void(vk::CommandBuffer)>;
+
+    /**
+     * @brief Create a scheduler for the context's compute queues
+     *
+     * @param context Vulkan context
+     * @param max_chunks Upper bound of chunks per workload (also sizes the timestamp pool)
+     * @return Scheduler or error message
+     */
+    static std::expected<std::unique_ptr<ComputeScheduler>, std::string> create(
+        const VulkanContext& context,
+        uint32_t max_chunks = 64
+    );
+
+    ~ComputeScheduler();
+
+    ComputeScheduler(const ComputeScheduler&) = delete;
+    ComputeScheduler& operator=(const ComputeScheduler&) = delete;
+
+    /**
+     * @brief Split a workload into chunks and submit it to all compute queues
+     *
+     * Waits for the previous workload first. Returns immediately after submission.
+     *
+     * @param item_count Total number of work items (e.g. particles)
+     * @param record_chunk Callback recording one chunk
+     * @param finalize Optional callback recorded on queue 0 after all chunks
+     * @param prepare Optional callback recorded on queue 0 before all chunks
+     */
+    void submit(
+        uint32_t item_count,
+        const RecordChunkFn& record_chunk,
+        const FinalizeFn& finalize = {},
+        const PrepareFn& prepare = {}
+    );
+
+    /**
+     * @brief Block until the last submitted workload has finished
+     *
+     * Also resolves the timestamps of that workload into last_stats().
+     */
+    void wait();
+
+    /**
+     * @brief Stats of the last completed workload
+     */
+    [[nodiscard]] const ComputeStats& last_stats() const { return m_stats; }
+
+    /**
+     * @brief Number of compute queues work is spread across
+     */
+    [[nodiscard]] uint32_t queue_count() const { return static_cast<uint32_t>(m_lanes.size()); }
+
+    /**
+     * @brief Set the item granularity chunks are rounded to (workgroup size)
+     */
+    void set_granularity(uint32_t items) { m_granularity = items; }
+
+private:
+    explicit ComputeScheduler(const VulkanContext& context, uint32_t max_chunks);
+
+    std::expected<void, std::string> initialize();
+
+    /**
+     * @brief Compute the chunk list for a workload
+     */
+    [[nodiscard]] std::vector<ComputeChunk> make_chunks(uint32_t item_count) const;
+
+    struct Lane {
+        vk::Queue queue;
+        vk::CommandPool command_pool;
+        vk::CommandBuffer command_buffer;
+        vk::Semaphore finished;  ///< Signalled by lanes > 0, waited on by the join
+        vk::Semaphore ready;     ///< Signalled by the prepare commands, waited on by lanes > 0
+    };
+
+    const VulkanContext* m_context;
+    vk::Device m_device;
+    uint32_t m_max_chunks;
+    uint32_t m_granularity = 256;
+    uint32_t m_max_items_per_chunk;
+
+    std::vector<Lane> m_lanes;
+    vk::CommandBuffer m_join_command_buffer;     ///< Allocated from lane 0's pool
+    vk::CommandBuffer m_prepare_command_buffer;  ///< Allocated from lane 0's pool
+    vk::Fence m_fence;
+
+    std::unique_ptr<TimestampProfiler> m_profiler;
+    std::vector<uint32_t> m_chunk_lane;  ///< Lane index of each profiled chunk
+    bool m_stats_pending = false;
+    ComputeStats m_stats;
+};
+
+} // namespace ifs
@@ -0,0 +1,181 @@
+#pragma once
+
+#include "ReadbackBuffer.hpp"
+#include "Shader.hpp"
+#include "TimestampProfiler.hpp"
+#include "VulkanContext.hpp"
+#include <glm/glm.hpp>
+#include <array>
+#include <expected>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace ifs {
+
+/**
+ * @brief Bounds and per-level box counts written by the GPU (matches BoxCountState in box_count.slang)
+ */
+struct BoxCountState {
+    static constexpr uint32_t MAX_LEVELS = 12;
+
+    glm::uvec4 bounds_min;  ///< Encoded bounds, only meaningful on the GPU
+    glm::uvec4 bounds_max;
+    uint32_t boxes[MAX_LEVELS + 1];  ///< Occupied boxes per level (index = level)
+};
+static_assert(sizeof(BoxCountState) == 84, "BoxCountState must match box_count.slang");
+
+/**
+ * @brief Push constants of the box-counting kernels (matches BoxCountPush in box_count.slang)
+ */
+struct BoxCountPush {
+    glm::uvec4 counts{0};  ///< x: particles, y: finest level, z: grid-stride threads
+    std::array<uint32_t, 16> level_offsets{};  ///< Word offset of each level's bitmap (index = level)
+};
+static_assert(sizeof(BoxCountPush) == 80, "BoxCountPush must match box_count.slang");
+
+/**
+ * @brief Box-counting configuration
+ */
+struct FractalDimensionConfig {
+    uint32_t max_level = 9;  ///< Finest level has 2^max_level boxes along the longest axis (max 10)
+};
+
+/**
+ * @brief Occupied boxes at one scale
+ */
+struct BoxCount {
+    uint32_t level;  ///< Boxes of side longest_extent / 2^level
+    uint32_t boxes;  ///< Boxes holding at least one particle
+};
+
+/**
+ * @brief Least-squares fit of log2(boxes) against level
+ */
+struct FractalDimensionEstimate {
+    std::vector<BoxCount> counts;  ///< Every level that was counted
+    uint32_t fit_first = 0;        ///< First level used by the fit
+    uint32_t fit_last = 0;         ///< Last level used by the fit
+    double dimension = 0.0;        ///< Slope of the fit
+    double standard_error = 0.0;   ///< Standard error of the slope
+    double r_squared = 0.0;        ///< Coefficient of determination of the fit
+    double gpu_ms = 0.0;           ///< GPU time of the counting passes
+};
+
+/**
+ * @brief Fit the box-counting dimension to per-level counts
+ *
+ * Levels with an average of fewer than 8 particles per occupied box are
+ * undersampled (the count flattens towards the particle count) and level 1 is
+ * dominated by the bounding box, so both are left out of the fit.
+ *
+ * @param counts Boxes per level, coarsest first
+ * @param particle_count Particles that were counted
+ * @return Estimate (gpu_ms left at 0), or an error if fewer than three levels remain
+ */
+std::expected<FractalDimensionEstimate, std::string> fit_box_counting(
+    const std::vector<BoxCount>& counts,
+    uint64_t particle_count
+);
+
+/**
+ * @brief GPU box-counting estimator of an attractor's fractal dimension
+ *
+ * estimate() counts the occupied boxes of every level at once: a bounds pass,
+ * then one pass that quantizes each particle at the finest level and sets its
+ * bit in a dense occupancy bitmap per level. The bitmaps make the count
+ * exact (no hash collisions) at 2^(3 * level) bits per level, about 19 MB for
+ * the default nine levels. The log-log slope is fitted on the CPU.
+ *
+ * Work is submitted to the graphics queue and returns immediately; poll()
+ * hands back the estimate once its fence has signaled. The particle buffer
+ * must be owned by the graphics queue family, and the caller must wait_idle()
+ * before the backend overwrites it.
+ */
+class FractalDimension {
+public:
+    static constexpr uint32_t MAX_LEVEL = 10;
+
+    /**
+     * @brief Create the estimator, its pipelines and bitmaps
+     *
+     * @param context Vulkan context
+     * @param config Finest level
+     * @return Estimator or error message
+     */
+    static std::expected<std::unique_ptr<FractalDimension>, std::string> create(
+        const VulkanContext& context,
+        FractalDimensionConfig config = {}
+    );
+
+    ~FractalDimension();
+
+    FractalDimension(const FractalDimension&) = delete;
+    FractalDimension& operator=(const FractalDimension&) = delete;
+
+    /**
+     * @brief Count boxes over a particle buffer (asynchronous)
+     *
+     * Waits for the previous estimate first.
+     */
+    std::expected<void, std::string> estimate(vk::Buffer particle_buffer, uint32_t particle_count);
+
+    /// Whether an estimate is in flight
+    [[nodiscard]] bool busy() const { return m_pending; }
+
+    /**
+     * @brief Result of the estimate in flight once it has completed
+     *
+     * Non-blocking. Returns an error if the fit was not possible (e.g. too few particles).
+     */
+    std::optional<std::expected<FractalDimensionEstimate, std::string>> poll();
+
+    /**
+     * @brief Block until the estimate in flight has completed
+     */
+    void wait_idle();
+
+private:
+    enum class Kernel : uint32_t {
+        Bounds,
+        Mark,
+        Count_
+    };
+
+    FractalDimension(const VulkanContext& context, FractalDimensionConfig config);
+
+    std::expected<void, std::string> initialize();
+    std::expected<void, std::string> create_pipelines();
+    std::expected<void, std::string> create_buffers();
+    std::expected<void, std::string> create_commands();
+
+    const VulkanContext* m_context;
+    vk::Device m_device;
+    FractalDimensionConfig m_config;
+    BoxCountPush m_push;  ///< Level offsets are fixed at creation
+
+    std::vector<Shader> m_shaders;
+    vk::DescriptorSetLayout m_descriptor_layout;
+    vk::PipelineLayout m_pipeline_layout;
+    std::array<vk::Pipeline, static_cast<size_t>(Kernel::Count_)> m_pipelines{};
+    vk::DescriptorPool m_descriptor_pool;
+    vk::DescriptorSet m_descriptor_set;
+
+    vk::Buffer m_state_buffer;
+    vk::DeviceMemory m_state_memory;
+    vk::Buffer m_occupancy;
+    vk::DeviceMemory m_occupancy_memory;
+    vk::DeviceSize m_occupancy_size = 0;
+    std::shared_ptr<ReadbackBuffer> m_readback;
+
+    vk::CommandPool m_command_pool;
+    vk::CommandBuffer m_cmd;
+    vk::Fence m_fence;
+    std::unique_ptr<TimestampProfiler> m_profiler;
+
+    uint32_t m_particle_count = 0;
+    bool m_pending = false;
+};
+
+} // namespace ifs
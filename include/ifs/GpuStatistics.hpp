@@ -0,0 +1,214 @@
+#pragma once
+
+#include "ReadbackBuffer.hpp"
+#include "Shader.hpp"
+#include "VulkanContext.hpp"
+#include <array>
+#include <expected>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace ifs {
+
+/**
+ * @brief Histogram, percentiles and min/max written by the GPU (matches StatisticsResult in statistics_result.slang)
+ *
+ * Everything is of the binned value, i.e. log2(1 + v) for log-scale sources.
+ */
+struct StatisticsResult {
+    static constexpr uint32_t BIN_COUNT = 256;
+    static constexpr uint32_t PERCENTILE_COUNT = 4;
+
+    uint32_t count;                               ///< Elements binned
+    uint32_t min_encoded;                         ///< Order-preserving encoded minimum, only meaningful on the GPU
+    uint32_t max_encoded;
+    float mean;                                   ///< From the bin centers
+    std::array<float, PERCENTILE_COUNT> percentiles;
+    std::array<uint32_t, BIN_COUNT> bins;
+};
+static_assert(sizeof(StatisticsResult) == 32 + 4 * StatisticsResult::BIN_COUNT, "StatisticsResult must match statistics_result.slang");
+
+/**
+ * @brief Where a statistic's values are in a buffer and how they are binned
+ */
+struct StatisticsSource {
+    uint32_t stride = 1;             ///< 32-bit words per element
+    uint32_t offset = 0;             ///< Word of the value within an element
+    uint32_t mask = 0xffffffffu;     ///< Applied to integer values (e.g. to drop flag bits)
+    bool is_float = false;           ///< The word is a float, else an unsigned integer
+    bool log_scale = false;          ///< Bin log2(1 + value) instead of the value
+    bool skip_zero = false;          ///< Leave out zero words (e.g. empty grid cells)
+    float range_min = 0.0f;          ///< Histogram range of the binned value; values outside land in the end bins
+    float range_max = 1.0f;
+    uint32_t bin_count = StatisticsResult::BIN_COUNT;  ///< Bins over the range, 1..BIN_COUNT
+    std::array<float, StatisticsResult::PERCENTILE_COUNT> percentiles{0.5f, 0.9f, 0.99f, 0.999f};  ///< Fractions to find
+};
+
+/**
+ * @brief Host copy of one statistic
+ */
+struct StatisticsSummary {
+    uint32_t count = 0;
+    float min = 0.0f;  ///< Of the binned value (0 if nothing was binned)
+    float max = 0.0f;
+    float mean = 0.0f;
+    std::array<float, StatisticsResult::PERCENTILE_COUNT> percentiles{};  ///< At StatisticsSource::percentiles
+    std::vector<uint32_t> bins;  ///< StatisticsSource::bin_count entries
+};
+
+/**
+ * @brief Decode a StatisticsResult read back from the GPU
+ */
+[[nodiscard]] StatisticsSummary summarize_statistics(const StatisticsResult& result, uint32_t bin_count);
+
+/**
+ * @brief GPU histograms with percentiles and min/max over any buffer of 32-bit values
+ *
+ * Each slot holds one statistic. record() clears the slot's result, then a
+ * grid-stride pass bins every element into a workgroup histogram in shared
+ * memory and reduces count, min and max across each subgroup, so the global
+ * atomics are one per non-empty bin and one per subgroup and group. A
+ * single-thread pass turns the histogram into the mean and the requested
+ * percentiles, interpolated within their bin.
+ *
+ * The result stays in a device-local buffer (result_buffer()) that later
+ * passes can bind and read without a CPU round trip, in the same submission
+ * after a compute barrier or in the next frame. It is also copied to a
+ * per-slot readback, which collect() decodes once the caller knows the work
+ * has completed, so the UI never waits on the GPU.
+ *
+ * Requires subgroup arithmetic in compute shaders.
+ */
+class GpuStatistics {
+public:
+    /**
+     * @brief Create the pipelines and `slot_count` result buffers
+     *
+     * @return Service or error message (e.g. no subgroup arithmetic)
+     */
+    static std::expected<std::unique_ptr<GpuStatistics>, std::string> create(
+        const VulkanContext& context,
+        uint32_t slot_count = 1
+    );
+
+    ~GpuStatistics();
+
+    GpuStatistics(const GpuStatistics&) = delete;
+    GpuStatistics& operator=(const GpuStatistics&) = delete;
+
+    /**
+     * @brief Record a statistic of `element_count` elements of `source` into a slot
+     *
+     * The slot's previous work must have completed (its descriptors are
+     * rewritten when the source buffer changes). Ends with the result
+     * readable by compute shaders and copied for collect().
+     *
+     * @param cmd Command buffer (outside a render pass, compute-capable queue)
+     * @param slot Slot to fill
+     * @param source Buffer holding the values (storage buffer usage)
+     * @param element_count Elements to bin
+     * @param spec Value layout and histogram range
+     */
+    void record(
+        vk::CommandBuffer cmd,
+        uint32_t slot,
+        vk::Buffer source,
+        uint32_t element_count,
+        const StatisticsSource& spec
+    );
+
+    /**
+     * @brief Device-local StatisticsResult of a slot, for binding as a storage buffer
+     */
+    [[nodiscard]] vk::Buffer result_buffer(uint32_t slot) const { return m_slots[slot].result; }
+
+    /**
+     * @brief Decode the slot's last recorded statistic; call once that work has completed
+     *
+     * @return Summary, or nothing if the slot was never recorded
+     */
+    std::optional<StatisticsSummary> collect(uint32_t slot);
+
+    /**
+     * @brief Summary returned by the slot's last collect()
+     */
+    [[nodiscard]] const std::optional<StatisticsSummary>& latest(uint32_t slot) const { return m_slots[slot].latest; }
+
+    [[nodiscard]] uint32_t slot_count() const { return static_cast<uint32_t>(m_slots.size()); }
+
+    /**
+     * @brief One record() of a submit()
+     */
+    struct Job {
+        uint32_t slot;
+        vk::Buffer source;
+        uint32_t element_count;
+        StatisticsSource spec;
+    };
+
+    /**
+     * @brief Record several statistics in one submission on the graphics queue (asynchronous)
+     *
+     * Waits for the previous submission first. The sources must be owned by
+     * the graphics queue family. poll() reports completion and collects the slots.
+     */
+    std::expected<void, std::string> submit(std::span<const Job> jobs);
+
+    /**
+     * @brief Whether the last submit() has completed (non-blocking); collects its slots if so
+     */
+    bool poll();
+
+    /// Whether a submit() is in flight
+    [[nodiscard]] bool busy() const { return m_pending; }
+
+    /**
+     * @brief Block until the submission in flight has completed
+     */
+    void wait_idle();
+
+private:
+    enum class Kernel : uint32_t {
+        Histogram,
+        Finalize,
+        Count_
+    };
+
+    struct Slot {
+        vk::Buffer result;
+        vk::DeviceMemory memory;
+        vk::DescriptorSet descriptor_set;
+        vk::Buffer bound_source;  ///< Source the descriptor set points at
+        std::shared_ptr<ReadbackBuffer> readback;
+        uint32_t bin_count = 0;   ///< Of the last record(); 0 if never recorded
+        std::optional<StatisticsSummary> latest;
+    };
+
+    explicit GpuStatistics(const VulkanContext& context);
+
+    std::expected<void, std::string> create_pipelines();
+    std::expected<void, std::string> create_slots(uint32_t slot_count);
+    std::expected<void, std::string> create_commands();
+
+    const VulkanContext* m_context;
+    vk::Device m_device;
+
+    std::vector<Shader> m_shaders;
+    vk::DescriptorSetLayout m_descriptor_layout;
+    vk::PipelineLayout m_pipeline_layout;
+    std::array<vk::Pipeline, static_cast<size_t>(Kernel::Count_)> m_pipelines{};
+    vk::DescriptorPool m_descriptor_pool;
+    std::vector<Slot> m_slots;
+
+    // submit(): own command buffer on the graphics queue
+    vk::CommandPool m_command_pool;
+    vk::CommandBuffer m_cmd;
+    vk::Fence m_fence;
+    std::vector<uint32_t> m_submitted_slots;
+    bool m_pending = false;
+};
+
+} // namespace ifs
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "Camera3D.hpp"
+#include "IFSBackend.hpp"
+#include "IFSFrontend.hpp"
+#include "OffscreenTarget.hpp"
+#include "ParticleData.hpp"
+#include "ReadbackBuffer.hpp"
+#include "Sweep.hpp"
+#include "UICallback.hpp"
+#include "VulkanContext.hpp"
+#include <expected>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ifs {
+
+/**
+ * @brief What a headless session runs
+ */
+struct HeadlessConfig {
+    std::string backend = "custom";   ///< "custom", "sierpinski", "affine" or "flame"
+    std::string frontend = "points";  ///< "points" or "spheres"
+    uint32_t width = 1024;            ///< Offscreen render size
+    uint32_t height = 1024;
+};
+
+/**
+ * @brief Particles read back to host memory
+ *
+ * Points straight into the mapping of a ReadbackBuffer, which `owner` keeps
+ * alive. The next read_particles() overwrites the same memory unless the
+ * particle count grew, so copy if a snapshot is needed.
+ */
+struct ParticleReadback {
+    std::shared_ptr<const ReadbackBuffer> owner;
+    const Particle* particles = nullptr;
+    uint32_t count = 0;
+};
+
+/**
+ * @brief Rendered image read back to host memory
+ *
+ * Tightly packed RGBA8 (sRGB) rows in the session's offscreen target; valid
+ * until the next render() or until the session is destroyed.
+ */
+struct ImageReadback {
+    const uint8_t* pixels = nullptr;
+    uint32_t width = 0;
+    uint32_t height = 0;
+};
+
+/**
+ * @brief Window-less context + backend + frontend for scripting
+ *
+ * Owns its own VulkanContext and never touches GLFW windows, so it runs on
+ * machines without a display. Every call blocks until the GPU is done.
+ *
+ * Readbacks reference memory owned by the session and must not be used after
+ * the session is destroyed.
+ */
+class HeadlessSession {
+public:
+    /**
+     * @brief Create the context, backend, frontend and offscreen target
+     *
+     * @param config Backend, frontend and render size
+     * @return Session or error message
+     */
+    static std::expected<std::unique_ptr<HeadlessSession>, std::string> create(const HeadlessConfig& config);
+
+    ~HeadlessSession();
+
+    HeadlessSession(const HeadlessSession&) = delete;
+    HeadlessSession& operator=(const HeadlessSession&) = delete;
+
+    [[nodiscard]] const VulkanContext& context() const { return *m_context; }
+    [[nodiscard]] IFSBackend& backend() { return *m_backend; }
+    [[nodiscard]] IFSFrontend& frontend() { return *m_frontend; }
+
+    /**
+     * @brief UI parameters of the backend followed by those of the frontend
+     */
+    [[nodiscard]] std::vector<UICallback> parameters();
+
+    /**
+     * @brief Set a UI parameter by name (see find_ui_callback() for matching)
+     */
+    std::expected<void, std::string> set_parameter(std::string_view name, float value);
+
+    /**
+     * @brief Current value of a UI parameter by name
+     */
+    [[nodiscard]] std::expected<float, std::string> parameter(std::string_view name);
+
+    /**
+     * @brief Run the backend and wait for it
+     */
+    std::expected<void, std::string> compute(const IFSParameters& params);
+
+    /**
+     * @brief Copy the backend's particles into host memory
+     *
+     * One GPU copy into a persistently mapped buffer; the result is read in place.
+     */
+    std::expected<ParticleReadback, std::string> read_particles();
+
+    /**
+     * @brief Draw the current particles offscreen and read the image back
+     *
+     * @param camera Camera overrides (defaults otherwise)
+     */
+    std::expected<ImageReadback, std::string> render(const SweepCamera& camera = {});
+
+private:
+    HeadlessSession();
+
+    std::expected<void, std::string> initialize(const HeadlessConfig& config);
+
+    /// Begin the session's command buffer, acquiring the particle buffer if compute left it on another family
+    std::expected<vk::CommandBuffer, std::string> begin_commands();
+    std::expected<void, std::string> submit_and_wait(vk::CommandBuffer cmd);
+
+    std::unique_ptr<VulkanContext> m_context;
+    std::unique_ptr<IFSBackend> m_backend;
+    std::unique_ptr<IFSFrontend> m_frontend;
+    std::unique_ptr<OffscreenTarget> m_target;
+    std::shared_ptr<ReadbackBuffer> m_particle_readback;
+    Camera3D m_camera;
+
+    vk::CommandPool m_command_pool;
+    vk::CommandBuffer m_command_buffer;
+    vk::Fence m_fence;
+
+    vk::Buffer m_bound_buffer;      ///< Particle buffer the frontend's descriptors point at
+    bool m_computed = false;
+    bool m_needs_acquire = false;   ///< Compute released the buffer and graphics hasn't acquired it yet
+};
+
+} // namespace ifs
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "VulkanContext.hpp"
+#include "ParticleBuffer.hpp"
 #include "UICallback.hpp"
+#include "ComputeScheduler.hpp"
 #include <string_view>
 #include <string>
 #include <vector>
@@ -169,6 +171,123 @@ public:
         }
     }
 
+    /**
+     * @brief Release the particle buffer at the end of compute()
+     *
+     * To the graphics family when it differs, or to VK_QUEUE_FAMILY_EXTERNAL
+     * when the buffer is shared with other processes (ParticleShareServer):
+     * their imports and this process's frontends then all acquire it from
+     * there (see shares_particle_buffer()).
+     *
+     * @param cmd Compute command buffer, after the last dispatch
+     * @param buffer The buffer compute() wrote
+     * @param queues Queue families of the context
+     */
+    void release_particle_buffer(vk::CommandBuffer cmd, const ParticleBuffer& buffer, const QueueFamilyIndices& queues) const {
+        if (buffer.external()) {
+            release_buffer_ownership(cmd, buffer.buffer(), queues.compute, VK_QUEUE_FAMILY_EXTERNAL);
+        } else if (queues.has_dedicated_compute()) {
+            release_buffer_ownership(cmd, buffer.buffer(), queues.compute, queues.graphics);
+        }
+    }
+
+    /**
+     * @brief Whether compute() releases the buffer to VK_QUEUE_FAMILY_EXTERNAL
+     *
+     * Frontends then acquire it from there after every compute, also when
+     * compute and graphics share a queue family.
+     */
+    [[nodiscard]] bool shares_particle_buffer() const {
+        const auto* buffer = particle_buffer();
+        return buffer && buffer->external();
+    }
+
+    /**
+     * @brief Whether the next compute() reads what the previous one left in the buffer
+     *
+     * Warm starts continue the stored orbits. With separate queue families the
+     * graphics queue owns the buffer after rendering, so the caller must hand
+     * it back first: record return_buffer_ownership() on the graphics queue
+     * and wait for it before compute(), which then records the matching
+     * acquire_returned_buffer() on the compute queue.
+     */
+    [[nodiscard]] virtual bool reads_particle_buffer() const {
+        return false;
+    }
+
+    /**
+     * @brief Release particle buffer ownership back to compute (graphics → compute)
+     *
+     * Recorded by the caller on the graphics queue after the last command that
+     * reads the buffer, when reads_particle_buffer() is true and the queue
+     * families differ.
+     *
+     * @param cmd Graphics command buffer to record into
+     * @param particle_buffer Device buffer containing particles
+     * @param graphics_queue_family Graphics queue family index
+     * @param compute_queue_family Compute queue family index
+     */
+    void return_buffer_ownership(
+        vk::CommandBuffer cmd,
+        vk::Buffer particle_buffer,
+        uint32_t graphics_queue_family,
+        uint32_t compute_queue_family
+    ) const {
+        auto barrier = vk::BufferMemoryBarrier()
+            .setSrcAccessMask({})  // Graphics only read the buffer
+            .setDstAccessMask({})  // Acquire will set this
+            .setSrcQueueFamilyIndex(graphics_queue_family)
+            .setDstQueueFamilyIndex(compute_queue_family)
+            .setBuffer(particle_buffer)
+            .setOffset(0)
+            .setSize(VK_WHOLE_SIZE);
+
+        cmd.pipelineBarrier(
+            vk::PipelineStageFlagBits::eAllCommands,
+            vk::PipelineStageFlagBits::eBottomOfPipe,
+            {},
+            {},
+            barrier,
+            {}
+        );
+    }
+
+    /**
+     * @brief Acquire particle buffer ownership returned by the graphics queue
+     *
+     * Matches return_buffer_ownership(); recorded by compute() before the
+     * first dispatch when reads_particle_buffer() is true.
+     *
+     * @param cmd Compute command buffer to record into
+     * @param particle_buffer Device buffer containing particles
+     * @param graphics_queue_family Graphics queue family index
+     * @param compute_queue_family Compute queue family index
+     */
+    void acquire_returned_buffer(
+        vk::CommandBuffer cmd,
+        vk::Buffer particle_buffer,
+        uint32_t graphics_queue_family,
+        uint32_t compute_queue_family
+    ) const {
+        auto barrier = vk::BufferMemoryBarrier()
+            .setSrcAccessMask({})  // Release already set this
+            .setDstAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite)
+            .setSrcQueueFamilyIndex(graphics_queue_family)
+            .setDstQueueFamilyIndex(compute_queue_family)
+            .setBuffer(particle_buffer)
+            .setOffset(0)
+            .setSize(VK_WHOLE_SIZE);
+
+        cmd.pipelineBarrier(
+            vk::PipelineStageFlagBits::eTopOfPipe,
+            vk::PipelineStageFlagBits::eComputeShader,
+            {},
+            {},
+            barrier,
+            {}
+        );
+    }
+
     /**
      * @brief Get custom parameter ranges for UI (DEPRECATED - use get_ui_callbacks() instead)
      *
@@ -221,6 +340,15 @@ public:
      */
     [[nodiscard]] virtual vk::Buffer get_particle_buffer() const = 0;
 
+    /**
+     * @brief The particle buffer object, for sharing its memory (ParticleShareServer)
+     *
+     * @return Buffer, or nullptr if the backend does not keep it in a ParticleBuffer
+     */
+    [[nodiscard]] virtual const ParticleBuffer* particle_buffer() const {
+        return nullptr;
+    }
+
     /**
      * @brief Get the current particle count
      *
@@ -229,6 +357,18 @@ public:
      * @return Number of particles in the buffer
      */
     [[nodiscard]] virtual uint32_t get_particle_count() const = 0;
+
+    /**
+     * @brief Get GPU timing of the last completed compute() call
+     *
+     * Backends that submit through a ComputeScheduler return its stats so the
+     * UI can show how the work was spread across compute queues.
+     *
+     * @return Stats, or nullptr if the backend does not collect any
+     */
+    [[nodiscard]] virtual const ComputeStats* compute_stats() const {
+        return nullptr;
+    }
 };
 
 } // namespace ifs
@@ -1,15 +1,29 @@
 #pragma once
 
+#include "Animation.hpp"
 #include "IFSBackend.hpp"
 #include "IFSFrontend.hpp"
 #include "Camera3D.hpp"
+#include "CameraPath.hpp"
+#include "FractalDimension.hpp"
+#include "GpuStatistics.hpp"
+#include "LatencyTracker.hpp"
+#include "Metrics.hpp"
 #include "ParticleBuffer.hpp"
+#include "ParticleShare.hpp"
+#include "SpatialGrid.hpp"
 #include "VulkanContext.hpp"
 #include "Window.hpp"
 #include <GLFW/glfw3.h>
+#include <array>
+#include <chrono>
+#include <filesystem>
 #include <memory>
 #include <expected>
 #include <functional>
+#include <optional>
+#include <string>
+#include <vector>
 
 namespace ifs {
 
@@ -20,6 +34,12 @@ struct IFSConfig {
     uint32_t window_width = 1280;
     uint32_t window_height = 720;
     const char* window_title = "IFS Visualizer";
+    std::optional<MetricsExportConfig> metrics_export;  ///< Periodically write metrics to a file
+    bool low_latency = false;  ///< Start in low-latency mode (see IFSController::set_low_latency())
+    /// Share the particle buffer with other processes over this Unix socket (ParticleShareServer)
+    std::optional<std::filesystem::path> share_socket;
+    /// Slang modules parsed on a worker thread while the window and swapchain are created
+    std::vector<std::string> preload_shaders;
 };
 
 /**
@@ -71,6 +91,69 @@ public:
      */
     void set_frontend(std::unique_ptr<IFSFrontend> frontend);
 
+    /**
+     * @brief Split the window: add a view with its own camera, right of the others
+     *
+     * Every view draws the backend's one particle buffer; the new camera
+     * starts as a copy of the main one. Views that share the main frontend
+     * are drawn by one render_frame() (ParticleRenderer: one multiview draw).
+     * A view with its own frontend is drawn by a second submission into the
+     * same swapchain image. Mouse and keyboard go to the view under the cursor.
+     *
+     * @param frontend Frontend of the view; nullptr shares the one of set_frontend() (call that first)
+     * @return Error if the window would hold more than MAX_FRAME_VIEWS views,
+     *         or the shared frontend more than its max_views()
+     */
+    std::expected<void, std::string> add_view(std::unique_ptr<IFSFrontend> frontend = nullptr);
+
+    /**
+     * @brief Remove the views added by add_view()
+     */
+    void clear_views();
+
+    /**
+     * @brief Number of views, including the main one
+     */
+    [[nodiscard]] size_t view_count() const { return 1 + m_split_views.size(); }
+
+    /**
+     * @brief Record every frame's camera, seed, scale and UI parameter changes
+     *
+     * Starts with the next frame. The path is written to `path` when the
+     * recording is stopped in the Camera Path panel or the window closes.
+     */
+    void start_path_recording(std::filesystem::path path);
+
+    /**
+     * @brief Replay a recorded path, one recorded frame per presented frame
+     *
+     * Input is ignored and frames are not paced to the recorded timestamps:
+     * each frame applies the next recorded state as soon as the previous one
+     * is presented. Per-frame timings are written as CSV to `timings` after
+     * the last frame, and a summary is logged.
+     *
+     * @param path Recording (parse_camera_path())
+     * @param timings CSV file for the timings
+     * @param close_when_done Close the window after the last frame
+     */
+    void start_path_replay(CameraPath path, std::filesystem::path timings, bool close_when_done = true);
+
+    /**
+     * @brief Trade throughput for input-to-present latency
+     *
+     * Presents immediately (tearing allowed) where the surface supports it,
+     * and before sampling input waits for the previous frame to reach the
+     * display (VK_KHR_present_wait) or, without present wait, for the GPU to
+     * go idle. Input then never waits behind queued frames.
+     */
+    void set_low_latency(bool enabled);
+    [[nodiscard]] bool low_latency() const { return m_low_latency; }
+
+    /**
+     * @brief Rolling input-to-present latency of the presented frames
+     */
+    [[nodiscard]] const LatencyTracker& latency() const { return m_latency; }
+
     /**
      * @brief Run the main application loop
      *
@@ -119,6 +202,21 @@ private:
      */
     void handle_input(float delta_time);
 
+    /**
+     * @brief Camera of the view under a cursor position (window coordinates)
+     */
+    [[nodiscard]] Camera3D* camera_at(double x, double y) const;
+
+    /**
+     * @brief Areas of the main view (0) and the split views, side by side over the extent
+     */
+    [[nodiscard]] std::vector<vk::Rect2D> view_areas(const vk::Extent2D& extent) const;
+
+    /**
+     * @brief The main frontend and the split views' own frontends
+     */
+    [[nodiscard]] std::vector<IFSFrontend*> frontends() const;
+
     /**
      * @brief Render ImGui UI
      */
@@ -126,8 +224,126 @@ private:
 
     /**
      * @brief Render UI callbacks generically
+     *
+     * @return Whether any value was changed this frame
      */
-    void render_ui_callbacks(const std::vector<UICallback>& callbacks);
+    bool render_ui_callbacks(const std::vector<UICallback>& callbacks);
+
+    /**
+     * @brief Render the Inspect panel (spatial index, picking, proximity queries)
+     */
+    void render_inspect_ui();
+
+    /**
+     * @brief Render the fractal dimension toggle and estimate (part of the Inspect panel)
+     */
+    void render_dimension_ui();
+
+    /**
+     * @brief Render the particle statistics toggle and histograms (part of the Inspect panel)
+     */
+    void render_statistics_ui();
+
+    /**
+     * @brief Rebuild the spatial grid after new particles, collect query results, pick under the cursor
+     *
+     * Called after the frame is submitted, when the graphics queue owns the particle buffer.
+     */
+    void update_spatial_grid();
+
+    /**
+     * @brief Re-estimate the fractal dimension after new particles and collect the result
+     */
+    void update_fractal_dimension();
+
+    /**
+     * @brief Re-gather color and transform histograms after new particles
+     */
+    void update_particle_statistics();
+
+    /**
+     * @brief Render the Animation panel (keyframes, playback, timeline files)
+     *
+     * Only shown for backends with editable maps (AffineIFS).
+     */
+    void render_animation_ui();
+
+    /**
+     * @brief Advance playback and apply the sampled frame to the backend, camera and scale
+     *
+     * Requests a warm-started recompute instead of a full burn-in.
+     */
+    void advance_animation(float delta_time);
+
+    /**
+     * @brief Render the Camera Path panel (recording, replay, timings)
+     */
+    void render_camera_path_ui();
+
+    /**
+     * @brief Apply the next recorded frame to the camera, parameters and backend
+     *
+     * @return Seconds between this recorded frame and the previous one
+     */
+    float apply_replay_frame();
+
+    /**
+     * @brief Write the recorded path to its file and stop recording
+     */
+    void stop_path_recording();
+
+    /**
+     * @brief Write the timings of a finished or aborted replay and log their summary
+     */
+    void finish_path_replay();
+
+    /**
+     * @brief Render the Deep Zoom panel (high-precision camera frame, view-directed generation)
+     *
+     * Only shown for AffineIFS backends.
+     */
+    void render_deep_zoom_ui();
+
+    /**
+     * @brief Render the metrics registry as a table
+     */
+    void render_metrics_ui();
+
+    /**
+     * @brief Render the Latency panel (low-latency toggle, stage timings, percentiles)
+     */
+    void render_latency_ui();
+
+    /**
+     * @brief Report displayed frames to the latency tracker
+     *
+     * @param block Wait for the newest presented frame (low latency) instead of polling
+     */
+    void poll_presents(bool block);
+
+    /**
+     * @brief Hand the particle buffer back to the compute queue family for a compute that reads it
+     *
+     * Only for IFSBackend::reads_particle_buffer() (warm starts), with separate
+     * queue families or a shared buffer no frame has acquired since the last
+     * compute; blocks until the graphics queue has released it.
+     */
+    void return_particle_buffer();
+
+    /**
+     * @brief Dispatch compute and record it in the metrics
+     */
+    void dispatch_compute();
+
+    /**
+     * @brief Wait for the dispatched compute and record its GPU time
+     */
+    void finish_compute();
+
+    /**
+     * @brief Update per-frame metrics, refresh rates and VRAM once a second, tick the exporter
+     */
+    void update_metrics(float delta_time);
 
     /**
      * @brief Cleanup resources
@@ -138,6 +354,7 @@ private:
     friend void glfw_key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
     friend void glfw_mouse_callback(GLFWwindow* window, double xpos, double ypos);
     friend void glfw_scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
+    friend void glfw_mouse_button_callback(GLFWwindow* window, int button, int action, int mods);
 
     // Configuration
     IFSConfig m_config;
@@ -152,6 +369,14 @@ private:
 
     // Camera and input
     std::unique_ptr<Camera3D> m_camera;
+    Camera3D* m_input_camera = nullptr;  ///< Camera moved by mouse and keys: the view under the cursor
+
+    // Split-screen views right of the main one (see add_view())
+    struct SplitView {
+        std::unique_ptr<Camera3D> camera;
+        std::unique_ptr<IFSFrontend> frontend;  ///< Null: drawn by m_frontend
+    };
+    std::vector<SplitView> m_split_views;
     bool m_keys_pressed[512] = {false};
     double m_last_mouse_x = 0.0;
     double m_last_mouse_y = 0.0;
@@ -164,12 +389,79 @@ private:
     bool m_needs_ownership_acquire = false;
     bool m_needs_buffer_rebind = false;  // Frontend needs to rebind particle buffer
 
+    // Graphics → compute ownership returns
+    vk::CommandPool m_ownership_pool;
+    vk::CommandBuffer m_ownership_command_buffer;
+    vk::Fence m_ownership_fence;
+
+    // Spatial index for picking (created when enabled in the Inspect panel)
+    std::unique_ptr<SpatialGrid> m_spatial_grid;
+    bool m_spatial_enabled = false;
+    bool m_spatial_dirty = true;               // Particles changed since the last build
+    std::optional<SpatialQueryKind> m_spatial_request;  // Radius/nearest query waiting for the grid
+    float m_pick_radius_px = 6.0f;
+    float m_query_radius = 0.02f;
+    int m_query_k = 16;
+    std::optional<SpatialHit> m_picked;        // Particle under the cursor
+    glm::vec3 m_picked_point{0.0f};            // Its position, as seen along the pick ray
+    std::pair<glm::vec3, glm::vec3> m_pick_ray;  // Origin and direction of the pick in flight
+    std::optional<SpatialQueryResult> m_spatial_result;  // Last radius/nearest result
+
+    // Box-counting dimension (created when enabled in the Inspect panel)
+    std::unique_ptr<FractalDimension> m_fractal_dimension;
+    bool m_dimension_enabled = false;
+    bool m_dimension_dirty = true;             // Particles changed since the last estimate
+    std::optional<std::expected<FractalDimensionEstimate, std::string>> m_dimension_result;
+
+    // Color and transform histograms (created when enabled in the Inspect panel)
+    std::unique_ptr<GpuStatistics> m_particle_statistics;
+    bool m_statistics_enabled = false;
+    bool m_statistics_dirty = true;            // Particles changed since the last histograms
+    uint32_t m_statistics_maps = 0;            // Transforms binned by the last submit; 0 if none
+
+    // Keyframe animation (AffineIFS backends only)
+    Timeline m_timeline;
+    bool m_animation_playing = false;
+    bool m_animation_loop = true;
+    float m_animation_time = 0.0f;
+    int m_warm_iterations = 8;                 // Iterations per played frame (continuing the previous orbits)
+    std::array<char, 256> m_timeline_path{"timeline.txt"};
+    std::string m_animation_status;            // Result of the last load/save
+
+    // Camera path recording and replay (deterministic benchmark workloads)
+    CameraPathRecorder m_path_recorder;
+    bool m_path_recording = false;
+    std::chrono::steady_clock::time_point m_path_record_start;
+    std::optional<CameraPath> m_path_replay;   // Set while replaying
+    size_t m_path_replay_frame = 0;            // Next recorded frame to apply
+    bool m_path_close_when_done = true;
+    std::filesystem::path m_path_timings_file;
+    std::vector<FrameTiming> m_path_timings;
+    std::array<char, 256> m_path_file{"camera_path.txt"};
+    std::string m_path_status;                 // Result of the last record/replay
+
+    // Deep zoom (AffineIFS backends only); the frame lives in m_camera
+    bool m_deep_zoom = false;
+
+    // Particle buffer shared with other processes (IFSConfig::share_socket)
+    std::unique_ptr<ParticleShareServer> m_particle_share;
+
+    // Input-to-present latency
+    LatencyTracker m_latency;
+    bool m_low_latency = false;
+
     // ImGui descriptor pool
     vk::DescriptorPool m_imgui_descriptor_pool;
 
     // Timing
     double m_last_frame_time = 0.0;
 
+    // Metrics (counters live in MetricsRegistry, these track the rate window)
+    std::unique_ptr<MetricsExporter> m_metrics_exporter;
+    double m_metrics_window_seconds = 0.0;
+    double m_window_samples = 0.0;
+    double m_window_draws = 0.0;
+
     // Frame counter for in-flight synchronization
     uint32_t m_current_frame = 0;
     static constexpr size_t MAX_FRAMES_IN_FLIGHT = 2;
@@ -2,15 +2,29 @@
 
 #include "Camera.hpp"
 #include "UICallback.hpp"
+#include "RenderDiagnostics.hpp"
+#include "OcclusionCuller.hpp"
 #include <vulkan/vulkan.hpp>
 #include <string_view>
 #include <string>
+#include <span>
 #include <vector>
 #include <utility>
 #include <array>
 
 namespace ifs {
 
+/// Most split-screen views of one frame
+constexpr uint32_t MAX_FRAME_VIEWS = 4;
+
+/**
+ * @brief One viewport of a split-screen frame
+ */
+struct FrameView {
+    Camera* camera;     ///< Camera of the view (its aspect ratio should match `area`)
+    vk::Rect2D area;    ///< Region of the framebuffer the view covers
+};
+
 /**
  * @brief Information needed to render a frame (Phase 3: Frontend owns graphics infrastructure)
  */
@@ -29,6 +43,7 @@ struct FrameRenderInfo {
     uint32_t compute_queue_family;             ///< Compute queue family (for ownership transfer)
     uint32_t graphics_queue_family;            ///< Graphics queue family (for ownership transfer)
     void* imgui_draw_data;                     ///< ImGui draw data (optional)
+    std::span<const FrameView> views = {};     ///< Split-screen views (empty: `camera` over the whole extent)
 };
 
 /**
@@ -117,6 +132,52 @@ public:
         const vk::Extent2D* extent = nullptr
     ) = 0;
 
+    /**
+     * @brief Most split-screen views one render_frame() can draw
+     */
+    [[nodiscard]] virtual uint32_t max_views() const { return 1; }
+
+    /**
+     * @brief Draw each view into its area of the current render pass
+     *
+     * render_frame() calls this instead of render() when FrameRenderInfo::views
+     * is set, at most max_views() of them. Unlike repeated render() calls, the
+     * views must not overwrite each other's camera parameters before the GPU
+     * reads them.
+     *
+     * @param cmd Command buffer to record into (inside the render pass)
+     * @param particle_buffer Device buffer containing particles
+     * @param particle_count Number of particles to render
+     * @param views Cameras and viewports
+     */
+    virtual void render_views(
+        vk::CommandBuffer cmd,
+        vk::Buffer particle_buffer,
+        uint32_t particle_count,
+        std::span<const FrameView> views
+    ) = 0;
+
+    /**
+     * @brief Record work that must run before the render pass in which render() draws
+     *
+     * Called by whoever owns the render pass, after the particle buffer was
+     * acquired and before the pass begins; render_frame() calls it itself.
+     * Default: nothing to record.
+     *
+     * @param cmd Command buffer to record into (outside a render pass)
+     * @param particle_buffer Device buffer containing particles
+     * @param particle_count Number of particles to render
+     * @param camera Camera render() will draw with
+     * @param extent Viewport extent render() will draw with
+     */
+    virtual void record_pre_pass(
+        [[maybe_unused]] vk::CommandBuffer cmd,
+        [[maybe_unused]] vk::Buffer particle_buffer,
+        [[maybe_unused]] uint32_t particle_count,
+        [[maybe_unused]] Camera& camera,
+        [[maybe_unused]] const vk::Extent2D& extent
+    ) {}
+
     /**
      * @brief Acquire particle buffer ownership (compute → graphics)
      *
@@ -221,6 +282,27 @@ public:
     [[nodiscard]] virtual std::vector<UICallback> get_ui_callbacks() {
         return {};
     }
+
+    /**
+     * @brief Get pipeline statistics of the last completed frame's particle draw
+     *
+     * Frontends that wrap their draw in a PipelineStatisticsQuery return its
+     * latest result while the query is enabled (see diagnostics_ui_callbacks()).
+     *
+     * @return Statistics, or nullptr if not collected
+     */
+    [[nodiscard]] virtual const PipelineStatistics* pipeline_statistics() const {
+        return nullptr;
+    }
+
+    /**
+     * @brief Get occlusion culling results of the last completed frame
+     *
+     * @return Statistics, or nullptr if the frontend doesn't cull
+     */
+    [[nodiscard]] virtual const OcclusionStatistics* occlusion_statistics() const {
+        return nullptr;
+    }
 };
 
 } // namespace ifs
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <optional>
+
+namespace ifs {
+
+/**
+ * @brief Timeline of one presented frame, in milliseconds between its stages
+ */
+struct LatencySample {
+    uint64_t present_id = 0;
+    bool has_input = false;            ///< Input was delivered since the previous frame
+    bool displayed = false;            ///< Ends at the display (present wait), else at the present call
+    double input_to_end_ms = 0.0;      ///< Earliest input of the frame to its end (0 without input)
+    double start_to_submit_ms = 0.0;   ///< Frame start (before input sampling) to the last queue submit
+    double submit_to_present_ms = 0.0; ///< Last submit to the present call
+    double present_to_display_ms = 0.0;  ///< Present call to the display (0 if not displayed)
+};
+
+/**
+ * @brief Rolling percentiles of the samples in a LatencyTracker
+ */
+struct LatencySummary {
+    size_t frames = 0;
+    size_t input_frames = 0;           ///< Frames with input; the input percentiles are over these
+    bool displayed = false;            ///< Every frame ended at the display
+    double input_mean_ms = 0.0;
+    double input_p50_ms = 0.0;
+    double input_p95_ms = 0.0;
+    double input_p99_ms = 0.0;
+    double input_max_ms = 0.0;
+    double start_to_submit_ms = 0.0;   ///< Means over all frames
+    double submit_to_present_ms = 0.0;
+    double present_to_display_ms = 0.0;
+};
+
+/**
+ * @brief Input-to-present latency, frame by frame
+ *
+ * The main loop reports each stage of a frame as it happens: input events
+ * (from the GLFW callbacks, i.e. when glfwPollEvents() delivers them), the
+ * frame start, the last queue submit and the present call, which returns the
+ * frame's present id. A frame ends either at the present call or, when the
+ * caller waits for presents (VK_KHR_present_wait), once displayed() reports
+ * its id; until then it is pending.
+ *
+ * Input delivered to a frame that is dropped (e.g. by a swapchain recreation)
+ * carries over to the next one, so its latency includes the retry.
+ */
+class LatencyTracker {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// Frames pending display beyond this are dropped (their ids never complete)
+    static constexpr size_t MAX_PENDING = 16;
+
+    /**
+     * @param window Samples kept for summary()
+     */
+    explicit LatencyTracker(size_t window = 240) : m_window(window) {}
+
+    /// An input event was delivered; only the earliest before the frame's submit counts
+    void input(Clock::time_point time);
+
+    /// A frame starts (before glfwPollEvents()); replaces a frame that was never presented
+    void begin_frame(Clock::time_point time);
+
+    /// The frame's last queue submit
+    void submitted(Clock::time_point time);
+
+    /**
+     * @brief The frame was presented
+     *
+     * @param await_display Keep the frame pending until displayed() reports its id
+     * @return Present id of the frame (increasing from 1)
+     */
+    uint64_t presented(Clock::time_point time, bool await_display);
+
+    /// Every pending frame up to `present_id` reached the display at `time`
+    void displayed(uint64_t present_id, Clock::time_point time);
+
+    /// Forget frames that will never be displayed (their swapchain was recreated)
+    void discard_pending() { m_pending.clear(); }
+
+    /// Oldest frame waiting for displayed()
+    [[nodiscard]] std::optional<uint64_t> oldest_pending() const;
+
+    /// Newest frame waiting for displayed()
+    [[nodiscard]] std::optional<uint64_t> newest_pending() const;
+
+    /// Completed frames, oldest first (at most the window)
+    [[nodiscard]] const std::deque<LatencySample>& samples() const { return m_samples; }
+
+    [[nodiscard]] LatencySummary summary() const;
+
+    void clear();
+
+private:
+    struct Frame {
+        Clock::time_point start{};
+        std::optional<Clock::time_point> input{};
+        Clock::time_point submit{};
+        Clock::time_point present{};
+        uint64_t present_id = 0;
+    };
+
+    void complete(const Frame& frame, Clock::time_point end, bool displayed);
+
+    size_t m_window;
+    uint64_t m_next_present_id = 1;
+    std::optional<Clock::time_point> m_input;  ///< Earliest input not yet claimed by a submit
+    std::optional<Frame> m_current;            ///< Frame between begin_frame() and presented()
+    std::deque<Frame> m_pending;               ///< Presented, waiting for displayed()
+    std::deque<LatencySample> m_samples;
+};
+
+} // namespace ifs
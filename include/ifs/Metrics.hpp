@@ -0,0 +1,164 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ifs {
+
+enum class MetricType {
+    Counter,  ///< Monotonically increasing total
+    Gauge     ///< Current value, may go up and down
+};
+
+/**
+ * @brief One named value in the metrics registry
+ *
+ * Updates are lock-free (a single atomic), so a cached reference can be
+ * bumped from any thread, including per-frame hot paths.
+ */
+class Metric {
+public:
+    Metric(std::string name, std::string help, MetricType type)
+        : m_name(std::move(name)), m_help(std::move(help)), m_type(type) {}
+
+    Metric(const Metric&) = delete;
+    Metric& operator=(const Metric&) = delete;
+
+    /// Add to a counter (or gauge)
+    void add(double delta = 1.0) { m_value.fetch_add(delta, std::memory_order_relaxed); }
+
+    /// Overwrite the value (gauges)
+    void set(double value) { m_value.store(value, std::memory_order_relaxed); }
+
+    [[nodiscard]] double value() const { return m_value.load(std::memory_order_relaxed); }
+    [[nodiscard]] const std::string& name() const { return m_name; }
+    [[nodiscard]] const std::string& help() const { return m_help; }
+    [[nodiscard]] MetricType type() const { return m_type; }
+
+private:
+    std::string m_name;
+    std::string m_help;
+    MetricType m_type;
+    std::atomic<double> m_value{0.0};
+};
+
+/**
+ * @brief Point-in-time copy of one metric
+ */
+struct MetricSample {
+    std::string name;
+    std::string help;
+    MetricType type;
+    double value;
+};
+
+/**
+ * @brief Process-wide registry of counters and gauges
+ *
+ * Names follow Prometheus conventions (`ifs_<what>_<unit>`, counters end in
+ * `_total`) and may carry labels, e.g. `ifs_vram_usage_bytes{heap="0"}`.
+ *
+ * Registration and snapshot() take a mutex; they are expected to happen
+ * rarely (look the metric up once and keep the reference, which stays valid
+ * for the lifetime of the process). Updates through Metric never lock.
+ *
+ * Usage:
+ *   static auto& frames = MetricsRegistry::instance().counter("ifs_frames_total", "Frames presented");
+ *   frames.add();
+ */
+class MetricsRegistry {
+public:
+    static MetricsRegistry& instance();
+
+    /**
+     * @brief Get or register a counter
+     */
+    Metric& counter(std::string_view name, std::string_view help = {});
+
+    /**
+     * @brief Get or register a gauge
+     */
+    Metric& gauge(std::string_view name, std::string_view help = {});
+
+    /**
+     * @brief Copy all metrics in registration order
+     */
+    [[nodiscard]] std::vector<MetricSample> snapshot() const;
+
+    MetricsRegistry() = default;
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+private:
+    Metric& get_or_create(std::string_view name, std::string_view help, MetricType type);
+
+    mutable std::mutex m_mutex;
+    std::deque<Metric> m_metrics;  ///< Deque: references stay valid on insert
+};
+
+enum class MetricsFormat {
+    JsonLines,   ///< One JSON object per flush appended to the file
+    Prometheus   ///< Text exposition format, file replaced on every flush
+};
+
+/**
+ * @brief Where and how often metrics are written
+ */
+struct MetricsExportConfig {
+    std::filesystem::path path;
+    MetricsFormat format = MetricsFormat::JsonLines;
+    double interval_seconds = 10.0;
+};
+
+/**
+ * @brief Periodically writes a registry snapshot to a file
+ *
+ * Meant to be ticked from the main loop. Prometheus output is written to a
+ * temporary file and renamed, so a scraper (e.g. node_exporter's textfile
+ * collector) never sees a partial file.
+ */
+class MetricsExporter {
+public:
+    explicit MetricsExporter(MetricsExportConfig config, const MetricsRegistry& registry = MetricsRegistry::instance());
+
+    /**
+     * @brief Flush if the interval has elapsed since the last flush
+     */
+    void tick();
+
+    /**
+     * @brief Write a snapshot now
+     *
+     * @return false if the file could not be written
+     */
+    bool flush();
+
+    [[nodiscard]] const MetricsExportConfig& config() const { return m_config; }
+
+    /**
+     * @brief Format a snapshot as one JSON line (including the trailing newline)
+     *
+     * @param samples Registry snapshot
+     * @param unix_ms Timestamp in milliseconds since the epoch
+     */
+    [[nodiscard]] static std::string format_json_line(const std::vector<MetricSample>& samples, int64_t unix_ms);
+
+    /**
+     * @brief Format a snapshot in the Prometheus text exposition format
+     */
+    [[nodiscard]] static std::string format_prometheus(const std::vector<MetricSample>& samples);
+
+private:
+    MetricsExportConfig m_config;
+    const MetricsRegistry* m_registry;
+    std::chrono::steady_clock::time_point m_last_flush;
+};
+
+} // namespace ifs
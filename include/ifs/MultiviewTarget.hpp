@@ -0,0 +1,133 @@
+#pragma once
+
+#include "VulkanContext.hpp"
+#include "Shader.hpp"
+#include <vulkan/vulkan.hpp>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <string>
+
+namespace ifs {
+
+/**
+ * @brief Layered offscreen target that draws several split-screen views in one pass
+ *
+ * The render pass' subpass has a VK_KHR_multiview view mask over
+ * view_count() layers: each draw recorded in it is broadcast to every layer,
+ * and the vertex stage reads SV_ViewID to pick that view's camera. The draw
+ * and its particle fetches are recorded once instead of once per view.
+ *
+ * Multiview layers share one extent and viewport, so all views are drawn at
+ * the size given to begin() (the views of a split are the same size, give or
+ * take a pixel), and record_composite() copies each layer into its area of
+ * the frontend's color attachment, clamping to the layer's edge.
+ *
+ * Frame order (all in the frontend's command buffer):
+ * 1. begin() outside a render pass, then the frontend's draw with a pipeline
+ *    built against render_pass()
+ * 2. end()
+ * 3. record_composite() once per view inside the frontend's render pass
+ */
+class MultiviewTarget {
+public:
+    static constexpr uint32_t MAX_VIEWS = 4;
+    static constexpr vk::Format COLOR_FORMAT = vk::Format::eR16G16B16A16Sfloat;
+
+    /**
+     * @brief Whether the device can render multiview passes
+     */
+    static bool supported(const VulkanContext& context) { return context.has_multiview(); }
+
+    /**
+     * @brief Create the multiview render pass and the composite pipeline
+     *
+     * @param context Vulkan context
+     * @param frontend_pipeline Create info of the frontend's pipeline; its render
+     *        pass, subpass, viewport, multisample and dynamic state are reused
+     *        for the composite. Pointers must be valid for the call.
+     * @param view_count Views (layers) drawn by each pass, 2 to MAX_VIEWS
+     * @return Target or error message
+     */
+    static std::expected<std::unique_ptr<MultiviewTarget>, std::string> create(
+        const VulkanContext& context,
+        const vk::GraphicsPipelineCreateInfo& frontend_pipeline,
+        uint32_t view_count
+    );
+
+    ~MultiviewTarget();
+
+    MultiviewTarget(const MultiviewTarget&) = delete;
+    MultiviewTarget& operator=(const MultiviewTarget&) = delete;
+
+    /**
+     * @brief Render pass with one COLOR_FORMAT attachment and depth, broadcast to view_count() layers
+     */
+    [[nodiscard]] vk::RenderPass render_pass() const { return m_render_pass; }
+
+    [[nodiscard]] uint32_t view_count() const { return m_view_count; }
+
+    /**
+     * @brief Begin the multiview pass (recreates the layers if the extent changed)
+     *
+     * Must be recorded outside a render pass.
+     *
+     * @param cmd Command buffer
+     * @param extent Extent of every view
+     * @param clear_color Background of the views
+     * @return false if nothing was begun
+     */
+    bool begin(vk::CommandBuffer cmd, const vk::Extent2D& extent, const vk::ClearColorValue& clear_color);
+
+    /**
+     * @brief End the multiview pass; the layers are ready for record_composite()
+     */
+    void end(vk::CommandBuffer cmd) const;
+
+    /**
+     * @brief Copy one view's layer into the frontend's color attachment
+     *
+     * @param cmd Command buffer (inside the frontend's render pass)
+     * @param view Layer to copy
+     * @param area Area of the framebuffer the view covers
+     */
+    void record_composite(vk::CommandBuffer cmd, uint32_t view, const vk::Rect2D& area) const;
+
+private:
+    MultiviewTarget(const VulkanContext& context, uint32_t view_count);
+
+    std::expected<void, std::string> create_render_pass();
+    std::expected<void, std::string> create_descriptors();
+    std::expected<void, std::string> create_pipeline(const vk::GraphicsPipelineCreateInfo& frontend_pipeline);
+    std::expected<void, std::string> create_images(const vk::Extent2D& extent);
+    void destroy_images();
+
+    const VulkanContext* m_context;
+    vk::Device m_device;
+    uint32_t m_view_count;
+    vk::Format m_depth_format = vk::Format::eUndefined;
+    vk::RenderPass m_render_pass;
+
+    // Layered color and depth attachments, one layer per view
+    struct Image {
+        vk::Image image;
+        vk::DeviceMemory memory;
+        vk::ImageView view;
+    };
+    Image m_color{};
+    Image m_depth{};
+    vk::Framebuffer m_framebuffer;
+    vk::Extent2D m_extent;
+
+    // Composite: the color layers as one sampled 2D array
+    vk::DescriptorSetLayout m_descriptor_layout;
+    vk::DescriptorPool m_descriptor_pool;
+    vk::DescriptorSet m_descriptor_set;
+
+    std::unique_ptr<Shader> m_composite_vertex_shader;
+    std::unique_ptr<Shader> m_composite_fragment_shader;
+    vk::PipelineLayout m_composite_layout;
+    vk::Pipeline m_composite_pipeline;
+};
+
+} // namespace ifs
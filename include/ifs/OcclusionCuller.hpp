@@ -0,0 +1,245 @@
+#pragma once
+
+#include "VulkanContext.hpp"
+#include <vulkan/vulkan.hpp>
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace ifs {
+
+/// Most levels of detail a culled draw can be split into (MAX_LODS in culling.slang)
+constexpr uint32_t MAX_LOD_COUNT = 8;
+
+/**
+ * @brief One level of detail of the instanced mesh, a range of the frontend's vertex and index buffers
+ */
+struct LodMesh {
+    uint32_t first_index = 0;
+    uint32_t index_count = 0;
+    int32_t vertex_offset = 0;
+    float max_radius = 0.0f;  ///< Spheres projected smaller than this (pixels) use this LOD; ignored for the last
+};
+
+/**
+ * @brief Result of one frame's occlusion culling
+ */
+struct OcclusionStatistics {
+    uint32_t instance_count = 0;  ///< Instances submitted
+    uint32_t first_phase = 0;     ///< Drawn after the test against the previous frame's pyramid
+    uint32_t second_phase = 0;    ///< Rejected at first, drawn after the re-test
+    uint32_t occluded = 0;        ///< Rejected by both phases
+    uint32_t lod_count = 0;
+    std::array<uint32_t, MAX_LOD_COUNT> lod_instances{};  ///< Drawn instances per LOD
+
+    [[nodiscard]] uint32_t drawn() const { return first_phase + second_phase; }
+
+    /// Instances entirely outside the view frustum
+    [[nodiscard]] uint32_t outside() const { return instance_count - drawn() - occluded; }
+};
+
+/**
+ * @brief Two-phase hierarchical-Z occlusion culling of instanced spheres
+ *
+ * Keeps its own occluder depth pyramid instead of reading the depth
+ * attachment, so culling runs entirely before the render pass. Each frame:
+ * 1. every instance is tested against the previous frame's pyramid; passes
+ *    go to the draw list, occluded ones to a rejected list
+ * 2. the pyramid is rebuilt from the first phase's spheres
+ * 3. rejected instances are re-tested against it; passes are appended
+ * 4. the second phase is added to the pyramid for the next frame
+ *
+ * The draw list is then binned by projected radius into one
+ * drawIndexedIndirect per LOD mesh, so vertex and fragment work follows the
+ * visible spheres and their size on screen. Drawn spheres splat a square inside their
+ * silhouette at their farthest depth, which keeps the test conservative:
+ * a sphere is only culled behind spheres that are drawn this frame.
+ *
+ * Frame order (all in the frontend's command buffer):
+ * 1. collect() once the slot's previous frame has completed
+ * 2. record_cull() before the render pass begins
+ * 3. record_draw() per LOD in the render pass, with a pipeline whose set 1 is draw_set_layout()
+ *
+ * With occlusion off, the pyramid passes are skipped: instances are only
+ * frustum culled and binned.
+ */
+class OcclusionCuller {
+public:
+    /**
+     * @brief Create the culler and its compute pipelines
+     *
+     * @param context Vulkan context
+     * @param slot_count Frames in flight (one statistics readback each)
+     * @return Culler or error message
+     */
+    static std::expected<std::unique_ptr<OcclusionCuller>, std::string> create(
+        const VulkanContext& context,
+        uint32_t slot_count
+    );
+
+    ~OcclusionCuller();
+
+    OcclusionCuller(const OcclusionCuller&) = delete;
+    OcclusionCuller& operator=(const OcclusionCuller&) = delete;
+
+    /**
+     * @brief Size of each pyramid level, from the full extent down to 1x1
+     *
+     * Each level halves the one below, rounding up; texels on an odd edge
+     * cover the remaining row or column alone.
+     */
+    [[nodiscard]] static std::vector<vk::Extent2D> pyramid_levels(const vk::Extent2D& extent);
+
+    /**
+     * @brief Layout of the draw list set (vertex stage)
+     *
+     * Binding 0 is the visible instances grouped by LOD, binding 1 the
+     * culling state with each bucket's range (CullState in culling.slang).
+     */
+    [[nodiscard]] vk::DescriptorSetLayout draw_set_layout() const { return m_draw_layout; }
+
+    /**
+     * @brief Bind the particle buffer read by the culling passes
+     */
+    void update_particle_buffer(vk::Buffer particle_buffer);
+
+    /**
+     * @brief Read back the slot's statistics (call after its fence was waited on)
+     */
+    void collect(uint32_t slot);
+
+    [[nodiscard]] const OcclusionStatistics& latest() const { return m_latest; }
+
+    /**
+     * @brief Record both culling phases, the pyramid builds and the LOD binning
+     *
+     * Recreates the lists or the pyramid if the particle count outgrew them
+     * or the extent changed. Must be recorded outside a render pass.
+     *
+     * @param cmd Command buffer
+     * @param slot Statistics slot (frame in flight)
+     * @param particle_count Instances to cull
+     * @param view_projection Camera matrix the spheres are drawn with
+     * @param radius Sphere radius
+     * @param extent Render extent
+     * @param lods Meshes by increasing max_radius (1 to MAX_LOD_COUNT)
+     * @param occlusion Test against the depth pyramid; false: frustum culling only
+     * @return false if nothing was recorded; the caller draws unculled
+     */
+    bool record_cull(
+        vk::CommandBuffer cmd,
+        uint32_t slot,
+        uint32_t particle_count,
+        const glm::mat4& view_projection,
+        float radius,
+        const vk::Extent2D& extent,
+        std::span<const LodMesh> lods,
+        bool occlusion = true
+    );
+
+    /**
+     * @brief Bind the draw list as set 1 of `layout` and draw one LOD bucket indirectly
+     *
+     * The caller binds its pipeline, set 0, vertex and index buffers, and
+     * tells its vertex shader which bucket it reads.
+     */
+    void record_draw(vk::CommandBuffer cmd, vk::PipelineLayout layout, uint32_t lod) const;
+
+private:
+    explicit OcclusionCuller(const VulkanContext& context, uint32_t slot_count);
+
+    std::expected<void, std::string> create_descriptors();
+    std::expected<void, std::string> create_pipelines();
+    std::expected<void, std::string> create_lists(uint32_t capacity);
+    std::expected<void, std::string> create_pyramid(const vk::Extent2D& extent);
+    void destroy_lists();
+    void destroy_pyramid();
+
+    /**
+     * @brief Dispatch `count` threads of `pipeline` in chunks the group limit allows
+     */
+    void dispatch(vk::CommandBuffer cmd, vk::Pipeline pipeline, uint32_t count, uint32_t level = 0);
+
+    /**
+     * @brief Build levels 1.. from level 0
+     */
+    void record_reduce(vk::CommandBuffer cmd);
+
+    /**
+     * @brief Rebuild the pyramid from the first phase, re-test its rejects and add the second phase
+     */
+    void record_occlusion(vk::CommandBuffer cmd, uint32_t particle_count);
+
+    const VulkanContext* m_context;
+    vk::Device m_device;
+
+    // Culling state (counters + indirect draw per LOD), draw, rejected and binned lists
+    vk::Buffer m_state_buffer;
+    vk::DeviceMemory m_state_memory;
+    vk::Buffer m_visible_buffer;
+    vk::DeviceMemory m_visible_memory;
+    vk::Buffer m_rejected_buffer;
+    vk::DeviceMemory m_rejected_memory;
+    vk::Buffer m_lod_buffer;
+    vk::DeviceMemory m_lod_memory;
+    uint32_t m_capacity = 0;
+
+    // Occluder depth pyramid, all levels in one buffer
+    vk::Buffer m_pyramid_buffer;
+    vk::DeviceMemory m_pyramid_memory;
+    vk::Extent2D m_extent;
+    uint32_t m_level_count = 0;
+    bool m_pyramid_initialized = false;  ///< Holds a previous frame's depths
+
+    vk::Buffer m_particle_buffer;
+
+    // Statistics readback, one state copy per slot, persistently mapped
+    vk::Buffer m_readback_buffer;
+    vk::DeviceMemory m_readback_memory;
+    void* m_readback_mapped = nullptr;
+    struct Slot {
+        bool pending = false;
+        uint32_t instance_count = 0;
+        uint32_t lod_count = 0;
+    };
+    std::vector<Slot> m_slots;
+    OcclusionStatistics m_latest;
+
+    // Compute pipelines (one per entry point of occlusion.slang)
+    vk::DescriptorSetLayout m_descriptor_layout;
+    vk::PipelineLayout m_pipeline_layout;
+    vk::Pipeline m_cull_first_pipeline;
+    vk::Pipeline m_splat_first_pipeline;
+    vk::Pipeline m_cull_second_pipeline;
+    vk::Pipeline m_splat_second_pipeline;
+    vk::Pipeline m_reduce_pipeline;
+    vk::Pipeline m_bin_count_pipeline;
+    vk::Pipeline m_bin_offsets_pipeline;
+    vk::Pipeline m_bin_scatter_pipeline;
+
+    // Set 0: compute bindings; draw set: binned list and state for the vertex shader
+    vk::DescriptorSetLayout m_draw_layout;
+    vk::DescriptorPool m_descriptor_pool;
+    vk::DescriptorSet m_descriptor_set;
+    vk::DescriptorSet m_draw_set;
+
+    // Per-dispatch parameters (CullParams in occlusion.slang)
+    struct CullParams {
+        glm::mat4 view_projection;
+        glm::uvec2 extent;
+        float radius;
+        uint32_t particle_count;
+        uint32_t level_count;
+        uint32_t level;
+        uint32_t first;
+        uint32_t padding;
+    };
+    CullParams m_params{};
+};
+
+} // namespace ifs
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "VulkanContext.hpp"
+#include <array>
+#include <expected>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ifs {
+
+/**
+ * @brief Headless color + depth render target with host readback
+ *
+ * The render pass has the same shape as the window's (one color and one
+ * depth attachment, one subpass with the same dependencies), so frontends
+ * created against render_pass() draw into it unchanged. The color attachment
+ * is R8G8B8A8_SRGB, which matches what the swapchain shows.
+ *
+ * Readback goes through a ring of host-visible buffers so the CPU can read
+ * one result while the GPU fills the next.
+ *
+ * Usage per job:
+ * 1. Begin render_pass() on framebuffer() with clear_values(), draw, end
+ * 2. record_readback(cmd, slot)
+ * 3. After the submission's fence: pixels(slot)
+ */
+class OffscreenTarget {
+public:
+    static constexpr vk::Format COLOR_FORMAT = vk::Format::eR8G8B8A8Srgb;
+    static constexpr uint32_t BYTES_PER_PIXEL = 4;
+
+    /**
+     * @brief Create the target
+     *
+     * @param context Vulkan context
+     * @param extent Render size in pixels
+     * @param readback_slots Number of readback buffers in the ring
+     * @return Target or error message
+     */
+    static std::expected<std::unique_ptr<OffscreenTarget>, std::string> create(
+        const VulkanContext& context,
+        const vk::Extent2D& extent,
+        uint32_t readback_slots = 2
+    );
+
+    ~OffscreenTarget();
+
+    OffscreenTarget(const OffscreenTarget&) = delete;
+    OffscreenTarget& operator=(const OffscreenTarget&) = delete;
+
+    [[nodiscard]] vk::RenderPass render_pass() const { return m_render_pass; }
+    [[nodiscard]] vk::Framebuffer framebuffer() const { return m_framebuffer; }
+    [[nodiscard]] const vk::Extent2D& extent() const { return m_extent; }
+    [[nodiscard]] uint32_t readback_slots() const { return static_cast<uint32_t>(m_readbacks.size()); }
+    [[nodiscard]] size_t image_size() const {
+        return static_cast<size_t>(m_extent.width) * m_extent.height * BYTES_PER_PIXEL;
+    }
+
+    /**
+     * @brief Clear values for color (opaque black) and depth (1.0)
+     */
+    [[nodiscard]] std::array<vk::ClearValue, 2> clear_values() const;
+
+    /**
+     * @brief Copy the color attachment into a readback buffer
+     *
+     * Must be recorded after the render pass has ended.
+     */
+    void record_readback(vk::CommandBuffer cmd, uint32_t slot) const;
+
+    /**
+     * @brief Tightly packed RGBA8 rows of the slot's last readback
+     *
+     * Only valid once the submission that recorded the readback has completed.
+     */
+    [[nodiscard]] const uint8_t* pixels(uint32_t slot) const;
+
+private:
+    OffscreenTarget(const VulkanContext& context, const vk::Extent2D& extent);
+
+    std::expected<void, std::string> create_render_pass();
+    std::expected<void, std::string> create_images();
+    std::expected<void, std::string> create_readbacks(uint32_t count);
+    std::expected<vk::DeviceMemory, std::string> allocate(
+        const vk::MemoryRequirements& requirements,
+        vk::MemoryPropertyFlags preferred,
+        vk::MemoryPropertyFlags required
+    );
+
+    struct Readback {
+        vk::Buffer buffer;
+        vk::DeviceMemory memory;
+        void* mapped = nullptr;
+    };
+
+    const VulkanContext* m_context;
+    vk::Device m_device;
+    vk::Extent2D m_extent;
+    vk::Format m_depth_format = vk::Format::eUndefined;
+
+    vk::RenderPass m_render_pass;
+    vk::Image m_color_image;
+    vk::DeviceMemory m_color_memory;
+    vk::ImageView m_color_view;
+    vk::Image m_depth_image;
+    vk::DeviceMemory m_depth_memory;
+    vk::ImageView m_depth_view;
+    vk::Framebuffer m_framebuffer;
+
+    std::vector<Readback> m_readbacks;
+    bool m_readback_coherent = true;
+};
+
+} // namespace ifs
@@ -31,6 +31,28 @@ public:
         const ParticleBufferConfig& config
     );
 
+    /**
+     * @brief Import a particle buffer exported by another process (or device)
+     *
+     * The memory is shared, not copied. The exporter must run on the same
+     * physical device and driver (VulkanContext::device_uuid() and
+     * driver_uuid() match). `fd` is consumed, also on failure.
+     *
+     * @param context Vulkan context (has_external_fd())
+     * @param device Vulkan device
+     * @param config Particle count and usage of the exported buffer
+     * @param fd Descriptor from the exporter's export_fd()
+     * @param allocation_size The exporter's allocation_size()
+     * @return ParticleBuffer on success, error message on failure
+     */
+    static std::expected<ParticleBuffer, std::string> import_fd(
+        const VulkanContext& context,
+        vk::Device device,
+        const ParticleBufferConfig& config,
+        int fd,
+        vk::DeviceSize allocation_size
+    );
+
     ~ParticleBuffer();
 
     // Non-copyable
@@ -61,6 +83,39 @@ public:
             .setRange(VK_WHOLE_SIZE);
     }
 
+    /**
+     * @brief Usage flags beyond the defaults (an importer must create its buffer with the same)
+     */
+    [[nodiscard]] vk::BufferUsageFlags additional_usage_flags() const { return m_config.additional_usage_flags; }
+
+    /**
+     * @brief Whether the memory can be exported (ParticleBufferConfig::exportable) or was imported
+     */
+    [[nodiscard]] bool external() const { return m_external; }
+
+    /**
+     * @brief Identifies the memory allocation within this process
+     *
+     * Changes with every allocation, unlike the Vulkan handles, which a new
+     * allocation may recycle.
+     */
+    [[nodiscard]] uint64_t allocation_id() const { return m_allocation_id; }
+
+    /**
+     * @brief Size of the memory allocation (at least particle_count() * sizeof(Particle))
+     */
+    [[nodiscard]] vk::DeviceSize allocation_size() const { return m_allocation_size; }
+
+    /**
+     * @brief Export the memory as a POSIX file descriptor for import_fd() in another process
+     *
+     * Every call returns a new descriptor, owned by the caller. The memory
+     * stays alive while any process holds a descriptor or an import.
+     *
+     * @return Descriptor or error message (the buffer is not exportable)
+     */
+    [[nodiscard]] std::expected<int, std::string> export_fd() const;
+
     /**
      * @brief Resize the particle buffer
      *
@@ -99,22 +154,17 @@ private:
 
     /**
      * @brief Internal buffer creation
+     *
+     * @param import_fd Descriptor to import the memory from, or -1 to allocate it (consumed on success)
+     * @param import_size Allocation size of the imported memory
      */
-    std::expected<void, std::string> create_buffer();
+    std::expected<void, std::string> create_buffer(int import_fd = -1, vk::DeviceSize import_size = 0);
 
     /**
      * @brief Internal buffer cleanup
      */
     void destroy_buffer();
 
-    /**
-     * @brief Find suitable memory type
-     */
-    std::expected<uint32_t, std::string> find_memory_type(
-        uint32_t type_filter,
-        vk::MemoryPropertyFlags properties
-    ) const;
-
     const VulkanContext* m_context;
     vk::Device m_device;
     ParticleBufferConfig m_config;
@@ -123,6 +173,10 @@ private:
     vk::DeviceMemory m_memory;
     uint32_t m_particle_count;
     vk::DeviceSize m_buffer_size;
+    vk::DeviceSize m_allocation_size = 0;
+    uint64_t m_allocation_id = 0;
+    bool m_external = false;   ///< Exportable or imported memory
+    bool m_imported = false;
 };
 
 } // namespace ifs
@@ -19,14 +19,33 @@ namespace ifs {
  * - Per-particle color variation
  */
 struct Particle {
-    glm::vec3 position;  ///< World-space position (2D backends set z=0)
-    float padding1;      ///< Padding for 16-byte alignment
-    glm::vec4 color;     ///< RGBA color (0.0-1.0 range)
+    glm::vec3 position;      ///< World-space position (2D backends set z=0)
+    uint32_t palette_index;  ///< 16-bit palette coordinate, flagged with particle_palette_indexed
+    glm::vec4 color;         ///< RGBA color (0.0-1.0 range)
 
     // Total size: 32 bytes (cache-line friendly on most architectures)
 };
 static_assert(sizeof(Particle) == 32, "Particle must be exactly 32 bytes");
 
+/**
+ * @brief Flag of compact particles: only position and palette_index were written
+ *
+ * Their color is the default cosine palette at (palette_index & 0xffff) / 65536.
+ */
+inline constexpr uint32_t particle_palette_indexed = 0x80000000u;
+
+/**
+ * @brief Displayed color of a particle (particle_color in common.slang)
+ */
+[[nodiscard]] inline glm::vec4 particle_color(const Particle& particle) {
+    if ((particle.palette_index & particle_palette_indexed) == 0) {
+        return particle.color;
+    }
+    const float t = static_cast<float>(particle.palette_index & 0xffffu) / 65536.0f;
+    const glm::vec3 rgb = 0.5f + 0.5f * glm::cos(6.28318530718f * (t + glm::vec3(0.0f, 0.33f, 0.67f)));
+    return glm::vec4(glm::clamp(rgb, 0.0f, 1.0f), 1.0f);
+}
+
 /**
  * @brief Configuration for particle buffer creation
  */
@@ -39,8 +58,12 @@ struct ParticleBufferConfig {
     bool support_dynamic_resize = false;
 
     /// Additional usage flags beyond the default
-    /// Default flags: STORAGE_BUFFER_BIT | VERTEX_BUFFER_BIT
+    /// Default flags: STORAGE_BUFFER_BIT | VERTEX_BUFFER_BIT | TRANSFER_DST_BIT | TRANSFER_SRC_BIT
     vk::BufferUsageFlags additional_usage_flags = {};
+
+    /// Allocate memory that another process can import (VK_KHR_external_memory_fd, see ParticleShareServer);
+    /// implied by VulkanContext::export_particle_buffers()
+    bool exportable = false;
 };
 
 } // namespace ifs
@@ -0,0 +1,229 @@
+#pragma once
+
+#include "ParticleBuffer.hpp"
+#include "VulkanContext.hpp"
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ifs {
+
+/**
+ * @brief Shares a particle buffer with other processes over a Unix socket, without copies
+ *
+ * Each client that connects receives the buffer's memory and two timeline
+ * semaphores as file descriptors (VK_KHR_external_memory_fd,
+ * VK_KHR_external_semaphore_fd) and imports them with ParticleShareClient.
+ * When publish() is handed a different buffer (the backend reallocated it),
+ * every client is sent the new one.
+ *
+ * Writes and reads never overlap:
+ * - `written` (one for all clients) is 2g while generation g is in the
+ *   buffer and 2g + 1 while the producer overwrites it
+ * - `reading` (one per client) is odd while that client reads
+ *
+ * begin_write() makes `written` odd, then waits for every client's `reading`
+ * to turn even; a client makes its `reading` odd, then backs off while
+ * `written` is odd. A client that stays in a read longer than the write
+ * timeout (e.g. it crashed) is dropped, so the producer never stalls on it.
+ *
+ * The writer releases the buffer to VK_QUEUE_FAMILY_EXTERNAL when it is done
+ * (IFSBackend::release_particle_buffer() does so for exportable buffers),
+ * which every importer's ParticleShareClient::acquire_barrier() matches.
+ *
+ * The memory is only importable on the same physical device and driver. Use
+ * VulkanContext::set_export_particle_buffers() before the backend allocates.
+ */
+class ParticleShareServer {
+public:
+    static constexpr uint64_t DEFAULT_TIMEOUT_NS = 1'000'000'000;
+
+    /**
+     * @brief Listen on a Unix socket
+     *
+     * A socket left at the path by a previous run is replaced; any other
+     * existing file is an error and is left untouched.
+     *
+     * @param context Vulkan context with has_external_fd()
+     * @param socket_path Socket file, removed again on destruction if this server created it
+     * @return Server or error message
+     */
+    static std::expected<std::unique_ptr<ParticleShareServer>, std::string> create(
+        const VulkanContext& context,
+        std::filesystem::path socket_path
+    );
+
+    ~ParticleShareServer();
+
+    ParticleShareServer(const ParticleShareServer&) = delete;
+    ParticleShareServer& operator=(const ParticleShareServer&) = delete;
+
+    /**
+     * @brief Share `buffer`; a no-op if it is the one already shared
+     *
+     * The previous buffer's memory stays alive until this call, even if its
+     * owner freed it, because the server holds an exported descriptor.
+     */
+    std::expected<void, std::string> publish(const ParticleBuffer& buffer);
+
+    /**
+     * @brief Accept new clients and drop disconnected ones (non-blocking)
+     */
+    void poll();
+
+    /**
+     * @brief Block readers, then wait until no client is reading
+     *
+     * Call before work that writes the buffer is submitted.
+     */
+    void begin_write(uint64_t timeout_ns = DEFAULT_TIMEOUT_NS);
+
+    /**
+     * @brief The write has completed on the GPU: publish the next generation
+     */
+    void end_write();
+
+    /// Generations completed by end_write()
+    [[nodiscard]] uint64_t generation() const { return m_generation; }
+    [[nodiscard]] size_t client_count() const { return m_clients.size(); }
+    [[nodiscard]] const std::filesystem::path& socket_path() const { return m_socket_path; }
+
+private:
+    struct Client {
+        int socket = -1;
+        vk::Semaphore reading;
+        int reading_fd = -1;  ///< Exported once, sent with every buffer
+    };
+
+    ParticleShareServer(const VulkanContext& context, std::filesystem::path socket_path);
+
+    std::expected<void, std::string> listen();
+    bool send_buffer(const Client& client) const;
+    void drop_client(size_t index);
+
+    const VulkanContext* m_context;
+    vk::Device m_device;
+    std::filesystem::path m_socket_path;
+    int m_listen_socket = -1;
+    bool m_created_socket_file = false;  ///< bind() created m_socket_path
+
+    vk::Semaphore m_written;
+    int m_written_fd = -1;
+    uint64_t m_generation = 0;
+    bool m_writing = false;
+
+    // Shared buffer: what publish() last exported
+    uint64_t m_allocation_id = 0;  ///< ParticleBuffer::allocation_id()
+    int m_memory_fd = -1;
+    uint64_t m_buffer_id = 0;
+    uint32_t m_particle_count = 0;
+    vk::DeviceSize m_allocation_size = 0;
+    vk::BufferUsageFlags m_additional_usage;
+
+    std::vector<Client> m_clients;
+};
+
+/**
+ * @brief Imports the particle buffer of a ParticleShareServer in another process
+ *
+ * Reads go between begin_read() and end_read(). The buffer is not written
+ * in between; a read that is submitted to the GPU ends with the semaphore
+ * signal returned by end_read_signal() instead, so the CPU does not wait.
+ * The producer releases the buffer to VK_QUEUE_FAMILY_EXTERNAL after every
+ * write; record acquire_barrier() in the first submit of each read.
+ */
+class ParticleShareClient {
+public:
+    /**
+     * @brief Connect and import the shared buffer
+     *
+     * @param context Vulkan context on the producer's device, with has_external_fd()
+     * @param socket_path The server's socket
+     * @param timeout How long to wait for the server to send the buffer
+     * @return Client or error message (no server, different device or driver)
+     */
+    static std::expected<std::unique_ptr<ParticleShareClient>, std::string> connect(
+        const VulkanContext& context,
+        const std::filesystem::path& socket_path,
+        std::chrono::milliseconds timeout = std::chrono::seconds(5)
+    );
+
+    ~ParticleShareClient();
+
+    ParticleShareClient(const ParticleShareClient&) = delete;
+    ParticleShareClient& operator=(const ParticleShareClient&) = delete;
+
+    /**
+     * @brief Import a buffer the server published since (non-blocking)
+     *
+     * Replaces buffer(), so call it while no GPU work uses the current one.
+     *
+     * @return Whether a new buffer was imported, or an error
+     */
+    std::expected<bool, std::string> poll();
+
+    [[nodiscard]] const ParticleBuffer& buffer() const { return *m_buffer; }
+    [[nodiscard]] uint32_t particle_count() const { return m_buffer->particle_count(); }
+
+    /// Changes whenever poll() imports a new buffer
+    [[nodiscard]] uint64_t buffer_id() const { return m_buffer_id; }
+
+    /// False once the server closed the connection; the last buffer stays readable
+    [[nodiscard]] bool connected() const { return m_socket >= 0; }
+
+    /**
+     * @brief Wait until the producer is not writing and start a read
+     *
+     * @return Generation in the buffer (0 before the first end_write()), or an error on timeout
+     */
+    std::expected<uint64_t, std::string> begin_read(uint64_t timeout_ns = ParticleShareServer::DEFAULT_TIMEOUT_NS);
+
+    /**
+     * @brief End the read from the host (the GPU work reading the buffer has completed)
+     */
+    void end_read();
+
+    /**
+     * @brief End the read from the GPU: signal the semaphore to the value in the submit that reads last
+     *
+     * @return Timeline semaphore and value (vk::TimelineSemaphoreSubmitInfo)
+     */
+    [[nodiscard]] std::pair<vk::Semaphore, uint64_t> end_read_signal();
+
+    /**
+     * @brief Acquire barrier of the buffer from the external queue family
+     *
+     * Matches the producer's release after the write begin_read() returned.
+     */
+    [[nodiscard]] vk::BufferMemoryBarrier acquire_barrier(uint32_t queue_family) const;
+
+private:
+    explicit ParticleShareClient(const VulkanContext& context);
+
+    /**
+     * @brief Receive one message; import its buffer (and on the first, the semaphores)
+     *
+     * @return Whether a message was received, or an error
+     */
+    std::expected<bool, std::string> receive(bool block);
+
+    const VulkanContext* m_context;
+    vk::Device m_device;
+    int m_socket = -1;
+
+    std::optional<ParticleBuffer> m_buffer;
+    uint64_t m_buffer_id = 0;
+
+    vk::Semaphore m_written;
+    vk::Semaphore m_reading;
+    uint64_t m_read_value = 0;  ///< Last value signaled on m_reading
+    bool m_in_read = false;
+};
+
+} // namespace ifs
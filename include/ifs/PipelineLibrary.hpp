@@ -0,0 +1,122 @@
+#pragma once
+
+#include "VulkanContext.hpp"
+#include <cstdint>
+#include <expected>
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ifs {
+
+/**
+ * @brief Graphics pipelines linked from VK_EXT_graphics_pipeline_library parts
+ *
+ * add() splits a complete create info into its four library parts (vertex
+ * input, pre-rasterization shaders, fragment shader, fragment output) and
+ * reuses every part an earlier variant already compiled, so a variant that
+ * differs in one stage or state block only compiles that part. The parts are
+ * linked without link-time optimization, which is fast enough to do while
+ * the frame waits. A link with full optimization runs on a worker thread,
+ * and pipeline() switches to it once it is done.
+ *
+ * Without the extension, add() creates the pipeline monolithically, as
+ * before. The library owns every pipeline it returns; the caller keeps the
+ * layouts, render passes and shader modules alive until it is destroyed.
+ * Parts are matched by a hash of their state, ignoring pNext chains.
+ */
+class PipelineLibrary {
+public:
+    using Handle = uint32_t;
+
+    /**
+     * @brief Create an empty library
+     *
+     * @param context Vulkan context; the parts are only used if it enabled the extension
+     * @return Library or error message
+     */
+    static std::expected<std::unique_ptr<PipelineLibrary>, std::string> create(const VulkanContext& context);
+
+    /**
+     * @brief Wait for the optimizing links and destroy every pipeline and part
+     */
+    ~PipelineLibrary();
+
+    PipelineLibrary(const PipelineLibrary&) = delete;
+    PipelineLibrary& operator=(const PipelineLibrary&) = delete;
+
+    /**
+     * @brief Whether pipelines are linked from parts (false: monolithic fallback)
+     */
+    [[nodiscard]] bool uses_libraries() const { return m_uses_libraries; }
+
+    /**
+     * @brief Link a pipeline variant
+     *
+     * The pointers of `info` need only be valid for the call.
+     *
+     * @return Handle for pipeline(), or error message
+     */
+    std::expected<Handle, std::string> add(const vk::GraphicsPipelineCreateInfo& info);
+
+    /**
+     * @brief Current pipeline of a variant: the optimized one once it is ready
+     */
+    [[nodiscard]] vk::Pipeline pipeline(Handle handle);
+
+    /**
+     * @brief Whether the variant's optimized pipeline is in use
+     */
+    [[nodiscard]] bool optimized(Handle handle) const { return m_variants[handle].optimized != nullptr; }
+
+    /**
+     * @brief Block until every optimizing link has finished
+     */
+    void wait_optimized();
+
+    /**
+     * @brief Number of variants added
+     */
+    [[nodiscard]] size_t variant_count() const { return m_variants.size(); }
+
+    /**
+     * @brief Number of variants whose optimized pipeline is in use
+     */
+    [[nodiscard]] size_t optimized_count() const;
+
+    /**
+     * @brief Number of distinct parts compiled (at most 4 per variant)
+     */
+    [[nodiscard]] size_t part_count() const { return m_parts.size(); }
+
+private:
+    explicit PipelineLibrary(const VulkanContext& context);
+
+    /**
+     * @brief Reuse or compile one library part
+     *
+     * @param key Hash of the state the part depends on
+     * @param info Create info of the part (flags and pNext are set here)
+     * @param part Which part `info` describes
+     */
+    std::expected<vk::Pipeline, std::string> part(
+        uint64_t key,
+        vk::GraphicsPipelineCreateInfo info,
+        vk::GraphicsPipelineLibraryFlagsEXT part
+    );
+
+    struct Variant {
+        vk::Pipeline fast;       ///< Linked without optimization (or monolithic)
+        vk::Pipeline optimized;  ///< Set by pipeline() once the future is ready
+        std::future<vk::Pipeline> pending;
+    };
+
+    vk::Device m_device;
+    bool m_uses_libraries = false;
+    std::unordered_map<uint64_t, vk::Pipeline> m_parts;
+    std::vector<Variant> m_variants;
+};
+
+} // namespace ifs
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "VulkanContext.hpp"
+#include <expected>
+#include <memory>
+#include <string>
+
+namespace ifs {
+
+/**
+ * @brief Persistently mapped host-visible buffer that GPU copies land in
+ *
+ * Host code reads the mapping in place, so a readback costs one GPU copy and
+ * no CPU copy. Prefers HOST_CACHED memory for fast CPU reads.
+ *
+ * Held through std::shared_ptr so views into data() (e.g. NumPy arrays) can
+ * keep the allocation alive after its owner has moved on to a larger one.
+ */
+class ReadbackBuffer {
+public:
+    /**
+     * @brief Allocate and map a readback buffer
+     *
+     * @param context Vulkan context
+     * @param size Size in bytes
+     * @param usage Buffer usage (add eStorageBuffer for shaders that write results directly)
+     * @return Buffer or error message
+     */
+    static std::expected<std::shared_ptr<ReadbackBuffer>, std::string> create(
+        const VulkanContext& context,
+        vk::DeviceSize size,
+        vk::BufferUsageFlags usage = vk::BufferUsageFlagBits::eTransferDst
+    );
+
+    ~ReadbackBuffer();
+
+    ReadbackBuffer(const ReadbackBuffer&) = delete;
+    ReadbackBuffer& operator=(const ReadbackBuffer&) = delete;
+
+    [[nodiscard]] vk::Buffer buffer() const { return m_buffer; }
+    [[nodiscard]] vk::DeviceSize size() const { return m_size; }
+
+    /**
+     * @brief Make GPU writes visible to the host (no-op on coherent memory)
+     *
+     * Call after the copy's fence has signaled and before reading data().
+     */
+    void invalidate() const;
+
+    [[nodiscard]] const void* data() const { return m_mapped; }
+
+private:
+    ReadbackBuffer(vk::Device device, vk::DeviceSize size);
+
+    vk::Device m_device;
+    vk::DeviceSize m_size;
+    vk::Buffer m_buffer;
+    vk::DeviceMemory m_memory;
+    void* m_mapped = nullptr;
+    bool m_coherent = true;
+};
+
+} // namespace ifs
@@ -0,0 +1,240 @@
+#pragma once
+
+#include "VulkanContext.hpp"
+#include "Shader.hpp"
+#include "UICallback.hpp"
+#include <algorithm>
+#include <expected>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ifs {
+
+/**
+ * @brief Pipeline statistics of one frontend draw
+ *
+ * Counters come from a VK_QUERY_TYPE_PIPELINE_STATISTICS query wrapped
+ * around the particle draw (ImGui is not included).
+ */
+struct PipelineStatistics {
+    uint64_t input_assembly_primitives = 0;  ///< Points / triangles assembled
+    uint64_t vertex_invocations = 0;         ///< Vertex shader invocations
+    uint64_t clipping_invocations = 0;       ///< Primitives entering the clipper
+    uint64_t clipping_primitives = 0;        ///< Primitives leaving the clipper (survived culling)
+    uint64_t fragment_invocations = 0;       ///< Fragment shader invocations
+    uint32_t pixel_count = 0;                ///< Render area of the frame (for overdraw ratios)
+
+    /**
+     * @brief Fraction of primitives discarded by clipping (off-screen work)
+     */
+    [[nodiscard]] double clipped_fraction() const {
+        return clipping_invocations ? 1.0 - static_cast<double>(clipping_primitives) / clipping_invocations : 0.0;
+    }
+
+    /**
+     * @brief Average fragment shader invocations per pixel (depth complexity)
+     */
+    [[nodiscard]] double fragments_per_pixel() const {
+        return pixel_count ? static_cast<double>(fragment_invocations) / pixel_count : 0.0;
+    }
+};
+
+/**
+ * @brief Pipeline statistics query per frame in flight
+ *
+ * Usage per frame:
+ * 1. collect(slot) right after the slot's in-flight fence has been waited on
+ * 2. begin(cmd, slot) / end(cmd, slot) around the draw, inside one subpass
+ *
+ * Queries are reset from the host (hostQueryReset), so nothing has to be
+ * recorded outside the render pass. When the device lacks
+ * pipelineStatisticsQuery or the query is disabled every call is a no-op.
+ */
+class PipelineStatisticsQuery {
+public:
+    /**
+     * @brief Create the query pool
+     *
+     * @param context Vulkan context
+     * @param slot_count Number of frames in flight
+     * @return Query or error message
+     */
+    static std::expected<std::unique_ptr<PipelineStatisticsQuery>, std::string> create(
+        const VulkanContext& context,
+        uint32_t slot_count
+    );
+
+    ~PipelineStatisticsQuery();
+
+    PipelineStatisticsQuery(const PipelineStatisticsQuery&) = delete;
+    PipelineStatisticsQuery& operator=(const PipelineStatisticsQuery&) = delete;
+
+    [[nodiscard]] bool supported() const { return m_query_pool != nullptr; }
+
+    void set_enabled(bool enabled) { m_enabled = enabled && supported(); }
+    [[nodiscard]] bool enabled() const { return m_enabled; }
+
+    /**
+     * @brief Read back the slot's previous query (if any) and reset it
+     *
+     * @param slot Frame-in-flight index whose fence has just been waited on
+     * @param pixel_count Render area of the frame that is about to be recorded
+     */
+    void collect(uint32_t slot, uint32_t pixel_count);
+
+    void begin(vk::CommandBuffer cmd, uint32_t slot);
+    void end(vk::CommandBuffer cmd, uint32_t slot);
+
+    /**
+     * @brief Most recently collected statistics
+     */
+    [[nodiscard]] const PipelineStatistics& latest() const { return m_latest; }
+
+private:
+    PipelineStatisticsQuery(const VulkanContext& context, uint32_t slot_count);
+
+    struct Slot {
+        bool pending = false;      ///< Query recorded, result not read yet
+        uint32_t pixel_count = 0;
+    };
+
+    vk::Device m_device;
+    vk::QueryPool m_query_pool;
+    std::vector<Slot> m_slots;
+    bool m_enabled = false;
+    PipelineStatistics m_latest;
+};
+
+/**
+ * @brief Per-pixel overdraw counter rendered as a heatmap
+ *
+ * While active, the frontend draws with a count pipeline instead of its
+ * normal one: same vertex stage and vertex input, but the fragment stage only
+ * does an atomic add into an R32_UINT storage image and the depth test is
+ * off, so every rasterized fragment is counted. A fullscreen pass afterwards
+ * maps the counts to a color ramp (black, blue, green, yellow, red, white
+ * at max_count and above).
+ *
+ * Frame order (all in the frontend's command buffer):
+ * 1. record_clear() before the render pass begins
+ * 2. bind_count_pipeline() + the frontend's own draw call
+ * 3. record_resolve() in the same subpass
+ *
+ * Requires fragmentStoresAndAtomics; the subpass self-dependency for step 3
+ * is part of the window's render pass.
+ */
+class OverdrawHeatmap {
+public:
+    /**
+     * @brief Create the heatmap and its count pipeline
+     *
+     * @param context Vulkan context
+     * @param frontend_pipeline Create info of the frontend's pipeline; its
+     *        vertex stage, vertex input, input assembly, rasterization, render
+     *        pass and subpass are reused. Pointers must be valid for the call.
+     * @param frontend_set_layout Descriptor set 0 of the frontend
+     * @return Heatmap or error message
+     */
+    static std::expected<std::unique_ptr<OverdrawHeatmap>, std::string> create(
+        const VulkanContext& context,
+        const vk::GraphicsPipelineCreateInfo& frontend_pipeline,
+        vk::DescriptorSetLayout frontend_set_layout
+    );
+
+    /**
+     * @brief Whether the device can run the heatmap at all
+     */
+    [[nodiscard]] static bool supported(const VulkanContext& context);
+
+    ~OverdrawHeatmap();
+
+    OverdrawHeatmap(const OverdrawHeatmap&) = delete;
+    OverdrawHeatmap& operator=(const OverdrawHeatmap&) = delete;
+
+    /**
+     * @brief Clear the counters (creates the image at `extent` if there is none)
+     *
+     * Must be recorded outside a render pass. An image smaller than `extent`
+     * is kept until handle_swapchain_recreation(), and the frame is not counted.
+     */
+    void record_clear(vk::CommandBuffer cmd, const vk::Extent2D& extent);
+
+    /**
+     * @brief Drop the counter image; the next record_clear() creates it at the new extent
+     *
+     * Call from the frontend's handle_swapchain_recreation(), while the device is idle.
+     */
+    void handle_swapchain_recreation();
+
+    /**
+     * @brief Whether the last record_clear() left counters for the frame
+     */
+    [[nodiscard]] bool ready() const { return m_ready; }
+
+    /**
+     * @brief Bind the count pipeline with the frontend's set 0 and the counter image as set 1
+     */
+    void bind_count_pipeline(vk::CommandBuffer cmd, vk::DescriptorSet frontend_set) const;
+
+    /**
+     * @brief Draw the heatmap over the color attachment
+     */
+    void record_resolve(vk::CommandBuffer cmd) const;
+
+    void set_max_count(uint32_t count) { m_max_count = std::max(count, 1u); }
+    [[nodiscard]] uint32_t max_count() const { return m_max_count; }
+
+private:
+    explicit OverdrawHeatmap(const VulkanContext& context);
+
+    std::expected<void, std::string> create_descriptors();
+    std::expected<void, std::string> create_pipelines(
+        const vk::GraphicsPipelineCreateInfo& frontend_pipeline,
+        vk::DescriptorSetLayout frontend_set_layout
+    );
+    std::expected<void, std::string> create_image(const vk::Extent2D& extent);
+    void destroy_image();
+
+    const VulkanContext* m_context;
+    vk::Device m_device;
+
+    // Counter image (one uint per pixel)
+    vk::Image m_image;
+    vk::DeviceMemory m_image_memory;
+    vk::ImageView m_image_view;
+    vk::Extent2D m_extent;
+    bool m_image_initialized = false;  ///< Layout is eGeneral
+    bool m_ready = false;
+
+    vk::DescriptorSetLayout m_descriptor_layout;
+    vk::DescriptorPool m_descriptor_pool;
+    vk::DescriptorSet m_descriptor_set;
+
+    std::unique_ptr<Shader> m_count_shader;
+    std::unique_ptr<Shader> m_resolve_vertex_shader;
+    std::unique_ptr<Shader> m_resolve_fragment_shader;
+    vk::PipelineLayout m_count_layout;
+    vk::Pipeline m_count_pipeline;
+    vk::PipelineLayout m_resolve_layout;
+    vk::Pipeline m_resolve_pipeline;
+
+    uint32_t m_max_count = 32;
+};
+
+/**
+ * @brief UI toggles shared by all frontends for the diagnostics above
+ *
+ * Controls are only added for features the device supports.
+ *
+ * @param statistics Frontend's statistics query (may be null)
+ * @param heatmap Frontend's overdraw heatmap (may be null)
+ * @param show_overdraw Frontend flag selecting the heatmap draw path
+ */
+[[nodiscard]] std::vector<UICallback> diagnostics_ui_callbacks(
+    PipelineStatisticsQuery* statistics,
+    OverdrawHeatmap* heatmap,
+    bool& show_overdraw
+);
+
+} // namespace ifs
@@ -8,6 +8,8 @@
 #include <optional>
 #include <variant>
 #include <slang.h>			  // Main API
+#include <span>
+#include <string>
 #include <string_view>
 
 #include "Common.hpp"
@@ -159,7 +161,15 @@ class Shader
 {
 public:
 
-	static std::expected<Shader, std::string> create_shader(vk::Device device, std::string_view name, std::string_view entry_point = "main");
+	/// Compile a Slang module's entry point. Generic entry points (e.g. `main<Post : IPostStage>`) are
+	/// specialized with `specialization`, one type name per generic parameter (e.g. "Then<A, B>").
+	static std::expected<Shader, std::string> create_shader(vk::Device device, std::string_view name, std::string_view entry_point = "main",
+															std::span<const std::string> specialization = {});
+
+	/// Create the Slang session and parse/check the given modules ahead of time, so later
+	/// create_shader() calls for them skip the front end. Intended for a worker thread during
+	/// startup; must not run concurrently with create_shader(). Returns the number of modules loaded.
+	static size_t preload_modules(std::span<const std::string> names);
 
 	[[nodiscard]] const std::vector<DescriptorInfo>& get_descriptor_infos() const;
 	[[nodiscard]] const std::optional<PushConstantInfo>& get_push_constant_info() const;
@@ -0,0 +1,256 @@
+#pragma once
+
+#include "ReadbackBuffer.hpp"
+#include "Shader.hpp"
+#include "TimestampProfiler.hpp"
+#include "VulkanContext.hpp"
+#include <glm/glm.hpp>
+#include <array>
+#include <expected>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace ifs {
+
+/**
+ * @brief Grid description written by the build (matches GridInfo in spatial_grid.slang)
+ */
+struct GridInfo {
+    glm::uvec4 bounds_min;  ///< Encoded bounds, only meaningful on the GPU
+    glm::uvec4 bounds_max;
+    glm::vec4 origin;       ///< xyz: minimum corner, w: cell size
+    glm::uvec4 dims;        ///< xyz: cells per axis, w: total cells
+};
+static_assert(sizeof(GridInfo) == 64, "GridInfo must match spatial_grid.slang");
+
+/**
+ * @brief Push constants shared by all grid kernels (matches GridPush in spatial_grid.slang)
+ */
+struct GridPush {
+    glm::vec4 origin{0.0f};     ///< Ray origin or query center; w: query radius or pick cone slope
+    glm::vec4 direction{0.0f};  ///< Ray direction; w: length of one ray step
+    glm::vec4 range{0.0f};      ///< x: first t along the ray, y: last t
+    glm::uvec4 cell_min{0};     ///< xyz: first cell of the query box
+    glm::uvec4 box_dims{0};     ///< xyz: cells of the query box per axis, w: result capacity
+    glm::uvec4 counts{0};       ///< x: particles, y: allocated cells, z: grid-stride threads, w: resolution
+};
+static_assert(sizeof(GridPush) == 96, "GridPush must match spatial_grid.slang");
+
+/**
+ * @brief Spatial grid configuration
+ */
+struct SpatialGridConfig {
+    uint32_t resolution = 128;     ///< Cells along the longest axis of the particle bounds (max 256)
+    uint32_t max_results = 65536;  ///< Hits returned by one radius / nearest query
+};
+
+/**
+ * @brief One particle returned by a query
+ */
+struct SpatialHit {
+    uint32_t index;   ///< Particle index in the backend's buffer
+    float distance;   ///< Distance along the ray (pick) or from the query center
+};
+
+enum class SpatialQueryKind {
+    Pick,
+    Radius,
+    Nearest
+};
+
+/**
+ * @brief Completed query
+ */
+struct SpatialQueryResult {
+    SpatialQueryKind kind;
+    std::vector<SpatialHit> hits;  ///< Nearest first for Pick and Nearest; unordered for Radius
+    uint32_t total = 0;            ///< Matches found (may exceed hits.size() for Radius)
+    double gpu_ms = 0.0;           ///< GPU time of the query pass(es)
+};
+
+/**
+ * @brief GPU uniform grid over particle positions for picking and proximity queries
+ *
+ * build() counting-sorts particle indices by cell entirely on the GPU:
+ * bounds -> setup -> per-cell count -> two-level exclusive scan -> scatter.
+ * Queries then only touch the particles of cells near the ray or sphere:
+ * - pick(): nearest particle inside a cone around a ray (e.g. from the cursor)
+ * - query_radius(): all particles within a radius
+ * - query_nearest(): k nearest particles, by radius queries that grow until
+ *   the k-th hit is provably inside the searched sphere
+ *
+ * Everything is submitted to the graphics queue and returns immediately;
+ * poll() hands back the result once its fence has signaled. The particle
+ * buffer must be owned by the graphics queue family when build() is
+ * submitted (i.e. after the frame that acquired it).
+ *
+ * One query is in flight at a time; call wait_idle() before the backend
+ * overwrites the particle buffer.
+ */
+class SpatialGrid {
+public:
+    static constexpr uint32_t MAX_RESOLUTION = 256;
+    static constexpr uint32_t MAX_PICK_STEPS = 4096;
+
+    /**
+     * @brief Create the grid, its pipelines and buffers
+     *
+     * @param context Vulkan context
+     * @param config Resolution and query capacity
+     * @return Grid or error message
+     */
+    static std::expected<std::unique_ptr<SpatialGrid>, std::string> create(
+        const VulkanContext& context,
+        SpatialGridConfig config = {}
+    );
+
+    ~SpatialGrid();
+
+    SpatialGrid(const SpatialGrid&) = delete;
+    SpatialGrid& operator=(const SpatialGrid&) = delete;
+
+    /**
+     * @brief Rebuild the grid over a particle buffer (asynchronous)
+     *
+     * Waits for the previous build or query first, since both use the
+     * descriptor set being updated.
+     */
+    std::expected<void, std::string> build(vk::Buffer particle_buffer, uint32_t particle_count);
+
+    /**
+     * @brief Whether the last build has completed (polls its fence)
+     */
+    [[nodiscard]] bool ready();
+
+    /**
+     * @brief Grid of the last completed build
+     */
+    [[nodiscard]] const std::optional<GridInfo>& info() const { return m_info; }
+
+    /// GPU time of the last completed build
+    [[nodiscard]] double build_ms() const { return m_build_ms; }
+
+    /// Whether a query is in flight
+    [[nodiscard]] bool busy() const { return m_pending.has_value(); }
+
+    /**
+     * @brief Find the particle nearest to the ray origin inside a cone around the ray
+     *
+     * @param origin Ray origin (camera position)
+     * @param direction Ray direction (normalized)
+     * @param cone_slope Accepted distance from the ray per unit of t (e.g. pick radius in pixels / focal length)
+     */
+    std::expected<void, std::string> pick(const glm::vec3& origin, const glm::vec3& direction, float cone_slope);
+
+    /**
+     * @brief Find all particles within a radius of a point
+     */
+    std::expected<void, std::string> query_radius(const glm::vec3& center, float radius);
+
+    /**
+     * @brief Find the k nearest particles to a point
+     */
+    std::expected<void, std::string> query_nearest(const glm::vec3& center, uint32_t k);
+
+    /**
+     * @brief Result of the query in flight once it has completed
+     *
+     * Non-blocking. Nearest queries may resubmit with a larger radius and
+     * return nothing until they have converged.
+     */
+    std::optional<SpatialQueryResult> poll();
+
+    /**
+     * @brief Block until the build and any query have completed
+     */
+    void wait_idle();
+
+private:
+    enum class Kernel : uint32_t {
+        Bounds,
+        Setup,
+        Count,
+        ScanBlocks,
+        ScanSums,
+        ScanAdd,
+        Scatter,
+        Pick,
+        Radius,
+        Count_
+    };
+
+    struct PendingQuery {
+        SpatialQueryKind kind;
+        glm::vec3 center{0.0f};
+        float radius = 0.0f;
+        float lower_radius = 0.0f;  ///< Nearest: largest radius known to hold fewer than k
+        float upper_radius = 0.0f;  ///< Nearest: smallest radius known to overflow (0: none yet)
+        uint32_t k = 0;
+        uint32_t steps = 0;  ///< Pick: result slots written
+        double gpu_ms = 0.0; ///< Accumulated over nearest-query rounds
+    };
+
+    SpatialGrid(const VulkanContext& context, SpatialGridConfig config);
+
+    std::expected<void, std::string> initialize();
+    std::expected<void, std::string> create_pipelines();
+    std::expected<void, std::string> create_buffers();
+    std::expected<void, std::string> create_commands();
+
+    std::expected<vk::Buffer, std::string> create_device_buffer(vk::DeviceSize size, vk::DeviceMemory& memory);
+
+    void bind(vk::CommandBuffer cmd, Kernel kernel, const GridPush& push) const;
+    static void compute_barrier(vk::CommandBuffer cmd);
+
+    /// Start recording a query; the caller records kernels then calls submit_query()
+    std::expected<vk::CommandBuffer, std::string> begin_query();
+    std::expected<void, std::string> submit_query(vk::CommandBuffer cmd, PendingQuery pending);
+    void record_radius(vk::CommandBuffer cmd, const glm::vec3& center, float radius) const;
+
+    const VulkanContext* m_context;
+    vk::Device m_device;
+    SpatialGridConfig m_config;
+    uint32_t m_cell_capacity = 0;
+
+    std::vector<Shader> m_shaders;
+    vk::DescriptorSetLayout m_descriptor_layout;
+    vk::PipelineLayout m_pipeline_layout;
+    std::array<vk::Pipeline, static_cast<size_t>(Kernel::Count_)> m_pipelines{};
+    vk::DescriptorPool m_descriptor_pool;
+    vk::DescriptorSet m_descriptor_set;
+
+    vk::Buffer m_grid_buffer;
+    vk::DeviceMemory m_grid_memory;
+    vk::Buffer m_cell_counts;
+    vk::DeviceMemory m_cell_counts_memory;
+    vk::Buffer m_cell_start;
+    vk::DeviceMemory m_cell_start_memory;
+    vk::Buffer m_block_sums;
+    vk::DeviceMemory m_block_sums_memory;
+    vk::Buffer m_sorted_indices;
+    vk::DeviceMemory m_sorted_indices_memory;
+    uint32_t m_sorted_capacity = 0;  ///< Particles m_sorted_indices can hold
+
+    std::shared_ptr<ReadbackBuffer> m_results;   ///< Query output, written by the kernels directly
+    std::shared_ptr<ReadbackBuffer> m_info_readback;
+
+    vk::CommandPool m_command_pool;
+    vk::CommandBuffer m_build_cmd;
+    vk::CommandBuffer m_query_cmd;
+    vk::Fence m_build_fence;
+    vk::Fence m_query_fence;
+    std::unique_ptr<TimestampProfiler> m_build_profiler;
+    std::unique_ptr<TimestampProfiler> m_query_profiler;
+    uint32_t m_query_scope = UINT32_MAX;  ///< Scope begun by begin_query(), ended by submit_query()
+
+    vk::Buffer m_particle_buffer;
+    uint32_t m_particle_count = 0;
+    bool m_build_pending = false;
+    std::optional<GridInfo> m_info;
+    double m_build_ms = 0.0;
+    std::optional<PendingQuery> m_pending;
+};
+
+} // namespace ifs
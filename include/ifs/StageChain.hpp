@@ -0,0 +1,144 @@
+#pragma once
+
+#include "VulkanContext.hpp"
+#include <glm/glm.hpp>
+#include <array>
+#include <expected>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ifs {
+
+/**
+ * @brief Final transforms applied to every orbit after generation
+ */
+enum class PostStage : uint32_t {
+    GlobalScale,  ///< Scale around 0.5 by IFSParameters::scale
+    FinalAffine,  ///< StageSettings::final_linear / final_offset
+    Spherical,    ///< Inversion in the sphere of radius 0.5 around the center
+    Swirl         ///< Rotation about z by StageSettings::swirl * r^2
+};
+
+/**
+ * @brief How a particle's color is derived
+ */
+enum class ColorStage : uint32_t {
+    Orbit,           ///< Color accumulated while iterating
+    Radial,          ///< Yellow, brighter with distance from the origin
+    PositionPalette, ///< Cosine palette over x (StageSettings::palette)
+    History          ///< Cosine palette over the address of the last transform choices
+};
+
+/**
+ * @brief What is stored per particle
+ */
+enum class WriteStage : uint32_t {
+    Particle,  ///< Position and color
+    Position,  ///< Position only, keeping the previous colors
+    Indexed    ///< Position and a history palette index (16 of 32 bytes; shown with the default palette)
+};
+
+/// Slang type names (shaders/ifs_modular/stages.slang)
+[[nodiscard]] std::string_view to_string(PostStage stage);
+[[nodiscard]] std::string_view to_string(ColorStage stage);
+[[nodiscard]] std::string_view to_string(WriteStage stage);
+
+/**
+ * @brief Declarative post -> color -> write chain following a backend's generation stage
+ *
+ * Backends compile their kernel with specialization() as the type arguments of
+ * its generic entry point, so Slang fuses the chain into the generation loop:
+ * adding a stage costs arithmetic, not a pass over the particle buffer.
+ *
+ * Chains without GlobalScale ignore IFSParameters::scale.
+ */
+struct StageChain {
+    std::vector<PostStage> post{PostStage::GlobalScale};  ///< Applied in order
+    ColorStage color = ColorStage::Orbit;
+    WriteStage write = WriteStage::Particle;
+
+    bool operator==(const StageChain&) const = default;
+
+    /**
+     * @brief Type arguments for the kernel's `main<Post, Color, Write>`
+     *
+     * Post stages fold into `Then<A, Then<B, C>>`; an empty list is `NoPost`.
+     */
+    [[nodiscard]] std::vector<std::string> specialization() const;
+
+    /// Human-readable chain, e.g. "GlobalScale > Swirl | OrbitColor | WriteParticle"
+    [[nodiscard]] std::string describe() const;
+};
+
+/**
+ * @brief Values read by the stages
+ */
+struct StageSettings {
+    glm::mat3 final_linear{1.0f};  ///< FinalAffine linear part (should be invertible for warm starts)
+    glm::vec3 final_offset{0.0f};
+    float swirl = 4.0f;            ///< Swirl radians per squared distance from the axis
+    /// Cosine palette a, b, c, d: a + b * cos(2 pi (c * t + d))
+    std::array<glm::vec3, 4> palette{
+        glm::vec3(0.5f), glm::vec3(0.5f), glm::vec3(1.0f), glm::vec3(0.0f, 0.33f, 0.67f)
+    };
+
+    bool operator==(const StageSettings&) const = default;
+};
+
+/**
+ * @brief StageParams in stages.slang
+ */
+struct GPUStageParams {
+    glm::vec4 final_rows[3];
+    glm::vec4 final_inverse[3];
+    glm::vec4 palette[4];
+    float scale;
+    float swirl;
+    float padding[2];
+};
+static_assert(sizeof(GPUStageParams) == 208, "GPUStageParams must match stages.slang");
+
+/**
+ * @brief Pack settings and the global scale for the GPU
+ */
+[[nodiscard]] GPUStageParams make_stage_params(const StageSettings& settings, float scale);
+
+/**
+ * @brief Persistently mapped uniform buffer with the stage parameters of the
+ *        current compute and of the one before (StageUniforms in stages.slang)
+ *
+ * The previous parameters let warm starts undo the post stages on the
+ * positions already in the buffer.
+ */
+class StageUniformBuffer {
+public:
+    static std::expected<std::unique_ptr<StageUniformBuffer>, std::string> create(const VulkanContext& context);
+
+    ~StageUniformBuffer();
+
+    StageUniformBuffer(const StageUniformBuffer&) = delete;
+    StageUniformBuffer& operator=(const StageUniformBuffer&) = delete;
+
+    /**
+     * @brief Write the parameters of the next compute; the last ones become `previous`
+     *
+     * Only call once the previous compute has completed.
+     */
+    void upload(const GPUStageParams& params);
+
+    [[nodiscard]] vk::DescriptorBufferInfo descriptor_info() const;
+
+private:
+    explicit StageUniformBuffer(vk::Device device);
+
+    vk::Device m_device;
+    vk::Buffer m_buffer;
+    vk::DeviceMemory m_memory;
+    GPUStageParams* m_mapped = nullptr;  ///< [0]: current, [1]: previous
+    bool m_uploaded = false;
+};
+
+} // namespace ifs
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "Metrics.hpp"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ifs {
+
+/**
+ * @brief One timed startup phase
+ */
+struct StartupPhase {
+    std::string name;
+    double begin_ms;       ///< Since process start
+    double duration_ms;
+    bool main_thread;      ///< False for work overlapped on a worker thread
+};
+
+/**
+ * @brief Phase-by-phase timeline of application startup
+ *
+ * Phases are recorded until finish() is called when the first frame has been
+ * presented; after that phase() is a no-op, so code shared with steady-state
+ * paths (e.g. shader compilation) can be instrumented unconditionally.
+ *
+ * finish() logs the timeline and publishes `ifs_time_to_first_frame_ms` and
+ * `ifs_startup_phase_ms{phase="..."}` gauges to the metrics registry.
+ *
+ * Usage:
+ *   {
+ *       auto _ = StartupTrace::instance().phase("vulkan_context");
+ *       ...
+ *   }
+ */
+class StartupTrace {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief RAII scope that records a phase when destroyed
+     */
+    class Scope {
+    public:
+        Scope(StartupTrace* trace, std::string name);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        Scope(Scope&& other) noexcept;
+        Scope& operator=(Scope&&) = delete;
+
+    private:
+        StartupTrace* m_trace;  ///< Null if not recording
+        std::string m_name;
+        Clock::time_point m_begin;
+    };
+
+    /**
+     * @brief Process-wide trace; its origin is static initialization time
+     */
+    static StartupTrace& instance();
+
+    /**
+     * @brief Start a trace whose origin is now and whose main thread is the caller
+     */
+    StartupTrace();
+
+    StartupTrace(const StartupTrace&) = delete;
+    StartupTrace& operator=(const StartupTrace&) = delete;
+
+    /**
+     * @brief Time a phase until the returned scope is destroyed
+     */
+    [[nodiscard]] Scope phase(std::string name);
+
+    /**
+     * @brief Record a phase with explicit bounds (e.g. measured on another thread)
+     */
+    void record(std::string name, Clock::time_point begin, Clock::time_point end);
+
+    /**
+     * @brief Stop recording, log the timeline and publish the metrics
+     *
+     * Only the first call has an effect.
+     *
+     * @param registry Registry receiving the gauges
+     * @return Time to first frame in milliseconds
+     */
+    double finish(MetricsRegistry& registry = MetricsRegistry::instance());
+
+    [[nodiscard]] bool finished() const { return m_finished.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Phases recorded so far, in order of their begin time
+     */
+    [[nodiscard]] std::vector<StartupPhase> phases() const;
+
+    /**
+     * @brief Milliseconds since the trace origin
+     */
+    [[nodiscard]] double elapsed_ms() const;
+
+private:
+    [[nodiscard]] double to_ms(Clock::time_point time) const;
+
+    mutable std::mutex m_mutex;
+    Clock::time_point m_origin;
+    std::thread::id m_main_thread;
+    std::vector<StartupPhase> m_phases;
+    std::atomic<bool> m_finished{false};
+    double m_first_frame_ms = 0.0;
+};
+
+} // namespace ifs
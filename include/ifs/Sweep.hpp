@@ -0,0 +1,177 @@
+#pragma once
+
+#include "IFSBackend.hpp"
+#include "IFSFrontend.hpp"
+#include "OffscreenTarget.hpp"
+#include "VulkanContext.hpp"
+#include <glm/glm.hpp>
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ifs {
+
+class Camera3D;
+
+/**
+ * @brief Camera overrides of one sweep job (unset fields keep Camera3D's defaults)
+ */
+struct SweepCamera {
+    std::optional<glm::vec3> target;
+    std::optional<float> distance;
+    std::optional<float> azimuth;    ///< Degrees
+    std::optional<float> elevation;  ///< Degrees
+
+    /**
+     * @brief Reset the camera to its defaults, then apply the overrides
+     */
+    void apply(Camera3D& camera) const;
+};
+
+/**
+ * @brief One render of a parameter sweep
+ */
+struct SweepJob {
+    std::string name;      ///< Output file stem, unique within a sweep
+    IFSParameters params;  ///< Seed and scale
+    /// Backend / frontend UI parameters set by field name before the job, e.g. {"Iteration Count", 50}
+    std::vector<std::pair<std::string, float>> settings;
+    SweepCamera camera;
+};
+
+/**
+ * @brief Parse a sweep specification into jobs
+ *
+ * One line per preset; blank lines and lines starting with '#' are skipped.
+ * A line is a list of whitespace-separated key=value pairs:
+ *
+ *   name=fern seed=1..4 scale=0.5,1,2 param.Iteration_Count=50 camera.azimuth=0:90:4
+ *
+ * Every value except name may be a list, and a line expands to the cartesian
+ * product of its lists (the first key varies slowest). List items are
+ * comma-separated and each one is a number, an inclusive integer range
+ * `a..b`, or `a:b:n` for n evenly spaced values from a to b.
+ *
+ * Keys:
+ * - name: job name prefix (default "job<line>"); expanded jobs get a _NNNN suffix.
+ *   No path separators: names are file stems in the output directory
+ * - seed, scale: IFSParameters fields
+ * - param.<Field>: UI parameter of the backend or frontend ('_' matches a space)
+ * - camera.distance, camera.azimuth, camera.elevation,
+ *   camera.target_x, camera.target_y, camera.target_z
+ *
+ * @return Jobs in file order or an error naming the offending line
+ */
+[[nodiscard]] std::expected<std::vector<SweepJob>, std::string> parse_sweep_spec(std::string_view text);
+
+/**
+ * @brief Summary of one rendered RGBA8 image
+ */
+struct ImageStatistics {
+    double coverage = 0.0;        ///< Fraction of pixels that aren't black
+    double mean_luminance = 0.0;  ///< Mean Rec. 709 luma of all pixels, 0..1 (sRGB-encoded values)
+    uint32_t min_x = 0, min_y = 0, max_x = 0, max_y = 0;  ///< Bounds of the covered pixels (all 0 if none)
+};
+
+/**
+ * @brief Compute image statistics of tightly packed RGBA8 pixels
+ */
+[[nodiscard]] ImageStatistics compute_image_statistics(const uint8_t* rgba, uint32_t width, uint32_t height);
+
+/**
+ * @brief Write tightly packed RGBA8 pixels as a binary PPM (alpha dropped)
+ */
+[[nodiscard]] bool write_ppm(const std::filesystem::path& path, const uint8_t* rgba, uint32_t width, uint32_t height);
+
+/**
+ * @brief What a sweep writes per job
+ */
+struct SweepOptions {
+    std::filesystem::path output_dir = "sweep";
+    bool write_images = true;      ///< <output_dir>/<name>.ppm
+    bool write_statistics = true;  ///< One JSON line per job in <output_dir>/statistics.jsonl
+};
+
+/**
+ * @brief Outcome of a sweep
+ */
+struct SweepReport {
+    size_t jobs = 0;
+    size_t failed = 0;  ///< Jobs whose outputs could not be written
+    double seconds = 0.0;
+    [[nodiscard]] double jobs_per_second() const { return seconds > 0.0 ? jobs / seconds : 0.0; }
+};
+
+/**
+ * @brief Renders sweep jobs headlessly, reusing one backend, frontend and target
+ *
+ * Create the runner first, then create the frontend against render_pass().
+ *
+ * Jobs share the backend's particle buffer, so on the GPU each job's compute
+ * waits for the previous job's draw. Everything after the draw is
+ * overlapped: the readback copy lands in a ring slot, and encoding, statistics
+ * and file output run on a worker thread while the next job computes and
+ * renders.
+ */
+class SweepRunner {
+public:
+    /**
+     * @brief Create the runner and its offscreen target
+     *
+     * @param context Vulkan context
+     * @param extent Image size
+     * @param options Output options
+     * @return Runner or error message
+     */
+    static std::expected<std::unique_ptr<SweepRunner>, std::string> create(
+        const VulkanContext& context,
+        const vk::Extent2D& extent,
+        SweepOptions options
+    );
+
+    ~SweepRunner();
+
+    SweepRunner(const SweepRunner&) = delete;
+    SweepRunner& operator=(const SweepRunner&) = delete;
+
+    /**
+     * @brief Render pass frontends must be created with
+     */
+    [[nodiscard]] vk::RenderPass render_pass() const { return m_target->render_pass(); }
+    [[nodiscard]] const vk::Extent2D& extent() const { return m_target->extent(); }
+
+    /**
+     * @brief Run all jobs
+     *
+     * @param jobs Jobs to render
+     * @param backend Backend producing the particles
+     * @param frontend Frontend created with render_pass()
+     * @return Report, or an error if the sweep could not run at all
+     */
+    std::expected<SweepReport, std::string> run(
+        const std::vector<SweepJob>& jobs,
+        IFSBackend& backend,
+        IFSFrontend& frontend
+    );
+
+private:
+    SweepRunner(const VulkanContext& context, SweepOptions options);
+
+    std::expected<void, std::string> initialize(const vk::Extent2D& extent);
+
+    const VulkanContext* m_context;
+    vk::Device m_device;
+    SweepOptions m_options;
+
+    std::unique_ptr<OffscreenTarget> m_target;
+    vk::CommandPool m_command_pool;
+    std::vector<vk::CommandBuffer> m_command_buffers;  ///< One per readback slot
+    std::vector<vk::Fence> m_fences;                   ///< One per readback slot
+};
+
+} // namespace ifs
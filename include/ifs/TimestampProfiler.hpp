@@ -0,0 +1,108 @@
+#pragma once
+
+#include "VulkanContext.hpp"
+#include <expected>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ifs {
+
+/**
+ * @brief Resolved GPU time of one profiled scope
+ */
+struct TimestampScope {
+    std::string name;
+    double begin_ms;     ///< Start relative to the earliest scope of the frame
+    double duration_ms;  ///< End - begin
+};
+
+/**
+ * @brief GPU timestamp profiler backed by a single query pool
+ *
+ * Each scope consumes two timestamp queries. Scopes may be recorded into
+ * command buffers of different queues as long as they share the device
+ * timestamp domain (all queues of one VkDevice do).
+ *
+ * Usage per frame:
+ * 1. reset() on the host before any command buffer that writes scopes is submitted
+ * 2. begin_scope()/end_scope() while recording
+ * 3. resolve() after the GPU work has completed (e.g. after a fence wait)
+ *
+ * The pool is reset from the host (Vulkan 1.2 hostQueryReset), so no command
+ * buffer has to be ordered before the others on multi-queue workloads.
+ */
+class TimestampProfiler {
+public:
+    /**
+     * @brief Create a profiler
+     *
+     * @param context Vulkan context
+     * @param max_scopes Maximum number of scopes between two reset() calls
+     * @param queue_family Queue family the scopes are recorded on (for timestampValidBits)
+     * @return Profiler or error message
+     */
+    static std::expected<std::unique_ptr<TimestampProfiler>, std::string> create(
+        const VulkanContext& context,
+        uint32_t max_scopes,
+        uint32_t queue_family
+    );
+
+    ~TimestampProfiler();
+
+    TimestampProfiler(const TimestampProfiler&) = delete;
+    TimestampProfiler& operator=(const TimestampProfiler&) = delete;
+
+    /**
+     * @brief Whether the queue family supports timestamps at all
+     *
+     * When false every call is a no-op and resolve() returns nothing.
+     */
+    [[nodiscard]] bool supported() const { return m_valid_bits != 0; }
+
+    /**
+     * @brief Reset all queries and forget previously recorded scopes (host side)
+     */
+    void reset();
+
+    /**
+     * @brief Write the begin timestamp of a new scope
+     *
+     * @return Scope handle for end_scope(), or UINT32_MAX if the pool is full
+     */
+    uint32_t begin_scope(
+        vk::CommandBuffer cmd,
+        std::string_view name,
+        vk::PipelineStageFlagBits stage = vk::PipelineStageFlagBits::eTopOfPipe
+    );
+
+    /**
+     * @brief Write the end timestamp of a scope
+     */
+    void end_scope(
+        vk::CommandBuffer cmd,
+        uint32_t scope,
+        vk::PipelineStageFlagBits stage = vk::PipelineStageFlagBits::eBottomOfPipe
+    );
+
+    /**
+     * @brief Read back all scopes recorded since the last reset()
+     *
+     * Must only be called once the recorded command buffers have completed.
+     */
+    [[nodiscard]] std::vector<TimestampScope> resolve() const;
+
+private:
+    TimestampProfiler(const VulkanContext& context, uint32_t max_scopes);
+
+    vk::Device m_device;
+    vk::QueryPool m_query_pool;
+    uint32_t m_max_scopes;
+    uint32_t m_valid_bits = 0;
+    double m_ns_per_tick = 1.0;
+
+    std::vector<std::string> m_scope_names;
+};
+
+} // namespace ifs
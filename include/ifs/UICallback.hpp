@@ -5,9 +5,14 @@
 #ifndef ITERATEDFUNCTIONS_UICALLBACK_HPP
 #define ITERATEDFUNCTIONS_UICALLBACK_HPP
 
+#include <algorithm>
+#include <cctype>
+#include <cmath>
 #include <functional>
 #include <variant>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "Common.hpp"
 
@@ -96,8 +101,58 @@ struct UICallback
 	[[nodiscard]] const ToggleCallback* as_toggle() const {
 		return std::get_if<ToggleCallback>(&callback);
 	}
+
+	/**
+	 * @brief Set the parameter from a float (rounded for discrete, non-zero for toggle)
+	 */
+	void set_value(float value) const
+	{
+		std::visit(
+			overloaded{
+				[value](const ContinuousCallback& cb) { cb.setter(value); },
+				[value](const DiscreteCallback& cb) { cb.setter(static_cast<int>(std::lround(value))); },
+				[value](const ToggleCallback& cb) { cb.setter(value != 0.0f); },
+			},
+			callback);
+	}
+
+	/**
+	 * @brief Current value of the parameter as a float
+	 */
+	[[nodiscard]] float value() const
+	{
+		return std::visit(
+			overloaded{
+				[](const ContinuousCallback& cb) { return cb.getter(); },
+				[](const DiscreteCallback& cb) { return static_cast<float>(cb.getter()); },
+				[](const ToggleCallback& cb) { return cb.getter() ? 1.0f : 0.0f; },
+			},
+			callback);
+	}
 };
 
+/**
+ * @brief Find a callback by field name for scripted access
+ *
+ * Matching is case-insensitive and '_' matches a space, so "iteration_count"
+ * finds "Iteration Count".
+ */
+[[nodiscard]] inline const UICallback* find_ui_callback(const std::vector<UICallback>& callbacks, std::string_view name)
+{
+	auto normalize = [](char c) {
+		return c == '_' ? ' ' : static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+	};
+	for (const auto& callback : callbacks) {
+		const auto& field = callback.field_name;
+		if (field.size() == name.size() &&
+			std::equal(field.begin(), field.end(), name.begin(),
+				[&](char a, char b) { return normalize(a) == normalize(b); })) {
+			return &callback;
+		}
+	}
+	return nullptr;
+}
+
 } // namespace ifs
 
 #endif // ITERATEDFUNCTIONS_UICALLBACK_HPP
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "VulkanContext.hpp"
+#include "Shader.hpp"
+#include <vulkan/vulkan.hpp>
+#include <expected>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace ifs {
+
+/**
+ * @brief Deferred shading through a visibility buffer
+ *
+ * For frontends whose fragment shading is expensive: instead of shading
+ * every rasterized fragment, the geometry is drawn into this class' own
+ * render pass with a fragment stage that only writes the instance index of
+ * the nearest surface (with depth). A compute pass then shades each covered
+ * pixel once, fetching the instance's data itself, and a fullscreen pass
+ * composites the result and its depth into the frontend's color and depth
+ * attachments. Shading cost follows the resolution, not the overdraw.
+ *
+ * Frame order (all in the frontend's command buffer):
+ * 1. begin() outside a render pass, then the frontend's draw with pipelines
+ *    built against render_pass()
+ * 2. end_and_shade() ends the visibility pass and dispatches the shading pass
+ * 3. record_composite() inside the frontend's render pass
+ *
+ * The shading shader gets the frontend's set 0 and, as set 1, the visibility
+ * image (binding 0, r32ui, EMPTY where nothing was drawn) and the shaded
+ * image (binding 1, rgba16f). Its push constant is the extent (uint2), and
+ * it runs in 8x8 groups. Pixels left EMPTY need not be written.
+ */
+class VisibilityBuffer {
+public:
+    static constexpr vk::Format ID_FORMAT = vk::Format::eR32Uint;
+    static constexpr vk::Format SHADED_FORMAT = vk::Format::eR16G16B16A16Sfloat;
+    static constexpr uint32_t EMPTY = 0xffffffffu;
+
+    /**
+     * @brief Create the visibility render pass, the shading and composite pipelines
+     *
+     * @param context Vulkan context
+     * @param frontend_pipeline Create info of the frontend's pipeline; its render
+     *        pass, subpass, viewport, multisample and dynamic state are reused
+     *        for the composite. Pointers must be valid for the call.
+     * @param frontend_set_layout Descriptor set 0 of the frontend (compute stage visible)
+     * @param shade_shader Shading compute shader
+     * @param shade_entry Its entry point
+     * @return Visibility buffer or error message
+     */
+    static std::expected<std::unique_ptr<VisibilityBuffer>, std::string> create(
+        const VulkanContext& context,
+        const vk::GraphicsPipelineCreateInfo& frontend_pipeline,
+        vk::DescriptorSetLayout frontend_set_layout,
+        std::string_view shade_shader,
+        std::string_view shade_entry = "main"
+    );
+
+    ~VisibilityBuffer();
+
+    VisibilityBuffer(const VisibilityBuffer&) = delete;
+    VisibilityBuffer& operator=(const VisibilityBuffer&) = delete;
+
+    /**
+     * @brief Render pass of the visibility pass: one ID_FORMAT color attachment and depth
+     */
+    [[nodiscard]] vk::RenderPass render_pass() const { return m_render_pass; }
+
+    /**
+     * @brief Begin the visibility pass (recreates the images if the extent changed)
+     *
+     * Must be recorded outside a render pass.
+     *
+     * @return false if nothing was begun; the frontend shades as usual
+     */
+    bool begin(vk::CommandBuffer cmd, const vk::Extent2D& extent);
+
+    /**
+     * @brief End the visibility pass and shade its pixels
+     *
+     * @param cmd Command buffer
+     * @param frontend_set The frontend's set 0
+     */
+    void end_and_shade(vk::CommandBuffer cmd, vk::DescriptorSet frontend_set);
+
+    /**
+     * @brief Draw the shaded pixels and their depth over the frontend's attachments
+     *
+     * @param cmd Command buffer
+     * @param origin Top-left corner of the viewport the visibility pass was drawn for
+     */
+    void record_composite(vk::CommandBuffer cmd, vk::Offset2D origin = {}) const;
+
+private:
+    explicit VisibilityBuffer(const VulkanContext& context);
+
+    std::expected<void, std::string> create_render_pass();
+    std::expected<void, std::string> create_descriptors();
+    std::expected<void, std::string> create_pipelines(
+        const vk::GraphicsPipelineCreateInfo& frontend_pipeline,
+        vk::DescriptorSetLayout frontend_set_layout,
+        std::string_view shade_shader,
+        std::string_view shade_entry
+    );
+    std::expected<void, std::string> create_images(const vk::Extent2D& extent);
+    void destroy_images();
+
+    const VulkanContext* m_context;
+    vk::Device m_device;
+    vk::Format m_depth_format = vk::Format::eUndefined;
+    vk::RenderPass m_render_pass;
+
+    // Visibility (instance index) and depth attachments, shaded colors
+    struct Image {
+        vk::Image image;
+        vk::DeviceMemory memory;
+        vk::ImageView view;
+    };
+    Image m_ids{};
+    Image m_depth{};
+    Image m_shaded{};
+    vk::Framebuffer m_framebuffer;
+    vk::Extent2D m_extent;
+    bool m_shaded_initialized = false;  ///< Layout is eGeneral
+
+    // One set for both passes: ids, shaded, depth (composite only)
+    vk::DescriptorSetLayout m_descriptor_layout;
+    vk::DescriptorPool m_descriptor_pool;
+    vk::DescriptorSet m_descriptor_set;
+
+    std::unique_ptr<Shader> m_shade_shader;
+    std::unique_ptr<Shader> m_composite_vertex_shader;
+    std::unique_ptr<Shader> m_composite_fragment_shader;
+    vk::PipelineLayout m_shade_layout;
+    vk::Pipeline m_shade_pipeline;
+    vk::PipelineLayout m_composite_layout;
+    vk::Pipeline m_composite_pipeline;
+};
+
+} // namespace ifs
@@ -6,12 +6,16 @@
 #define ITERATEDFUNCTIONS_VULKANCONTEXT_HPP
 
 #include "Common.hpp"
+#include <array>
+#include <optional>
 #include <string_view>
+#include <vector>
 
 struct QueueFamilyIndices
 {
 	uint32_t graphics;
 	uint32_t compute;
+	uint32_t compute_queue_count = 1; // Queues created in the compute family
 
 	[[nodiscard]] bool has_dedicated_compute() const { return compute != graphics; }
 };
@@ -32,7 +36,30 @@ public:
 	[[nodiscard]] vk::Device device() const { return m_device; }
 	[[nodiscard]] const QueueFamilyIndices& queue_indices() const { return m_queue_indices; }
 	[[nodiscard]] vk::Queue graphics_queue() const { return m_graphics_queue; }
-	[[nodiscard]] vk::Queue compute_queue() const { return m_compute_queue; }
+	[[nodiscard]] vk::Queue compute_queue() const { return m_compute_queues.front(); }
+	/// All queues of the compute family; index 0 is the one returned by compute_queue()
+	[[nodiscard]] const std::vector<vk::Queue>& compute_queues() const { return m_compute_queues; }
+	/// Whether VK_EXT_memory_budget is enabled (per-heap usage and budget can be queried)
+	[[nodiscard]] bool has_memory_budget() const { return m_memory_budget; }
+	/// Whether VK_EXT_graphics_pipeline_library is enabled (pipelines can be linked from parts)
+	[[nodiscard]] bool has_graphics_pipeline_library() const { return m_graphics_pipeline_library; }
+	/// Whether the multiview feature is enabled (render passes can draw several views at once)
+	[[nodiscard]] bool has_multiview() const { return m_multiview; }
+	/// Whether VK_KHR_present_id and VK_KHR_present_wait are enabled (Window::wait_for_present())
+	[[nodiscard]] bool has_present_wait() const { return m_present_wait; }
+	/// Whether VK_KHR_external_memory_fd, VK_KHR_external_semaphore_fd and timeline semaphores are enabled
+	[[nodiscard]] bool has_external_fd() const { return m_external_fd; }
+
+	/// Identify the physical device and driver: external memory imports only where both match the exporter's
+	[[nodiscard]] std::array<uint8_t, VK_UUID_SIZE> device_uuid() const;
+	[[nodiscard]] std::array<uint8_t, VK_UUID_SIZE> driver_uuid() const;
+
+	/// First memory type allowed by `type_bits` (from vk::MemoryRequirements) that has all of `flags`
+	[[nodiscard]] std::optional<uint32_t> find_memory_type(uint32_t type_bits, vk::MemoryPropertyFlags flags) const;
+
+	/// Allocate every ParticleBuffer with exportable memory (see ParticleShareServer); needs has_external_fd()
+	void set_export_particle_buffers(bool enabled) { m_export_particle_buffers = enabled && m_external_fd; }
+	[[nodiscard]] bool export_particle_buffers() const { return m_export_particle_buffers; }
 
 private:
 	vk::Instance m_instance;
@@ -41,6 +68,12 @@ private:
 	QueueFamilyIndices m_queue_indices;
 	vk::Device m_device;
 	vk::Queue m_graphics_queue;
-	vk::Queue m_compute_queue;
+	std::vector<vk::Queue> m_compute_queues;
+	bool m_memory_budget = false;
+	bool m_graphics_pipeline_library = false;
+	bool m_multiview = false;
+	bool m_present_wait = false;
+	bool m_external_fd = false;
+	bool m_export_particle_buffers = false;
 };
 #endif // ITERATEDFUNCTIONS_VULKANCONTEXT_HPP
\ No newline at end of file
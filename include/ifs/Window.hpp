@@ -73,6 +73,14 @@ public:
      */
     [[nodiscard]] vk::RenderPass render_pass() const { return m_render_pass; }
 
+    /**
+     * @brief Render pass compatible with render_pass() that loads the color attachment
+     *
+     * For a second submission into an image a first one has already drawn
+     * (and left in ePresentSrcKHR); depth is cleared.
+     */
+    [[nodiscard]] vk::RenderPass load_render_pass() const { return m_load_render_pass; }
+
     /**
      * @brief Get current swapchain extent
      */
@@ -122,14 +130,43 @@ public:
      * @param present_queue Queue to present on (usually graphics queue)
      * @param wait_semaphore Semaphore to wait on before presenting
      * @param image_index Index of image to present
+     * @param present_id Increasing id for wait_for_present(); 0 for none (ignored without present wait)
      * @return true if presented successfully, false if swapchain was recreated
      */
     [[nodiscard]] bool present(
         vk::Queue present_queue,
         vk::Semaphore wait_semaphore,
-        uint32_t image_index
+        uint32_t image_index,
+        uint64_t present_id = 0
     );
 
+    /**
+     * @brief Block until a present() with this id (or a later one) is displayed
+     *
+     * Requires VulkanContext::has_present_wait(). Ids of a swapchain that was
+     * recreated since never complete; the wait then runs into the timeout.
+     *
+     * @param present_id Id passed to present()
+     * @param timeout Timeout in nanoseconds (0 polls)
+     * @return Whether the image has been displayed
+     */
+    [[nodiscard]] bool wait_for_present(uint64_t present_id, uint64_t timeout);
+
+    /**
+     * @brief Switch between the default and the low-latency present mode
+     *
+     * Low latency prefers immediate presentation (tearing allowed), then
+     * mailbox; the default prefers mailbox, then FIFO. The swapchain is
+     * recreated by the next acquire_next_image().
+     */
+    void set_low_latency(bool enabled);
+    [[nodiscard]] bool low_latency() const { return m_low_latency; }
+
+    /**
+     * @brief Present mode of the current swapchain
+     */
+    [[nodiscard]] vk::PresentModeKHR present_mode() const { return m_present_mode; }
+
     /**
      * @brief Mark that window needs resize handling
      *
@@ -257,6 +294,7 @@ private:
     std::vector<vk::ImageView> m_image_views;
     std::vector<vk::Framebuffer> m_framebuffers;
     vk::RenderPass m_render_pass;
+    vk::RenderPass m_load_render_pass;
 
     // Depth buffer resources
     vk::Image m_depth_image;
@@ -267,6 +305,7 @@ private:
     // State tracking
     uint32_t m_current_image_index;
     bool m_needs_resize;
+    bool m_low_latency = false;
 };
 
 } // namespace ifs
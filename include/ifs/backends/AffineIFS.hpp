@@ -0,0 +1,407 @@
+#pragma once
+
+#include "../IFSBackend.hpp"
+#include "../Shader.hpp"
+#include "../ParticleBuffer.hpp"
+#include "../ComputeScheduler.hpp"
+#include "../StageChain.hpp"
+#include <glm/glm.hpp>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace ifs {
+
+/**
+ * @brief One weighted affine map of an IFS: p' = linear * p + offset
+ */
+struct AffineMap {
+    glm::mat3 linear{0.5f};    ///< Linear part (column-major, as glm)
+    glm::vec3 offset{0.0f};    ///< Translation
+    float weight = 1.0f;       ///< Relative selection probability
+    glm::vec3 color{1.0f};     ///< Color particles blend towards when this map is applied
+
+    bool operator==(const AffineMap&) const = default;
+};
+
+/**
+ * @brief A complete affine IFS
+ *
+ * Presets are normalized so their attractors fit the unit cube around
+ * (0.5, 0.5, 0.5), which is where the default camera looks.
+ */
+struct AffineIFSDefinition {
+    std::vector<AffineMap> maps;
+
+    bool operator==(const AffineIFSDefinition&) const = default;
+
+    [[nodiscard]] static AffineIFSDefinition sierpinski_triangle();
+    [[nodiscard]] static AffineIFSDefinition barnsley_fern();
+    [[nodiscard]] static AffineIFSDefinition sierpinski_tetrahedron();
+    [[nodiscard]] static AffineIFSDefinition menger_sponge();
+
+    /// Names accepted by preset()
+    [[nodiscard]] static std::span<const std::string_view> preset_names();
+
+    /**
+     * @brief Look up a preset by name (e.g. "barnsley_fern")
+     */
+    [[nodiscard]] static std::optional<AffineIFSDefinition> preset(std::string_view name);
+};
+
+/**
+ * @brief One slot of a Walker/Vose alias table
+ *
+ * A uniform u in [0, n) selects slot floor(u); the slot's own index is taken
+ * when frac(u) < threshold, `alias` otherwise.
+ */
+struct AliasEntry {
+    float threshold = 1.0f;
+    uint32_t alias = 0;
+
+    bool operator==(const AliasEntry&) const = default;
+};
+
+/**
+ * @brief Alias table sampling index i with probability weights[i] / sum(weights)
+ *
+ * Negative weights count as 0; if no weight is positive, every index is
+ * equally likely. O(n) to build, O(1) per sample.
+ */
+[[nodiscard]] std::vector<AliasEntry> build_alias_table(std::span<const float> weights);
+
+/**
+ * @brief Iterations that carry orbits from the attractor of `from` to within
+ *        `tolerance` of the attractor of `to`
+ *
+ * Moving the maps by at most delta (over the attractor's extent) moves the
+ * attractor by at most delta / (1 - rate), and every iteration shrinks the
+ * remaining distance by the contraction rate: the largest spectral norm of
+ * the maps, since any orbit may keep picking the slowest one (the weighted
+ * average rate holds only for typical orbits, and the rest would ghost).
+ * Weight changes count as moving that share of the mass across the
+ * attractor. Map colors blend in by half per iteration, so color changes
+ * need log2 of their size in 8-bit steps.
+ *
+ * @return Iterations (0 when only the stage parameters can have changed), or
+ *         nullopt when the map counts differ or a map of `to` does not contract
+ */
+[[nodiscard]] std::optional<uint32_t> warm_start_iterations(
+    const AffineIFSDefinition& from,
+    const AffineIFSDefinition& to,
+    float tolerance
+);
+
+/**
+ * @brief Region of the attractor to generate in deep zoom, and its local frame
+ *
+ * Particles are written in local coordinates, (world - anchor) / extent,
+ * matching Camera3D::set_frame().
+ */
+struct DeepZoomView {
+    glm::dvec3 anchor{0.0};  ///< World position of the local origin
+    double extent = 1.0;     ///< World size of one local unit
+    double radius = 2.0;     ///< Local radius around the anchor that gets samples
+
+    bool operator==(const DeepZoomView&) const = default;
+};
+
+/**
+ * @brief A piece of the attractor: the image of the whole attractor under a
+ *        composition of maps (an address word), in double precision
+ */
+struct DeepZoomWord {
+    glm::dmat3 linear{1.0};
+    glm::dvec3 offset{0.0};
+    double probability = 1.0;  ///< Share of the invariant measure on the piece
+};
+
+/**
+ * @brief Pieces of the attractor that reach into `view`
+ *
+ * Subdivides the attractor by address until the pieces are about the size
+ * of the view or `max_words` is reached, dropping pieces whose bounding
+ * balls miss the view. Sampling a piece by probability, then a point of the
+ * attractor and mapping it by the word, samples the invariant measure inside
+ * the view exactly, without spending samples elsewhere.
+ *
+ * @param post Affine map applied after the IFS (the affine post stages)
+ * @return The words (empty if the view misses the attractor), or an error
+ *         when a map with positive weight does not contract
+ */
+[[nodiscard]] std::expected<std::vector<DeepZoomWord>, std::string> deep_zoom_words(
+    const AffineIFSDefinition& definition,
+    const DeepZoomWord& post,
+    const DeepZoomView& view,
+    uint32_t max_words
+);
+
+/**
+ * @brief Data-driven IFS backend iterating arbitrary weighted affine maps
+ *
+ * The maps live in a storage buffer, so changing the definition only
+ * rewrites a few bytes instead of recompiling a kernel. Supports warm
+ * starts: after set_warm_start(n), the next compute() continues every orbit
+ * from its previous position for n iterations instead of running the full
+ * burn-in from the origin. Attractors of nearby definitions are close, so a
+ * few iterations suffice when the definition changes smoothly (animation).
+ *
+ * Everything after generation (final transforms, coloring, the write) is a
+ * StageChain fused into the same kernel.
+ *
+ * Maps are selected in O(1) through alias tables, so the iteration cost does
+ * not grow with the number of maps. The kernel stages maps in tiles of
+ * tile_map_count in workgroup shared memory. A definition of at most one
+ * tile is loaded once per dispatch. Larger ones are cache-blocked: each
+ * iteration, the workgroup draws one tile by its total weight (every lane
+ * advances the same workgroup RNG state, so all draw the same tile through a
+ * uniform load of the tile table) and loads it coalesced, then every thread
+ * picks a map inside the tile. Each orbit still sees every map
+ * with its own probability; only orbits of one workgroup share tile draws.
+ */
+class AffineIFS : public IFSBackend {
+public:
+    /// Maps per shared-memory tile (TILE_MAPS in affine_ifs.slang, 16 KB)
+    static constexpr uint32_t tile_map_count = 256;
+
+    /// Largest definition: the tile table must fit one tile itself
+    static constexpr uint32_t max_map_count = tile_map_count * tile_map_count;
+
+    /// Most pieces deep zoom samples from
+    static constexpr uint32_t max_deep_zoom_words = 256;
+
+    /**
+     * @brief Create AffineIFS backend
+     *
+     * @param context Vulkan context
+     * @param device Vulkan device
+     * @param definition Initial maps (Sierpinski triangle by default)
+     * @return AffineIFS instance or error message
+     */
+    static std::expected<std::unique_ptr<AffineIFS>, std::string> create(
+        const VulkanContext& context,
+        vk::Device device,
+        AffineIFSDefinition definition = AffineIFSDefinition::sierpinski_triangle()
+    );
+
+    ~AffineIFS() override;
+
+    AffineIFS(const AffineIFS&) = delete;
+    AffineIFS& operator=(const AffineIFS&) = delete;
+
+    // IFSBackend interface
+    [[nodiscard]] std::string_view name() const override { return "Affine IFS"; }
+    [[nodiscard]] uint32_t dimension() const override { return 3; }
+
+    void compute(
+        vk::Buffer particle_buffer,
+        uint32_t particle_count,
+        const IFSParameters& params
+    ) override;
+
+    void wait_compute_complete() override;
+
+    /// A warm start may follow (conservative: update_params() can still start cold, e.g. on a new seed)
+    [[nodiscard]] bool reads_particle_buffer() const override {
+        return m_has_orbits && !m_deep_zoom && !m_last_deep && (m_warm_iterations > 0 || m_auto_warm_start);
+    }
+
+    void dispatch(
+        vk::CommandBuffer cmd,
+        vk::Buffer particle_buffer,
+        uint32_t particle_count,
+        const IFSParameters& params
+    ) override;
+
+    [[nodiscard]] vk::Buffer get_particle_buffer() const override {
+        return m_particle_buffer ? m_particle_buffer->buffer() : nullptr;
+    }
+
+    [[nodiscard]] const ParticleBuffer* particle_buffer() const override {
+        return m_particle_buffer.get();
+    }
+
+    [[nodiscard]] uint32_t get_particle_count() const override {
+        return m_particle_count;
+    }
+
+    [[nodiscard]] std::vector<UICallback> get_ui_callbacks() override;
+
+    [[nodiscard]] const ComputeStats* compute_stats() const override {
+        return m_scheduler ? &m_scheduler->last_stats() : nullptr;
+    }
+
+    /**
+     * @brief Replace the maps used by the next compute()
+     *
+     * Waits for the compute in flight. Definitions without maps or with more
+     * than max_map_count maps are rejected.
+     */
+    std::expected<void, std::string> set_definition(AffineIFSDefinition definition);
+
+    [[nodiscard]] const AffineIFSDefinition& definition() const { return m_definition; }
+
+    /**
+     * @brief Continue the existing orbits for `iterations` in the next compute()
+     *
+     * One-shot: the compute after that starts cold again unless this is called
+     * again. Ignored (cold start) when the buffer holds no orbits yet, e.g.
+     * after a particle count change. 0 cancels a pending warm start.
+     */
+    void set_warm_start(uint32_t iterations) { m_warm_iterations = iterations; }
+
+    /// Whether the last compute() continued previous orbits
+    [[nodiscard]] bool last_compute_was_warm() const { return m_last_warm; }
+
+    /**
+     * @brief Warm-start every compute() whose parameters moved only slightly
+     *
+     * The iterations follow from warm_start_iterations() between the definition
+     * of the last compute and the current one: a nudged coefficient costs a few
+     * iterations, a changed scale or stage parameter none, since the post stages
+     * are undone and reapplied. Starts cold on a new random seed, or when the
+     * estimate is no cheaper than a cold start. set_warm_start() takes precedence.
+     */
+    void set_auto_warm_start(bool enabled) { m_auto_warm_start = enabled; }
+
+    [[nodiscard]] bool auto_warm_start() const { return m_auto_warm_start; }
+
+    /// Distance to the new attractor auto warm starts settle for (scene units; the presets span 1)
+    void set_warm_tolerance(float tolerance) { m_warm_tolerance = tolerance; }
+
+    [[nodiscard]] float warm_tolerance() const { return m_warm_tolerance; }
+
+    /// Iterations the last compute() ran
+    [[nodiscard]] uint32_t last_iteration_count() const { return m_last_iterations; }
+
+    /**
+     * @brief Generate only the attractor around a high-precision anchor (nullopt: off)
+     *
+     * Each orbit iterates a generic point of the attractor in float, then maps
+     * it by one word of deep_zoom_words() composed in double with the affine
+     * post stages and the local frame, so positions stay exact down to float
+     * precision relative to the view, at any zoom. Nonlinear post stages
+     * (Spherical, Swirl) are skipped, and computes always start cold.
+     */
+    void set_deep_zoom(std::optional<DeepZoomView> view) { m_deep_zoom = view; }
+
+    [[nodiscard]] const std::optional<DeepZoomView>& deep_zoom() const { return m_deep_zoom; }
+
+    /// Pieces the last deep-zoom compute sampled (0 when off or the view missed the attractor)
+    [[nodiscard]] uint32_t deep_zoom_word_count() const { return m_deep_zoom_words; }
+
+    /// Iterations of a cold start
+    [[nodiscard]] uint32_t iteration_count() const { return m_iteration_count; }
+
+    /**
+     * @brief Recompile the kernel with another stage chain
+     *
+     * Waits for the compute in flight. The next compute starts cold, since the
+     * stored positions were written by the old chain. On error the old chain
+     * stays in place.
+     */
+    std::expected<void, std::string> set_stage_chain(StageChain chain);
+
+    [[nodiscard]] const StageChain& stage_chain() const { return m_stage_chain; }
+
+    /// Stage parameters used from the next compute on
+    void set_stage_settings(const StageSettings& settings) { m_stage_settings = settings; }
+
+    [[nodiscard]] const StageSettings& stage_settings() const { return m_stage_settings; }
+
+private:
+    AffineIFS(const VulkanContext& context, vk::Device device, AffineIFSDefinition definition);
+
+    std::expected<void, std::string> initialize();
+    std::expected<void, std::string> create_descriptor_layout();
+    std::expected<void, std::string> create_pipeline();
+
+    /**
+     * @brief Grow the map buffer if needed and upload the maps with their alias tables
+     *
+     * Layout: the maps, with alias entries local to their tile, followed by one
+     * alias entry per tile for the tile draw, then room for max_deep_zoom_words.
+     */
+    std::expected<void, std::string> upload_maps();
+
+    void cleanup();
+
+    /**
+     * @brief Upload shader parameters and bind the particle buffer
+     *
+     * Must be called once per workload before any record_chunk().
+     */
+    void update_params(vk::Buffer particle_buffer, uint32_t particle_count, const IFSParameters& params);
+
+    /**
+     * @brief Upload the deep-zoom words after the tile table
+     *
+     * @return Number of words uploaded (at least 1)
+     */
+    uint32_t upload_deep_zoom_words(float scale);
+
+    void record_chunk(vk::CommandBuffer cmd, const ComputeChunk& chunk) const;
+
+    void reallocate_particle_buffer(uint32_t new_count);
+
+    const VulkanContext* m_context;
+    vk::Device m_device;
+
+    // Particle data (backend owns this)
+    std::unique_ptr<ParticleBuffer> m_particle_buffer;
+    uint32_t m_particle_count;
+    uint32_t m_iteration_count = 40;
+
+    // Maps
+    AffineIFSDefinition m_definition;
+    vk::Buffer m_map_buffer;
+    vk::DeviceMemory m_map_memory;
+    void* m_map_mapped = nullptr;
+    uint32_t m_map_capacity = 0;
+
+    // Warm start state
+    uint32_t m_warm_iterations = 0;
+    bool m_has_orbits = false;        ///< Buffer holds positions of a previous compute
+    bool m_last_warm = false;
+    uint32_t m_last_iterations = 0;
+    uint32_t m_generation = 0;
+
+    // Auto warm start: the definition and seed the stored orbits were computed with
+    bool m_auto_warm_start = false;
+    float m_warm_tolerance = 1e-3f;
+    AffineIFSDefinition m_computed_definition;
+    bool m_definition_changed = false;  ///< m_computed_definition differs from m_definition
+    uint32_t m_computed_seed = 0;
+    uint32_t m_edit_map = 0;            ///< Map edited in the UI
+
+    // Deep zoom
+    std::optional<DeepZoomView> m_deep_zoom;
+    bool m_last_deep = false;           ///< The stored positions are in a deep-zoom frame
+    uint32_t m_deep_zoom_words = 0;
+
+    // Stages fused after generation
+    StageChain m_stage_chain;
+    StageSettings m_stage_settings;
+    std::unique_ptr<StageUniformBuffer> m_stage_uniforms;
+
+    // Shader and pipeline
+    std::unique_ptr<Shader> m_compute_shader;
+    vk::DescriptorSetLayout m_descriptor_layout;
+    vk::PipelineLayout m_pipeline_layout;
+    vk::Pipeline m_compute_pipeline;
+
+    vk::DescriptorPool m_descriptor_pool;
+    vk::DescriptorSet m_descriptor_set;
+
+    // Parameter buffer (uniform buffer for AffineParams), persistently mapped
+    vk::Buffer m_param_buffer;
+    vk::DeviceMemory m_param_memory;
+    void* m_param_mapped = nullptr;
+
+    // Compute submission, spread across all queues of the compute family
+    std::unique_ptr<ComputeScheduler> m_scheduler;
+};
+
+} // namespace ifs
@@ -3,6 +3,8 @@
 #include "../IFSBackend.hpp"
 #include "../Shader.hpp"
 #include "../ParticleBuffer.hpp"
+#include "../ComputeScheduler.hpp"
+#include "../StageChain.hpp"
 #include <memory>
 
 namespace ifs {
@@ -75,12 +77,20 @@ public:
         return m_particle_buffer ? m_particle_buffer->buffer() : nullptr;
     }
 
+    [[nodiscard]] const ParticleBuffer* particle_buffer() const override {
+        return m_particle_buffer.get();
+    }
+
     [[nodiscard]] uint32_t get_particle_count() const override {
         return m_particle_count;
     }
 
     [[nodiscard]] std::vector<UICallback> get_ui_callbacks() override;
 
+    [[nodiscard]] const ComputeStats* compute_stats() const override {
+        return m_scheduler ? &m_scheduler->last_stats() : nullptr;
+    }
+
 private:
     // Private constructor - use create() factory
     CustomIFS(
@@ -108,6 +118,18 @@ private:
      */
     void cleanup();
 
+    /**
+     * @brief Upload shader parameters and bind the particle buffer
+     *
+     * Must be called once per workload before any record_chunk().
+     */
+    void update_params(vk::Buffer particle_buffer, uint32_t particle_count, const IFSParameters& params);
+
+    /**
+     * @brief Record the dispatch for one particle range
+     */
+    void record_chunk(vk::CommandBuffer cmd, const ComputeChunk& chunk) const;
+
     /**
      * @brief Reallocate particle buffer with new count
      *
@@ -140,11 +162,12 @@ private:
     vk::Buffer m_param_buffer;
     vk::DeviceMemory m_param_memory;
 
-    // Phase 2: Compute command infrastructure (backend owns compute resources)
-    vk::CommandPool m_compute_command_pool;
-    vk::CommandBuffer m_compute_command_buffer;
-    vk::Fence m_compute_fence;
-    vk::Queue m_compute_queue;
+    // Scale and color, fused into the kernel
+    StageChain m_stage_chain{.post = {PostStage::GlobalScale}, .color = ColorStage::Radial};
+    std::unique_ptr<StageUniformBuffer> m_stage_uniforms;
+
+    // Compute submission, spread across all queues of the compute family
+    std::unique_ptr<ComputeScheduler> m_scheduler;
 };
 
 } // namespace ifs
@@ -0,0 +1,319 @@
+#pragma once
+
+#include "../IFSBackend.hpp"
+#include "../Shader.hpp"
+#include "../ParticleBuffer.hpp"
+#include "../ComputeScheduler.hpp"
+#include "../GpuStatistics.hpp"
+#include <glm/glm.hpp>
+#include <array>
+#include <map>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ifs {
+
+/**
+ * @brief Nonlinear variations of a flame transform (flam3 numbering order)
+ */
+enum class Variation : uint32_t {
+    Linear,
+    Sinusoidal,
+    Spherical,
+    Swirl,
+    Horseshoe,
+    Polar,
+    Handkerchief,
+    Heart,
+    Disc,
+    Spiral,
+    Hyperbolic,
+    Diamond,
+    Julia,
+    Bubble,
+    Fisheye,
+    Exponential
+};
+
+inline constexpr uint32_t variation_count = 16;
+
+/// Slang type name (shaders/ifs_modular/backends/flame/variations.slang)
+[[nodiscard]] std::string_view to_string(Variation variation);
+
+/**
+ * @brief One flame transform: a 2D affine map followed by weighted variations
+ *
+ * x' = a x + b y + c, y' = d x + e y + f, then p'' = sum of weight_v * V_v(p').
+ */
+struct FlameTransform {
+    float a = 1.0f, b = 0.0f, c = 0.0f;
+    float d = 0.0f, e = 1.0f, f = 0.0f;
+    std::array<float, variation_count> variations{1.0f};  ///< Indexed by Variation; linear only by default
+    float weight = 1.0f;       ///< Relative selection probability
+    float color = 0.0f;        ///< Palette coordinate in [0, 1]
+    float color_speed = 0.5f;  ///< Share of the orbit's palette coordinate replaced by `color`
+
+    bool operator==(const FlameTransform&) const = default;
+
+    [[nodiscard]] float& variation(Variation v) { return variations[static_cast<uint32_t>(v)]; }
+    [[nodiscard]] float variation(Variation v) const { return variations[static_cast<uint32_t>(v)]; }
+};
+
+/**
+ * @brief A complete fractal flame
+ *
+ * Flame coordinates [-1, 1] are shown in the unit square around (0.5, 0.5),
+ * where the default camera looks.
+ */
+struct FlameDefinition {
+    std::vector<FlameTransform> transforms;
+    /// Applied to each plotted point, without feeding back into the orbit
+    std::optional<FlameTransform> final_transform;
+    /// Cosine palette a, b, c, d: a + b * cos(2 pi (c * t + d))
+    std::array<glm::vec3, 4> palette{
+        glm::vec3(0.5f), glm::vec3(0.5f), glm::vec3(1.0f), glm::vec3(0.0f, 0.33f, 0.67f)
+    };
+
+    bool operator==(const FlameDefinition&) const = default;
+
+    /// Variations with a nonzero weight in any transform (or in the final transform)
+    [[nodiscard]] std::vector<Variation> used_variations(bool final) const;
+
+    /**
+     * @brief Type arguments for the iterate kernel's `main<Vars, FinalVars>`
+     *
+     * Each is the set of used variations folded into `Add<V, Add<W, NoVariations>>`;
+     * a definition without a final transform gets `NoVariations` for it.
+     */
+    [[nodiscard]] std::vector<std::string> kernel_specialization() const;
+
+    [[nodiscard]] static FlameDefinition sierpinski();
+    [[nodiscard]] static FlameDefinition spherical_lace();
+    [[nodiscard]] static FlameDefinition julia_swirl();
+    [[nodiscard]] static FlameDefinition sinusoidal_heart();
+
+    /// Names accepted by preset()
+    [[nodiscard]] static std::span<const std::string_view> preset_names();
+
+    /**
+     * @brief Look up a preset by name (e.g. "julia_swirl")
+     */
+    [[nodiscard]] static std::optional<FlameDefinition> preset(std::string_view name);
+};
+
+/**
+ * @brief Fractal flame backend: weighted nonlinear variations with density-grid tone mapping
+ *
+ * Every orbit starts at a random point, runs a few unplotted fuse iterations,
+ * then plots each iteration into a density grid over the view with atomic
+ * adds (hit count and summed palette coordinate per cell). A cell stops
+ * counting at MAX_CELL_HITS (variations.slang), so long runs saturate instead
+ * of wrapping. After every chunk has finished, a resolve pass gives each
+ * particle, the orbit's last plotted point, the log-density brightness and
+ * mean color of its cell.
+ *
+ * With auto-exposure on, a GpuStatistics pass over the grid finds a
+ * percentile of the cells' log-density between plotting and resolving, and
+ * the resolve scales brightness by it instead of by the fixed density 15, so
+ * sparse and dense flames both fill the tonal range without a CPU round trip.
+ *
+ * The iterate kernel is specialized by the variations the definition uses,
+ * so a flame only pays for its own variations. Kernels are cached per
+ * variation set: returning to a set seen before does not recompile.
+ */
+class FlameIFS : public IFSBackend {
+public:
+    /// Largest definition (transforms, excluding the final one)
+    static constexpr uint32_t max_transform_count = 256;
+
+    /// Density grid cells per side over the unit square of the view
+    static constexpr uint32_t grid_size = 1024;
+
+    /**
+     * @brief Create FlameIFS backend
+     *
+     * @param context Vulkan context
+     * @param device Vulkan device
+     * @param definition Initial flame (julia_swirl by default)
+     * @return FlameIFS instance or error message
+     */
+    static std::expected<std::unique_ptr<FlameIFS>, std::string> create(
+        const VulkanContext& context,
+        vk::Device device,
+        FlameDefinition definition = FlameDefinition::julia_swirl()
+    );
+
+    ~FlameIFS() override;
+
+    FlameIFS(const FlameIFS&) = delete;
+    FlameIFS& operator=(const FlameIFS&) = delete;
+
+    // IFSBackend interface
+    [[nodiscard]] std::string_view name() const override { return "Flame IFS"; }
+    [[nodiscard]] uint32_t dimension() const override { return 2; }
+
+    void compute(
+        vk::Buffer particle_buffer,
+        uint32_t particle_count,
+        const IFSParameters& params
+    ) override;
+
+    void wait_compute_complete() override;
+
+    void dispatch(
+        vk::CommandBuffer cmd,
+        vk::Buffer particle_buffer,
+        uint32_t particle_count,
+        const IFSParameters& params
+    ) override;
+
+    [[nodiscard]] vk::Buffer get_particle_buffer() const override {
+        return m_particle_buffer ? m_particle_buffer->buffer() : nullptr;
+    }
+
+    [[nodiscard]] const ParticleBuffer* particle_buffer() const override {
+        return m_particle_buffer.get();
+    }
+
+    [[nodiscard]] uint32_t get_particle_count() const override {
+        return m_particle_count;
+    }
+
+    [[nodiscard]] std::vector<UICallback> get_ui_callbacks() override;
+
+    [[nodiscard]] const ComputeStats* compute_stats() const override {
+        return m_scheduler ? &m_scheduler->last_stats() : nullptr;
+    }
+
+    /**
+     * @brief Replace the flame used by the next compute()
+     *
+     * Compiles the kernel for a new variation set (once per set). Waits for
+     * the compute in flight. Definitions without transforms or with more than
+     * max_transform_count are rejected; on error the old definition stays.
+     */
+    std::expected<void, std::string> set_definition(FlameDefinition definition);
+
+    [[nodiscard]] const FlameDefinition& definition() const { return m_definition; }
+
+    /// Specialized iterate kernels compiled so far
+    [[nodiscard]] size_t kernel_count() const { return m_pipelines.size(); }
+
+    /// Plotted iterations per orbit
+    [[nodiscard]] uint32_t iteration_count() const { return m_iteration_count; }
+
+    /// Tone mapping: a cell 15 times denser than average is white at brightness 1
+    void set_brightness(float brightness) { m_brightness = brightness; }
+
+    void set_gamma(float gamma) { m_gamma = gamma; }
+
+    /**
+     * @brief Scale brightness by a percentile of the grid's log-density instead
+     *
+     * Has no effect if the device lacks subgroup arithmetic (see GpuStatistics).
+     */
+    void set_auto_exposure(bool enabled) { m_auto_exposure = enabled; }
+
+    [[nodiscard]] bool auto_exposure() const { return m_auto_exposure && m_statistics; }
+
+    /// Share of occupied cells at or below white with auto-exposure
+    void set_exposure_percentile(float percentile) { m_exposure_percentile = percentile; }
+
+    /**
+     * @brief log2(1 + hits) over the occupied cells of the last auto-exposed compute
+     *
+     * Percentiles are at the exposure percentile, then 0.5, 0.9 and 0.99.
+     * Updated by wait_compute_complete().
+     */
+    [[nodiscard]] const std::optional<StatisticsSummary>& density_statistics() const;
+
+private:
+    FlameIFS(const VulkanContext& context, vk::Device device, FlameDefinition definition);
+
+    std::expected<void, std::string> initialize();
+    std::expected<void, std::string> create_descriptor_layout(const Shader& shader);
+    std::expected<vk::Pipeline, std::string> create_pipeline(const Shader& shader, std::string_view label);
+
+    /**
+     * @brief The iterate pipeline for the definition's variation sets, compiling it if needed
+     */
+    std::expected<vk::Pipeline, std::string> iterate_pipeline(const FlameDefinition& definition);
+
+    /**
+     * @brief Upload the transforms with their alias table, then the final transform
+     */
+    void upload_transforms();
+
+    void cleanup();
+
+    /**
+     * @brief Upload shader parameters and bind the particle buffer
+     *
+     * Must be called once per workload before any record_chunk().
+     */
+    void update_params(vk::Buffer particle_buffer, uint32_t particle_count, const IFSParameters& params);
+
+    void record_chunk(vk::CommandBuffer cmd, const ComputeChunk& chunk) const;
+
+    /**
+     * @brief After all chunks: gather the density statistics if auto-exposed,
+     *        tone map every particle, then clear the grid for the next compute
+     */
+    void record_resolve(vk::CommandBuffer cmd, uint32_t particle_count) const;
+
+    void reallocate_particle_buffer(uint32_t new_count);
+
+    const VulkanContext* m_context;
+    vk::Device m_device;
+
+    // Particle data (backend owns this)
+    std::unique_ptr<ParticleBuffer> m_particle_buffer;
+    uint32_t m_particle_count;
+    uint32_t m_iteration_count = 40;
+    uint32_t m_fuse_count = 20;
+
+    // Tone mapping
+    float m_brightness = 1.0f;
+    float m_gamma = 2.2f;
+    bool m_auto_exposure = false;
+    float m_exposure_percentile = 0.995f;
+
+    // Density statistics for auto-exposure; null without subgroup arithmetic
+    std::unique_ptr<GpuStatistics> m_statistics;
+    bool m_statistics_pending = false;  ///< The compute in flight records statistics
+
+    // Transforms
+    FlameDefinition m_definition;
+    vk::Buffer m_transform_buffer;
+    vk::DeviceMemory m_transform_memory;
+    void* m_transform_mapped = nullptr;
+    uint32_t m_edit_transform = 0;  ///< Transform edited in the UI
+
+    // Density grid (uint2 per cell), device local
+    vk::Buffer m_grid_buffer;
+    vk::DeviceMemory m_grid_memory;
+
+    // Pipelines: one iterate kernel per variation set, one resolve kernel
+    vk::DescriptorSetLayout m_descriptor_layout;
+    vk::PipelineLayout m_pipeline_layout;
+    std::map<std::string, vk::Pipeline> m_pipelines;  ///< Keyed by the joined specialization
+    vk::Pipeline m_iterate_pipeline;                  ///< Current definition's entry of m_pipelines
+    vk::Pipeline m_resolve_pipeline;
+
+    vk::DescriptorPool m_descriptor_pool;
+    vk::DescriptorSet m_descriptor_set;
+
+    // Parameter buffer (uniform buffer for FlameParams), persistently mapped
+    vk::Buffer m_param_buffer;
+    vk::DeviceMemory m_param_memory;
+    void* m_param_mapped = nullptr;
+
+    // Compute submission, spread across all queues of the compute family
+    std::unique_ptr<ComputeScheduler> m_scheduler;
+};
+
+} // namespace ifs
@@ -3,8 +3,14 @@
 #include "../IFSFrontend.hpp"
 #include "../Shader.hpp"
 #include "../VulkanContext.hpp"
+#include "../MultiviewTarget.hpp"
+#include "../ReadbackBuffer.hpp"
+#include <glm/glm.hpp>
+#include <algorithm>
 #include <memory>
 #include <expected>
+#include <span>
+#include <vector>
 
 namespace ifs {
 
@@ -19,6 +25,17 @@ namespace ifs {
  * - Adjustable point size
  * - Per-particle colors
  * - Dynamic viewport/scissor handling
+ * - Split-screen views drawn by one multiview draw (see MultiviewTarget)
+ * - Stochastic screen-space LOD (point_lod())
+ *
+ * Point LOD: each particle of the chaos game is an independent sample of the
+ * attractor, so any prefix of the buffer is a uniformly random subset of it.
+ * record_pre_pass() copies the first LOD_SAMPLES positions back to the host,
+ * and the next use of the frame slot projects them to bound the attractor on
+ * screen. When the particles outnumber lod_density() points per pixel of that
+ * bound, only such a prefix is drawn, and each point's alpha is raised so the
+ * accumulated opacity of a pixel matches the full draw. Draw cost then follows
+ * screen coverage instead of the particle count.
  */
 class ParticleRenderer : public IFSFrontend {
 public:
@@ -66,6 +83,34 @@ public:
         const vk::Extent2D* extent = nullptr
     ) override;
 
+    /**
+     * @brief MultiviewTarget::MAX_VIEWS if the device supports multiview, else 1
+     */
+    [[nodiscard]] uint32_t max_views() const override {
+        return MultiviewTarget::supported(*m_context) && !m_multiview_failed ? MultiviewTarget::MAX_VIEWS : 1;
+    }
+
+    /**
+     * @brief Composite the views drawn before the render pass (one view: draw it in its area)
+     */
+    void render_views(
+        vk::CommandBuffer cmd,
+        vk::Buffer particle_buffer,
+        uint32_t particle_count,
+        std::span<const FrameView> views
+    ) override;
+
+    /**
+     * @brief Read back the previous LOD samples of the frame slot and copy new ones
+     */
+    void record_pre_pass(
+        vk::CommandBuffer cmd,
+        vk::Buffer particle_buffer,
+        uint32_t particle_count,
+        Camera& camera,
+        const vk::Extent2D& extent
+    ) override;
+
     void resize(const vk::Extent2D& new_extent) override;
 
     [[nodiscard]] std::vector<std::pair<std::string, std::pair<float, float>>>
@@ -75,16 +120,10 @@ public:
         };
     }
 
-    [[nodiscard]] std::vector<UICallback> get_ui_callbacks() override {
-        std::vector<UICallback> callbacks;
-        callbacks.emplace_back("Point Size", ContinuousCallback{
-            .setter = [this](float v) { set_point_size(v); },
-            .getter = [this]() { return point_size(); },
-            .min = 1.0f,
-            .max = 10.0f,
-            .logarithmic = false
-        });
-        return callbacks;
+    [[nodiscard]] std::vector<UICallback> get_ui_callbacks() override;
+
+    [[nodiscard]] const PipelineStatistics* pipeline_statistics() const override {
+        return m_statistics && m_statistics->enabled() ? &m_statistics->latest() : nullptr;
     }
 
     /**
@@ -94,6 +133,50 @@ public:
 
     [[nodiscard]] float point_size() const { return m_point_size; }
 
+    /// Particles read back per frame to bound the attractor on screen
+    static constexpr uint32_t LOD_SAMPLES = 4096;
+
+    /**
+     * @brief Draw only as many particles as the screen coverage needs (default on)
+     */
+    void set_point_lod(bool enabled) { m_point_lod = enabled; }
+
+    [[nodiscard]] bool point_lod() const { return m_point_lod; }
+
+    /**
+     * @brief Points drawn per covered pixel before the LOD drops particles (default 32)
+     */
+    void set_lod_density(float density) { m_lod_density = std::max(density, 1.0f); }
+
+    [[nodiscard]] float lod_density() const { return m_lod_density; }
+
+    /**
+     * @brief Particles drawn by the last draw (the particle count without LOD)
+     */
+    [[nodiscard]] uint32_t lod_drawn() const { return m_lod_drawn; }
+
+    /**
+     * @brief Number of particles to draw for `density` points per covered pixel
+     *
+     * Coverage is the screen-space bounding box of the projected samples,
+     * clipped to the viewport, so it errs towards drawing more. All particles
+     * are drawn if a sample is behind the camera or there are no samples.
+     *
+     * @param samples World positions of a random subset of the particles
+     * @param view_projection Camera of the draw
+     * @param extent Viewport size in pixels
+     * @param particle_count Particles in the buffer
+     * @param density Points per covered pixel
+     * @return Length of the prefix to draw, 1..particle_count (0 if particle_count is 0)
+     */
+    [[nodiscard]] static uint32_t lod_draw_count(
+        std::span<const glm::vec3> samples,
+        const glm::mat4& view_projection,
+        const vk::Extent2D& extent,
+        uint32_t particle_count,
+        float density
+    );
+
     /**
      * @brief Update particle buffer binding in descriptor set
      *
@@ -126,6 +209,32 @@ private:
      */
     std::expected<void, std::string> create_pipeline();
 
+    /**
+     * @brief Create the multiview target and pipeline for a split into `view_count` views
+     *
+     * Recreated when the number of views changes.
+     *
+     * @return false if multiview is unavailable (the failure is only logged once)
+     */
+    bool ensure_multiview(uint32_t view_count);
+
+    void destroy_multiview();
+
+    /**
+     * @brief Particles to draw of `particle_count` for the camera and viewport (see lod_draw_count())
+     */
+    [[nodiscard]] uint32_t lod_count(uint32_t particle_count, Camera& camera, const vk::Extent2D& extent) const;
+
+    /**
+     * @brief Write the camera to the view buffer and draw the points into `area`
+     */
+    void record_points(vk::CommandBuffer cmd, uint32_t particle_count, Camera& camera, const vk::Rect2D& area);
+
+    /**
+     * @brief Draw every view of a split frame into the multiview target (outside the render pass)
+     */
+    void record_multiview(vk::CommandBuffer cmd, const FrameRenderInfo& info);
+
     /**
      * @brief Cleanup Vulkan resources
      */
@@ -154,6 +263,28 @@ private:
     // Rendering parameters
     float m_point_size;
 
+    // Diagnostics (pipeline statistics, overdraw heatmap)
+    std::unique_ptr<PipelineStatisticsQuery> m_statistics;
+    std::unique_ptr<OverdrawHeatmap> m_overdraw;  ///< Null if the device can't run it
+    bool m_show_overdraw = false;
+    bool m_overdraw_this_frame = false;  ///< render() draws with the count pipeline
+
+    // Split-screen views (created on the first split frame)
+    std::unique_ptr<Shader> m_multiview_vertex_shader;  ///< main_multiview: camera per SV_ViewID
+    std::unique_ptr<MultiviewTarget> m_multiview;
+    vk::Pipeline m_multiview_pipeline;
+    bool m_multiview_failed = false;
+    bool m_multiview_this_frame = false;  ///< record_multiview() drew the views; render_views() composites them
+
+    // Point LOD: sampled positions, one readback per frame in flight
+    std::vector<std::shared_ptr<ReadbackBuffer>> m_lod_readbacks;
+    std::vector<uint32_t> m_lod_copied;  ///< Samples copied into each readback (0: none pending)
+    std::vector<glm::vec3> m_lod_samples;
+    bool m_point_lod = true;
+    float m_lod_density = 32.0f;
+    uint32_t m_lod_drawn = 0;
+    uint32_t m_frame_slot = 0;  ///< Frame in flight recorded by render_frame()
+
     // Phase 3: Graphics command infrastructure (frontend owns graphics resources)
     vk::CommandPool m_graphics_command_pool;
     std::vector<vk::CommandBuffer> m_command_buffers;  // One per swapchain image
@@ -3,9 +3,13 @@
 #include <ifs/IFSFrontend.hpp>
 #include <ifs/VulkanContext.hpp>
 #include <ifs/Shader.hpp>
+#include <ifs/PipelineLibrary.hpp>
+#include <ifs/VisibilityBuffer.hpp>
 #include <vulkan/vulkan.hpp>
 #include <glm/glm.hpp>
+#include <array>
 #include <memory>
+#include <span>
 #include <vector>
 #include <expected>
 #include <string>
@@ -20,6 +24,23 @@ namespace ifs {
  * Uses GPU instancing to render each particle as a small sphere with proper
  * 3D geometry, lighting, and depth testing. Much better visual quality than
  * point sprites or billboards.
+ *
+ * With occlusion culling on (the default), record_pre_pass() culls the
+ * instances hidden behind nearer spheres (see OcclusionCuller). With sphere
+ * LOD on (the default), it also bins them by projected radius: one vertex
+ * and index buffer holds an octahedron and icospheres 0-4, and sub-pixel
+ * spheres are drawn as points. render() then issues one indirect draw per
+ * LOD. Without a pre-pass, or with the overdraw heatmap shown, render()
+ * draws every instance with the icosphere of `sphere_subdivisions`.
+ *
+ * With visibility-buffer shading on, record_pre_pass() also draws the
+ * spheres into a VisibilityBuffer that keeps only the nearest particle index
+ * per pixel; a compute pass then shades each covered pixel once from the
+ * analytic sphere, and render() only composites the result.
+ *
+ * Split-screen frames draw each view with its own slot of the view buffer.
+ * Culling, LOD and the visibility buffer follow a single camera, so with
+ * more than one view every instance is drawn with the fixed mesh.
  */
 class SphereRenderer : public IFSFrontend {
 public:
@@ -31,7 +52,7 @@ public:
      * @param device Vulkan device
      * @param render_pass Render pass to use
      * @param extent Initial swapchain extent
-     * @param sphere_subdivisions Number of subdivisions for sphere mesh (higher = smoother)
+     * @param sphere_subdivisions Subdivisions of the mesh drawn without LOD (higher = smoother, at most 4)
      * @return SphereRenderer instance or error
      */
     [[nodiscard]] static std::expected<std::unique_ptr<SphereRenderer>, std::string> create(
@@ -62,6 +83,42 @@ public:
      */
     float sphere_radius() const { return m_sphere_radius; }
 
+    /**
+     * @brief Enable or disable two-phase occlusion culling
+     */
+    void set_occlusion_culling(bool enabled) { m_occlusion_culling = enabled; }
+
+    [[nodiscard]] bool occlusion_culling() const { return m_occlusion_culling && m_culler; }
+
+    /**
+     * @brief Enable or disable the per-instance mesh level of detail
+     */
+    void set_sphere_lod(bool enabled) { m_sphere_lod = enabled; }
+
+    [[nodiscard]] bool sphere_lod() const { return m_sphere_lod && m_culler; }
+
+    /**
+     * @brief Mesh ranges of each LOD, coarsest first (empty until the first frame)
+     *
+     * LOD 0 is the point fallback; the last one has no radius limit.
+     */
+    [[nodiscard]] std::span<const LodMesh> lod_meshes() const { return m_lods; }
+
+    /**
+     * @brief Enable or disable deferred shading through the visibility buffer
+     */
+    void set_visibility_shading(bool enabled) { m_visibility_shading = enabled; }
+
+    [[nodiscard]] bool visibility_shading() const { return m_visibility_shading && m_visibility; }
+
+    void record_pre_pass(
+        vk::CommandBuffer cmd,
+        vk::Buffer particle_buffer,
+        uint32_t particle_count,
+        Camera& camera,
+        const vk::Extent2D& extent
+    ) override;
+
     void render(
         vk::CommandBuffer cmd,
         vk::Buffer particle_buffer,
@@ -70,6 +127,15 @@ public:
         const vk::Extent2D* extent = nullptr
     ) override;
 
+    [[nodiscard]] uint32_t max_views() const override { return MAX_FRAME_VIEWS; }
+
+    void render_views(
+        vk::CommandBuffer cmd,
+        vk::Buffer particle_buffer,
+        uint32_t particle_count,
+        std::span<const FrameView> views
+    ) override;
+
     [[nodiscard]] vk::Semaphore render_frame(
         const FrameRenderInfo& info,
         vk::Queue graphics_queue
@@ -77,19 +143,52 @@ public:
 
     void handle_swapchain_recreation(uint32_t new_image_count) override;
 
+    [[nodiscard]] std::vector<UICallback> get_ui_callbacks() override;
+
+    [[nodiscard]] const PipelineStatistics* pipeline_statistics() const override {
+        return m_statistics && m_statistics->enabled() ? &m_statistics->latest() : nullptr;
+    }
+
+    /**
+     * @brief Linked pipeline variants
+     */
+    [[nodiscard]] PipelineLibrary& pipeline_library() { return *m_pipelines; }
+
+    [[nodiscard]] const OcclusionStatistics* occlusion_statistics() const override {
+        return occlusion_culling() || sphere_lod() ? &m_culler->latest() : nullptr;
+    }
+
+    static constexpr uint32_t MAX_SPHERE_SUBDIVISIONS = 4;
+    static constexpr uint32_t LOD_COUNT = MAX_SPHERE_SUBDIVISIONS + 3;  ///< Points, octahedron, icospheres 0-4
+
 private:
     SphereRenderer(const VulkanContext& context, vk::Device device);
 
     /**
-     * @brief Generate sphere mesh geometry
+     * @brief Generate the LOD meshes into one vertex and index array
      */
-    void generate_sphere_mesh(uint32_t subdivisions);
+    void generate_sphere_meshes();
 
     /**
-     * @brief Create vertex and index buffers for sphere mesh
+     * @brief Create vertex and index buffers for the sphere meshes
      */
     [[nodiscard]] std::expected<void, std::string> create_sphere_buffers();
 
+    /**
+     * @brief Generate and upload the sphere mesh on first use
+     *
+     * Deferred from create() so a renderer that is constructed but never
+     * drawn (or drawn late) doesn't pay for the mesh at startup.
+     *
+     * @return false if the mesh is unavailable
+     */
+    bool ensure_sphere_mesh();
+
+    /**
+     * @brief Destroy the sphere vertex and index buffers (safe on partial creation)
+     */
+    void destroy_sphere_buffers();
+
     /**
      * @brief Create descriptor set layout
      */
@@ -100,11 +199,39 @@ private:
      */
     [[nodiscard]] std::expected<void, std::string> create_pipeline();
 
+    /**
+     * @brief Create the visibility buffer and the pipelines drawing into it
+     * @param pipeline_info Create info of the forward pipeline
+     */
+    [[nodiscard]] std::expected<void, std::string> create_visibility_pipelines(const vk::GraphicsPipelineCreateInfo& pipeline_info);
+
     /**
      * @brief Create descriptor set
      */
     [[nodiscard]] std::expected<void, std::string> create_descriptor_set();
 
+    /**
+     * @brief Write the camera and sphere parameters to a view's slot of the view buffer
+     */
+    void update_view_params(Camera& camera, uint32_t view = 0);
+
+    /**
+     * @brief Set the Y-flipped viewport and the scissor
+     */
+    void set_viewport(vk::CommandBuffer cmd, const vk::Rect2D& area);
+
+    /**
+     * @brief Draw the spheres: the culled LOD buckets if record_pre_pass() filled them, else every instance
+     * @param visibility Use the pipelines of the visibility pass
+     * @param view Descriptor set (view buffer slot) to draw with
+     */
+    void record_spheres(vk::CommandBuffer cmd, uint32_t particle_count, bool visibility, uint32_t view = 0);
+
+    /**
+     * @brief render() into one area: the visibility composite or the spheres
+     */
+    void record_view(vk::CommandBuffer cmd, uint32_t particle_count, Camera& camera, const vk::Rect2D& area);
+
     // Vulkan context
     const VulkanContext* m_context;
     vk::Device m_device;
@@ -113,16 +240,26 @@ private:
 
     // Shaders
     std::unique_ptr<Shader> m_vertex_shader;
+    std::unique_ptr<Shader> m_culled_vertex_shader;  ///< main_culled: reads the culler's draw list
+    std::unique_ptr<Shader> m_point_vertex_shader;   ///< main_culled_point: the sub-pixel LOD
     std::unique_ptr<Shader> m_fragment_shader;
+    std::unique_ptr<Shader> m_visibility_fragment_shader;  ///< Writes the particle index
 
-    // Pipeline
+    // Pipeline variants, linked by m_pipelines from shared parts
+    std::unique_ptr<PipelineLibrary> m_pipelines;
     vk::PipelineLayout m_pipeline_layout;
-    vk::Pipeline m_graphics_pipeline;
+    PipelineLibrary::Handle m_graphics_pipeline = 0;
+    vk::PipelineLayout m_culled_pipeline_layout;  ///< Set 0 + the culler's draw set, LOD push constant
+    PipelineLibrary::Handle m_culled_pipeline = 0;
+    PipelineLibrary::Handle m_point_pipeline = 0;       ///< Culled layout, point list
+    PipelineLibrary::Handle m_visibility_pipeline = 0;  ///< Visibility pass variants of the three above
+    PipelineLibrary::Handle m_visibility_culled_pipeline = 0;
+    PipelineLibrary::Handle m_visibility_point_pipeline = 0;
 
-    // Descriptor sets
+    // Descriptor sets, one per split-screen view; set 0 also serves the pre-pass
     vk::DescriptorSetLayout m_descriptor_layout;
     vk::DescriptorPool m_descriptor_pool;
-    vk::DescriptorSet m_descriptor_set;
+    std::array<vk::DescriptorSet, MAX_FRAME_VIEWS> m_descriptor_sets{};
 
     // Sphere mesh data
     struct Vertex {
@@ -131,17 +268,21 @@ private:
     };
     std::vector<Vertex> m_sphere_vertices;
     std::vector<uint32_t> m_sphere_indices;
+    std::vector<LodMesh> m_lods;  ///< LOD_COUNT ranges of the arrays above, coarsest first
 
-    // Sphere mesh buffers
+    // Sphere mesh buffers (created by ensure_sphere_mesh())
+    uint32_t m_sphere_subdivisions = 2;
+    bool m_sphere_mesh_attempted = false;
     vk::Buffer m_vertex_buffer;
     vk::DeviceMemory m_vertex_memory;
     vk::Buffer m_index_buffer;
     vk::DeviceMemory m_index_memory;
 
-    // View parameters buffer
+    // View parameters buffer, one ViewParams per split-screen view
     vk::Buffer m_view_buffer;
     vk::DeviceMemory m_view_memory;
     void* m_view_mapped = nullptr;
+    vk::DeviceSize m_view_stride = 0;  ///< sizeof(ViewParams) rounded up to the uniform offset alignment
 
     // Graphics infrastructure (Phase 3: owned by frontend)
     vk::CommandPool m_graphics_command_pool;
@@ -158,10 +299,30 @@ private:
         float sphere_radius;
         glm::vec3 light_dir;
         float padding;
+        glm::mat4 inverse_view_projection;  ///< Pixel rays of the visibility shading pass
     };
 
     // Rendering parameters
     float m_sphere_radius = 0.003f;
+
+    // Diagnostics (pipeline statistics, overdraw heatmap)
+    std::unique_ptr<PipelineStatisticsQuery> m_statistics;
+    std::unique_ptr<OverdrawHeatmap> m_overdraw;  ///< Null if the device can't run it
+    bool m_show_overdraw = false;
+    bool m_overdraw_this_frame = false;  ///< render() draws with the count pipeline
+
+    // Occlusion culling (null if unavailable)
+    std::unique_ptr<OcclusionCuller> m_culler;
+    bool m_occlusion_culling = true;
+    bool m_sphere_lod = true;
+    bool m_culled_this_frame = false;  ///< record_pre_pass() filled the draw list for render()
+    bool m_culled_lod = false;         ///< The draw list was binned into all LOD_COUNT meshes
+    uint32_t m_frame_slot = 0;         ///< Frame in flight recorded by render_frame()
+
+    // Visibility-buffer shading (null if unavailable)
+    std::unique_ptr<VisibilityBuffer> m_visibility;
+    bool m_visibility_shading = false;
+    bool m_visibility_this_frame = false;  ///< record_pre_pass() shaded the frame; render() composites it
 };
 
 } // namespace ifs
@@ -2,26 +2,99 @@
 // Model (Backend): Sierpinski2D fractal generator
 // View (Frontend): ParticleRenderer point cloud visualizer
 // Controller: IFSController manages interaction and coordination
+//
+// Usage: ifs_modular [--backend custom|sierpinski|affine|flame] [--record FILE]
+//                    [--replay FILE [--timings FILE]] [--low-latency] [--share SOCKET]
+//
+// --record writes the camera path of the session; --replay plays one back
+// unpaced, writes per-frame timings (default FILE.timings.csv) and exits.
+// --low-latency starts with immediate present and input sampled after the GPU.
+// --share serves the particle buffer to other processes (ParticleShareClient).
 
 #include <ifs/backends/Sierpinski2D.hpp>
 #include <ifs/frontends/ParticleRenderer.hpp>
 #include <ifs/IFSController.hpp>
 #include <ifs/Logger.hpp>
+#include <ifs/StartupTrace.hpp>
 #include <spdlog/spdlog.h>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <string_view>
 
+#include "ifs/backends/AffineIFS.hpp"
 #include "ifs/backends/CustomIFS.hpp"
+#include "ifs/backends/FlameIFS.hpp"
 #include "ifs/frontends/SphereRenderer.hpp"
 
-int main() {
+int main(int argc, char** argv) {
     Logger::instance().set_level(spdlog::level::trace);
     Logger::instance().info("Starting IFS Modular Visualizer...");
 
+    std::string_view backend_name = "custom";
+    std::filesystem::path record_path;
+    std::filesystem::path replay_path;
+    std::filesystem::path timings_path;
+    bool low_latency = false;
+    std::optional<std::filesystem::path> share_socket;
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg = argv[i];
+        if (i + 1 < argc && arg == "--backend") {
+            backend_name = argv[++i];
+        } else if (i + 1 < argc && arg == "--record") {
+            record_path = argv[++i];
+        } else if (i + 1 < argc && arg == "--replay") {
+            replay_path = argv[++i];
+        } else if (i + 1 < argc && arg == "--timings") {
+            timings_path = argv[++i];
+        } else if (i + 1 < argc && arg == "--share") {
+            share_socket = argv[++i];
+        } else if (arg == "--low-latency") {
+            low_latency = true;
+        } else {
+            Logger::instance().error("Usage: ifs_modular [--backend custom|sierpinski|affine|flame] [--record FILE] "
+                                     "[--replay FILE [--timings FILE]] [--low-latency] [--share SOCKET]");
+            return 1;
+        }
+    }
+
+    std::optional<ifs::CameraPath> replay;
+    if (!replay_path.empty()) {
+        std::ifstream file(replay_path);
+        if (!file) {
+            Logger::instance().error("Failed to open '{}'", replay_path.string());
+            return 1;
+        }
+        std::stringstream text;
+        text << file.rdbuf();
+        auto path = ifs::parse_camera_path(text.str());
+        if (!path) {
+            Logger::instance().error("{}: {}", replay_path.string(), path.error());
+            return 1;
+        }
+        replay = std::move(*path);
+        if (timings_path.empty()) {
+            timings_path = std::filesystem::path(replay_path).replace_extension(".timings.csv");
+        }
+    }
+
     try {
         // Configure application
         ifs::IFSConfig config{
             .window_width = 1280,
             .window_height = 720,
-            .window_title = "IFS Modular - MVC Architecture"
+            .window_title = "IFS Modular - MVC Architecture",
+            .low_latency = low_latency,
+            .share_socket = share_socket,
+            .preload_shaders = {
+                backend_name == "affine" ? "ifs_modular/backends/affine_ifs"
+                    : backend_name == "flame" ? "ifs_modular/backends/flame/iterate.slang"
+                    : "ifs_modular/backends/custom_ifs",
+                "ifs_modular/frontends/particle/particle.vert.slang",
+                "ifs_modular/frontends/particle/particle.frag.slang"
+            }
         };
 
         // Create controller
@@ -32,19 +105,36 @@ int main() {
         }
         auto& controller = *controller_result;
 
-        auto backend = ifs::CustomIFS::create(controller->context(), controller->device());
+        auto backend = [&]() -> std::expected<std::unique_ptr<ifs::IFSBackend>, std::string> {
+            auto _ = ifs::StartupTrace::instance().phase("backend_create");
+            if (backend_name == "custom") return ifs::CustomIFS::create(controller->context(), controller->device());
+            if (backend_name == "sierpinski") return ifs::Sierpinski2D::create(controller->context(), controller->device());
+            if (backend_name == "affine") {
+                auto affine = ifs::AffineIFS::create(controller->context(), controller->device());
+                if (affine) {
+                    // Slider drags re-iterate only as far as the maps moved
+                    (*affine)->set_auto_warm_start(true);
+                }
+                return affine;
+            }
+            if (backend_name == "flame") return ifs::FlameIFS::create(controller->context(), controller->device());
+            return std::unexpected(std::format("Unknown backend '{}'", backend_name));
+        }();
         if (!backend) {
             Logger::instance().error("Failed to create backend: {}", backend.error());
             return 1;
         }
 
         // Create frontend (View) - Point particle renderer
-        auto frontend = ifs::ParticleRenderer::create(
-            controller->context(),
-            controller->device(),
-            controller->render_pass(),
-            controller->extent()
-        );
+        auto frontend = [&] {
+            auto _ = ifs::StartupTrace::instance().phase("frontend_create");
+            return ifs::ParticleRenderer::create(
+                controller->context(),
+                controller->device(),
+                controller->render_pass(),
+                controller->extent()
+            );
+        }();
         if (!frontend) {
             Logger::instance().error("Failed to create frontend: {}", frontend.error());
             return 1;
@@ -54,6 +144,12 @@ int main() {
         controller->set_backend(std::move(*backend));
         controller->set_frontend(std::move(*frontend));
 
+        if (replay) {
+            controller->start_path_replay(std::move(*replay), timings_path);
+        } else if (!record_path.empty()) {
+            controller->start_path_recording(record_path);
+        }
+
         // Run main loop (blocks until window closes)
         if (auto result = controller->run(); !result) {
             Logger::instance().error("Runtime error: {}", result.error());
@@ -0,0 +1,134 @@
+// IFS Sweep - headless batch renderer
+// Renders every job of a sweep specification (see ifs/Sweep.hpp) to images
+// and/or a statistics file, reusing one Vulkan context, backend and frontend.
+//
+// Usage: ifs_sweep <spec-file> [--out DIR] [--width W] [--height H]
+//                  [--output images|stats|both] [--frontend points|spheres]
+
+#include <ifs/backends/CustomIFS.hpp>
+#include <ifs/frontends/ParticleRenderer.hpp>
+#include <ifs/frontends/SphereRenderer.hpp>
+#include <ifs/Logger.hpp>
+#include <ifs/Sweep.hpp>
+#include <spdlog/spdlog.h>
+#include <charconv>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+void print_usage() {
+    Logger::instance().info("Usage: ifs_sweep <spec-file> [--out DIR] [--width W] [--height H] "
+                            "[--output images|stats|both] [--frontend points|spheres]");
+}
+
+bool parse_dimension(std::string_view text, uint32_t& value) {
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return ec == std::errc() && ptr == text.data() + text.size() && value > 0;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    Logger::instance().set_level(spdlog::level::info);
+
+    std::string spec_path;
+    std::string frontend_name = "points";
+    ifs::SweepOptions options;
+    vk::Extent2D extent{1280, 720};
+
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--out" && has_value) {
+            options.output_dir = argv[++i];
+        } else if (arg == "--width" && has_value) {
+            if (!parse_dimension(argv[++i], extent.width)) {
+                Logger::instance().error("Invalid width '{}'", argv[i]);
+                return 1;
+            }
+        } else if (arg == "--height" && has_value) {
+            if (!parse_dimension(argv[++i], extent.height)) {
+                Logger::instance().error("Invalid height '{}'", argv[i]);
+                return 1;
+            }
+        } else if (arg == "--output" && has_value) {
+            std::string_view output = argv[++i];
+            options.write_images = output == "images" || output == "both";
+            options.write_statistics = output == "stats" || output == "both";
+            if (!options.write_images && !options.write_statistics) {
+                Logger::instance().error("Invalid output '{}'", output);
+                return 1;
+            }
+        } else if (arg == "--frontend" && has_value) {
+            frontend_name = argv[++i];
+        } else if (spec_path.empty() && !arg.starts_with("--")) {
+            spec_path = arg;
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+    if (spec_path.empty()) {
+        print_usage();
+        return 1;
+    }
+
+    std::ifstream spec_file(spec_path);
+    if (!spec_file) {
+        Logger::instance().error("Failed to open '{}'", spec_path);
+        return 1;
+    }
+    std::stringstream spec;
+    spec << spec_file.rdbuf();
+
+    auto jobs = ifs::parse_sweep_spec(spec.str());
+    if (!jobs) {
+        Logger::instance().error("{}: {}", spec_path, jobs.error());
+        return 1;
+    }
+    Logger::instance().info("Loaded {} job(s) from {}", jobs->size(), spec_path);
+
+    try {
+        // No window: the context only needs a graphics and a compute queue
+        VulkanContext context("IFS Sweep");
+
+        auto runner = ifs::SweepRunner::create(context, extent, options);
+        if (!runner) {
+            Logger::instance().error("Failed to create sweep runner: {}", runner.error());
+            return 1;
+        }
+
+        auto backend = ifs::CustomIFS::create(context, context.device());
+        if (!backend) {
+            Logger::instance().error("Failed to create backend: {}", backend.error());
+            return 1;
+        }
+
+        if (frontend_name != "points" && frontend_name != "spheres") {
+            Logger::instance().error("Unknown frontend '{}'", frontend_name);
+            return 1;
+        }
+        auto frontend = [&]() -> std::expected<std::unique_ptr<ifs::IFSFrontend>, std::string> {
+            if (frontend_name == "spheres") {
+                return ifs::SphereRenderer::create(context, context.device(), (*runner)->render_pass(), extent);
+            }
+            return ifs::ParticleRenderer::create(context, context.device(), (*runner)->render_pass(), extent);
+        }();
+        if (!frontend) {
+            Logger::instance().error("Failed to create frontend: {}", frontend.error());
+            return 1;
+        }
+
+        auto report = (*runner)->run(*jobs, **backend, **frontend);
+        if (!report) {
+            Logger::instance().error("Sweep failed: {}", report.error());
+            return 1;
+        }
+        return report->failed == 0 ? 0 : 1;
+
+    } catch (const std::exception& e) {
+        Logger::instance().error("Unhandled exception: {}", e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,150 @@
+// Python bindings for IFSLib
+// Exposes HeadlessSession as `pyifs.Session`. Readbacks are returned as NumPy
+// arrays that view the mapped Vulkan memory directly; nothing is copied on
+// the CPU. Arrays are read-only and alias the latest readback, so use
+// `.copy()` to keep a snapshot across calls.
+
+#include <ifs/HeadlessSession.hpp>
+#include <ifs/Logger.hpp>
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <spdlog/spdlog.h>
+#include <cstddef>
+
+namespace py = pybind11;
+
+namespace {
+
+/// Keeps both the mapped allocation and the session (which owns the device) alive
+struct ArrayOwner {
+    py::object session;  // Declared first: released after the buffer, whose memory lives on its device
+    std::shared_ptr<const ifs::ReadbackBuffer> buffer;
+};
+
+template <typename T>
+T unwrap(std::expected<T, std::string> result) {
+    if (!result) {
+        throw std::runtime_error(result.error());
+    }
+    return std::move(*result);
+}
+
+void unwrap(std::expected<void, std::string> result) {
+    if (!result) {
+        throw std::runtime_error(result.error());
+    }
+}
+
+py::array make_view(py::dtype dtype, std::vector<py::ssize_t> shape, std::vector<py::ssize_t> strides,
+                    const void* data, py::handle base) {
+    py::array array(std::move(dtype), std::move(shape), std::move(strides), data, base);
+    array.attr("setflags")(py::arg("write") = false);
+    return array;
+}
+
+py::capsule particle_owner(const ifs::ParticleReadback& readback, py::handle session) {
+    return py::capsule(new ArrayOwner{py::reinterpret_borrow<py::object>(session), readback.owner},
+        [](void* owner) { delete static_cast<ArrayOwner*>(owner); });
+}
+
+} // anonymous namespace
+
+PYBIND11_MODULE(pyifs, m) {
+    m.doc() = "Headless IFS compute and rendering with zero-copy NumPy readback";
+
+    m.def("set_log_level", [](const std::string& level) {
+        Logger::instance().set_level(spdlog::level::from_str(level));
+    }, py::arg("level"), "Set the library log level (trace, debug, info, warn, error, off)");
+
+    py::class_<ifs::HeadlessSession>(m, "Session")
+        .def(py::init([](const std::string& backend, const std::string& frontend, uint32_t width, uint32_t height) {
+            return unwrap(ifs::HeadlessSession::create({
+                .backend = backend,
+                .frontend = frontend,
+                .width = width,
+                .height = height
+            }));
+        }), py::arg("backend") = "custom", py::arg("frontend") = "points",
+            py::arg("width") = 1024, py::arg("height") = 1024)
+
+        .def_property_readonly("backend_name", [](ifs::HeadlessSession& self) {
+            return std::string(self.backend().name());
+        })
+        .def_property_readonly("frontend_name", [](ifs::HeadlessSession& self) {
+            return std::string(self.frontend().name());
+        })
+
+        .def("parameters", [](ifs::HeadlessSession& self) {
+            py::dict result;
+            for (const auto& callback : self.parameters()) {
+                result[py::str(callback.field_name)] = callback.value();
+            }
+            return result;
+        }, "UI parameters of the backend and frontend and their current values")
+
+        .def("set_parameter", [](ifs::HeadlessSession& self, const std::string& name, float value) {
+            unwrap(self.set_parameter(name, value));
+        }, py::arg("name"), py::arg("value"),
+            "Set a parameter by name; matching ignores case and '_' stands for a space")
+
+        .def("compute", [](ifs::HeadlessSession& self, uint32_t seed, float scale) {
+            py::gil_scoped_release release;
+            unwrap(self.compute({.scale = scale, .random_seed = seed}));
+        }, py::arg("seed") = 0, py::arg("scale") = 1.0f, "Run the backend (seed 0 picks a random seed)")
+
+        .def("particles", [](py::object self_obj) {
+            auto& self = self_obj.cast<ifs::HeadlessSession&>();
+            auto readback = [&] {
+                py::gil_scoped_release release;
+                return unwrap(self.read_particles());
+            }();
+            constexpr auto stride = static_cast<py::ssize_t>(sizeof(ifs::Particle));
+            return make_view(py::dtype::of<float>(), {readback.count, stride / 4}, {stride, 4},
+                readback.particles, particle_owner(readback, self_obj));
+        }, "All particle fields as a float32 (N, 8) array: x, y, z, pad, r, g, b, a")
+
+        .def("positions", [](py::object self_obj) {
+            auto& self = self_obj.cast<ifs::HeadlessSession&>();
+            auto readback = [&] {
+                py::gil_scoped_release release;
+                return unwrap(self.read_particles());
+            }();
+            return make_view(py::dtype::of<float>(), {readback.count, 3},
+                {static_cast<py::ssize_t>(sizeof(ifs::Particle)), 4},
+                reinterpret_cast<const std::byte*>(readback.particles) + offsetof(ifs::Particle, position),
+                particle_owner(readback, self_obj));
+        }, "Strided float32 (N, 3) view of the particle positions")
+
+        .def("colors", [](py::object self_obj) {
+            auto& self = self_obj.cast<ifs::HeadlessSession&>();
+            auto readback = [&] {
+                py::gil_scoped_release release;
+                return unwrap(self.read_particles());
+            }();
+            return make_view(py::dtype::of<float>(), {readback.count, 4},
+                {static_cast<py::ssize_t>(sizeof(ifs::Particle)), 4},
+                reinterpret_cast<const std::byte*>(readback.particles) + offsetof(ifs::Particle, color),
+                particle_owner(readback, self_obj));
+        }, "Strided float32 (N, 4) view of the particle colors")
+
+        .def("render", [](py::object self_obj, std::optional<float> distance, std::optional<float> azimuth,
+                          std::optional<float> elevation, std::optional<std::array<float, 3>> target) {
+            auto& self = self_obj.cast<ifs::HeadlessSession&>();
+            ifs::SweepCamera camera{
+                .target = target ? std::optional(glm::vec3((*target)[0], (*target)[1], (*target)[2])) : std::nullopt,
+                .distance = distance,
+                .azimuth = azimuth,
+                .elevation = elevation
+            };
+            auto image = [&] {
+                py::gil_scoped_release release;
+                return unwrap(self.render(camera));
+            }();
+            const auto row = static_cast<py::ssize_t>(image.width) * 4;
+            return make_view(py::dtype::of<uint8_t>(), {image.height, image.width, 4}, {row, 4, 1},
+                image.pixels, self_obj);
+        }, py::arg("distance") = py::none(), py::arg("azimuth") = py::none(),
+            py::arg("elevation") = py::none(), py::arg("target") = py::none(),
+            "Render offscreen and return a uint8 (H, W, 4) sRGB view of the image");
+}
@@ -0,0 +1,367 @@
+#include <ifs/Animation.hpp>
+#include <ifs/Camera3D.hpp>
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <format>
+
+namespace ifs {
+
+namespace {
+
+std::string_view trim(std::string_view text) {
+    const auto first = text.find_first_not_of(" \t\r");
+    if (first == std::string_view::npos) {
+        return {};
+    }
+    const auto last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+std::optional<float> parse_number(std::string_view text) {
+    text = trim(text);
+    float value = 0.0f;
+    const auto* end = text.data() + text.size();
+    auto [ptr, ec] = std::from_chars(text.data(), end, value);
+    if (text.empty() || ec != std::errc() || ptr != end) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+/// Exactly `count` comma-separated numbers
+std::optional<std::vector<float>> parse_list(std::string_view text, size_t count) {
+    std::vector<float> values;
+    while (!text.empty()) {
+        const auto comma = text.find(',');
+        auto value = parse_number(text.substr(0, comma));
+        if (!value) {
+            return std::nullopt;
+        }
+        values.push_back(*value);
+        text = comma == std::string_view::npos ? std::string_view{} : text.substr(comma + 1);
+    }
+    if (values.size() != count) {
+        return std::nullopt;
+    }
+    return values;
+}
+
+/// Map index of a "mapN" / "weightN" / "colorN" key
+std::optional<size_t> parse_index(std::string_view key, std::string_view prefix) {
+    if (!key.starts_with(prefix) || key.size() == prefix.size()) {
+        return std::nullopt;
+    }
+    size_t index = 0;
+    const auto digits = key.substr(prefix.size());
+    auto [ptr, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), index);
+    if (ec != std::errc() || ptr != digits.data() + digits.size()) {
+        return std::nullopt;
+    }
+    return index;
+}
+
+/// Store one key into a keyframe that starts as a copy of the previous one
+std::expected<void, std::string> apply_key(Keyframe& keyframe, bool& has_time, std::string_view key, std::string_view value) {
+    auto& frame = keyframe.frame;
+    auto& maps = frame.ifs.maps;
+    auto number = [&]() -> std::expected<float, std::string> {
+        if (auto v = parse_number(value)) {
+            return *v;
+        }
+        return std::unexpected(std::format("{}: invalid number '{}'", key, value));
+    };
+
+    if (key == "t") {
+        auto v = number();
+        if (!v) return std::unexpected(v.error());
+        keyframe.time = *v;
+        has_time = true;
+    } else if (key == "preset") {
+        auto preset = AffineIFSDefinition::preset(value);
+        if (!preset) {
+            return std::unexpected(std::format("unknown preset '{}'", value));
+        }
+        frame.ifs = std::move(*preset);
+    } else if (key == "scale") {
+        auto v = number();
+        if (!v) return std::unexpected(v.error());
+        frame.scale = *v;
+    } else if (key == "maps") {
+        auto v = number();
+        if (!v || *v < 0.0f || *v != std::floor(*v) || *v > static_cast<float>(maps.size())) {
+            return std::unexpected(std::format("maps: expected a count of at most {}, got '{}'", maps.size(), value));
+        }
+        maps.resize(static_cast<size_t>(*v));
+    } else if (auto index = parse_index(key, "map")) {
+        auto values = parse_list(value, 12);
+        if (!values || *index > maps.size()) {
+            return std::unexpected(std::format("{}: expected 12 numbers for map 0..{}", key, maps.size()));
+        }
+        if (*index == maps.size()) {
+            maps.emplace_back();
+        }
+        auto& map = maps[*index];
+        for (int row = 0; row < 3; row++) {
+            for (int col = 0; col < 3; col++) {
+                map.linear[col][row] = (*values)[row * 3 + col];
+            }
+        }
+        map.offset = {(*values)[9], (*values)[10], (*values)[11]};
+    } else if (auto index = parse_index(key, "weight")) {
+        auto v = number();
+        if (!v || *v < 0.0f || *index >= maps.size()) {
+            return std::unexpected(std::format("{}: expected a non-negative weight of map 0..{}", key, maps.size()));
+        }
+        maps[*index].weight = *v;
+    } else if (auto index = parse_index(key, "color")) {
+        auto values = parse_list(value, 3);
+        if (!values || *index >= maps.size()) {
+            return std::unexpected(std::format("{}: expected r,g,b of map 0..{}", key, maps.size()));
+        }
+        maps[*index].color = {(*values)[0], (*values)[1], (*values)[2]};
+    } else if (key == "camera.target") {
+        auto values = parse_list(value, 3);
+        if (!values) {
+            return std::unexpected(std::format("camera.target: expected x,y,z, got '{}'", value));
+        }
+        frame.camera.target = {(*values)[0], (*values)[1], (*values)[2]};
+    } else if (key == "camera.distance" || key == "camera.azimuth" || key == "camera.elevation") {
+        auto v = number();
+        if (!v) return std::unexpected(v.error());
+        float& field = key == "camera.distance" ? frame.camera.distance
+            : key == "camera.azimuth" ? frame.camera.azimuth : frame.camera.elevation;
+        field = *v;
+    } else {
+        return std::unexpected(std::format("unknown key '{}'", key));
+    }
+    return {};
+}
+
+/**
+ * @brief Four control points around the segment containing a time
+ *
+ * Indices are clamped at the ends (the end keyframe doubles as its own
+ * neighbour), which makes the tangent there the one-sided difference.
+ */
+struct Segment {
+    std::array<const Keyframe*, 4> keys;
+    float u;  ///< Position within [keys[1], keys[2]], 0..1
+};
+
+/**
+ * @brief Non-uniform Catmull-Rom: cubic Hermite with finite-difference tangents
+ */
+template <typename T>
+T catmull_rom(const Segment& s, const T& p0, const T& p1, const T& p2, const T& p3) {
+    const float t0 = s.keys[0]->time, t1 = s.keys[1]->time, t2 = s.keys[2]->time, t3 = s.keys[3]->time;
+    const float h = t2 - t1;
+    // Tangents in units of the segment (d/du)
+    const T m1 = (p2 - p0) * (h / std::max(t2 - t0, 1e-6f));
+    const T m2 = (p3 - p1) * (h / std::max(t3 - t1, 1e-6f));
+
+    const float u = s.u, u2 = u * u, u3 = u2 * u;
+    return p1 * (2.0f * u3 - 3.0f * u2 + 1.0f) + m1 * (u3 - 2.0f * u2 + u)
+         + p2 * (-2.0f * u3 + 3.0f * u2) + m2 * (u3 - u2);
+}
+
+std::string format_floats(std::initializer_list<float> values) {
+    std::string text;
+    for (float v : values) {
+        text += text.empty() ? std::format("{}", v) : std::format(",{}", v);
+    }
+    return text;
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// CameraPose
+// ============================================================================
+
+CameraPose CameraPose::from(const Camera3D& camera) {
+    return {
+        .target = camera.target(),
+        .distance = camera.distance(),
+        .azimuth = camera.azimuth(),
+        .elevation = camera.elevation()
+    };
+}
+
+void CameraPose::apply(Camera3D& camera) const {
+    camera.set_target(target);
+    camera.set_distance(distance);
+    camera.set_rotation(azimuth, elevation);
+}
+
+SweepCamera CameraPose::sweep_camera() const {
+    return {.target = target, .distance = distance, .azimuth = azimuth, .elevation = elevation};
+}
+
+// ============================================================================
+// Timeline
+// ============================================================================
+
+void Timeline::add(Keyframe keyframe) {
+    auto it = std::ranges::lower_bound(m_keyframes, keyframe.time, {}, &Keyframe::time);
+    if (it != m_keyframes.end() && it->time == keyframe.time) {
+        *it = std::move(keyframe);
+    } else {
+        m_keyframes.insert(it, std::move(keyframe));
+    }
+}
+
+void Timeline::remove(size_t index) {
+    if (index < m_keyframes.size()) {
+        m_keyframes.erase(m_keyframes.begin() + static_cast<std::ptrdiff_t>(index));
+    }
+}
+
+std::optional<AnimationFrame> Timeline::sample(float time) const {
+    if (m_keyframes.empty()) {
+        return std::nullopt;
+    }
+    if (m_keyframes.size() == 1 || time <= m_keyframes.front().time) {
+        return m_keyframes.front().frame;
+    }
+    if (time >= m_keyframes.back().time) {
+        return m_keyframes.back().frame;
+    }
+
+    // First keyframe after `time`; the segment is [next - 1, next]
+    const auto next = static_cast<size_t>(
+        std::ranges::upper_bound(m_keyframes, time, {}, &Keyframe::time) - m_keyframes.begin());
+    const size_t last = m_keyframes.size() - 1;
+    Segment s{
+        .keys = {
+            &m_keyframes[next >= 2 ? next - 2 : 0],
+            &m_keyframes[next - 1],
+            &m_keyframes[next],
+            &m_keyframes[std::min(next + 1, last)]
+        },
+        .u = (time - m_keyframes[next - 1].time) / (m_keyframes[next].time - m_keyframes[next - 1].time)
+    };
+    auto frame_of = [&](int i) -> const AnimationFrame& { return s.keys[i]->frame; };
+
+    AnimationFrame result;
+    result.scale = catmull_rom(s, frame_of(0).scale, frame_of(1).scale, frame_of(2).scale, frame_of(3).scale);
+
+    // Camera; azimuths are unwrapped around the segment start so the camera takes the short way
+    const auto& c1 = frame_of(1).camera;
+    auto unwrap = [](float azimuth, float reference) {
+        return reference + std::remainder(azimuth - reference, 360.0f);
+    };
+    const float a1 = c1.azimuth;
+    const float a0 = unwrap(frame_of(0).camera.azimuth, a1);
+    const float a2 = unwrap(frame_of(2).camera.azimuth, a1);
+    const float a3 = unwrap(frame_of(3).camera.azimuth, a2);
+    result.camera.azimuth = catmull_rom(s, a0, a1, a2, a3);
+    result.camera.elevation = catmull_rom(s, frame_of(0).camera.elevation, c1.elevation,
+        frame_of(2).camera.elevation, frame_of(3).camera.elevation);
+    result.camera.distance = std::max(1e-3f, catmull_rom(s, frame_of(0).camera.distance, c1.distance,
+        frame_of(2).camera.distance, frame_of(3).camera.distance));
+    result.camera.target = catmull_rom(s, frame_of(0).camera.target, c1.target,
+        frame_of(2).camera.target, frame_of(3).camera.target);
+
+    // Maps; a keyframe without map i borrows it from a neighbour at weight 0
+    size_t map_count = 0;
+    for (int i = 0; i < 4; i++) {
+        map_count = std::max(map_count, frame_of(i).ifs.maps.size());
+    }
+    result.ifs.maps.resize(map_count);
+    for (size_t m = 0; m < map_count; m++) {
+        const AffineMap* reference = nullptr;
+        for (int i : {1, 2, 0, 3}) {
+            if (m < frame_of(i).ifs.maps.size()) {
+                reference = &frame_of(i).ifs.maps[m];
+                break;
+            }
+        }
+        std::array<AffineMap, 4> p;
+        for (int i = 0; i < 4; i++) {
+            const auto& maps = frame_of(i).ifs.maps;
+            p[i] = m < maps.size() ? maps[m] : *reference;
+            if (m >= maps.size()) {
+                p[i].weight = 0.0f;
+            }
+        }
+
+        auto& map = result.ifs.maps[m];
+        map.linear = catmull_rom(s, p[0].linear, p[1].linear, p[2].linear, p[3].linear);
+        map.offset = catmull_rom(s, p[0].offset, p[1].offset, p[2].offset, p[3].offset);
+        map.weight = std::max(0.0f, catmull_rom(s, p[0].weight, p[1].weight, p[2].weight, p[3].weight));
+        map.color = glm::clamp(catmull_rom(s, p[0].color, p[1].color, p[2].color, p[3].color), 0.0f, 1.0f);
+    }
+    return result;
+}
+
+std::string Timeline::serialize() const {
+    std::string text = "# t=seconds; every line is a complete keyframe (see parse_timeline)\n";
+    for (const auto& keyframe : m_keyframes) {
+        const auto& frame = keyframe.frame;
+        const auto& camera = frame.camera;
+        text += std::format("t={} scale={} camera.target={} camera.distance={} camera.azimuth={} camera.elevation={} maps=0",
+            keyframe.time, frame.scale, format_floats({camera.target.x, camera.target.y, camera.target.z}),
+            camera.distance, camera.azimuth, camera.elevation);
+        for (size_t m = 0; m < frame.ifs.maps.size(); m++) {
+            const auto& map = frame.ifs.maps[m];
+            const auto& l = map.linear;
+            text += std::format(" map{}={} weight{}={} color{}={}",
+                m, format_floats({l[0][0], l[1][0], l[2][0], l[0][1], l[1][1], l[2][1], l[0][2], l[1][2], l[2][2],
+                                  map.offset.x, map.offset.y, map.offset.z}),
+                m, map.weight,
+                m, format_floats({map.color.r, map.color.g, map.color.b}));
+        }
+        text += '\n';
+    }
+    return text;
+}
+
+std::expected<Timeline, std::string> parse_timeline(std::string_view text) {
+    Timeline timeline;
+    Keyframe current;
+    std::optional<float> previous_time;
+    size_t line_number = 0;
+
+    while (!text.empty()) {
+        const auto newline = text.find('\n');
+        auto line = trim(text.substr(0, newline));
+        text = newline == std::string_view::npos ? std::string_view{} : text.substr(newline + 1);
+        line_number++;
+
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+
+        bool has_time = false;
+        while (!line.empty()) {
+            const auto space = line.find_first_of(" \t");
+            const auto token = line.substr(0, space);
+            line = space == std::string_view::npos ? std::string_view{} : trim(line.substr(space));
+
+            const auto equals = token.find('=');
+            if (equals == std::string_view::npos || equals == 0) {
+                return std::unexpected(std::format("line {}: expected key=value, got '{}'", line_number, token));
+            }
+            if (auto result = apply_key(current, has_time, token.substr(0, equals), token.substr(equals + 1)); !result) {
+                return std::unexpected(std::format("line {}: {}", line_number, result.error()));
+            }
+        }
+
+        if (!has_time) {
+            return std::unexpected(std::format("line {}: missing t=", line_number));
+        }
+        if (previous_time && current.time <= *previous_time) {
+            return std::unexpected(std::format("line {}: keyframe times must increase", line_number));
+        }
+        if (current.frame.ifs.maps.empty()) {
+            return std::unexpected(std::format("line {}: keyframe has no maps (set preset= or map0=)", line_number));
+        }
+        previous_time = current.time;
+        timeline.add(current);
+    }
+    return timeline;
+}
+
+} // namespace ifs
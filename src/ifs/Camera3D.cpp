@@ -9,6 +9,8 @@ Camera3D::Camera3D(uint32_t viewport_width, uint32_t viewport_height)
     , m_distance(1.5f)              // Distance from target
     , m_azimuth(-90.0f)             // Facing negative Z
     , m_elevation(-35.0f)           // Looking down
+    , m_anchor(0.0)                 // Identity frame
+    , m_extent(1.0)
     , m_move_speed(0.5f)
     , m_fov(60.0f)
     , m_aspect_ratio(static_cast<float>(viewport_width) / static_cast<float>(viewport_height))
@@ -72,6 +74,20 @@ glm::mat4 Camera3D::view_projection_matrix() {
     return m_projection_matrix * m_view_matrix;
 }
 
+std::pair<glm::vec3, glm::vec3> Camera3D::screen_ray(const glm::vec2& pixel, const glm::vec2& viewport) {
+    // Renderers flip Y with a negative viewport height, so the top row is NDC y = +1.
+    // Depth 0.5 lies inside the frustum under either depth convention.
+    glm::vec4 ndc(
+        2.0f * pixel.x / viewport.x - 1.0f,
+        1.0f - 2.0f * pixel.y / viewport.y,
+        0.5f,
+        1.0f
+    );
+    glm::vec4 world = glm::inverse(view_projection_matrix()) * ndc;
+    glm::vec3 origin = position();
+    return {origin, glm::normalize(glm::vec3(world) / world.w - origin)};
+}
+
 glm::vec3 Camera3D::position() {
     // Calculate position from orbital parameters
     float azimuth_rad = glm::radians(m_azimuth);
@@ -159,7 +175,29 @@ void Camera3D::set_move_speed(float speed) {
     m_move_speed = std::clamp(speed, 0.1f, 10.0f);
 }
 
+void Camera3D::set_frame(const glm::dvec3& anchor, double extent) {
+    m_anchor = anchor;
+    m_extent = extent;
+}
+
+void Camera3D::zoom_frame(double factor) {
+    m_anchor = to_world(m_target);
+    m_extent /= factor;
+    m_target = glm::vec3(0.0f);
+    m_view_dirty = true;
+}
+
+glm::dvec3 Camera3D::to_world(const glm::vec3& local) const {
+    return m_anchor + m_extent * glm::dvec3(local);
+}
+
+glm::vec3 Camera3D::to_local(const glm::dvec3& world) const {
+    return glm::vec3((world - m_anchor) / m_extent);
+}
+
 void Camera3D::reset() {
+    m_anchor = glm::dvec3(0.0);
+    m_extent = 1.0;
     m_target = glm::vec3(0.5f, 0.5f, 0.0f);
     m_distance = 1.5f;
     m_azimuth = -90.0f;
@@ -198,8 +236,20 @@ float Camera3D::elevation() const {
     return m_elevation;
 }
 
+float Camera3D::fov() const {
+    return m_fov;
+}
+
 float Camera3D::move_speed() const {
     return m_move_speed;
 }
 
+glm::dvec3 Camera3D::anchor() const {
+    return m_anchor;
+}
+
+double Camera3D::extent() const {
+    return m_extent;
+}
+
 } // namespace ifs
@@ -0,0 +1,337 @@
+#include <ifs/CameraPath.hpp>
+#include <ifs/HeadlessSession.hpp>
+#include <ifs/Logger.hpp>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <format>
+#include <fstream>
+
+namespace ifs {
+
+namespace {
+
+std::string_view trim(std::string_view text) {
+    const auto first = text.find_first_not_of(" \t\r");
+    if (first == std::string_view::npos) {
+        return {};
+    }
+    const auto last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+template <typename T>
+std::optional<T> parse_number(std::string_view text) {
+    text = trim(text);
+    T value{};
+    const auto* end = text.data() + text.size();
+    auto [ptr, ec] = std::from_chars(text.data(), end, value);
+    if (text.empty() || ec != std::errc() || ptr != end) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+std::optional<glm::vec3> parse_vec3(std::string_view text) {
+    glm::vec3 value;
+    for (int i = 0; i < 3; i++) {
+        const auto comma = text.find(',');
+        if ((i < 2) == (comma == std::string_view::npos)) {
+            return std::nullopt;
+        }
+        auto v = parse_number<float>(text.substr(0, comma));
+        if (!v) {
+            return std::nullopt;
+        }
+        value[i] = *v;
+        text = comma == std::string_view::npos ? std::string_view{} : text.substr(comma + 1);
+    }
+    return value;
+}
+
+/// Field name as a token: spaces become '_', which find_ui_callback() matches back
+std::string parameter_key(std::string_view name) {
+    std::string key(name);
+    std::replace(key.begin(), key.end(), ' ', '_');
+    return key;
+}
+
+/// Store one key into a frame that starts as a copy of the previous one
+std::expected<void, std::string> apply_key(CameraPathFrame& frame, bool& has_time, std::string_view key, std::string_view value) {
+    auto number = [&]() -> std::expected<float, std::string> {
+        if (auto v = parse_number<float>(value)) {
+            return *v;
+        }
+        return std::unexpected(std::format("{}: invalid number '{}'", key, value));
+    };
+
+    if (key == "t") {
+        auto v = parse_number<double>(value);
+        if (!v) return std::unexpected(std::format("t: invalid number '{}'", value));
+        frame.time = *v;
+        has_time = true;
+    } else if (key == "seed") {
+        auto v = parse_number<uint32_t>(value);
+        if (!v) return std::unexpected(std::format("seed: expected an unsigned integer, got '{}'", value));
+        frame.random_seed = *v;
+    } else if (key == "scale") {
+        auto v = number();
+        if (!v) return std::unexpected(v.error());
+        frame.scale = *v;
+    } else if (key == "camera.target") {
+        auto v = parse_vec3(value);
+        if (!v) {
+            return std::unexpected(std::format("camera.target: expected x,y,z, got '{}'", value));
+        }
+        frame.camera.target = *v;
+    } else if (key == "camera.distance" || key == "camera.azimuth" || key == "camera.elevation") {
+        auto v = number();
+        if (!v) return std::unexpected(v.error());
+        float& field = key == "camera.distance" ? frame.camera.distance
+            : key == "camera.azimuth" ? frame.camera.azimuth : frame.camera.elevation;
+        field = *v;
+    } else if (key.starts_with("param.") && key.size() > 6) {
+        auto v = number();
+        if (!v) return std::unexpected(v.error());
+        frame.parameters.emplace_back(std::string(key.substr(6)), *v);
+    } else {
+        return std::unexpected(std::format("unknown key '{}'", key));
+    }
+    return {};
+}
+
+double percentile(const std::vector<double>& sorted, double fraction) {
+    const auto index = static_cast<size_t>(std::ceil(fraction * sorted.size()));
+    return sorted[std::clamp<size_t>(index, 1, sorted.size()) - 1];
+}
+
+double elapsed_ms(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// CameraPath
+// ============================================================================
+
+std::string CameraPath::serialize() const {
+    std::string text = "# t=seconds; each line changes the previous frame (see parse_camera_path)\n";
+    const CameraPathFrame* previous = nullptr;
+    for (const auto& frame : m_frames) {
+        const auto& camera = frame.camera;
+        text += std::format("t={}", frame.time);
+        if (!previous || frame.random_seed != previous->random_seed) {
+            text += std::format(" seed={}", frame.random_seed);
+        }
+        if (!previous || frame.scale != previous->scale) {
+            text += std::format(" scale={}", frame.scale);
+        }
+        if (!previous || camera.target != previous->camera.target) {
+            text += std::format(" camera.target={},{},{}", camera.target.x, camera.target.y, camera.target.z);
+        }
+        if (!previous || camera.distance != previous->camera.distance) {
+            text += std::format(" camera.distance={}", camera.distance);
+        }
+        if (!previous || camera.azimuth != previous->camera.azimuth) {
+            text += std::format(" camera.azimuth={}", camera.azimuth);
+        }
+        if (!previous || camera.elevation != previous->camera.elevation) {
+            text += std::format(" camera.elevation={}", camera.elevation);
+        }
+        for (const auto& [name, value] : frame.parameters) {
+            text += std::format(" param.{}={}", parameter_key(name), value);
+        }
+        text += '\n';
+        previous = &frame;
+    }
+    return text;
+}
+
+std::expected<CameraPath, std::string> parse_camera_path(std::string_view text) {
+    CameraPath path;
+    CameraPathFrame current;
+    std::optional<double> previous_time;
+    size_t line_number = 0;
+
+    while (!text.empty()) {
+        const auto newline = text.find('\n');
+        auto line = trim(text.substr(0, newline));
+        text = newline == std::string_view::npos ? std::string_view{} : text.substr(newline + 1);
+        line_number++;
+
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+
+        // Parameters only apply to the frame that set them
+        current.parameters.clear();
+        bool has_time = false;
+        while (!line.empty()) {
+            const auto space = line.find_first_of(" \t");
+            const auto token = line.substr(0, space);
+            line = space == std::string_view::npos ? std::string_view{} : trim(line.substr(space));
+
+            const auto equals = token.find('=');
+            if (equals == std::string_view::npos || equals == 0) {
+                return std::unexpected(std::format("line {}: expected key=value, got '{}'", line_number, token));
+            }
+            if (auto result = apply_key(current, has_time, token.substr(0, equals), token.substr(equals + 1)); !result) {
+                return std::unexpected(std::format("line {}: {}", line_number, result.error()));
+            }
+        }
+
+        if (!has_time) {
+            return std::unexpected(std::format("line {}: missing t=", line_number));
+        }
+        if (previous_time && current.time < *previous_time) {
+            return std::unexpected(std::format("line {}: frame times must not decrease", line_number));
+        }
+        previous_time = current.time;
+        path.add(current);
+    }
+    return path;
+}
+
+// ============================================================================
+// CameraPathRecorder
+// ============================================================================
+
+void CameraPathRecorder::record(
+    double time,
+    const CameraPose& camera,
+    const IFSParameters& params,
+    const std::vector<UICallback>& callbacks
+) {
+    CameraPathFrame frame{
+        .time = time,
+        .camera = camera,
+        .scale = params.scale,
+        .random_seed = params.random_seed,
+        .parameters = {}
+    };
+
+    // Everything on the first frame, then only what differs from the previous one
+    const bool first = m_path.empty();
+    if (first) {
+        m_values.clear();
+    }
+    for (size_t i = 0; i < callbacks.size(); i++) {
+        const auto& name = callbacks[i].field_name;
+        const float value = callbacks[i].value();
+        if (i >= m_values.size() || m_values[i].first != name) {
+            // The callback list changed shape (e.g. a variation joined the flame): resync
+            m_values.resize(i);
+            m_values.emplace_back(name, value);
+            frame.parameters.emplace_back(name, value);
+        } else if (first || m_values[i].second != value) {
+            m_values[i].second = value;
+            frame.parameters.emplace_back(name, value);
+        }
+    }
+    m_path.add(std::move(frame));
+}
+
+CameraPath CameraPathRecorder::take() {
+    m_values.clear();
+    return std::exchange(m_path, {});
+}
+
+// ============================================================================
+// Replay
+// ============================================================================
+
+ReplaySummary summarize_replay(const std::vector<FrameTiming>& timings) {
+    ReplaySummary summary;
+    summary.frames = timings.size();
+    if (timings.empty()) {
+        return summary;
+    }
+
+    std::vector<double> frame_ms;
+    frame_ms.reserve(timings.size());
+    for (const auto& timing : timings) {
+        frame_ms.push_back(timing.frame_ms);
+        summary.mean_ms += timing.frame_ms;
+        summary.recomputes += timing.recomputed;
+    }
+    summary.mean_ms /= static_cast<double>(timings.size());
+    std::sort(frame_ms.begin(), frame_ms.end());
+    summary.p50_ms = percentile(frame_ms, 0.50);
+    summary.p95_ms = percentile(frame_ms, 0.95);
+    summary.p99_ms = percentile(frame_ms, 0.99);
+    summary.max_ms = frame_ms.back();
+    return summary;
+}
+
+bool write_frame_timings(const std::filesystem::path& path, const std::vector<FrameTiming>& timings) {
+    std::ofstream file(path);
+    if (!file) {
+        return false;
+    }
+    file << "frame,recomputed,frame_ms,compute_ms,compute_gpu_ms\n";
+    for (const auto& timing : timings) {
+        file << std::format("{},{},{:.4f},{:.4f},{:.4f}\n", timing.frame, timing.recomputed ? 1 : 0,
+            timing.frame_ms, timing.compute_ms, timing.compute_gpu_ms);
+    }
+    return static_cast<bool>(file);
+}
+
+std::vector<std::pair<std::string, float>> apply_path_parameters(
+    std::span<const std::pair<std::string, float>> parameters,
+    const std::vector<UICallback>& callbacks
+) {
+    std::vector<std::pair<std::string, float>> unmatched;
+    for (const auto& [name, value] : parameters) {
+        if (const auto* callback = find_ui_callback(callbacks, name)) {
+            callback->set_value(value);
+        } else {
+            unmatched.emplace_back(name, value);
+        }
+    }
+    return unmatched;
+}
+
+std::expected<std::vector<FrameTiming>, std::string> replay_camera_path(HeadlessSession& session, const CameraPath& path) {
+    std::vector<FrameTiming> timings;
+    timings.reserve(path.frames().size());
+
+    IFSParameters params;
+    for (size_t n = 0; n < path.frames().size(); n++) {
+        const auto& frame = path.frames()[n];
+        const auto start = std::chrono::steady_clock::now();
+        FrameTiming timing{.frame = static_cast<uint32_t>(n)};
+
+        // Backend parameters first; the rest belong to the frontend
+        auto rest = apply_path_parameters(frame.parameters, session.backend().get_ui_callbacks());
+        const bool backend_changed = rest.size() < frame.parameters.size();
+        for (const auto& [name, value] : apply_path_parameters(rest, session.frontend().get_ui_callbacks())) {
+            Logger::instance().warn("Frame {}: no parameter named '{}'", n, name);
+        }
+
+        timing.recomputed = n == 0 || backend_changed ||
+            frame.random_seed != params.random_seed || frame.scale != params.scale;
+        if (timing.recomputed) {
+            params.random_seed = frame.random_seed;
+            params.scale = frame.scale;
+            const auto compute_start = std::chrono::steady_clock::now();
+            if (auto result = session.compute(params); !result) {
+                return std::unexpected(std::format("frame {}: {}", n, result.error()));
+            }
+            timing.compute_ms = elapsed_ms(compute_start);
+            if (const auto* stats = session.backend().compute_stats()) {
+                timing.compute_gpu_ms = stats->gpu_ms;
+            }
+        }
+
+        if (auto image = session.render(frame.camera.sweep_camera()); !image) {
+            return std::unexpected(std::format("frame {}: {}", n, image.error()));
+        }
+        timing.frame_ms = elapsed_ms(start);
+        timings.push_back(timing);
+    }
+    return timings;
+}
+
+} // namespace ifs
@@ -0,0 +1,314 @@
+#include <ifs/ComputeScheduler.hpp>
+#include <ifs/Logger.hpp>
+#include <algorithm>
+#include <array>
+#include <format>
+
+namespace ifs {
+
+namespace {
+
+// Chunks smaller than this are dominated by submission overhead
+constexpr uint32_t MIN_ITEMS_PER_CHUNK = 256 * 1024;
+// Chunks per queue, so queues that finish early can't sit idle for long
+constexpr uint32_t CHUNKS_PER_QUEUE = 4;
+
+uint64_t round_up(uint64_t value, uint64_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+} // anonymous namespace
+
+ComputeScheduler::ComputeScheduler(const VulkanContext& context, uint32_t max_chunks)
+    : m_context(&context)
+    , m_device(context.device())
+    , m_max_chunks(std::max(max_chunks, 1u))
+    , m_max_items_per_chunk(context.physical_device().getProperties().limits.maxComputeWorkGroupCount[0])
+    , m_join_command_buffer(nullptr)
+    , m_prepare_command_buffer(nullptr)
+    , m_fence(nullptr)
+{}
+
+std::expected<std::unique_ptr<ComputeScheduler>, std::string> ComputeScheduler::create(
+    const VulkanContext& context,
+    uint32_t max_chunks
+) {
+    auto scheduler = std::unique_ptr<ComputeScheduler>(new ComputeScheduler(context, max_chunks));
+
+    if (auto result = scheduler->initialize(); !result) {
+        return std::unexpected(result.error());
+    }
+
+    Logger::instance().info("Created ComputeScheduler with {} compute queue(s)", scheduler->queue_count());
+    return scheduler;
+}
+
+std::expected<void, std::string> ComputeScheduler::initialize() {
+    const uint32_t family = m_context->queue_indices().compute;
+
+    for (auto queue : m_context->compute_queues()) {
+        Lane lane{.queue = queue, .command_pool = nullptr, .command_buffer = nullptr, .finished = nullptr, .ready = nullptr};
+
+        auto cmd_pool_info = vk::CommandPoolCreateInfo()
+            .setQueueFamilyIndex(family)
+            .setFlags(vk::CommandPoolCreateFlagBits::eResetCommandBuffer);
+
+		auto cmd_pool_res = m_device.createCommandPool(cmd_pool_info);
+		if (cmd_pool_res.result != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Failed to create compute command pool: {}", to_string(cmd_pool_res.result)));
+		}
+		lane.command_pool = cmd_pool_res.value;
+        m_lanes.push_back(lane);  // Pushed early so cleanup in the destructor sees it
+
+        auto cmd_alloc_info = vk::CommandBufferAllocateInfo()
+            .setCommandPool(lane.command_pool)
+            .setLevel(vk::CommandBufferLevel::ePrimary)
+            .setCommandBufferCount(1);
+
+		auto cmd_buffers_res = m_device.allocateCommandBuffers(cmd_alloc_info);
+		if (cmd_buffers_res.result != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Failed to allocate compute command buffer: {}", to_string(cmd_buffers_res.result)));
+		}
+		m_lanes.back().command_buffer = cmd_buffers_res.value[0];
+
+		auto semaphore_res = m_device.createSemaphore({});
+		if (semaphore_res.result != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Failed to create compute semaphore: {}", to_string(semaphore_res.result)));
+		}
+		m_lanes.back().finished = semaphore_res.value;
+
+		auto ready_res = m_device.createSemaphore({});
+		if (ready_res.result != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Failed to create compute semaphore: {}", to_string(ready_res.result)));
+		}
+		m_lanes.back().ready = ready_res.value;
+    }
+
+    if (m_lanes.empty()) {
+        return std::unexpected("Context exposes no compute queues");
+    }
+
+    // Join and prepare command buffers live on queue 0
+    auto join_alloc_info = vk::CommandBufferAllocateInfo()
+        .setCommandPool(m_lanes.front().command_pool)
+        .setLevel(vk::CommandBufferLevel::ePrimary)
+        .setCommandBufferCount(2);
+
+	auto join_res = m_device.allocateCommandBuffers(join_alloc_info);
+	if (join_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to allocate join command buffer: {}", to_string(join_res.result)));
+	}
+	m_join_command_buffer = join_res.value[0];
+	m_prepare_command_buffer = join_res.value[1];
+
+	auto fence_res = m_device.createFence({vk::FenceCreateFlagBits::eSignaled});
+	if (fence_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create compute fence: {}", to_string(fence_res.result)));
+	}
+	m_fence = fence_res.value;
+
+    auto profiler_res = TimestampProfiler::create(*m_context, m_max_chunks, family);
+    if (!profiler_res) {
+        return std::unexpected(profiler_res.error());
+    }
+    m_profiler = std::move(*profiler_res);
+
+    return {};
+}
+
+ComputeScheduler::~ComputeScheduler() {
+    if (m_fence) {
+        [[maybe_unused]] auto result = m_device.waitForFences(m_fence, true, UINT64_MAX);
+        m_device.destroyFence(m_fence);
+    }
+    for (auto& lane : m_lanes) {
+        if (lane.finished) {
+            m_device.destroySemaphore(lane.finished);
+        }
+        if (lane.ready) {
+            m_device.destroySemaphore(lane.ready);
+        }
+        if (lane.command_pool) {
+            // Command buffers (including the join buffer) are freed with the pool
+            m_device.destroyCommandPool(lane.command_pool);
+        }
+    }
+}
+
+std::vector<ComputeChunk> ComputeScheduler::make_chunks(uint32_t item_count) const {
+    std::vector<ComputeChunk> chunks;
+    if (item_count == 0) {
+        return chunks;
+    }
+
+    const uint64_t granularity = std::max(m_granularity, 1u);
+    const uint64_t max_items = static_cast<uint64_t>(m_max_items_per_chunk) * granularity;
+    const uint64_t target_chunks = static_cast<uint64_t>(m_lanes.size()) * CHUNKS_PER_QUEUE;
+
+    uint64_t per_chunk = round_up((item_count + target_chunks - 1) / target_chunks, granularity);
+    per_chunk = std::max<uint64_t>(per_chunk, MIN_ITEMS_PER_CHUNK);
+    // Never exceed the chunk budget, then respect the workgroup count limit
+    per_chunk = std::max(per_chunk, round_up((item_count + m_max_chunks - 1) / m_max_chunks, granularity));
+    per_chunk = std::min(per_chunk, max_items);
+
+    for (uint64_t first = 0; first < item_count; first += per_chunk) {
+        auto count = static_cast<uint32_t>(std::min<uint64_t>(per_chunk, item_count - first));
+        chunks.push_back({static_cast<uint32_t>(first), count});
+    }
+    return chunks;
+}
+
+void ComputeScheduler::submit(
+    uint32_t item_count,
+    const RecordChunkFn& record_chunk,
+    const FinalizeFn& finalize,
+    const PrepareFn& prepare
+) {
+    wait();
+
+    auto chunks = make_chunks(item_count);
+    const auto lanes_used = static_cast<uint32_t>(std::min(chunks.size(), m_lanes.size()));
+    const uint32_t lane_count = std::max(lanes_used, 1u);
+
+    m_profiler->reset();
+    m_chunk_lane.clear();
+
+    for (uint32_t l = 0; l < lane_count; l++) {
+        auto cmd = m_lanes[l].command_buffer;
+        auto _ = cmd.reset();
+        auto _ = cmd.begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+    }
+
+    // One queue: prepare ahead of the chunks in the same command buffer
+    if (prepare && lane_count == 1) {
+        prepare(m_lanes.front().command_buffer);
+    }
+
+    // Round-robin chunks over the lanes
+    for (size_t c = 0; c < chunks.size(); c++) {
+        auto lane = static_cast<uint32_t>(c % lane_count);
+        auto cmd = m_lanes[lane].command_buffer;
+
+        auto scope = m_profiler->begin_scope(cmd, "chunk", vk::PipelineStageFlagBits::eComputeShader);
+        record_chunk(cmd, chunks[c]);
+        m_profiler->end_scope(cmd, scope, vk::PipelineStageFlagBits::eComputeShader);
+        if (scope != UINT32_MAX) {
+            m_chunk_lane.push_back(lane);
+        }
+    }
+
+    auto _ = m_device.resetFences(m_fence);
+
+    if (lane_count == 1) {
+        auto cmd = m_lanes.front().command_buffer;
+        if (finalize) {
+            finalize(cmd);
+        }
+        auto _ = cmd.end();
+
+        auto submit_info = vk::SubmitInfo().setCommandBuffers(cmd);
+        auto _ = m_lanes.front().queue.submit(submit_info, m_fence);
+    } else {
+        // Prepare on queue 0 first: its chunks follow in queue order, the other lanes wait for it
+        std::vector<vk::Semaphore> ready;
+        if (prepare) {
+            auto _ = m_prepare_command_buffer.reset();
+            auto _ = m_prepare_command_buffer.begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+            prepare(m_prepare_command_buffer);
+            auto _ = m_prepare_command_buffer.end();
+
+            for (uint32_t l = 1; l < lane_count; l++) {
+                ready.push_back(m_lanes[l].ready);
+            }
+            auto submit_info = vk::SubmitInfo()
+                .setCommandBuffers(m_prepare_command_buffer)
+                .setSignalSemaphores(ready);
+            auto _ = m_lanes.front().queue.submit(submit_info, nullptr);
+        }
+
+        // Fork: lanes 1..N signal their semaphore when their chunks are done
+        std::vector<vk::Semaphore> join_waits;
+        const vk::PipelineStageFlags ready_stage = vk::PipelineStageFlagBits::eComputeShader;
+        for (uint32_t l = 1; l < lane_count; l++) {
+            auto cmd = m_lanes[l].command_buffer;
+            auto _ = cmd.end();
+
+            auto submit_info = vk::SubmitInfo()
+                .setCommandBuffers(cmd)
+                .setSignalSemaphores(m_lanes[l].finished);
+            if (prepare) {
+                submit_info.setWaitSemaphores(m_lanes[l].ready).setWaitDstStageMask(ready_stage);
+            }
+            auto _ = m_lanes[l].queue.submit(submit_info, nullptr);
+            join_waits.push_back(m_lanes[l].finished);
+        }
+
+        // Join: queue 0 runs its own chunks, then waits for the other lanes
+        auto lane0_cmd = m_lanes.front().command_buffer;
+        auto _ = lane0_cmd.end();
+
+        auto _ = m_join_command_buffer.reset();
+        auto _ = m_join_command_buffer.begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+        // Make the other queues' writes (via semaphore) and queue 0's writes
+        // (via barrier) visible to whatever the finalize step or later compute reads
+        auto barrier = vk::MemoryBarrier()
+            .setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+            .setDstAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite);
+        m_join_command_buffer.pipelineBarrier(
+            vk::PipelineStageFlagBits::eComputeShader,
+            vk::PipelineStageFlagBits::eComputeShader,
+            {},
+            barrier,
+            {},
+            {}
+        );
+        if (finalize) {
+            finalize(m_join_command_buffer);
+        }
+        auto _ = m_join_command_buffer.end();
+
+        std::vector<vk::PipelineStageFlags> wait_stages(join_waits.size(), vk::PipelineStageFlagBits::eComputeShader);
+        std::array submits = {
+            vk::SubmitInfo().setCommandBuffers(lane0_cmd),
+            vk::SubmitInfo()
+                .setWaitSemaphores(join_waits)
+                .setWaitDstStageMask(wait_stages)
+                .setCommandBuffers(m_join_command_buffer)
+        };
+        auto _ = m_lanes.front().queue.submit(submits, m_fence);
+    }
+
+    m_stats = ComputeStats{};
+    m_stats.queue_count = lanes_used;
+    m_stats.chunk_count = static_cast<uint32_t>(chunks.size());
+    m_stats_pending = true;
+}
+
+void ComputeScheduler::wait() {
+    if (!m_fence) {
+        return;
+    }
+    [[maybe_unused]] auto result = m_device.waitForFences(m_fence, true, UINT64_MAX);
+
+    if (!m_stats_pending) {
+        return;
+    }
+    m_stats_pending = false;
+
+    auto scopes = m_profiler->resolve();
+    m_stats.queue_busy_ms.assign(m_stats.queue_count, 0.0);
+    double span_end = 0.0;
+    for (size_t i = 0; i < scopes.size() && i < m_chunk_lane.size(); i++) {
+        m_stats.queue_busy_ms[m_chunk_lane[i]] += scopes[i].duration_ms;
+        span_end = std::max(span_end, scopes[i].begin_ms + scopes[i].duration_ms);
+    }
+    m_stats.gpu_ms = span_end;
+}
+
+} // namespace ifs
@@ -0,0 +1,437 @@
+#include <ifs/FractalDimension.hpp>
+#include <ifs/Logger.hpp>
+#include <ifs/StartupTrace.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <format>
+
+namespace ifs {
+
+namespace {
+
+constexpr uint32_t GROUP_SIZE = 256;
+constexpr uint32_t MAX_STRIDE_GROUPS = 4096;  ///< Workgroups of the grid-stride particle passes
+constexpr uint32_t MIN_PARTICLES_PER_BOX = 8;
+constexpr uint32_t BINDING_COUNT = 3;
+
+constexpr std::array KERNEL_SHADERS = {
+    "ifs_modular/analysis/box_count/bounds.slang",
+    "ifs_modular/analysis/box_count/mark.slang",
+};
+
+} // anonymous namespace
+
+// ============================================================================
+// Fit
+// ============================================================================
+
+std::expected<FractalDimensionEstimate, std::string> fit_box_counting(
+    const std::vector<BoxCount>& counts,
+    uint64_t particle_count
+) {
+    FractalDimensionEstimate estimate;
+    estimate.counts = counts;
+
+    // Levels 2.. up to the last one that still averages enough particles per box
+    std::vector<BoxCount> fitted;
+    for (const auto& count : counts) {
+        if (count.level < 2 || count.boxes == 0) {
+            continue;
+        }
+        if (static_cast<uint64_t>(count.boxes) * MIN_PARTICLES_PER_BOX > particle_count) {
+            break;
+        }
+        fitted.push_back(count);
+    }
+    if (fitted.size() < 3) {
+        return std::unexpected(std::format(
+            "Too few well-sampled levels for a fit ({} of {} particles per box needed)",
+            fitted.size(), MIN_PARTICLES_PER_BOX));
+    }
+
+    const double n = static_cast<double>(fitted.size());
+    double mean_x = 0.0;
+    double mean_y = 0.0;
+    for (const auto& count : fitted) {
+        mean_x += count.level;
+        mean_y += std::log2(static_cast<double>(count.boxes));
+    }
+    mean_x /= n;
+    mean_y /= n;
+
+    double sxx = 0.0;
+    double sxy = 0.0;
+    double syy = 0.0;
+    for (const auto& count : fitted) {
+        const double dx = count.level - mean_x;
+        const double dy = std::log2(static_cast<double>(count.boxes)) - mean_y;
+        sxx += dx * dx;
+        sxy += dx * dy;
+        syy += dy * dy;
+    }
+
+    // Box side halves per level, so the slope in log2 units is the dimension
+    const double slope = sxy / sxx;
+    const double residual = std::max(syy - slope * sxy, 0.0);
+
+    estimate.fit_first = fitted.front().level;
+    estimate.fit_last = fitted.back().level;
+    estimate.dimension = slope;
+    estimate.standard_error = std::sqrt(residual / (n - 2.0) / sxx);
+    estimate.r_squared = syy > 0.0 ? 1.0 - residual / syy : 1.0;
+    return estimate;
+}
+
+// ============================================================================
+// FractalDimension
+// ============================================================================
+
+FractalDimension::FractalDimension(const VulkanContext& context, FractalDimensionConfig config)
+    : m_context(&context)
+    , m_device(context.device())
+    , m_config(config)
+    , m_descriptor_layout(nullptr)
+    , m_pipeline_layout(nullptr)
+    , m_descriptor_pool(nullptr)
+    , m_descriptor_set(nullptr)
+    , m_state_buffer(nullptr)
+    , m_state_memory(nullptr)
+    , m_occupancy(nullptr)
+    , m_occupancy_memory(nullptr)
+    , m_command_pool(nullptr)
+    , m_cmd(nullptr)
+    , m_fence(nullptr)
+{}
+
+std::expected<std::unique_ptr<FractalDimension>, std::string> FractalDimension::create(
+    const VulkanContext& context,
+    FractalDimensionConfig config
+) {
+    config.max_level = std::clamp(config.max_level, 3u, MAX_LEVEL);
+
+    auto estimator = std::unique_ptr<FractalDimension>(new FractalDimension(context, config));
+    if (auto result = estimator->initialize(); !result) {
+        return std::unexpected(result.error());
+    }
+    return estimator;
+}
+
+FractalDimension::~FractalDimension() {
+    wait_idle();
+
+    if (m_fence) m_device.destroyFence(m_fence);
+    if (m_command_pool) m_device.destroyCommandPool(m_command_pool);
+
+    for (auto pipeline : m_pipelines) {
+        if (pipeline) m_device.destroyPipeline(pipeline);
+    }
+    if (m_pipeline_layout) m_device.destroyPipelineLayout(m_pipeline_layout);
+    if (m_descriptor_pool) m_device.destroyDescriptorPool(m_descriptor_pool);
+    if (m_descriptor_layout) m_device.destroyDescriptorSetLayout(m_descriptor_layout);
+
+    if (m_state_buffer) m_device.destroyBuffer(m_state_buffer);
+    if (m_state_memory) m_device.freeMemory(m_state_memory);
+    if (m_occupancy) m_device.destroyBuffer(m_occupancy);
+    if (m_occupancy_memory) m_device.freeMemory(m_occupancy_memory);
+}
+
+std::expected<void, std::string> FractalDimension::initialize() {
+    // Level L has 8^L boxes, one bit each
+    uint32_t offset = 0;
+    for (uint32_t level = 1; level <= m_config.max_level; level++) {
+        m_push.level_offsets[level] = offset;
+        offset += std::max(1u, (1u << (3 * level)) / 32);
+    }
+    m_occupancy_size = static_cast<vk::DeviceSize>(offset) * sizeof(uint32_t);
+    m_push.counts.y = m_config.max_level;
+
+    if (auto result = create_pipelines(); !result) {
+        return std::unexpected(result.error());
+    }
+    if (auto result = create_buffers(); !result) {
+        return std::unexpected(result.error());
+    }
+    if (auto result = create_commands(); !result) {
+        return std::unexpected(result.error());
+    }
+
+    Logger::instance().info("Fractal dimension estimator ready: {} levels, {:.1f} MB of bitmaps",
+        m_config.max_level, m_occupancy_size / (1024.0 * 1024.0));
+    return {};
+}
+
+std::expected<void, std::string> FractalDimension::create_pipelines() {
+    auto trace_scope = StartupTrace::instance().phase("pipeline:FractalDimension");
+
+    std::array<vk::DescriptorSetLayoutBinding, BINDING_COUNT> bindings;
+    for (uint32_t i = 0; i < BINDING_COUNT; i++) {
+        bindings[i] = vk::DescriptorSetLayoutBinding()
+            .setBinding(i)
+            .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+            .setDescriptorCount(1)
+            .setStageFlags(vk::ShaderStageFlagBits::eCompute);
+    }
+
+	auto layout_res = m_device.createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo().setBindings(bindings));
+	if (layout_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create box counting descriptor layout: {}", to_string(layout_res.result)));
+	}
+	m_descriptor_layout = layout_res.value;
+
+    auto push_constant_range = vk::PushConstantRange()
+        .setStageFlags(vk::ShaderStageFlagBits::eCompute)
+        .setOffset(0)
+        .setSize(sizeof(BoxCountPush));
+
+    auto pipeline_layout_info = vk::PipelineLayoutCreateInfo()
+        .setSetLayouts(m_descriptor_layout)
+        .setPushConstantRanges(push_constant_range);
+
+	auto pipeline_layout_res = m_device.createPipelineLayout(pipeline_layout_info);
+	if (pipeline_layout_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create box counting pipeline layout: {}", to_string(pipeline_layout_res.result)));
+	}
+	m_pipeline_layout = pipeline_layout_res.value;
+
+    for (size_t i = 0; i < KERNEL_SHADERS.size(); i++) {
+        auto shader = Shader::create_shader(m_device, KERNEL_SHADERS[i], "main");
+        if (!shader) {
+            return std::unexpected(std::format("Failed to load {}: {}", KERNEL_SHADERS[i], shader.error()));
+        }
+        if (!std::holds_alternative<ComputeDetails>(shader->get_details())) {
+            return std::unexpected(std::format("{} is not a compute shader", KERNEL_SHADERS[i]));
+        }
+
+        auto pipeline_info = vk::ComputePipelineCreateInfo()
+            .setStage(shader->create_pipeline_shader_stage_create_info())
+            .setLayout(m_pipeline_layout);
+
+		auto pipeline_res = m_device.createComputePipeline(nullptr, pipeline_info);
+		if (pipeline_res.result != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Failed to create {} pipeline: {}", KERNEL_SHADERS[i], to_string(pipeline_res.result)));
+		}
+		m_pipelines[i] = pipeline_res.value;
+        m_shaders.push_back(std::move(*shader));
+    }
+
+    return {};
+}
+
+std::expected<void, std::string> FractalDimension::create_buffers() {
+    struct Allocation {
+        vk::DeviceSize size;
+        vk::Buffer* buffer;
+        vk::DeviceMemory* memory;
+    };
+    std::array allocations = {
+        Allocation{sizeof(BoxCountState), &m_state_buffer, &m_state_memory},
+        Allocation{m_occupancy_size, &m_occupancy, &m_occupancy_memory},
+    };
+    for (auto& allocation : allocations) {
+        auto buffer_info = vk::BufferCreateInfo()
+            .setSize(allocation.size)
+            .setUsage(vk::BufferUsageFlagBits::eStorageBuffer |
+                      vk::BufferUsageFlagBits::eTransferDst |
+                      vk::BufferUsageFlagBits::eTransferSrc)
+            .setSharingMode(vk::SharingMode::eExclusive);
+
+		auto buffer_res = m_device.createBuffer(buffer_info);
+		if (buffer_res.result != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Failed to create box counting buffer: {}", to_string(buffer_res.result)));
+		}
+		*allocation.buffer = buffer_res.value;
+
+        auto requirements = m_device.getBufferMemoryRequirements(*allocation.buffer);
+        auto memory_type = m_context->find_memory_type(requirements.memoryTypeBits,
+            vk::MemoryPropertyFlagBits::eDeviceLocal);
+        if (!memory_type) {
+            return std::unexpected("Failed to find device-local memory for box counting");
+        }
+
+		auto alloc_res = m_device.allocateMemory(vk::MemoryAllocateInfo(requirements.size, *memory_type));
+		if (alloc_res.result != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Failed to allocate box counting memory ({} bytes): {}", allocation.size, to_string(alloc_res.result)));
+		}
+		*allocation.memory = alloc_res.value;
+        auto _ = m_device.bindBufferMemory(*allocation.buffer, *allocation.memory, 0);
+    }
+
+    auto readback = ReadbackBuffer::create(*m_context, sizeof(BoxCountState));
+    if (!readback) {
+        return std::unexpected(readback.error());
+    }
+    m_readback = std::move(*readback);
+
+    auto pool_size = vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, BINDING_COUNT);
+	auto pool_res = m_device.createDescriptorPool(vk::DescriptorPoolCreateInfo().setMaxSets(1).setPoolSizes(pool_size));
+	if (pool_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create box counting descriptor pool: {}", to_string(pool_res.result)));
+	}
+	m_descriptor_pool = pool_res.value;
+
+	auto set_res = m_device.allocateDescriptorSets(vk::DescriptorSetAllocateInfo(m_descriptor_pool, m_descriptor_layout));
+	if (set_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to allocate box counting descriptor set: {}", to_string(set_res.result)));
+	}
+	m_descriptor_set = set_res.value.front();
+
+    // Particles (0) are bound by estimate()
+    std::array infos = {
+        vk::DescriptorBufferInfo(m_state_buffer, 0, VK_WHOLE_SIZE),
+        vk::DescriptorBufferInfo(m_occupancy, 0, VK_WHOLE_SIZE),
+    };
+    std::array writes = {
+        vk::WriteDescriptorSet().setDstSet(m_descriptor_set).setDstBinding(1)
+            .setDescriptorType(vk::DescriptorType::eStorageBuffer).setBufferInfo(infos[0]),
+        vk::WriteDescriptorSet().setDstSet(m_descriptor_set).setDstBinding(2)
+            .setDescriptorType(vk::DescriptorType::eStorageBuffer).setBufferInfo(infos[1]),
+    };
+    m_device.updateDescriptorSets(writes, {});
+
+    return {};
+}
+
+std::expected<void, std::string> FractalDimension::create_commands() {
+    const uint32_t family = m_context->queue_indices().graphics;
+
+    auto pool_info = vk::CommandPoolCreateInfo()
+        .setFlags(vk::CommandPoolCreateFlagBits::eResetCommandBuffer)
+        .setQueueFamilyIndex(family);
+
+	auto pool_res = m_device.createCommandPool(pool_info);
+	if (pool_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create box counting command pool: {}", to_string(pool_res.result)));
+	}
+	m_command_pool = pool_res.value;
+
+	auto cmd_res = m_device.allocateCommandBuffers(
+		vk::CommandBufferAllocateInfo(m_command_pool, vk::CommandBufferLevel::ePrimary, 1));
+	if (cmd_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to allocate box counting command buffer: {}", to_string(cmd_res.result)));
+	}
+	m_cmd = cmd_res.value.front();
+
+	auto fence_res = m_device.createFence({vk::FenceCreateFlagBits::eSignaled});
+	if (fence_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create box counting fence: {}", to_string(fence_res.result)));
+	}
+	m_fence = fence_res.value;
+
+    auto profiler = TimestampProfiler::create(*m_context, 1, family);
+    if (!profiler) {
+        return std::unexpected(profiler.error());
+    }
+    m_profiler = std::move(*profiler);
+
+    return {};
+}
+
+std::expected<void, std::string> FractalDimension::estimate(vk::Buffer particle_buffer, uint32_t particle_count) {
+    wait_idle();
+    m_pending = false;
+    if (particle_count == 0) {
+        return std::unexpected("No particles to count");
+    }
+
+    auto buffer_info = vk::DescriptorBufferInfo(particle_buffer, 0, VK_WHOLE_SIZE);
+    auto write = vk::WriteDescriptorSet().setDstSet(m_descriptor_set).setDstBinding(0)
+        .setDescriptorType(vk::DescriptorType::eStorageBuffer).setBufferInfo(buffer_info);
+    m_device.updateDescriptorSets(write, {});
+    m_particle_count = particle_count;
+
+    const uint32_t groups = std::min((particle_count + GROUP_SIZE - 1) / GROUP_SIZE, MAX_STRIDE_GROUPS);
+    BoxCountPush push = m_push;
+    push.counts.x = particle_count;
+    push.counts.z = groups * GROUP_SIZE;
+
+    auto barrier = vk::MemoryBarrier()
+        .setSrcAccessMask(vk::AccessFlagBits::eShaderWrite | vk::AccessFlagBits::eTransferWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite |
+                          vk::AccessFlagBits::eTransferRead);
+    const auto stages = vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eTransfer;
+
+    m_profiler->reset();
+    auto cmd = m_cmd;
+    auto _ = cmd.reset();
+    auto _ = cmd.begin(vk::CommandBufferBeginInfo().setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+    auto scope = m_profiler->begin_scope(cmd, "box_count");
+
+    // Bounds start at (+max, -max) in the ordered encoding, counts and bitmaps at zero
+    cmd.fillBuffer(m_state_buffer, offsetof(BoxCountState, bounds_min), sizeof(glm::uvec4), 0xffffffffu);
+    cmd.fillBuffer(m_state_buffer, offsetof(BoxCountState, bounds_max), VK_WHOLE_SIZE, 0u);
+    cmd.fillBuffer(m_occupancy, 0, VK_WHOLE_SIZE, 0u);
+    cmd.pipelineBarrier(stages, stages, {}, barrier, {}, {});
+
+    cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_pipeline_layout, 0, m_descriptor_set, {});
+    cmd.pushConstants(m_pipeline_layout, vk::ShaderStageFlagBits::eCompute, 0, sizeof(BoxCountPush), &push);
+
+    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, m_pipelines[static_cast<size_t>(Kernel::Bounds)]);
+    cmd.dispatch(groups, 1, 1);
+    cmd.pipelineBarrier(stages, stages, {}, barrier, {}, {});
+
+    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, m_pipelines[static_cast<size_t>(Kernel::Mark)]);
+    cmd.dispatch(groups, 1, 1);
+    cmd.pipelineBarrier(stages, stages, {}, barrier, {}, {});
+
+    cmd.copyBuffer(m_state_buffer, m_readback->buffer(), vk::BufferCopy(0, 0, sizeof(BoxCountState)));
+    auto to_host = vk::MemoryBarrier()
+        .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eHostRead);
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eHost, {}, to_host, {}, {});
+
+    m_profiler->end_scope(cmd, scope);
+    auto _ = cmd.end();
+
+    auto _ = m_device.resetFences(m_fence);
+	auto submit_res = m_context->graphics_queue().submit(vk::SubmitInfo().setCommandBuffers(cmd), m_fence);
+	if (submit_res != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to submit box counting: {}", to_string(submit_res)));
+	}
+    m_pending = true;
+    return {};
+}
+
+std::optional<std::expected<FractalDimensionEstimate, std::string>> FractalDimension::poll() {
+    if (!m_pending || m_device.getFenceStatus(m_fence) != vk::Result::eSuccess) {
+        return std::nullopt;
+    }
+    m_pending = false;
+
+    m_readback->invalidate();
+    BoxCountState state;
+    std::memcpy(&state, m_readback->data(), sizeof(BoxCountState));
+
+    std::vector<BoxCount> counts;
+    for (uint32_t level = 1; level <= m_config.max_level; level++) {
+        counts.push_back({level, state.boxes[level]});
+    }
+
+    auto estimate = fit_box_counting(counts, m_particle_count);
+    if (estimate) {
+        auto scopes = m_profiler->resolve();
+        estimate->gpu_ms = scopes.empty() ? 0.0 : scopes.front().duration_ms;
+        Logger::instance().debug("Box-counting dimension {:.4f} +- {:.4f} over levels {}-{} ({:.3f} ms)",
+            estimate->dimension, estimate->standard_error, estimate->fit_first, estimate->fit_last, estimate->gpu_ms);
+    }
+    return estimate;
+}
+
+void FractalDimension::wait_idle() {
+    if (m_fence) {
+        auto _ = m_device.waitForFences(m_fence, true, UINT64_MAX);
+    }
+}
+
+} // namespace ifs
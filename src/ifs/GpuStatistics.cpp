@@ -0,0 +1,392 @@
+#include <ifs/GpuStatistics.hpp>
+#include <ifs/Logger.hpp>
+#include <ifs/StartupTrace.hpp>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <format>
+
+namespace ifs {
+
+namespace {
+
+constexpr uint32_t GROUP_SIZE = 256;
+constexpr uint32_t MAX_STRIDE_GROUPS = 4096;  ///< Workgroups of the grid-stride histogram pass
+constexpr uint32_t BINDING_COUNT = 2;
+
+constexpr uint32_t SOURCE_FLOAT = 1;
+constexpr uint32_t SOURCE_LOG = 2;
+constexpr uint32_t SOURCE_SKIP_ZERO = 4;
+
+constexpr std::array KERNEL_SHADERS = {
+    "ifs_modular/analysis/statistics/histogram.slang",
+    "ifs_modular/analysis/statistics/finalize.slang",
+};
+
+// Push constants matching StatisticsPush in statistics.slang
+struct StatisticsPush {
+    glm::uvec4 counts;  ///< x: elements, y: words per element, z: word of the value, w: grid-stride threads
+    uint32_t mask;
+    uint32_t flags;
+    uint32_t bin_count;
+    float range_min;
+    float range_max;
+    uint32_t padding[3];
+    glm::vec4 fractions;
+};
+static_assert(sizeof(StatisticsPush) == 64, "StatisticsPush must match statistics.slang");
+
+// Inverse of encode_ordered in ordered_float.slang
+float decode_ordered(uint32_t u) {
+    return std::bit_cast<float>((u & 0x80000000u) != 0 ? (u & 0x7fffffffu) : ~u);
+}
+
+} // anonymous namespace
+
+StatisticsSummary summarize_statistics(const StatisticsResult& result, uint32_t bin_count) {
+    StatisticsSummary summary;
+    summary.count = result.count;
+    if (result.count > 0) {
+        summary.min = decode_ordered(result.min_encoded);
+        summary.max = decode_ordered(result.max_encoded);
+        summary.mean = result.mean;
+        summary.percentiles = result.percentiles;
+    }
+    bin_count = std::clamp(bin_count, 1u, StatisticsResult::BIN_COUNT);
+    summary.bins.assign(result.bins.begin(), result.bins.begin() + bin_count);
+    return summary;
+}
+
+GpuStatistics::GpuStatistics(const VulkanContext& context)
+    : m_context(&context)
+    , m_device(context.device())
+    , m_descriptor_layout(nullptr)
+    , m_pipeline_layout(nullptr)
+    , m_descriptor_pool(nullptr)
+    , m_command_pool(nullptr)
+    , m_cmd(nullptr)
+    , m_fence(nullptr)
+{}
+
+std::expected<std::unique_ptr<GpuStatistics>, std::string> GpuStatistics::create(
+    const VulkanContext& context,
+    uint32_t slot_count
+) {
+    // Count, min and max are reduced across subgroups before any atomic
+    auto properties = context.physical_device().getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceSubgroupProperties>();
+    const auto& subgroup = properties.get<vk::PhysicalDeviceSubgroupProperties>();
+    if (!(subgroup.supportedStages & vk::ShaderStageFlagBits::eCompute) ||
+        !(subgroup.supportedOperations & vk::SubgroupFeatureFlagBits::eArithmetic)) {
+        return std::unexpected("GPU statistics need subgroup arithmetic in compute shaders");
+    }
+
+    auto statistics = std::unique_ptr<GpuStatistics>(new GpuStatistics(context));
+    if (auto result = statistics->create_pipelines(); !result) {
+        return std::unexpected(result.error());
+    }
+    if (auto result = statistics->create_slots(std::max(slot_count, 1u)); !result) {
+        return std::unexpected(result.error());
+    }
+    if (auto result = statistics->create_commands(); !result) {
+        return std::unexpected(result.error());
+    }
+    return statistics;
+}
+
+GpuStatistics::~GpuStatistics() {
+    wait_idle();
+
+    if (m_fence) m_device.destroyFence(m_fence);
+    if (m_command_pool) m_device.destroyCommandPool(m_command_pool);
+
+    for (auto pipeline : m_pipelines) {
+        if (pipeline) m_device.destroyPipeline(pipeline);
+    }
+    if (m_pipeline_layout) m_device.destroyPipelineLayout(m_pipeline_layout);
+    if (m_descriptor_pool) m_device.destroyDescriptorPool(m_descriptor_pool);
+    if (m_descriptor_layout) m_device.destroyDescriptorSetLayout(m_descriptor_layout);
+
+    for (auto& slot : m_slots) {
+        if (slot.result) m_device.destroyBuffer(slot.result);
+        if (slot.memory) m_device.freeMemory(slot.memory);
+    }
+}
+
+std::expected<void, std::string> GpuStatistics::create_pipelines() {
+    auto trace_scope = StartupTrace::instance().phase("pipeline:GpuStatistics");
+
+    std::array<vk::DescriptorSetLayoutBinding, BINDING_COUNT> bindings;
+    for (uint32_t i = 0; i < BINDING_COUNT; i++) {
+        bindings[i] = vk::DescriptorSetLayoutBinding()
+            .setBinding(i)
+            .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+            .setDescriptorCount(1)
+            .setStageFlags(vk::ShaderStageFlagBits::eCompute);
+    }
+
+	auto layout_res = m_device.createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo().setBindings(bindings));
+	if (layout_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create statistics descriptor layout: {}", to_string(layout_res.result)));
+	}
+	m_descriptor_layout = layout_res.value;
+
+    auto push_constant_range = vk::PushConstantRange()
+        .setStageFlags(vk::ShaderStageFlagBits::eCompute)
+        .setOffset(0)
+        .setSize(sizeof(StatisticsPush));
+
+    auto pipeline_layout_info = vk::PipelineLayoutCreateInfo()
+        .setSetLayouts(m_descriptor_layout)
+        .setPushConstantRanges(push_constant_range);
+
+	auto pipeline_layout_res = m_device.createPipelineLayout(pipeline_layout_info);
+	if (pipeline_layout_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create statistics pipeline layout: {}", to_string(pipeline_layout_res.result)));
+	}
+	m_pipeline_layout = pipeline_layout_res.value;
+
+    for (size_t i = 0; i < KERNEL_SHADERS.size(); i++) {
+        auto shader = Shader::create_shader(m_device, KERNEL_SHADERS[i], "main");
+        if (!shader) {
+            return std::unexpected(std::format("Failed to load {}: {}", KERNEL_SHADERS[i], shader.error()));
+        }
+        if (!std::holds_alternative<ComputeDetails>(shader->get_details())) {
+            return std::unexpected(std::format("{} is not a compute shader", KERNEL_SHADERS[i]));
+        }
+
+        auto pipeline_info = vk::ComputePipelineCreateInfo()
+            .setStage(shader->create_pipeline_shader_stage_create_info())
+            .setLayout(m_pipeline_layout);
+
+		auto pipeline_res = m_device.createComputePipeline(nullptr, pipeline_info);
+		if (pipeline_res.result != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Failed to create {} pipeline: {}", KERNEL_SHADERS[i], to_string(pipeline_res.result)));
+		}
+		m_pipelines[i] = pipeline_res.value;
+        m_shaders.push_back(std::move(*shader));
+    }
+
+    return {};
+}
+
+std::expected<void, std::string> GpuStatistics::create_slots(uint32_t slot_count) {
+    auto pool_size = vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, BINDING_COUNT * slot_count);
+	auto pool_res = m_device.createDescriptorPool(vk::DescriptorPoolCreateInfo().setMaxSets(slot_count).setPoolSizes(pool_size));
+	if (pool_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create statistics descriptor pool: {}", to_string(pool_res.result)));
+	}
+	m_descriptor_pool = pool_res.value;
+
+    m_slots.resize(slot_count);
+    for (auto& slot : m_slots) {
+        auto buffer_info = vk::BufferCreateInfo()
+            .setSize(sizeof(StatisticsResult))
+            .setUsage(vk::BufferUsageFlagBits::eStorageBuffer |
+                      vk::BufferUsageFlagBits::eTransferDst |
+                      vk::BufferUsageFlagBits::eTransferSrc)
+            .setSharingMode(vk::SharingMode::eExclusive);
+
+		auto buffer_res = m_device.createBuffer(buffer_info);
+		if (buffer_res.result != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Failed to create statistics buffer: {}", to_string(buffer_res.result)));
+		}
+		slot.result = buffer_res.value;
+
+        auto requirements = m_device.getBufferMemoryRequirements(slot.result);
+        auto memory_type = m_context->find_memory_type(requirements.memoryTypeBits,
+            vk::MemoryPropertyFlagBits::eDeviceLocal);
+        if (!memory_type) {
+            return std::unexpected("Failed to find device-local memory for statistics");
+        }
+
+		auto alloc_res = m_device.allocateMemory(vk::MemoryAllocateInfo(requirements.size, *memory_type));
+		if (alloc_res.result != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Failed to allocate statistics memory: {}", to_string(alloc_res.result)));
+		}
+		slot.memory = alloc_res.value;
+        auto _ = m_device.bindBufferMemory(slot.result, slot.memory, 0);
+
+		auto set_res = m_device.allocateDescriptorSets(vk::DescriptorSetAllocateInfo(m_descriptor_pool, m_descriptor_layout));
+		if (set_res.result != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Failed to allocate statistics descriptor set: {}", to_string(set_res.result)));
+		}
+		slot.descriptor_set = set_res.value.front();
+
+        // The source (0) is bound by record()
+        auto result_info = vk::DescriptorBufferInfo(slot.result, 0, VK_WHOLE_SIZE);
+        auto write = vk::WriteDescriptorSet().setDstSet(slot.descriptor_set).setDstBinding(1)
+            .setDescriptorType(vk::DescriptorType::eStorageBuffer).setBufferInfo(result_info);
+        m_device.updateDescriptorSets(write, {});
+
+        auto readback = ReadbackBuffer::create(*m_context, sizeof(StatisticsResult));
+        if (!readback) {
+            return std::unexpected(readback.error());
+        }
+        slot.readback = std::move(*readback);
+    }
+
+    return {};
+}
+
+std::expected<void, std::string> GpuStatistics::create_commands() {
+    auto pool_info = vk::CommandPoolCreateInfo()
+        .setFlags(vk::CommandPoolCreateFlagBits::eResetCommandBuffer)
+        .setQueueFamilyIndex(m_context->queue_indices().graphics);
+
+	auto pool_res = m_device.createCommandPool(pool_info);
+	if (pool_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create statistics command pool: {}", to_string(pool_res.result)));
+	}
+	m_command_pool = pool_res.value;
+
+	auto cmd_res = m_device.allocateCommandBuffers(
+		vk::CommandBufferAllocateInfo(m_command_pool, vk::CommandBufferLevel::ePrimary, 1));
+	if (cmd_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to allocate statistics command buffer: {}", to_string(cmd_res.result)));
+	}
+	m_cmd = cmd_res.value.front();
+
+	auto fence_res = m_device.createFence({vk::FenceCreateFlagBits::eSignaled});
+	if (fence_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create statistics fence: {}", to_string(fence_res.result)));
+	}
+	m_fence = fence_res.value;
+
+    return {};
+}
+
+void GpuStatistics::record(
+    vk::CommandBuffer cmd,
+    uint32_t slot_index,
+    vk::Buffer source,
+    uint32_t element_count,
+    const StatisticsSource& spec
+) {
+    auto& slot = m_slots[slot_index];
+    if (source != slot.bound_source) {
+        auto source_info = vk::DescriptorBufferInfo(source, 0, VK_WHOLE_SIZE);
+        auto write = vk::WriteDescriptorSet().setDstSet(slot.descriptor_set).setDstBinding(0)
+            .setDescriptorType(vk::DescriptorType::eStorageBuffer).setBufferInfo(source_info);
+        m_device.updateDescriptorSets(write, {});
+        slot.bound_source = source;
+    }
+    slot.bin_count = std::clamp(spec.bin_count, 1u, StatisticsResult::BIN_COUNT);
+
+    const uint32_t groups = std::clamp((element_count + GROUP_SIZE - 1) / GROUP_SIZE, 1u, MAX_STRIDE_GROUPS);
+    StatisticsPush push{
+        .counts = glm::uvec4(element_count, std::max(spec.stride, 1u), spec.offset, groups * GROUP_SIZE),
+        .mask = spec.mask,
+        .flags = (spec.is_float ? SOURCE_FLOAT : 0u) | (spec.log_scale ? SOURCE_LOG : 0u) |
+                 (spec.skip_zero ? SOURCE_SKIP_ZERO : 0u),
+        .bin_count = slot.bin_count,
+        .range_min = spec.range_min,
+        .range_max = spec.range_max > spec.range_min ? spec.range_max : spec.range_min + 1.0f,
+        .padding = {},
+        .fractions = glm::vec4(spec.percentiles[0], spec.percentiles[1], spec.percentiles[2], spec.percentiles[3])
+    };
+
+    auto barrier = vk::MemoryBarrier()
+        .setSrcAccessMask(vk::AccessFlagBits::eShaderWrite | vk::AccessFlagBits::eTransferWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite |
+                          vk::AccessFlagBits::eTransferRead);
+    const auto stages = vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eTransfer;
+
+    // Earlier readers of the result (e.g. last frame's consumers) finish before it is cleared
+    auto readers = vk::MemoryBarrier()
+        .setSrcAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eTransferRead)
+        .setDstAccessMask(vk::AccessFlagBits::eTransferWrite);
+    cmd.pipelineBarrier(stages, vk::PipelineStageFlagBits::eTransfer, {}, readers, {}, {});
+
+    // Min starts at +max in the ordered encoding, max, count and bins at zero
+    cmd.fillBuffer(slot.result, 0, VK_WHOLE_SIZE, 0u);
+    cmd.fillBuffer(slot.result, offsetof(StatisticsResult, min_encoded), sizeof(uint32_t), 0xffffffffu);
+    cmd.pipelineBarrier(stages, stages, {}, barrier, {}, {});
+
+    cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_pipeline_layout, 0, slot.descriptor_set, {});
+    cmd.pushConstants(m_pipeline_layout, vk::ShaderStageFlagBits::eCompute, 0, sizeof(StatisticsPush), &push);
+
+    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, m_pipelines[static_cast<size_t>(Kernel::Histogram)]);
+    cmd.dispatch(groups, 1, 1);
+    cmd.pipelineBarrier(stages, stages, {}, barrier, {}, {});
+
+    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, m_pipelines[static_cast<size_t>(Kernel::Finalize)]);
+    cmd.dispatch(1, 1, 1);
+    cmd.pipelineBarrier(stages, stages, {}, barrier, {}, {});
+
+    cmd.copyBuffer(slot.result, slot.readback->buffer(), vk::BufferCopy(0, 0, sizeof(StatisticsResult)));
+    auto to_host = vk::MemoryBarrier()
+        .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eHostRead);
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eHost, {}, to_host, {}, {});
+}
+
+std::optional<StatisticsSummary> GpuStatistics::collect(uint32_t slot_index) {
+    auto& slot = m_slots[slot_index];
+    if (slot.bin_count == 0) {
+        return std::nullopt;
+    }
+
+    slot.readback->invalidate();
+    StatisticsResult result;
+    std::memcpy(&result, slot.readback->data(), sizeof(StatisticsResult));
+    slot.latest = summarize_statistics(result, slot.bin_count);
+    return slot.latest;
+}
+
+std::expected<void, std::string> GpuStatistics::submit(std::span<const Job> jobs) {
+    wait_idle();
+    m_pending = false;
+    if (jobs.empty()) {
+        return {};
+    }
+
+    auto cmd = m_cmd;
+    auto _ = cmd.reset();
+    auto _ = cmd.begin(vk::CommandBufferBeginInfo().setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+    m_submitted_slots.clear();
+    for (const auto& job : jobs) {
+        record(cmd, job.slot, job.source, job.element_count, job.spec);
+        m_submitted_slots.push_back(job.slot);
+    }
+    auto _ = cmd.end();
+
+    auto _ = m_device.resetFences(m_fence);
+	auto submit_res = m_context->graphics_queue().submit(vk::SubmitInfo().setCommandBuffers(cmd), m_fence);
+	if (submit_res != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to submit statistics: {}", to_string(submit_res)));
+	}
+    m_pending = true;
+    return {};
+}
+
+bool GpuStatistics::poll() {
+    if (!m_pending || m_device.getFenceStatus(m_fence) != vk::Result::eSuccess) {
+        return false;
+    }
+    m_pending = false;
+    for (uint32_t slot : m_submitted_slots) {
+        collect(slot);
+    }
+    return true;
+}
+
+void GpuStatistics::wait_idle() {
+    if (m_fence) {
+        auto _ = m_device.waitForFences(m_fence, true, UINT64_MAX);
+    }
+}
+
+} // namespace ifs
@@ -0,0 +1,314 @@
+#include <ifs/HeadlessSession.hpp>
+#include <ifs/backends/AffineIFS.hpp>
+#include <ifs/backends/CustomIFS.hpp>
+#include <ifs/backends/FlameIFS.hpp>
+#include <ifs/backends/Sierpinski2D.hpp>
+#include <ifs/frontends/ParticleRenderer.hpp>
+#include <ifs/frontends/SphereRenderer.hpp>
+#include <ifs/Logger.hpp>
+#include <format>
+
+namespace ifs {
+
+HeadlessSession::HeadlessSession()
+    : m_command_pool(nullptr)
+    , m_command_buffer(nullptr)
+    , m_fence(nullptr)
+    , m_bound_buffer(nullptr)
+{}
+
+std::expected<std::unique_ptr<HeadlessSession>, std::string> HeadlessSession::create(const HeadlessConfig& config) {
+    auto session = std::unique_ptr<HeadlessSession>(new HeadlessSession());
+    if (auto result = session->initialize(config); !result) {
+        return std::unexpected(result.error());
+    }
+    return session;
+}
+
+HeadlessSession::~HeadlessSession() {
+    if (!m_context) {
+        return;
+    }
+    auto device = m_context->device();
+    auto _ = device.waitIdle();
+
+    if (m_fence) device.destroyFence(m_fence);
+    if (m_command_pool) device.destroyCommandPool(m_command_pool);
+
+    m_particle_readback.reset();
+    m_frontend.reset();
+    m_backend.reset();
+    m_target.reset();
+}
+
+std::expected<void, std::string> HeadlessSession::initialize(const HeadlessConfig& config) {
+    try {
+        m_context = std::make_unique<VulkanContext>("IFS Headless");
+    } catch (const std::exception& e) {
+        return std::unexpected(std::format("Failed to create Vulkan context: {}", e.what()));
+    }
+    auto device = m_context->device();
+    const vk::Extent2D extent{config.width, config.height};
+
+    auto target = OffscreenTarget::create(*m_context, extent, 1);
+    if (!target) {
+        return std::unexpected(target.error());
+    }
+    m_target = std::move(*target);
+
+    auto backend = [&]() -> std::expected<std::unique_ptr<IFSBackend>, std::string> {
+        if (config.backend == "custom") return CustomIFS::create(*m_context, device);
+        if (config.backend == "sierpinski") return Sierpinski2D::create(*m_context, device);
+        if (config.backend == "affine") return AffineIFS::create(*m_context, device);
+        if (config.backend == "flame") return FlameIFS::create(*m_context, device);
+        return std::unexpected(std::format("Unknown backend '{}' (expected custom, sierpinski, affine or flame)", config.backend));
+    }();
+    if (!backend) {
+        return std::unexpected(backend.error());
+    }
+    m_backend = std::move(*backend);
+
+    auto frontend = [&]() -> std::expected<std::unique_ptr<IFSFrontend>, std::string> {
+        if (config.frontend == "points") {
+            return ParticleRenderer::create(*m_context, device, m_target->render_pass(), extent);
+        }
+        if (config.frontend == "spheres") {
+            return SphereRenderer::create(*m_context, device, m_target->render_pass(), extent);
+        }
+        return std::unexpected(std::format("Unknown frontend '{}' (expected points or spheres)", config.frontend));
+    }();
+    if (!frontend) {
+        return std::unexpected(frontend.error());
+    }
+    m_frontend = std::move(*frontend);
+    m_camera.handle_resize(extent.width, extent.height);
+
+    auto pool_info = vk::CommandPoolCreateInfo()
+        .setFlags(vk::CommandPoolCreateFlagBits::eResetCommandBuffer)
+        .setQueueFamilyIndex(m_context->queue_indices().graphics);
+
+	auto pool_res = device.createCommandPool(pool_info);
+	if (pool_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create headless command pool: {}", to_string(pool_res.result)));
+	}
+	m_command_pool = pool_res.value;
+
+    auto alloc_info = vk::CommandBufferAllocateInfo()
+        .setCommandPool(m_command_pool)
+        .setLevel(vk::CommandBufferLevel::ePrimary)
+        .setCommandBufferCount(1);
+
+	auto cmd_res = device.allocateCommandBuffers(alloc_info);
+	if (cmd_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to allocate headless command buffer: {}", to_string(cmd_res.result)));
+	}
+	m_command_buffer = cmd_res.value.front();
+
+	auto fence_res = device.createFence({});
+	if (fence_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create headless fence: {}", to_string(fence_res.result)));
+	}
+	m_fence = fence_res.value;
+
+    Logger::instance().info("Headless session ready: backend '{}', frontend '{}', {}x{}",
+        m_backend->name(), m_frontend->name(), extent.width, extent.height);
+    return {};
+}
+
+std::vector<UICallback> HeadlessSession::parameters() {
+    auto callbacks = m_backend->get_ui_callbacks();
+    for (auto& callback : m_frontend->get_ui_callbacks()) {
+        callbacks.push_back(std::move(callback));
+    }
+    return callbacks;
+}
+
+std::expected<void, std::string> HeadlessSession::set_parameter(std::string_view name, float value) {
+    auto callbacks = parameters();
+    const auto* callback = find_ui_callback(callbacks, name);
+    if (!callback) {
+        return std::unexpected(std::format("No parameter named '{}'", name));
+    }
+    callback->set_value(value);
+    return {};
+}
+
+std::expected<float, std::string> HeadlessSession::parameter(std::string_view name) {
+    auto callbacks = parameters();
+    const auto* callback = find_ui_callback(callbacks, name);
+    if (!callback) {
+        return std::unexpected(std::format("No parameter named '{}'", name));
+    }
+    return callback->value();
+}
+
+std::expected<void, std::string> HeadlessSession::compute(const IFSParameters& params) {
+    // Warm starts read the buffer the graphics queue last used; hand it back to compute first
+    const auto& queues = m_context->queue_indices();
+    if (m_computed && queues.has_dedicated_compute() && m_backend->reads_particle_buffer()) {
+        auto cmd = begin_commands();
+        if (!cmd) {
+            return std::unexpected(cmd.error());
+        }
+        m_backend->return_buffer_ownership(*cmd, m_backend->get_particle_buffer(), queues.graphics, queues.compute);
+        if (auto result = submit_and_wait(*cmd); !result) {
+            return std::unexpected(result.error());
+        }
+    }
+
+    m_backend->compute(nullptr, 0, params);
+    m_backend->wait_compute_complete();
+    m_computed = true;
+    m_needs_acquire = m_context->queue_indices().has_dedicated_compute();
+
+    // Setting "Particle Count" reallocates the backend's buffer
+    if (auto buffer = m_backend->get_particle_buffer(); buffer != m_bound_buffer) {
+        m_frontend->update_particle_buffer(buffer);
+        m_bound_buffer = buffer;
+    }
+    return {};
+}
+
+std::expected<vk::CommandBuffer, std::string> HeadlessSession::begin_commands() {
+    auto cmd = m_command_buffer;
+    auto _ = cmd.reset();
+    auto _ = cmd.begin(vk::CommandBufferBeginInfo().setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+
+    // Matches the backend's release barrier; the copy, the frontend's pre-pass and the draw read the buffer afterwards
+    if (m_needs_acquire) {
+        const auto& queues = m_context->queue_indices();
+        auto barrier = vk::BufferMemoryBarrier()
+            .setSrcAccessMask({})
+            .setDstAccessMask(vk::AccessFlagBits::eTransferRead |
+                              vk::AccessFlagBits::eVertexAttributeRead |
+                              vk::AccessFlagBits::eShaderRead)
+            .setSrcQueueFamilyIndex(queues.compute)
+            .setDstQueueFamilyIndex(queues.graphics)
+            .setBuffer(m_backend->get_particle_buffer())
+            .setOffset(0)
+            .setSize(VK_WHOLE_SIZE);
+
+        cmd.pipelineBarrier(
+            vk::PipelineStageFlagBits::eTopOfPipe,
+            vk::PipelineStageFlagBits::eTransfer |
+                vk::PipelineStageFlagBits::eVertexInput |
+                vk::PipelineStageFlagBits::eVertexShader |
+                vk::PipelineStageFlagBits::eComputeShader,
+            {},
+            {},
+            barrier,
+            {}
+        );
+        m_needs_acquire = false;
+    }
+    return cmd;
+}
+
+std::expected<void, std::string> HeadlessSession::submit_and_wait(vk::CommandBuffer cmd) {
+    auto _ = cmd.end();
+    auto device = m_context->device();
+
+	auto submit_res = m_context->graphics_queue().submit(vk::SubmitInfo().setCommandBuffers(cmd), m_fence);
+	if (submit_res != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to submit headless commands: {}", to_string(submit_res)));
+	}
+
+	auto wait_res = device.waitForFences(m_fence, true, UINT64_MAX);
+	if (wait_res != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to wait for headless commands: {}", to_string(wait_res)));
+	}
+    auto _ = device.resetFences(m_fence);
+    return {};
+}
+
+std::expected<ParticleReadback, std::string> HeadlessSession::read_particles() {
+    if (!m_computed) {
+        return std::unexpected("compute() must run before read_particles()");
+    }
+
+    const uint32_t count = m_backend->get_particle_count();
+    const vk::DeviceSize size = static_cast<vk::DeviceSize>(count) * sizeof(Particle);
+
+    // Grow only; views into the previous buffer keep it alive through their shared_ptr
+    if (!m_particle_readback || m_particle_readback->size() < size) {
+        auto readback = ReadbackBuffer::create(*m_context, size);
+        if (!readback) {
+            return std::unexpected(readback.error());
+        }
+        m_particle_readback = std::move(*readback);
+    }
+
+    auto cmd = begin_commands();
+    if (!cmd) {
+        return std::unexpected(cmd.error());
+    }
+    cmd->copyBuffer(m_backend->get_particle_buffer(), m_particle_readback->buffer(), vk::BufferCopy(0, 0, size));
+
+    auto to_host = vk::MemoryBarrier()
+        .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eHostRead);
+    cmd->pipelineBarrier(
+        vk::PipelineStageFlagBits::eTransfer,
+        vk::PipelineStageFlagBits::eHost,
+        {},
+        to_host,
+        {},
+        {}
+    );
+
+    if (auto result = submit_and_wait(*cmd); !result) {
+        return std::unexpected(result.error());
+    }
+    m_particle_readback->invalidate();
+
+    return ParticleReadback{
+        .owner = m_particle_readback,
+        .particles = static_cast<const Particle*>(m_particle_readback->data()),
+        .count = count
+    };
+}
+
+std::expected<ImageReadback, std::string> HeadlessSession::render(const SweepCamera& camera) {
+    if (!m_computed) {
+        return std::unexpected("compute() must run before render()");
+    }
+
+    const auto& extent = m_target->extent();
+    const auto clear_values = m_target->clear_values();
+    camera.apply(m_camera);
+
+    auto cmd = begin_commands();
+    if (!cmd) {
+        return std::unexpected(cmd.error());
+    }
+
+    m_frontend->record_pre_pass(*cmd, m_backend->get_particle_buffer(), m_backend->get_particle_count(), m_camera, extent);
+
+    auto render_pass_begin = vk::RenderPassBeginInfo()
+        .setRenderPass(m_target->render_pass())
+        .setFramebuffer(m_target->framebuffer())
+        .setRenderArea(vk::Rect2D({0, 0}, extent))
+        .setClearValues(clear_values);
+
+    cmd->beginRenderPass(render_pass_begin, vk::SubpassContents::eInline);
+    m_frontend->render(*cmd, m_backend->get_particle_buffer(), m_backend->get_particle_count(), m_camera, &extent);
+    cmd->endRenderPass();
+    m_target->record_readback(*cmd, 0);
+
+    if (auto result = submit_and_wait(*cmd); !result) {
+        return std::unexpected(result.error());
+    }
+
+    return ImageReadback{
+        .pixels = m_target->pixels(0),
+        .width = extent.width,
+        .height = extent.height
+    };
+}
+
+} // namespace ifs
@@ -1,11 +1,19 @@
 #include <ifs/IFSController.hpp>
 #include <ifs/Logger.hpp>
+#include <ifs/StartupTrace.hpp>
+#include <ifs/backends/AffineIFS.hpp>
 #include <imgui.h>
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_vulkan.h>
+#include <algorithm>
+#include <cfloat>
 #include <chrono>
+#include <cmath>
+#include <fstream>
+#include <future>
 #include <random>
 #include <format>
+#include <sstream>
 
 namespace ifs {
 
@@ -13,6 +21,7 @@ namespace ifs {
 void glfw_key_callback(GLFWwindow* window, int key, [[maybe_unused]] int scancode, int action,[[maybe_unused]]  int mods) {
     auto* controller = static_cast<IFSController*>(glfwGetWindowUserPointer(window));
     if (!controller) return;
+    controller->m_latency.input(LatencyTracker::Clock::now());
 
     if (action == GLFW_PRESS) {
         controller->m_keys_pressed[key] = true;
@@ -21,6 +30,11 @@ void glfw_key_callback(GLFWwindow* window, int key, [[maybe_unused]] int scancod
         if (key == GLFW_KEY_TAB) {
             controller->m_mouse_captured = !controller->m_mouse_captured;
             if (controller->m_mouse_captured) {
+                // The captured mouse orbits the view it was over
+                double x = 0.0;
+                double y = 0.0;
+                glfwGetCursorPos(window, &x, &y);
+                controller->m_input_camera = controller->camera_at(x, y);
                 glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
                 controller->m_first_mouse = true;  // Reset to avoid jump
             } else {
@@ -35,6 +49,7 @@ void glfw_key_callback(GLFWwindow* window, int key, [[maybe_unused]] int scancod
 void glfw_mouse_callback(GLFWwindow* window, double xpos, double ypos) {
     auto* controller = static_cast<IFSController*>(glfwGetWindowUserPointer(window));
     if (!controller || !controller->m_camera) return;
+    controller->m_latency.input(LatencyTracker::Clock::now());  // Also moves the ImGui hover
 
     if (!controller->m_mouse_captured) return;
 
@@ -50,15 +65,26 @@ void glfw_mouse_callback(GLFWwindow* window, double xpos, double ypos) {
     controller->m_last_mouse_x = xpos;
     controller->m_last_mouse_y = ypos;
 
-    controller->m_camera->handle_mouse_movement(xoffset, yoffset);
+    controller->m_input_camera->handle_mouse_movement(xoffset, yoffset);
 }
 
 void glfw_scroll_callback(GLFWwindow* window, double xoffset, double yoffset) {
     (void)xoffset;  // Unused
     auto* controller = static_cast<IFSController*>(glfwGetWindowUserPointer(window));
     if (!controller || !controller->m_camera) return;
+    controller->m_latency.input(LatencyTracker::Clock::now());
 
-    controller->m_camera->handle_mouse_scroll(yoffset);
+    double x = 0.0;
+    double y = 0.0;
+    glfwGetCursorPos(window, &x, &y);
+    controller->camera_at(x, y)->handle_mouse_scroll(yoffset);
+}
+
+void glfw_mouse_button_callback(GLFWwindow* window, [[maybe_unused]] int button, [[maybe_unused]] int action, [[maybe_unused]] int mods) {
+    // Buttons only drive ImGui (which chains to this callback); they count as input for the latency
+    auto* controller = static_cast<IFSController*>(glfwGetWindowUserPointer(window));
+    if (!controller) return;
+    controller->m_latency.input(LatencyTracker::Clock::now());
 }
 
 IFSController::IFSController(const IFSConfig& config)
@@ -92,31 +118,86 @@ std::expected<std::unique_ptr<IFSController>, std::string> IFSController::create
 
 std::expected<void, std::string> IFSController::initialize() {
     Logger::instance().info("Initializing IFS Controller...");
+    auto& trace = StartupTrace::instance();
+
+    // The Slang front end doesn't touch Vulkan or GLFW, so shader modules are
+    // parsed while the context and swapchain are built. Nothing on this thread
+    // compiles shaders until the preload is joined below.
+    auto shader_preload = std::async(std::launch::async, [modules = m_config.preload_shaders] {
+        auto _ = StartupTrace::instance().phase("shader_preload");
+        Shader::preload_modules(modules);
+    });
 
     // Create Vulkan context
-    try {
-        m_context = std::make_unique<VulkanContext>("IFS Controller");
-    } catch (const std::exception& e) {
-        return std::unexpected(std::format("Failed to create Vulkan context: {}", e.what()));
+    {
+        auto _ = trace.phase("vulkan_context");
+        try {
+            m_context = std::make_unique<VulkanContext>("IFS Controller");
+        } catch (const std::exception& e) {
+            return std::unexpected(std::format("Failed to create Vulkan context: {}", e.what()));
+        }
+    }
+
+    // Warm starts read the particle buffer on the compute queue after the graphics queue rendered it
+    {
+        auto device = m_context->device();
+        auto pool_info = vk::CommandPoolCreateInfo()
+            .setQueueFamilyIndex(m_context->queue_indices().graphics)
+            .setFlags(vk::CommandPoolCreateFlagBits::eResetCommandBuffer);
+
+		auto pool_res = device.createCommandPool(pool_info);
+		if (pool_res.result != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Failed to create ownership command pool: {}", to_string(pool_res.result)));
+		}
+		m_ownership_pool = pool_res.value;
+
+		auto cmd_res = device.allocateCommandBuffers(vk::CommandBufferAllocateInfo(m_ownership_pool, vk::CommandBufferLevel::ePrimary, 1));
+		if (cmd_res.result != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Failed to allocate ownership command buffer: {}", to_string(cmd_res.result)));
+		}
+		m_ownership_command_buffer = cmd_res.value[0];
+
+		auto fence_res = device.createFence({});
+		if (fence_res.result != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Failed to create ownership fence: {}", to_string(fence_res.result)));
+		}
+		m_ownership_fence = fence_res.value;
+    }
+
+    // Must precede the backend, whose particle buffers are then allocated exportable
+    if (m_config.share_socket) {
+        if (auto share = ParticleShareServer::create(*m_context, *m_config.share_socket)) {
+            m_particle_share = std::move(*share);
+            m_context->set_export_particle_buffers(true);
+        } else {
+            Logger::instance().warn("Particle sharing disabled: {}", share.error());
+        }
     }
 
     // Create window
-    auto window_result = Window::create(
-        *m_context,
-        m_config.window_width,
-        m_config.window_height,
-        m_config.window_title
-    );
-    if (!window_result) {
-        return std::unexpected(std::format("Failed to create window: {}", window_result.error()));
+    {
+        auto _ = trace.phase("window_swapchain");
+        auto window_result = Window::create(
+            *m_context,
+            m_config.window_width,
+            m_config.window_height,
+            m_config.window_title
+        );
+        if (!window_result) {
+            return std::unexpected(std::format("Failed to create window: {}", window_result.error()));
+        }
+        m_window = std::make_unique<Window>(std::move(window_result.value()));
     }
-    m_window = std::make_unique<Window>(std::move(window_result.value()));
 
     // Note: Particle buffer is now owned by the backend
     // It will be created when the backend is initialized
 
     // Create 3D camera
     m_camera = std::make_unique<Camera3D>(m_config.window_width, m_config.window_height);
+    m_input_camera = m_camera.get();
 
     // Set up input handling
     m_mouse_captured = false;  // Start with mouse not captured
@@ -124,13 +205,32 @@ std::expected<void, std::string> IFSController::initialize() {
     glfwSetKeyCallback(m_window->get_window_handle(), glfw_key_callback);
     glfwSetCursorPosCallback(m_window->get_window_handle(), glfw_mouse_callback);
     glfwSetScrollCallback(m_window->get_window_handle(), glfw_scroll_callback);
+    glfwSetMouseButtonCallback(m_window->get_window_handle(), glfw_mouse_button_callback);
 
     // Enable mouse capture at startup
     glfwSetInputMode(m_window->get_window_handle(), GLFW_CURSOR, GLFW_CURSOR_NORMAL);
 
+    if (m_config.low_latency) {
+        set_low_latency(true);
+    }
+
     // Setup ImGui
-    if (auto result = setup_imgui(); !result) {
-        return std::unexpected(result.error());
+    {
+        auto _ = trace.phase("imgui_setup");
+        if (auto result = setup_imgui(); !result) {
+            return std::unexpected(result.error());
+        }
+    }
+
+    {
+        auto _ = trace.phase("shader_preload_join");
+        shader_preload.get();
+    }
+
+    if (m_config.metrics_export) {
+        m_metrics_exporter = std::make_unique<MetricsExporter>(*m_config.metrics_export);
+        Logger::instance().info("Writing metrics to {} every {} s",
+            m_config.metrics_export->path.string(), m_config.metrics_export->interval_seconds);
     }
 
     Logger::instance().info("IFS Controller initialized successfully");
@@ -206,33 +306,112 @@ void IFSController::set_frontend(std::unique_ptr<IFSFrontend> frontend) {
     }
 }
 
+std::expected<void, std::string> IFSController::add_view(std::unique_ptr<IFSFrontend> frontend) {
+    if (view_count() >= MAX_FRAME_VIEWS) {
+        return std::unexpected(std::format("At most {} views", MAX_FRAME_VIEWS));
+    }
+    if (!frontend) {
+        if (!m_frontend) {
+            return std::unexpected("Frontend not set - call set_frontend() before add_view()");
+        }
+        const auto shared = 1 + std::ranges::count_if(m_split_views, [](const SplitView& view) { return !view.frontend; });
+        if (static_cast<uint32_t>(shared) >= m_frontend->max_views()) {
+            return std::unexpected(std::format("{} draws at most {} views", m_frontend->name(), m_frontend->max_views()));
+        }
+    } else if (m_window) {
+        frontend->handle_swapchain_recreation(m_window->image_count());
+        if (m_backend && m_backend->get_particle_buffer()) {
+            frontend->update_particle_buffer(m_backend->get_particle_buffer());
+        }
+    }
+
+    m_split_views.push_back(SplitView{
+        .camera = std::make_unique<Camera3D>(*m_camera),
+        .frontend = std::move(frontend)
+    });
+    return {};
+}
+
+void IFSController::clear_views() {
+    if (m_split_views.empty()) {
+        return;
+    }
+    // The views' frontends may still be drawing
+    auto _ = m_context->device().waitIdle();
+    m_split_views.clear();
+    m_input_camera = m_camera.get();
+    m_camera->handle_resize(m_window->extent().width, m_window->extent().height);
+}
+
+Camera3D* IFSController::camera_at(double x, [[maybe_unused]] double y) const {
+    int width = 0;
+    int height = 0;
+    glfwGetWindowSize(m_window->get_window_handle(), &width, &height);
+    if (m_split_views.empty() || width <= 0) {
+        return m_camera.get();
+    }
+    const auto view = static_cast<size_t>(std::clamp(x / width, 0.0, 1.0) * static_cast<double>(view_count()));
+    return view == 0 ? m_camera.get() : m_split_views[std::min(view, m_split_views.size()) - 1].camera.get();
+}
+
+std::vector<vk::Rect2D> IFSController::view_areas(const vk::Extent2D& extent) const {
+    // Equal columns; the last one takes the remainder
+    const auto count = static_cast<uint32_t>(view_count());
+    const uint32_t width = extent.width / count;
+    std::vector<vk::Rect2D> areas;
+    for (uint32_t view = 0; view < count; view++) {
+        const uint32_t x = view * width;
+        areas.emplace_back(
+            vk::Offset2D(static_cast<int32_t>(x), 0),
+            vk::Extent2D(view + 1 == count ? extent.width - x : width, extent.height));
+    }
+    return areas;
+}
+
+std::vector<IFSFrontend*> IFSController::frontends() const {
+    std::vector<IFSFrontend*> result = {m_frontend.get()};
+    for (const auto& view : m_split_views) {
+        if (view.frontend) {
+            result.push_back(view.frontend.get());
+        }
+    }
+    return result;
+}
+
 void IFSController::handle_input(float delta_time) {
     if (!m_camera) return;
 
+    // Keys move the captured view, else the one under the cursor
+    double x = 0.0;
+    double y = 0.0;
+    glfwGetCursorPos(m_window->get_window_handle(), &x, &y);
+    auto* camera = m_mouse_captured ? m_input_camera : camera_at(x, y);
+
     // WASD moves the focus/target point
     if (m_keys_pressed[GLFW_KEY_W]) {
-        m_camera->move_target_forward(delta_time, -1.0f);
+        camera->move_target_forward(delta_time, -1.0f);
     }
     if (m_keys_pressed[GLFW_KEY_S]) {
-        m_camera->move_target_forward(delta_time, 1.0f);
+        camera->move_target_forward(delta_time, 1.0f);
     }
     if (m_keys_pressed[GLFW_KEY_A]) {
-        m_camera->move_target_right(delta_time, 1.0f);
+        camera->move_target_right(delta_time, 1.0f);
     }
     if (m_keys_pressed[GLFW_KEY_D]) {
-        m_camera->move_target_right(delta_time, -1.0f);
+        camera->move_target_right(delta_time, -1.0f);
     }
 
     // QE for up/down movement of target
     if (m_keys_pressed[GLFW_KEY_Q]) {
-        m_camera->move_target_up(delta_time, 1.0f);
+        camera->move_target_up(delta_time, 1.0f);
     }
     if (m_keys_pressed[GLFW_KEY_E]) {
-        m_camera->move_target_up(delta_time, -1.0f);
+        camera->move_target_up(delta_time, -1.0f);
     }
 }
 
-void IFSController::render_ui_callbacks(const std::vector<UICallback>& callbacks) {
+bool IFSController::render_ui_callbacks(const std::vector<UICallback>& callbacks) {
+    bool changed = false;
     for (const auto& callback : callbacks) {
         switch (callback.get_callback_type()) {
             case CallbackType::Continuous: {
@@ -241,6 +420,7 @@ void IFSController::render_ui_callbacks(const std::vector<UICallback>& callbacks
                     int flags = cb->logarithmic ? ImGuiSliderFlags_Logarithmic : 0;
                     if (ImGui::SliderFloat(callback.field_name.c_str(), &value, cb->min, cb->max, "%.3f", flags)) {
                         cb->setter(value);
+                        changed = true;
                     }
                 }
                 break;
@@ -250,6 +430,7 @@ void IFSController::render_ui_callbacks(const std::vector<UICallback>& callbacks
                     int value = cb->getter();
                     if (ImGui::SliderInt(callback.field_name.c_str(), &value, cb->min, cb->max)) {
                         cb->setter(value);
+                        changed = true;
                     }
                 }
                 break;
@@ -259,12 +440,14 @@ void IFSController::render_ui_callbacks(const std::vector<UICallback>& callbacks
                     bool value = cb->getter();
                     if (ImGui::Checkbox(callback.field_name.c_str(), &value)) {
                         cb->setter(value);
+                        changed = true;
                     }
                 }
                 break;
             }
         }
     }
+    return changed;
 }
 
 void IFSController::render_ui() {
@@ -288,6 +471,41 @@ void IFSController::render_ui() {
         ImGui::TextDisabled("Particles: (backend not set)");
     }
 
+    if (m_particle_share) {
+        ImGui::Text("Sharing on %s: %zu clients, generation %llu",
+            m_particle_share->socket_path().string().c_str(), m_particle_share->client_count(),
+            static_cast<unsigned long long>(m_particle_share->generation()));
+    }
+
+    if (auto* stats = m_backend ? m_backend->compute_stats() : nullptr; stats && stats->chunk_count > 0) {
+        ImGui::Text("Compute: %.3f ms (%u chunks on %u queues)", stats->gpu_ms, stats->chunk_count, stats->queue_count);
+        for (size_t i = 0; i < stats->queue_busy_ms.size(); i++) {
+            ImGui::Text("  Queue %zu busy: %.3f ms", i, stats->queue_busy_ms[i]);
+        }
+    }
+
+    if (auto* draw_stats = m_frontend ? m_frontend->pipeline_statistics() : nullptr) {
+        ImGui::Text("Draw: %llu primitives, %llu vertex, %llu fragment invocations",
+            static_cast<unsigned long long>(draw_stats->input_assembly_primitives),
+            static_cast<unsigned long long>(draw_stats->vertex_invocations),
+            static_cast<unsigned long long>(draw_stats->fragment_invocations));
+        ImGui::Text("  Clipped: %.1f%%  Fragments/pixel: %.2f",
+            draw_stats->clipped_fraction() * 100.0, draw_stats->fragments_per_pixel());
+    }
+
+    if (auto* occlusion = m_frontend ? m_frontend->occlusion_statistics() : nullptr; occlusion && occlusion->instance_count > 0) {
+        ImGui::Text("Occlusion: drew %u of %u (%u + %u re-tested), %u occluded, %u outside",
+            occlusion->drawn(), occlusion->instance_count, occlusion->first_phase, occlusion->second_phase,
+            occlusion->occluded, occlusion->outside());
+        if (occlusion->lod_count > 1) {
+            std::string lods;
+            for (uint32_t lod = 0; lod < occlusion->lod_count; lod++) {
+                lods += std::format(" {}", occlusion->lod_instances[lod]);
+            }
+            ImGui::Text("  Per LOD (points first):%s", lods.c_str());
+        }
+    }
+
     ImGui::Separator();
     ImGui::Text("Camera Controls:");
     ImGui::Text("  TAB: Toggle mouse capture");
@@ -306,6 +524,21 @@ void IFSController::render_ui() {
         ImGui::Text("Azimuth: %.1f  Elevation: %.1f", m_camera->azimuth(), m_camera->elevation());
         ImGui::Text("Move Speed: %.2f", m_camera->move_speed());
         ImGui::Text("Mouse: %s", m_mouse_captured ? "Captured" : "Free");
+
+        // Split screen: more cameras on the same particles (the panels edit the left view)
+        ImGui::Text("Views: %zu", view_count());
+        ImGui::SameLine();
+        if (ImGui::SmallButton("Split")) {
+            if (auto result = add_view(); !result) {
+                Logger::instance().warn("Cannot split: {}", result.error());
+            }
+        }
+        if (!m_split_views.empty()) {
+            ImGui::SameLine();
+            if (ImGui::SmallButton("Single View")) {
+                clear_views();
+            }
+        }
     }
 
     ImGui::Separator();
@@ -326,9 +559,10 @@ void IFSController::render_ui() {
         ImGui::Text("Backend Parameters:");
         auto backend_callbacks = m_backend->get_ui_callbacks();
         if (!backend_callbacks.empty()) {
-            render_ui_callbacks(backend_callbacks);
-            m_needs_recompute = true;  // Backend parameters might affect computation
-            m_needs_buffer_rebind = true;  // Buffer might have changed (e.g., particle count)
+            if (render_ui_callbacks(backend_callbacks)) {
+                m_needs_recompute = true;  // Backend parameters might affect computation
+                m_needs_buffer_rebind = true;  // Buffer might have changed (e.g., particle count)
+            }
         } else {
             ImGui::TextDisabled("(No backend parameters)");
         }
@@ -353,12 +587,847 @@ void IFSController::render_ui() {
         if (m_camera) {
             m_camera->reset();
         }
+        // The reset also drops the deep-zoom frame
+        if (auto* affine = dynamic_cast<AffineIFS*>(m_backend.get()); affine && m_deep_zoom) {
+            m_deep_zoom = false;
+            affine->set_deep_zoom(std::nullopt);
+            m_needs_recompute = true;
+        }
     }
 
     ImGui::Text("FPS: %.1f", ImGui::GetIO().Framerate);
+
+    render_animation_ui();
+    render_camera_path_ui();
+    render_deep_zoom_ui();
+    render_inspect_ui();
+    render_latency_ui();
+    render_metrics_ui();
     ImGui::End();
 }
 
+void IFSController::render_animation_ui() {
+    auto* affine = dynamic_cast<AffineIFS*>(m_backend.get());
+    if (!affine || !ImGui::CollapsingHeader("Animation")) {
+        return;
+    }
+
+    ImGui::Text("Keyframes: %zu, duration %.2f s", m_timeline.keyframes().size(), m_timeline.duration());
+    if (ImGui::Button("Add keyframe")) {
+        // Appended 2 s after the last one, holding the current maps, camera and scale
+        m_timeline.add({
+            .time = m_timeline.empty() ? 0.0f : m_timeline.duration() + 2.0f,
+            .frame = {
+                .ifs = affine->definition(),
+                .camera = CameraPose::from(*m_camera),
+                .scale = m_ifs_params.scale
+            }
+        });
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Clear")) {
+        m_timeline.clear();
+        m_animation_playing = false;
+        m_animation_time = 0.0f;
+    }
+
+    ImGui::BeginDisabled(m_timeline.keyframes().size() < 2);
+    if (ImGui::Button(m_animation_playing ? "Pause" : "Play")) {
+        m_animation_playing = !m_animation_playing;
+        if (m_animation_playing && m_animation_time >= m_timeline.duration()) {
+            m_animation_time = m_timeline.keyframes().front().time;
+        }
+    }
+    ImGui::SameLine();
+    ImGui::Checkbox("Loop", &m_animation_loop);
+    if (ImGui::SliderFloat("Time", &m_animation_time, 0.0f, m_timeline.duration(), "%.2f s")) {
+        advance_animation(0.0f);  // Scrubbing shows the frame even while paused
+    }
+    ImGui::EndDisabled();
+    ImGui::SliderInt("Warm-start iterations", &m_warm_iterations, 1, 64);
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Iterations per frame, continuing the previous frame's orbits");
+    }
+
+    ImGui::InputText("File", m_timeline_path.data(), m_timeline_path.size());
+    if (ImGui::Button("Load")) {
+        std::ifstream file(m_timeline_path.data());
+        std::stringstream text;
+        text << file.rdbuf();
+        auto timeline = parse_timeline(text.str());
+        if (!file) {
+            m_animation_status = "Load failed: could not read file";
+        } else if (timeline) {
+            m_timeline = std::move(*timeline);
+            m_animation_time = 0.0f;
+            m_animation_status = std::format("Loaded {} keyframes", m_timeline.keyframes().size());
+        } else {
+            m_animation_status = std::format("Load failed: {}", timeline.error());
+        }
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Save")) {
+        std::ofstream file(m_timeline_path.data());
+        file << m_timeline.serialize();
+        m_animation_status = file ? "Saved" : "Save failed: could not write file";
+    }
+    if (!m_animation_status.empty()) {
+        ImGui::TextDisabled("%s", m_animation_status.c_str());
+    }
+}
+
+void IFSController::start_path_recording(std::filesystem::path path) {
+    const auto text = path.string();
+    m_path_file.fill('\0');
+    std::copy_n(text.begin(), std::min(text.size(), m_path_file.size() - 1), m_path_file.begin());
+    m_path_recorder = {};
+    m_path_record_start = std::chrono::steady_clock::now();
+    m_path_recording = true;
+}
+
+void IFSController::start_path_replay(CameraPath path, std::filesystem::path timings, bool close_when_done) {
+    if (m_path_recording) {
+        stop_path_recording();
+    }
+    m_path_replay_frame = 0;
+    m_path_timings.clear();
+    m_path_timings.reserve(path.frames().size());
+    m_path_timings_file = std::move(timings);
+    m_path_close_when_done = close_when_done;
+    m_path_replay = path.empty() ? std::nullopt : std::optional(std::move(path));
+}
+
+void IFSController::stop_path_recording() {
+    m_path_recording = false;
+    const auto path = m_path_recorder.take();
+    std::ofstream file(m_path_file.data());
+    file << path.serialize();
+    m_path_status = file ? std::format("Recorded {} frames ({:.1f} s)", path.frames().size(), path.duration())
+                         : std::format("Could not write '{}'", m_path_file.data());
+    Logger::instance().info("Camera path: {}", m_path_status);
+}
+
+float IFSController::apply_replay_frame() {
+    const auto& frames = m_path_replay->frames();
+    const auto& frame = frames[m_path_replay_frame];
+    const float delta_time = m_path_replay_frame > 0
+        ? static_cast<float>(frame.time - frames[m_path_replay_frame - 1].time) : 0.0f;
+
+    frame.camera.apply(*m_camera);
+    if (frame.random_seed != m_ifs_params.random_seed || frame.scale != m_ifs_params.scale) {
+        m_ifs_params.random_seed = frame.random_seed;
+        m_ifs_params.scale = frame.scale;
+        m_needs_recompute = true;
+    }
+
+    // Backend parameters first, as the UI does; the rest belong to the frontend
+    auto rest = apply_path_parameters(frame.parameters, m_backend->get_ui_callbacks());
+    if (rest.size() < frame.parameters.size()) {
+        m_needs_recompute = true;
+        m_needs_buffer_rebind = true;
+    }
+    for (const auto& [name, value] : apply_path_parameters(rest, m_frontend->get_ui_callbacks())) {
+        Logger::instance().warn("Camera path frame {}: no parameter named '{}'", m_path_replay_frame, name);
+    }
+
+    m_path_replay_frame++;
+    return delta_time;
+}
+
+void IFSController::finish_path_replay() {
+    const auto summary = summarize_replay(m_path_timings);
+    m_path_status = std::format("Replayed {} frames ({} recomputes): mean {:.3f} ms, p50 {:.3f}, p95 {:.3f}, p99 {:.3f}, max {:.3f}",
+        summary.frames, summary.recomputes, summary.mean_ms, summary.p50_ms, summary.p95_ms, summary.p99_ms, summary.max_ms);
+    Logger::instance().info("Camera path: {}", m_path_status);
+    if (!write_frame_timings(m_path_timings_file, m_path_timings)) {
+        Logger::instance().error("Failed to write '{}'", m_path_timings_file.string());
+    }
+
+    m_path_replay.reset();
+    if (m_path_close_when_done) {
+        glfwSetWindowShouldClose(m_window->get_window_handle(), GLFW_TRUE);
+    }
+}
+
+void IFSController::render_camera_path_ui() {
+    if (!ImGui::CollapsingHeader("Camera Path")) {
+        return;
+    }
+
+    ImGui::InputText("Path file", m_path_file.data(), m_path_file.size());
+    if (m_path_recording) {
+        ImGui::Text("Recording: %zu frames", m_path_recorder.path().frames().size());
+        if (ImGui::Button("Stop")) {
+            stop_path_recording();
+        }
+    } else if (m_path_replay) {
+        ImGui::Text("Replaying: frame %zu of %zu", m_path_replay_frame, m_path_replay->frames().size());
+        if (ImGui::Button("Abort")) {
+            finish_path_replay();
+        }
+    } else {
+        if (ImGui::Button("Record")) {
+            start_path_recording(m_path_file.data());
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Replay")) {
+            std::ifstream file(m_path_file.data());
+            std::stringstream text;
+            text << file.rdbuf();
+            auto path = parse_camera_path(text.str());
+            if (!file) {
+                m_path_status = "Replay failed: could not read file";
+            } else if (!path) {
+                m_path_status = std::format("Replay failed: {}", path.error());
+            } else {
+                // Timings land next to the recording, e.g. camera_path.timings.csv
+                auto timings = std::filesystem::path(m_path_file.data()).replace_extension(".timings.csv");
+                start_path_replay(std::move(*path), std::move(timings), false);
+            }
+        }
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("Plays the recording back as fast as frames present, writing per-frame timings");
+        }
+    }
+    if (!m_path_status.empty()) {
+        ImGui::TextWrapped("%s", m_path_status.c_str());
+    }
+}
+
+void IFSController::render_deep_zoom_ui() {
+    auto* affine = dynamic_cast<AffineIFS*>(m_backend.get());
+    if (!affine || !m_camera || !ImGui::CollapsingHeader("Deep Zoom")) {
+        return;
+    }
+
+    bool frame_changed = false;
+    if (ImGui::Checkbox("Enabled", &m_deep_zoom)) {
+        if (!m_deep_zoom) {
+            // Back to world coordinates, keeping the camera where it looks
+            const glm::vec3 target = glm::vec3(m_camera->to_world(m_camera->target()));
+            m_camera->set_frame(glm::dvec3(0.0), 1.0);
+            m_camera->set_target(target);
+        }
+        frame_changed = true;
+    }
+    ImGui::BeginDisabled(!m_deep_zoom);
+    if (ImGui::Button("Zoom in x10")) {
+        m_camera->zoom_frame(10.0);
+        frame_changed = true;
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Zoom out x10")) {
+        m_camera->zoom_frame(0.1);
+        frame_changed = true;
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Recenter")) {
+        m_camera->zoom_frame(1.0);  // Re-anchor at the target after moving
+        frame_changed = true;
+    }
+    ImGui::EndDisabled();
+
+    const auto anchor = m_camera->anchor();
+    ImGui::Text("Anchor: (%.17g, %.17g, %.17g)", anchor.x, anchor.y, anchor.z);
+    ImGui::Text("Extent: %.3g (zoom x%.3g)", m_camera->extent(), 1.0 / m_camera->extent());
+    if (m_deep_zoom) {
+        ImGui::Text("Pieces sampled: %u", affine->deep_zoom_word_count());
+    }
+
+    if (frame_changed) {
+        affine->set_deep_zoom(m_deep_zoom
+            ? std::optional(DeepZoomView{.anchor = m_camera->anchor(), .extent = m_camera->extent()})
+            : std::nullopt);
+        m_needs_recompute = true;
+    }
+}
+
+void IFSController::advance_animation(float delta_time) {
+    static auto& frames = MetricsRegistry::instance().counter(
+        "ifs_animation_frames_total", "Animation frames applied to the backend");
+
+    auto* affine = dynamic_cast<AffineIFS*>(m_backend.get());
+    if (!affine || m_timeline.empty()) {
+        m_animation_playing = false;
+        return;
+    }
+
+    if (m_animation_playing) {
+        m_animation_time += delta_time;
+        if (m_animation_time > m_timeline.duration()) {
+            if (m_animation_loop && m_timeline.duration() > 0.0f) {
+                m_animation_time = std::fmod(m_animation_time, m_timeline.duration());
+            } else {
+                m_animation_time = m_timeline.duration();
+                m_animation_playing = false;
+            }
+        }
+    }
+
+    auto frame = m_timeline.sample(m_animation_time);
+    if (auto result = affine->set_definition(std::move(frame->ifs)); !result) {
+        Logger::instance().error("Animation frame rejected: {}", result.error());
+        m_animation_playing = false;
+        return;
+    }
+    frame->camera.apply(*m_camera);
+    m_ifs_params.scale = frame->scale;
+
+    // Consecutive frames are close, so the previous orbits only need a few iterations to settle
+    affine->set_warm_start(static_cast<uint32_t>(m_warm_iterations));
+    m_needs_recompute = true;
+    frames.add();
+}
+
+void IFSController::render_inspect_ui() {
+    if (!ImGui::CollapsingHeader("Inspect")) {
+        return;
+    }
+
+    render_dimension_ui();
+    render_statistics_ui();
+    ImGui::Separator();
+
+    if (ImGui::Checkbox("Spatial index", &m_spatial_enabled) && m_spatial_enabled && !m_spatial_grid) {
+        auto grid = SpatialGrid::create(*m_context);
+        if (grid) {
+            m_spatial_grid = std::move(*grid);
+            m_spatial_dirty = true;
+        } else {
+            Logger::instance().error("Failed to create spatial grid: {}", grid.error());
+            m_spatial_enabled = false;
+        }
+    }
+    if (!m_spatial_enabled || !m_spatial_grid) {
+        ImGui::TextDisabled("Hover particles to pick them once enabled");
+        return;
+    }
+
+    if (const auto& info = m_spatial_grid->info()) {
+        ImGui::Text("Grid: %ux%ux%u cells of %.4g, built in %.3f ms",
+            info->dims.x, info->dims.y, info->dims.z, info->origin.w, m_spatial_grid->build_ms());
+    } else {
+        ImGui::TextDisabled("Grid: building...");
+    }
+    ImGui::SliderFloat("Pick radius (px)", &m_pick_radius_px, 1.0f, 32.0f, "%.0f");
+
+    if (m_picked) {
+        ImGui::Text("Picked: #%u at (%.4f, %.4f, %.4f)", m_picked->index,
+            m_picked_point.x, m_picked_point.y, m_picked_point.z);
+    } else {
+        ImGui::TextDisabled("Picked: (none under cursor)");
+    }
+
+    ImGui::BeginDisabled(!m_picked);
+    ImGui::SliderFloat("Query radius", &m_query_radius, 0.0001f, 1.0f, "%.4f", ImGuiSliderFlags_Logarithmic);
+    if (ImGui::Button("Particles within radius")) {
+        m_spatial_request = SpatialQueryKind::Radius;
+    }
+    ImGui::SliderInt("k", &m_query_k, 1, 1024);
+    if (ImGui::Button("k nearest")) {
+        m_spatial_request = SpatialQueryKind::Nearest;
+    }
+    ImGui::EndDisabled();
+
+    if (m_spatial_result) {
+        ImGui::Text("%s: %u particles in %.3f ms",
+            m_spatial_result->kind == SpatialQueryKind::Radius ? "Radius" : "Nearest",
+            m_spatial_result->total, m_spatial_result->gpu_ms);
+        const size_t shown = std::min<size_t>(m_spatial_result->hits.size(), 8);
+        for (size_t i = 0; i < shown; i++) {
+            ImGui::Text("  #%u  d=%.5f", m_spatial_result->hits[i].index, m_spatial_result->hits[i].distance);
+        }
+    }
+}
+
+void IFSController::render_dimension_ui() {
+    if (ImGui::Checkbox("Fractal dimension", &m_dimension_enabled) && m_dimension_enabled && !m_fractal_dimension) {
+        auto estimator = FractalDimension::create(*m_context);
+        if (estimator) {
+            m_fractal_dimension = std::move(*estimator);
+            m_dimension_dirty = true;
+        } else {
+            Logger::instance().error("Failed to create fractal dimension estimator: {}", estimator.error());
+            m_dimension_enabled = false;
+        }
+    }
+    if (!m_dimension_enabled || !m_fractal_dimension) {
+        return;
+    }
+
+    if (!m_dimension_result) {
+        ImGui::TextDisabled("Dimension: counting...");
+    } else if (!*m_dimension_result) {
+        ImGui::TextDisabled("Dimension: %s", m_dimension_result->error().c_str());
+    } else {
+        const auto& estimate = **m_dimension_result;
+        ImGui::Text("Dimension: %.4f +/- %.4f (R^2 %.5f, levels %u-%u, %.3f ms)",
+            estimate.dimension, estimate.standard_error, estimate.r_squared,
+            estimate.fit_first, estimate.fit_last, estimate.gpu_ms);
+        if (ImGui::IsItemHovered() && ImGui::BeginTooltip()) {
+            for (const auto& count : estimate.counts) {
+                ImGui::Text("Level %2u: %u boxes", count.level, count.boxes);
+            }
+            ImGui::EndTooltip();
+        }
+    }
+}
+
+namespace {
+
+// Particle statistics slots: red, green and blue, then transform usage
+constexpr uint32_t TRANSFORM_SLOT = 3;
+constexpr std::array<const char*, 3> CHANNEL_NAMES = {"Red", "Green", "Blue"};
+
+} // anonymous namespace
+
+void IFSController::render_statistics_ui() {
+    if (ImGui::Checkbox("Particle statistics", &m_statistics_enabled) && m_statistics_enabled && !m_particle_statistics) {
+        auto statistics = GpuStatistics::create(*m_context, TRANSFORM_SLOT + 1);
+        if (statistics) {
+            m_particle_statistics = std::move(*statistics);
+            m_statistics_dirty = true;
+        } else {
+            Logger::instance().error("Failed to create particle statistics: {}", statistics.error());
+            m_statistics_enabled = false;
+        }
+    }
+    if (!m_statistics_enabled || !m_particle_statistics) {
+        return;
+    }
+
+    // Stored colors; particles written palette-indexed keep whatever was there before
+    for (uint32_t channel = 0; channel < CHANNEL_NAMES.size(); channel++) {
+        const auto& summary = m_particle_statistics->latest(channel);
+        if (!summary) {
+            ImGui::TextDisabled("%s: binning...", CHANNEL_NAMES[channel]);
+            continue;
+        }
+        std::vector<float> bins(summary->bins.begin(), summary->bins.end());
+        auto label = std::format("##{}", CHANNEL_NAMES[channel]);
+        auto overlay = std::format("{} mean {:.3f}, median {:.3f}, p99 {:.3f}",
+            CHANNEL_NAMES[channel], summary->mean, summary->percentiles[0], summary->percentiles[2]);
+        ImGui::PlotHistogram(label.c_str(), bins.data(), static_cast<int>(bins.size()), 0, overlay.c_str(),
+            0.0f, FLT_MAX, ImVec2(0.0f, 48.0f));
+    }
+
+    if (m_statistics_maps == 0) {
+        return;
+    }
+    const auto& usage = m_particle_statistics->latest(TRANSFORM_SLOT);
+    if (!usage || usage->count == 0) {
+        return;
+    }
+    ImGui::Text("Last transform applied (%u particles):", usage->count);
+    const size_t shown = std::min<size_t>(usage->bins.size(), 16);
+    for (size_t i = 0; i < shown; i++) {
+        ImGui::Text("  Map %2zu: %10u  %6.2f%%", i, usage->bins[i], 100.0 * usage->bins[i] / usage->count);
+    }
+    if (usage->bins.size() > shown) {
+        ImGui::TextDisabled("  ... %zu more", usage->bins.size() - shown);
+    }
+}
+
+void IFSController::update_particle_statistics() {
+    static auto& red_mean = MetricsRegistry::instance().gauge(
+        "ifs_particle_red_mean", "Mean red channel of the stored particle colors");
+    static auto& green_mean = MetricsRegistry::instance().gauge(
+        "ifs_particle_green_mean", "Mean green channel of the stored particle colors");
+    static auto& blue_mean = MetricsRegistry::instance().gauge(
+        "ifs_particle_blue_mean", "Mean blue channel of the stored particle colors");
+
+    if (!m_statistics_enabled || !m_particle_statistics) {
+        return;
+    }
+
+    if (m_statistics_dirty) {
+        constexpr uint32_t PARTICLE_WORDS = sizeof(Particle) / sizeof(uint32_t);
+        const auto buffer = m_backend->get_particle_buffer();
+        const auto count = m_backend->get_particle_count();
+
+        std::vector<GpuStatistics::Job> jobs;
+        for (uint32_t channel = 0; channel < CHANNEL_NAMES.size(); channel++) {
+            jobs.push_back({
+                .slot = channel,
+                .source = buffer,
+                .element_count = count,
+                .spec = {.stride = PARTICLE_WORDS, .offset = 4 + channel, .is_float = true}
+            });
+        }
+
+        // The leading base-radix digit of the 16-bit history coordinate is the
+        // most recent map, so one bin per map over [0, 65536) counts them
+        m_statistics_maps = 0;
+        if (auto* affine = dynamic_cast<AffineIFS*>(m_backend.get())) {
+            const auto maps = static_cast<uint32_t>(affine->definition().maps.size());
+            if (maps <= StatisticsResult::BIN_COUNT) {
+                jobs.push_back({
+                    .slot = TRANSFORM_SLOT,
+                    .source = buffer,
+                    .element_count = count,
+                    .spec = {.stride = PARTICLE_WORDS, .offset = 3, .mask = 0xffffu,
+                             .range_min = 0.0f, .range_max = 65536.0f, .bin_count = maps}
+                });
+                m_statistics_maps = maps;
+            }
+        }
+
+        if (auto result = m_particle_statistics->submit(jobs); !result) {
+            Logger::instance().error("{}", result.error());
+        }
+        m_statistics_dirty = false;
+        return;
+    }
+
+    if (m_particle_statistics->poll()) {
+        for (auto [slot, gauge] : {std::pair{0u, &red_mean}, std::pair{1u, &green_mean}, std::pair{2u, &blue_mean}}) {
+            if (const auto& summary = m_particle_statistics->latest(slot)) {
+                gauge->set(summary->mean);
+            }
+        }
+    }
+}
+
+void IFSController::update_fractal_dimension() {
+    static auto& dimension = MetricsRegistry::instance().gauge(
+        "ifs_fractal_dimension", "Box-counting dimension of the last recompute");
+    static auto& dimension_ms = MetricsRegistry::instance().gauge(
+        "ifs_fractal_dimension_gpu_ms", "GPU time of the last box count");
+
+    if (!m_dimension_enabled || !m_fractal_dimension) {
+        return;
+    }
+
+    if (m_dimension_dirty) {
+        if (auto result = m_fractal_dimension->estimate(m_backend->get_particle_buffer(), m_backend->get_particle_count()); !result) {
+            m_dimension_result = std::unexpected(result.error());
+        } else {
+            m_dimension_result.reset();
+        }
+        m_dimension_dirty = false;
+        return;
+    }
+
+    if (auto result = m_fractal_dimension->poll()) {
+        if (*result) {
+            dimension.set((*result)->dimension);
+            dimension_ms.set((*result)->gpu_ms);
+        }
+        m_dimension_result = std::move(*result);
+    }
+}
+
+void IFSController::update_spatial_grid() {
+    static auto& build_ms = MetricsRegistry::instance().gauge(
+        "ifs_spatial_build_gpu_ms", "GPU time of the last spatial grid build");
+    static auto& query_ms = MetricsRegistry::instance().gauge(
+        "ifs_spatial_query_gpu_ms", "GPU time of the last spatial query");
+
+    if (!m_spatial_enabled || !m_spatial_grid) {
+        return;
+    }
+
+    if (m_spatial_dirty) {
+        if (auto result = m_spatial_grid->build(m_backend->get_particle_buffer(), m_backend->get_particle_count()); !result) {
+            Logger::instance().error("Spatial grid build failed: {}", result.error());
+        }
+        m_spatial_dirty = false;
+        m_picked.reset();
+        m_spatial_result.reset();
+        return;
+    }
+
+    if (auto result = m_spatial_grid->poll()) {
+        query_ms.set(result->gpu_ms);
+        if (result->kind == SpatialQueryKind::Pick) {
+            m_picked = result->hits.empty() ? std::nullopt : std::optional(result->hits.front());
+            if (m_picked) {
+                m_picked_point = m_pick_ray.first + m_pick_ray.second * m_picked->distance;
+            }
+        } else {
+            m_spatial_result = std::move(*result);
+        }
+    }
+
+    if (m_spatial_grid->busy() || !m_spatial_grid->ready()) {
+        return;
+    }
+    build_ms.set(m_spatial_grid->build_ms());
+
+    if (m_spatial_request && m_picked) {
+        auto submitted = *m_spatial_request == SpatialQueryKind::Radius
+            ? m_spatial_grid->query_radius(m_picked_point, m_query_radius)
+            : m_spatial_grid->query_nearest(m_picked_point, static_cast<uint32_t>(m_query_k));
+        if (!submitted) {
+            Logger::instance().error("Spatial query failed: {}", submitted.error());
+        }
+        m_spatial_request.reset();
+        return;
+    }
+
+    // Hover picking: the ray through the cursor, widened to a cone of the pick radius
+    const auto& io = ImGui::GetIO();
+    if (m_mouse_captured || io.WantCaptureMouse || io.DisplaySize.x <= 0.0f || io.DisplaySize.y <= 0.0f) {
+        return;
+    }
+    // Split-screen: only the main view (the left column) picks
+    const glm::vec2 view_size(io.DisplaySize.x / static_cast<float>(view_count()), io.DisplaySize.y);
+    if (io.MousePos.x >= view_size.x) {
+        return;
+    }
+    auto [origin, direction] = m_camera->screen_ray(glm::vec2(io.MousePos.x, io.MousePos.y), view_size);
+    const float slope = m_pick_radius_px * 2.0f * std::tan(glm::radians(m_camera->fov()) * 0.5f) / io.DisplaySize.y;
+    if (auto result = m_spatial_grid->pick(origin, direction, slope); !result) {
+        Logger::instance().error("Spatial pick failed: {}", result.error());
+    }
+    m_pick_ray = {origin, direction};
+}
+
+void IFSController::set_low_latency(bool enabled) {
+    m_low_latency = enabled;
+    m_window->set_low_latency(enabled);
+    m_latency.clear();  // Samples of the other mode would skew the percentiles
+    Logger::instance().info("Low-latency mode {}", enabled ? "on" : "off");
+}
+
+void IFSController::poll_presents(bool block) {
+    constexpr uint64_t PRESENT_TIMEOUT_NS = 100'000'000;  // Hidden or minimized windows may never present
+
+    if (!m_context->has_present_wait()) {
+        if (block) {
+            auto _ = m_context->graphics_queue().waitIdle();
+        }
+        return;
+    }
+
+    if (block) {
+        if (auto present_id = m_latency.newest_pending()) {
+            if (m_window->wait_for_present(*present_id, PRESENT_TIMEOUT_NS)) {
+                m_latency.displayed(*present_id, LatencyTracker::Clock::now());
+            } else {
+                m_latency.discard_pending();
+            }
+        }
+        return;
+    }
+
+    // Observed at the poll, so up to a frame late; the low-latency wait is exact
+    while (auto present_id = m_latency.oldest_pending()) {
+        if (!m_window->wait_for_present(*present_id, 0)) {
+            break;
+        }
+        m_latency.displayed(*present_id, LatencyTracker::Clock::now());
+    }
+}
+
+void IFSController::render_latency_ui() {
+    if (!ImGui::CollapsingHeader("Latency")) {
+        return;
+    }
+
+    bool low_latency = m_low_latency;
+    if (ImGui::Checkbox("Low latency", &low_latency)) {
+        set_low_latency(low_latency);
+    }
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Immediate present, and wait for the previous frame before sampling input");
+    }
+    ImGui::Text("Present mode: %s", vk::to_string(m_window->present_mode()).c_str());
+    if (!m_context->has_present_wait()) {
+        ImGui::TextDisabled("No present wait: latencies end at the present call");
+    }
+
+    const auto summary = m_latency.summary();
+    if (summary.frames == 0) {
+        ImGui::TextDisabled("No frames yet");
+        return;
+    }
+    const char* end = summary.displayed ? "display" : "present";
+    if (summary.input_frames > 0) {
+        ImGui::Text("Input to %s: mean %.2f ms, p50 %.2f, p95 %.2f, p99 %.2f, max %.2f",
+            end, summary.input_mean_ms, summary.input_p50_ms, summary.input_p95_ms, summary.input_p99_ms, summary.input_max_ms);
+        ImGui::Text("  over %zu of the last %zu frames", summary.input_frames, summary.frames);
+    } else {
+        ImGui::TextDisabled("No input in the last %zu frames", summary.frames);
+    }
+    ImGui::Text("Frame start to submit: %.2f ms", summary.start_to_submit_ms);
+    ImGui::Text("Submit to present: %.2f ms", summary.submit_to_present_ms);
+    if (summary.displayed) {
+        ImGui::Text("Present to display: %.2f ms", summary.present_to_display_ms);
+    }
+}
+
+void IFSController::render_metrics_ui() {
+    if (!ImGui::CollapsingHeader("Metrics")) {
+        return;
+    }
+
+    if (m_metrics_exporter) {
+        const auto& config = m_metrics_exporter->config();
+        ImGui::Text("Exporting to %s", config.path.string().c_str());
+        ImGui::SameLine();
+        if (ImGui::SmallButton("Flush")) {
+            m_metrics_exporter->flush();
+        }
+    }
+
+    if (ImGui::BeginTable("metrics", 2, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp)) {
+        for (const auto& sample : MetricsRegistry::instance().snapshot()) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(sample.name.c_str());
+            if (!sample.help.empty() && ImGui::IsItemHovered()) {
+                ImGui::SetTooltip("%s", sample.help.c_str());
+            }
+            ImGui::TableNextColumn();
+            ImGui::Text("%.6g", sample.value);
+        }
+        ImGui::EndTable();
+    }
+}
+
+void IFSController::return_particle_buffer() {
+    const auto& queues = m_context->queue_indices();
+    // Shared buffers go to the external family after each compute, so even one
+    // family has to take it back if no frame has since
+    const bool shared = m_backend->shares_particle_buffer();
+    if (!m_backend->reads_particle_buffer() ||
+        !(queues.has_dedicated_compute() || (shared && m_needs_ownership_acquire))) {
+        return;
+    }
+
+    auto device = m_context->device();
+    auto buffer = m_backend->get_particle_buffer();
+    auto cmd = m_ownership_command_buffer;
+    auto _ = cmd.reset();
+    auto _ = cmd.begin(vk::CommandBufferBeginInfo().setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+
+    // Not rendered since the last compute: take the buffer first, so the release has an owner
+    if (m_needs_ownership_acquire) {
+        m_frontend->acquire_buffer_ownership(cmd, buffer, shared ? VK_QUEUE_FAMILY_EXTERNAL : queues.compute, queues.graphics);
+        m_needs_ownership_acquire = false;
+    }
+    // After every frame submitted so far in queue order, so their reads finish first
+    if (queues.has_dedicated_compute()) {
+        m_backend->return_buffer_ownership(cmd, buffer, queues.graphics, queues.compute);
+    }
+    auto _ = cmd.end();
+
+	auto submit_res = m_context->graphics_queue().submit(vk::SubmitInfo().setCommandBuffers(cmd), m_ownership_fence);
+	if (submit_res != vk::Result::eSuccess)
+	{
+		Logger::instance().error("Failed to return particle buffer ownership: {}", to_string(submit_res));
+		return;
+	}
+    auto _ = device.waitForFences(m_ownership_fence, true, UINT64_MAX);
+    auto _ = device.resetFences(m_ownership_fence);
+}
+
+void IFSController::dispatch_compute() {
+    static auto& recomputes = MetricsRegistry::instance().counter(
+        "ifs_recompute_total", "Backend compute dispatches");
+    static auto& samples = MetricsRegistry::instance().counter(
+        "ifs_compute_samples_total", "Particles generated by the backend");
+
+    // Readers of the shared buffer finish first, and don't start until finish_compute()
+    if (m_particle_share) {
+        m_particle_share->begin_write();
+    }
+    return_particle_buffer();
+
+    m_backend->compute(nullptr, 0, m_ifs_params);  // Parameters ignored by backend
+
+    const double particle_count = m_backend->get_particle_count();
+    recomputes.add();
+    samples.add(particle_count);
+    m_window_samples += particle_count;
+}
+
+void IFSController::finish_compute() {
+    static auto& compute_ms = MetricsRegistry::instance().gauge(
+        "ifs_compute_gpu_ms", "GPU time of the last compute pass");
+
+    m_backend->wait_compute_complete();
+    if (auto* stats = m_backend->compute_stats(); stats && stats->chunk_count > 0) {
+        compute_ms.set(stats->gpu_ms);
+    }
+
+    if (m_particle_share) {
+        // The backend may have reallocated the buffer; clients get the new one
+        if (const auto* buffer = m_backend->particle_buffer()) {
+            if (auto result = m_particle_share->publish(*buffer); !result) {
+                Logger::instance().error("Failed to share particles: {}", result.error());
+            }
+        }
+        m_particle_share->end_write();
+    }
+}
+
+void IFSController::update_metrics(float delta_time) {
+    auto& registry = MetricsRegistry::instance();
+    static auto& frames = registry.counter("ifs_frames_total", "Frames presented");
+    static auto& draws = registry.counter("ifs_draws_total", "Frontend particle draws");
+    static auto& frame_ms = registry.gauge("ifs_frame_ms", "CPU time of the last frame");
+
+    frames.add();
+    draws.add();
+    m_window_draws += 1.0;
+    frame_ms.set(delta_time * 1000.0);
+
+    // Rates and VRAM are refreshed once per second
+    m_metrics_window_seconds += delta_time;
+    if (m_metrics_window_seconds >= 1.0) {
+        static auto& samples_per_second = registry.gauge("ifs_samples_per_second", "Particles generated per second");
+        static auto& draws_per_second = registry.gauge("ifs_draws_per_second", "Frontend draws per second");
+        samples_per_second.set(m_window_samples / m_metrics_window_seconds);
+        draws_per_second.set(m_window_draws / m_metrics_window_seconds);
+        m_window_samples = 0.0;
+        m_window_draws = 0.0;
+        m_metrics_window_seconds = 0.0;
+
+        if (const auto latency = m_latency.summary(); latency.input_frames > 0) {
+            static auto& latency_p50 = registry.gauge("ifs_input_latency_ms{quantile=\"0.5\"}", "Input to present (or display) latency");
+            static auto& latency_p99 = registry.gauge("ifs_input_latency_ms{quantile=\"0.99\"}", "Input to present (or display) latency");
+            latency_p50.set(latency.input_p50_ms);
+            latency_p99.set(latency.input_p99_ms);
+        }
+
+        if (auto* draw_stats = m_frontend->pipeline_statistics()) {
+            static auto& fragments = registry.gauge("ifs_draw_fragment_invocations", "Fragment shader invocations of the last draw");
+            static auto& clipped = registry.gauge("ifs_draw_clipped_ratio", "Fraction of primitives clipped in the last draw");
+            fragments.set(static_cast<double>(draw_stats->fragment_invocations));
+            clipped.set(draw_stats->clipped_fraction());
+        }
+
+        // Heap metrics are looked up by name each second; registration is idempotent
+        auto physical_device = m_context->physical_device();
+        if (m_context->has_memory_budget()) {
+            auto chain = physical_device.getMemoryProperties2<
+                vk::PhysicalDeviceMemoryProperties2, vk::PhysicalDeviceMemoryBudgetPropertiesEXT>();
+            const auto& properties = chain.get<vk::PhysicalDeviceMemoryProperties2>().memoryProperties;
+            const auto& budget = chain.get<vk::PhysicalDeviceMemoryBudgetPropertiesEXT>();
+            for (uint32_t heap = 0; heap < properties.memoryHeapCount; heap++) {
+                registry.gauge(std::format("ifs_vram_heap_size_bytes{{heap=\"{}\"}}", heap), "Size of each memory heap")
+                    .set(static_cast<double>(properties.memoryHeaps[heap].size));
+                registry.gauge(std::format("ifs_vram_usage_bytes{{heap=\"{}\"}}", heap), "Memory heap usage by this process")
+                    .set(static_cast<double>(budget.heapUsage[heap]));
+                registry.gauge(std::format("ifs_vram_budget_bytes{{heap=\"{}\"}}", heap), "Memory heap budget for this process")
+                    .set(static_cast<double>(budget.heapBudget[heap]));
+            }
+        } else {
+            auto properties = physical_device.getMemoryProperties();
+            for (uint32_t heap = 0; heap < properties.memoryHeapCount; heap++) {
+                registry.gauge(std::format("ifs_vram_heap_size_bytes{{heap=\"{}\"}}", heap), "Size of each memory heap")
+                    .set(static_cast<double>(properties.memoryHeaps[heap].size));
+            }
+        }
+    }
+
+    if (m_metrics_exporter) {
+        m_metrics_exporter->tick();
+    }
+}
+
 std::expected<void, std::string> IFSController::run() {
     if (!m_backend) {
         return std::unexpected("Backend not set - call set_backend() before run()");
@@ -372,16 +1441,12 @@ std::expected<void, std::string> IFSController::run() {
     // Check if we need queue family transfers
     bool different_queue_families = m_context->queue_indices().has_dedicated_compute();
 
-    // Dispatch initial compute (backend owns particle buffer)
-    m_backend->compute(nullptr, 0, m_ifs_params);  // Parameters ignored by backend
-    m_backend->wait_compute_complete();
-    m_needs_recompute = false;
-    m_needs_ownership_acquire = different_queue_families;
+    auto& trace = StartupTrace::instance();
+    auto first_compute_begin = StartupTrace::Clock::now();
 
-    // IMPORTANT: Bind particle buffer to frontend descriptor set
-    // Frontend needs this to access particle data in shaders
-    // Query backend for particle buffer
-    m_frontend->update_particle_buffer(m_backend->get_particle_buffer());
+    // Dispatch initial compute (backend owns particle buffer); the per-frame
+    // setup below is done on the CPU while it runs
+    dispatch_compute();
 
     // Create image available semaphores (one per swapchain image)
     std::vector<vk::Semaphore> image_available_sems;
@@ -390,6 +1455,18 @@ std::expected<void, std::string> IFSController::run() {
         image_available_sems.push_back(std::move(semaphore_res.value));
     }
 
+    finish_compute();
+    trace.record("first_compute", first_compute_begin, StartupTrace::Clock::now());
+    m_needs_recompute = false;
+    m_needs_ownership_acquire = different_queue_families || m_backend->shares_particle_buffer();
+
+    // IMPORTANT: Bind particle buffer to frontend descriptor set
+    // Frontend needs this to access particle data in shaders
+    // Query backend for particle buffer
+    for (auto* frontend : frontends()) {
+        frontend->update_particle_buffer(m_backend->get_particle_buffer());
+    }
+
     // Delta time tracking
     auto last_frame_time = std::chrono::high_resolution_clock::now();
 
@@ -398,15 +1475,25 @@ std::expected<void, std::string> IFSController::run() {
 
     // Main loop
     while (!m_window->should_close()) {
+        // Low latency: sample input only once the previous frame is out, so it never queues behind frames
+        poll_presents(m_low_latency);
+
+        if (m_particle_share) {
+            m_particle_share->poll();
+        }
+
         // Calculate delta time
         auto current_frame_time = std::chrono::high_resolution_clock::now();
         float delta_time = std::chrono::duration<float>(current_frame_time - last_frame_time).count();
         last_frame_time = current_frame_time;
 
+        m_latency.begin_frame(LatencyTracker::Clock::now());
         glfwPollEvents();
 
-        // Process camera input
-        handle_input(delta_time);
+        // Process camera input; a replay drives the camera itself
+        if (!m_path_replay) {
+            handle_input(delta_time);
+        }
 
         // Start ImGui frame
         ImGui_ImplVulkan_NewFrame();
@@ -416,6 +1503,27 @@ std::expected<void, std::string> IFSController::run() {
         // Build UI
         render_ui();
 
+        // Replayed frames advance by the recorded time, however long they take now
+        std::optional<FrameTiming> replay_timing;
+        if (m_path_replay && m_path_replay_frame >= m_path_replay->frames().size()) {
+            finish_path_replay();  // The last frame was dropped by a swapchain recreation
+        }
+        if (m_path_replay) {
+            replay_timing = FrameTiming{.frame = static_cast<uint32_t>(m_path_replay_frame)};
+            delta_time = apply_replay_frame();
+        }
+        if (m_animation_playing) {
+            advance_animation(delta_time);
+        }
+        if (m_path_recording) {
+            auto callbacks = m_backend->get_ui_callbacks();
+            for (auto& callback : m_frontend->get_ui_callbacks()) {
+                callbacks.push_back(std::move(callback));
+            }
+            const double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_path_record_start).count();
+            m_path_recorder.record(time, CameraPose::from(*m_camera), m_ifs_params, callbacks);
+        }
+
         ImGui::Render();
 
         // Rebind frontend buffer if backend reallocated it
@@ -425,16 +1533,40 @@ std::expected<void, std::string> IFSController::run() {
             auto _ = m_context->device().waitIdle();
 
             // Update frontend's descriptor set with (potentially new) particle buffer
-            m_frontend->update_particle_buffer(m_backend->get_particle_buffer());
+            for (auto* frontend : frontends()) {
+                frontend->update_particle_buffer(m_backend->get_particle_buffer());
+            }
             m_needs_buffer_rebind = false;
         }
 
         // Recompute if needed
         if (m_needs_recompute) {
-            m_backend->compute(nullptr, 0, m_ifs_params);  // Parameters ignored by backend
-            m_backend->wait_compute_complete();
+            // Analysis passes read the particle buffer on the graphics queue
+            if (m_spatial_grid) {
+                m_spatial_grid->wait_idle();
+                m_spatial_dirty = true;
+            }
+            if (m_fractal_dimension) {
+                m_fractal_dimension->wait_idle();
+                m_dimension_dirty = true;
+            }
+            if (m_particle_statistics) {
+                m_particle_statistics->wait_idle();
+                m_statistics_dirty = true;
+            }
+            const auto compute_start = std::chrono::steady_clock::now();
+            dispatch_compute();
+            finish_compute();
             m_needs_recompute = false;
-            m_needs_ownership_acquire = different_queue_families;
+            m_needs_ownership_acquire = different_queue_families || m_backend->shares_particle_buffer();
+            if (replay_timing) {
+                replay_timing->recomputed = true;
+                replay_timing->compute_ms = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - compute_start).count();
+                if (const auto* stats = m_backend->compute_stats()) {
+                    replay_timing->compute_gpu_ms = stats->gpu_ms;
+                }
+            }
         }
 
         // Acquire next image
@@ -442,16 +1574,36 @@ std::expected<void, std::string> IFSController::run() {
         auto acquire_result = m_window->acquire_next_image(image_available_sems[semaphore_index]);
 
         if (!acquire_result) {
-            // Swapchain out of date - will be recreated
-            m_frontend->handle_swapchain_recreation(m_window->image_count());
+            // Swapchain out of date - will be recreated; its presents never complete
+            m_latency.discard_pending();
+            for (auto* frontend : frontends()) {
+                frontend->handle_swapchain_recreation(m_window->image_count());
 
-            // Rebind particle buffer after swapchain recreation (query from backend)
-            m_frontend->update_particle_buffer(m_backend->get_particle_buffer());
+                // Rebind particle buffer after swapchain recreation (query from backend)
+                frontend->update_particle_buffer(m_backend->get_particle_buffer());
+            }
             continue;
         }
 
         uint32_t image_index = *acquire_result;
 
+        // Split-screen: the main frontend draws its views first, then each view
+        // with its own frontend loads the image and draws over its area
+        std::vector<FrameView> shared_views;
+        std::vector<std::pair<IFSFrontend*, FrameView>> own_views;
+        if (!m_split_views.empty()) {
+            const auto areas = view_areas(m_window->extent());
+            for (size_t i = 0; i < areas.size(); i++) {
+                auto* camera = i == 0 ? m_camera.get() : m_split_views[i - 1].camera.get();
+                camera->handle_resize(areas[i].extent.width, areas[i].extent.height);
+                if (i > 0 && m_split_views[i - 1].frontend) {
+                    own_views.emplace_back(m_split_views[i - 1].frontend.get(), FrameView{camera, areas[i]});
+                } else {
+                    shared_views.push_back(FrameView{camera, areas[i]});
+                }
+            }
+        }
+
         // Prepare frame render info (query backend for buffer/count)
         FrameRenderInfo render_info{
             .image_index = image_index,
@@ -468,31 +1620,99 @@ std::expected<void, std::string> IFSController::run() {
             .particle_count = m_backend->get_particle_count(),
             .camera = *m_camera,
             .needs_ownership_acquire = m_needs_ownership_acquire,
-            .compute_queue_family = m_context->queue_indices().compute,
+            // Shared buffers are released to the external family, like for the other processes
+            .compute_queue_family = m_backend->shares_particle_buffer()
+                ? VK_QUEUE_FAMILY_EXTERNAL : m_context->queue_indices().compute,
             .graphics_queue_family = m_context->queue_indices().graphics,
-            .imgui_draw_data = ImGui::GetDrawData()
+            .imgui_draw_data = own_views.empty() ? ImGui::GetDrawData() : nullptr,
+            .views = shared_views
         };
 
         // Render frame (frontend handles everything)
         auto render_finished_sem = m_frontend->render_frame(render_info, m_context->graphics_queue());
 
+        // Each further frontend waits for the previous submission; the last one draws ImGui
+        for (size_t i = 0; i < own_views.size(); i++) {
+            auto& [frontend, view] = own_views[i];
+            FrameRenderInfo view_info{
+                .image_index = image_index,
+                .current_frame = m_current_frame,
+                .image_available_semaphore = render_finished_sem,
+                .framebuffer = m_window->get_framebuffer(image_index),
+                .extent = m_window->extent(),
+                .render_pass = m_window->load_render_pass(),
+                .clear_values = render_info.clear_values,
+                .particle_buffer = render_info.particle_buffer,
+                .particle_count = render_info.particle_count,
+                .camera = *view.camera,
+                .needs_ownership_acquire = false,  // Acquired by the first submission
+                .compute_queue_family = render_info.compute_queue_family,
+                .graphics_queue_family = render_info.graphics_queue_family,
+                .imgui_draw_data = i + 1 == own_views.size() ? ImGui::GetDrawData() : nullptr,
+                .views = std::span(&view, 1)
+            };
+            render_finished_sem = frontend->render_frame(view_info, m_context->graphics_queue());
+        }
+
+        m_latency.submitted(LatencyTracker::Clock::now());
+
         // Present (correct argument order: queue, semaphore, image_index)
-        auto present_result = m_window->present(m_context->graphics_queue(), render_finished_sem, image_index);
+        const uint64_t present_id = m_latency.presented(LatencyTracker::Clock::now(), m_context->has_present_wait());
+        auto present_result = m_window->present(m_context->graphics_queue(), render_finished_sem, image_index, present_id);
 
         if (!present_result) {
             // Swapchain out of date - recreate
-            m_frontend->handle_swapchain_recreation(m_window->image_count());
+            m_latency.discard_pending();
+            for (auto* frontend : frontends()) {
+                frontend->handle_swapchain_recreation(m_window->image_count());
+            }
+        }
+
+        if (!trace.finished()) {
+            trace.finish();
         }
 
         m_needs_ownership_acquire = false;
         m_current_frame = (m_current_frame + 1) % MAX_FRAMES_IN_FLIGHT;
 
+        // After the frame's acquire barrier, so the graphics queue owns the particles
+        update_spatial_grid();
+        update_fractal_dimension();
+        update_particle_statistics();
+
+        update_metrics(delta_time);
+
+        if (replay_timing && m_path_replay) {
+            replay_timing->frame_ms = std::chrono::duration<double, std::milli>(
+                std::chrono::high_resolution_clock::now() - current_frame_time).count();
+            m_path_timings.push_back(*replay_timing);
+            if (m_path_replay_frame >= m_path_replay->frames().size()) {
+                finish_path_replay();
+            }
+        }
+
         // Advance semaphore index for next frame
         semaphore_index = (semaphore_index + 1) % image_available_sems.size();
     }
 
+    // Keep what was recorded or replayed so far
+    if (m_path_recording) {
+        stop_path_recording();
+    }
+    if (m_path_replay) {
+        finish_path_replay();
+    }
+
     // Wait for all operations to complete before cleanup
     auto _ = m_context->device().waitIdle();
+    m_spatial_grid.reset();
+    m_fractal_dimension.reset();
+    m_particle_statistics.reset();
+    m_particle_share.reset();
+
+    if (m_metrics_exporter) {
+        m_metrics_exporter->flush();
+    }
 
     // Cleanup semaphores
     for (auto& sem : image_available_sems) {
@@ -520,6 +1740,17 @@ void IFSController::cleanup() {
         m_imgui_descriptor_pool = nullptr;
     }
 
+    if (m_context && m_context->device()) {
+        if (m_ownership_fence) {
+            m_context->device().destroyFence(m_ownership_fence);
+            m_ownership_fence = nullptr;
+        }
+        if (m_ownership_pool) {
+            m_context->device().destroyCommandPool(m_ownership_pool);  // Frees the command buffer
+            m_ownership_pool = nullptr;
+        }
+    }
+
     // Resources are automatically cleaned up by unique_ptr destructors
 }
 
@@ -0,0 +1,141 @@
+#include <ifs/LatencyTracker.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace ifs {
+
+namespace {
+
+double to_ms(LatencyTracker::Clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+double percentile(const std::vector<double>& sorted, double fraction) {
+    const auto index = static_cast<size_t>(std::ceil(fraction * sorted.size()));
+    return sorted[std::clamp<size_t>(index, 1, sorted.size()) - 1];
+}
+
+} // anonymous namespace
+
+void LatencyTracker::input(Clock::time_point time) {
+    if (!m_input) {
+        m_input = time;
+    }
+}
+
+void LatencyTracker::begin_frame(Clock::time_point time) {
+    m_current = Frame{.start = time};
+}
+
+void LatencyTracker::submitted(Clock::time_point time) {
+    if (!m_current) {
+        return;
+    }
+    m_current->submit = time;
+    // Input delivered after the submit is for the next frame
+    if (m_input && *m_input <= time) {
+        m_current->input = m_input;
+        m_input.reset();
+    }
+}
+
+uint64_t LatencyTracker::presented(Clock::time_point time, bool await_display) {
+    const uint64_t present_id = m_next_present_id++;
+    if (!m_current) {
+        return present_id;
+    }
+    m_current->present = time;
+    m_current->present_id = present_id;
+    if (await_display) {
+        m_pending.push_back(*m_current);
+        if (m_pending.size() > MAX_PENDING) {
+            m_pending.pop_front();
+        }
+    } else {
+        complete(*m_current, time, false);
+    }
+    m_current.reset();
+    return present_id;
+}
+
+void LatencyTracker::displayed(uint64_t present_id, Clock::time_point time) {
+    while (!m_pending.empty() && m_pending.front().present_id <= present_id) {
+        complete(m_pending.front(), time, true);
+        m_pending.pop_front();
+    }
+}
+
+std::optional<uint64_t> LatencyTracker::oldest_pending() const {
+    if (m_pending.empty()) {
+        return std::nullopt;
+    }
+    return m_pending.front().present_id;
+}
+
+std::optional<uint64_t> LatencyTracker::newest_pending() const {
+    if (m_pending.empty()) {
+        return std::nullopt;
+    }
+    return m_pending.back().present_id;
+}
+
+void LatencyTracker::complete(const Frame& frame, Clock::time_point end, bool displayed) {
+    m_samples.push_back(LatencySample{
+        .present_id = frame.present_id,
+        .has_input = frame.input.has_value(),
+        .displayed = displayed,
+        .input_to_end_ms = frame.input ? to_ms(end - *frame.input) : 0.0,
+        .start_to_submit_ms = to_ms(frame.submit - frame.start),
+        .submit_to_present_ms = to_ms(frame.present - frame.submit),
+        .present_to_display_ms = displayed ? to_ms(end - frame.present) : 0.0
+    });
+    if (m_samples.size() > m_window) {
+        m_samples.pop_front();
+    }
+}
+
+LatencySummary LatencyTracker::summary() const {
+    LatencySummary summary;
+    summary.frames = m_samples.size();
+    if (m_samples.empty()) {
+        return summary;
+    }
+
+    summary.displayed = true;
+    std::vector<double> input_ms;
+    for (const auto& sample : m_samples) {
+        summary.displayed = summary.displayed && sample.displayed;
+        summary.start_to_submit_ms += sample.start_to_submit_ms;
+        summary.submit_to_present_ms += sample.submit_to_present_ms;
+        summary.present_to_display_ms += sample.present_to_display_ms;
+        if (sample.has_input) {
+            input_ms.push_back(sample.input_to_end_ms);
+            summary.input_mean_ms += sample.input_to_end_ms;
+        }
+    }
+    const auto frames = static_cast<double>(m_samples.size());
+    summary.start_to_submit_ms /= frames;
+    summary.submit_to_present_ms /= frames;
+    summary.present_to_display_ms /= frames;
+
+    summary.input_frames = input_ms.size();
+    if (!input_ms.empty()) {
+        summary.input_mean_ms /= static_cast<double>(input_ms.size());
+        std::sort(input_ms.begin(), input_ms.end());
+        summary.input_p50_ms = percentile(input_ms, 0.50);
+        summary.input_p95_ms = percentile(input_ms, 0.95);
+        summary.input_p99_ms = percentile(input_ms, 0.99);
+        summary.input_max_ms = input_ms.back();
+    }
+    return summary;
+}
+
+void LatencyTracker::clear() {
+    m_input.reset();
+    m_current.reset();
+    m_pending.clear();
+    m_samples.clear();
+}
+
+} // namespace ifs
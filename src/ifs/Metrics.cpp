@@ -0,0 +1,202 @@
+#include <ifs/Metrics.hpp>
+#include <ifs/Logger.hpp>
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <fstream>
+
+namespace ifs {
+
+namespace {
+
+std::string json_escape(std::string_view text) {
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (char c : text) {
+        switch (c) {
+            case '"': escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            default: escaped += c; break;
+        }
+    }
+    return escaped;
+}
+
+// JSON has no NaN/Inf
+std::string json_number(double value) {
+    return std::isfinite(value) ? std::format("{}", value) : "null";
+}
+
+// Prometheus spells the non-finite values +Inf, -Inf and NaN
+std::string prometheus_number(double value) {
+    if (std::isnan(value)) {
+        return "NaN";
+    }
+    if (std::isinf(value)) {
+        return value > 0 ? "+Inf" : "-Inf";
+    }
+    return std::format("{}", value);
+}
+
+// HELP text escapes only backslashes and line feeds
+std::string prometheus_help(std::string_view text) {
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (char c : text) {
+        switch (c) {
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            default: escaped += c; break;
+        }
+    }
+    return escaped;
+}
+
+std::string_view base_name(std::string_view name) {
+    return name.substr(0, name.find('{'));
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// MetricsRegistry
+// ============================================================================
+
+MetricsRegistry& MetricsRegistry::instance() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+Metric& MetricsRegistry::counter(std::string_view name, std::string_view help) {
+    return get_or_create(name, help, MetricType::Counter);
+}
+
+Metric& MetricsRegistry::gauge(std::string_view name, std::string_view help) {
+    return get_or_create(name, help, MetricType::Gauge);
+}
+
+Metric& MetricsRegistry::get_or_create(std::string_view name, std::string_view help, MetricType type) {
+    std::lock_guard lock(m_mutex);
+    for (auto& metric : m_metrics) {
+        if (metric.name() == name) {
+            if (metric.type() != type) {
+                Logger::instance().warn("Metric '{}' re-registered with a different type", name);
+            }
+            return metric;
+        }
+    }
+    return m_metrics.emplace_back(std::string{name}, std::string{help}, type);
+}
+
+std::vector<MetricSample> MetricsRegistry::snapshot() const {
+    std::lock_guard lock(m_mutex);
+    std::vector<MetricSample> samples;
+    samples.reserve(m_metrics.size());
+    for (const auto& metric : m_metrics) {
+        samples.push_back({metric.name(), metric.help(), metric.type(), metric.value()});
+    }
+    return samples;
+}
+
+// ============================================================================
+// MetricsExporter
+// ============================================================================
+
+MetricsExporter::MetricsExporter(MetricsExportConfig config, const MetricsRegistry& registry)
+    : m_config(std::move(config))
+    , m_registry(&registry)
+    , m_last_flush(std::chrono::steady_clock::now())
+{}
+
+void MetricsExporter::tick() {
+    auto now = std::chrono::steady_clock::now();
+    if (std::chrono::duration<double>(now - m_last_flush).count() >= m_config.interval_seconds) {
+        flush();
+    }
+}
+
+bool MetricsExporter::flush() {
+    m_last_flush = std::chrono::steady_clock::now();
+    auto samples = m_registry->snapshot();
+
+    if (m_config.format == MetricsFormat::JsonLines) {
+        auto unix_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+
+        std::ofstream file(m_config.path, std::ios::app);
+        if (!file) {
+            Logger::instance().warn("Could not open metrics file {}", m_config.path.string());
+            return false;
+        }
+        file << format_json_line(samples, unix_ms);
+        return static_cast<bool>(file);
+    }
+
+    auto tmp_path = m_config.path;
+    tmp_path += ".tmp";
+    {
+        std::ofstream file(tmp_path, std::ios::trunc);
+        if (!file) {
+            Logger::instance().warn("Could not open metrics file {}", tmp_path.string());
+            return false;
+        }
+        file << format_prometheus(samples);
+        if (!file) {
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmp_path, m_config.path, ec);
+    if (ec) {
+        Logger::instance().warn("Could not replace metrics file {}: {}", m_config.path.string(), ec.message());
+        return false;
+    }
+    return true;
+}
+
+std::string MetricsExporter::format_json_line(const std::vector<MetricSample>& samples, int64_t unix_ms) {
+    std::string line = std::format("{{\"timestamp_ms\":{},\"metrics\":{{", unix_ms);
+    for (size_t i = 0; i < samples.size(); i++) {
+        if (i > 0) {
+            line += ',';
+        }
+        line += std::format("\"{}\":{}", json_escape(samples[i].name), json_number(samples[i].value));
+    }
+    line += "}}\n";
+    return line;
+}
+
+std::string MetricsExporter::format_prometheus(const std::vector<MetricSample>& samples) {
+    // A family's series must be contiguous, under one HELP/TYPE, even when
+    // they were registered interleaved with other families (e.g. per heap)
+    std::vector<std::string_view> families;
+    for (const auto& sample : samples) {
+        auto family = base_name(sample.name);
+        if (std::find(families.begin(), families.end(), family) == families.end()) {
+            families.push_back(family);
+        }
+    }
+
+    std::string text;
+    for (auto family : families) {
+        bool described = false;
+        for (const auto& sample : samples) {
+            if (base_name(sample.name) != family) {
+                continue;
+            }
+            if (!described) {
+                described = true;
+                if (!sample.help.empty()) {
+                    text += std::format("# HELP {} {}\n", family, prometheus_help(sample.help));
+                }
+                text += std::format("# TYPE {} {}\n", family, sample.type == MetricType::Counter ? "counter" : "gauge");
+            }
+            text += std::format("{} {}\n", sample.name, prometheus_number(sample.value));
+        }
+    }
+    return text;
+}
+
+} // namespace ifs
@@ -0,0 +1,479 @@
+#include <ifs/MultiviewTarget.hpp>
+#include <ifs/Logger.hpp>
+#include <ifs/StartupTrace.hpp>
+#include <array>
+#include <format>
+
+namespace ifs {
+
+namespace {
+
+vk::Format find_depth_format(vk::PhysicalDevice physical_device) {
+    for (auto format : {vk::Format::eD32Sfloat, vk::Format::eD32SfloatS8Uint, vk::Format::eD24UnormS8Uint}) {
+        auto props = physical_device.getFormatProperties(format);
+        if (props.optimalTilingFeatures & vk::FormatFeatureFlagBits::eDepthStencilAttachment) {
+            return format;
+        }
+    }
+    return vk::Format::eUndefined;
+}
+
+// Composite push constant: where the view goes and which layer it reads
+struct CompositeParams {
+    int32_t origin_x;
+    int32_t origin_y;
+    uint32_t layer;
+    uint32_t padding;
+};
+
+} // anonymous namespace
+
+MultiviewTarget::MultiviewTarget(const VulkanContext& context, uint32_t view_count)
+    : m_context(&context)
+    , m_device(context.device())
+    , m_view_count(view_count)
+    , m_render_pass(nullptr)
+    , m_framebuffer(nullptr)
+    , m_extent{}
+    , m_descriptor_layout(nullptr)
+    , m_descriptor_pool(nullptr)
+    , m_descriptor_set(nullptr)
+    , m_composite_layout(nullptr)
+    , m_composite_pipeline(nullptr)
+{}
+
+std::expected<std::unique_ptr<MultiviewTarget>, std::string> MultiviewTarget::create(
+    const VulkanContext& context,
+    const vk::GraphicsPipelineCreateInfo& frontend_pipeline,
+    uint32_t view_count
+) {
+    if (!supported(context)) {
+        return std::unexpected("Multiview is not supported by the device");
+    }
+    if (view_count < 2 || view_count > MAX_VIEWS) {
+        return std::unexpected(std::format("Multiview needs 2 to {} views, got {}", MAX_VIEWS, view_count));
+    }
+
+    auto target = std::unique_ptr<MultiviewTarget>(new MultiviewTarget(context, view_count));
+
+    target->m_depth_format = find_depth_format(context.physical_device());
+    if (target->m_depth_format == vk::Format::eUndefined) {
+        return std::unexpected("No supported depth format");
+    }
+
+    if (auto result = target->create_render_pass(); !result) {
+        return std::unexpected(result.error());
+    }
+    if (auto result = target->create_descriptors(); !result) {
+        return std::unexpected(result.error());
+    }
+    if (auto result = target->create_pipeline(frontend_pipeline); !result) {
+        return std::unexpected(result.error());
+    }
+
+    // Layers are created on the first begin(), when the extent is known
+    return target;
+}
+
+MultiviewTarget::~MultiviewTarget() {
+    destroy_images();
+
+    if (m_composite_pipeline) m_device.destroyPipeline(m_composite_pipeline);
+    if (m_composite_layout) m_device.destroyPipelineLayout(m_composite_layout);
+    if (m_descriptor_pool) m_device.destroyDescriptorPool(m_descriptor_pool);
+    if (m_descriptor_layout) m_device.destroyDescriptorSetLayout(m_descriptor_layout);
+    if (m_render_pass) m_device.destroyRenderPass(m_render_pass);
+}
+
+std::expected<void, std::string> MultiviewTarget::create_render_pass() {
+    // Cleared every frame, left readable for the composite
+    auto color_attachment = vk::AttachmentDescription()
+        .setFormat(COLOR_FORMAT)
+        .setSamples(vk::SampleCountFlagBits::e1)
+        .setLoadOp(vk::AttachmentLoadOp::eClear)
+        .setStoreOp(vk::AttachmentStoreOp::eStore)
+        .setStencilLoadOp(vk::AttachmentLoadOp::eDontCare)
+        .setStencilStoreOp(vk::AttachmentStoreOp::eDontCare)
+        .setInitialLayout(vk::ImageLayout::eUndefined)
+        .setFinalLayout(vk::ImageLayout::eShaderReadOnlyOptimal);
+
+    auto depth_attachment = vk::AttachmentDescription()
+        .setFormat(m_depth_format)
+        .setSamples(vk::SampleCountFlagBits::e1)
+        .setLoadOp(vk::AttachmentLoadOp::eClear)
+        .setStoreOp(vk::AttachmentStoreOp::eDontCare)
+        .setStencilLoadOp(vk::AttachmentLoadOp::eDontCare)
+        .setStencilStoreOp(vk::AttachmentStoreOp::eDontCare)
+        .setInitialLayout(vk::ImageLayout::eUndefined)
+        .setFinalLayout(vk::ImageLayout::eDepthStencilAttachmentOptimal);
+
+    auto color_ref = vk::AttachmentReference()
+        .setAttachment(0)
+        .setLayout(vk::ImageLayout::eColorAttachmentOptimal);
+
+    auto depth_ref = vk::AttachmentReference()
+        .setAttachment(1)
+        .setLayout(vk::ImageLayout::eDepthStencilAttachmentOptimal);
+
+    auto subpass = vk::SubpassDescription()
+        .setPipelineBindPoint(vk::PipelineBindPoint::eGraphics)
+        .setColorAttachments(color_ref)
+        .setPDepthStencilAttachment(&depth_ref);
+
+    // Previous frame's composite reads -> this frame's writes
+    auto dependency = vk::SubpassDependency()
+        .setSrcSubpass(VK_SUBPASS_EXTERNAL)
+        .setDstSubpass(0)
+        .setSrcStageMask(
+            vk::PipelineStageFlagBits::eFragmentShader |
+            vk::PipelineStageFlagBits::eLateFragmentTests)
+        .setDstStageMask(
+            vk::PipelineStageFlagBits::eColorAttachmentOutput |
+            vk::PipelineStageFlagBits::eEarlyFragmentTests)
+        .setDstAccessMask(
+            vk::AccessFlagBits::eColorAttachmentWrite |
+            vk::AccessFlagBits::eDepthStencilAttachmentWrite);
+
+    // Views -> composite
+    auto composite_dependency = vk::SubpassDependency()
+        .setSrcSubpass(0)
+        .setDstSubpass(VK_SUBPASS_EXTERNAL)
+        .setSrcStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput)
+        .setDstStageMask(vk::PipelineStageFlagBits::eFragmentShader)
+        .setSrcAccessMask(vk::AccessFlagBits::eColorAttachmentWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eShaderRead);
+
+    std::array dependencies = {dependency, composite_dependency};
+    std::array attachments = {color_attachment, depth_attachment};
+
+    // Every draw is broadcast to layers 0..view_count-1
+    const uint32_t view_mask = (1u << m_view_count) - 1;
+    auto multiview_info = vk::RenderPassMultiviewCreateInfo()
+        .setViewMasks(view_mask)
+        .setCorrelationMasks(view_mask);
+
+    auto render_pass_info = vk::RenderPassCreateInfo()
+        .setPNext(&multiview_info)
+        .setAttachments(attachments)
+        .setSubpasses(subpass)
+        .setDependencies(dependencies);
+
+	auto render_pass_res = m_device.createRenderPass(render_pass_info);
+	if (render_pass_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create multiview render pass: {}", to_string(render_pass_res.result)));
+	}
+	m_render_pass = render_pass_res.value;
+
+    return {};
+}
+
+std::expected<void, std::string> MultiviewTarget::create_descriptors() {
+    auto binding = vk::DescriptorSetLayoutBinding()
+        .setBinding(0)
+        .setDescriptorType(vk::DescriptorType::eSampledImage)
+        .setDescriptorCount(1)
+        .setStageFlags(vk::ShaderStageFlagBits::eFragment);
+
+	auto layout_res = m_device.createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo().setBindings(binding));
+	if (layout_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create multiview descriptor layout: {}", to_string(layout_res.result)));
+	}
+	m_descriptor_layout = layout_res.value;
+
+    auto pool_size = vk::DescriptorPoolSize(vk::DescriptorType::eSampledImage, 1);
+    auto pool_info = vk::DescriptorPoolCreateInfo()
+        .setMaxSets(1)
+        .setPoolSizes(pool_size);
+
+	auto pool_res = m_device.createDescriptorPool(pool_info);
+	if (pool_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create multiview descriptor pool: {}", to_string(pool_res.result)));
+	}
+	m_descriptor_pool = pool_res.value;
+
+    auto alloc_info = vk::DescriptorSetAllocateInfo()
+        .setDescriptorPool(m_descriptor_pool)
+        .setSetLayouts(m_descriptor_layout);
+
+	auto set_res = m_device.allocateDescriptorSets(alloc_info);
+	if (set_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to allocate multiview descriptor set: {}", to_string(set_res.result)));
+	}
+	m_descriptor_set = set_res.value[0];
+
+    return {};
+}
+
+std::expected<void, std::string> MultiviewTarget::create_pipeline(const vk::GraphicsPipelineCreateInfo& frontend_pipeline) {
+    auto trace_scope = StartupTrace::instance().phase("pipeline:MultiviewTarget");
+
+    auto vert_result = Shader::create_shader(m_device, "ifs_modular/visibility/composite.vert.slang", "main");
+    if (!vert_result) {
+        return std::unexpected(std::format("Failed to load multiview composite vertex shader: {}", vert_result.error()));
+    }
+    m_composite_vertex_shader = std::make_unique<Shader>(std::move(*vert_result));
+
+    auto frag_result = Shader::create_shader(m_device, "ifs_modular/multiview/composite.frag.slang", "main");
+    if (!frag_result) {
+        return std::unexpected(std::format("Failed to load multiview composite fragment shader: {}", frag_result.error()));
+    }
+    m_composite_fragment_shader = std::make_unique<Shader>(std::move(*frag_result));
+
+    auto push_range = vk::PushConstantRange()
+        .setStageFlags(vk::ShaderStageFlagBits::eFragment)
+        .setOffset(0)
+        .setSize(sizeof(CompositeParams));
+
+    auto layout_info = vk::PipelineLayoutCreateInfo()
+        .setSetLayouts(m_descriptor_layout)
+        .setPushConstantRanges(push_range);
+
+	auto layout_res = m_device.createPipelineLayout(layout_info);
+	if (layout_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create multiview composite pipeline layout: {}", to_string(layout_res.result)));
+	}
+	m_composite_layout = layout_res.value;
+
+    std::array stages = {
+        vk::PipelineShaderStageCreateInfo()
+            .setStage(vk::ShaderStageFlagBits::eVertex)
+            .setModule(m_composite_vertex_shader->get_shader_module())
+            .setPName("main"),
+        vk::PipelineShaderStageCreateInfo()
+            .setStage(vk::ShaderStageFlagBits::eFragment)
+            .setModule(m_composite_fragment_shader->get_shader_module())
+            .setPName("main")
+    };
+
+    auto vertex_input = vk::PipelineVertexInputStateCreateInfo();
+
+    auto input_assembly = vk::PipelineInputAssemblyStateCreateInfo()
+        .setTopology(vk::PrimitiveTopology::eTriangleList)
+        .setPrimitiveRestartEnable(false);
+
+    auto rasterizer = vk::PipelineRasterizationStateCreateInfo()
+        .setDepthClampEnable(false)
+        .setRasterizerDiscardEnable(false)
+        .setPolygonMode(vk::PolygonMode::eFill)
+        .setLineWidth(1.0f)
+        .setCullMode(vk::CullModeFlagBits::eNone)
+        .setFrontFace(vk::FrontFace::eCounterClockwise)
+        .setDepthBiasEnable(false);
+
+    // The views were depth tested in the multiview pass
+    auto depth_stencil = vk::PipelineDepthStencilStateCreateInfo()
+        .setDepthTestEnable(false)
+        .setDepthWriteEnable(false)
+        .setDepthBoundsTestEnable(false)
+        .setStencilTestEnable(false);
+
+    auto blend_attachment = vk::PipelineColorBlendAttachmentState()
+        .setColorWriteMask(vk::ColorComponentFlagBits::eR |
+                          vk::ColorComponentFlagBits::eG |
+                          vk::ColorComponentFlagBits::eB |
+                          vk::ColorComponentFlagBits::eA)
+        .setBlendEnable(false);
+
+    auto blending = vk::PipelineColorBlendStateCreateInfo()
+        .setLogicOpEnable(false)
+        .setAttachments(blend_attachment);
+
+    auto composite_info = vk::GraphicsPipelineCreateInfo()
+        .setStages(stages)
+        .setPVertexInputState(&vertex_input)
+        .setPInputAssemblyState(&input_assembly)
+        .setPViewportState(frontend_pipeline.pViewportState)
+        .setPRasterizationState(&rasterizer)
+        .setPMultisampleState(frontend_pipeline.pMultisampleState)
+        .setPDepthStencilState(&depth_stencil)
+        .setPColorBlendState(&blending)
+        .setPDynamicState(frontend_pipeline.pDynamicState)
+        .setLayout(m_composite_layout)
+        .setRenderPass(frontend_pipeline.renderPass)
+        .setSubpass(frontend_pipeline.subpass);
+
+	auto pipeline_res = m_device.createGraphicsPipeline(nullptr, composite_info);
+	if (pipeline_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create multiview composite pipeline: {}", to_string(pipeline_res.result)));
+	}
+	m_composite_pipeline = pipeline_res.value;
+
+    return {};
+}
+
+std::expected<void, std::string> MultiviewTarget::create_images(const vk::Extent2D& extent) {
+    struct Attachment {
+        vk::Format format;
+        vk::ImageUsageFlags usage;
+        vk::ImageAspectFlags aspect;
+        Image* image;
+    };
+    std::array attachments = {
+        Attachment{COLOR_FORMAT, vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eSampled,
+                   vk::ImageAspectFlagBits::eColor, &m_color},
+        Attachment{m_depth_format, vk::ImageUsageFlagBits::eDepthStencilAttachment,
+                   vk::ImageAspectFlagBits::eDepth, &m_depth}
+    };
+
+    for (auto& attachment : attachments) {
+        auto image_info = vk::ImageCreateInfo()
+            .setImageType(vk::ImageType::e2D)
+            .setFormat(attachment.format)
+            .setExtent(vk::Extent3D(extent.width, extent.height, 1))
+            .setMipLevels(1)
+            .setArrayLayers(m_view_count)
+            .setSamples(vk::SampleCountFlagBits::e1)
+            .setTiling(vk::ImageTiling::eOptimal)
+            .setUsage(attachment.usage)
+            .setSharingMode(vk::SharingMode::eExclusive)
+            .setInitialLayout(vk::ImageLayout::eUndefined);
+
+		auto image_res = m_device.createImage(image_info);
+		if (image_res.result != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Failed to create multiview image: {}", to_string(image_res.result)));
+		}
+		attachment.image->image = image_res.value;
+
+        auto mem_reqs = m_device.getImageMemoryRequirements(attachment.image->image);
+        auto memory_type = m_context->find_memory_type(mem_reqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
+        if (!memory_type) {
+            return std::unexpected("Failed to find suitable memory type for multiview image");
+        }
+
+		auto alloc_res = m_device.allocateMemory(vk::MemoryAllocateInfo(mem_reqs.size, *memory_type));
+		if (alloc_res.result != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Failed to allocate multiview image memory: {}", to_string(alloc_res.result)));
+		}
+		attachment.image->memory = alloc_res.value;
+
+		auto bind_res = m_device.bindImageMemory(attachment.image->image, attachment.image->memory, 0);
+		if (bind_res != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Failed to bind multiview image memory: {}", to_string(bind_res)));
+		}
+
+        auto view_info = vk::ImageViewCreateInfo()
+            .setImage(attachment.image->image)
+            .setViewType(vk::ImageViewType::e2DArray)
+            .setFormat(attachment.format)
+            .setSubresourceRange(vk::ImageSubresourceRange(attachment.aspect, 0, 1, 0, m_view_count));
+
+		auto view_res = m_device.createImageView(view_info);
+		if (view_res.result != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Failed to create multiview image view: {}", to_string(view_res.result)));
+		}
+		attachment.image->view = view_res.value;
+    }
+
+    // Multiview framebuffers have one layer; the view mask selects the rest
+    std::array views = {m_color.view, m_depth.view};
+    auto framebuffer_info = vk::FramebufferCreateInfo()
+        .setRenderPass(m_render_pass)
+        .setAttachments(views)
+        .setWidth(extent.width)
+        .setHeight(extent.height)
+        .setLayers(1);
+
+	auto framebuffer_res = m_device.createFramebuffer(framebuffer_info);
+	if (framebuffer_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create multiview framebuffer: {}", to_string(framebuffer_res.result)));
+	}
+	m_framebuffer = framebuffer_res.value;
+
+    auto color_info = vk::DescriptorImageInfo()
+        .setImageView(m_color.view)
+        .setImageLayout(vk::ImageLayout::eShaderReadOnlyOptimal);
+    auto write = vk::WriteDescriptorSet()
+        .setDstSet(m_descriptor_set)
+        .setDstBinding(0)
+        .setDescriptorType(vk::DescriptorType::eSampledImage)
+        .setImageInfo(color_info);
+    m_device.updateDescriptorSets(write, {});
+
+    m_extent = extent;
+    return {};
+}
+
+void MultiviewTarget::destroy_images() {
+    if (m_framebuffer) {
+        m_device.destroyFramebuffer(m_framebuffer);
+        m_framebuffer = nullptr;
+    }
+    for (auto* image : {&m_color, &m_depth}) {
+        if (image->view) m_device.destroyImageView(image->view);
+        if (image->image) m_device.destroyImage(image->image);
+        if (image->memory) m_device.freeMemory(image->memory);  // After the image it backs
+        *image = Image{};
+    }
+    m_extent = vk::Extent2D{};
+}
+
+bool MultiviewTarget::begin(vk::CommandBuffer cmd, const vk::Extent2D& extent, const vk::ClearColorValue& clear_color) {
+    if (extent.width == 0 || extent.height == 0) {
+        return false;
+    }
+    if (extent != m_extent) {
+        // The other frame in flight may still read the old layers
+        auto _ = m_device.waitIdle();
+        destroy_images();
+        if (auto result = create_images(extent); !result) {
+            Logger::instance().error("{}", result.error());
+            destroy_images();
+            return false;
+        }
+    }
+
+    std::array clear_values = {
+        vk::ClearValue(clear_color),
+        vk::ClearValue(vk::ClearDepthStencilValue(1.0f, 0))
+    };
+    auto render_pass_begin = vk::RenderPassBeginInfo()
+        .setRenderPass(m_render_pass)
+        .setFramebuffer(m_framebuffer)
+        .setRenderArea(vk::Rect2D({0, 0}, extent))
+        .setClearValues(clear_values);
+
+    cmd.beginRenderPass(render_pass_begin, vk::SubpassContents::eInline);
+    return true;
+}
+
+void MultiviewTarget::end(vk::CommandBuffer cmd) const {
+    // The render pass leaves the layers in eShaderReadOnlyOptimal for the composite
+    cmd.endRenderPass();
+}
+
+void MultiviewTarget::record_composite(vk::CommandBuffer cmd, uint32_t view, const vk::Rect2D& area) const {
+    const CompositeParams params{
+        .origin_x = area.offset.x,
+        .origin_y = area.offset.y,
+        .layer = view,
+        .padding = 0
+    };
+
+    auto viewport = vk::Viewport()
+        .setX(static_cast<float>(area.offset.x))
+        .setY(static_cast<float>(area.offset.y))
+        .setWidth(static_cast<float>(area.extent.width))
+        .setHeight(static_cast<float>(area.extent.height))
+        .setMinDepth(0.0f)
+        .setMaxDepth(1.0f);
+
+    cmd.setViewport(0, viewport);
+    cmd.setScissor(0, area);
+    cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, m_composite_pipeline);
+    cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_composite_layout, 0, m_descriptor_set, {});
+    cmd.pushConstants<CompositeParams>(m_composite_layout, vk::ShaderStageFlagBits::eFragment, 0, params);
+    cmd.draw(3, 1, 0, 0);
+}
+
+} // namespace ifs
@@ -0,0 +1,643 @@
+#include <ifs/OcclusionCuller.hpp>
+#include <ifs/Shader.hpp>
+#include <ifs/Logger.hpp>
+#include <ifs/StartupTrace.hpp>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <format>
+#include <optional>
+#include <utility>
+
+namespace ifs {
+
+namespace {
+
+constexpr uint32_t GROUP_SIZE = 256;
+constexpr uint32_t MAX_GROUPS_X = 65535;
+constexpr uint32_t BINDING_COUNT = 6;
+
+constexpr auto OCCLUSION_SHADER = "ifs_modular/frontends/sphere/occlusion.slang";
+
+// 1.0f: the far plane, never occludes
+constexpr uint32_t FAR_DEPTH = 0x3f800000u;
+
+// LodDraw in culling.slang: VkDrawIndexedIndirectCommand, then the bucket's range
+struct GPULodDraw {
+    uint32_t index_count;
+    uint32_t instance_count;
+    uint32_t first_index;
+    int32_t vertex_offset;
+    uint32_t first_instance;
+    uint32_t base;
+    uint32_t count;
+    float max_radius;
+};
+static_assert(sizeof(GPULodDraw) == 32, "GPULodDraw must match culling.slang");
+static_assert(offsetof(GPULodDraw, base) == sizeof(vk::DrawIndexedIndirectCommand));
+
+// CullState in culling.slang: the phase counters, then one draw per LOD
+struct GPUCullState {
+    uint32_t visible_count;
+    uint32_t first_phase_count;
+    uint32_t rejected_count;
+    uint32_t lod_count;
+    std::array<GPULodDraw, MAX_LOD_COUNT> draws;
+};
+static_assert(sizeof(GPUCullState) == 16 + MAX_LOD_COUNT * sizeof(GPULodDraw), "GPUCullState must match culling.slang");
+
+/**
+ * @brief Allocate a buffer, persistently mapped if `mapped` is given
+ */
+std::expected<void, std::string> create_buffer(
+    const VulkanContext& context,
+    vk::Device device,
+    vk::DeviceSize size,
+    vk::BufferUsageFlags usage,
+    vk::MemoryPropertyFlags flags,
+    vk::Buffer& buffer,
+    vk::DeviceMemory& memory,
+    void** mapped
+) {
+    auto buffer_info = vk::BufferCreateInfo()
+        .setSize(size)
+        .setUsage(usage)
+        .setSharingMode(vk::SharingMode::eExclusive);
+
+	auto buffer_res = device.createBuffer(buffer_info);
+	if (buffer_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Could not create buffer {}", to_string(buffer_res.result)));
+	}
+	buffer = buffer_res.value;
+
+    auto mem_reqs = device.getBufferMemoryRequirements(buffer);
+    auto memory_type = context.find_memory_type(mem_reqs.memoryTypeBits, flags);
+    if (!memory_type) {
+        return std::unexpected(std::format("Failed to find memory with flags {}", to_string(flags)));
+    }
+
+	auto alloc_res = device.allocateMemory(vk::MemoryAllocateInfo(mem_reqs.size, *memory_type));
+	if (alloc_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Could not allocate device memory {}", to_string(alloc_res.result)));
+	}
+	memory = alloc_res.value;
+
+	auto bind_res = device.bindBufferMemory(buffer, memory, 0);
+	if (bind_res != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Could not bind memory to buffer {}", to_string(bind_res)));
+	}
+
+    if (mapped) {
+		auto map_res = device.mapMemory(memory, 0, VK_WHOLE_SIZE);
+		if (map_res.result != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Could not map memory {}", to_string(map_res.result)));
+		}
+		*mapped = map_res.value;
+    }
+    return {};
+}
+
+void destroy_buffer(vk::Device device, vk::Buffer& buffer, vk::DeviceMemory& memory) {
+    if (buffer) {
+        device.destroyBuffer(buffer);
+        buffer = nullptr;
+    }
+    if (memory) {
+        device.freeMemory(memory);  // Implicitly unmaps
+        memory = nullptr;
+    }
+}
+
+/**
+ * @brief Make one pass' storage writes visible to the next dispatch
+ */
+void compute_barrier(vk::CommandBuffer cmd) {
+    auto barrier = vk::MemoryBarrier()
+        .setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite);
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eComputeShader,
+                        {}, barrier, {}, {});
+}
+
+} // anonymous namespace
+
+OcclusionCuller::OcclusionCuller(const VulkanContext& context, uint32_t slot_count)
+    : m_context(&context)
+    , m_device(context.device())
+    , m_state_buffer(nullptr)
+    , m_state_memory(nullptr)
+    , m_visible_buffer(nullptr)
+    , m_visible_memory(nullptr)
+    , m_rejected_buffer(nullptr)
+    , m_rejected_memory(nullptr)
+    , m_lod_buffer(nullptr)
+    , m_lod_memory(nullptr)
+    , m_pyramid_buffer(nullptr)
+    , m_pyramid_memory(nullptr)
+    , m_extent{}
+    , m_particle_buffer(nullptr)
+    , m_readback_buffer(nullptr)
+    , m_readback_memory(nullptr)
+    , m_slots(slot_count)
+    , m_descriptor_layout(nullptr)
+    , m_pipeline_layout(nullptr)
+    , m_cull_first_pipeline(nullptr)
+    , m_splat_first_pipeline(nullptr)
+    , m_cull_second_pipeline(nullptr)
+    , m_splat_second_pipeline(nullptr)
+    , m_reduce_pipeline(nullptr)
+    , m_bin_count_pipeline(nullptr)
+    , m_bin_offsets_pipeline(nullptr)
+    , m_bin_scatter_pipeline(nullptr)
+    , m_draw_layout(nullptr)
+    , m_descriptor_pool(nullptr)
+    , m_descriptor_set(nullptr)
+    , m_draw_set(nullptr)
+{}
+
+std::expected<std::unique_ptr<OcclusionCuller>, std::string> OcclusionCuller::create(
+    const VulkanContext& context,
+    uint32_t slot_count
+) {
+    auto culler = std::unique_ptr<OcclusionCuller>(new OcclusionCuller(context, slot_count));
+
+    if (auto result = culler->create_descriptors(); !result) {
+        return std::unexpected(result.error());
+    }
+    if (auto result = culler->create_pipelines(); !result) {
+        return std::unexpected(result.error());
+    }
+
+    auto device = context.device();
+    if (auto result = create_buffer(context, device, sizeof(GPUCullState),
+            vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer |
+            vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eTransferSrc,
+            vk::MemoryPropertyFlagBits::eDeviceLocal, culler->m_state_buffer, culler->m_state_memory, nullptr); !result) {
+        return std::unexpected(std::format("Culling state: {}", result.error()));
+    }
+    if (auto result = create_buffer(context, device, slot_count * sizeof(GPUCullState),
+            vk::BufferUsageFlagBits::eTransferDst,
+            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+            culler->m_readback_buffer, culler->m_readback_memory, &culler->m_readback_mapped); !result) {
+        return std::unexpected(std::format("Culling statistics: {}", result.error()));
+    }
+
+    auto state_info = vk::DescriptorBufferInfo(culler->m_state_buffer, 0, VK_WHOLE_SIZE);
+    std::array writes = {
+        vk::WriteDescriptorSet()
+            .setDstSet(culler->m_descriptor_set)
+            .setDstBinding(1)
+            .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+            .setBufferInfo(state_info),
+        vk::WriteDescriptorSet()
+            .setDstSet(culler->m_draw_set)
+            .setDstBinding(1)
+            .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+            .setBufferInfo(state_info)
+    };
+    device.updateDescriptorSets(writes, {});
+
+    // Lists and pyramid are created on the first record_cull(), when the count and extent are known
+    return culler;
+}
+
+OcclusionCuller::~OcclusionCuller() {
+    destroy_lists();
+    destroy_pyramid();
+    destroy_buffer(m_device, m_state_buffer, m_state_memory);
+    destroy_buffer(m_device, m_readback_buffer, m_readback_memory);
+
+    for (auto* pipeline : {&m_cull_first_pipeline, &m_splat_first_pipeline, &m_cull_second_pipeline,
+                           &m_splat_second_pipeline, &m_reduce_pipeline, &m_bin_count_pipeline,
+                           &m_bin_offsets_pipeline, &m_bin_scatter_pipeline}) {
+        if (*pipeline) {
+            m_device.destroyPipeline(*pipeline);
+        }
+    }
+    if (m_pipeline_layout) m_device.destroyPipelineLayout(m_pipeline_layout);
+    if (m_descriptor_pool) m_device.destroyDescriptorPool(m_descriptor_pool);
+    if (m_descriptor_layout) m_device.destroyDescriptorSetLayout(m_descriptor_layout);
+    if (m_draw_layout) m_device.destroyDescriptorSetLayout(m_draw_layout);
+}
+
+std::vector<vk::Extent2D> OcclusionCuller::pyramid_levels(const vk::Extent2D& extent) {
+    std::vector<vk::Extent2D> levels{extent};
+    while (levels.back().width > 1 || levels.back().height > 1) {
+        const auto below = levels.back();
+        levels.push_back(vk::Extent2D((below.width + 1) / 2, (below.height + 1) / 2));
+    }
+    return levels;
+}
+
+std::expected<void, std::string> OcclusionCuller::create_descriptors() {
+    // Set 0 of the culling passes: particles, state, visible, rejected, pyramid, binned list
+    std::array<vk::DescriptorSetLayoutBinding, BINDING_COUNT> bindings;
+    for (uint32_t i = 0; i < BINDING_COUNT; i++) {
+        bindings[i] = vk::DescriptorSetLayoutBinding()
+            .setBinding(i)
+            .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+            .setDescriptorCount(1)
+            .setStageFlags(vk::ShaderStageFlagBits::eCompute);
+    }
+
+	auto layout_res = m_device.createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo().setBindings(bindings));
+	if (layout_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create culling descriptor layout: {}", to_string(layout_res.result)));
+	}
+	m_descriptor_layout = layout_res.value;
+
+    // Draw set: the binned list and the bucket ranges, read by the frontend's vertex shader
+    std::array<vk::DescriptorSetLayoutBinding, 2> draw_bindings;
+    for (uint32_t i = 0; i < draw_bindings.size(); i++) {
+        draw_bindings[i] = vk::DescriptorSetLayoutBinding()
+            .setBinding(i)
+            .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+            .setDescriptorCount(1)
+            .setStageFlags(vk::ShaderStageFlagBits::eVertex);
+    }
+
+	auto draw_layout_res = m_device.createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo().setBindings(draw_bindings));
+	if (draw_layout_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create draw list descriptor layout: {}", to_string(draw_layout_res.result)));
+	}
+	m_draw_layout = draw_layout_res.value;
+
+    auto pool_size = vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, BINDING_COUNT + 2);
+    auto pool_info = vk::DescriptorPoolCreateInfo()
+        .setMaxSets(2)
+        .setPoolSizes(pool_size);
+
+	auto pool_res = m_device.createDescriptorPool(pool_info);
+	if (pool_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create culling descriptor pool: {}", to_string(pool_res.result)));
+	}
+	m_descriptor_pool = pool_res.value;
+
+    std::array set_layouts = {m_descriptor_layout, m_draw_layout};
+    auto alloc_info = vk::DescriptorSetAllocateInfo()
+        .setDescriptorPool(m_descriptor_pool)
+        .setSetLayouts(set_layouts);
+
+	auto set_res = m_device.allocateDescriptorSets(alloc_info);
+	if (set_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to allocate culling descriptor sets: {}", to_string(set_res.result)));
+	}
+	m_descriptor_set = set_res.value[0];
+	m_draw_set = set_res.value[1];
+
+    auto push_constant_range = vk::PushConstantRange()
+        .setStageFlags(vk::ShaderStageFlagBits::eCompute)
+        .setOffset(0)
+        .setSize(sizeof(CullParams));
+
+    auto pipeline_layout_info = vk::PipelineLayoutCreateInfo()
+        .setSetLayouts(m_descriptor_layout)
+        .setPushConstantRanges(push_constant_range);
+
+	auto pipeline_layout_res = m_device.createPipelineLayout(pipeline_layout_info);
+	if (pipeline_layout_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create culling pipeline layout: {}", to_string(pipeline_layout_res.result)));
+	}
+	m_pipeline_layout = pipeline_layout_res.value;
+
+    return {};
+}
+
+std::expected<void, std::string> OcclusionCuller::create_pipelines() {
+    auto trace_scope = StartupTrace::instance().phase("pipeline:OcclusionCuller");
+
+    const std::array entries = {
+        std::pair{"cull_first", &m_cull_first_pipeline},
+        std::pair{"splat_first", &m_splat_first_pipeline},
+        std::pair{"cull_second", &m_cull_second_pipeline},
+        std::pair{"splat_second", &m_splat_second_pipeline},
+        std::pair{"reduce", &m_reduce_pipeline},
+        std::pair{"bin_count", &m_bin_count_pipeline},
+        std::pair{"bin_offsets", &m_bin_offsets_pipeline},
+        std::pair{"bin_scatter", &m_bin_scatter_pipeline},
+    };
+    for (const auto& [entry, pipeline] : entries) {
+        auto shader = Shader::create_shader(m_device, OCCLUSION_SHADER, entry);
+        if (!shader) {
+            return std::unexpected(std::format("Failed to load {}:{}: {}", OCCLUSION_SHADER, entry, shader.error()));
+        }
+
+        auto pipeline_info = vk::ComputePipelineCreateInfo()
+            .setStage(shader->create_pipeline_shader_stage_create_info())
+            .setLayout(m_pipeline_layout);
+
+		auto pipeline_res = m_device.createComputePipeline(nullptr, pipeline_info);
+		if (pipeline_res.result != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Failed to create {} pipeline: {}", entry, to_string(pipeline_res.result)));
+		}
+		*pipeline = pipeline_res.value;
+    }
+    return {};
+}
+
+std::expected<void, std::string> OcclusionCuller::create_lists(uint32_t capacity) {
+    const vk::DeviceSize size = vk::DeviceSize(capacity) * sizeof(uint32_t);
+    for (auto [buffer, memory] : {std::pair{&m_visible_buffer, &m_visible_memory},
+                                  std::pair{&m_rejected_buffer, &m_rejected_memory},
+                                  std::pair{&m_lod_buffer, &m_lod_memory}}) {
+        if (auto result = create_buffer(*m_context, m_device, size, vk::BufferUsageFlagBits::eStorageBuffer,
+                vk::MemoryPropertyFlagBits::eDeviceLocal, *buffer, *memory, nullptr); !result) {
+            return std::unexpected(std::format("Culling lists: {}", result.error()));
+        }
+    }
+
+    auto visible_info = vk::DescriptorBufferInfo(m_visible_buffer, 0, VK_WHOLE_SIZE);
+    auto rejected_info = vk::DescriptorBufferInfo(m_rejected_buffer, 0, VK_WHOLE_SIZE);
+    auto lod_info = vk::DescriptorBufferInfo(m_lod_buffer, 0, VK_WHOLE_SIZE);
+    std::array writes = {
+        vk::WriteDescriptorSet()
+            .setDstSet(m_descriptor_set)
+            .setDstBinding(2)
+            .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+            .setBufferInfo(visible_info),
+        vk::WriteDescriptorSet()
+            .setDstSet(m_descriptor_set)
+            .setDstBinding(3)
+            .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+            .setBufferInfo(rejected_info),
+        vk::WriteDescriptorSet()
+            .setDstSet(m_descriptor_set)
+            .setDstBinding(5)
+            .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+            .setBufferInfo(lod_info),
+        vk::WriteDescriptorSet()
+            .setDstSet(m_draw_set)
+            .setDstBinding(0)
+            .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+            .setBufferInfo(lod_info)
+    };
+    m_device.updateDescriptorSets(writes, {});
+
+    m_capacity = capacity;
+    return {};
+}
+
+std::expected<void, std::string> OcclusionCuller::create_pyramid(const vk::Extent2D& extent) {
+    const auto levels = pyramid_levels(extent);
+    vk::DeviceSize texels = 0;
+    for (const auto& level : levels) {
+        texels += vk::DeviceSize(level.width) * level.height;
+    }
+
+    if (auto result = create_buffer(*m_context, m_device, texels * sizeof(uint32_t),
+            vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst,
+            vk::MemoryPropertyFlagBits::eDeviceLocal, m_pyramid_buffer, m_pyramid_memory, nullptr); !result) {
+        return std::unexpected(std::format("Depth pyramid: {}", result.error()));
+    }
+
+    auto pyramid_info = vk::DescriptorBufferInfo(m_pyramid_buffer, 0, VK_WHOLE_SIZE);
+    auto write = vk::WriteDescriptorSet()
+        .setDstSet(m_descriptor_set)
+        .setDstBinding(4)
+        .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+        .setBufferInfo(pyramid_info);
+    m_device.updateDescriptorSets(write, {});
+
+    m_extent = extent;
+    m_level_count = static_cast<uint32_t>(levels.size());
+    m_pyramid_initialized = false;
+    return {};
+}
+
+void OcclusionCuller::destroy_lists() {
+    destroy_buffer(m_device, m_visible_buffer, m_visible_memory);
+    destroy_buffer(m_device, m_rejected_buffer, m_rejected_memory);
+    destroy_buffer(m_device, m_lod_buffer, m_lod_memory);
+    m_capacity = 0;
+}
+
+void OcclusionCuller::destroy_pyramid() {
+    destroy_buffer(m_device, m_pyramid_buffer, m_pyramid_memory);
+    m_extent = vk::Extent2D{};
+    m_level_count = 0;
+    m_pyramid_initialized = false;
+}
+
+void OcclusionCuller::update_particle_buffer(vk::Buffer particle_buffer) {
+    m_particle_buffer = particle_buffer;
+    if (!particle_buffer) {
+        return;
+    }
+
+    auto particle_info = vk::DescriptorBufferInfo(particle_buffer, 0, VK_WHOLE_SIZE);
+    auto write = vk::WriteDescriptorSet()
+        .setDstSet(m_descriptor_set)
+        .setDstBinding(0)
+        .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+        .setBufferInfo(particle_info);
+    m_device.updateDescriptorSets(write, {});
+}
+
+void OcclusionCuller::collect(uint32_t slot) {
+    if (slot >= m_slots.size() || !m_slots[slot].pending) {
+        return;
+    }
+
+    GPUCullState state;
+    std::memcpy(&state, static_cast<const char*>(m_readback_mapped) + slot * sizeof(GPUCullState), sizeof(state));
+    const uint32_t second_phase = state.visible_count - state.first_phase_count;
+    m_latest = OcclusionStatistics{
+        .instance_count = m_slots[slot].instance_count,
+        .first_phase = state.first_phase_count,
+        .second_phase = second_phase,
+        .occluded = state.rejected_count - second_phase,
+        .lod_count = m_slots[slot].lod_count
+    };
+    for (uint32_t lod = 0; lod < m_latest.lod_count; lod++) {
+        m_latest.lod_instances[lod] = state.draws[lod].instance_count;
+    }
+    m_slots[slot].pending = false;
+}
+
+void OcclusionCuller::dispatch(vk::CommandBuffer cmd, vk::Pipeline pipeline, uint32_t count, uint32_t level) {
+    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline);
+    for (uint32_t first = 0; first < count; first += MAX_GROUPS_X * GROUP_SIZE) {
+        m_params.first = first;
+        m_params.level = level;
+        cmd.pushConstants<CullParams>(m_pipeline_layout, vk::ShaderStageFlagBits::eCompute, 0, m_params);
+        cmd.dispatch((std::min(count - first, MAX_GROUPS_X * GROUP_SIZE) + GROUP_SIZE - 1) / GROUP_SIZE, 1, 1);
+    }
+}
+
+void OcclusionCuller::record_reduce(vk::CommandBuffer cmd) {
+    const auto levels = pyramid_levels(m_extent);
+    for (uint32_t level = 1; level < levels.size(); level++) {
+        dispatch(cmd, m_reduce_pipeline, levels[level].width * levels[level].height, level);
+        compute_barrier(cmd);
+    }
+}
+
+void OcclusionCuller::record_occlusion(vk::CommandBuffer cmd, uint32_t particle_count) {
+    // Level 0 now only holds this frame's spheres
+    auto tested = vk::MemoryBarrier()
+        .setSrcAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eTransferWrite | vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite);
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader,
+                        vk::PipelineStageFlagBits::eTransfer | vk::PipelineStageFlagBits::eComputeShader,
+                        {}, tested, {}, {});
+    cmd.fillBuffer(m_pyramid_buffer, 0, vk::DeviceSize(m_extent.width) * m_extent.height * sizeof(uint32_t), FAR_DEPTH);
+    auto reset = vk::MemoryBarrier()
+        .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite);
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eComputeShader,
+                        {}, reset, {}, {});
+
+    dispatch(cmd, m_splat_first_pipeline, particle_count);
+    compute_barrier(cmd);
+    record_reduce(cmd);
+
+    // Phase 2: re-test the rejected instances against the spheres drawn so far
+    dispatch(cmd, m_cull_second_pipeline, particle_count);
+    compute_barrier(cmd);
+    dispatch(cmd, m_splat_second_pipeline, particle_count);
+    compute_barrier(cmd);
+    record_reduce(cmd);
+}
+
+bool OcclusionCuller::record_cull(
+    vk::CommandBuffer cmd,
+    uint32_t slot,
+    uint32_t particle_count,
+    const glm::mat4& view_projection,
+    float radius,
+    const vk::Extent2D& extent,
+    std::span<const LodMesh> lods,
+    bool occlusion
+) {
+    if (!m_particle_buffer || particle_count == 0 || extent.width == 0 || extent.height == 0 || slot >= m_slots.size() ||
+        lods.empty() || lods.size() > MAX_LOD_COUNT) {
+        return false;
+    }
+
+    if (particle_count > m_capacity || extent != m_extent) {
+        // The other frame in flight may still use the old buffers
+        auto _ = m_device.waitIdle();
+        if (particle_count > m_capacity) {
+            destroy_lists();
+            if (auto result = create_lists(particle_count); !result) {
+                Logger::instance().error("{}", result.error());
+                destroy_lists();
+                return false;
+            }
+        }
+        if (extent != m_extent) {
+            destroy_pyramid();
+            if (auto result = create_pyramid(extent); !result) {
+                Logger::instance().error("{}", result.error());
+                destroy_pyramid();
+                return false;
+            }
+        }
+    }
+
+    m_params = CullParams{
+        .view_projection = view_projection,
+        .extent = glm::uvec2(extent.width, extent.height),
+        .radius = radius,
+        .particle_count = particle_count,
+        .level_count = occlusion ? m_level_count : 0
+    };
+
+    // Previous frame's culling, draw and readback -> this frame's writes
+    auto reuse = vk::MemoryBarrier()
+        .setSrcAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite |
+                          vk::AccessFlagBits::eIndirectCommandRead | vk::AccessFlagBits::eTransferRead)
+        .setDstAccessMask(vk::AccessFlagBits::eTransferWrite |
+                          vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite);
+    cmd.pipelineBarrier(
+        vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eDrawIndirect |
+            vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eTransfer,
+        vk::PipelineStageFlagBits::eTransfer | vk::PipelineStageFlagBits::eComputeShader,
+        {}, reuse, {}, {});
+
+    // Without a previous frame nothing occludes: the first phase draws everything in view
+    if (!occlusion) {
+        m_pyramid_initialized = false;  // Stale once occlusion is back on
+    } else if (!m_pyramid_initialized) {
+        cmd.fillBuffer(m_pyramid_buffer, 0, VK_WHOLE_SIZE, FAR_DEPTH);
+        m_pyramid_initialized = true;
+    }
+    GPUCullState initial{.lod_count = static_cast<uint32_t>(lods.size())};
+    for (size_t lod = 0; lod < lods.size(); lod++) {
+        initial.draws[lod] = GPULodDraw{
+            .index_count = lods[lod].index_count,
+            .first_index = lods[lod].first_index,
+            .vertex_offset = lods[lod].vertex_offset,
+            .max_radius = lods[lod].max_radius
+        };
+    }
+    cmd.updateBuffer<GPUCullState>(m_state_buffer, 0, initial);
+
+    auto reset = vk::MemoryBarrier()
+        .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite);
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eComputeShader,
+                        {}, reset, {}, {});
+
+    cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_pipeline_layout, 0, m_descriptor_set, {});
+
+    // Phase 1: against the previous frame's pyramid (with occlusion off, the frustum only)
+    dispatch(cmd, m_cull_first_pipeline, particle_count);
+    if (occlusion) {
+        record_occlusion(cmd, particle_count);
+    } else {
+        compute_barrier(cmd);
+    }
+
+    // Bin the visible list by projected radius into the per-LOD draws
+    dispatch(cmd, m_bin_count_pipeline, particle_count);
+    compute_barrier(cmd);
+    dispatch(cmd, m_bin_offsets_pipeline, 1);
+    compute_barrier(cmd);
+    dispatch(cmd, m_bin_scatter_pipeline, particle_count);
+
+    // Binned list and commands -> indirect draws; counters -> statistics readback
+    auto culled = vk::MemoryBarrier()
+        .setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eIndirectCommandRead | vk::AccessFlagBits::eShaderRead |
+                          vk::AccessFlagBits::eTransferRead);
+    cmd.pipelineBarrier(
+        vk::PipelineStageFlagBits::eComputeShader,
+        vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eVertexShader |
+            vk::PipelineStageFlagBits::eTransfer,
+        {}, culled, {}, {});
+
+    cmd.copyBuffer(m_state_buffer, m_readback_buffer,
+                   vk::BufferCopy(0, slot * sizeof(GPUCullState), sizeof(GPUCullState)));
+    auto readback = vk::MemoryBarrier()
+        .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eHostRead);
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eHost,
+                        {}, readback, {}, {});
+
+    m_slots[slot] = Slot{
+        .pending = true,
+        .instance_count = particle_count,
+        .lod_count = static_cast<uint32_t>(lods.size())
+    };
+    return true;
+}
+
+void OcclusionCuller::record_draw(vk::CommandBuffer cmd, vk::PipelineLayout layout, uint32_t lod) const {
+    cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, layout, 1, m_draw_set, {});
+    cmd.drawIndexedIndirect(m_state_buffer, offsetof(GPUCullState, draws) + lod * sizeof(GPULodDraw), 1,
+                            sizeof(GPULodDraw));
+}
+
+} // namespace ifs
@@ -0,0 +1,370 @@
+#include <ifs/OffscreenTarget.hpp>
+#include <ifs/Logger.hpp>
+#include <algorithm>
+#include <format>
+
+namespace ifs {
+
+namespace {
+
+vk::Format find_depth_format(vk::PhysicalDevice physical_device) {
+    for (auto format : {vk::Format::eD32Sfloat, vk::Format::eD32SfloatS8Uint, vk::Format::eD24UnormS8Uint}) {
+        auto props = physical_device.getFormatProperties(format);
+        if (props.optimalTilingFeatures & vk::FormatFeatureFlagBits::eDepthStencilAttachment) {
+            return format;
+        }
+    }
+    return vk::Format::eUndefined;
+}
+
+} // anonymous namespace
+
+OffscreenTarget::OffscreenTarget(const VulkanContext& context, const vk::Extent2D& extent)
+    : m_context(&context)
+    , m_device(context.device())
+    , m_extent(extent)
+    , m_render_pass(nullptr)
+    , m_color_image(nullptr)
+    , m_color_memory(nullptr)
+    , m_color_view(nullptr)
+    , m_depth_image(nullptr)
+    , m_depth_memory(nullptr)
+    , m_depth_view(nullptr)
+    , m_framebuffer(nullptr)
+{}
+
+std::expected<std::unique_ptr<OffscreenTarget>, std::string> OffscreenTarget::create(
+    const VulkanContext& context,
+    const vk::Extent2D& extent,
+    uint32_t readback_slots
+) {
+    if (extent.width == 0 || extent.height == 0) {
+        return std::unexpected("Offscreen target extent must be non-zero");
+    }
+
+    auto target = std::unique_ptr<OffscreenTarget>(new OffscreenTarget(context, extent));
+
+    target->m_depth_format = find_depth_format(context.physical_device());
+    if (target->m_depth_format == vk::Format::eUndefined) {
+        return std::unexpected("No supported depth format");
+    }
+
+    if (auto result = target->create_render_pass(); !result) {
+        return std::unexpected(result.error());
+    }
+    if (auto result = target->create_images(); !result) {
+        return std::unexpected(result.error());
+    }
+    if (auto result = target->create_readbacks(std::max(readback_slots, 1u)); !result) {
+        return std::unexpected(result.error());
+    }
+
+    Logger::instance().info("Created offscreen target {}x{} with {} readback slot(s)",
+        extent.width, extent.height, target->m_readbacks.size());
+    return target;
+}
+
+OffscreenTarget::~OffscreenTarget() {
+    for (auto& readback : m_readbacks) {
+        if (readback.memory) {
+            if (readback.mapped) {
+                m_device.unmapMemory(readback.memory);
+            }
+            m_device.freeMemory(readback.memory);
+        }
+        if (readback.buffer) {
+            m_device.destroyBuffer(readback.buffer);
+        }
+    }
+
+    if (m_framebuffer) m_device.destroyFramebuffer(m_framebuffer);
+    if (m_depth_view) m_device.destroyImageView(m_depth_view);
+    if (m_depth_image) m_device.destroyImage(m_depth_image);
+    if (m_depth_memory) m_device.freeMemory(m_depth_memory);
+    if (m_color_view) m_device.destroyImageView(m_color_view);
+    if (m_color_image) m_device.destroyImage(m_color_image);
+    if (m_color_memory) m_device.freeMemory(m_color_memory);
+    if (m_render_pass) m_device.destroyRenderPass(m_render_pass);
+}
+
+std::expected<void, std::string> OffscreenTarget::create_render_pass() {
+    auto color_attachment = vk::AttachmentDescription()
+        .setFormat(COLOR_FORMAT)
+        .setSamples(vk::SampleCountFlagBits::e1)
+        .setLoadOp(vk::AttachmentLoadOp::eClear)
+        .setStoreOp(vk::AttachmentStoreOp::eStore)
+        .setStencilLoadOp(vk::AttachmentLoadOp::eDontCare)
+        .setStencilStoreOp(vk::AttachmentStoreOp::eDontCare)
+        .setInitialLayout(vk::ImageLayout::eUndefined)
+        .setFinalLayout(vk::ImageLayout::eTransferSrcOptimal);  // Ready for readback
+
+    auto depth_attachment = vk::AttachmentDescription()
+        .setFormat(m_depth_format)
+        .setSamples(vk::SampleCountFlagBits::e1)
+        .setLoadOp(vk::AttachmentLoadOp::eClear)
+        .setStoreOp(vk::AttachmentStoreOp::eDontCare)
+        .setStencilLoadOp(vk::AttachmentLoadOp::eDontCare)
+        .setStencilStoreOp(vk::AttachmentStoreOp::eDontCare)
+        .setInitialLayout(vk::ImageLayout::eUndefined)
+        .setFinalLayout(vk::ImageLayout::eDepthStencilAttachmentOptimal);
+
+    auto color_ref = vk::AttachmentReference()
+        .setAttachment(0)
+        .setLayout(vk::ImageLayout::eColorAttachmentOptimal);
+
+    auto depth_ref = vk::AttachmentReference()
+        .setAttachment(1)
+        .setLayout(vk::ImageLayout::eDepthStencilAttachmentOptimal);
+
+    auto subpass = vk::SubpassDescription()
+        .setPipelineBindPoint(vk::PipelineBindPoint::eGraphics)
+        .setColorAttachments(color_ref)
+        .setPDepthStencilAttachment(&depth_ref);
+
+    // Same dependencies as the window's render pass, so the passes are compatible
+    auto dependency = vk::SubpassDependency()
+        .setSrcSubpass(VK_SUBPASS_EXTERNAL)
+        .setDstSubpass(0)
+        .setSrcStageMask(
+            vk::PipelineStageFlagBits::eColorAttachmentOutput |
+            vk::PipelineStageFlagBits::eEarlyFragmentTests)
+        .setDstStageMask(
+            vk::PipelineStageFlagBits::eColorAttachmentOutput |
+            vk::PipelineStageFlagBits::eEarlyFragmentTests)
+        .setDstAccessMask(
+            vk::AccessFlagBits::eColorAttachmentWrite |
+            vk::AccessFlagBits::eDepthStencilAttachmentWrite);
+
+    auto self_dependency = vk::SubpassDependency()
+        .setSrcSubpass(0)
+        .setDstSubpass(0)
+        .setSrcStageMask(vk::PipelineStageFlagBits::eFragmentShader)
+        .setDstStageMask(vk::PipelineStageFlagBits::eFragmentShader)
+        .setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eShaderRead)
+        .setDependencyFlags(vk::DependencyFlagBits::eByRegion);
+
+    std::array dependencies = {dependency, self_dependency};
+    std::array attachments = {color_attachment, depth_attachment};
+
+    auto render_pass_info = vk::RenderPassCreateInfo()
+        .setAttachments(attachments)
+        .setSubpasses(subpass)
+        .setDependencies(dependencies);
+
+	auto render_pass_res = m_device.createRenderPass(render_pass_info);
+	if (render_pass_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create offscreen render pass: {}", to_string(render_pass_res.result)));
+	}
+	m_render_pass = render_pass_res.value;
+
+    return {};
+}
+
+std::expected<vk::DeviceMemory, std::string> OffscreenTarget::allocate(
+    const vk::MemoryRequirements& requirements,
+    vk::MemoryPropertyFlags preferred,
+    vk::MemoryPropertyFlags required
+) {
+    auto memory_type = m_context->find_memory_type(requirements.memoryTypeBits, preferred);
+    if (!memory_type) {
+        memory_type = m_context->find_memory_type(requirements.memoryTypeBits, required);
+    }
+    if (!memory_type) {
+        return std::unexpected("Failed to find suitable memory type for offscreen target");
+    }
+
+    auto alloc_info = vk::MemoryAllocateInfo()
+        .setAllocationSize(requirements.size)
+        .setMemoryTypeIndex(*memory_type);
+
+	auto alloc_res = m_device.allocateMemory(alloc_info);
+	if (alloc_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to allocate offscreen memory: {}", to_string(alloc_res.result)));
+	}
+
+    if (required & vk::MemoryPropertyFlagBits::eHostVisible) {
+        auto mem_props = m_context->physical_device().getMemoryProperties();
+        m_readback_coherent = static_cast<bool>(
+            mem_props.memoryTypes[*memory_type].propertyFlags & vk::MemoryPropertyFlagBits::eHostCoherent);
+    }
+    return alloc_res.value;
+}
+
+std::expected<void, std::string> OffscreenTarget::create_images() {
+    struct Attachment {
+        vk::Format format;
+        vk::ImageUsageFlags usage;
+        vk::ImageAspectFlags aspect;
+        vk::Image* image;
+        vk::DeviceMemory* memory;
+        vk::ImageView* view;
+    };
+    std::array attachments = {
+        Attachment{COLOR_FORMAT, vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc,
+                   vk::ImageAspectFlagBits::eColor, &m_color_image, &m_color_memory, &m_color_view},
+        Attachment{m_depth_format, vk::ImageUsageFlagBits::eDepthStencilAttachment,
+                   vk::ImageAspectFlagBits::eDepth, &m_depth_image, &m_depth_memory, &m_depth_view}
+    };
+
+    for (auto& attachment : attachments) {
+        auto image_info = vk::ImageCreateInfo()
+            .setImageType(vk::ImageType::e2D)
+            .setFormat(attachment.format)
+            .setExtent(vk::Extent3D(m_extent.width, m_extent.height, 1))
+            .setMipLevels(1)
+            .setArrayLayers(1)
+            .setSamples(vk::SampleCountFlagBits::e1)
+            .setTiling(vk::ImageTiling::eOptimal)
+            .setUsage(attachment.usage)
+            .setSharingMode(vk::SharingMode::eExclusive)
+            .setInitialLayout(vk::ImageLayout::eUndefined);
+
+		auto image_res = m_device.createImage(image_info);
+		if (image_res.result != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Failed to create offscreen image: {}", to_string(image_res.result)));
+		}
+		*attachment.image = image_res.value;
+
+        auto memory = allocate(m_device.getImageMemoryRequirements(*attachment.image),
+            vk::MemoryPropertyFlagBits::eDeviceLocal, {});
+        if (!memory) {
+            return std::unexpected(memory.error());
+        }
+        *attachment.memory = *memory;
+
+		auto bind_res = m_device.bindImageMemory(*attachment.image, *attachment.memory, 0);
+		if (bind_res != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Failed to bind offscreen image memory: {}", to_string(bind_res)));
+		}
+
+        auto view_info = vk::ImageViewCreateInfo()
+            .setImage(*attachment.image)
+            .setViewType(vk::ImageViewType::e2D)
+            .setFormat(attachment.format)
+            .setSubresourceRange(vk::ImageSubresourceRange(attachment.aspect, 0, 1, 0, 1));
+
+		auto view_res = m_device.createImageView(view_info);
+		if (view_res.result != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Failed to create offscreen image view: {}", to_string(view_res.result)));
+		}
+		*attachment.view = view_res.value;
+    }
+
+    std::array views = {m_color_view, m_depth_view};
+    auto framebuffer_info = vk::FramebufferCreateInfo()
+        .setRenderPass(m_render_pass)
+        .setAttachments(views)
+        .setWidth(m_extent.width)
+        .setHeight(m_extent.height)
+        .setLayers(1);
+
+	auto framebuffer_res = m_device.createFramebuffer(framebuffer_info);
+	if (framebuffer_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create offscreen framebuffer: {}", to_string(framebuffer_res.result)));
+	}
+	m_framebuffer = framebuffer_res.value;
+
+    return {};
+}
+
+std::expected<void, std::string> OffscreenTarget::create_readbacks(uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        auto& readback = m_readbacks.emplace_back();
+
+        auto buffer_info = vk::BufferCreateInfo()
+            .setSize(image_size())
+            .setUsage(vk::BufferUsageFlagBits::eTransferDst)
+            .setSharingMode(vk::SharingMode::eExclusive);
+
+		auto buffer_res = m_device.createBuffer(buffer_info);
+		if (buffer_res.result != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Failed to create readback buffer: {}", to_string(buffer_res.result)));
+		}
+		readback.buffer = buffer_res.value;
+
+        // Cached memory makes the CPU-side reads (encoding, statistics) much faster
+        auto memory = allocate(m_device.getBufferMemoryRequirements(readback.buffer),
+            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCached,
+            vk::MemoryPropertyFlagBits::eHostVisible);
+        if (!memory) {
+            return std::unexpected(memory.error());
+        }
+        readback.memory = *memory;
+
+		auto bind_res = m_device.bindBufferMemory(readback.buffer, readback.memory, 0);
+		if (bind_res != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Failed to bind readback memory: {}", to_string(bind_res)));
+		}
+
+		auto map_res = m_device.mapMemory(readback.memory, 0, VK_WHOLE_SIZE);
+		if (map_res.result != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Failed to map readback memory: {}", to_string(map_res.result)));
+		}
+		readback.mapped = map_res.value;
+    }
+    return {};
+}
+
+std::array<vk::ClearValue, 2> OffscreenTarget::clear_values() const {
+    return {
+        vk::ClearColorValue(std::array<float, 4>{0.0f, 0.0f, 0.0f, 1.0f}),
+        vk::ClearDepthStencilValue(1.0f, 0)
+    };
+}
+
+void OffscreenTarget::record_readback(vk::CommandBuffer cmd, uint32_t slot) const {
+    auto region = vk::BufferImageCopy()
+        .setBufferOffset(0)
+        .setBufferRowLength(0)  // Tightly packed
+        .setBufferImageHeight(0)
+        .setImageSubresource(vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, 1))
+        .setImageExtent(vk::Extent3D(m_extent.width, m_extent.height, 1));
+
+    // The render pass leaves the image in eTransferSrcOptimal but has no
+    // outgoing dependency, so the attachment writes are made visible here
+    auto to_transfer = vk::MemoryBarrier()
+        .setSrcAccessMask(vk::AccessFlagBits::eColorAttachmentWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eTransferRead);
+    cmd.pipelineBarrier(
+        vk::PipelineStageFlagBits::eColorAttachmentOutput,
+        vk::PipelineStageFlagBits::eTransfer,
+        {},
+        to_transfer,
+        {},
+        {}
+    );
+
+    cmd.copyImageToBuffer(m_color_image, vk::ImageLayout::eTransferSrcOptimal, m_readbacks[slot].buffer, region);
+
+    auto to_host = vk::MemoryBarrier()
+        .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eHostRead);
+    cmd.pipelineBarrier(
+        vk::PipelineStageFlagBits::eTransfer,
+        vk::PipelineStageFlagBits::eHost,
+        {},
+        to_host,
+        {},
+        {}
+    );
+}
+
+const uint8_t* OffscreenTarget::pixels(uint32_t slot) const {
+    const auto& readback = m_readbacks[slot];
+    if (!m_readback_coherent) {
+        auto _ = m_device.invalidateMappedMemoryRanges(vk::MappedMemoryRange(readback.memory, 0, VK_WHOLE_SIZE));
+    }
+    return static_cast<const uint8_t*>(readback.mapped);
+}
+
+} // namespace ifs
@@ -1,6 +1,9 @@
 #include <ifs/ParticleBuffer.hpp>
 #include <ifs/Logger.hpp>
+#include <ifs/Metrics.hpp>
+#include <atomic>
 #include <format>
+#include <unistd.h>
 
 namespace ifs {
 
@@ -16,6 +19,7 @@ ParticleBuffer::ParticleBuffer(
     , m_memory(nullptr)
     , m_particle_count(config.particle_count)
     , m_buffer_size(config.particle_count * sizeof(Particle))
+    , m_external(config.exportable || context.export_particle_buffers())
 {}
 
 std::expected<ParticleBuffer, std::string> ParticleBuffer::create(
@@ -36,6 +40,32 @@ std::expected<ParticleBuffer, std::string> ParticleBuffer::create(
     return buffer;
 }
 
+std::expected<ParticleBuffer, std::string> ParticleBuffer::import_fd(
+    const VulkanContext& context,
+    vk::Device device,
+    const ParticleBufferConfig& config,
+    int fd,
+    vk::DeviceSize allocation_size
+) {
+    if (!context.has_external_fd()) {
+        close(fd);
+        return std::unexpected("Importing memory needs VK_KHR_external_memory_fd");
+    }
+
+    ParticleBuffer buffer(context, device, config);
+    buffer.m_external = true;
+    buffer.m_imported = true;
+    if (auto result = buffer.create_buffer(fd, allocation_size); !result) {
+        return std::unexpected(result.error());
+    }
+
+    Logger::instance().info("Imported particle buffer: {} particles ({} MB)",
+        config.particle_count,
+        buffer.m_buffer_size / (1024.0 * 1024.0));
+
+    return buffer;
+}
+
 ParticleBuffer::~ParticleBuffer() {
     destroy_buffer();
 }
@@ -48,6 +78,10 @@ ParticleBuffer::ParticleBuffer(ParticleBuffer&& other) noexcept
     , m_memory(other.m_memory)
     , m_particle_count(other.m_particle_count)
     , m_buffer_size(other.m_buffer_size)
+    , m_allocation_size(other.m_allocation_size)
+    , m_allocation_id(other.m_allocation_id)
+    , m_external(other.m_external)
+    , m_imported(other.m_imported)
 {
     other.m_buffer = nullptr;
     other.m_memory = nullptr;
@@ -64,6 +98,10 @@ ParticleBuffer& ParticleBuffer::operator=(ParticleBuffer&& other) noexcept {
         m_memory = other.m_memory;
         m_particle_count = other.m_particle_count;
         m_buffer_size = other.m_buffer_size;
+        m_allocation_size = other.m_allocation_size;
+        m_allocation_id = other.m_allocation_id;
+        m_external = other.m_external;
+        m_imported = other.m_imported;
 
         other.m_buffer = nullptr;
         other.m_memory = nullptr;
@@ -71,48 +109,90 @@ ParticleBuffer& ParticleBuffer::operator=(ParticleBuffer&& other) noexcept {
     return *this;
 }
 
-std::expected<void, std::string> ParticleBuffer::create_buffer() {
+std::expected<void, std::string> ParticleBuffer::create_buffer(int import_fd, vk::DeviceSize import_size) {
+    // An fd that was not handed to Vulkan is ours to close
+    auto fail = [&](std::string error) -> std::expected<void, std::string> {
+        if (import_fd >= 0) {
+            close(import_fd);
+        }
+        return std::unexpected(std::move(error));
+    };
+
     // Create device-local buffer
+    constexpr auto handle_type = vk::ExternalMemoryHandleTypeFlagBits::eOpaqueFd;
+    auto external_info = vk::ExternalMemoryBufferCreateInfo().setHandleTypes(handle_type);
     auto buffer_info = vk::BufferCreateInfo()
         .setSize(m_buffer_size)
         .setUsage(vk::BufferUsageFlagBits::eStorageBuffer |
                   vk::BufferUsageFlagBits::eVertexBuffer |
                   vk::BufferUsageFlagBits::eTransferDst |
+                  vk::BufferUsageFlagBits::eTransferSrc |
                   m_config.additional_usage_flags)
         .setSharingMode(vk::SharingMode::eExclusive);
+    if (m_external) {
+        buffer_info.setPNext(&external_info);
+    }
 
 	auto buffer_res = m_device.createBuffer(buffer_info);
 	if (buffer_res.result != vk::Result::eSuccess)
 	{
-		return std::unexpected(std::format("Failed to create buffer: {}", to_string(buffer_res.result)));
+		return fail(std::format("Failed to create buffer: {}", to_string(buffer_res.result)));
 	}
 	m_buffer = buffer_res.value;
 
     // Allocate device-local memory
     auto mem_reqs = m_device.getBufferMemoryRequirements(m_buffer);
+    if (import_fd >= 0 && import_size < mem_reqs.size) {
+        m_device.destroyBuffer(m_buffer);
+        m_buffer = nullptr;
+        return fail(std::format("Imported memory is {} bytes, the buffer needs {}", import_size, mem_reqs.size));
+    }
 
-    auto memory_type_result = find_memory_type(
+    auto memory_type_result = m_context->find_memory_type(
         mem_reqs.memoryTypeBits,
         vk::MemoryPropertyFlagBits::eDeviceLocal
     );
     if (!memory_type_result) {
         m_device.destroyBuffer(m_buffer);
         m_buffer = nullptr;
-        return std::unexpected(memory_type_result.error());
+        return fail("Failed to find suitable memory type");
     }
 
+    // External memory is a dedicated allocation on both sides, as drivers may require for opaque fds
+    m_allocation_size = import_fd >= 0 ? import_size : mem_reqs.size;
+    auto dedicated_info = vk::MemoryDedicatedAllocateInfo().setBuffer(m_buffer);
+    auto export_info = vk::ExportMemoryAllocateInfo().setHandleTypes(handle_type);
+    auto import_info = vk::ImportMemoryFdInfoKHR().setHandleType(handle_type).setFd(import_fd);
     auto alloc_info = vk::MemoryAllocateInfo()
-        .setAllocationSize(mem_reqs.size)
+        .setAllocationSize(m_allocation_size)
         .setMemoryTypeIndex(*memory_type_result);
+    if (m_external) {
+        dedicated_info.setPNext(import_fd >= 0 ? static_cast<const void*>(&import_info) : static_cast<const void*>(&export_info));
+        alloc_info.setPNext(&dedicated_info);
+    }
 
 	auto alloc_res = m_device.allocateMemory(alloc_info);
 	if (alloc_res.result != vk::Result::eSuccess)
 	{
 		m_device.destroyBuffer(m_buffer);
 		m_buffer = nullptr;
-		return std::unexpected(std::format("Failed to allocate memory: {}", to_string(alloc_res.result)));
+		return fail(std::format("Failed to allocate memory: {}", to_string(alloc_res.result)));
 	}
 	m_memory = alloc_res.value;
+	import_fd = -1;  // Owned by the memory now
+
+	static std::atomic<uint64_t> next_allocation_id{1};
+	m_allocation_id = next_allocation_id++;
+
+	static auto& allocations = MetricsRegistry::instance().counter(
+		"ifs_particle_buffer_allocations_total", "Particle buffer device memory allocations");
+	static auto& allocated_bytes = MetricsRegistry::instance().counter(
+		"ifs_particle_buffer_allocated_bytes_total", "Bytes allocated for particle buffers");
+	if (!m_imported) {
+		allocations.add();
+		allocated_bytes.add(static_cast<double>(mem_reqs.size));
+	}
+
 	auto bind_res = m_device.bindBufferMemory(m_buffer, m_memory, 0);
 	if (bind_res != vk::Result::eSuccess)
 	{
@@ -135,23 +215,24 @@ void ParticleBuffer::destroy_buffer() {
     }
 }
 
-std::expected<uint32_t, std::string> ParticleBuffer::find_memory_type(
-    uint32_t type_filter,
-    vk::MemoryPropertyFlags properties
-) const {
-    auto mem_props = m_context->physical_device().getMemoryProperties();
-
-    for (uint32_t i = 0; i < mem_props.memoryTypeCount; i++) {
-        if ((type_filter & (1 << i)) &&
-            (mem_props.memoryTypes[i].propertyFlags & properties) == properties) {
-            return i;
-        }
+std::expected<int, std::string> ParticleBuffer::export_fd() const {
+    if (!m_external || !m_memory) {
+        return std::unexpected("Particle buffer memory is not exportable");
     }
-
-    return std::unexpected("Failed to find suitable memory type");
+    auto fd_res = m_device.getMemoryFdKHR(vk::MemoryGetFdInfoKHR()
+        .setMemory(m_memory)
+        .setHandleType(vk::ExternalMemoryHandleTypeFlagBits::eOpaqueFd));
+	if (fd_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to export particle memory: {}", to_string(fd_res.result)));
+	}
+    return fd_res.value;
 }
 
 std::expected<void, std::string> ParticleBuffer::resize(uint32_t new_particle_count) {
+    if (m_imported) {
+        return std::unexpected("Imported particle buffers are resized by their exporter");
+    }
     Logger::instance().info("Resizing particle buffer: {} -> {} particles",
         m_particle_count, new_particle_count);
 
@@ -0,0 +1,565 @@
+#include <ifs/ParticleShare.hpp>
+#include <ifs/Logger.hpp>
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <span>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace ifs {
+
+namespace {
+
+constexpr uint32_t SHARE_MAGIC = 0x50534649;  // "IFSP"
+constexpr uint32_t SHARE_VERSION = 1;
+constexpr size_t SHARE_FD_COUNT = 3;         // Memory, `written`, the client's `reading`
+
+/**
+ * @brief Sent with every buffer; the descriptors travel as SCM_RIGHTS
+ */
+struct ShareMessage {
+    uint32_t magic = SHARE_MAGIC;
+    uint32_t version = SHARE_VERSION;
+    std::array<uint8_t, VK_UUID_SIZE> device_uuid{};
+    std::array<uint8_t, VK_UUID_SIZE> driver_uuid{};
+    uint64_t buffer_id = 0;
+    uint64_t allocation_size = 0;
+    uint32_t particle_count = 0;
+    uint32_t particle_size = sizeof(Particle);
+    uint32_t additional_usage = 0;  ///< ParticleBuffer::additional_usage_flags()
+};
+
+std::string errno_string() {
+    return std::strerror(errno);
+}
+
+void close_fds(std::span<const int> fds) {
+    for (int fd : fds) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+}
+
+std::expected<sockaddr_un, std::string> socket_address(const std::filesystem::path& path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    const std::string native = path.string();
+    if (native.empty() || native.size() >= sizeof(address.sun_path)) {
+        return std::unexpected(std::format("Socket path '{}' must be 1 to {} characters", native, sizeof(address.sun_path) - 1));
+    }
+    std::memcpy(address.sun_path, native.c_str(), native.size() + 1);
+    return address;
+}
+
+bool send_message(int socket, const ShareMessage& message, std::span<const int, SHARE_FD_COUNT> fds) {
+    iovec io{.iov_base = const_cast<ShareMessage*>(&message), .iov_len = sizeof(message)};
+    alignas(cmsghdr) std::array<char, CMSG_SPACE(sizeof(int) * SHARE_FD_COUNT)> control{};
+
+    msghdr header{};
+    header.msg_iov = &io;
+    header.msg_iovlen = 1;
+    header.msg_control = control.data();
+    header.msg_controllen = control.size();
+
+    cmsghdr* rights = CMSG_FIRSTHDR(&header);
+    rights->cmsg_level = SOL_SOCKET;
+    rights->cmsg_type = SCM_RIGHTS;
+    rights->cmsg_len = CMSG_LEN(sizeof(int) * SHARE_FD_COUNT);
+    std::memcpy(CMSG_DATA(rights), fds.data(), sizeof(int) * SHARE_FD_COUNT);
+
+    // The receiver gets duplicates; ours stay open for the next client
+    return sendmsg(socket, &header, MSG_NOSIGNAL) == static_cast<ssize_t>(sizeof(message));
+}
+
+/**
+ * @return Bytes received (0: peer closed, -1: errno), with any received descriptors in `fds`
+ */
+ssize_t receive_message(int socket, ShareMessage& message, std::array<int, SHARE_FD_COUNT>& fds, bool block) {
+    fds.fill(-1);
+    iovec io{.iov_base = &message, .iov_len = sizeof(message)};
+    alignas(cmsghdr) std::array<char, CMSG_SPACE(sizeof(int) * SHARE_FD_COUNT)> control{};
+
+    msghdr header{};
+    header.msg_iov = &io;
+    header.msg_iovlen = 1;
+    header.msg_control = control.data();
+    header.msg_controllen = control.size();
+
+    const ssize_t received = recvmsg(socket, &header, MSG_CMSG_CLOEXEC | (block ? 0 : MSG_DONTWAIT));
+    if (received <= 0) {
+        return received;
+    }
+    for (cmsghdr* rights = CMSG_FIRSTHDR(&header); rights; rights = CMSG_NXTHDR(&header, rights)) {
+        if (rights->cmsg_level == SOL_SOCKET && rights->cmsg_type == SCM_RIGHTS) {
+            const size_t count = std::min<size_t>((rights->cmsg_len - CMSG_LEN(0)) / sizeof(int), SHARE_FD_COUNT);
+            std::memcpy(fds.data(), CMSG_DATA(rights), count * sizeof(int));
+        }
+    }
+    return received;
+}
+
+std::expected<vk::Semaphore, std::string> create_timeline(vk::Device device, bool exportable) {
+    auto export_info = vk::ExportSemaphoreCreateInfo()
+        .setHandleTypes(vk::ExternalSemaphoreHandleTypeFlagBits::eOpaqueFd);
+    auto type_info = vk::SemaphoreTypeCreateInfo()
+        .setSemaphoreType(vk::SemaphoreType::eTimeline)
+        .setInitialValue(0);
+    if (exportable) {
+        type_info.setPNext(&export_info);
+    }
+
+	auto semaphore_res = device.createSemaphore(vk::SemaphoreCreateInfo().setPNext(&type_info));
+	if (semaphore_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create timeline semaphore: {}", to_string(semaphore_res.result)));
+	}
+    return semaphore_res.value;
+}
+
+std::expected<int, std::string> export_semaphore(vk::Device device, vk::Semaphore semaphore) {
+	auto fd_res = device.getSemaphoreFdKHR(vk::SemaphoreGetFdInfoKHR()
+		.setSemaphore(semaphore)
+		.setHandleType(vk::ExternalSemaphoreHandleTypeFlagBits::eOpaqueFd));
+	if (fd_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to export semaphore: {}", to_string(fd_res.result)));
+	}
+    return fd_res.value;
+}
+
+/// Timeline semaphore sharing the payload behind `fd` (consumed, also on failure)
+std::expected<vk::Semaphore, std::string> import_semaphore(vk::Device device, int fd) {
+    auto semaphore = create_timeline(device, false);
+    if (!semaphore) {
+        close(fd);
+        return semaphore;
+    }
+	auto import_res = device.importSemaphoreFdKHR(vk::ImportSemaphoreFdInfoKHR()
+		.setSemaphore(*semaphore)
+		.setHandleType(vk::ExternalSemaphoreHandleTypeFlagBits::eOpaqueFd)
+		.setFd(fd));
+	if (import_res != vk::Result::eSuccess)
+	{
+		close(fd);
+		device.destroySemaphore(*semaphore);
+		return std::unexpected(std::format("Failed to import semaphore: {}", to_string(import_res)));
+	}
+    return semaphore;
+}
+
+uint64_t counter_value(vk::Device device, vk::Semaphore semaphore) {
+    auto value_res = device.getSemaphoreCounterValue(semaphore);
+    return value_res.result == vk::Result::eSuccess ? value_res.value : 0;
+}
+
+void host_signal(vk::Device device, vk::Semaphore semaphore, uint64_t value) {
+    auto _ = device.signalSemaphore(vk::SemaphoreSignalInfo().setSemaphore(semaphore).setValue(value));
+}
+
+/// Whether `semaphore` reached `value` within the timeout
+bool host_wait(vk::Device device, vk::Semaphore semaphore, uint64_t value, uint64_t timeout_ns) {
+    auto wait_info = vk::SemaphoreWaitInfo().setSemaphores(semaphore).setValues(value);
+    return device.waitSemaphores(wait_info, timeout_ns) == vk::Result::eSuccess;
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// ParticleShareServer
+// ============================================================================
+
+ParticleShareServer::ParticleShareServer(const VulkanContext& context, std::filesystem::path socket_path)
+    : m_context(&context)
+    , m_device(context.device())
+    , m_socket_path(std::move(socket_path))
+{}
+
+std::expected<std::unique_ptr<ParticleShareServer>, std::string> ParticleShareServer::create(
+    const VulkanContext& context,
+    std::filesystem::path socket_path
+) {
+    if (!context.has_external_fd()) {
+        return std::unexpected("Sharing particles needs VK_KHR_external_memory_fd, VK_KHR_external_semaphore_fd and timeline semaphores");
+    }
+
+    auto server = std::unique_ptr<ParticleShareServer>(new ParticleShareServer(context, std::move(socket_path)));
+
+    auto written = create_timeline(server->m_device, true);
+    if (!written) {
+        return std::unexpected(written.error());
+    }
+    server->m_written = *written;
+    auto written_fd = export_semaphore(server->m_device, server->m_written);
+    if (!written_fd) {
+        return std::unexpected(written_fd.error());
+    }
+    server->m_written_fd = *written_fd;
+
+    if (auto result = server->listen(); !result) {
+        return std::unexpected(result.error());
+    }
+
+    Logger::instance().info("Sharing particles on {}", server->m_socket_path.string());
+    return server;
+}
+
+ParticleShareServer::~ParticleShareServer() {
+    while (!m_clients.empty()) {
+        drop_client(m_clients.size() - 1);
+    }
+    if (m_listen_socket >= 0) {
+        close(m_listen_socket);
+    }
+    if (m_created_socket_file) {
+        std::error_code ignored;
+        std::filesystem::remove(m_socket_path, ignored);
+    }
+    close_fds(std::array{m_memory_fd, m_written_fd});
+    if (m_written) {
+        m_device.destroySemaphore(m_written);
+    }
+}
+
+std::expected<void, std::string> ParticleShareServer::listen() {
+    auto address = socket_address(m_socket_path);
+    if (!address) {
+        return std::unexpected(address.error());
+    }
+
+    m_listen_socket = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (m_listen_socket < 0) {
+        return std::unexpected(std::format("Failed to create socket: {}", errno_string()));
+    }
+
+    // A socket file left behind by a previous run would make bind() fail; never
+    // remove anything else a mistyped path points at
+    std::error_code status_error;
+    const auto status = std::filesystem::symlink_status(m_socket_path, status_error);
+    if (std::filesystem::is_socket(status)) {
+        unlink(address->sun_path);
+    } else if (std::filesystem::exists(status)) {
+        close(m_listen_socket);
+        m_listen_socket = -1;
+        return std::unexpected(std::format("{} exists and is not a socket", m_socket_path.string()));
+    }
+
+    if (bind(m_listen_socket, reinterpret_cast<const sockaddr*>(&*address), sizeof(*address)) == 0) {
+        m_created_socket_file = true;
+        if (::listen(m_listen_socket, 8) == 0) {
+            return {};
+        }
+    }
+    auto error = std::format("Failed to listen on {}: {}", m_socket_path.string(), errno_string());
+    close(m_listen_socket);
+    m_listen_socket = -1;
+    return std::unexpected(error);
+}
+
+std::expected<void, std::string> ParticleShareServer::publish(const ParticleBuffer& buffer) {
+    // Not the handle: a reallocation may get the freed buffer's handle back
+    if (buffer.allocation_id() == m_allocation_id) {
+        return {};
+    }
+
+    auto memory_fd = buffer.export_fd();
+    if (!memory_fd) {
+        return std::unexpected(memory_fd.error());
+    }
+    close_fds(std::array{m_memory_fd});
+    m_memory_fd = *memory_fd;
+    m_allocation_id = buffer.allocation_id();
+    m_particle_count = buffer.particle_count();
+    m_allocation_size = buffer.allocation_size();
+    m_additional_usage = buffer.additional_usage_flags();
+    m_buffer_id++;
+
+    for (size_t i = m_clients.size(); i-- > 0;) {
+        if (!send_buffer(m_clients[i])) {
+            Logger::instance().warn("Particle share client disconnected: {}", errno_string());
+            drop_client(i);
+        }
+    }
+    return {};
+}
+
+bool ParticleShareServer::send_buffer(const Client& client) const {
+    ShareMessage message{
+        .device_uuid = m_context->device_uuid(),
+        .driver_uuid = m_context->driver_uuid(),
+        .buffer_id = m_buffer_id,
+        .allocation_size = m_allocation_size,
+        .particle_count = m_particle_count,
+        .additional_usage = static_cast<uint32_t>(m_additional_usage)
+    };
+    const std::array fds{m_memory_fd, m_written_fd, client.reading_fd};
+    return send_message(client.socket, message, fds);
+}
+
+void ParticleShareServer::poll() {
+    for (;;) {
+        const int socket = accept4(m_listen_socket, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (socket < 0) {
+            break;  // EAGAIN: nobody waiting
+        }
+
+        Client client{.socket = socket};
+        auto reading = create_timeline(m_device, true);
+        if (!reading) {
+            Logger::instance().error("Particle share client rejected: {}", reading.error());
+            close(socket);
+            continue;
+        }
+        auto reading_fd = export_semaphore(m_device, *reading);
+        if (!reading_fd) {
+            Logger::instance().error("Particle share client rejected: {}", reading_fd.error());
+            m_device.destroySemaphore(*reading);
+            close(socket);
+            continue;
+        }
+        client.reading = *reading;
+        client.reading_fd = *reading_fd;
+        m_clients.push_back(client);
+        Logger::instance().info("Particle share client connected ({} total)", m_clients.size());
+
+        if (m_memory_fd >= 0 && !send_buffer(client)) {
+            drop_client(m_clients.size() - 1);
+        }
+    }
+
+    // Clients never send, so a readable socket means it was closed
+    for (size_t i = m_clients.size(); i-- > 0;) {
+        char byte;
+        if (recv(m_clients[i].socket, &byte, 1, MSG_DONTWAIT | MSG_PEEK) == 0) {
+            Logger::instance().info("Particle share client disconnected");
+            drop_client(i);
+        }
+    }
+}
+
+void ParticleShareServer::drop_client(size_t index) {
+    const auto& client = m_clients[index];
+    close_fds(std::array{client.socket, client.reading_fd});
+    if (client.reading) {
+        m_device.destroySemaphore(client.reading);
+    }
+    m_clients.erase(m_clients.begin() + static_cast<std::ptrdiff_t>(index));
+}
+
+void ParticleShareServer::begin_write(uint64_t timeout_ns) {
+    if (m_writing) {
+        return;
+    }
+    m_writing = true;
+    host_signal(m_device, m_written, 2 * m_generation + 1);
+
+    // Readers that started before the signal finish; later ones see it and back off
+    for (size_t i = m_clients.size(); i-- > 0;) {
+        const uint64_t reading = counter_value(m_device, m_clients[i].reading);
+        if (reading % 2 == 1 && !host_wait(m_device, m_clients[i].reading, reading + 1, timeout_ns)) {
+            Logger::instance().warn("Particle share client did not finish its read in time; dropping it");
+            drop_client(i);
+        }
+    }
+}
+
+void ParticleShareServer::end_write() {
+    if (!m_writing) {
+        return;
+    }
+    m_writing = false;
+    m_generation++;
+    host_signal(m_device, m_written, 2 * m_generation);
+}
+
+// ============================================================================
+// ParticleShareClient
+// ============================================================================
+
+ParticleShareClient::ParticleShareClient(const VulkanContext& context)
+    : m_context(&context)
+    , m_device(context.device())
+{}
+
+std::expected<std::unique_ptr<ParticleShareClient>, std::string> ParticleShareClient::connect(
+    const VulkanContext& context,
+    const std::filesystem::path& socket_path,
+    std::chrono::milliseconds timeout
+) {
+    if (!context.has_external_fd()) {
+        return std::unexpected("Importing particles needs VK_KHR_external_memory_fd, VK_KHR_external_semaphore_fd and timeline semaphores");
+    }
+    auto address = socket_address(socket_path);
+    if (!address) {
+        return std::unexpected(address.error());
+    }
+
+    auto client = std::unique_ptr<ParticleShareClient>(new ParticleShareClient(context));
+    client->m_socket = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (client->m_socket < 0) {
+        return std::unexpected(std::format("Failed to create socket: {}", errno_string()));
+    }
+    if (::connect(client->m_socket, reinterpret_cast<const sockaddr*>(&*address), sizeof(*address)) != 0) {
+        return std::unexpected(std::format("Failed to connect to {}: {}", socket_path.string(), errno_string()));
+    }
+
+    // The server sends the buffer from its next poll(), and only once it has computed one
+    timeval receive_timeout{
+        .tv_sec = static_cast<time_t>(timeout.count() / 1000),
+        .tv_usec = static_cast<suseconds_t>((timeout.count() % 1000) * 1000)
+    };
+    setsockopt(client->m_socket, SOL_SOCKET, SO_RCVTIMEO, &receive_timeout, sizeof(receive_timeout));
+    auto received = client->receive(true);
+    if (!received) {
+        return std::unexpected(received.error());
+    }
+    if (!*received) {
+        return std::unexpected(std::format("{} sent no particle buffer", socket_path.string()));
+    }
+    return client;
+}
+
+ParticleShareClient::~ParticleShareClient() {
+    if (m_in_read) {
+        end_read();
+    }
+    m_buffer.reset();
+    if (m_written) {
+        m_device.destroySemaphore(m_written);
+    }
+    if (m_reading) {
+        m_device.destroySemaphore(m_reading);
+    }
+    if (m_socket >= 0) {
+        close(m_socket);
+    }
+}
+
+std::expected<bool, std::string> ParticleShareClient::receive(bool block) {
+    ShareMessage message;
+    std::array<int, SHARE_FD_COUNT> fds;
+    const ssize_t received = receive_message(m_socket, message, fds, block);
+    if (received < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return false;
+        }
+        return std::unexpected(std::format("Failed to receive particle buffer: {}", errno_string()));
+    }
+    if (received == 0) {
+        close(m_socket);
+        m_socket = -1;
+        return false;
+    }
+
+    if (received != static_cast<ssize_t>(sizeof(message)) || message.magic != SHARE_MAGIC ||
+        message.version != SHARE_VERSION || message.particle_size != sizeof(Particle)) {
+        close_fds(fds);
+        return std::unexpected("Particle share message has an unknown format");
+    }
+    if (std::ranges::find(fds, -1) != fds.end()) {
+        close_fds(fds);
+        return std::unexpected("Particle share message arrived without its descriptors");
+    }
+    if (message.device_uuid != m_context->device_uuid() || message.driver_uuid != m_context->driver_uuid()) {
+        close_fds(fds);
+        return std::unexpected("The shared particles live on a different device or driver");
+    }
+
+    // The semaphores keep their payload when the buffer changes; import them once
+    if (!m_written) {
+        auto written = import_semaphore(m_device, fds[1]);
+        auto reading = import_semaphore(m_device, fds[2]);
+        if (!written || !reading) {
+            close_fds(std::array{fds[0]});
+            if (written) m_device.destroySemaphore(*written);
+            if (reading) m_device.destroySemaphore(*reading);
+            return std::unexpected(!written ? written.error() : reading.error());
+        }
+        m_written = *written;
+        m_reading = *reading;
+        m_read_value = counter_value(m_device, m_reading);
+    } else {
+        close_fds(std::array{fds[1], fds[2]});
+    }
+
+    // Dedicated imports must match the exported buffer
+    ParticleBufferConfig config{
+        .particle_count = message.particle_count,
+        .additional_usage_flags = vk::BufferUsageFlags(message.additional_usage)
+    };
+    auto buffer = ParticleBuffer::import_fd(*m_context, m_device, config, fds[0], message.allocation_size);
+    if (!buffer) {
+        return std::unexpected(buffer.error());
+    }
+    m_buffer.reset();
+    m_buffer.emplace(std::move(*buffer));
+    m_buffer_id = message.buffer_id;
+    return true;
+}
+
+std::expected<bool, std::string> ParticleShareClient::poll() {
+    bool imported = false;
+    while (m_socket >= 0) {
+        auto received = receive(false);
+        if (!received) {
+            return std::unexpected(received.error());
+        }
+        if (!*received) {
+            break;
+        }
+        imported = true;  // Keep going: only the newest buffer matters
+    }
+    return imported;
+}
+
+std::expected<uint64_t, std::string> ParticleShareClient::begin_read(uint64_t timeout_ns) {
+    if (m_in_read) {
+        return std::unexpected("begin_read() while a read is in progress");
+    }
+    for (;;) {
+        host_signal(m_device, m_reading, ++m_read_value);  // Odd: reading
+        const uint64_t written = counter_value(m_device, m_written);
+        if (written % 2 == 0) {
+            m_in_read = true;
+            return written / 2;
+        }
+
+        // The producer is writing: step aside until it is done
+        host_signal(m_device, m_reading, ++m_read_value);
+        if (!host_wait(m_device, m_written, written + 1, timeout_ns)) {
+            return std::unexpected("Timed out waiting for the producer to finish writing");
+        }
+    }
+}
+
+void ParticleShareClient::end_read() {
+    if (m_in_read) {
+        m_in_read = false;
+        host_signal(m_device, m_reading, ++m_read_value);
+    }
+}
+
+std::pair<vk::Semaphore, uint64_t> ParticleShareClient::end_read_signal() {
+    m_in_read = false;
+    return {m_reading, ++m_read_value};
+}
+
+vk::BufferMemoryBarrier ParticleShareClient::acquire_barrier(uint32_t queue_family) const {
+    return vk::BufferMemoryBarrier()
+        .setSrcAccessMask({})
+        .setDstAccessMask(vk::AccessFlagBits::eTransferRead |
+                          vk::AccessFlagBits::eVertexAttributeRead |
+                          vk::AccessFlagBits::eShaderRead)
+        .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_EXTERNAL)
+        .setDstQueueFamilyIndex(queue_family)
+        .setBuffer(m_buffer->buffer())
+        .setOffset(0)
+        .setSize(VK_WHOLE_SIZE);
+}
+
+} // namespace ifs
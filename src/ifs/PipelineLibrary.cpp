@@ -0,0 +1,320 @@
+#include <ifs/PipelineLibrary.hpp>
+#include <ifs/Logger.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <format>
+#include <span>
+#include <tuple>
+#include <type_traits>
+
+namespace ifs {
+
+namespace {
+
+// FNV-1a over the state a part depends on
+struct StateHash {
+    uint64_t value = 14695981039346656037ull;
+
+    void bytes(const void* data, size_t size) {
+        const auto* p = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; i++) {
+            value = (value ^ p[i]) * 1099511628211ull;
+        }
+    }
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    void add(const T& data) { bytes(&data, sizeof(T)); }
+
+    template <typename T>
+    void add_array(std::span<const T> data) {
+        add(data.size());
+        bytes(data.data(), data.size_bytes());
+    }
+
+    void add_string(const char* string) {
+        add(string ? std::strlen(string) : size_t{0});
+        if (string) bytes(string, std::strlen(string));
+    }
+};
+
+void add_dynamic_state(StateHash& hash, const vk::PipelineDynamicStateCreateInfo* dynamic_state) {
+    if (!dynamic_state) {
+        hash.add(uint32_t{0});
+        return;
+    }
+    hash.add_array(std::span(dynamic_state->pDynamicStates, dynamic_state->dynamicStateCount));
+}
+
+void add_stage(StateHash& hash, const vk::PipelineShaderStageCreateInfo& stage) {
+    hash.add(stage.stage);
+    hash.add(stage.module);
+    hash.add_string(stage.pName);
+}
+
+void add_multisample(StateHash& hash, const vk::PipelineMultisampleStateCreateInfo* multisample) {
+    if (!multisample) {
+        hash.add(uint32_t{0});
+        return;
+    }
+    hash.add(multisample->rasterizationSamples);
+    hash.add(multisample->sampleShadingEnable);
+    hash.add(multisample->minSampleShading);
+    hash.add(multisample->alphaToCoverageEnable);
+    hash.add(multisample->alphaToOneEnable);
+}
+
+} // anonymous namespace
+
+PipelineLibrary::PipelineLibrary(const VulkanContext& context)
+    : m_device(context.device())
+    , m_uses_libraries(context.has_graphics_pipeline_library())
+{}
+
+std::expected<std::unique_ptr<PipelineLibrary>, std::string> PipelineLibrary::create(const VulkanContext& context) {
+    auto library = std::unique_ptr<PipelineLibrary>(new PipelineLibrary(context));
+    if (library->m_uses_libraries) {
+        auto properties = context.physical_device().getProperties2<
+            vk::PhysicalDeviceProperties2, vk::PhysicalDeviceGraphicsPipelineLibraryPropertiesEXT>();
+        const auto& library_properties = properties.get<vk::PhysicalDeviceGraphicsPipelineLibraryPropertiesEXT>();
+        Logger::instance().info("Graphics pipeline library enabled (fast linking: {})",
+            library_properties.graphicsPipelineLibraryFastLinking ? "yes" : "no");
+    }
+    return library;
+}
+
+PipelineLibrary::~PipelineLibrary() {
+    wait_optimized();
+    for (auto& variant : m_variants) {
+        if (variant.optimized) m_device.destroyPipeline(variant.optimized);
+        if (variant.fast) m_device.destroyPipeline(variant.fast);
+    }
+    // Parts after the pipelines linked from them
+    for (auto& [key, part] : m_parts) {
+        m_device.destroyPipeline(part);
+    }
+}
+
+std::expected<vk::Pipeline, std::string> PipelineLibrary::part(
+    uint64_t key,
+    vk::GraphicsPipelineCreateInfo info,
+    vk::GraphicsPipelineLibraryFlagsEXT part
+) {
+    if (auto it = m_parts.find(key); it != m_parts.end()) {
+        return it->second;
+    }
+
+    auto library_info = vk::GraphicsPipelineLibraryCreateInfoEXT().setFlags(part);
+    info.setPNext(&library_info)
+        .setFlags(vk::PipelineCreateFlagBits::eLibraryKHR | vk::PipelineCreateFlagBits::eRetainLinkTimeOptimizationInfoEXT);
+
+	auto part_res = m_device.createGraphicsPipeline(nullptr, info);
+	if (part_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create pipeline library part: {}", to_string(part_res.result)));
+	}
+	m_parts.emplace(key, part_res.value);
+    return part_res.value;
+}
+
+std::expected<PipelineLibrary::Handle, std::string> PipelineLibrary::add(const vk::GraphicsPipelineCreateInfo& info) {
+    const auto handle = static_cast<Handle>(m_variants.size());
+
+    if (!m_uses_libraries) {
+		auto pipeline_res = m_device.createGraphicsPipeline(nullptr, info);
+		if (pipeline_res.result != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Failed to create graphics pipeline: {}", to_string(pipeline_res.result)));
+		}
+        m_variants.push_back(Variant{.fast = pipeline_res.value, .optimized = nullptr, .pending = {}});
+        return handle;
+    }
+
+    auto stages = std::span(info.pStages, info.stageCount);
+    const vk::PipelineShaderStageCreateInfo* fragment_stage = nullptr;
+    std::vector<vk::PipelineShaderStageCreateInfo> pre_rasterization_stages;
+    for (const auto& stage : stages) {
+        if (stage.stage == vk::ShaderStageFlagBits::eFragment) {
+            fragment_stage = &stage;
+        } else {
+            pre_rasterization_stages.push_back(stage);
+        }
+    }
+
+    // Vertex input interface: vertex layout and topology
+    StateHash vertex_input_key;
+    vertex_input_key.add(vk::GraphicsPipelineLibraryFlagBitsEXT::eVertexInputInterface);
+    if (const auto* vertex_input = info.pVertexInputState) {
+        vertex_input_key.add_array(std::span(vertex_input->pVertexBindingDescriptions, vertex_input->vertexBindingDescriptionCount));
+        vertex_input_key.add_array(std::span(vertex_input->pVertexAttributeDescriptions, vertex_input->vertexAttributeDescriptionCount));
+    }
+    if (const auto* input_assembly = info.pInputAssemblyState) {
+        vertex_input_key.add(input_assembly->topology);
+        vertex_input_key.add(input_assembly->primitiveRestartEnable);
+    }
+    add_dynamic_state(vertex_input_key, info.pDynamicState);
+
+    auto vertex_input_info = vk::GraphicsPipelineCreateInfo()
+        .setPVertexInputState(info.pVertexInputState)
+        .setPInputAssemblyState(info.pInputAssemblyState)
+        .setPDynamicState(info.pDynamicState);
+
+    // Pre-rasterization shaders: vertex stages, viewport and rasterizer state
+    StateHash pre_rasterization_key;
+    pre_rasterization_key.add(vk::GraphicsPipelineLibraryFlagBitsEXT::ePreRasterizationShaders);
+    pre_rasterization_key.add(info.layout);
+    pre_rasterization_key.add(info.renderPass);
+    pre_rasterization_key.add(info.subpass);
+    for (const auto& stage : pre_rasterization_stages) {
+        add_stage(pre_rasterization_key, stage);
+    }
+    if (const auto* viewport = info.pViewportState) {
+        pre_rasterization_key.add(viewport->viewportCount);
+        pre_rasterization_key.add(viewport->scissorCount);
+    }
+    if (const auto* rasterizer = info.pRasterizationState) {
+        pre_rasterization_key.add(rasterizer->depthClampEnable);
+        pre_rasterization_key.add(rasterizer->rasterizerDiscardEnable);
+        pre_rasterization_key.add(rasterizer->polygonMode);
+        pre_rasterization_key.add(rasterizer->cullMode);
+        pre_rasterization_key.add(rasterizer->frontFace);
+        pre_rasterization_key.add(rasterizer->depthBiasEnable);
+        pre_rasterization_key.add(rasterizer->depthBiasConstantFactor);
+        pre_rasterization_key.add(rasterizer->depthBiasClamp);
+        pre_rasterization_key.add(rasterizer->depthBiasSlopeFactor);
+        pre_rasterization_key.add(rasterizer->lineWidth);
+    }
+    add_dynamic_state(pre_rasterization_key, info.pDynamicState);
+
+    auto pre_rasterization_info = vk::GraphicsPipelineCreateInfo()
+        .setStages(pre_rasterization_stages)
+        .setPViewportState(info.pViewportState)
+        .setPRasterizationState(info.pRasterizationState)
+        .setPTessellationState(info.pTessellationState)
+        .setPDynamicState(info.pDynamicState)
+        .setLayout(info.layout)
+        .setRenderPass(info.renderPass)
+        .setSubpass(info.subpass);
+
+    // Fragment shader: fragment stage, depth and stencil state
+    StateHash fragment_key;
+    fragment_key.add(vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentShader);
+    fragment_key.add(info.layout);
+    fragment_key.add(info.renderPass);
+    fragment_key.add(info.subpass);
+    if (fragment_stage) {
+        add_stage(fragment_key, *fragment_stage);
+    }
+    if (const auto* depth_stencil = info.pDepthStencilState) {
+        fragment_key.add(depth_stencil->depthTestEnable);
+        fragment_key.add(depth_stencil->depthWriteEnable);
+        fragment_key.add(depth_stencil->depthCompareOp);
+        fragment_key.add(depth_stencil->depthBoundsTestEnable);
+        fragment_key.add(depth_stencil->stencilTestEnable);
+        fragment_key.add(depth_stencil->front);
+        fragment_key.add(depth_stencil->back);
+        fragment_key.add(depth_stencil->minDepthBounds);
+        fragment_key.add(depth_stencil->maxDepthBounds);
+    }
+    add_multisample(fragment_key, info.pMultisampleState);
+    add_dynamic_state(fragment_key, info.pDynamicState);
+
+    auto fragment_info = vk::GraphicsPipelineCreateInfo()
+        .setStageCount(fragment_stage ? 1 : 0)
+        .setPStages(fragment_stage)
+        .setPDepthStencilState(info.pDepthStencilState)
+        .setPMultisampleState(info.pMultisampleState)
+        .setPDynamicState(info.pDynamicState)
+        .setLayout(info.layout)
+        .setRenderPass(info.renderPass)
+        .setSubpass(info.subpass);
+
+    // Fragment output interface: blending and the attachments
+    StateHash output_key;
+    output_key.add(vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentOutputInterface);
+    output_key.add(info.renderPass);
+    output_key.add(info.subpass);
+    if (const auto* blending = info.pColorBlendState) {
+        output_key.add(blending->logicOpEnable);
+        output_key.add(blending->logicOp);
+        output_key.add_array(std::span(blending->pAttachments, blending->attachmentCount));
+        output_key.add(blending->blendConstants);
+    }
+    add_multisample(output_key, info.pMultisampleState);
+    add_dynamic_state(output_key, info.pDynamicState);
+
+    auto output_info = vk::GraphicsPipelineCreateInfo()
+        .setPColorBlendState(info.pColorBlendState)
+        .setPMultisampleState(info.pMultisampleState)
+        .setPDynamicState(info.pDynamicState)
+        .setRenderPass(info.renderPass)
+        .setSubpass(info.subpass);
+
+    std::array<vk::Pipeline, 4> parts;
+    const std::array<std::tuple<uint64_t, const vk::GraphicsPipelineCreateInfo*, vk::GraphicsPipelineLibraryFlagBitsEXT>, 4> descriptions = {{
+        {vertex_input_key.value, &vertex_input_info, vk::GraphicsPipelineLibraryFlagBitsEXT::eVertexInputInterface},
+        {pre_rasterization_key.value, &pre_rasterization_info, vk::GraphicsPipelineLibraryFlagBitsEXT::ePreRasterizationShaders},
+        {fragment_key.value, &fragment_info, vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentShader},
+        {output_key.value, &output_info, vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentOutputInterface}
+    }};
+    for (size_t i = 0; i < parts.size(); i++) {
+        const auto& [key, part_info, flag] = descriptions[i];
+        auto part_result = part(key, *part_info, flag);
+        if (!part_result) {
+            return std::unexpected(part_result.error());
+        }
+        parts[i] = *part_result;
+    }
+
+    // Fast link now; the optimized link runs on a worker and replaces it when done
+    auto link = [device = m_device, parts, layout = info.layout](vk::PipelineCreateFlags flags) {
+        auto libraries = vk::PipelineLibraryCreateInfoKHR().setLibraries(parts);
+        auto link_info = vk::GraphicsPipelineCreateInfo()
+            .setPNext(&libraries)
+            .setFlags(flags)
+            .setLayout(layout);
+        return device.createGraphicsPipeline(nullptr, link_info);
+    };
+
+	auto fast_res = link({});
+	if (fast_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to link graphics pipeline: {}", to_string(fast_res.result)));
+	}
+
+    auto pending = std::async(std::launch::async, [link]() -> vk::Pipeline {
+        auto optimized_res = link(vk::PipelineCreateFlagBits::eLinkTimeOptimizationEXT);
+        if (optimized_res.result != vk::Result::eSuccess) {
+            Logger::instance().warn("Optimized pipeline link failed: {}", to_string(optimized_res.result));
+            return nullptr;
+        }
+        return optimized_res.value;
+    });
+    m_variants.push_back(Variant{.fast = fast_res.value, .optimized = nullptr, .pending = std::move(pending)});
+    return handle;
+}
+
+vk::Pipeline PipelineLibrary::pipeline(Handle handle) {
+    auto& variant = m_variants[handle];
+    if (variant.pending.valid() &&
+        variant.pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        variant.optimized = variant.pending.get();
+    }
+    return variant.optimized ? variant.optimized : variant.fast;
+}
+
+size_t PipelineLibrary::optimized_count() const {
+    return static_cast<size_t>(std::ranges::count_if(m_variants, [](const Variant& variant) { return variant.optimized != nullptr; }));
+}
+
+void PipelineLibrary::wait_optimized() {
+    for (auto& variant : m_variants) {
+        if (variant.pending.valid()) {
+            variant.optimized = variant.pending.get();
+        }
+    }
+}
+
+} // namespace ifs
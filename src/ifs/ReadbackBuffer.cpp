@@ -0,0 +1,92 @@
+#include <ifs/ReadbackBuffer.hpp>
+#include <format>
+
+namespace ifs {
+
+ReadbackBuffer::ReadbackBuffer(vk::Device device, vk::DeviceSize size)
+    : m_device(device)
+    , m_size(size)
+    , m_buffer(nullptr)
+    , m_memory(nullptr)
+{}
+
+std::expected<std::shared_ptr<ReadbackBuffer>, std::string> ReadbackBuffer::create(
+    const VulkanContext& context,
+    vk::DeviceSize size,
+    vk::BufferUsageFlags usage
+) {
+    auto readback = std::shared_ptr<ReadbackBuffer>(new ReadbackBuffer(context.device(), size));
+    auto device = context.device();
+
+    auto buffer_info = vk::BufferCreateInfo()
+        .setSize(size)
+        .setUsage(usage)
+        .setSharingMode(vk::SharingMode::eExclusive);
+
+	auto buffer_res = device.createBuffer(buffer_info);
+	if (buffer_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create readback buffer: {}", to_string(buffer_res.result)));
+	}
+	readback->m_buffer = buffer_res.value;
+
+    auto requirements = device.getBufferMemoryRequirements(readback->m_buffer);
+    auto mem_props = context.physical_device().getMemoryProperties();
+
+    auto memory_type = context.find_memory_type(requirements.memoryTypeBits,
+        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCached);
+    if (!memory_type) {
+        memory_type = context.find_memory_type(requirements.memoryTypeBits, vk::MemoryPropertyFlagBits::eHostVisible);
+    }
+    if (!memory_type) {
+        return std::unexpected("Failed to find host-visible memory for readback buffer");
+    }
+    readback->m_coherent = static_cast<bool>(
+        mem_props.memoryTypes[*memory_type].propertyFlags & vk::MemoryPropertyFlagBits::eHostCoherent);
+
+    auto alloc_info = vk::MemoryAllocateInfo()
+        .setAllocationSize(requirements.size)
+        .setMemoryTypeIndex(*memory_type);
+
+	auto alloc_res = device.allocateMemory(alloc_info);
+	if (alloc_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to allocate readback memory: {}", to_string(alloc_res.result)));
+	}
+	readback->m_memory = alloc_res.value;
+
+	auto bind_res = device.bindBufferMemory(readback->m_buffer, readback->m_memory, 0);
+	if (bind_res != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to bind readback memory: {}", to_string(bind_res)));
+	}
+
+	auto map_res = device.mapMemory(readback->m_memory, 0, VK_WHOLE_SIZE);
+	if (map_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to map readback memory: {}", to_string(map_res.result)));
+	}
+	readback->m_mapped = map_res.value;
+
+    return readback;
+}
+
+ReadbackBuffer::~ReadbackBuffer() {
+    if (m_memory) {
+        if (m_mapped) {
+            m_device.unmapMemory(m_memory);
+        }
+        m_device.freeMemory(m_memory);
+    }
+    if (m_buffer) {
+        m_device.destroyBuffer(m_buffer);
+    }
+}
+
+void ReadbackBuffer::invalidate() const {
+    if (!m_coherent) {
+        auto _ = m_device.invalidateMappedMemoryRanges(vk::MappedMemoryRange(m_memory, 0, VK_WHOLE_SIZE));
+    }
+}
+
+} // namespace ifs
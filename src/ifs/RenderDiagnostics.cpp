@@ -0,0 +1,589 @@
+#include <ifs/RenderDiagnostics.hpp>
+#include <ifs/Logger.hpp>
+#include <array>
+#include <format>
+
+namespace ifs {
+
+namespace {
+
+// Result order follows the bit order of the flags
+constexpr vk::QueryPipelineStatisticFlags STATISTIC_FLAGS =
+    vk::QueryPipelineStatisticFlagBits::eInputAssemblyPrimitives |
+    vk::QueryPipelineStatisticFlagBits::eVertexShaderInvocations |
+    vk::QueryPipelineStatisticFlagBits::eClippingInvocations |
+    vk::QueryPipelineStatisticFlagBits::eClippingPrimitives |
+    vk::QueryPipelineStatisticFlagBits::eFragmentShaderInvocations;
+constexpr uint32_t STATISTIC_COUNT = 5;
+
+constexpr vk::Format COUNTER_FORMAT = vk::Format::eR32Uint;
+
+} // anonymous namespace
+
+// ============================================================================
+// PipelineStatisticsQuery
+// ============================================================================
+
+PipelineStatisticsQuery::PipelineStatisticsQuery(const VulkanContext& context, uint32_t slot_count)
+    : m_device(context.device())
+    , m_query_pool(nullptr)
+    , m_slots(slot_count)
+{}
+
+std::expected<std::unique_ptr<PipelineStatisticsQuery>, std::string> PipelineStatisticsQuery::create(
+    const VulkanContext& context,
+    uint32_t slot_count
+) {
+    auto query = std::unique_ptr<PipelineStatisticsQuery>(new PipelineStatisticsQuery(context, slot_count));
+
+    if (!context.physical_device().getFeatures().pipelineStatisticsQuery) {
+        Logger::instance().warn("Device does not support pipeline statistics queries");
+        return query;
+    }
+
+    auto pool_info = vk::QueryPoolCreateInfo()
+        .setQueryType(vk::QueryType::ePipelineStatistics)
+        .setQueryCount(slot_count)
+        .setPipelineStatistics(STATISTIC_FLAGS);
+
+	auto pool_res = context.device().createQueryPool(pool_info);
+	if (pool_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create pipeline statistics query pool: {}", to_string(pool_res.result)));
+	}
+	query->m_query_pool = pool_res.value;
+    context.device().resetQueryPool(query->m_query_pool, 0, slot_count);
+
+    return query;
+}
+
+PipelineStatisticsQuery::~PipelineStatisticsQuery() {
+    if (m_query_pool) {
+        m_device.destroyQueryPool(m_query_pool);
+    }
+}
+
+void PipelineStatisticsQuery::collect(uint32_t slot, uint32_t pixel_count) {
+    if (!m_query_pool || slot >= m_slots.size()) {
+        return;
+    }
+
+    auto& state = m_slots[slot];
+    if (state.pending) {
+        auto results_res = m_device.getQueryPoolResults<uint64_t>(
+            m_query_pool, slot, 1,
+            STATISTIC_COUNT * sizeof(uint64_t), STATISTIC_COUNT * sizeof(uint64_t),
+            vk::QueryResultFlagBits::e64);
+        if (results_res.result == vk::Result::eSuccess) {
+            const auto& values = results_res.value;
+            m_latest = PipelineStatistics{
+                .input_assembly_primitives = values[0],
+                .vertex_invocations = values[1],
+                .clipping_invocations = values[2],
+                .clipping_primitives = values[3],
+                .fragment_invocations = values[4],
+                .pixel_count = state.pixel_count
+            };
+        }
+        m_device.resetQueryPool(m_query_pool, slot, 1);
+        state.pending = false;
+    }
+    state.pixel_count = pixel_count;
+}
+
+void PipelineStatisticsQuery::begin(vk::CommandBuffer cmd, uint32_t slot) {
+    if (!m_enabled || slot >= m_slots.size()) {
+        return;
+    }
+    cmd.beginQuery(m_query_pool, slot, {});
+    m_slots[slot].pending = true;
+}
+
+void PipelineStatisticsQuery::end(vk::CommandBuffer cmd, uint32_t slot) {
+    if (slot >= m_slots.size() || !m_slots[slot].pending) {
+        return;
+    }
+    cmd.endQuery(m_query_pool, slot);
+}
+
+// ============================================================================
+// OverdrawHeatmap
+// ============================================================================
+
+OverdrawHeatmap::OverdrawHeatmap(const VulkanContext& context)
+    : m_context(&context)
+    , m_device(context.device())
+    , m_image(nullptr)
+    , m_image_memory(nullptr)
+    , m_image_view(nullptr)
+    , m_extent{}
+    , m_descriptor_layout(nullptr)
+    , m_descriptor_pool(nullptr)
+    , m_descriptor_set(nullptr)
+    , m_count_layout(nullptr)
+    , m_count_pipeline(nullptr)
+    , m_resolve_layout(nullptr)
+    , m_resolve_pipeline(nullptr)
+{}
+
+bool OverdrawHeatmap::supported(const VulkanContext& context) {
+    auto features = context.physical_device().getFeatures();
+    auto format_props = context.physical_device().getFormatProperties(COUNTER_FORMAT);
+    return features.fragmentStoresAndAtomics &&
+           (format_props.optimalTilingFeatures & vk::FormatFeatureFlagBits::eStorageImageAtomic);
+}
+
+std::expected<std::unique_ptr<OverdrawHeatmap>, std::string> OverdrawHeatmap::create(
+    const VulkanContext& context,
+    const vk::GraphicsPipelineCreateInfo& frontend_pipeline,
+    vk::DescriptorSetLayout frontend_set_layout
+) {
+    if (!supported(context)) {
+        return std::unexpected("Overdraw heatmap needs fragmentStoresAndAtomics and R32_UINT storage image atomics");
+    }
+
+    auto heatmap = std::unique_ptr<OverdrawHeatmap>(new OverdrawHeatmap(context));
+
+    if (auto result = heatmap->create_descriptors(); !result) {
+        return std::unexpected(result.error());
+    }
+    if (auto result = heatmap->create_pipelines(frontend_pipeline, frontend_set_layout); !result) {
+        return std::unexpected(result.error());
+    }
+
+    // The counter image is created on the first record_clear(), when the extent is known
+    return heatmap;
+}
+
+OverdrawHeatmap::~OverdrawHeatmap() {
+    destroy_image();
+
+    if (m_resolve_pipeline) m_device.destroyPipeline(m_resolve_pipeline);
+    if (m_resolve_layout) m_device.destroyPipelineLayout(m_resolve_layout);
+    if (m_count_pipeline) m_device.destroyPipeline(m_count_pipeline);
+    if (m_count_layout) m_device.destroyPipelineLayout(m_count_layout);
+    if (m_descriptor_pool) m_device.destroyDescriptorPool(m_descriptor_pool);
+    if (m_descriptor_layout) m_device.destroyDescriptorSetLayout(m_descriptor_layout);
+}
+
+std::expected<void, std::string> OverdrawHeatmap::create_descriptors() {
+    // Binding 0: counter image (written by the count pass, read by the resolve pass)
+    auto binding = vk::DescriptorSetLayoutBinding()
+        .setBinding(0)
+        .setDescriptorType(vk::DescriptorType::eStorageImage)
+        .setDescriptorCount(1)
+        .setStageFlags(vk::ShaderStageFlagBits::eFragment);
+
+    auto layout_info = vk::DescriptorSetLayoutCreateInfo()
+        .setBindings(binding);
+
+	auto layout_res = m_device.createDescriptorSetLayout(layout_info);
+	if (layout_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create overdraw descriptor layout: {}", to_string(layout_res.result)));
+	}
+	m_descriptor_layout = layout_res.value;
+
+    auto pool_size = vk::DescriptorPoolSize(vk::DescriptorType::eStorageImage, 1);
+    auto pool_info = vk::DescriptorPoolCreateInfo()
+        .setMaxSets(1)
+        .setPoolSizes(pool_size);
+
+	auto pool_res = m_device.createDescriptorPool(pool_info);
+	if (pool_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create overdraw descriptor pool: {}", to_string(pool_res.result)));
+	}
+	m_descriptor_pool = pool_res.value;
+
+    auto alloc_info = vk::DescriptorSetAllocateInfo()
+        .setDescriptorPool(m_descriptor_pool)
+        .setSetLayouts(m_descriptor_layout);
+
+	auto set_res = m_device.allocateDescriptorSets(alloc_info);
+	if (set_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to allocate overdraw descriptor set: {}", to_string(set_res.result)));
+	}
+	m_descriptor_set = set_res.value[0];
+
+    return {};
+}
+
+std::expected<void, std::string> OverdrawHeatmap::create_pipelines(
+    const vk::GraphicsPipelineCreateInfo& frontend_pipeline,
+    vk::DescriptorSetLayout frontend_set_layout
+) {
+    auto count_result = Shader::create_shader(m_device, "ifs_modular/debug/overdraw_count.frag.slang", "main");
+    if (!count_result) {
+        return std::unexpected(std::format("Failed to load overdraw count shader: {}", count_result.error()));
+    }
+    m_count_shader = std::make_unique<Shader>(std::move(*count_result));
+
+    auto vert_result = Shader::create_shader(m_device, "ifs_modular/debug/overdraw_heatmap.vert.slang", "main");
+    if (!vert_result) {
+        return std::unexpected(std::format("Failed to load overdraw heatmap vertex shader: {}", vert_result.error()));
+    }
+    m_resolve_vertex_shader = std::make_unique<Shader>(std::move(*vert_result));
+
+    auto frag_result = Shader::create_shader(m_device, "ifs_modular/debug/overdraw_heatmap.frag.slang", "main");
+    if (!frag_result) {
+        return std::unexpected(std::format("Failed to load overdraw heatmap fragment shader: {}", frag_result.error()));
+    }
+    m_resolve_fragment_shader = std::make_unique<Shader>(std::move(*frag_result));
+
+    // Count pipeline: frontend set 0 + counter image as set 1
+    std::array count_set_layouts = {frontend_set_layout, m_descriptor_layout};
+    auto count_layout_info = vk::PipelineLayoutCreateInfo()
+        .setSetLayouts(count_set_layouts);
+
+	auto count_layout_res = m_device.createPipelineLayout(count_layout_info);
+	if (count_layout_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create overdraw count pipeline layout: {}", to_string(count_layout_res.result)));
+	}
+	m_count_layout = count_layout_res.value;
+
+    // Keep the frontend's vertex stage, swap in the counting fragment stage
+    std::vector<vk::PipelineShaderStageCreateInfo> count_stages;
+    for (uint32_t i = 0; i < frontend_pipeline.stageCount; i++) {
+        if (frontend_pipeline.pStages[i].stage == vk::ShaderStageFlagBits::eVertex) {
+            count_stages.push_back(frontend_pipeline.pStages[i]);
+        }
+    }
+    count_stages.push_back(vk::PipelineShaderStageCreateInfo()
+        .setStage(vk::ShaderStageFlagBits::eFragment)
+        .setModule(m_count_shader->get_shader_module())
+        .setPName("main"));
+
+    // Every fragment counts, so no depth test
+    auto depth_stencil = vk::PipelineDepthStencilStateCreateInfo()
+        .setDepthTestEnable(false)
+        .setDepthWriteEnable(false)
+        .setDepthBoundsTestEnable(false)
+        .setStencilTestEnable(false);
+
+    // Color attachment is left untouched by the count pass
+    auto count_blend_attachment = vk::PipelineColorBlendAttachmentState()
+        .setColorWriteMask({})
+        .setBlendEnable(false);
+
+    auto count_blending = vk::PipelineColorBlendStateCreateInfo()
+        .setLogicOpEnable(false)
+        .setAttachments(count_blend_attachment);
+
+    auto count_info = frontend_pipeline;
+    count_info
+        .setStages(count_stages)
+        .setPDepthStencilState(&depth_stencil)
+        .setPColorBlendState(&count_blending)
+        .setLayout(m_count_layout);
+
+	auto count_pipeline_res = m_device.createGraphicsPipeline(nullptr, count_info);
+	if (count_pipeline_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create overdraw count pipeline: {}", to_string(count_pipeline_res.result)));
+	}
+	m_count_pipeline = count_pipeline_res.value;
+
+    // Resolve pipeline: fullscreen triangle reading the counters
+    auto push_constant_range = vk::PushConstantRange()
+        .setStageFlags(vk::ShaderStageFlagBits::eFragment)
+        .setOffset(0)
+        .setSize(sizeof(uint32_t));
+
+    auto resolve_layout_info = vk::PipelineLayoutCreateInfo()
+        .setSetLayouts(m_descriptor_layout)
+        .setPushConstantRanges(push_constant_range);
+
+	auto resolve_layout_res = m_device.createPipelineLayout(resolve_layout_info);
+	if (resolve_layout_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create overdraw resolve pipeline layout: {}", to_string(resolve_layout_res.result)));
+	}
+	m_resolve_layout = resolve_layout_res.value;
+
+    std::array resolve_stages = {
+        vk::PipelineShaderStageCreateInfo()
+            .setStage(vk::ShaderStageFlagBits::eVertex)
+            .setModule(m_resolve_vertex_shader->get_shader_module())
+            .setPName("main"),
+        vk::PipelineShaderStageCreateInfo()
+            .setStage(vk::ShaderStageFlagBits::eFragment)
+            .setModule(m_resolve_fragment_shader->get_shader_module())
+            .setPName("main")
+    };
+
+    auto vertex_input = vk::PipelineVertexInputStateCreateInfo();
+
+    auto input_assembly = vk::PipelineInputAssemblyStateCreateInfo()
+        .setTopology(vk::PrimitiveTopology::eTriangleList)
+        .setPrimitiveRestartEnable(false);
+
+    auto rasterizer = vk::PipelineRasterizationStateCreateInfo()
+        .setDepthClampEnable(false)
+        .setRasterizerDiscardEnable(false)
+        .setPolygonMode(vk::PolygonMode::eFill)
+        .setLineWidth(1.0f)
+        .setCullMode(vk::CullModeFlagBits::eNone)
+        .setFrontFace(vk::FrontFace::eCounterClockwise)
+        .setDepthBiasEnable(false);
+
+    auto resolve_blend_attachment = vk::PipelineColorBlendAttachmentState()
+        .setColorWriteMask(vk::ColorComponentFlagBits::eR |
+                          vk::ColorComponentFlagBits::eG |
+                          vk::ColorComponentFlagBits::eB |
+                          vk::ColorComponentFlagBits::eA)
+        .setBlendEnable(false);
+
+    auto resolve_blending = vk::PipelineColorBlendStateCreateInfo()
+        .setLogicOpEnable(false)
+        .setAttachments(resolve_blend_attachment);
+
+    auto resolve_info = vk::GraphicsPipelineCreateInfo()
+        .setStages(resolve_stages)
+        .setPVertexInputState(&vertex_input)
+        .setPInputAssemblyState(&input_assembly)
+        .setPViewportState(frontend_pipeline.pViewportState)
+        .setPRasterizationState(&rasterizer)
+        .setPMultisampleState(frontend_pipeline.pMultisampleState)
+        .setPDepthStencilState(&depth_stencil)
+        .setPColorBlendState(&resolve_blending)
+        .setPDynamicState(frontend_pipeline.pDynamicState)
+        .setLayout(m_resolve_layout)
+        .setRenderPass(frontend_pipeline.renderPass)
+        .setSubpass(frontend_pipeline.subpass);
+
+	auto resolve_pipeline_res = m_device.createGraphicsPipeline(nullptr, resolve_info);
+	if (resolve_pipeline_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create overdraw resolve pipeline: {}", to_string(resolve_pipeline_res.result)));
+	}
+	m_resolve_pipeline = resolve_pipeline_res.value;
+
+    return {};
+}
+
+std::expected<void, std::string> OverdrawHeatmap::create_image(const vk::Extent2D& extent) {
+    auto image_info = vk::ImageCreateInfo()
+        .setImageType(vk::ImageType::e2D)
+        .setFormat(COUNTER_FORMAT)
+        .setExtent(vk::Extent3D(extent.width, extent.height, 1))
+        .setMipLevels(1)
+        .setArrayLayers(1)
+        .setSamples(vk::SampleCountFlagBits::e1)
+        .setTiling(vk::ImageTiling::eOptimal)
+        .setUsage(vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eTransferDst)
+        .setSharingMode(vk::SharingMode::eExclusive)
+        .setInitialLayout(vk::ImageLayout::eUndefined);
+
+	auto image_res = m_device.createImage(image_info);
+	if (image_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create overdraw image: {}", to_string(image_res.result)));
+	}
+	m_image = image_res.value;
+
+    auto mem_reqs = m_device.getImageMemoryRequirements(m_image);
+    auto memory_type = m_context->find_memory_type(mem_reqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
+    if (!memory_type) {
+        return std::unexpected("Failed to find suitable memory type for overdraw image");
+    }
+
+    auto alloc_info = vk::MemoryAllocateInfo()
+        .setAllocationSize(mem_reqs.size)
+        .setMemoryTypeIndex(*memory_type);
+
+	auto alloc_res = m_device.allocateMemory(alloc_info);
+	if (alloc_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to allocate overdraw image memory: {}", to_string(alloc_res.result)));
+	}
+	m_image_memory = alloc_res.value;
+	auto bind_res = m_device.bindImageMemory(m_image, m_image_memory, 0);
+	if (bind_res != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to bind overdraw image memory: {}", to_string(bind_res)));
+	}
+
+    auto view_info = vk::ImageViewCreateInfo()
+        .setImage(m_image)
+        .setViewType(vk::ImageViewType::e2D)
+        .setFormat(COUNTER_FORMAT)
+        .setSubresourceRange(vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1));
+
+	auto view_res = m_device.createImageView(view_info);
+	if (view_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create overdraw image view: {}", to_string(view_res.result)));
+	}
+	m_image_view = view_res.value;
+
+    auto image_descriptor = vk::DescriptorImageInfo()
+        .setImageView(m_image_view)
+        .setImageLayout(vk::ImageLayout::eGeneral);
+
+    auto write = vk::WriteDescriptorSet()
+        .setDstSet(m_descriptor_set)
+        .setDstBinding(0)
+        .setDstArrayElement(0)
+        .setDescriptorType(vk::DescriptorType::eStorageImage)
+        .setImageInfo(image_descriptor);
+
+    m_device.updateDescriptorSets(write, {});
+
+    m_extent = extent;
+    m_image_initialized = false;
+    return {};
+}
+
+void OverdrawHeatmap::destroy_image() {
+    if (m_image_view) {
+        m_device.destroyImageView(m_image_view);
+        m_image_view = nullptr;
+    }
+    if (m_image) {
+        m_device.destroyImage(m_image);
+        m_image = nullptr;
+    }
+    if (m_image_memory) {
+        m_device.freeMemory(m_image_memory);
+        m_image_memory = nullptr;
+    }
+    m_extent = vk::Extent2D{};
+    m_image_initialized = false;
+    m_ready = false;
+}
+
+void OverdrawHeatmap::handle_swapchain_recreation() {
+    destroy_image();
+}
+
+void OverdrawHeatmap::record_clear(vk::CommandBuffer cmd, const vk::Extent2D& extent) {
+    m_ready = false;
+    if (!m_image) {
+        if (auto result = create_image(extent); !result) {
+            Logger::instance().error("{}", result.error());
+            destroy_image();
+            return;
+        }
+    } else if (extent.width > m_extent.width || extent.height > m_extent.height) {
+        // The other frame in flight may still read the image: it is only
+        // replaced while the device is idle (handle_swapchain_recreation())
+        return;
+    }
+
+    auto range = vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1);
+
+    // Previous frame's count/resolve passes -> clear
+    auto to_transfer = vk::ImageMemoryBarrier()
+        .setSrcAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eTransferWrite)
+        .setOldLayout(m_image_initialized ? vk::ImageLayout::eGeneral : vk::ImageLayout::eUndefined)
+        .setNewLayout(vk::ImageLayout::eGeneral)
+        .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+        .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+        .setImage(m_image)
+        .setSubresourceRange(range);
+
+    cmd.pipelineBarrier(
+        vk::PipelineStageFlagBits::eFragmentShader,
+        vk::PipelineStageFlagBits::eTransfer,
+        {},
+        {},
+        {},
+        to_transfer
+    );
+    m_image_initialized = true;
+
+    cmd.clearColorImage(m_image, vk::ImageLayout::eGeneral, vk::ClearColorValue(std::array<uint32_t, 4>{0, 0, 0, 0}), range);
+
+    // Clear -> this frame's count pass
+    auto to_fragment = vk::ImageMemoryBarrier()
+        .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite)
+        .setOldLayout(vk::ImageLayout::eGeneral)
+        .setNewLayout(vk::ImageLayout::eGeneral)
+        .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+        .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+        .setImage(m_image)
+        .setSubresourceRange(range);
+
+    cmd.pipelineBarrier(
+        vk::PipelineStageFlagBits::eTransfer,
+        vk::PipelineStageFlagBits::eFragmentShader,
+        {},
+        {},
+        {},
+        to_fragment
+    );
+    m_ready = true;
+}
+
+void OverdrawHeatmap::bind_count_pipeline(vk::CommandBuffer cmd, vk::DescriptorSet frontend_set) const {
+    std::array sets = {frontend_set, m_descriptor_set};
+    cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, m_count_pipeline);
+    cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_count_layout, 0, sets, {});
+}
+
+void OverdrawHeatmap::record_resolve(vk::CommandBuffer cmd) const {
+    if (!m_image) {
+        return;
+    }
+
+    // Count pass writes -> resolve reads; each pixel only reads its own counter,
+    // which the render pass' by-region self-dependency allows
+    auto barrier = vk::MemoryBarrier()
+        .setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eShaderRead);
+
+    cmd.pipelineBarrier(
+        vk::PipelineStageFlagBits::eFragmentShader,
+        vk::PipelineStageFlagBits::eFragmentShader,
+        vk::DependencyFlagBits::eByRegion,
+        barrier,
+        {},
+        {}
+    );
+
+    cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, m_resolve_pipeline);
+    cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_resolve_layout, 0, m_descriptor_set, {});
+    cmd.pushConstants<uint32_t>(m_resolve_layout, vk::ShaderStageFlagBits::eFragment, 0, m_max_count);
+    cmd.draw(3, 1, 0, 0);
+}
+
+// ============================================================================
+// UI
+// ============================================================================
+
+std::vector<UICallback> diagnostics_ui_callbacks(
+    PipelineStatisticsQuery* statistics,
+    OverdrawHeatmap* heatmap,
+    bool& show_overdraw
+) {
+    std::vector<UICallback> callbacks;
+
+    if (statistics && statistics->supported()) {
+        callbacks.emplace_back("Pipeline Statistics", ToggleCallback{
+            .setter = [statistics](bool v) { statistics->set_enabled(v); },
+            .getter = [statistics]() { return statistics->enabled(); }
+        });
+    }
+
+    if (heatmap) {
+        callbacks.emplace_back("Overdraw Heatmap", ToggleCallback{
+            .setter = [&show_overdraw](bool v) { show_overdraw = v; },
+            .getter = [&show_overdraw]() { return show_overdraw; }
+        });
+        callbacks.emplace_back("Heatmap Max Overdraw", DiscreteCallback{
+            .setter = [heatmap](int v) { heatmap->set_max_count(static_cast<uint32_t>(v)); },
+            .getter = [heatmap]() { return static_cast<int>(heatmap->max_count()); },
+            .min = 1,
+            .max = 256
+        });
+    }
+
+    return callbacks;
+}
+
+} // namespace ifs
@@ -2,10 +2,15 @@
 // Created by chris on 1/7/26.
 //
 #include <ifs/Logger.hpp>
+#include <ifs/Metrics.hpp>
 #include <ifs/Shader.hpp>
+#include <ifs/StartupTrace.hpp>
+#include <chrono>
+#include <format>
 #include <map>
 #include <slang-com-ptr.h>
 #include <utility>
+#include <vector>
 
 // ============================================================================
 // Slang Session Management
@@ -75,9 +80,10 @@ std::optional<std::string> check_diagnostics(slang::IBlob* diagnostics)
 }
 
 /// Load a shader module and find the specified entry point.
-/// Creates a composite component type combining module + entry point.
-std::expected<Slang::ComPtr<slang::IComponentType>, std::string> load_shader_program(std::string_view name,
-																					 std::string_view entry_point)
+/// Creates a composite component type combining module + entry point, specialized
+/// with the given type names if the entry point is generic.
+std::expected<Slang::ComPtr<slang::IComponentType>, std::string> load_shader_program(
+	std::string_view name, std::string_view entry_point, std::span<const std::string> specialization)
 {
 	Logger::instance().debug("Loading shader module '{}' with entry point '{}'", name, entry_point);
 
@@ -113,6 +119,35 @@ std::expected<Slang::ComPtr<slang::IComponentType>, std::string> load_shader_pro
 		return std::unexpected{*error};
 	}
 
+	if (!specialization.empty())
+	{
+		std::vector<slang::SpecializationArg> args;
+		for (const auto& type_name : specialization)
+		{
+			auto* type = module->getLayout()->findTypeByName(type_name.c_str());
+			if (!type)
+			{
+				Logger::instance().error("Type '{}' not found in module '{}'", type_name, name);
+				return std::unexpected{std::format("Specialization type '{}' not found", type_name)};
+			}
+			args.push_back(slang::SpecializationArg::fromType(type));
+		}
+
+		Slang::ComPtr<slang::IComponentType> specialized;
+		program->specialize(args.data(), static_cast<SlangInt>(args.size()), specialized.writeRef(),
+							diagnostics.writeRef());
+		if (auto error = check_diagnostics(diagnostics.get()))
+		{
+			Logger::instance().error("Failed to specialize '{}':'{}': {}", name, entry_point, *error);
+			return std::unexpected{*error};
+		}
+		if (!specialized)
+		{
+			return std::unexpected{std::format("Failed to specialize '{}':'{}'", name, entry_point)};
+		}
+		program = std::move(specialized);
+	}
+
 	Logger::instance().trace("Successfully loaded shader program '{}':'{}'", name, entry_point);
 	return program;
 }
@@ -941,12 +976,20 @@ vk::ShaderStageFlagBits ShaderDetails::stage() const
 // ============================================================================
 
 std::expected<Shader, std::string> Shader::create_shader(vk::Device device, std::string_view name,
-														 std::string_view entry_point)
+														 std::string_view entry_point,
+														 std::span<const std::string> specialization)
 {
 	Logger::instance().info("Creating shader '{}':'{}'", name, entry_point);
+	auto trace_scope = ifs::StartupTrace::instance().phase(std::format("shader:{}", name));
+
+	static auto& compiles = ifs::MetricsRegistry::instance().counter(
+		"ifs_shader_compiles_total", "Shader modules compiled from Slang source");
+	static auto& compile_seconds = ifs::MetricsRegistry::instance().counter(
+		"ifs_shader_compile_seconds_total", "Time spent compiling shaders");
+	auto compile_start = std::chrono::steady_clock::now();
 
 	auto linked =
-		load_shader_program(name, entry_point).and_then([](auto prog) { return link_program(std::move(prog)); });
+		load_shader_program(name, entry_point, specialization).and_then([](auto prog) { return link_program(std::move(prog)); });
 
 	if (!linked)
 	{
@@ -965,11 +1008,35 @@ std::expected<Shader, std::string> Shader::create_shader(vk::Device device, std:
 	auto descriptors	= extract_descriptors(linked->get(), stage);
 	auto module			= create_shader_module(device, spirv->get());
 
+	compiles.add();
+	compile_seconds.add(std::chrono::duration<double>(std::chrono::steady_clock::now() - compile_start).count());
+
 	Logger::instance().info("Shader '{}' created successfully ({} descriptors)", name, descriptors.size());
 
 	return Shader{device, module, stage, details, descriptors, push_constants, std::string{entry_point}};
 }
 
+size_t Shader::preload_modules(std::span<const std::string> names)
+{
+	auto*  session = get_session();
+	size_t loaded  = 0;
+	for (const auto& name : names)
+	{
+		Slang::ComPtr<slang::IBlob> diagnostics;
+		// The session caches loaded modules, create_shader() picks them up by name
+		Slang::ComPtr<slang::IModule> module(session->loadModule(name.c_str(), diagnostics.writeRef()));
+		if (auto error = check_diagnostics(diagnostics.get()); error || !module)
+		{
+			// Not fatal here, create_shader() reports the error when the module is actually needed
+			Logger::instance().warn("Failed to preload shader module '{}'", name);
+			continue;
+		}
+		loaded++;
+	}
+	Logger::instance().debug("Preloaded {}/{} shader modules", loaded, names.size());
+	return loaded;
+}
+
 const std::vector<DescriptorInfo>& Shader::get_descriptor_infos() const
 {
 	return m_descriptor_infos;
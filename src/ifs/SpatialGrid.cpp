@@ -0,0 +1,715 @@
+#include <ifs/SpatialGrid.hpp>
+#include <ifs/Logger.hpp>
+#include <ifs/StartupTrace.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <limits>
+
+namespace ifs {
+
+namespace {
+
+constexpr uint32_t GROUP_SIZE = 256;
+constexpr uint32_t SCAN_BLOCK = 1024;
+constexpr uint32_t MAX_STRIDE_GROUPS = 4096;  ///< Workgroups of the grid-stride particle passes
+constexpr uint32_t MAX_GROUPS_X = 65535;
+constexpr uint32_t EMPTY = 0xffffffffu;
+constexpr uint32_t BINDING_COUNT = 7;
+
+constexpr std::array KERNEL_SHADERS = {
+    "ifs_modular/analysis/spatial_grid/bounds.slang",
+    "ifs_modular/analysis/spatial_grid/setup.slang",
+    "ifs_modular/analysis/spatial_grid/count.slang",
+    "ifs_modular/analysis/spatial_grid/scan_blocks.slang",
+    "ifs_modular/analysis/spatial_grid/scan_sums.slang",
+    "ifs_modular/analysis/spatial_grid/scan_add.slang",
+    "ifs_modular/analysis/spatial_grid/scatter.slang",
+    "ifs_modular/analysis/spatial_grid/pick.slang",
+    "ifs_modular/analysis/spatial_grid/radius.slang",
+};
+
+uint32_t div_up(uint32_t value, uint32_t divisor) {
+    return (value + divisor - 1) / divisor;
+}
+
+} // anonymous namespace
+
+SpatialGrid::SpatialGrid(const VulkanContext& context, SpatialGridConfig config)
+    : m_context(&context)
+    , m_device(context.device())
+    , m_config(config)
+    , m_descriptor_layout(nullptr)
+    , m_pipeline_layout(nullptr)
+    , m_descriptor_pool(nullptr)
+    , m_descriptor_set(nullptr)
+    , m_grid_buffer(nullptr)
+    , m_grid_memory(nullptr)
+    , m_cell_counts(nullptr)
+    , m_cell_counts_memory(nullptr)
+    , m_cell_start(nullptr)
+    , m_cell_start_memory(nullptr)
+    , m_block_sums(nullptr)
+    , m_block_sums_memory(nullptr)
+    , m_sorted_indices(nullptr)
+    , m_sorted_indices_memory(nullptr)
+    , m_command_pool(nullptr)
+    , m_build_cmd(nullptr)
+    , m_query_cmd(nullptr)
+    , m_build_fence(nullptr)
+    , m_query_fence(nullptr)
+    , m_particle_buffer(nullptr)
+{}
+
+std::expected<std::unique_ptr<SpatialGrid>, std::string> SpatialGrid::create(
+    const VulkanContext& context,
+    SpatialGridConfig config
+) {
+    config.resolution = std::clamp(config.resolution, 4u, MAX_RESOLUTION);
+    config.max_results = std::max(config.max_results, 1u);
+
+    auto grid = std::unique_ptr<SpatialGrid>(new SpatialGrid(context, config));
+    if (auto result = grid->initialize(); !result) {
+        return std::unexpected(result.error());
+    }
+    return grid;
+}
+
+SpatialGrid::~SpatialGrid() {
+    wait_idle();
+
+    if (m_build_fence) m_device.destroyFence(m_build_fence);
+    if (m_query_fence) m_device.destroyFence(m_query_fence);
+    if (m_command_pool) m_device.destroyCommandPool(m_command_pool);
+
+    for (auto pipeline : m_pipelines) {
+        if (pipeline) m_device.destroyPipeline(pipeline);
+    }
+    if (m_pipeline_layout) m_device.destroyPipelineLayout(m_pipeline_layout);
+    if (m_descriptor_pool) m_device.destroyDescriptorPool(m_descriptor_pool);
+    if (m_descriptor_layout) m_device.destroyDescriptorSetLayout(m_descriptor_layout);
+
+    std::array buffers = {
+        std::pair{m_grid_buffer, m_grid_memory},
+        std::pair{m_cell_counts, m_cell_counts_memory},
+        std::pair{m_cell_start, m_cell_start_memory},
+        std::pair{m_block_sums, m_block_sums_memory},
+        std::pair{m_sorted_indices, m_sorted_indices_memory},
+    };
+    for (auto [buffer, memory] : buffers) {
+        if (buffer) m_device.destroyBuffer(buffer);
+        if (memory) m_device.freeMemory(memory);
+    }
+}
+
+std::expected<void, std::string> SpatialGrid::initialize() {
+    m_cell_capacity = m_config.resolution * m_config.resolution * m_config.resolution;
+
+    if (auto result = create_pipelines(); !result) {
+        return std::unexpected(result.error());
+    }
+    if (auto result = create_buffers(); !result) {
+        return std::unexpected(result.error());
+    }
+    if (auto result = create_commands(); !result) {
+        return std::unexpected(result.error());
+    }
+
+    Logger::instance().info("Spatial grid ready: {}^3 cells, {} query results",
+        m_config.resolution, m_config.max_results);
+    return {};
+}
+
+std::expected<void, std::string> SpatialGrid::create_pipelines() {
+    auto trace_scope = StartupTrace::instance().phase("pipeline:SpatialGrid");
+
+    // One layout for all kernels: every binding is a storage buffer
+    std::array<vk::DescriptorSetLayoutBinding, BINDING_COUNT> bindings;
+    for (uint32_t i = 0; i < BINDING_COUNT; i++) {
+        bindings[i] = vk::DescriptorSetLayoutBinding()
+            .setBinding(i)
+            .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+            .setDescriptorCount(1)
+            .setStageFlags(vk::ShaderStageFlagBits::eCompute);
+    }
+
+	auto layout_res = m_device.createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo().setBindings(bindings));
+	if (layout_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create spatial grid descriptor layout: {}", to_string(layout_res.result)));
+	}
+	m_descriptor_layout = layout_res.value;
+
+    auto push_constant_range = vk::PushConstantRange()
+        .setStageFlags(vk::ShaderStageFlagBits::eCompute)
+        .setOffset(0)
+        .setSize(sizeof(GridPush));
+
+    auto pipeline_layout_info = vk::PipelineLayoutCreateInfo()
+        .setSetLayouts(m_descriptor_layout)
+        .setPushConstantRanges(push_constant_range);
+
+	auto pipeline_layout_res = m_device.createPipelineLayout(pipeline_layout_info);
+	if (pipeline_layout_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create spatial grid pipeline layout: {}", to_string(pipeline_layout_res.result)));
+	}
+	m_pipeline_layout = pipeline_layout_res.value;
+
+    for (size_t i = 0; i < KERNEL_SHADERS.size(); i++) {
+        auto shader = Shader::create_shader(m_device, KERNEL_SHADERS[i], "main");
+        if (!shader) {
+            return std::unexpected(std::format("Failed to load {}: {}", KERNEL_SHADERS[i], shader.error()));
+        }
+        if (!std::holds_alternative<ComputeDetails>(shader->get_details())) {
+            return std::unexpected(std::format("{} is not a compute shader", KERNEL_SHADERS[i]));
+        }
+
+        auto pipeline_info = vk::ComputePipelineCreateInfo()
+            .setStage(shader->create_pipeline_shader_stage_create_info())
+            .setLayout(m_pipeline_layout);
+
+		auto pipeline_res = m_device.createComputePipeline(nullptr, pipeline_info);
+		if (pipeline_res.result != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Failed to create {} pipeline: {}", KERNEL_SHADERS[i], to_string(pipeline_res.result)));
+		}
+		m_pipelines[i] = pipeline_res.value;
+        m_shaders.push_back(std::move(*shader));
+    }
+
+    return {};
+}
+
+std::expected<vk::Buffer, std::string> SpatialGrid::create_device_buffer(vk::DeviceSize size, vk::DeviceMemory& memory) {
+    auto buffer_info = vk::BufferCreateInfo()
+        .setSize(size)
+        .setUsage(vk::BufferUsageFlagBits::eStorageBuffer |
+                  vk::BufferUsageFlagBits::eTransferDst |
+                  vk::BufferUsageFlagBits::eTransferSrc)
+        .setSharingMode(vk::SharingMode::eExclusive);
+
+	auto buffer_res = m_device.createBuffer(buffer_info);
+	if (buffer_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create spatial grid buffer: {}", to_string(buffer_res.result)));
+	}
+
+    auto requirements = m_device.getBufferMemoryRequirements(buffer_res.value);
+    auto memory_type = m_context->find_memory_type(requirements.memoryTypeBits,
+        vk::MemoryPropertyFlagBits::eDeviceLocal);
+    if (!memory_type) {
+        m_device.destroyBuffer(buffer_res.value);
+        return std::unexpected("Failed to find device-local memory for spatial grid");
+    }
+
+	auto alloc_res = m_device.allocateMemory(vk::MemoryAllocateInfo(requirements.size, *memory_type));
+	if (alloc_res.result != vk::Result::eSuccess)
+	{
+		m_device.destroyBuffer(buffer_res.value);
+		return std::unexpected(std::format("Failed to allocate spatial grid memory ({} bytes): {}", size, to_string(alloc_res.result)));
+	}
+	memory = alloc_res.value;
+
+    auto _ = m_device.bindBufferMemory(buffer_res.value, memory, 0);
+    return buffer_res.value;
+}
+
+std::expected<void, std::string> SpatialGrid::create_buffers() {
+    const vk::DeviceSize cell_bytes = static_cast<vk::DeviceSize>(m_cell_capacity) * sizeof(uint32_t);
+    const vk::DeviceSize block_bytes = static_cast<vk::DeviceSize>(div_up(m_cell_capacity, SCAN_BLOCK)) * sizeof(uint32_t);
+
+    struct Allocation {
+        vk::DeviceSize size;
+        vk::Buffer* buffer;
+        vk::DeviceMemory* memory;
+    };
+    std::array allocations = {
+        Allocation{sizeof(GridInfo), &m_grid_buffer, &m_grid_memory},
+        Allocation{cell_bytes, &m_cell_counts, &m_cell_counts_memory},
+        Allocation{cell_bytes, &m_cell_start, &m_cell_start_memory},
+        Allocation{block_bytes, &m_block_sums, &m_block_sums_memory},
+    };
+    for (auto& allocation : allocations) {
+        auto buffer = create_device_buffer(allocation.size, *allocation.memory);
+        if (!buffer) {
+            return std::unexpected(buffer.error());
+        }
+        *allocation.buffer = *buffer;
+    }
+
+    // Two header words, then (index, distance) pairs; picks use one pair per ray step
+    const vk::DeviceSize result_words = 2 + 2 * static_cast<vk::DeviceSize>(std::max(m_config.max_results, MAX_PICK_STEPS));
+    auto results = ReadbackBuffer::create(*m_context, result_words * sizeof(uint32_t),
+        vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst);
+    if (!results) {
+        return std::unexpected(results.error());
+    }
+    m_results = std::move(*results);
+
+    auto info_readback = ReadbackBuffer::create(*m_context, sizeof(GridInfo));
+    if (!info_readback) {
+        return std::unexpected(info_readback.error());
+    }
+    m_info_readback = std::move(*info_readback);
+
+    auto pool_size = vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, BINDING_COUNT);
+	auto pool_res = m_device.createDescriptorPool(vk::DescriptorPoolCreateInfo().setMaxSets(1).setPoolSizes(pool_size));
+	if (pool_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create spatial grid descriptor pool: {}", to_string(pool_res.result)));
+	}
+	m_descriptor_pool = pool_res.value;
+
+	auto set_res = m_device.allocateDescriptorSets(vk::DescriptorSetAllocateInfo(m_descriptor_pool, m_descriptor_layout));
+	if (set_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to allocate spatial grid descriptor set: {}", to_string(set_res.result)));
+	}
+	m_descriptor_set = set_res.value.front();
+
+    // Particles (0) and sorted indices (4) are bound by build()
+    std::array fixed = {
+        std::pair{1u, m_grid_buffer},
+        std::pair{2u, m_cell_counts},
+        std::pair{3u, m_cell_start},
+        std::pair{5u, m_block_sums},
+        std::pair{6u, m_results->buffer()},
+    };
+    std::array<vk::DescriptorBufferInfo, fixed.size()> infos;
+    std::array<vk::WriteDescriptorSet, fixed.size()> writes;
+    for (size_t i = 0; i < fixed.size(); i++) {
+        infos[i] = vk::DescriptorBufferInfo(fixed[i].second, 0, VK_WHOLE_SIZE);
+        writes[i] = vk::WriteDescriptorSet()
+            .setDstSet(m_descriptor_set)
+            .setDstBinding(fixed[i].first)
+            .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+            .setDescriptorCount(1)
+            .setBufferInfo(infos[i]);
+    }
+    m_device.updateDescriptorSets(writes, {});
+
+    return {};
+}
+
+std::expected<void, std::string> SpatialGrid::create_commands() {
+    const uint32_t family = m_context->queue_indices().graphics;
+
+    auto pool_info = vk::CommandPoolCreateInfo()
+        .setFlags(vk::CommandPoolCreateFlagBits::eResetCommandBuffer)
+        .setQueueFamilyIndex(family);
+
+	auto pool_res = m_device.createCommandPool(pool_info);
+	if (pool_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create spatial grid command pool: {}", to_string(pool_res.result)));
+	}
+	m_command_pool = pool_res.value;
+
+	auto cmd_res = m_device.allocateCommandBuffers(
+		vk::CommandBufferAllocateInfo(m_command_pool, vk::CommandBufferLevel::ePrimary, 2));
+	if (cmd_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to allocate spatial grid command buffers: {}", to_string(cmd_res.result)));
+	}
+	m_build_cmd = cmd_res.value[0];
+	m_query_cmd = cmd_res.value[1];
+
+    for (auto* fence : {&m_build_fence, &m_query_fence}) {
+		auto fence_res = m_device.createFence({vk::FenceCreateFlagBits::eSignaled});
+		if (fence_res.result != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Failed to create spatial grid fence: {}", to_string(fence_res.result)));
+		}
+		*fence = fence_res.value;
+    }
+
+    auto build_profiler = TimestampProfiler::create(*m_context, 1, family);
+    if (!build_profiler) {
+        return std::unexpected(build_profiler.error());
+    }
+    m_build_profiler = std::move(*build_profiler);
+
+    auto query_profiler = TimestampProfiler::create(*m_context, 1, family);
+    if (!query_profiler) {
+        return std::unexpected(query_profiler.error());
+    }
+    m_query_profiler = std::move(*query_profiler);
+
+    return {};
+}
+
+void SpatialGrid::bind(vk::CommandBuffer cmd, Kernel kernel, const GridPush& push) const {
+    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, m_pipelines[static_cast<size_t>(kernel)]);
+    cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_pipeline_layout, 0, m_descriptor_set, {});
+    cmd.pushConstants(m_pipeline_layout, vk::ShaderStageFlagBits::eCompute, 0, sizeof(GridPush), &push);
+}
+
+void SpatialGrid::compute_barrier(vk::CommandBuffer cmd) {
+    auto barrier = vk::MemoryBarrier()
+        .setSrcAccessMask(vk::AccessFlagBits::eShaderWrite | vk::AccessFlagBits::eTransferWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite |
+                          vk::AccessFlagBits::eTransferWrite);
+    cmd.pipelineBarrier(
+        vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eTransfer,
+        vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eTransfer,
+        {},
+        barrier,
+        {},
+        {}
+    );
+}
+
+// ============================================================================
+// Build
+// ============================================================================
+
+std::expected<void, std::string> SpatialGrid::build(vk::Buffer particle_buffer, uint32_t particle_count) {
+    wait_idle();
+    m_info.reset();
+    if (particle_count == 0) {
+        return {};
+    }
+
+    if (particle_count > m_sorted_capacity) {
+        if (m_sorted_indices) {
+            m_device.destroyBuffer(m_sorted_indices);
+            m_device.freeMemory(m_sorted_indices_memory);
+            m_sorted_indices = nullptr;
+            m_sorted_indices_memory = nullptr;
+            m_sorted_capacity = 0;
+        }
+        auto buffer = create_device_buffer(static_cast<vk::DeviceSize>(particle_count) * sizeof(uint32_t),
+            m_sorted_indices_memory);
+        if (!buffer) {
+            return std::unexpected(buffer.error());
+        }
+        m_sorted_indices = *buffer;
+        m_sorted_capacity = particle_count;
+    }
+
+    // The particle buffer may have been reallocated by the backend, and the
+    // sorted indices by the growth above; both fences are idle here
+    std::array infos = {
+        vk::DescriptorBufferInfo(particle_buffer, 0, VK_WHOLE_SIZE),
+        vk::DescriptorBufferInfo(m_sorted_indices, 0, VK_WHOLE_SIZE),
+    };
+    std::array writes = {
+        vk::WriteDescriptorSet().setDstSet(m_descriptor_set).setDstBinding(0)
+            .setDescriptorType(vk::DescriptorType::eStorageBuffer).setBufferInfo(infos[0]),
+        vk::WriteDescriptorSet().setDstSet(m_descriptor_set).setDstBinding(4)
+            .setDescriptorType(vk::DescriptorType::eStorageBuffer).setBufferInfo(infos[1]),
+    };
+    m_device.updateDescriptorSets(writes, {});
+    m_particle_buffer = particle_buffer;
+    m_particle_count = particle_count;
+
+    const uint32_t stride_groups = std::min(div_up(particle_count, GROUP_SIZE), MAX_STRIDE_GROUPS);
+    const uint32_t scan_groups = div_up(m_cell_capacity, SCAN_BLOCK);
+    GridPush push;
+    push.counts = glm::uvec4(particle_count, m_cell_capacity, stride_groups * GROUP_SIZE, m_config.resolution);
+
+    m_build_profiler->reset();
+    auto cmd = m_build_cmd;
+    auto _ = cmd.reset();
+    auto _ = cmd.begin(vk::CommandBufferBeginInfo().setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+    auto scope = m_build_profiler->begin_scope(cmd, "spatial_grid_build");
+
+    // Bounds start at (+max, -max) in the ordered encoding
+    cmd.fillBuffer(m_grid_buffer, offsetof(GridInfo, bounds_min), sizeof(glm::uvec4), 0xffffffffu);
+    cmd.fillBuffer(m_grid_buffer, offsetof(GridInfo, bounds_max), sizeof(glm::uvec4), 0u);
+    cmd.fillBuffer(m_cell_counts, 0, VK_WHOLE_SIZE, 0u);
+    compute_barrier(cmd);
+
+    bind(cmd, Kernel::Bounds, push);
+    cmd.dispatch(stride_groups, 1, 1);
+    compute_barrier(cmd);
+
+    bind(cmd, Kernel::Setup, push);
+    cmd.dispatch(1, 1, 1);
+    compute_barrier(cmd);
+
+    bind(cmd, Kernel::Count, push);
+    cmd.dispatch(stride_groups, 1, 1);
+    compute_barrier(cmd);
+
+    bind(cmd, Kernel::ScanBlocks, push);
+    cmd.dispatch(scan_groups, 1, 1);
+    compute_barrier(cmd);
+
+    bind(cmd, Kernel::ScanSums, push);
+    cmd.dispatch(1, 1, 1);
+    compute_barrier(cmd);
+
+    bind(cmd, Kernel::ScanAdd, push);
+    cmd.dispatch(scan_groups, 1, 1);
+    compute_barrier(cmd);
+
+    // Counts become the per-cell cursors of the scatter
+    cmd.fillBuffer(m_cell_counts, 0, VK_WHOLE_SIZE, 0u);
+    compute_barrier(cmd);
+
+    bind(cmd, Kernel::Scatter, push);
+    cmd.dispatch(stride_groups, 1, 1);
+    compute_barrier(cmd);
+
+    cmd.copyBuffer(m_grid_buffer, m_info_readback->buffer(), vk::BufferCopy(0, 0, sizeof(GridInfo)));
+    auto to_host = vk::MemoryBarrier()
+        .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eHostRead);
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eHost, {}, to_host, {}, {});
+
+    m_build_profiler->end_scope(cmd, scope);
+    auto _ = cmd.end();
+
+    auto _ = m_device.resetFences(m_build_fence);
+	auto submit_res = m_context->graphics_queue().submit(vk::SubmitInfo().setCommandBuffers(cmd), m_build_fence);
+	if (submit_res != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to submit spatial grid build: {}", to_string(submit_res)));
+	}
+    m_build_pending = true;
+    return {};
+}
+
+bool SpatialGrid::ready() {
+    if (m_build_pending && m_device.getFenceStatus(m_build_fence) == vk::Result::eSuccess) {
+        m_build_pending = false;
+        m_info_readback->invalidate();
+        GridInfo info;
+        std::memcpy(&info, m_info_readback->data(), sizeof(GridInfo));
+        m_info = info;
+
+        auto scopes = m_build_profiler->resolve();
+        m_build_ms = scopes.empty() ? 0.0 : scopes.front().duration_ms;
+        Logger::instance().debug("Spatial grid built: {}x{}x{} cells over {} particles in {:.3f} ms",
+            info.dims.x, info.dims.y, info.dims.z, m_particle_count, m_build_ms);
+    }
+    return !m_build_pending && m_info.has_value();
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+std::expected<vk::CommandBuffer, std::string> SpatialGrid::begin_query() {
+    if (busy()) {
+        return std::unexpected("A spatial query is already in flight");
+    }
+    if (!ready()) {
+        return std::unexpected("Spatial grid is not built");
+    }
+
+    m_query_profiler->reset();
+    auto cmd = m_query_cmd;
+    auto _ = cmd.reset();
+    auto _ = cmd.begin(vk::CommandBufferBeginInfo().setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+    m_query_scope = m_query_profiler->begin_scope(cmd, "spatial_grid_query");
+    return cmd;
+}
+
+std::expected<void, std::string> SpatialGrid::submit_query(vk::CommandBuffer cmd, PendingQuery pending) {
+    auto to_host = vk::MemoryBarrier()
+        .setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eHostRead);
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eHost, {}, to_host, {}, {});
+
+    m_query_profiler->end_scope(cmd, m_query_scope);
+    auto _ = cmd.end();
+
+    auto _ = m_device.resetFences(m_query_fence);
+	auto submit_res = m_context->graphics_queue().submit(vk::SubmitInfo().setCommandBuffers(cmd), m_query_fence);
+	if (submit_res != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to submit spatial query: {}", to_string(submit_res)));
+	}
+    m_pending = pending;
+    return {};
+}
+
+std::expected<void, std::string> SpatialGrid::pick(const glm::vec3& origin, const glm::vec3& direction, float cone_slope) {
+    auto cmd = begin_query();
+    if (!cmd) {
+        return std::unexpected(cmd.error());
+    }
+    const auto& info = *m_info;
+    const float cell = info.origin.w;
+    const glm::vec3 grid_min = glm::vec3(info.origin);
+    const glm::vec3 grid_max = grid_min + glm::vec3(info.dims) * cell;
+
+    // Slab test against the grid box, widened by the cone radius at its far corner
+    const float margin = cone_slope * (glm::length(grid_max - origin) + glm::length(grid_min - origin));
+    float t_enter = 0.0f;
+    float t_exit = std::numeric_limits<float>::max();
+    for (int axis = 0; axis < 3; axis++) {
+        const float lo = grid_min[axis] - margin;
+        const float hi = grid_max[axis] + margin;
+        if (std::abs(direction[axis]) < 1e-12f) {
+            if (origin[axis] < lo || origin[axis] > hi) {
+                t_exit = -1.0f;
+            }
+            continue;
+        }
+        float t0 = (lo - origin[axis]) / direction[axis];
+        float t1 = (hi - origin[axis]) / direction[axis];
+        if (t0 > t1) std::swap(t0, t1);
+        t_enter = std::max(t_enter, t0);
+        t_exit = std::min(t_exit, t1);
+    }
+
+    uint32_t steps = 0;
+    GridPush push;
+    if (t_exit > t_enter) {
+        const float step = std::max(cell, (t_exit - t_enter) / MAX_PICK_STEPS);
+        steps = std::min(static_cast<uint32_t>(std::ceil((t_exit - t_enter) / step)), MAX_PICK_STEPS);
+        push.origin = glm::vec4(origin, cone_slope);
+        push.direction = glm::vec4(direction, step);
+        push.range = glm::vec4(t_enter, t_exit, 0.0f, 0.0f);
+        push.counts = glm::uvec4(m_particle_count, m_cell_capacity, 0, m_config.resolution);
+
+        compute_barrier(*cmd);
+        bind(*cmd, Kernel::Pick, push);
+        cmd->dispatch(steps, 1, 1);
+    }
+
+    return submit_query(*cmd, PendingQuery{.kind = SpatialQueryKind::Pick, .steps = steps});
+}
+
+void SpatialGrid::record_radius(vk::CommandBuffer cmd, const glm::vec3& center, float radius) const {
+    const auto& info = *m_info;
+    const float cell = info.origin.w;
+    const glm::vec3 grid_min = glm::vec3(info.origin);
+    const glm::ivec3 max_cell = glm::ivec3(info.dims) - 1;
+
+    const auto lo = glm::clamp(glm::ivec3(glm::floor((center - radius - grid_min) / cell)), glm::ivec3(0), max_cell);
+    const auto hi = glm::clamp(glm::ivec3(glm::floor((center + radius - grid_min) / cell)), glm::ivec3(0), max_cell);
+    const auto box = glm::uvec3(hi - lo + 1);
+    const uint32_t box_cells = box.x * box.y * box.z;
+
+    GridPush push;
+    push.origin = glm::vec4(center, radius);
+    push.cell_min = glm::uvec4(glm::uvec3(lo), 0);
+    push.box_dims = glm::uvec4(box, m_config.max_results);
+    push.counts = glm::uvec4(m_particle_count, m_cell_capacity, 0, m_config.resolution);
+
+    cmd.fillBuffer(m_results->buffer(), 0, 2 * sizeof(uint32_t), 0u);
+    compute_barrier(cmd);
+    bind(cmd, Kernel::Radius, push);
+    cmd.dispatch(std::min(box_cells, MAX_GROUPS_X), div_up(box_cells, MAX_GROUPS_X), 1);
+}
+
+std::expected<void, std::string> SpatialGrid::query_radius(const glm::vec3& center, float radius) {
+    auto cmd = begin_query();
+    if (!cmd) {
+        return std::unexpected(cmd.error());
+    }
+    record_radius(*cmd, center, radius);
+    return submit_query(*cmd, PendingQuery{.kind = SpatialQueryKind::Radius, .center = center, .radius = radius});
+}
+
+std::expected<void, std::string> SpatialGrid::query_nearest(const glm::vec3& center, uint32_t k) {
+    if (k == 0 || k > m_config.max_results) {
+        return std::unexpected(std::format("k must be between 1 and {}", m_config.max_results));
+    }
+    auto cmd = begin_query();
+    if (!cmd) {
+        return std::unexpected(cmd.error());
+    }
+    // Start with a sphere of about one cell and grow or shrink in poll()
+    const float radius = m_info->origin.w;
+    record_radius(*cmd, center, radius);
+    return submit_query(*cmd, PendingQuery{.kind = SpatialQueryKind::Nearest, .center = center, .radius = radius, .k = k});
+}
+
+std::optional<SpatialQueryResult> SpatialGrid::poll() {
+    if (!m_pending || m_device.getFenceStatus(m_query_fence) != vk::Result::eSuccess) {
+        return std::nullopt;
+    }
+    auto pending = *m_pending;
+    m_pending.reset();
+
+    m_results->invalidate();
+    const auto* words = static_cast<const uint32_t*>(m_results->data());
+    auto scopes = m_query_profiler->resolve();
+    pending.gpu_ms += scopes.empty() ? 0.0 : scopes.front().duration_ms;
+
+    SpatialQueryResult result{.kind = pending.kind, .gpu_ms = pending.gpu_ms};
+
+    if (pending.kind == SpatialQueryKind::Pick) {
+        // Steps are ordered along the ray, so the first hit is the nearest
+        for (uint32_t step = 0; step < pending.steps; step++) {
+            if (words[step * 2] != EMPTY) {
+                float t;
+                std::memcpy(&t, &words[step * 2 + 1], sizeof(float));
+                result.hits.push_back({words[step * 2], t});
+                result.total = 1;
+                break;
+            }
+        }
+        return result;
+    }
+
+    const uint32_t total = words[0];
+    const uint32_t stored = std::min(total, m_config.max_results);
+    result.total = total;
+    result.hits.reserve(stored);
+    for (uint32_t i = 0; i < stored; i++) {
+        float distance_sq;
+        std::memcpy(&distance_sq, &words[3 + i * 2], sizeof(float));
+        result.hits.push_back({words[2 + i * 2], std::sqrt(distance_sq)});
+    }
+
+    if (pending.kind == SpatialQueryKind::Radius) {
+        return result;
+    }
+
+    // Nearest: every particle closer than the radius is in the result once it
+    // didn't overflow, so the k smallest are exact when there are at least k
+    const auto& info = *m_info;
+    const float grid_diagonal = glm::length(glm::vec3(info.dims) * info.origin.w);
+    const bool overflow = total > m_config.max_results;
+    const bool enough = total >= pending.k;
+    const bool exhausted = !enough && pending.radius > 2.0f * grid_diagonal;
+    // More than max_results particles share (almost) one point: return the stored subset
+    const bool degenerate = overflow && pending.radius - pending.lower_radius < info.origin.w * 1e-4f;
+    if ((!overflow && enough) || exhausted || degenerate) {
+        std::ranges::sort(result.hits, {}, &SpatialHit::distance);
+        result.hits.resize(std::min<size_t>(result.hits.size(), pending.k));
+        result.total = static_cast<uint32_t>(result.hits.size());
+        return result;
+    }
+
+    // Too few: double the radius until one overflows, then bisect between the
+    // two bounds, so no step goes back past a radius known to overflow
+    if (overflow) {
+        pending.upper_radius = pending.radius;
+    } else {
+        pending.lower_radius = pending.radius;
+    }
+    pending.radius = pending.upper_radius > 0.0f
+        ? (pending.lower_radius + pending.upper_radius) * 0.5f
+        : pending.radius * 2.0f;
+    auto cmd = begin_query();
+    if (!cmd) {
+        Logger::instance().error("Nearest query aborted: {}", cmd.error());
+        return std::nullopt;
+    }
+    record_radius(*cmd, pending.center, pending.radius);
+    if (auto submitted = submit_query(*cmd, pending); !submitted) {
+        Logger::instance().error("Nearest query aborted: {}", submitted.error());
+    }
+    return std::nullopt;
+}
+
+void SpatialGrid::wait_idle() {
+    if (m_build_fence) {
+        auto _ = m_device.waitForFences(m_build_fence, true, UINT64_MAX);
+        ready();
+    }
+    if (m_query_fence) {
+        auto _ = m_device.waitForFences(m_query_fence, true, UINT64_MAX);
+    }
+}
+
+} // namespace ifs
@@ -0,0 +1,149 @@
+#include <ifs/StageChain.hpp>
+#include <format>
+
+namespace ifs {
+
+std::string_view to_string(PostStage stage) {
+    switch (stage) {
+        case PostStage::GlobalScale: return "GlobalScale";
+        case PostStage::FinalAffine: return "FinalAffine";
+        case PostStage::Spherical: return "Spherical";
+        case PostStage::Swirl: return "Swirl";
+    }
+    return "NoPost";
+}
+
+std::string_view to_string(ColorStage stage) {
+    switch (stage) {
+        case ColorStage::Orbit: return "OrbitColor";
+        case ColorStage::Radial: return "RadialColor";
+        case ColorStage::PositionPalette: return "PositionPalette";
+        case ColorStage::History: return "HistoryColor";
+    }
+    return "OrbitColor";
+}
+
+std::string_view to_string(WriteStage stage) {
+    switch (stage) {
+        case WriteStage::Particle: return "WriteParticle";
+        case WriteStage::Position: return "WritePosition";
+        case WriteStage::Indexed: return "WriteIndexed";
+    }
+    return "WriteParticle";
+}
+
+std::vector<std::string> StageChain::specialization() const {
+    // Fold from the back: [A, B, C] -> Then<A, Then<B, C>>
+    std::string chain = post.empty() ? "NoPost" : std::string(to_string(post.back()));
+    for (size_t i = post.size(); i-- > 1;) {
+        chain = std::format("Then<{}, {}>", to_string(post[i - 1]), chain);
+    }
+    return {chain, std::string(to_string(color)), std::string(to_string(write))};
+}
+
+std::string StageChain::describe() const {
+    std::string text;
+    for (auto stage : post) {
+        text += text.empty() ? std::string(to_string(stage)) : std::format(" > {}", to_string(stage));
+    }
+    return std::format("{} | {} | {}", text.empty() ? "NoPost" : text, to_string(color), to_string(write));
+}
+
+GPUStageParams make_stage_params(const StageSettings& settings, float scale) {
+    GPUStageParams params{};
+    const glm::mat3 inverse_linear = glm::inverse(settings.final_linear);
+    const glm::vec3 inverse_offset = -(inverse_linear * settings.final_offset);
+    for (int row = 0; row < 3; row++) {
+        params.final_rows[row] = glm::vec4(settings.final_linear[0][row], settings.final_linear[1][row],
+                                           settings.final_linear[2][row], settings.final_offset[row]);
+        params.final_inverse[row] = glm::vec4(inverse_linear[0][row], inverse_linear[1][row],
+                                              inverse_linear[2][row], inverse_offset[row]);
+    }
+    for (size_t i = 0; i < settings.palette.size(); i++) {
+        params.palette[i] = glm::vec4(settings.palette[i], 0.0f);
+    }
+    params.scale = scale != 0.0f ? scale : 1.0f;
+    params.swirl = settings.swirl;
+    return params;
+}
+
+// ============================================================================
+// StageUniformBuffer
+// ============================================================================
+
+StageUniformBuffer::StageUniformBuffer(vk::Device device)
+    : m_device(device)
+    , m_buffer(nullptr)
+    , m_memory(nullptr)
+{}
+
+std::expected<std::unique_ptr<StageUniformBuffer>, std::string> StageUniformBuffer::create(const VulkanContext& context) {
+    auto uniforms = std::unique_ptr<StageUniformBuffer>(new StageUniformBuffer(context.device()));
+    auto device = context.device();
+
+    auto buffer_info = vk::BufferCreateInfo()
+        .setSize(2 * sizeof(GPUStageParams))
+        .setUsage(vk::BufferUsageFlagBits::eUniformBuffer)
+        .setSharingMode(vk::SharingMode::eExclusive);
+
+	auto buffer_res = device.createBuffer(buffer_info);
+	if (buffer_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create stage uniform buffer: {}", to_string(buffer_res.result)));
+	}
+	uniforms->m_buffer = buffer_res.value;
+
+    auto requirements = device.getBufferMemoryRequirements(uniforms->m_buffer);
+    const auto flags = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+
+    auto memory_type = context.find_memory_type(requirements.memoryTypeBits, flags);
+    if (!memory_type) {
+        return std::unexpected("Failed to find host-visible memory for stage uniforms");
+    }
+
+	auto alloc_res = device.allocateMemory(vk::MemoryAllocateInfo(requirements.size, *memory_type));
+	if (alloc_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to allocate stage uniform memory: {}", to_string(alloc_res.result)));
+	}
+	uniforms->m_memory = alloc_res.value;
+
+	auto bind_res = device.bindBufferMemory(uniforms->m_buffer, uniforms->m_memory, 0);
+	if (bind_res != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to bind stage uniform memory: {}", to_string(bind_res)));
+	}
+
+	auto map_res = device.mapMemory(uniforms->m_memory, 0, VK_WHOLE_SIZE);
+	if (map_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to map stage uniform memory: {}", to_string(map_res.result)));
+	}
+	uniforms->m_mapped = static_cast<GPUStageParams*>(map_res.value);
+
+    // Identity chain until the first upload
+    uniforms->m_mapped[0] = make_stage_params({}, 1.0f);
+    uniforms->m_mapped[1] = uniforms->m_mapped[0];
+    return uniforms;
+}
+
+StageUniformBuffer::~StageUniformBuffer() {
+    if (m_buffer) {
+        m_device.destroyBuffer(m_buffer);
+    }
+    if (m_memory) {
+        m_device.freeMemory(m_memory);  // Implicitly unmaps
+    }
+}
+
+void StageUniformBuffer::upload(const GPUStageParams& params) {
+    m_mapped[1] = m_uploaded ? m_mapped[0] : params;
+    m_mapped[0] = params;
+    m_uploaded = true;
+}
+
+vk::DescriptorBufferInfo StageUniformBuffer::descriptor_info() const {
+    return vk::DescriptorBufferInfo(m_buffer, 0, 2 * sizeof(GPUStageParams));
+}
+
+} // namespace ifs
@@ -0,0 +1,118 @@
+#include <ifs/StartupTrace.hpp>
+#include <ifs/Logger.hpp>
+#include <algorithm>
+#include <format>
+
+namespace ifs {
+
+namespace {
+
+// Constructed during static initialization so the origin is close to process start
+[[maybe_unused]] const StartupTrace& g_startup_trace = StartupTrace::instance();
+
+} // anonymous namespace
+
+// ============================================================================
+// Scope
+// ============================================================================
+
+StartupTrace::Scope::Scope(StartupTrace* trace, std::string name)
+    : m_trace(trace)
+    , m_name(std::move(name))
+    , m_begin(Clock::now())
+{}
+
+StartupTrace::Scope::Scope(Scope&& other) noexcept
+    : m_trace(other.m_trace)
+    , m_name(std::move(other.m_name))
+    , m_begin(other.m_begin)
+{
+    other.m_trace = nullptr;
+}
+
+StartupTrace::Scope::~Scope() {
+    if (m_trace) {
+        m_trace->record(std::move(m_name), m_begin, Clock::now());
+    }
+}
+
+// ============================================================================
+// StartupTrace
+// ============================================================================
+
+StartupTrace& StartupTrace::instance() {
+    static StartupTrace trace;
+    return trace;
+}
+
+StartupTrace::StartupTrace()
+    : m_origin(Clock::now())
+    , m_main_thread(std::this_thread::get_id())
+{}
+
+StartupTrace::Scope StartupTrace::phase(std::string name) {
+    return Scope(finished() ? nullptr : this, std::move(name));
+}
+
+void StartupTrace::record(std::string name, Clock::time_point begin, Clock::time_point end) {
+    std::lock_guard lock(m_mutex);
+    if (m_finished) {
+        return;
+    }
+    m_phases.push_back({
+        .name = std::move(name),
+        .begin_ms = to_ms(begin),
+        .duration_ms = std::chrono::duration<double, std::milli>(end - begin).count(),
+        .main_thread = std::this_thread::get_id() == m_main_thread
+    });
+}
+
+double StartupTrace::finish(MetricsRegistry& registry) {
+    const double first_frame_ms = elapsed_ms();
+    std::vector<StartupPhase> phases;
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_finished.exchange(true)) {
+            return m_first_frame_ms;
+        }
+        m_first_frame_ms = first_frame_ms;
+        phases = m_phases;
+    }
+    std::ranges::stable_sort(phases, {}, &StartupPhase::begin_ms);
+
+    registry.gauge("ifs_time_to_first_frame_ms", "Process start to first presented frame").set(first_frame_ms);
+
+    double overlapped_ms = 0.0;
+    Logger::instance().info("Startup timeline (time to first frame {:.1f} ms):", first_frame_ms);
+    for (const auto& phase : phases) {
+        Logger::instance().info("  {:>8.1f} ms  {:>8.1f} ms  {}{}",
+            phase.begin_ms, phase.duration_ms, phase.main_thread ? "" : "[worker] ", phase.name);
+        registry.gauge(std::format("ifs_startup_phase_ms{{phase=\"{}\"}}", phase.name), "Duration of each startup phase")
+            .set(phase.duration_ms);
+        if (!phase.main_thread) {
+            overlapped_ms += phase.duration_ms;
+        }
+    }
+    if (overlapped_ms > 0.0) {
+        Logger::instance().info("  {:.1f} ms of startup work ran on worker threads", overlapped_ms);
+    }
+
+    return first_frame_ms;
+}
+
+std::vector<StartupPhase> StartupTrace::phases() const {
+    std::lock_guard lock(m_mutex);
+    auto phases = m_phases;
+    std::ranges::stable_sort(phases, {}, &StartupPhase::begin_ms);
+    return phases;
+}
+
+double StartupTrace::elapsed_ms() const {
+    return to_ms(Clock::now());
+}
+
+double StartupTrace::to_ms(Clock::time_point time) const {
+    return std::chrono::duration<double, std::milli>(time - m_origin).count();
+}
+
+} // namespace ifs
@@ -0,0 +1,559 @@
+#include <ifs/Sweep.hpp>
+#include <ifs/Camera3D.hpp>
+#include <ifs/Logger.hpp>
+#include <ifs/Metrics.hpp>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <format>
+#include <fstream>
+#include <future>
+#include <unordered_set>
+
+namespace ifs {
+
+namespace {
+
+std::string_view trim(std::string_view text) {
+    const auto first = text.find_first_not_of(" \t\r");
+    if (first == std::string_view::npos) {
+        return {};
+    }
+    const auto last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+std::optional<double> parse_number(std::string_view text) {
+    text = trim(text);
+    double value = 0.0;
+    const auto* end = text.data() + text.size();
+    auto [ptr, ec] = std::from_chars(text.data(), end, value);
+    if (text.empty() || ec != std::errc() || ptr != end) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+/// Expand one comma-separated value list ("1,2", "1..4", "0:1:5")
+std::expected<std::vector<double>, std::string> parse_values(std::string_view text) {
+    std::vector<double> values;
+    while (!text.empty()) {
+        const auto comma = text.find(',');
+        const auto item = trim(text.substr(0, comma));
+        text = comma == std::string_view::npos ? std::string_view{} : text.substr(comma + 1);
+
+        if (const auto dots = item.find(".."); dots != std::string_view::npos) {
+            auto first = parse_number(item.substr(0, dots));
+            auto last = parse_number(item.substr(dots + 2));
+            if (!first || !last || *first != std::floor(*first) || *last != std::floor(*last) || *last < *first) {
+                return std::unexpected(std::format("invalid range '{}'", item));
+            }
+            for (double v = *first; v <= *last; v += 1.0) {
+                values.push_back(v);
+            }
+        } else if (const auto colon = item.find(':'); colon != std::string_view::npos) {
+            const auto second = item.find(':', colon + 1);
+            auto first = parse_number(item.substr(0, colon));
+            auto last = second == std::string_view::npos ? std::nullopt
+                : parse_number(item.substr(colon + 1, second - colon - 1));
+            auto count = second == std::string_view::npos ? std::nullopt : parse_number(item.substr(second + 1));
+            if (!first || !last || !count || *count < 1.0 || *count != std::floor(*count)) {
+                return std::unexpected(std::format("invalid linspace '{}' (expected a:b:n)", item));
+            }
+            const auto n = static_cast<size_t>(*count);
+            for (size_t i = 0; i < n; i++) {
+                values.push_back(n == 1 ? *first : *first + (*last - *first) * static_cast<double>(i) / (n - 1));
+            }
+        } else if (auto value = parse_number(item)) {
+            values.push_back(*value);
+        } else {
+            return std::unexpected(std::format("invalid number '{}'", item));
+        }
+    }
+    if (values.empty()) {
+        return std::unexpected("empty value list");
+    }
+    return values;
+}
+
+/// Store one expanded key/value into a job; keys are validated before expansion
+void apply_key(SweepJob& job, std::string_view key, double value) {
+    const auto f = static_cast<float>(value);
+    auto target = [&]() -> glm::vec3& {
+        if (!job.camera.target) {
+            job.camera.target = glm::vec3(0.5f, 0.5f, 0.0f);  // Camera3D's default target
+        }
+        return *job.camera.target;
+    };
+
+    if (key == "seed") {
+        job.params.random_seed = static_cast<uint32_t>(value);
+    } else if (key == "scale") {
+        job.params.scale = f;
+    } else if (key.starts_with("param.")) {
+        job.settings.emplace_back(std::string(key.substr(6)), f);
+    } else if (key == "camera.distance") {
+        job.camera.distance = f;
+    } else if (key == "camera.azimuth") {
+        job.camera.azimuth = f;
+    } else if (key == "camera.elevation") {
+        job.camera.elevation = f;
+    } else if (key == "camera.target_x") {
+        target().x = f;
+    } else if (key == "camera.target_y") {
+        target().y = f;
+    } else if (key == "camera.target_z") {
+        target().z = f;
+    }
+}
+
+bool is_known_key(std::string_view key) {
+    static constexpr std::string_view KEYS[] = {
+        "seed", "scale", "camera.distance", "camera.azimuth", "camera.elevation",
+        "camera.target_x", "camera.target_y", "camera.target_z"
+    };
+    return std::ranges::find(KEYS, key) != std::end(KEYS) || (key.starts_with("param.") && key.size() > 6);
+}
+
+std::string json_escape(std::string_view text) {
+    std::string result;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            result.push_back('\\');
+        }
+        result.push_back(c);
+    }
+    return result;
+}
+
+/// Job description half of a statistics line; the image half is appended by the writer
+std::string describe_job(const SweepJob& job, double compute_ms) {
+    std::string line = std::format("{{\"name\":\"{}\",\"seed\":{},\"scale\":{}",
+        json_escape(job.name), job.params.random_seed, job.params.scale);
+    for (const auto& [field, value] : job.settings) {
+        line += std::format(",\"param.{}\":{}", json_escape(field), value);
+    }
+    if (job.camera.distance) line += std::format(",\"camera.distance\":{}", *job.camera.distance);
+    if (job.camera.azimuth) line += std::format(",\"camera.azimuth\":{}", *job.camera.azimuth);
+    if (job.camera.elevation) line += std::format(",\"camera.elevation\":{}", *job.camera.elevation);
+    if (job.camera.target) {
+        line += std::format(",\"camera.target\":[{},{},{}]",
+            job.camera.target->x, job.camera.target->y, job.camera.target->z);
+    }
+    line += std::format(",\"compute_ms\":{:.3f}", compute_ms);
+    return line;
+}
+
+struct WriterResult {
+    bool ok = true;
+    std::string statistics_line;
+};
+
+} // anonymous namespace
+
+// ============================================================================
+// Spec parsing and image helpers
+// ============================================================================
+
+void SweepCamera::apply(Camera3D& camera) const {
+    camera.reset();
+    if (target) camera.set_target(*target);
+    if (distance) camera.set_distance(*distance);
+    if (azimuth || elevation) {
+        camera.set_rotation(azimuth.value_or(camera.azimuth()), elevation.value_or(camera.elevation()));
+    }
+}
+
+std::expected<std::vector<SweepJob>, std::string> parse_sweep_spec(std::string_view text) {
+    std::vector<SweepJob> jobs;
+    std::unordered_set<std::string> names;
+    size_t line_number = 0;
+
+    while (!text.empty()) {
+        const auto newline = text.find('\n');
+        auto line = trim(text.substr(0, newline));
+        text = newline == std::string_view::npos ? std::string_view{} : text.substr(newline + 1);
+        line_number++;
+
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+
+        std::string prefix = std::format("job{}", line_number);
+        std::vector<std::pair<std::string, std::vector<double>>> keys;
+        while (!line.empty()) {
+            const auto space = line.find_first_of(" \t");
+            const auto token = line.substr(0, space);
+            line = space == std::string_view::npos ? std::string_view{} : trim(line.substr(space));
+
+            const auto equals = token.find('=');
+            if (equals == std::string_view::npos || equals == 0) {
+                return std::unexpected(std::format("line {}: expected key=value, got '{}'", line_number, token));
+            }
+            const auto key = token.substr(0, equals);
+            const auto value = token.substr(equals + 1);
+
+            if (key == "name") {
+                if (value.empty()) {
+                    return std::unexpected(std::format("line {}: empty name", line_number));
+                }
+                // Names become file stems in the output directory
+                if (value.find_first_of("/\\") != std::string_view::npos || value == "." || value == "..") {
+                    return std::unexpected(std::format("line {}: name '{}' is not a plain file name", line_number, value));
+                }
+                prefix = value;
+                continue;
+            }
+            if (!is_known_key(key)) {
+                return std::unexpected(std::format("line {}: unknown key '{}'", line_number, key));
+            }
+            auto values = parse_values(value);
+            if (!values) {
+                return std::unexpected(std::format("line {}: {}: {}", line_number, key, values.error()));
+            }
+            keys.emplace_back(std::string(key), std::move(*values));
+        }
+
+        size_t count = 1;
+        for (const auto& [key, values] : keys) {
+            count *= values.size();
+        }
+
+        // Odometer over the value lists; the last key varies fastest
+        std::vector<size_t> indices(keys.size(), 0);
+        for (size_t n = 0; n < count; n++) {
+            SweepJob job;
+            job.name = count > 1 ? std::format("{}_{:04}", prefix, n) : prefix;
+            for (size_t k = 0; k < keys.size(); k++) {
+                apply_key(job, keys[k].first, keys[k].second[indices[k]]);
+            }
+            if (!names.insert(job.name).second) {
+                return std::unexpected(std::format("line {}: duplicate job name '{}'", line_number, job.name));
+            }
+            jobs.push_back(std::move(job));
+
+            for (size_t k = keys.size(); k-- > 0;) {
+                if (++indices[k] < keys[k].second.size()) {
+                    break;
+                }
+                indices[k] = 0;
+            }
+        }
+    }
+
+    return jobs;
+}
+
+ImageStatistics compute_image_statistics(const uint8_t* rgba, uint32_t width, uint32_t height) {
+    ImageStatistics stats;
+    const size_t pixel_count = static_cast<size_t>(width) * height;
+    if (pixel_count == 0) {
+        return stats;
+    }
+
+    size_t covered = 0;
+    double luminance = 0.0;
+    uint32_t min_x = width, min_y = height, max_x = 0, max_y = 0;
+    for (uint32_t y = 0; y < height; y++) {
+        const uint8_t* row = rgba + static_cast<size_t>(y) * width * 4;
+        for (uint32_t x = 0; x < width; x++) {
+            const uint8_t r = row[x * 4 + 0];
+            const uint8_t g = row[x * 4 + 1];
+            const uint8_t b = row[x * 4 + 2];
+            luminance += 0.2126 * r + 0.7152 * g + 0.0722 * b;
+            if (r | g | b) {
+                covered++;
+                min_x = std::min(min_x, x);
+                min_y = std::min(min_y, y);
+                max_x = std::max(max_x, x);
+                max_y = std::max(max_y, y);
+            }
+        }
+    }
+
+    stats.coverage = static_cast<double>(covered) / pixel_count;
+    stats.mean_luminance = luminance / (255.0 * pixel_count);
+    if (covered > 0) {
+        stats.min_x = min_x;
+        stats.min_y = min_y;
+        stats.max_x = max_x;
+        stats.max_y = max_y;
+    }
+    return stats;
+}
+
+bool write_ppm(const std::filesystem::path& path, const uint8_t* rgba, uint32_t width, uint32_t height) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    file << std::format("P6\n{} {}\n255\n", width, height);
+
+    std::vector<char> row(static_cast<size_t>(width) * 3);
+    for (uint32_t y = 0; y < height; y++) {
+        const uint8_t* src = rgba + static_cast<size_t>(y) * width * 4;
+        for (uint32_t x = 0; x < width; x++) {
+            row[x * 3 + 0] = static_cast<char>(src[x * 4 + 0]);
+            row[x * 3 + 1] = static_cast<char>(src[x * 4 + 1]);
+            row[x * 3 + 2] = static_cast<char>(src[x * 4 + 2]);
+        }
+        file.write(row.data(), static_cast<std::streamsize>(row.size()));
+    }
+    return static_cast<bool>(file);
+}
+
+// ============================================================================
+// SweepRunner
+// ============================================================================
+
+SweepRunner::SweepRunner(const VulkanContext& context, SweepOptions options)
+    : m_context(&context)
+    , m_device(context.device())
+    , m_options(std::move(options))
+    , m_command_pool(nullptr)
+{}
+
+std::expected<std::unique_ptr<SweepRunner>, std::string> SweepRunner::create(
+    const VulkanContext& context,
+    const vk::Extent2D& extent,
+    SweepOptions options
+) {
+    auto runner = std::unique_ptr<SweepRunner>(new SweepRunner(context, std::move(options)));
+    if (auto result = runner->initialize(extent); !result) {
+        return std::unexpected(result.error());
+    }
+    return runner;
+}
+
+SweepRunner::~SweepRunner() {
+    if (m_device) {
+        auto _ = m_device.waitIdle();
+    }
+    for (auto fence : m_fences) {
+        m_device.destroyFence(fence);
+    }
+    if (m_command_pool) {
+        m_device.destroyCommandPool(m_command_pool);
+    }
+    m_target.reset();
+}
+
+std::expected<void, std::string> SweepRunner::initialize(const vk::Extent2D& extent) {
+    auto target = OffscreenTarget::create(*m_context, extent, 2);
+    if (!target) {
+        return std::unexpected(target.error());
+    }
+    m_target = std::move(*target);
+    const uint32_t slots = m_target->readback_slots();
+
+    auto pool_info = vk::CommandPoolCreateInfo()
+        .setFlags(vk::CommandPoolCreateFlagBits::eResetCommandBuffer)
+        .setQueueFamilyIndex(m_context->queue_indices().graphics);
+
+	auto pool_res = m_device.createCommandPool(pool_info);
+	if (pool_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create sweep command pool: {}", to_string(pool_res.result)));
+	}
+	m_command_pool = pool_res.value;
+
+    auto alloc_info = vk::CommandBufferAllocateInfo()
+        .setCommandPool(m_command_pool)
+        .setLevel(vk::CommandBufferLevel::ePrimary)
+        .setCommandBufferCount(slots);
+
+	auto cmd_res = m_device.allocateCommandBuffers(alloc_info);
+	if (cmd_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to allocate sweep command buffers: {}", to_string(cmd_res.result)));
+	}
+	m_command_buffers = cmd_res.value;
+
+    for (uint32_t i = 0; i < slots; i++) {
+		auto fence_res = m_device.createFence(vk::FenceCreateInfo().setFlags(vk::FenceCreateFlagBits::eSignaled));
+		if (fence_res.result != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Failed to create sweep fence: {}", to_string(fence_res.result)));
+		}
+		m_fences.push_back(fence_res.value);
+    }
+
+    return {};
+}
+
+std::expected<SweepReport, std::string> SweepRunner::run(
+    const std::vector<SweepJob>& jobs,
+    IFSBackend& backend,
+    IFSFrontend& frontend
+) {
+    static auto& jobs_total = MetricsRegistry::instance().counter(
+        "ifs_sweep_jobs_total", "Sweep jobs rendered");
+
+    // Unknown settings would otherwise silently render the same image for every value
+    {
+        auto backend_callbacks = backend.get_ui_callbacks();
+        auto frontend_callbacks = frontend.get_ui_callbacks();
+        for (const auto& job : jobs) {
+            for (const auto& [field, value] : job.settings) {
+                if (!find_ui_callback(backend_callbacks, field) && !find_ui_callback(frontend_callbacks, field)) {
+                    return std::unexpected(std::format("Job '{}': no parameter named '{}' in backend '{}' or frontend '{}'",
+                        job.name, field, backend.name(), frontend.name()));
+                }
+            }
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(m_options.output_dir, ec);
+    if (ec) {
+        return std::unexpected(std::format("Failed to create output directory '{}': {}",
+            m_options.output_dir.string(), ec.message()));
+    }
+
+    std::ofstream statistics_file;
+    if (m_options.write_statistics) {
+        statistics_file.open(m_options.output_dir / "statistics.jsonl", std::ios::trunc);
+        if (!statistics_file) {
+            return std::unexpected("Failed to open statistics.jsonl");
+        }
+    }
+
+    const auto& extent = m_target->extent();
+    const auto& queues = m_context->queue_indices();
+    const uint32_t slots = m_target->readback_slots();
+    const auto clear_values = m_target->clear_values();
+    frontend.resize(extent);
+
+    Camera3D camera(extent.width, extent.height);
+    vk::Buffer bound_buffer = nullptr;
+    SweepReport report;
+    std::vector<std::future<WriterResult>> writers(slots);
+
+    // Joining writers in job order keeps statistics.jsonl in spec order
+    auto join_writer = [&](uint32_t slot) {
+        if (!writers[slot].valid()) {
+            return;
+        }
+        auto result = writers[slot].get();
+        if (!result.ok) {
+            report.failed++;
+        }
+        if (statistics_file && !result.statistics_line.empty()) {
+            statistics_file << result.statistics_line << '\n';
+        }
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < jobs.size(); i++) {
+        const auto& job = jobs[i];
+        const auto slot = static_cast<uint32_t>(i % slots);
+
+        // Settings may reallocate the particle buffer, so callbacks are fetched per job
+        if (!job.settings.empty()) {
+            auto backend_callbacks = backend.get_ui_callbacks();
+            auto frontend_callbacks = frontend.get_ui_callbacks();
+            for (const auto& [field, value] : job.settings) {
+                const auto* callback = find_ui_callback(backend_callbacks, field);
+                (callback ? callback : find_ui_callback(frontend_callbacks, field))->set_value(value);
+            }
+        }
+
+        // Compute overwrites the particle buffer the previous job drew from
+        if (i > 0) {
+            auto _ = m_device.waitForFences(m_fences[(i - 1) % slots], true, UINT64_MAX);
+        }
+
+        backend.compute(nullptr, 0, job.params);
+        backend.wait_compute_complete();
+        const double compute_ms = backend.compute_stats() ? backend.compute_stats()->gpu_ms : 0.0;
+
+        const auto particle_buffer = backend.get_particle_buffer();
+        if (particle_buffer != bound_buffer) {
+            frontend.update_particle_buffer(particle_buffer);
+            bound_buffer = particle_buffer;
+        }
+
+        job.camera.apply(camera);
+
+        // The slot's readback buffer is reused, so its previous writer must be done
+        join_writer(slot);
+
+        auto cmd = m_command_buffers[slot];
+        auto fence = m_fences[slot];
+        auto _ = m_device.resetFences(fence);
+        auto _ = cmd.reset();
+        auto _ = cmd.begin(vk::CommandBufferBeginInfo().setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+
+        if (queues.has_dedicated_compute()) {
+            frontend.acquire_buffer_ownership(cmd, particle_buffer, queues.compute, queues.graphics);
+        }
+
+        auto render_pass_begin = vk::RenderPassBeginInfo()
+            .setRenderPass(m_target->render_pass())
+            .setFramebuffer(m_target->framebuffer())
+            .setRenderArea(vk::Rect2D({0, 0}, extent))
+            .setClearValues(clear_values);
+
+        cmd.beginRenderPass(render_pass_begin, vk::SubpassContents::eInline);
+        frontend.render(cmd, particle_buffer, backend.get_particle_count(), camera, &extent);
+        cmd.endRenderPass();
+        m_target->record_readback(cmd, slot);
+        // A warm-started next job reads the buffer on the compute queue; a cold one overwrites it without acquiring
+        if (queues.has_dedicated_compute() && i + 1 < jobs.size()) {
+            backend.return_buffer_ownership(cmd, particle_buffer, queues.graphics, queues.compute);
+        }
+        auto _ = cmd.end();
+
+		auto submit_res = m_context->graphics_queue().submit(vk::SubmitInfo().setCommandBuffers(cmd), fence);
+		if (submit_res != vk::Result::eSuccess)
+		{
+			for (uint32_t s = 0; s < slots; s++) {
+				join_writer(s);
+			}
+			return std::unexpected(std::format("Failed to submit sweep job '{}': {}", job.name, to_string(submit_res)));
+		}
+
+        // Encoding and file output overlap with the next job's compute and draw
+        writers[slot] = std::async(std::launch::async,
+            [this, slot, fence, name = job.name, line = describe_job(job, compute_ms)]() mutable {
+                WriterResult result;
+                auto _ = m_device.waitForFences(fence, true, UINT64_MAX);
+                const auto& target_extent = m_target->extent();
+                const uint8_t* pixels = m_target->pixels(slot);
+
+                if (m_options.write_images) {
+                    const auto path = m_options.output_dir / (name + ".ppm");
+                    if (!write_ppm(path, pixels, target_extent.width, target_extent.height)) {
+                        Logger::instance().error("Failed to write {}", path.string());
+                        result.ok = false;
+                    }
+                }
+                if (m_options.write_statistics) {
+                    const auto stats = compute_image_statistics(pixels, target_extent.width, target_extent.height);
+                    result.statistics_line = line + std::format(
+                        ",\"coverage\":{:.6f},\"mean_luminance\":{:.6f},\"bounds\":[{},{},{},{}]}}",
+                        stats.coverage, stats.mean_luminance, stats.min_x, stats.min_y, stats.max_x, stats.max_y);
+                }
+                return result;
+            });
+
+        report.jobs++;
+        jobs_total.add();
+        Logger::instance().debug("Sweep job {}/{} '{}' submitted", i + 1, jobs.size(), job.name);
+    }
+
+    // Remaining writers, oldest first
+    for (size_t i = jobs.size() > slots ? jobs.size() - slots : 0; i < jobs.size(); i++) {
+        join_writer(static_cast<uint32_t>(i % slots));
+    }
+
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    MetricsRegistry::instance().gauge("ifs_sweep_jobs_per_second", "Throughput of the last sweep")
+        .set(report.jobs_per_second());
+    Logger::instance().info("Sweep finished: {} job(s) in {:.2f} s ({:.2f} jobs/s), {} failed",
+        report.jobs, report.seconds, report.jobs_per_second(), report.failed);
+    return report;
+}
+
+} // namespace ifs
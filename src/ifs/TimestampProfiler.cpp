@@ -0,0 +1,122 @@
+#include <ifs/TimestampProfiler.hpp>
+#include <ifs/Logger.hpp>
+#include <algorithm>
+#include <format>
+
+namespace ifs {
+
+TimestampProfiler::TimestampProfiler(const VulkanContext& context, uint32_t max_scopes)
+    : m_device(context.device())
+    , m_query_pool(nullptr)
+    , m_max_scopes(max_scopes)
+{}
+
+std::expected<std::unique_ptr<TimestampProfiler>, std::string> TimestampProfiler::create(
+    const VulkanContext& context,
+    uint32_t max_scopes,
+    uint32_t queue_family
+) {
+    auto profiler = std::unique_ptr<TimestampProfiler>(new TimestampProfiler(context, max_scopes));
+
+    auto families = context.physical_device().getQueueFamilyProperties();
+    profiler->m_valid_bits = queue_family < families.size() ? families[queue_family].timestampValidBits : 0;
+    profiler->m_ns_per_tick = context.physical_device().getProperties().limits.timestampPeriod;
+
+    if (!profiler->supported()) {
+        Logger::instance().warn("Queue family {} does not support timestamps, profiling disabled", queue_family);
+        return profiler;
+    }
+
+    auto pool_info = vk::QueryPoolCreateInfo()
+        .setQueryType(vk::QueryType::eTimestamp)
+        .setQueryCount(max_scopes * 2);
+
+	auto pool_res = context.device().createQueryPool(pool_info);
+	if (pool_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create timestamp query pool: {}", to_string(pool_res.result)));
+	}
+	profiler->m_query_pool = pool_res.value;
+    profiler->reset();
+
+    return profiler;
+}
+
+TimestampProfiler::~TimestampProfiler() {
+    if (m_query_pool) {
+        m_device.destroyQueryPool(m_query_pool);
+    }
+}
+
+void TimestampProfiler::reset() {
+    m_scope_names.clear();
+    if (m_query_pool) {
+        m_device.resetQueryPool(m_query_pool, 0, m_max_scopes * 2);
+    }
+}
+
+uint32_t TimestampProfiler::begin_scope(
+    vk::CommandBuffer cmd,
+    std::string_view name,
+    vk::PipelineStageFlagBits stage
+) {
+    if (!m_query_pool || m_scope_names.size() >= m_max_scopes) {
+        return UINT32_MAX;
+    }
+
+    auto scope = static_cast<uint32_t>(m_scope_names.size());
+    m_scope_names.emplace_back(name);
+    cmd.writeTimestamp(stage, m_query_pool, scope * 2);
+    return scope;
+}
+
+void TimestampProfiler::end_scope(
+    vk::CommandBuffer cmd,
+    uint32_t scope,
+    vk::PipelineStageFlagBits stage
+) {
+    if (!m_query_pool || scope >= m_scope_names.size()) {
+        return;
+    }
+    cmd.writeTimestamp(stage, m_query_pool, scope * 2 + 1);
+}
+
+std::vector<TimestampScope> TimestampProfiler::resolve() const {
+    std::vector<TimestampScope> scopes;
+    if (!m_query_pool || m_scope_names.empty()) {
+        return scopes;
+    }
+
+    auto query_count = static_cast<uint32_t>(m_scope_names.size() * 2);
+    auto results_res = m_device.getQueryPoolResults<uint64_t>(
+        m_query_pool, 0, query_count,
+        query_count * sizeof(uint64_t), sizeof(uint64_t),
+        vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWait);
+    if (results_res.result != vk::Result::eSuccess) {
+        Logger::instance().warn("Failed to read timestamp queries: {}", to_string(results_res.result));
+        return scopes;
+    }
+    const auto& ticks = results_res.value;
+
+    const uint64_t mask = m_valid_bits >= 64 ? ~0ull : ((1ull << m_valid_bits) - 1);
+    uint64_t origin = UINT64_MAX;
+    for (size_t i = 0; i < m_scope_names.size(); i++) {
+        origin = std::min(origin, ticks[i * 2] & mask);
+    }
+
+    auto to_ms = [this](uint64_t delta) { return static_cast<double>(delta) * m_ns_per_tick / 1.0e6; };
+
+    scopes.reserve(m_scope_names.size());
+    for (size_t i = 0; i < m_scope_names.size(); i++) {
+        uint64_t begin = ticks[i * 2] & mask;
+        uint64_t end = ticks[i * 2 + 1] & mask;
+        scopes.push_back({
+            .name = m_scope_names[i],
+            .begin_ms = to_ms(begin - origin),
+            .duration_ms = to_ms(end >= begin ? end - begin : 0)
+        });
+    }
+    return scopes;
+}
+
+} // namespace ifs
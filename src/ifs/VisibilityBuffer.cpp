@@ -0,0 +1,582 @@
+#include <ifs/VisibilityBuffer.hpp>
+#include <ifs/Logger.hpp>
+#include <ifs/StartupTrace.hpp>
+#include <array>
+#include <format>
+
+namespace ifs {
+
+namespace {
+
+constexpr uint32_t SHADE_GROUP_SIZE = 8;
+
+vk::Format find_depth_format(vk::PhysicalDevice physical_device) {
+    for (auto format : {vk::Format::eD32Sfloat, vk::Format::eD32SfloatS8Uint, vk::Format::eD24UnormS8Uint}) {
+        auto props = physical_device.getFormatProperties(format);
+        // Sampled by the composite, which copies it into the frontend's depth
+        const auto features = vk::FormatFeatureFlagBits::eDepthStencilAttachment | vk::FormatFeatureFlagBits::eSampledImage;
+        if ((props.optimalTilingFeatures & features) == features) {
+            return format;
+        }
+    }
+    return vk::Format::eUndefined;
+}
+
+} // anonymous namespace
+
+VisibilityBuffer::VisibilityBuffer(const VulkanContext& context)
+    : m_context(&context)
+    , m_device(context.device())
+    , m_render_pass(nullptr)
+    , m_framebuffer(nullptr)
+    , m_extent{}
+    , m_descriptor_layout(nullptr)
+    , m_descriptor_pool(nullptr)
+    , m_descriptor_set(nullptr)
+    , m_shade_layout(nullptr)
+    , m_shade_pipeline(nullptr)
+    , m_composite_layout(nullptr)
+    , m_composite_pipeline(nullptr)
+{}
+
+std::expected<std::unique_ptr<VisibilityBuffer>, std::string> VisibilityBuffer::create(
+    const VulkanContext& context,
+    const vk::GraphicsPipelineCreateInfo& frontend_pipeline,
+    vk::DescriptorSetLayout frontend_set_layout,
+    std::string_view shade_shader,
+    std::string_view shade_entry
+) {
+    auto visibility = std::unique_ptr<VisibilityBuffer>(new VisibilityBuffer(context));
+
+    visibility->m_depth_format = find_depth_format(context.physical_device());
+    if (visibility->m_depth_format == vk::Format::eUndefined) {
+        return std::unexpected("No supported depth format");
+    }
+
+    if (auto result = visibility->create_render_pass(); !result) {
+        return std::unexpected(result.error());
+    }
+    if (auto result = visibility->create_descriptors(); !result) {
+        return std::unexpected(result.error());
+    }
+    if (auto result = visibility->create_pipelines(frontend_pipeline, frontend_set_layout, shade_shader, shade_entry); !result) {
+        return std::unexpected(result.error());
+    }
+
+    // Images are created on the first begin(), when the extent is known
+    return visibility;
+}
+
+VisibilityBuffer::~VisibilityBuffer() {
+    destroy_images();
+
+    if (m_composite_pipeline) m_device.destroyPipeline(m_composite_pipeline);
+    if (m_composite_layout) m_device.destroyPipelineLayout(m_composite_layout);
+    if (m_shade_pipeline) m_device.destroyPipeline(m_shade_pipeline);
+    if (m_shade_layout) m_device.destroyPipelineLayout(m_shade_layout);
+    if (m_descriptor_pool) m_device.destroyDescriptorPool(m_descriptor_pool);
+    if (m_descriptor_layout) m_device.destroyDescriptorSetLayout(m_descriptor_layout);
+    if (m_render_pass) m_device.destroyRenderPass(m_render_pass);
+}
+
+std::expected<void, std::string> VisibilityBuffer::create_render_pass() {
+    // Cleared every frame, left in eGeneral for the shading and composite passes
+    auto id_attachment = vk::AttachmentDescription()
+        .setFormat(ID_FORMAT)
+        .setSamples(vk::SampleCountFlagBits::e1)
+        .setLoadOp(vk::AttachmentLoadOp::eClear)
+        .setStoreOp(vk::AttachmentStoreOp::eStore)
+        .setStencilLoadOp(vk::AttachmentLoadOp::eDontCare)
+        .setStencilStoreOp(vk::AttachmentStoreOp::eDontCare)
+        .setInitialLayout(vk::ImageLayout::eUndefined)
+        .setFinalLayout(vk::ImageLayout::eGeneral);
+
+    auto depth_attachment = vk::AttachmentDescription()
+        .setFormat(m_depth_format)
+        .setSamples(vk::SampleCountFlagBits::e1)
+        .setLoadOp(vk::AttachmentLoadOp::eClear)
+        .setStoreOp(vk::AttachmentStoreOp::eStore)
+        .setStencilLoadOp(vk::AttachmentLoadOp::eDontCare)
+        .setStencilStoreOp(vk::AttachmentStoreOp::eDontCare)
+        .setInitialLayout(vk::ImageLayout::eUndefined)
+        .setFinalLayout(vk::ImageLayout::eDepthStencilReadOnlyOptimal);
+
+    auto id_ref = vk::AttachmentReference()
+        .setAttachment(0)
+        .setLayout(vk::ImageLayout::eColorAttachmentOptimal);
+
+    auto depth_ref = vk::AttachmentReference()
+        .setAttachment(1)
+        .setLayout(vk::ImageLayout::eDepthStencilAttachmentOptimal);
+
+    auto subpass = vk::SubpassDescription()
+        .setPipelineBindPoint(vk::PipelineBindPoint::eGraphics)
+        .setColorAttachments(id_ref)
+        .setPDepthStencilAttachment(&depth_ref);
+
+    // Previous frame's shading and composite reads -> this frame's writes
+    auto dependency = vk::SubpassDependency()
+        .setSrcSubpass(VK_SUBPASS_EXTERNAL)
+        .setDstSubpass(0)
+        .setSrcStageMask(
+            vk::PipelineStageFlagBits::eComputeShader |
+            vk::PipelineStageFlagBits::eFragmentShader |
+            vk::PipelineStageFlagBits::eLateFragmentTests)
+        .setDstStageMask(
+            vk::PipelineStageFlagBits::eColorAttachmentOutput |
+            vk::PipelineStageFlagBits::eEarlyFragmentTests)
+        .setDstAccessMask(
+            vk::AccessFlagBits::eColorAttachmentWrite |
+            vk::AccessFlagBits::eDepthStencilAttachmentWrite);
+
+    // Instance indices -> shading pass
+    auto shade_dependency = vk::SubpassDependency()
+        .setSrcSubpass(0)
+        .setDstSubpass(VK_SUBPASS_EXTERNAL)
+        .setSrcStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput)
+        .setDstStageMask(vk::PipelineStageFlagBits::eComputeShader)
+        .setSrcAccessMask(vk::AccessFlagBits::eColorAttachmentWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eShaderRead);
+
+    // Depth -> composite
+    auto depth_dependency = vk::SubpassDependency()
+        .setSrcSubpass(0)
+        .setDstSubpass(VK_SUBPASS_EXTERNAL)
+        .setSrcStageMask(vk::PipelineStageFlagBits::eLateFragmentTests)
+        .setDstStageMask(vk::PipelineStageFlagBits::eFragmentShader)
+        .setSrcAccessMask(vk::AccessFlagBits::eDepthStencilAttachmentWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eShaderRead);
+
+    std::array dependencies = {dependency, shade_dependency, depth_dependency};
+    std::array attachments = {id_attachment, depth_attachment};
+
+    auto render_pass_info = vk::RenderPassCreateInfo()
+        .setAttachments(attachments)
+        .setSubpasses(subpass)
+        .setDependencies(dependencies);
+
+	auto render_pass_res = m_device.createRenderPass(render_pass_info);
+	if (render_pass_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create visibility render pass: {}", to_string(render_pass_res.result)));
+	}
+	m_render_pass = render_pass_res.value;
+
+    return {};
+}
+
+std::expected<void, std::string> VisibilityBuffer::create_descriptors() {
+    // Binding 0: instance indices, binding 1: shaded colors (shading and composite passes),
+    // binding 2: depth (composite)
+    std::array<vk::DescriptorSetLayoutBinding, 3> bindings;
+    for (uint32_t i = 0; i < 2; i++) {
+        bindings[i] = vk::DescriptorSetLayoutBinding()
+            .setBinding(i)
+            .setDescriptorType(vk::DescriptorType::eStorageImage)
+            .setDescriptorCount(1)
+            .setStageFlags(vk::ShaderStageFlagBits::eCompute | vk::ShaderStageFlagBits::eFragment);
+    }
+    bindings[2] = vk::DescriptorSetLayoutBinding()
+        .setBinding(2)
+        .setDescriptorType(vk::DescriptorType::eSampledImage)
+        .setDescriptorCount(1)
+        .setStageFlags(vk::ShaderStageFlagBits::eFragment);
+
+	auto layout_res = m_device.createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo().setBindings(bindings));
+	if (layout_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create visibility descriptor layout: {}", to_string(layout_res.result)));
+	}
+	m_descriptor_layout = layout_res.value;
+
+    std::array pool_sizes = {
+        vk::DescriptorPoolSize(vk::DescriptorType::eStorageImage, 2),
+        vk::DescriptorPoolSize(vk::DescriptorType::eSampledImage, 1)
+    };
+    auto pool_info = vk::DescriptorPoolCreateInfo()
+        .setMaxSets(1)
+        .setPoolSizes(pool_sizes);
+
+	auto pool_res = m_device.createDescriptorPool(pool_info);
+	if (pool_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create visibility descriptor pool: {}", to_string(pool_res.result)));
+	}
+	m_descriptor_pool = pool_res.value;
+
+    auto alloc_info = vk::DescriptorSetAllocateInfo()
+        .setDescriptorPool(m_descriptor_pool)
+        .setSetLayouts(m_descriptor_layout);
+
+	auto set_res = m_device.allocateDescriptorSets(alloc_info);
+	if (set_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to allocate visibility descriptor set: {}", to_string(set_res.result)));
+	}
+	m_descriptor_set = set_res.value[0];
+
+    return {};
+}
+
+std::expected<void, std::string> VisibilityBuffer::create_pipelines(
+    const vk::GraphicsPipelineCreateInfo& frontend_pipeline,
+    vk::DescriptorSetLayout frontend_set_layout,
+    std::string_view shade_shader,
+    std::string_view shade_entry
+) {
+    auto trace_scope = StartupTrace::instance().phase("pipeline:VisibilityBuffer");
+
+    auto shade_result = Shader::create_shader(m_device, shade_shader, shade_entry);
+    if (!shade_result) {
+        return std::unexpected(std::format("Failed to load visibility shading shader: {}", shade_result.error()));
+    }
+    m_shade_shader = std::make_unique<Shader>(std::move(*shade_result));
+
+    auto vert_result = Shader::create_shader(m_device, "ifs_modular/visibility/composite.vert.slang", "main");
+    if (!vert_result) {
+        return std::unexpected(std::format("Failed to load visibility composite vertex shader: {}", vert_result.error()));
+    }
+    m_composite_vertex_shader = std::make_unique<Shader>(std::move(*vert_result));
+
+    auto frag_result = Shader::create_shader(m_device, "ifs_modular/visibility/composite.frag.slang", "main");
+    if (!frag_result) {
+        return std::unexpected(std::format("Failed to load visibility composite fragment shader: {}", frag_result.error()));
+    }
+    m_composite_fragment_shader = std::make_unique<Shader>(std::move(*frag_result));
+
+    // Shading pipeline: frontend set 0 + visibility set 1, extent as push constant
+    std::array shade_set_layouts = {frontend_set_layout, m_descriptor_layout};
+    auto push_constant_range = vk::PushConstantRange()
+        .setStageFlags(vk::ShaderStageFlagBits::eCompute)
+        .setOffset(0)
+        .setSize(sizeof(uint32_t) * 2);
+
+    auto shade_layout_info = vk::PipelineLayoutCreateInfo()
+        .setSetLayouts(shade_set_layouts)
+        .setPushConstantRanges(push_constant_range);
+
+	auto shade_layout_res = m_device.createPipelineLayout(shade_layout_info);
+	if (shade_layout_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create visibility shading pipeline layout: {}", to_string(shade_layout_res.result)));
+	}
+	m_shade_layout = shade_layout_res.value;
+
+    auto shade_info = vk::ComputePipelineCreateInfo()
+        .setStage(m_shade_shader->create_pipeline_shader_stage_create_info())
+        .setLayout(m_shade_layout);
+
+	auto shade_pipeline_res = m_device.createComputePipeline(nullptr, shade_info);
+	if (shade_pipeline_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create visibility shading pipeline: {}", to_string(shade_pipeline_res.result)));
+	}
+	m_shade_pipeline = shade_pipeline_res.value;
+
+    // Composite pipeline: fullscreen triangle reading the shaded pixels; its
+    // push constant is the viewport origin (int2)
+    auto composite_push_range = vk::PushConstantRange()
+        .setStageFlags(vk::ShaderStageFlagBits::eFragment)
+        .setOffset(0)
+        .setSize(2 * sizeof(int32_t));
+
+    auto composite_layout_info = vk::PipelineLayoutCreateInfo()
+        .setSetLayouts(m_descriptor_layout)
+        .setPushConstantRanges(composite_push_range);
+
+	auto composite_layout_res = m_device.createPipelineLayout(composite_layout_info);
+	if (composite_layout_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create visibility composite pipeline layout: {}", to_string(composite_layout_res.result)));
+	}
+	m_composite_layout = composite_layout_res.value;
+
+    std::array composite_stages = {
+        vk::PipelineShaderStageCreateInfo()
+            .setStage(vk::ShaderStageFlagBits::eVertex)
+            .setModule(m_composite_vertex_shader->get_shader_module())
+            .setPName("main"),
+        vk::PipelineShaderStageCreateInfo()
+            .setStage(vk::ShaderStageFlagBits::eFragment)
+            .setModule(m_composite_fragment_shader->get_shader_module())
+            .setPName("main")
+    };
+
+    auto vertex_input = vk::PipelineVertexInputStateCreateInfo();
+
+    auto input_assembly = vk::PipelineInputAssemblyStateCreateInfo()
+        .setTopology(vk::PrimitiveTopology::eTriangleList)
+        .setPrimitiveRestartEnable(false);
+
+    auto rasterizer = vk::PipelineRasterizationStateCreateInfo()
+        .setDepthClampEnable(false)
+        .setRasterizerDiscardEnable(false)
+        .setPolygonMode(vk::PolygonMode::eFill)
+        .setLineWidth(1.0f)
+        .setCullMode(vk::CullModeFlagBits::eNone)
+        .setFrontFace(vk::FrontFace::eCounterClockwise)
+        .setDepthBiasEnable(false);
+
+    // Visibility was resolved by the visibility pass' own depth test: the composite
+    // copies that depth over the frontend's, so later draws in its pass test against it
+    auto depth_stencil = vk::PipelineDepthStencilStateCreateInfo()
+        .setDepthTestEnable(true)
+        .setDepthWriteEnable(true)
+        .setDepthCompareOp(vk::CompareOp::eAlways)
+        .setDepthBoundsTestEnable(false)
+        .setStencilTestEnable(false);
+
+    auto blend_attachment = vk::PipelineColorBlendAttachmentState()
+        .setColorWriteMask(vk::ColorComponentFlagBits::eR |
+                          vk::ColorComponentFlagBits::eG |
+                          vk::ColorComponentFlagBits::eB |
+                          vk::ColorComponentFlagBits::eA)
+        .setBlendEnable(false);
+
+    auto blending = vk::PipelineColorBlendStateCreateInfo()
+        .setLogicOpEnable(false)
+        .setAttachments(blend_attachment);
+
+    auto composite_info = vk::GraphicsPipelineCreateInfo()
+        .setStages(composite_stages)
+        .setPVertexInputState(&vertex_input)
+        .setPInputAssemblyState(&input_assembly)
+        .setPViewportState(frontend_pipeline.pViewportState)
+        .setPRasterizationState(&rasterizer)
+        .setPMultisampleState(frontend_pipeline.pMultisampleState)
+        .setPDepthStencilState(&depth_stencil)
+        .setPColorBlendState(&blending)
+        .setPDynamicState(frontend_pipeline.pDynamicState)
+        .setLayout(m_composite_layout)
+        .setRenderPass(frontend_pipeline.renderPass)
+        .setSubpass(frontend_pipeline.subpass);
+
+	auto composite_pipeline_res = m_device.createGraphicsPipeline(nullptr, composite_info);
+	if (composite_pipeline_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create visibility composite pipeline: {}", to_string(composite_pipeline_res.result)));
+	}
+	m_composite_pipeline = composite_pipeline_res.value;
+
+    return {};
+}
+
+std::expected<void, std::string> VisibilityBuffer::create_images(const vk::Extent2D& extent) {
+    struct Attachment {
+        vk::Format format;
+        vk::ImageUsageFlags usage;
+        vk::ImageAspectFlags aspect;
+        Image* image;
+    };
+    std::array attachments = {
+        Attachment{ID_FORMAT, vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eStorage,
+                   vk::ImageAspectFlagBits::eColor, &m_ids},
+        Attachment{m_depth_format, vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eSampled,
+                   vk::ImageAspectFlagBits::eDepth, &m_depth},
+        Attachment{SHADED_FORMAT, vk::ImageUsageFlagBits::eStorage,
+                   vk::ImageAspectFlagBits::eColor, &m_shaded}
+    };
+
+    for (auto& attachment : attachments) {
+        auto image_info = vk::ImageCreateInfo()
+            .setImageType(vk::ImageType::e2D)
+            .setFormat(attachment.format)
+            .setExtent(vk::Extent3D(extent.width, extent.height, 1))
+            .setMipLevels(1)
+            .setArrayLayers(1)
+            .setSamples(vk::SampleCountFlagBits::e1)
+            .setTiling(vk::ImageTiling::eOptimal)
+            .setUsage(attachment.usage)
+            .setSharingMode(vk::SharingMode::eExclusive)
+            .setInitialLayout(vk::ImageLayout::eUndefined);
+
+		auto image_res = m_device.createImage(image_info);
+		if (image_res.result != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Failed to create visibility image: {}", to_string(image_res.result)));
+		}
+		attachment.image->image = image_res.value;
+
+        auto mem_reqs = m_device.getImageMemoryRequirements(attachment.image->image);
+        auto memory_type = m_context->find_memory_type(mem_reqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
+        if (!memory_type) {
+            return std::unexpected("Failed to find suitable memory type for visibility image");
+        }
+
+		auto alloc_res = m_device.allocateMemory(vk::MemoryAllocateInfo(mem_reqs.size, *memory_type));
+		if (alloc_res.result != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Failed to allocate visibility image memory: {}", to_string(alloc_res.result)));
+		}
+		attachment.image->memory = alloc_res.value;
+
+		auto bind_res = m_device.bindImageMemory(attachment.image->image, attachment.image->memory, 0);
+		if (bind_res != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Failed to bind visibility image memory: {}", to_string(bind_res)));
+		}
+
+        auto view_info = vk::ImageViewCreateInfo()
+            .setImage(attachment.image->image)
+            .setViewType(vk::ImageViewType::e2D)
+            .setFormat(attachment.format)
+            .setSubresourceRange(vk::ImageSubresourceRange(attachment.aspect, 0, 1, 0, 1));
+
+		auto view_res = m_device.createImageView(view_info);
+		if (view_res.result != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Failed to create visibility image view: {}", to_string(view_res.result)));
+		}
+		attachment.image->view = view_res.value;
+    }
+
+    std::array views = {m_ids.view, m_depth.view};
+    auto framebuffer_info = vk::FramebufferCreateInfo()
+        .setRenderPass(m_render_pass)
+        .setAttachments(views)
+        .setWidth(extent.width)
+        .setHeight(extent.height)
+        .setLayers(1);
+
+	auto framebuffer_res = m_device.createFramebuffer(framebuffer_info);
+	if (framebuffer_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create visibility framebuffer: {}", to_string(framebuffer_res.result)));
+	}
+	m_framebuffer = framebuffer_res.value;
+
+    auto ids_info = vk::DescriptorImageInfo()
+        .setImageView(m_ids.view)
+        .setImageLayout(vk::ImageLayout::eGeneral);
+    auto shaded_info = vk::DescriptorImageInfo()
+        .setImageView(m_shaded.view)
+        .setImageLayout(vk::ImageLayout::eGeneral);
+    auto depth_info = vk::DescriptorImageInfo()
+        .setImageView(m_depth.view)
+        .setImageLayout(vk::ImageLayout::eDepthStencilReadOnlyOptimal);
+    std::array writes = {
+        vk::WriteDescriptorSet()
+            .setDstSet(m_descriptor_set)
+            .setDstBinding(0)
+            .setDescriptorType(vk::DescriptorType::eStorageImage)
+            .setImageInfo(ids_info),
+        vk::WriteDescriptorSet()
+            .setDstSet(m_descriptor_set)
+            .setDstBinding(1)
+            .setDescriptorType(vk::DescriptorType::eStorageImage)
+            .setImageInfo(shaded_info),
+        vk::WriteDescriptorSet()
+            .setDstSet(m_descriptor_set)
+            .setDstBinding(2)
+            .setDescriptorType(vk::DescriptorType::eSampledImage)
+            .setImageInfo(depth_info)
+    };
+    m_device.updateDescriptorSets(writes, {});
+
+    m_extent = extent;
+    m_shaded_initialized = false;
+    return {};
+}
+
+void VisibilityBuffer::destroy_images() {
+    if (m_framebuffer) {
+        m_device.destroyFramebuffer(m_framebuffer);
+        m_framebuffer = nullptr;
+    }
+    for (auto* image : {&m_ids, &m_depth, &m_shaded}) {
+        if (image->view) m_device.destroyImageView(image->view);
+        if (image->image) m_device.destroyImage(image->image);
+        if (image->memory) m_device.freeMemory(image->memory);  // After the image it backs
+        *image = Image{};
+    }
+    m_extent = vk::Extent2D{};
+    m_shaded_initialized = false;
+}
+
+bool VisibilityBuffer::begin(vk::CommandBuffer cmd, const vk::Extent2D& extent) {
+    if (extent.width == 0 || extent.height == 0) {
+        return false;
+    }
+    if (extent != m_extent) {
+        // The other frame in flight may still use the old images
+        auto _ = m_device.waitIdle();
+        destroy_images();
+        if (auto result = create_images(extent); !result) {
+            Logger::instance().error("{}", result.error());
+            destroy_images();
+            return false;
+        }
+    }
+
+    std::array clear_values = {
+        vk::ClearValue(vk::ClearColorValue(std::array<uint32_t, 4>{EMPTY, 0, 0, 0})),
+        vk::ClearValue(vk::ClearDepthStencilValue(1.0f, 0))
+    };
+    auto render_pass_begin = vk::RenderPassBeginInfo()
+        .setRenderPass(m_render_pass)
+        .setFramebuffer(m_framebuffer)
+        .setRenderArea(vk::Rect2D({0, 0}, extent))
+        .setClearValues(clear_values);
+
+    cmd.beginRenderPass(render_pass_begin, vk::SubpassContents::eInline);
+    return true;
+}
+
+void VisibilityBuffer::end_and_shade(vk::CommandBuffer cmd, vk::DescriptorSet frontend_set) {
+    cmd.endRenderPass();
+
+    auto range = vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1);
+
+    // Previous frame's composite reads -> this frame's shading writes
+    auto to_shade = vk::ImageMemoryBarrier()
+        .setSrcAccessMask(vk::AccessFlagBits::eShaderRead)
+        .setDstAccessMask(vk::AccessFlagBits::eShaderWrite)
+        .setOldLayout(m_shaded_initialized ? vk::ImageLayout::eGeneral : vk::ImageLayout::eUndefined)
+        .setNewLayout(vk::ImageLayout::eGeneral)
+        .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+        .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+        .setImage(m_shaded.image)
+        .setSubresourceRange(range);
+
+    cmd.pipelineBarrier(
+        vk::PipelineStageFlagBits::eFragmentShader,
+        vk::PipelineStageFlagBits::eComputeShader,
+        {},
+        {},
+        {},
+        to_shade
+    );
+    m_shaded_initialized = true;
+
+    std::array sets = {frontend_set, m_descriptor_set};
+    const std::array<uint32_t, 2> extent = {m_extent.width, m_extent.height};
+    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, m_shade_pipeline);
+    cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_shade_layout, 0, sets, {});
+    cmd.pushConstants<std::array<uint32_t, 2>>(m_shade_layout, vk::ShaderStageFlagBits::eCompute, 0, extent);
+    cmd.dispatch((m_extent.width + SHADE_GROUP_SIZE - 1) / SHADE_GROUP_SIZE,
+                 (m_extent.height + SHADE_GROUP_SIZE - 1) / SHADE_GROUP_SIZE, 1);
+
+    // Shaded pixels -> composite
+    auto shaded = vk::MemoryBarrier()
+        .setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eShaderRead);
+
+    cmd.pipelineBarrier(
+        vk::PipelineStageFlagBits::eComputeShader,
+        vk::PipelineStageFlagBits::eFragmentShader,
+        {},
+        shaded,
+        {},
+        {}
+    );
+}
+
+void VisibilityBuffer::record_composite(vk::CommandBuffer cmd, vk::Offset2D origin) const {
+    const std::array<int32_t, 2> push = {origin.x, origin.y};
+    cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, m_composite_pipeline);
+    cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_composite_layout, 0, m_descriptor_set, {});
+    cmd.pushConstants<std::array<int32_t, 2>>(m_composite_layout, vk::ShaderStageFlagBits::eFragment, 0, push);
+    cmd.draw(3, 1, 0, 0);
+}
+
+} // namespace ifs
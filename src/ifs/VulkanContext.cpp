@@ -2,6 +2,7 @@
 
 #include <ifs/VulkanContext.hpp>
 #include <ifs/Logger.hpp>
+#include <algorithm>
 #include <set>
 #include <optional>
 
@@ -199,6 +200,7 @@ QueueFamilyIndices find_queue_families(vk::PhysicalDevice physical_device)
 
     std::optional<uint32_t> graphics;
     std::optional<uint32_t> compute;
+    uint32_t compute_queue_count = 1;
 
     for (uint32_t i = 0; i < queue_families.size(); i++) {
         const auto& family = queue_families[i];
@@ -210,6 +212,7 @@ QueueFamilyIndices find_queue_families(vk::PhysicalDevice physical_device)
         if (family.queueFlags & vk::QueueFlagBits::eCompute) {
             if (!compute.has_value() || !(family.queueFlags & vk::QueueFlagBits::eGraphics)) {
                 compute = i;
+                compute_queue_count = family.queueCount;
             }
         }
     }
@@ -218,10 +221,62 @@ QueueFamilyIndices find_queue_families(vk::PhysicalDevice physical_device)
         throw std::runtime_error{"Failed to find required queue families"};
     }
 
-    Logger::instance().debug("Queue families - graphics: {}, compute: {}",
-                              *graphics, *compute);
+    Logger::instance().debug("Queue families - graphics: {}, compute: {} ({} queues)",
+                              *graphics, *compute, compute_queue_count);
 
-    return {*graphics, *compute};
+    return {*graphics, *compute, compute_queue_count};
+}
+
+bool supports_device_extension(vk::PhysicalDevice physical_device, std::string_view name)
+{
+    auto extensions_res = physical_device.enumerateDeviceExtensionProperties();
+    if (extensions_res.result != vk::Result::eSuccess) {
+        return false;
+    }
+    for (const auto& extension : extensions_res.value) {
+        if (std::string_view{extension.extensionName.data()} == name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool supports_graphics_pipeline_library(vk::PhysicalDevice physical_device)
+{
+    if (!supports_device_extension(physical_device, VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME) ||
+        !supports_device_extension(physical_device, VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME)) {
+        return false;
+    }
+    auto features = physical_device.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT>();
+    return features.get<vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT>().graphicsPipelineLibrary;
+}
+
+bool supports_multiview(vk::PhysicalDevice physical_device)
+{
+    auto features = physical_device.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan11Features>();
+    return features.get<vk::PhysicalDeviceVulkan11Features>().multiview;
+}
+
+bool supports_present_wait(vk::PhysicalDevice physical_device)
+{
+    if (!supports_device_extension(physical_device, VK_KHR_PRESENT_ID_EXTENSION_NAME) ||
+        !supports_device_extension(physical_device, VK_KHR_PRESENT_WAIT_EXTENSION_NAME)) {
+        return false;
+    }
+    auto features = physical_device.getFeatures2<vk::PhysicalDeviceFeatures2,
+        vk::PhysicalDevicePresentIdFeaturesKHR, vk::PhysicalDevicePresentWaitFeaturesKHR>();
+    return features.get<vk::PhysicalDevicePresentIdFeaturesKHR>().presentId &&
+        features.get<vk::PhysicalDevicePresentWaitFeaturesKHR>().presentWait;
+}
+
+bool supports_external_fd(vk::PhysicalDevice physical_device)
+{
+    if (!supports_device_extension(physical_device, VK_KHR_EXTERNAL_MEMORY_FD_EXTENSION_NAME) ||
+        !supports_device_extension(physical_device, VK_KHR_EXTERNAL_SEMAPHORE_FD_EXTENSION_NAME)) {
+        return false;
+    }
+    auto features = physical_device.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>();
+    return features.get<vk::PhysicalDeviceVulkan12Features>().timelineSemaphore;
 }
 
 vk::Device create_logical_device(vk::PhysicalDevice physical_device, const QueueFamilyIndices& indices)
@@ -229,34 +284,81 @@ vk::Device create_logical_device(vk::PhysicalDevice physical_device, const Queue
     std::vector<vk::DeviceQueueCreateInfo> queue_create_infos;
     std::set<uint32_t> unique_families = {indices.graphics, indices.compute};
 
-    float queue_priority = 1.0f;
+    // Every queue the compute family offers is created so chunked dispatches can
+    // run side by side; the graphics family (if separate) only needs one.
+    std::vector<float> queue_priorities(indices.compute_queue_count, 1.0f);
     for (uint32_t family : unique_families) {
+        uint32_t count = family == indices.compute ? indices.compute_queue_count : 1;
         auto queue_create_info = vk::DeviceQueueCreateInfo()
             .setQueueFamilyIndex(family)
-            .setQueueCount(1)
-            .setPQueuePriorities(&queue_priority);
+            .setQueueCount(count)
+            .setPQueuePriorities(queue_priorities.data());
         queue_create_infos.push_back(queue_create_info);
     }
 
     std::vector<const char*> extensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+    // Optional: per-heap usage/budget for the metrics panel
+    if (supports_device_extension(physical_device, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME)) {
+        extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    }
+    // Optional: pipelines linked from separately compiled parts (PipelineLibrary)
+    const bool pipeline_library = supports_graphics_pipeline_library(physical_device);
+    if (pipeline_library) {
+        extensions.push_back(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME);
+        extensions.push_back(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+    }
+    // Optional: timestamps of when presented images reach the display (latency panel)
+    const bool present_wait = supports_present_wait(physical_device);
+    if (present_wait) {
+        extensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+        extensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+    }
+
+    // Optional: particle buffers and timeline semaphores shared with other processes (ParticleShare)
+    const bool external_fd = supports_external_fd(physical_device);
+    if (external_fd) {
+        extensions.push_back(VK_KHR_EXTERNAL_MEMORY_FD_EXTENSION_NAME);
+        extensions.push_back(VK_KHR_EXTERNAL_SEMAPHORE_FD_EXTENSION_NAME);
+    }
 
     // Base features
     vk::PhysicalDeviceFeatures features{};
     features.tessellationShader = VK_TRUE;
     features.geometryShader = VK_TRUE;
 
+    // Optional diagnostics features (pipeline statistics, overdraw heatmap)
+    auto supported_features = physical_device.getFeatures();
+    features.pipelineStatisticsQuery = supported_features.pipelineStatisticsQuery;
+    features.fragmentStoresAndAtomics = supported_features.fragmentStoresAndAtomics;
+
     // Vulkan 1.1 features
     vk::PhysicalDeviceVulkan11Features vulkan11_features{};
     vulkan11_features.shaderDrawParameters = VK_TRUE;
+    vulkan11_features.multiview = supports_multiview(physical_device);  // Optional: split-screen views (MultiviewTarget)
 
     // Vulkan 1.2 features
     vk::PhysicalDeviceVulkan12Features vulkan12_features{};
+    vulkan12_features.hostQueryReset = VK_TRUE;  // Timestamp pools are reset from the host
+    vulkan12_features.timelineSemaphore = external_fd;  // ParticleShare write/read handshake
     vulkan12_features.pNext = &vulkan11_features;
 
+    vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT pipeline_library_features{};
+    pipeline_library_features.graphicsPipelineLibrary = VK_TRUE;
+    if (pipeline_library) {
+        vulkan11_features.pNext = &pipeline_library_features;
+    }
+
+    vk::PhysicalDevicePresentIdFeaturesKHR present_id_features{};
+    present_id_features.presentId = VK_TRUE;
+    present_id_features.pNext = &vulkan12_features;
+    vk::PhysicalDevicePresentWaitFeaturesKHR present_wait_features{};
+    present_wait_features.presentWait = VK_TRUE;
+    present_wait_features.pNext = &present_id_features;
+
     // Features2 container
     vk::PhysicalDeviceFeatures2 features2{};
     features2.features = features;
-    features2.pNext = &vulkan12_features;
+    features2.pNext = present_wait ? static_cast<void*>(&present_wait_features) : static_cast<void*>(&vulkan12_features);
 
     auto create_info = vk::DeviceCreateInfo()
         .setQueueCreateInfos(queue_create_infos)
@@ -281,8 +383,15 @@ VulkanContext::VulkanContext(std::string_view title)
     , m_queue_indices(find_queue_families(m_physical_device))
     , m_device(create_logical_device(m_physical_device, m_queue_indices))
     , m_graphics_queue(m_device.getQueue(m_queue_indices.graphics, 0))
-    , m_compute_queue(m_device.getQueue(m_queue_indices.compute, 0))
+    , m_memory_budget(supports_device_extension(m_physical_device, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME))
+    , m_graphics_pipeline_library(supports_graphics_pipeline_library(m_physical_device))
+    , m_multiview(supports_multiview(m_physical_device))
+    , m_present_wait(supports_present_wait(m_physical_device))
+    , m_external_fd(supports_external_fd(m_physical_device))
 {
+    for (uint32_t i = 0; i < m_queue_indices.compute_queue_count; i++) {
+        m_compute_queues.push_back(m_device.getQueue(m_queue_indices.compute, i));
+    }
 	Logger::instance().info("VulkanContext VK_HEADER_VERSION: {}", VK_HEADER_VERSION);
     Logger::instance().info("VulkanContext initialized");
 	VULKAN_HPP_DEFAULT_DISPATCHER.init(m_device);
@@ -302,3 +411,30 @@ VulkanContext::~VulkanContext()
         Logger::instance().trace("Destroyed instance");
     }
 }
+
+std::array<uint8_t, VK_UUID_SIZE> VulkanContext::device_uuid() const
+{
+    auto properties = m_physical_device.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceIDProperties>();
+    std::array<uint8_t, VK_UUID_SIZE> uuid{};
+    std::ranges::copy(properties.get<vk::PhysicalDeviceIDProperties>().deviceUUID, uuid.begin());
+    return uuid;
+}
+
+std::array<uint8_t, VK_UUID_SIZE> VulkanContext::driver_uuid() const
+{
+    auto properties = m_physical_device.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceIDProperties>();
+    std::array<uint8_t, VK_UUID_SIZE> uuid{};
+    std::ranges::copy(properties.get<vk::PhysicalDeviceIDProperties>().driverUUID, uuid.begin());
+    return uuid;
+}
+
+std::optional<uint32_t> VulkanContext::find_memory_type(uint32_t type_bits, vk::MemoryPropertyFlags flags) const
+{
+    auto mem_props = m_physical_device.getMemoryProperties();
+    for (uint32_t i = 0; i < mem_props.memoryTypeCount; i++) {
+        if ((type_bits & (1 << i)) && (mem_props.memoryTypes[i].propertyFlags & flags) == flags) {
+            return i;
+        }
+    }
+    return std::nullopt;
+}
@@ -82,17 +82,20 @@ Window::Window(Window&& other) noexcept
     , m_image_views(std::move(other.m_image_views))
     , m_framebuffers(std::move(other.m_framebuffers))
     , m_render_pass(other.m_render_pass)
+    , m_load_render_pass(other.m_load_render_pass)
     , m_depth_image(other.m_depth_image)
     , m_depth_memory(other.m_depth_memory)
     , m_depth_image_view(other.m_depth_image_view)
     , m_depth_format(other.m_depth_format)
     , m_current_image_index(other.m_current_image_index)
     , m_needs_resize(other.m_needs_resize)
+    , m_low_latency(other.m_low_latency)
 {
     other.m_window_handle = nullptr;
     other.m_surface = nullptr;
     other.m_swapchain = nullptr;
     other.m_render_pass = nullptr;
+    other.m_load_render_pass = nullptr;
     other.m_depth_image = nullptr;
     other.m_depth_memory = nullptr;
     other.m_depth_image_view = nullptr;
@@ -119,17 +122,20 @@ Window& Window::operator=(Window&& other) noexcept {
         m_image_views = std::move(other.m_image_views);
         m_framebuffers = std::move(other.m_framebuffers);
         m_render_pass = other.m_render_pass;
+        m_load_render_pass = other.m_load_render_pass;
         m_depth_image = other.m_depth_image;
         m_depth_memory = other.m_depth_memory;
         m_depth_image_view = other.m_depth_image_view;
         m_depth_format = other.m_depth_format;
         m_current_image_index = other.m_current_image_index;
         m_needs_resize = other.m_needs_resize;
+        m_low_latency = other.m_low_latency;
 
         other.m_window_handle = nullptr;
         other.m_surface = nullptr;
         other.m_swapchain = nullptr;
         other.m_render_pass = nullptr;
+        other.m_load_render_pass = nullptr;
         other.m_depth_image = nullptr;
         other.m_depth_memory = nullptr;
         other.m_depth_image_view = nullptr;
@@ -300,16 +306,40 @@ std::expected<void, std::string> Window::create_render_pass() {
             vk::AccessFlagBits::eColorAttachmentWrite |
             vk::AccessFlagBits::eDepthStencilAttachmentWrite);
 
+    // Lets a fragment pass read storage-image writes of an earlier draw in the
+    // same subpass (overdraw heatmap resolve, see OverdrawHeatmap)
+    auto self_dependency = vk::SubpassDependency()
+        .setSrcSubpass(0)
+        .setDstSubpass(0)
+        .setSrcStageMask(vk::PipelineStageFlagBits::eFragmentShader)
+        .setDstStageMask(vk::PipelineStageFlagBits::eFragmentShader)
+        .setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eShaderRead)
+        .setDependencyFlags(vk::DependencyFlagBits::eByRegion);
+
+    std::array dependencies = {dependency, self_dependency};
+
     std::array<vk::AttachmentDescription, 2> attachments = {color_attachment, depth_attachment};
 
     auto render_pass_info = vk::RenderPassCreateInfo()
         .setAttachments(attachments)
         .setSubpasses(subpass)
-        .setDependencies(dependency);
+        .setDependencies(dependencies);
 
 	auto render_pass_res = m_device.createRenderPass(render_pass_info);
 	CHECK_VK_RESULT(render_pass_res, "Could not create render pass");
     m_render_pass = render_pass_res.value;
+
+    // Compatible pass that keeps what an earlier submission drew into the
+    // image (split-screen views of another frontend); depth is cleared again
+    attachments[0]
+        .setLoadOp(vk::AttachmentLoadOp::eLoad)
+        .setInitialLayout(vk::ImageLayout::ePresentSrcKHR);
+    dependencies[0].dstAccessMask |= vk::AccessFlagBits::eColorAttachmentRead;
+
+	auto load_render_pass_res = m_device.createRenderPass(render_pass_info);
+	CHECK_VK_RESULT(load_render_pass_res, "Could not create load render pass");
+    m_load_render_pass = load_render_pass_res.value;
     return {};
 }
 
@@ -353,26 +383,15 @@ std::expected<void, std::string> Window::create_depth_resources() {
 
     // Allocate memory for depth image
     auto mem_requirements = m_device.getImageMemoryRequirements(m_depth_image);
-    auto mem_properties = m_context->physical_device().getMemoryProperties();
-
-    uint32_t memory_type_index = UINT32_MAX;
-    vk::MemoryPropertyFlags required_props = vk::MemoryPropertyFlagBits::eDeviceLocal;
-
-    for (uint32_t i = 0; i < mem_properties.memoryTypeCount; i++) {
-        if ((mem_requirements.memoryTypeBits & (1 << i)) &&
-            (mem_properties.memoryTypes[i].propertyFlags & required_props) == required_props) {
-            memory_type_index = i;
-            break;
-        }
-    }
-
-    if (memory_type_index == UINT32_MAX) {
+    auto memory_type_index = m_context->find_memory_type(mem_requirements.memoryTypeBits,
+        vk::MemoryPropertyFlagBits::eDeviceLocal);
+    if (!memory_type_index) {
         return std::unexpected("Failed to find suitable memory type for depth image");
     }
 
     auto alloc_info = vk::MemoryAllocateInfo()
         .setAllocationSize(mem_requirements.size)
-        .setMemoryTypeIndex(memory_type_index);
+        .setMemoryTypeIndex(*memory_type_index);
 
 	auto depth_mem_res = m_device.allocateMemory(alloc_info);
 	CHECK_VK_RESULT(depth_mem_res, "Could not allocate depth memory {}");
@@ -478,12 +497,17 @@ std::optional<uint32_t> Window::acquire_next_image(
 bool Window::present(
     vk::Queue present_queue,
     vk::Semaphore wait_semaphore,
-    uint32_t image_index
+    uint32_t image_index,
+    uint64_t present_id
 ) {
     auto present_info = vk::PresentInfoKHR()
         .setWaitSemaphores(wait_semaphore)
         .setSwapchains(m_swapchain)
         .setImageIndices(image_index);
+    auto present_id_info = vk::PresentIdKHR().setPresentIds(present_id);
+    if (present_id != 0 && m_context->has_present_wait()) {
+        present_info.setPNext(&present_id_info);
+    }
 
 	auto result = vkQueuePresentKHR( // This hurts my soul but some genius at vk hpp decided that recreating a swapchain is a fatal error
 	present_queue,
@@ -508,6 +532,22 @@ bool Window::present(
 	return true;
 }
 
+bool Window::wait_for_present(uint64_t present_id, uint64_t timeout) {
+    if (!m_context->has_present_wait() || !m_swapchain) {
+        return false;
+    }
+    // Suboptimal still means the image was displayed; out-of-date is handled by the next acquire
+    const vk::Result result = m_device.waitForPresentKHR(m_swapchain, present_id, timeout);
+    return result == vk::Result::eSuccess || result == vk::Result::eSuboptimalKHR;
+}
+
+void Window::set_low_latency(bool enabled) {
+    if (enabled != m_low_latency) {
+        m_low_latency = enabled;
+        m_needs_resize = true;
+    }
+}
+
 std::expected<void, std::string> Window::recreate_swapchain() {
     // Get new window size
     int width, height;
@@ -582,6 +622,10 @@ void Window::cleanup() {
             m_device.destroyRenderPass(m_render_pass);
             m_render_pass = nullptr;
         }
+        if (m_load_render_pass) {
+            m_device.destroyRenderPass(m_load_render_pass);
+            m_load_render_pass = nullptr;
+        }
 
         if (m_surface) {
             m_context->instance().destroySurfaceKHR(m_surface);
@@ -606,11 +650,17 @@ vk::SurfaceFormatKHR Window::choose_surface_format(
 vk::PresentModeKHR Window::choose_present_mode(
     const std::vector<vk::PresentModeKHR>& available_modes
 ) const {
+    auto available = [&](vk::PresentModeKHR mode) {
+        return std::find(available_modes.begin(), available_modes.end(), mode) != available_modes.end();
+    };
+
+    // Low latency: show each image as soon as it is rendered, even mid-scanout
+    if (m_low_latency && available(vk::PresentModeKHR::eImmediate)) {
+        return vk::PresentModeKHR::eImmediate;
+    }
     // Prefer mailbox (triple buffering) if available
-    for (const auto& mode : available_modes) {
-        if (mode == vk::PresentModeKHR::eMailbox) {
-            return mode;
-        }
+    if (available(vk::PresentModeKHR::eMailbox)) {
+        return vk::PresentModeKHR::eMailbox;
     }
     return vk::PresentModeKHR::eFifo;  // Always available
 }
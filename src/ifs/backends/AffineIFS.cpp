@@ -0,0 +1,1123 @@
+#include <ifs/backends/AffineIFS.hpp>
+#include <ifs/Logger.hpp>
+#include <ifs/StartupTrace.hpp>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <utility>
+
+namespace ifs {
+
+namespace {
+
+// Parameter structure matching AffineParams in affine_ifs.slang
+struct alignas(16) AffineShaderParams {
+    uint32_t iteration_count;
+    uint32_t particle_count;
+    uint32_t random_seed;
+    uint32_t map_count;
+    uint32_t warm_start;
+    uint32_t generation;
+    uint32_t word_count;
+    uint32_t padding;
+};
+
+// Map layout matching AffineMap in affine_ifs.slang
+struct GPUAffineMap {
+    glm::vec4 rows[3];   ///< Linear part in xyz, offset in w
+    uint32_t color;      ///< RGBA8
+    float threshold;     ///< Alias table slot (AliasEntry)
+    uint32_t alias;
+    uint32_t padding;
+};
+static_assert(sizeof(GPUAffineMap) == 64, "Four maps per 256-byte line, 256 maps per 16 KB tile");
+
+uint32_t pack_color(glm::vec3 color) {
+    const auto channel = [](float value) {
+        return static_cast<uint32_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+    };
+    return channel(color.r) | (channel(color.g) << 8) | (channel(color.b) << 16) | (255u << 24);
+}
+
+/**
+ * @brief Allocate a persistently mapped host-visible buffer
+ */
+std::expected<void, std::string> create_host_buffer(
+    const VulkanContext& context,
+    vk::Device device,
+    vk::DeviceSize size,
+    vk::BufferUsageFlags usage,
+    vk::Buffer& buffer,
+    vk::DeviceMemory& memory,
+    void*& mapped
+) {
+    auto buffer_info = vk::BufferCreateInfo()
+        .setSize(size)
+        .setUsage(usage)
+        .setSharingMode(vk::SharingMode::eExclusive);
+
+	auto buffer_res = device.createBuffer(buffer_info);
+	if (buffer_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Could not create buffer {}", to_string(buffer_res.result)));
+	}
+	buffer = buffer_res.value;
+
+    auto mem_reqs = device.getBufferMemoryRequirements(buffer);
+    const auto flags = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+
+    auto memory_type = context.find_memory_type(mem_reqs.memoryTypeBits, flags);
+    if (!memory_type) {
+        return std::unexpected("Failed to find host-visible memory");
+    }
+
+	auto alloc_res = device.allocateMemory(vk::MemoryAllocateInfo(mem_reqs.size, *memory_type));
+	if (alloc_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Could not allocate device memory {}", to_string(alloc_res.result)));
+	}
+	memory = alloc_res.value;
+
+	auto bind_res = device.bindBufferMemory(buffer, memory, 0);
+	if (bind_res != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Could not bind memory to buffer {}", to_string(bind_res)));
+	}
+
+	auto map_res = device.mapMemory(memory, 0, VK_WHOLE_SIZE);
+	if (map_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Could not map memory {}", to_string(map_res.result)));
+	}
+	mapped = map_res.value;
+    return {};
+}
+
+/**
+ * @brief 2D map x' = a x + b y + e, y' = c x + d y + f (z collapses to 0)
+ */
+AffineMap map_2d(float a, float b, float c, float d, float e, float f, float weight, glm::vec3 color) {
+    glm::mat3 linear(0.0f);
+    linear[0][0] = a;
+    linear[1][0] = b;
+    linear[0][1] = c;
+    linear[1][1] = d;
+    return {.linear = linear, .offset = {e, f, 0.0f}, .weight = weight, .color = color};
+}
+
+/**
+ * @brief Uniform contraction by `ratio` towards `fixed_point`
+ */
+AffineMap contract_towards(glm::vec3 fixed_point, float ratio, glm::vec3 color) {
+    return {.linear = glm::mat3(ratio), .offset = fixed_point * (1.0f - ratio), .weight = 1.0f, .color = color};
+}
+
+/**
+ * @brief Conjugate every map by T(p) = scale * p + shift, moving the attractor by T
+ */
+AffineIFSDefinition transformed(AffineIFSDefinition definition, float scale, glm::vec3 shift) {
+    for (auto& map : definition.maps) {
+        // T f T^-1 (p) = L p + scale * offset + shift - L shift
+        map.offset = scale * map.offset + shift - map.linear * shift;
+    }
+    return definition;
+}
+
+constexpr std::array PRESET_NAMES = {
+    std::string_view("sierpinski_triangle"),
+    std::string_view("barnsley_fern"),
+    std::string_view("sierpinski_tetrahedron"),
+    std::string_view("menger_sponge"),
+};
+
+} // anonymous namespace
+
+std::vector<AliasEntry> build_alias_table(std::span<const float> weights) {
+    const auto n = static_cast<uint32_t>(weights.size());
+    std::vector<AliasEntry> table(n);
+    if (n == 0) {
+        return table;
+    }
+
+    double total = 0.0;
+    for (float weight : weights) {
+        total += std::max(weight, 0.0f);
+    }
+
+    // Vose: pair every under-full slot with an over-full one that tops it up
+    std::vector<double> scaled(n);
+    std::vector<uint32_t> small;
+    std::vector<uint32_t> large;
+    for (uint32_t i = 0; i < n; i++) {
+        scaled[i] = total > 0.0 ? std::max(weights[i], 0.0f) * n / total : 1.0;
+        (scaled[i] < 1.0 ? small : large).push_back(i);
+        table[i].alias = i;
+    }
+    while (!small.empty() && !large.empty()) {
+        const uint32_t under = small.back();
+        const uint32_t over = large.back();
+        small.pop_back();
+        table[under].threshold = static_cast<float>(scaled[under]);
+        table[under].alias = over;
+        scaled[over] -= 1.0 - scaled[under];
+        if (scaled[over] < 1.0) {
+            large.pop_back();
+            small.push_back(over);
+        }
+    }
+    // Leftovers are full up to rounding
+    for (uint32_t i : small) {
+        table[i].threshold = 1.0f;
+    }
+    for (uint32_t i : large) {
+        table[i].threshold = 1.0f;
+    }
+    return table;
+}
+
+namespace {
+
+/**
+ * @brief Largest singular value (power iteration on L^T L)
+ */
+template <typename Matrix>
+typename Matrix::value_type spectral_norm(const Matrix& linear) {
+    using Vector = typename Matrix::col_type;
+    using Scalar = typename Matrix::value_type;
+    const Matrix gram = glm::transpose(linear) * linear;
+    // Asymmetric start, unlikely to be orthogonal to the dominant direction of axis-aligned maps
+    Vector v = glm::normalize(Vector(1.0, 0.7, 0.3));
+    Scalar eigenvalue = 0;
+    for (int i = 0; i < 32; i++) {
+        const Vector next = gram * v;
+        eigenvalue = glm::length(next);
+        if (eigenvalue == 0) {
+            break;
+        }
+        v = next / eigenvalue;
+    }
+    return std::sqrt(eigenvalue);
+}
+
+/**
+ * @brief Selection probabilities (uniform if no weight is positive)
+ */
+std::vector<float> probabilities(const AffineIFSDefinition& definition) {
+    float total = 0.0f;
+    for (const auto& map : definition.maps) {
+        total += std::max(map.weight, 0.0f);
+    }
+    std::vector<float> result;
+    result.reserve(definition.maps.size());
+    for (const auto& map : definition.maps) {
+        result.push_back(total > 0.0f ? std::max(map.weight, 0.0f) / total : 1.0f / definition.maps.size());
+    }
+    return result;
+}
+
+} // anonymous namespace
+
+std::optional<uint32_t> warm_start_iterations(
+    const AffineIFSDefinition& from,
+    const AffineIFSDefinition& to,
+    float tolerance
+) {
+    if (from.maps.size() != to.maps.size() || to.maps.empty()) {
+        return std::nullopt;
+    }
+
+    const auto p_from = probabilities(from);
+    const auto p_to = probabilities(to);
+    // Worst case: an orbit may keep picking the slowest map, however unlikely it is
+    float rate = 0.0f;
+    float max_offset = 0.0f;
+    for (size_t i = 0; i < to.maps.size(); i++) {
+        rate = std::max(rate, spectral_norm(to.maps[i].linear));
+        max_offset = std::max(max_offset, glm::length(to.maps[i].offset));
+    }
+    if (rate >= 1.0f) {
+        return std::nullopt;
+    }
+    const float log_rate = std::log(std::max(rate, 1e-6f));
+    // Attractor within this distance of the origin (fixed point argument)
+    const float radius = max_offset / (1.0f - rate);
+
+    float map_shift = 0.0f;
+    float mass_moved = 0.0f;
+    float color_shift = 0.0f;
+    for (size_t i = 0; i < to.maps.size(); i++) {
+        const auto& a = from.maps[i];
+        const auto& b = to.maps[i];
+        map_shift = std::max(map_shift, spectral_norm(b.linear - a.linear) * radius + glm::length(b.offset - a.offset));
+        mass_moved += 0.5f * std::abs(p_to[i] - p_from[i]);
+        const glm::vec3 dc = glm::abs(b.color - a.color);
+        color_shift = std::max({color_shift, dc.r, dc.g, dc.b});
+    }
+
+    uint32_t iterations = 0;
+    const float distance = map_shift / (1.0f - rate) + mass_moved * 2.0f * radius;
+    if (distance > tolerance) {
+        iterations = static_cast<uint32_t>(std::ceil(std::log(tolerance / distance) / log_rate));
+    }
+    if (color_shift * 255.0f > 1.0f) {
+        iterations = std::max(iterations, static_cast<uint32_t>(std::ceil(std::log2(color_shift * 255.0f))));
+    }
+    return iterations;
+}
+
+std::expected<std::vector<DeepZoomWord>, std::string> deep_zoom_words(
+    const AffineIFSDefinition& definition,
+    const DeepZoomWord& post,
+    const DeepZoomView& view,
+    uint32_t max_words
+) {
+    struct Map {
+        glm::dmat3 linear;
+        glm::dvec3 offset;
+        double probability;
+        double norm;
+    };
+    const auto p = probabilities(definition);
+    std::vector<Map> maps;
+    for (size_t i = 0; i < definition.maps.size(); i++) {
+        if (p[i] <= 0.0f) {
+            continue;
+        }
+        const glm::dmat3 linear(definition.maps[i].linear);
+        const double norm = spectral_norm(linear);
+        if (norm >= 1.0) {
+            return std::unexpected(std::format("Deep zoom needs contractive maps (map {} has norm {:.3f})", i, norm));
+        }
+        maps.push_back({linear, glm::dvec3(definition.maps[i].offset), p[i], norm});
+    }
+
+    // Ball around the mean fixed point that every map sends into itself, so it holds the attractor:
+    // |f(x) - c| <= s R + |f(c) - c| <= R for R = max |f(c) - c| / (1 - s)
+    glm::dvec3 center(0.0);
+    for (const auto& map : maps) {
+        center += glm::inverse(glm::dmat3(1.0) - map.linear) * map.offset / static_cast<double>(maps.size());
+    }
+    double radius = 0.0;
+    double max_norm = 0.0;
+    for (const auto& map : maps) {
+        radius = std::max(radius, glm::length(map.linear * center + map.offset - center));
+        max_norm = std::max(max_norm, map.norm);
+    }
+    radius /= 1.0 - max_norm;
+
+    // Pieces carry an upper bound of their linear part's norm
+    struct Piece {
+        DeepZoomWord word;
+        double norm;
+    };
+    const double view_radius = view.radius * view.extent;
+    auto piece_radius = [&](const Piece& piece) { return piece.norm * radius; };
+    auto reaches_view = [&](const Piece& piece) {
+        const glm::dvec3 piece_center = piece.word.linear * center + piece.word.offset;
+        return glm::length(piece_center - view.anchor) <= piece_radius(piece) + view_radius;
+    };
+
+    std::vector<Piece> pieces;
+    const Piece root{post, spectral_norm(post.linear)};
+    if (reaches_view(root)) {
+        pieces.push_back(root);
+    }
+    // Subdivide level by level while pieces are larger than half the view
+    for (int depth = 0; depth < 256; depth++) {
+        std::vector<Piece> next;
+        bool split = false;
+        for (const auto& piece : pieces) {
+            if (piece_radius(piece) <= 0.5 * view_radius) {
+                next.push_back(piece);
+                continue;
+            }
+            split = true;
+            for (const auto& map : maps) {
+                Piece child{
+                    .word = {
+                        .linear = piece.word.linear * map.linear,
+                        .offset = piece.word.linear * map.offset + piece.word.offset,
+                        .probability = piece.word.probability * map.probability
+                    },
+                    .norm = piece.norm * map.norm
+                };
+                if (reaches_view(child)) {
+                    next.push_back(child);
+                }
+            }
+            if (next.size() > max_words) {
+                break;
+            }
+        }
+        if (!split || next.size() > max_words) {
+            break;
+        }
+        pieces = std::move(next);
+    }
+
+    std::vector<DeepZoomWord> words;
+    words.reserve(pieces.size());
+    for (const auto& piece : pieces) {
+        words.push_back(piece.word);
+    }
+    return words;
+}
+
+// ============================================================================
+// Definitions
+// ============================================================================
+
+AffineIFSDefinition AffineIFSDefinition::sierpinski_triangle() {
+    return {.maps = {
+        contract_towards({0.0f, 0.0f, 0.0f}, 0.5f, {1.0f, 0.2f, 0.2f}),
+        contract_towards({1.0f, 0.0f, 0.0f}, 0.5f, {0.2f, 1.0f, 0.2f}),
+        contract_towards({0.5f, 0.866f, 0.0f}, 0.5f, {0.2f, 0.4f, 1.0f}),
+    }};
+}
+
+AffineIFSDefinition AffineIFSDefinition::barnsley_fern() {
+    // Classic table; the attractor spans x in [-2.2, 2.7], y in [0, 10]
+    AffineIFSDefinition fern{.maps = {
+        map_2d(0.0f, 0.0f, 0.0f, 0.16f, 0.0f, 0.0f, 0.01f, {0.4f, 0.25f, 0.1f}),
+        map_2d(0.85f, 0.04f, -0.04f, 0.85f, 0.0f, 1.6f, 0.85f, {0.3f, 0.9f, 0.2f}),
+        map_2d(0.2f, -0.26f, 0.23f, 0.22f, 0.0f, 1.6f, 0.07f, {0.1f, 0.6f, 0.1f}),
+        map_2d(-0.15f, 0.28f, 0.26f, 0.24f, 0.0f, 0.44f, 0.07f, {0.5f, 0.8f, 0.1f}),
+    }};
+    return transformed(std::move(fern), 0.1f, {0.5f, 0.0f, 0.0f});
+}
+
+AffineIFSDefinition AffineIFSDefinition::sierpinski_tetrahedron() {
+    return {.maps = {
+        contract_towards({0.0f, 0.0f, 0.0f}, 0.5f, {1.0f, 0.2f, 0.2f}),
+        contract_towards({1.0f, 0.0f, 0.0f}, 0.5f, {0.2f, 1.0f, 0.2f}),
+        contract_towards({0.5f, 0.866f, 0.0f}, 0.5f, {0.2f, 0.4f, 1.0f}),
+        contract_towards({0.5f, 0.289f, 0.816f}, 0.5f, {1.0f, 0.9f, 0.2f}),
+    }};
+}
+
+AffineIFSDefinition AffineIFSDefinition::menger_sponge() {
+    // 20 sub-cubes of side 1/3: every cell of the 3x3x3 grid except the center and face centers
+    AffineIFSDefinition sponge;
+    for (int x = 0; x < 3; x++) {
+        for (int y = 0; y < 3; y++) {
+            for (int z = 0; z < 3; z++) {
+                if ((x == 1) + (y == 1) + (z == 1) >= 2) {
+                    continue;
+                }
+                glm::vec3 corner(x, y, z);
+                sponge.maps.push_back({
+                    .linear = glm::mat3(1.0f / 3.0f),
+                    .offset = corner / 3.0f,
+                    .weight = 1.0f,
+                    .color = glm::mix(glm::vec3(0.9f, 0.5f, 0.1f), glm::vec3(0.1f, 0.5f, 0.9f), corner / 2.0f),
+                });
+            }
+        }
+    }
+    return sponge;
+}
+
+std::span<const std::string_view> AffineIFSDefinition::preset_names() {
+    return PRESET_NAMES;
+}
+
+std::optional<AffineIFSDefinition> AffineIFSDefinition::preset(std::string_view name) {
+    if (name == "sierpinski_triangle") return sierpinski_triangle();
+    if (name == "barnsley_fern") return barnsley_fern();
+    if (name == "sierpinski_tetrahedron") return sierpinski_tetrahedron();
+    if (name == "menger_sponge") return menger_sponge();
+    return std::nullopt;
+}
+
+// ============================================================================
+// AffineIFS
+// ============================================================================
+
+AffineIFS::AffineIFS(
+    const VulkanContext& context,
+    vk::Device device,
+    AffineIFSDefinition definition
+)
+    : m_context(&context)
+    , m_device(device)
+    , m_particle_buffer(nullptr)
+    , m_particle_count(100000)  // Default particle count
+    , m_definition(std::move(definition))
+    , m_map_buffer(nullptr)
+    , m_map_memory(nullptr)
+    , m_compute_shader(nullptr)
+    , m_descriptor_layout(nullptr)
+    , m_pipeline_layout(nullptr)
+    , m_compute_pipeline(nullptr)
+    , m_descriptor_pool(nullptr)
+    , m_descriptor_set(nullptr)
+    , m_param_buffer(nullptr)
+    , m_param_memory(nullptr)
+    , m_scheduler(nullptr)
+{}
+
+std::expected<std::unique_ptr<AffineIFS>, std::string> AffineIFS::create(
+    const VulkanContext& context,
+    vk::Device device,
+    AffineIFSDefinition definition
+) {
+    if (definition.maps.empty()) {
+        return std::unexpected("An affine IFS needs at least one map");
+    }
+    if (definition.maps.size() > max_map_count) {
+        return std::unexpected(std::format("An affine IFS has at most {} maps, got {}", max_map_count, definition.maps.size()));
+    }
+
+    auto backend = std::unique_ptr<AffineIFS>(new AffineIFS(context, device, std::move(definition)));
+    if (auto result = backend->initialize(); !result) {
+        return std::unexpected(result.error());
+    }
+
+    Logger::instance().info("Created AffineIFS backend ({} maps)", backend->m_definition.maps.size());
+    return backend;
+}
+
+AffineIFS::~AffineIFS() {
+    cleanup();
+}
+
+std::expected<void, std::string> AffineIFS::initialize() {
+    auto shader_result = Shader::create_shader(
+        m_device, "ifs_modular/backends/affine_ifs", "main", m_stage_chain.specialization());
+    if (!shader_result) {
+        return std::unexpected(std::format("Failed to load shader: {}", shader_result.error()));
+    }
+    m_compute_shader = std::make_unique<Shader>(std::move(*shader_result));
+
+    if (auto result = create_descriptor_layout(); !result) {
+        return std::unexpected(result.error());
+    }
+    if (auto result = create_pipeline(); !result) {
+        return std::unexpected(result.error());
+    }
+
+    if (auto result = create_host_buffer(*m_context, m_device, sizeof(AffineShaderParams),
+            vk::BufferUsageFlagBits::eUniformBuffer, m_param_buffer, m_param_memory, m_param_mapped); !result) {
+        return std::unexpected(std::format("Parameter buffer: {}", result.error()));
+    }
+
+    auto stage_uniforms = StageUniformBuffer::create(*m_context);
+    if (!stage_uniforms) {
+        return std::unexpected(stage_uniforms.error());
+    }
+    m_stage_uniforms = std::move(*stage_uniforms);
+
+    std::vector<vk::DescriptorPoolSize> pool_sizes = {
+        vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, 2),
+        vk::DescriptorPoolSize(vk::DescriptorType::eUniformBuffer, 2)
+    };
+
+    auto pool_info = vk::DescriptorPoolCreateInfo()
+        .setMaxSets(1)
+        .setPoolSizes(pool_sizes);
+
+    auto descriptor_pool_res = m_device.createDescriptorPool(pool_info);
+	if (descriptor_pool_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Could not create descriptor pool {}", to_string(descriptor_pool_res.result)));
+	}
+	m_descriptor_pool = descriptor_pool_res.value;
+
+    auto alloc_info_desc = vk::DescriptorSetAllocateInfo()
+        .setDescriptorPool(m_descriptor_pool)
+        .setSetLayouts(m_descriptor_layout);
+
+    auto descriptor_set_res = m_device.allocateDescriptorSets(alloc_info_desc);
+	if (descriptor_set_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to allocate descriptor set {}", to_string(descriptor_set_res.result)));
+	}
+	m_descriptor_set = descriptor_set_res.value[0];
+
+    auto param_buffer_info = vk::DescriptorBufferInfo(m_param_buffer, 0, sizeof(AffineShaderParams));
+    auto stage_buffer_info = m_stage_uniforms->descriptor_info();
+    std::array writes = {
+        vk::WriteDescriptorSet()
+            .setDstSet(m_descriptor_set)
+            .setDstBinding(1)
+            .setDescriptorType(vk::DescriptorType::eUniformBuffer)
+            .setBufferInfo(param_buffer_info),
+        vk::WriteDescriptorSet()
+            .setDstSet(m_descriptor_set)
+            .setDstBinding(3)
+            .setDescriptorType(vk::DescriptorType::eUniformBuffer)
+            .setBufferInfo(stage_buffer_info)
+    };
+    m_device.updateDescriptorSets(writes, {});
+
+    if (auto result = upload_maps(); !result) {
+        return std::unexpected(result.error());
+    }
+
+    // Compute submission (one lane per compute queue)
+    auto scheduler_result = ComputeScheduler::create(*m_context);
+    if (!scheduler_result) {
+        return std::unexpected(std::format("Failed to create compute scheduler: {}", scheduler_result.error()));
+    }
+    m_scheduler = std::move(*scheduler_result);
+    m_scheduler->set_granularity(256);  // numthreads(256) in the shader
+
+    ParticleBufferConfig buffer_config{
+        .particle_count = m_particle_count,
+        .support_dynamic_resize = false
+    };
+
+    auto particle_buffer_result = ParticleBuffer::create(*m_context, m_device, buffer_config);
+    if (!particle_buffer_result) {
+        return std::unexpected(std::format("Failed to create particle buffer: {}", particle_buffer_result.error()));
+    }
+    m_particle_buffer = std::make_unique<ParticleBuffer>(std::move(particle_buffer_result.value()));
+
+    return {};
+}
+
+std::expected<void, std::string> AffineIFS::create_descriptor_layout() {
+    // Get descriptor info from shader reflection
+    auto& descriptors = m_compute_shader->get_descriptor_infos();
+
+    std::vector<vk::DescriptorSetLayoutBinding> bindings;
+    for (const auto& desc : descriptors) {
+        bindings.push_back(vk::DescriptorSetLayoutBinding()
+            .setBinding(static_cast<uint32_t>(desc.binding))
+            .setDescriptorType(desc.type)
+            .setDescriptorCount(static_cast<uint32_t>(desc.descriptor_count))
+            .setStageFlags(vk::ShaderStageFlagBits::eCompute)
+        );
+    }
+
+	auto layout_res = m_device.createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo().setBindings(bindings));
+	if (layout_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create descriptor layout: {}", to_string(layout_res.result)));
+	}
+	m_descriptor_layout = layout_res.value;
+
+    return {};
+}
+
+std::expected<void, std::string> AffineIFS::create_pipeline() {
+    auto trace_scope = StartupTrace::instance().phase("pipeline:AffineIFS");
+
+    // The layout is shared by every stage chain
+    if (!m_pipeline_layout) {
+        // Push constant: DispatchChunk (particle range of one chunk)
+        auto push_constant_range = vk::PushConstantRange()
+            .setStageFlags(vk::ShaderStageFlagBits::eCompute)
+            .setOffset(0)
+            .setSize(sizeof(ComputeChunk));
+
+        auto pipeline_layout_info = vk::PipelineLayoutCreateInfo()
+            .setSetLayouts(m_descriptor_layout)
+            .setPushConstantRanges(push_constant_range);
+
+		auto pipeline_layout_res = m_device.createPipelineLayout(pipeline_layout_info);
+		if (pipeline_layout_res.result != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Failed to create pipeline layout: {}", to_string(pipeline_layout_res.result)));
+		}
+		m_pipeline_layout = pipeline_layout_res.value;
+    }
+
+    if (!std::holds_alternative<ComputeDetails>(m_compute_shader->get_details())) {
+        return std::unexpected("Shader is not a compute shader");
+    }
+
+    auto pipeline_info = vk::ComputePipelineCreateInfo()
+        .setStage(m_compute_shader->create_pipeline_shader_stage_create_info())
+        .setLayout(m_pipeline_layout);
+
+	auto pipeline_res = m_device.createComputePipeline(nullptr, pipeline_info);
+	if (pipeline_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create compute pipeline: {}", to_string(pipeline_res.result)));
+	}
+	m_compute_pipeline = pipeline_res.value;
+
+    return {};
+}
+
+std::expected<void, std::string> AffineIFS::upload_maps() {
+    const auto count = static_cast<uint32_t>(m_definition.maps.size());
+    const uint32_t tile_count = (count + tile_map_count - 1) / tile_map_count;
+    const uint32_t entries = count + tile_count + max_deep_zoom_words;
+    if (entries > m_map_capacity) {
+        if (m_map_buffer) {
+            m_device.destroyBuffer(m_map_buffer);
+            m_device.freeMemory(m_map_memory);
+            m_map_buffer = nullptr;
+            m_map_memory = nullptr;
+        }
+        const uint32_t capacity = std::bit_ceil(std::max(entries, 16u));
+        if (auto result = create_host_buffer(*m_context, m_device, capacity * sizeof(GPUAffineMap),
+                vk::BufferUsageFlagBits::eStorageBuffer, m_map_buffer, m_map_memory, m_map_mapped); !result) {
+            return std::unexpected(std::format("Map buffer: {}", result.error()));
+        }
+        m_map_capacity = capacity;
+
+        auto map_buffer_info = vk::DescriptorBufferInfo(m_map_buffer, 0, VK_WHOLE_SIZE);
+        auto write = vk::WriteDescriptorSet()
+            .setDstSet(m_descriptor_set)
+            .setDstBinding(2)
+            .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+            .setBufferInfo(map_buffer_info);
+        m_device.updateDescriptorSets(write, {});
+    }
+
+    auto* gpu_maps = static_cast<GPUAffineMap*>(m_map_mapped);
+    std::vector<float> weights(count);
+    for (uint32_t i = 0; i < count; i++) {
+        const auto& map = m_definition.maps[i];
+        weights[i] = std::max(map.weight, 0.0f);
+        for (int row = 0; row < 3; row++) {
+            gpu_maps[i].rows[row] = glm::vec4(map.linear[0][row], map.linear[1][row], map.linear[2][row], map.offset[row]);
+        }
+        gpu_maps[i].color = pack_color(map.color);
+    }
+
+    // Alias entries of a map are local to its tile; the tile draw picks tiles by total weight
+    std::vector<float> tile_weights(tile_count, 0.0f);
+    for (uint32_t tile = 0; tile < tile_count; tile++) {
+        const uint32_t first = tile * tile_map_count;
+        const auto tile_maps = std::span(weights).subspan(first, std::min(tile_map_count, count - first));
+        const auto table = build_alias_table(tile_maps);
+        for (uint32_t i = 0; i < table.size(); i++) {
+            gpu_maps[first + i].threshold = table[i].threshold;
+            gpu_maps[first + i].alias = table[i].alias;
+            tile_weights[tile] += tile_maps[i];
+        }
+    }
+    const auto tile_table = build_alias_table(tile_weights);
+    for (uint32_t tile = 0; tile < tile_count; tile++) {
+        gpu_maps[count + tile] = GPUAffineMap{.threshold = tile_table[tile].threshold, .alias = tile_table[tile].alias};
+    }
+    return {};
+}
+
+std::expected<void, std::string> AffineIFS::set_definition(AffineIFSDefinition definition) {
+    if (definition.maps.empty()) {
+        return std::unexpected("An affine IFS needs at least one map");
+    }
+    if (definition.maps.size() > max_map_count) {
+        return std::unexpected(std::format("An affine IFS has at most {} maps, got {}", max_map_count, definition.maps.size()));
+    }
+    // The shader may still be reading the maps
+    wait_compute_complete();
+    if (m_definition_changed) {
+        m_definition = std::move(definition);
+    } else {
+        // Keep what the stored orbits were computed with, for auto warm starts
+        m_computed_definition = std::exchange(m_definition, std::move(definition));
+        m_definition_changed = true;
+    }
+    return upload_maps();
+}
+
+std::expected<void, std::string> AffineIFS::set_stage_chain(StageChain chain) {
+    if (chain == m_stage_chain) {
+        return {};
+    }
+
+    auto shader_result = Shader::create_shader(
+        m_device, "ifs_modular/backends/affine_ifs", "main", chain.specialization());
+    if (!shader_result) {
+        return std::unexpected(std::format("Failed to compile stage chain '{}': {}", chain.describe(), shader_result.error()));
+    }
+
+    // The pipeline may still be executing
+    wait_compute_complete();
+    auto old_pipeline = std::exchange(m_compute_pipeline, nullptr);
+    auto old_shader = std::exchange(m_compute_shader, std::make_unique<Shader>(std::move(*shader_result)));
+    if (auto result = create_pipeline(); !result) {
+        m_compute_pipeline = old_pipeline;
+        m_compute_shader = std::move(old_shader);
+        return std::unexpected(result.error());
+    }
+    m_device.destroyPipeline(old_pipeline);
+
+    Logger::instance().info("AffineIFS stage chain: {}", chain.describe());
+    m_stage_chain = std::move(chain);
+    m_has_orbits = false;  // Stored positions went through the old post stages
+    return {};
+}
+
+void AffineIFS::cleanup() {
+    // Destroying the scheduler waits for pending compute work
+    m_scheduler.reset();
+    m_stage_uniforms.reset();
+
+    if (m_descriptor_pool) {
+        m_device.destroyDescriptorPool(m_descriptor_pool);
+        m_descriptor_pool = nullptr;
+    }
+    if (m_compute_pipeline) {
+        m_device.destroyPipeline(m_compute_pipeline);
+        m_compute_pipeline = nullptr;
+    }
+    if (m_pipeline_layout) {
+        m_device.destroyPipelineLayout(m_pipeline_layout);
+        m_pipeline_layout = nullptr;
+    }
+    if (m_descriptor_layout) {
+        m_device.destroyDescriptorSetLayout(m_descriptor_layout);
+        m_descriptor_layout = nullptr;
+    }
+    for (auto [buffer, memory] : {std::pair{&m_param_buffer, &m_param_memory}, std::pair{&m_map_buffer, &m_map_memory}}) {
+        if (*buffer) {
+            m_device.destroyBuffer(*buffer);
+            *buffer = nullptr;
+        }
+        if (*memory) {
+            m_device.freeMemory(*memory);  // Implicitly unmaps
+            *memory = nullptr;
+        }
+    }
+}
+
+void AffineIFS::dispatch(
+    vk::CommandBuffer cmd,
+    vk::Buffer particle_buffer,
+    uint32_t particle_count,
+    const IFSParameters& params
+) {
+    update_params(particle_buffer, particle_count, params);
+    record_chunk(cmd, {.first = 0, .count = particle_count});
+}
+
+void AffineIFS::update_params(
+    vk::Buffer particle_buffer,
+    uint32_t particle_count,
+    const IFSParameters& params
+) {
+    const bool has_orbits = m_has_orbits && particle_buffer == m_particle_buffer->buffer();
+    uint32_t warm_iterations = m_warm_iterations;
+    bool warm = warm_iterations > 0;
+    if (!warm && m_auto_warm_start && params.random_seed == m_computed_seed) {
+        auto planned = m_definition_changed
+            ? warm_start_iterations(m_computed_definition, m_definition, m_warm_tolerance)
+            : std::optional<uint32_t>(0);
+        warm = planned && *planned < m_iteration_count;
+        warm_iterations = planned.value_or(0);
+    }
+
+    // Deep-zoom positions are in a frame that changes between computes
+    const bool deep = m_deep_zoom.has_value();
+    m_deep_zoom_words = deep ? upload_deep_zoom_words(params.scale) : 0;
+    m_last_warm = warm && has_orbits && !deep && !m_last_deep;
+    m_last_deep = deep;
+    m_last_iterations = m_last_warm ? warm_iterations : m_iteration_count;
+    m_generation = m_last_warm ? m_generation + 1 : 0;
+
+    AffineShaderParams shader_params{
+        .iteration_count = m_last_iterations,
+        .particle_count = particle_count,
+        .random_seed = params.random_seed,
+        .map_count = static_cast<uint32_t>(m_definition.maps.size()),
+        .warm_start = m_last_warm ? 1u : 0u,
+        .generation = m_generation,
+        .word_count = m_deep_zoom_words,
+        .padding = 0
+    };
+    std::memcpy(m_param_mapped, &shader_params, sizeof(AffineShaderParams));
+    m_stage_uniforms->upload(make_stage_params(m_stage_settings, params.scale));
+
+    m_warm_iterations = 0;
+    m_has_orbits = particle_buffer == m_particle_buffer->buffer();
+    m_definition_changed = false;
+    m_computed_seed = params.random_seed;
+
+    auto particle_buffer_info = vk::DescriptorBufferInfo(particle_buffer, 0, VK_WHOLE_SIZE);
+    auto write = vk::WriteDescriptorSet()
+        .setDstSet(m_descriptor_set)
+        .setDstBinding(0)
+        .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+        .setBufferInfo(particle_buffer_info);
+    m_device.updateDescriptorSets(write, {});
+}
+
+uint32_t AffineIFS::upload_deep_zoom_words(float scale) {
+    // Fold the affine post stages; nonlinear ones have no exact double-precision composition
+    DeepZoomWord post;
+    for (auto stage : m_stage_chain.post) {
+        glm::dmat3 linear(1.0);
+        glm::dvec3 offset(0.0);
+        if (stage == PostStage::GlobalScale) {
+            const double s = scale != 0.0f ? scale : 1.0f;
+            linear = glm::dmat3(s);
+            offset = glm::dvec3(0.5 - 0.5 * s);
+        } else if (stage == PostStage::FinalAffine) {
+            linear = glm::dmat3(m_stage_settings.final_linear);
+            offset = glm::dvec3(m_stage_settings.final_offset);
+        }
+        post = {.linear = linear * post.linear, .offset = linear * post.offset + offset};
+    }
+
+    const auto& view = *m_deep_zoom;
+    auto words = deep_zoom_words(m_definition, post, view, max_deep_zoom_words);
+    if (!words) {
+        Logger::instance().warn("Deep zoom: {}", words.error());
+    }
+    if (!words || words->empty()) {
+        // Nothing reaches the view: draw the whole attractor, which then lies outside it
+        words = std::vector<DeepZoomWord>{post};
+    }
+
+    // Products of map probabilities underflow float within ~80 levels; normalize in double first
+    double max_probability = 0.0;
+    for (const auto& word : *words) {
+        max_probability = std::max(max_probability, word.probability);
+    }
+    std::vector<float> weights;
+    for (const auto& word : *words) {
+        weights.push_back(max_probability > 0.0 ? static_cast<float>(word.probability / max_probability) : 0.0f);
+    }
+    const auto table = build_alias_table(weights);
+
+    const uint32_t count = static_cast<uint32_t>(m_definition.maps.size());
+    const uint32_t base = count + (count + tile_map_count - 1) / tile_map_count;
+    auto* gpu_words = static_cast<GPUAffineMap*>(m_map_mapped) + base;
+    for (size_t i = 0; i < words->size(); i++) {
+        // Local frame in double, then float: exact relative to the view
+        const glm::dmat3 linear = (*words)[i].linear / view.extent;
+        const glm::dvec3 offset = ((*words)[i].offset - view.anchor) / view.extent;
+        for (int row = 0; row < 3; row++) {
+            gpu_words[i].rows[row] = glm::vec4(linear[0][row], linear[1][row], linear[2][row], offset[row]);
+        }
+        gpu_words[i].threshold = table[i].threshold;
+        gpu_words[i].alias = table[i].alias;
+    }
+    return static_cast<uint32_t>(words->size());
+}
+
+void AffineIFS::record_chunk(vk::CommandBuffer cmd, const ComputeChunk& chunk) const {
+    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, m_compute_pipeline);
+    cmd.bindDescriptorSets(
+        vk::PipelineBindPoint::eCompute,
+        m_pipeline_layout,
+        0,
+        m_descriptor_set,
+        {}
+    );
+    cmd.pushConstants<ComputeChunk>(m_pipeline_layout, vk::ShaderStageFlagBits::eCompute, 0, chunk);
+
+    // Calculate dispatch size (256 threads per workgroup)
+    uint32_t workgroup_count = (chunk.count + 255) / 256;
+    cmd.dispatch(workgroup_count, 1, 1);
+}
+
+void AffineIFS::compute(
+    vk::Buffer particle_buffer,
+    uint32_t particle_count,
+    const IFSParameters& params
+) {
+    // Backend owns its own particle buffer
+    (void)particle_buffer;
+    (void)particle_count;
+
+    // Wait for previous compute to finish (if any) before touching the shared parameters
+    wait_compute_complete();
+    // Decided before update_params() consumes the warm-start state; the caller returned the buffer on the same condition
+    const auto& queues = m_context->queue_indices();
+    const bool acquire = queues.has_dedicated_compute() && reads_particle_buffer();
+    update_params(m_particle_buffer->buffer(), m_particle_count, params);
+
+    auto record = [this](vk::CommandBuffer cmd, const ComputeChunk& chunk) {
+        record_chunk(cmd, chunk);
+    };
+
+    // Warm starts read the previous orbits, which the graphics queue owned while rendering
+    ComputeScheduler::PrepareFn prepare;
+    if (acquire) {
+        prepare = [this, &queues](vk::CommandBuffer cmd) {
+            acquire_returned_buffer(cmd, m_particle_buffer->buffer(), queues.graphics, queues.compute);
+        };
+    }
+
+    // Issue ownership release barrier if different queue families or shared
+    // (recorded on queue 0 once every chunk has finished)
+    auto finalize = [this](vk::CommandBuffer cmd) {
+        release_particle_buffer(cmd, *m_particle_buffer, m_context->queue_indices());
+    };
+
+    m_scheduler->submit(m_particle_count, record, finalize, prepare);
+}
+
+void AffineIFS::wait_compute_complete() {
+    if (m_scheduler) {
+        m_scheduler->wait();
+    }
+}
+
+std::vector<UICallback> AffineIFS::get_ui_callbacks() {
+    static constexpr std::size_t MAX_PARTICLES = (3.5 * 1024 * 1024 * 1024) / sizeof(Particle);
+    static constexpr int MAX_ITER = 500;
+
+    std::vector<UICallback> callbacks;
+
+    callbacks.emplace_back("Particle Count", DiscreteCallback{
+        .setter = [this](int v) {
+            uint32_t new_count = std::clamp<uint32_t>(static_cast<uint32_t>(v), 10000, MAX_PARTICLES);
+            if (new_count != m_particle_count) {
+                reallocate_particle_buffer(new_count);
+            }
+        },
+        .getter = [this]() { return static_cast<int>(m_particle_count); },
+        .min = 10000,
+        .max = MAX_PARTICLES
+    });
+    callbacks.emplace_back("Iteration Count", DiscreteCallback{
+        .setter = [this](int v) { m_iteration_count = static_cast<uint32_t>(std::clamp(v, 1, MAX_ITER)); },
+        .getter = [this]() { return static_cast<int>(m_iteration_count); },
+        .min = 1,
+        .max = MAX_ITER
+    });
+
+    // Preset index; -1 while the definition matches none (e.g. mid-animation)
+    auto names = AffineIFSDefinition::preset_names();
+    callbacks.emplace_back("Preset", DiscreteCallback{
+        .setter = [this, names](int v) {
+            if (v >= 0 && v < static_cast<int>(names.size())) {
+                if (auto result = set_definition(*AffineIFSDefinition::preset(names[v])); !result) {
+                    Logger::instance().error("Failed to load preset: {}", result.error());
+                }
+            }
+        },
+        .getter = [this, names]() {
+            for (size_t i = 0; i < names.size(); i++) {
+                if (AffineIFSDefinition::preset(names[i]) == m_definition) {
+                    return static_cast<int>(i);
+                }
+            }
+            return -1;
+        },
+        .min = 0,
+        .max = static_cast<int>(names.size()) - 1
+    });
+
+    // Map editor; with auto warm start, dragging re-iterates only as far as the maps moved
+    const auto map_count = static_cast<int>(m_definition.maps.size());
+    m_edit_map = std::min(m_edit_map, static_cast<uint32_t>(map_count - 1));
+    callbacks.emplace_back("Edit Map", DiscreteCallback{
+        .setter = [this](int v) { m_edit_map = static_cast<uint32_t>(std::clamp(v, 0, static_cast<int>(m_definition.maps.size()) - 1)); },
+        .getter = [this]() { return static_cast<int>(m_edit_map); },
+        .min = 0,
+        .max = map_count - 1
+    });
+    auto edit_map = [this](auto&& change) {
+        AffineIFSDefinition definition = m_definition;
+        change(definition.maps[m_edit_map]);
+        if (auto result = set_definition(std::move(definition)); !result) {
+            Logger::instance().error("{}", result.error());
+        }
+    };
+    for (int axis = 0; axis < 3; axis++) {
+        callbacks.emplace_back(std::format("Map Offset {}", "XYZ"[axis]), ContinuousCallback{
+            .setter = [this, axis, edit_map](float v) { edit_map([axis, v](AffineMap& map) { map.offset[axis] = v; }); },
+            .getter = [this, axis]() { return m_definition.maps[m_edit_map].offset[axis]; },
+            .min = -1.0f,
+            .max = 2.0f
+        });
+    }
+    callbacks.emplace_back("Map Weight", ContinuousCallback{
+        .setter = [edit_map](float v) { edit_map([v](AffineMap& map) { map.weight = v; }); },
+        .getter = [this]() { return m_definition.maps[m_edit_map].weight; },
+        .min = 0.001f,
+        .max = 100.0f,
+        .logarithmic = true
+    });
+    callbacks.emplace_back("Auto Warm Start", ToggleCallback{
+        .setter = [this](bool enabled) { m_auto_warm_start = enabled; },
+        .getter = [this]() { return m_auto_warm_start; }
+    });
+    callbacks.emplace_back("Warm Tolerance", ContinuousCallback{
+        .setter = [this](float v) { m_warm_tolerance = v; },
+        .getter = [this]() { return m_warm_tolerance; },
+        .min = 1e-5f,
+        .max = 1e-1f,
+        .logarithmic = true
+    });
+
+    // Stage chain: optional final transforms before the global scale
+    auto apply_chain = [this](StageChain chain) {
+        if (auto result = set_stage_chain(std::move(chain)); !result) {
+            Logger::instance().error("{}", result.error());
+        }
+    };
+    for (auto stage : {PostStage::Spherical, PostStage::Swirl}) {
+        callbacks.emplace_back(std::format("Final {}", to_string(stage)), ToggleCallback{
+            .setter = [this, stage, apply_chain](bool enabled) {
+                StageChain chain = m_stage_chain;
+                std::erase(chain.post, stage);
+                if (enabled) {
+                    // Final transforms keep the order of PostStage, all before GlobalScale
+                    auto it = std::ranges::find_if(chain.post, [stage](PostStage other) {
+                        return other == PostStage::GlobalScale || other > stage;
+                    });
+                    chain.post.insert(it, stage);
+                }
+                apply_chain(std::move(chain));
+            },
+            .getter = [this, stage]() { return std::ranges::contains(m_stage_chain.post, stage); }
+        });
+    }
+    callbacks.emplace_back("Swirl Strength", ContinuousCallback{
+        .setter = [this](float v) { m_stage_settings.swirl = v; },
+        .getter = [this]() { return m_stage_settings.swirl; },
+        .min = -20.0f,
+        .max = 20.0f
+    });
+    callbacks.emplace_back("Color Stage", DiscreteCallback{
+        .setter = [this, apply_chain](int v) {
+            StageChain chain = m_stage_chain;
+            chain.color = static_cast<ColorStage>(std::clamp(v, 0, 3));
+            apply_chain(std::move(chain));
+        },
+        .getter = [this]() { return static_cast<int>(m_stage_chain.color); },
+        .min = 0,
+        .max = 3
+    });
+    // Writes half of each particle; renderers color it by transform history
+    callbacks.emplace_back("Compact Colors", ToggleCallback{
+        .setter = [this, apply_chain](bool enabled) {
+            StageChain chain = m_stage_chain;
+            chain.write = enabled ? WriteStage::Indexed : WriteStage::Particle;
+            apply_chain(std::move(chain));
+        },
+        .getter = [this]() { return m_stage_chain.write == WriteStage::Indexed; }
+    });
+
+    return callbacks;
+}
+
+void AffineIFS::reallocate_particle_buffer(uint32_t new_count) {
+    Logger::instance().info("Reallocating particle buffer: {} -> {} particles", m_particle_count, new_count);
+
+    wait_compute_complete();
+    auto _ = m_device.waitIdle();
+
+    m_particle_count = new_count;
+    m_has_orbits = false;
+
+    ParticleBufferConfig buffer_config{
+        .particle_count = m_particle_count,
+        .support_dynamic_resize = false
+    };
+
+    auto particle_buffer_result = ParticleBuffer::create(*m_context, m_device, buffer_config);
+    if (!particle_buffer_result) {
+        Logger::instance().error("Failed to reallocate particle buffer: {}", particle_buffer_result.error());
+        return;
+    }
+    m_particle_buffer = std::make_unique<ParticleBuffer>(std::move(particle_buffer_result.value()));
+
+    Logger::instance().info("Particle buffer reallocated successfully");
+}
+
+} // namespace ifs
@@ -0,0 +1,917 @@
+#include <ifs/backends/FlameIFS.hpp>
+#include <ifs/backends/AffineIFS.hpp>
+#include <ifs/Logger.hpp>
+#include <ifs/StartupTrace.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <numbers>
+#include <utility>
+
+namespace ifs {
+
+namespace {
+
+constexpr uint32_t GROUP_SIZE = 256;
+constexpr uint32_t MAX_GROUPS_X = 65535;
+constexpr uint32_t BINDING_COUNT = 4;          ///< Reflected from the iterate kernel
+constexpr uint32_t STATISTICS_BINDING = 4;     ///< Density statistics, read by the resolve kernel only
+constexpr float MAX_LOG_DENSITY = 32.0f;       ///< log2(1 + hits) of a full 32-bit cell
+
+constexpr auto ITERATE_SHADER = "ifs_modular/backends/flame/iterate.slang";
+constexpr auto RESOLVE_SHADER = "ifs_modular/backends/flame/resolve.slang";
+
+// Parameter structure matching FlameParams in variations.slang
+struct alignas(16) FlameShaderParams {
+    uint32_t iteration_count;
+    uint32_t fuse_count;
+    uint32_t particle_count;
+    uint32_t random_seed;
+    uint32_t transform_count;
+    uint32_t has_final;
+    uint32_t grid_size;
+    uint32_t auto_exposure;
+    float scale;
+    float brightness;
+    float gamma;
+    float density_scale;
+    glm::vec4 palette[4];
+};
+
+// Transform layout matching FlameXform in variations.slang
+struct GPUFlameTransform {
+    glm::vec4 affine_x;    ///< a, b, c
+    glm::vec4 affine_y;    ///< d, e, f
+    glm::vec4 weights[4];  ///< Variation weights
+    float color;
+    float color_speed;
+    float threshold;       ///< Alias table slot (AliasEntry)
+    uint32_t alias;
+};
+static_assert(sizeof(GPUFlameTransform) == 112, "GPUFlameTransform must match variations.slang");
+
+constexpr std::array VARIATION_NAMES = {
+    std::string_view("Linear"),
+    std::string_view("Sinusoidal"),
+    std::string_view("Spherical"),
+    std::string_view("Swirl"),
+    std::string_view("Horseshoe"),
+    std::string_view("Polar"),
+    std::string_view("Handkerchief"),
+    std::string_view("Heart"),
+    std::string_view("Disc"),
+    std::string_view("Spiral"),
+    std::string_view("Hyperbolic"),
+    std::string_view("Diamond"),
+    std::string_view("Julia"),
+    std::string_view("Bubble"),
+    std::string_view("Fisheye"),
+    std::string_view("Exponential"),
+};
+static_assert(VARIATION_NAMES.size() == variation_count);
+
+constexpr std::array PRESET_NAMES = {
+    std::string_view("sierpinski"),
+    std::string_view("spherical_lace"),
+    std::string_view("julia_swirl"),
+    std::string_view("sinusoidal_heart"),
+};
+
+/**
+ * @brief Allocate a buffer, persistently mapped if `mapped` is given
+ */
+std::expected<void, std::string> create_buffer(
+    const VulkanContext& context,
+    vk::Device device,
+    vk::DeviceSize size,
+    vk::BufferUsageFlags usage,
+    vk::MemoryPropertyFlags flags,
+    vk::Buffer& buffer,
+    vk::DeviceMemory& memory,
+    void** mapped
+) {
+    auto buffer_info = vk::BufferCreateInfo()
+        .setSize(size)
+        .setUsage(usage)
+        .setSharingMode(vk::SharingMode::eExclusive);
+
+	auto buffer_res = device.createBuffer(buffer_info);
+	if (buffer_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Could not create buffer {}", to_string(buffer_res.result)));
+	}
+	buffer = buffer_res.value;
+
+    auto mem_reqs = device.getBufferMemoryRequirements(buffer);
+    auto memory_type = context.find_memory_type(mem_reqs.memoryTypeBits, flags);
+    if (!memory_type) {
+        return std::unexpected(std::format("Failed to find memory with flags {}", to_string(flags)));
+    }
+
+	auto alloc_res = device.allocateMemory(vk::MemoryAllocateInfo(mem_reqs.size, *memory_type));
+	if (alloc_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Could not allocate device memory {}", to_string(alloc_res.result)));
+	}
+	memory = alloc_res.value;
+
+	auto bind_res = device.bindBufferMemory(buffer, memory, 0);
+	if (bind_res != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Could not bind memory to buffer {}", to_string(bind_res)));
+	}
+
+    if (mapped) {
+		auto map_res = device.mapMemory(memory, 0, VK_WHOLE_SIZE);
+		if (map_res.result != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Could not map memory {}", to_string(map_res.result)));
+		}
+		*mapped = map_res.value;
+    }
+    return {};
+}
+
+/**
+ * @brief Fold variations into Add<A, Add<B, NoVariations>>
+ */
+std::string variation_set(std::span<const Variation> variations) {
+    std::string set = "NoVariations";
+    for (size_t i = variations.size(); i-- > 0;) {
+        set = std::format("Add<{}, {}>", to_string(variations[i]), set);
+    }
+    return set;
+}
+
+/**
+ * @brief Rotation by `angle` scaled by `scale`, then a shift
+ */
+FlameTransform rotation(float angle, float scale, glm::vec2 shift, float color) {
+    const float s = scale * std::sin(angle);
+    const float c = scale * std::cos(angle);
+    return {.a = c, .b = -s, .c = shift.x, .d = s, .e = c, .f = shift.y, .color = color};
+}
+
+GPUFlameTransform pack_transform(const FlameTransform& transform) {
+    GPUFlameTransform gpu{};
+    gpu.affine_x = glm::vec4(transform.a, transform.b, transform.c, 0.0f);
+    gpu.affine_y = glm::vec4(transform.d, transform.e, transform.f, 0.0f);
+    for (uint32_t v = 0; v < variation_count; v++) {
+        gpu.weights[v / 4][v % 4] = transform.variations[v];
+    }
+    gpu.color = std::clamp(transform.color, 0.0f, 1.0f);
+    gpu.color_speed = std::clamp(transform.color_speed, 0.0f, 1.0f);
+    return gpu;
+}
+
+} // anonymous namespace
+
+std::string_view to_string(Variation variation) {
+    const auto index = static_cast<uint32_t>(variation);
+    return index < VARIATION_NAMES.size() ? VARIATION_NAMES[index] : "Linear";
+}
+
+// ============================================================================
+// Definitions
+// ============================================================================
+
+std::vector<Variation> FlameDefinition::used_variations(bool final) const {
+    std::vector<Variation> used;
+    for (uint32_t v = 0; v < variation_count; v++) {
+        const bool in_use = final
+            ? final_transform && final_transform->variations[v] != 0.0f
+            : std::ranges::any_of(transforms, [v](const FlameTransform& t) { return t.variations[v] != 0.0f; });
+        if (in_use) {
+            used.push_back(static_cast<Variation>(v));
+        }
+    }
+    return used;
+}
+
+std::vector<std::string> FlameDefinition::kernel_specialization() const {
+    return {variation_set(used_variations(false)), variation_set(used_variations(true))};
+}
+
+FlameDefinition FlameDefinition::sierpinski() {
+    // Linear only: the triangle with corners (-1, -1), (1, -1), (0, 1)
+    return {.transforms = {
+        {.a = 0.5f, .c = -0.5f, .e = 0.5f, .f = -0.5f, .color = 0.0f},
+        {.a = 0.5f, .c = 0.5f, .e = 0.5f, .f = -0.5f, .color = 0.5f},
+        {.a = 0.5f, .c = 0.0f, .e = 0.5f, .f = 0.5f, .color = 1.0f},
+    }};
+}
+
+FlameDefinition FlameDefinition::spherical_lace() {
+    FlameDefinition lace{.palette = {
+        glm::vec3(0.5f), glm::vec3(0.5f), glm::vec3(1.0f), glm::vec3(0.8f, 0.9f, 0.3f)
+    }};
+    for (int k = 0; k < 3; k++) {
+        const float angle = 2.0f * std::numbers::pi_v<float> * k / 3.0f;
+        auto transform = rotation(angle, 0.6f, 0.5f * glm::vec2(std::cos(angle), std::sin(angle)), k / 2.0f);
+        transform.variation(Variation::Linear) = 0.3f;
+        transform.variation(Variation::Spherical) = 0.7f;
+        lace.transforms.push_back(transform);
+    }
+    return lace;
+}
+
+FlameDefinition FlameDefinition::julia_swirl() {
+    auto julia = rotation(0.3f, 0.9f, {0.25f, 0.1f}, 0.1f);
+    julia.variation(Variation::Linear) = 0.0f;
+    julia.variation(Variation::Julia) = 1.0f;
+
+    auto swirl = rotation(std::numbers::pi_v<float> / 4.0f, 0.5f, {-0.3f, 0.0f}, 0.9f);
+    swirl.variation(Variation::Linear) = 0.5f;
+    swirl.variation(Variation::Swirl) = 0.5f;
+    swirl.weight = 0.5f;
+
+    return {.transforms = {julia, swirl}};
+}
+
+FlameDefinition FlameDefinition::sinusoidal_heart() {
+    FlameDefinition heart{.palette = {
+        glm::vec3(0.5f), glm::vec3(0.5f), glm::vec3(1.0f, 1.0f, 0.5f), glm::vec3(0.8f, 0.9f, 0.3f)
+    }};
+    for (int k = 0; k < 3; k++) {
+        const float angle = 2.0f * std::numbers::pi_v<float> * k / 3.0f + 0.2f;
+        auto transform = rotation(angle, 1.2f, 0.4f * glm::vec2(std::sin(angle), std::cos(angle)), k / 2.0f);
+        transform.variation(Variation::Linear) = 0.0f;
+        transform.variation(Variation::Sinusoidal) = 1.0f;
+        heart.transforms.push_back(transform);
+    }
+    FlameTransform final_transform{.color = 0.5f, .color_speed = 0.0f};
+    final_transform.variation(Variation::Linear) = 0.7f;
+    final_transform.variation(Variation::Heart) = 0.3f;
+    heart.final_transform = final_transform;
+    return heart;
+}
+
+std::span<const std::string_view> FlameDefinition::preset_names() {
+    return PRESET_NAMES;
+}
+
+std::optional<FlameDefinition> FlameDefinition::preset(std::string_view name) {
+    if (name == "sierpinski") return sierpinski();
+    if (name == "spherical_lace") return spherical_lace();
+    if (name == "julia_swirl") return julia_swirl();
+    if (name == "sinusoidal_heart") return sinusoidal_heart();
+    return std::nullopt;
+}
+
+// ============================================================================
+// FlameIFS
+// ============================================================================
+
+FlameIFS::FlameIFS(
+    const VulkanContext& context,
+    vk::Device device,
+    FlameDefinition definition
+)
+    : m_context(&context)
+    , m_device(device)
+    , m_particle_buffer(nullptr)
+    , m_particle_count(1000000)  // Default particle count
+    , m_definition(std::move(definition))
+    , m_transform_buffer(nullptr)
+    , m_transform_memory(nullptr)
+    , m_grid_buffer(nullptr)
+    , m_grid_memory(nullptr)
+    , m_descriptor_layout(nullptr)
+    , m_pipeline_layout(nullptr)
+    , m_iterate_pipeline(nullptr)
+    , m_resolve_pipeline(nullptr)
+    , m_descriptor_pool(nullptr)
+    , m_descriptor_set(nullptr)
+    , m_param_buffer(nullptr)
+    , m_param_memory(nullptr)
+    , m_scheduler(nullptr)
+{}
+
+std::expected<std::unique_ptr<FlameIFS>, std::string> FlameIFS::create(
+    const VulkanContext& context,
+    vk::Device device,
+    FlameDefinition definition
+) {
+    if (definition.transforms.empty()) {
+        return std::unexpected("A flame needs at least one transform");
+    }
+    if (definition.transforms.size() > max_transform_count) {
+        return std::unexpected(std::format("A flame has at most {} transforms, got {}", max_transform_count, definition.transforms.size()));
+    }
+
+    auto backend = std::unique_ptr<FlameIFS>(new FlameIFS(context, device, std::move(definition)));
+    if (auto result = backend->initialize(); !result) {
+        return std::unexpected(result.error());
+    }
+
+    Logger::instance().info("Created FlameIFS backend ({} transforms)", backend->m_definition.transforms.size());
+    return backend;
+}
+
+FlameIFS::~FlameIFS() {
+    cleanup();
+}
+
+std::expected<void, std::string> FlameIFS::initialize() {
+    // The iterate kernel binds everything, so its reflection defines the shared layout
+    const auto specialization = m_definition.kernel_specialization();
+    auto iterate_shader = Shader::create_shader(m_device, ITERATE_SHADER, "main", specialization);
+    if (!iterate_shader) {
+        return std::unexpected(std::format("Failed to load {}: {}", ITERATE_SHADER, iterate_shader.error()));
+    }
+    if (auto result = create_descriptor_layout(*iterate_shader); !result) {
+        return std::unexpected(result.error());
+    }
+    auto iterate = create_pipeline(*iterate_shader, "iterate");
+    if (!iterate) {
+        return std::unexpected(iterate.error());
+    }
+    m_iterate_pipeline = *iterate;
+    m_pipelines.emplace(specialization[0] + " | " + specialization[1], m_iterate_pipeline);
+
+    auto resolve_shader = Shader::create_shader(m_device, RESOLVE_SHADER, "main");
+    if (!resolve_shader) {
+        return std::unexpected(std::format("Failed to load {}: {}", RESOLVE_SHADER, resolve_shader.error()));
+    }
+    auto resolve = create_pipeline(*resolve_shader, "resolve");
+    if (!resolve) {
+        return std::unexpected(resolve.error());
+    }
+    m_resolve_pipeline = *resolve;
+
+    const auto host_flags = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+    if (auto result = create_buffer(*m_context, m_device, sizeof(FlameShaderParams),
+            vk::BufferUsageFlagBits::eUniformBuffer, host_flags, m_param_buffer, m_param_memory, &m_param_mapped); !result) {
+        return std::unexpected(std::format("Parameter buffer: {}", result.error()));
+    }
+    // Room for every transform plus the final one, so redefinitions never reallocate
+    if (auto result = create_buffer(*m_context, m_device, (max_transform_count + 1) * sizeof(GPUFlameTransform),
+            vk::BufferUsageFlagBits::eStorageBuffer, host_flags, m_transform_buffer, m_transform_memory, &m_transform_mapped); !result) {
+        return std::unexpected(std::format("Transform buffer: {}", result.error()));
+    }
+    if (auto result = create_buffer(*m_context, m_device, vk::DeviceSize(grid_size) * grid_size * sizeof(glm::uvec2),
+            vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst,
+            vk::MemoryPropertyFlagBits::eDeviceLocal, m_grid_buffer, m_grid_memory, nullptr); !result) {
+        return std::unexpected(std::format("Density grid: {}", result.error()));
+    }
+
+    // Auto-exposure is unavailable without subgroup arithmetic; the fixed tone mapping still works
+    if (auto statistics = GpuStatistics::create(*m_context); statistics) {
+        m_statistics = std::move(*statistics);
+    } else {
+        Logger::instance().warn("FlameIFS auto-exposure unavailable: {}", statistics.error());
+    }
+
+    // Particles, transforms and grid, plus the density statistics
+    std::vector<vk::DescriptorPoolSize> pool_sizes = {
+        vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, BINDING_COUNT),
+        vk::DescriptorPoolSize(vk::DescriptorType::eUniformBuffer, 1)
+    };
+
+    auto pool_info = vk::DescriptorPoolCreateInfo()
+        .setMaxSets(1)
+        .setPoolSizes(pool_sizes);
+
+    auto descriptor_pool_res = m_device.createDescriptorPool(pool_info);
+	if (descriptor_pool_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Could not create descriptor pool {}", to_string(descriptor_pool_res.result)));
+	}
+	m_descriptor_pool = descriptor_pool_res.value;
+
+    auto alloc_info_desc = vk::DescriptorSetAllocateInfo()
+        .setDescriptorPool(m_descriptor_pool)
+        .setSetLayouts(m_descriptor_layout);
+
+    auto descriptor_set_res = m_device.allocateDescriptorSets(alloc_info_desc);
+	if (descriptor_set_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to allocate descriptor set {}", to_string(descriptor_set_res.result)));
+	}
+	m_descriptor_set = descriptor_set_res.value[0];
+
+    // Particles (0) are bound by update_params()
+    auto param_buffer_info = vk::DescriptorBufferInfo(m_param_buffer, 0, sizeof(FlameShaderParams));
+    auto transform_buffer_info = vk::DescriptorBufferInfo(m_transform_buffer, 0, VK_WHOLE_SIZE);
+    auto grid_buffer_info = vk::DescriptorBufferInfo(m_grid_buffer, 0, VK_WHOLE_SIZE);
+    // Without statistics the resolve never reads binding 4, but it must still be valid
+    auto statistics_info = m_statistics
+        ? vk::DescriptorBufferInfo(m_statistics->result_buffer(0), 0, VK_WHOLE_SIZE)
+        : grid_buffer_info;
+    std::array writes = {
+        vk::WriteDescriptorSet()
+            .setDstSet(m_descriptor_set)
+            .setDstBinding(1)
+            .setDescriptorType(vk::DescriptorType::eUniformBuffer)
+            .setBufferInfo(param_buffer_info),
+        vk::WriteDescriptorSet()
+            .setDstSet(m_descriptor_set)
+            .setDstBinding(2)
+            .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+            .setBufferInfo(transform_buffer_info),
+        vk::WriteDescriptorSet()
+            .setDstSet(m_descriptor_set)
+            .setDstBinding(3)
+            .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+            .setBufferInfo(grid_buffer_info),
+        vk::WriteDescriptorSet()
+            .setDstSet(m_descriptor_set)
+            .setDstBinding(STATISTICS_BINDING)
+            .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+            .setBufferInfo(statistics_info)
+    };
+    m_device.updateDescriptorSets(writes, {});
+
+    upload_transforms();
+
+    // Compute submission (one lane per compute queue)
+    auto scheduler_result = ComputeScheduler::create(*m_context);
+    if (!scheduler_result) {
+        return std::unexpected(std::format("Failed to create compute scheduler: {}", scheduler_result.error()));
+    }
+    m_scheduler = std::move(*scheduler_result);
+    m_scheduler->set_granularity(GROUP_SIZE);  // numthreads(256) in the shaders
+
+    // Every compute leaves the grid cleared for the next one; start out that way
+    m_scheduler->submit(0, {}, [this](vk::CommandBuffer cmd) {
+        cmd.fillBuffer(m_grid_buffer, 0, VK_WHOLE_SIZE, 0u);
+    });
+    m_scheduler->wait();
+
+    ParticleBufferConfig buffer_config{
+        .particle_count = m_particle_count,
+        .support_dynamic_resize = false
+    };
+
+    auto particle_buffer_result = ParticleBuffer::create(*m_context, m_device, buffer_config);
+    if (!particle_buffer_result) {
+        return std::unexpected(std::format("Failed to create particle buffer: {}", particle_buffer_result.error()));
+    }
+    m_particle_buffer = std::make_unique<ParticleBuffer>(std::move(particle_buffer_result.value()));
+
+    return {};
+}
+
+std::expected<void, std::string> FlameIFS::create_descriptor_layout(const Shader& shader) {
+    // Get descriptor info from shader reflection
+    auto& descriptors = shader.get_descriptor_infos();
+
+    std::vector<vk::DescriptorSetLayoutBinding> bindings;
+    for (const auto& desc : descriptors) {
+        bindings.push_back(vk::DescriptorSetLayoutBinding()
+            .setBinding(static_cast<uint32_t>(desc.binding))
+            .setDescriptorType(desc.type)
+            .setDescriptorCount(static_cast<uint32_t>(desc.descriptor_count))
+            .setStageFlags(vk::ShaderStageFlagBits::eCompute)
+        );
+    }
+    if (bindings.size() != BINDING_COUNT) {
+        return std::unexpected(std::format("{} has {} bindings, expected {}", ITERATE_SHADER, bindings.size(), BINDING_COUNT));
+    }
+    bindings.push_back(vk::DescriptorSetLayoutBinding()
+        .setBinding(STATISTICS_BINDING)
+        .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+        .setDescriptorCount(1)
+        .setStageFlags(vk::ShaderStageFlagBits::eCompute)
+    );
+
+	auto layout_res = m_device.createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo().setBindings(bindings));
+	if (layout_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create descriptor layout: {}", to_string(layout_res.result)));
+	}
+	m_descriptor_layout = layout_res.value;
+
+    // Push constant: DispatchChunk (particle range of one chunk)
+    auto push_constant_range = vk::PushConstantRange()
+        .setStageFlags(vk::ShaderStageFlagBits::eCompute)
+        .setOffset(0)
+        .setSize(sizeof(ComputeChunk));
+
+    auto pipeline_layout_info = vk::PipelineLayoutCreateInfo()
+        .setSetLayouts(m_descriptor_layout)
+        .setPushConstantRanges(push_constant_range);
+
+	auto pipeline_layout_res = m_device.createPipelineLayout(pipeline_layout_info);
+	if (pipeline_layout_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create pipeline layout: {}", to_string(pipeline_layout_res.result)));
+	}
+	m_pipeline_layout = pipeline_layout_res.value;
+
+    return {};
+}
+
+std::expected<vk::Pipeline, std::string> FlameIFS::create_pipeline(const Shader& shader, std::string_view label) {
+    auto trace_scope = StartupTrace::instance().phase(std::format("pipeline:FlameIFS:{}", label));
+
+    if (!std::holds_alternative<ComputeDetails>(shader.get_details())) {
+        return std::unexpected(std::format("Flame {} shader is not a compute shader", label));
+    }
+
+    auto pipeline_info = vk::ComputePipelineCreateInfo()
+        .setStage(shader.create_pipeline_shader_stage_create_info())
+        .setLayout(m_pipeline_layout);
+
+	auto pipeline_res = m_device.createComputePipeline(nullptr, pipeline_info);
+	if (pipeline_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create flame {} pipeline: {}", label, to_string(pipeline_res.result)));
+	}
+    return pipeline_res.value;
+}
+
+std::expected<vk::Pipeline, std::string> FlameIFS::iterate_pipeline(const FlameDefinition& definition) {
+    const auto specialization = definition.kernel_specialization();
+    const auto key = specialization[0] + " | " + specialization[1];
+    if (auto it = m_pipelines.find(key); it != m_pipelines.end()) {
+        return it->second;
+    }
+
+    auto shader = Shader::create_shader(m_device, ITERATE_SHADER, "main", specialization);
+    if (!shader) {
+        return std::unexpected(std::format("Failed to compile flame kernel '{}': {}", key, shader.error()));
+    }
+    auto pipeline = create_pipeline(*shader, "iterate");
+    if (!pipeline) {
+        return std::unexpected(pipeline.error());
+    }
+    Logger::instance().info("FlameIFS kernel: {}", key);
+    m_pipelines.emplace(key, *pipeline);
+    return *pipeline;
+}
+
+void FlameIFS::upload_transforms() {
+    auto* gpu_transforms = static_cast<GPUFlameTransform*>(m_transform_mapped);
+    std::vector<float> weights;
+    for (size_t i = 0; i < m_definition.transforms.size(); i++) {
+        gpu_transforms[i] = pack_transform(m_definition.transforms[i]);
+        weights.push_back(std::max(m_definition.transforms[i].weight, 0.0f));
+    }
+    const auto table = build_alias_table(weights);
+    for (size_t i = 0; i < table.size(); i++) {
+        gpu_transforms[i].threshold = table[i].threshold;
+        gpu_transforms[i].alias = table[i].alias;
+    }
+    if (m_definition.final_transform) {
+        gpu_transforms[m_definition.transforms.size()] = pack_transform(*m_definition.final_transform);
+    }
+}
+
+std::expected<void, std::string> FlameIFS::set_definition(FlameDefinition definition) {
+    if (definition.transforms.empty()) {
+        return std::unexpected("A flame needs at least one transform");
+    }
+    if (definition.transforms.size() > max_transform_count) {
+        return std::unexpected(std::format("A flame has at most {} transforms, got {}", max_transform_count, definition.transforms.size()));
+    }
+
+    // Compile before waiting, so a new variation set does not stall the compute in flight
+    auto pipeline = iterate_pipeline(definition);
+    if (!pipeline) {
+        return std::unexpected(pipeline.error());
+    }
+
+    // The shader may still be reading the transforms
+    wait_compute_complete();
+    m_iterate_pipeline = *pipeline;
+    m_definition = std::move(definition);
+    upload_transforms();
+    return {};
+}
+
+void FlameIFS::cleanup() {
+    // Destroying the scheduler waits for pending compute work
+    m_scheduler.reset();
+    m_statistics.reset();
+
+    if (m_descriptor_pool) {
+        m_device.destroyDescriptorPool(m_descriptor_pool);
+        m_descriptor_pool = nullptr;
+    }
+    for (auto& [key, pipeline] : m_pipelines) {
+        m_device.destroyPipeline(pipeline);
+    }
+    m_pipelines.clear();
+    m_iterate_pipeline = nullptr;
+    if (m_resolve_pipeline) {
+        m_device.destroyPipeline(m_resolve_pipeline);
+        m_resolve_pipeline = nullptr;
+    }
+    if (m_pipeline_layout) {
+        m_device.destroyPipelineLayout(m_pipeline_layout);
+        m_pipeline_layout = nullptr;
+    }
+    if (m_descriptor_layout) {
+        m_device.destroyDescriptorSetLayout(m_descriptor_layout);
+        m_descriptor_layout = nullptr;
+    }
+    for (auto [buffer, memory] : {std::pair{&m_param_buffer, &m_param_memory},
+                                  std::pair{&m_transform_buffer, &m_transform_memory},
+                                  std::pair{&m_grid_buffer, &m_grid_memory}}) {
+        if (*buffer) {
+            m_device.destroyBuffer(*buffer);
+            *buffer = nullptr;
+        }
+        if (*memory) {
+            m_device.freeMemory(*memory);  // Implicitly unmaps
+            *memory = nullptr;
+        }
+    }
+}
+
+void FlameIFS::dispatch(
+    vk::CommandBuffer cmd,
+    vk::Buffer particle_buffer,
+    uint32_t particle_count,
+    const IFSParameters& params
+) {
+    update_params(particle_buffer, particle_count, params);
+
+    // The grid is zero here: creation clears it, and every resolve clears it again
+    for (uint32_t first = 0; first < particle_count; first += MAX_GROUPS_X * GROUP_SIZE) {
+        record_chunk(cmd, {.first = first, .count = std::min(particle_count - first, MAX_GROUPS_X * GROUP_SIZE)});
+    }
+    record_resolve(cmd, particle_count);
+}
+
+void FlameIFS::update_params(
+    vk::Buffer particle_buffer,
+    uint32_t particle_count,
+    const IFSParameters& params
+) {
+    // Relative density 1 is the average over the whole grid
+    const double samples = static_cast<double>(particle_count) * m_iteration_count;
+    const double cells = static_cast<double>(grid_size) * grid_size;
+
+    FlameShaderParams shader_params{
+        .iteration_count = m_iteration_count,
+        .fuse_count = m_fuse_count,
+        .particle_count = particle_count,
+        .random_seed = params.random_seed,
+        .transform_count = static_cast<uint32_t>(m_definition.transforms.size()),
+        .has_final = m_definition.final_transform ? 1u : 0u,
+        .grid_size = grid_size,
+        .auto_exposure = auto_exposure() ? 1u : 0u,
+        .scale = params.scale != 0.0f ? params.scale : 1.0f,
+        .brightness = m_brightness,
+        .gamma = std::max(m_gamma, 0.01f),
+        .density_scale = samples > 0.0 ? static_cast<float>(cells / samples) : 0.0f,
+        .palette = {}
+    };
+    for (size_t i = 0; i < m_definition.palette.size(); i++) {
+        shader_params.palette[i] = glm::vec4(m_definition.palette[i], 0.0f);
+    }
+    std::memcpy(m_param_mapped, &shader_params, sizeof(FlameShaderParams));
+
+    auto particle_buffer_info = vk::DescriptorBufferInfo(particle_buffer, 0, VK_WHOLE_SIZE);
+    auto write = vk::WriteDescriptorSet()
+        .setDstSet(m_descriptor_set)
+        .setDstBinding(0)
+        .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+        .setBufferInfo(particle_buffer_info);
+    m_device.updateDescriptorSets(write, {});
+}
+
+void FlameIFS::record_chunk(vk::CommandBuffer cmd, const ComputeChunk& chunk) const {
+    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, m_iterate_pipeline);
+    cmd.bindDescriptorSets(
+        vk::PipelineBindPoint::eCompute,
+        m_pipeline_layout,
+        0,
+        m_descriptor_set,
+        {}
+    );
+    cmd.pushConstants<ComputeChunk>(m_pipeline_layout, vk::ShaderStageFlagBits::eCompute, 0, chunk);
+    cmd.dispatch((chunk.count + GROUP_SIZE - 1) / GROUP_SIZE, 1, 1);
+}
+
+void FlameIFS::record_resolve(vk::CommandBuffer cmd, uint32_t particle_count) const {
+    // Every plot must land before any particle reads the grid
+    auto plotted = vk::MemoryBarrier()
+        .setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite);
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eComputeShader,
+                        {}, plotted, {}, {});
+
+    // Log-density of the occupied cells; record() leaves the result readable by the resolve
+    if (auto_exposure()) {
+        StatisticsSource density{
+            .stride = 2,
+            .offset = 0,
+            .log_scale = true,
+            .skip_zero = true,
+            .range_min = 0.0f,
+            .range_max = MAX_LOG_DENSITY,
+            .percentiles = {m_exposure_percentile, 0.5f, 0.9f, 0.99f}
+        };
+        m_statistics->record(cmd, 0, m_grid_buffer, grid_size * grid_size, density);
+    }
+
+    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, m_resolve_pipeline);
+    cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_pipeline_layout, 0, m_descriptor_set, {});
+    for (uint32_t first = 0; first < particle_count; first += MAX_GROUPS_X * GROUP_SIZE) {
+        const ComputeChunk chunk{.first = first, .count = std::min(particle_count - first, MAX_GROUPS_X * GROUP_SIZE)};
+        cmd.pushConstants<ComputeChunk>(m_pipeline_layout, vk::ShaderStageFlagBits::eCompute, 0, chunk);
+        cmd.dispatch((chunk.count + GROUP_SIZE - 1) / GROUP_SIZE, 1, 1);
+    }
+
+    // Clear the grid for the next compute once every particle has read it
+    auto resolved = vk::MemoryBarrier()
+        .setSrcAccessMask(vk::AccessFlagBits::eShaderRead)
+        .setDstAccessMask(vk::AccessFlagBits::eTransferWrite);
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eTransfer,
+                        {}, resolved, {}, {});
+    cmd.fillBuffer(m_grid_buffer, 0, VK_WHOLE_SIZE, 0u);
+    auto cleared = vk::MemoryBarrier()
+        .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite);
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eComputeShader,
+                        {}, cleared, {}, {});
+}
+
+void FlameIFS::compute(
+    vk::Buffer particle_buffer,
+    uint32_t particle_count,
+    const IFSParameters& params
+) {
+    // Backend owns its own particle buffer
+    (void)particle_buffer;
+    (void)particle_count;
+
+    // Wait for previous compute to finish (if any) before touching the shared parameters
+    wait_compute_complete();
+    update_params(m_particle_buffer->buffer(), m_particle_count, params);
+
+    auto record = [this](vk::CommandBuffer cmd, const ComputeChunk& chunk) {
+        record_chunk(cmd, chunk);
+    };
+
+    // Tone mapping needs the whole histogram, so it runs once every chunk has
+    // finished, followed by the ownership release barrier if different queue families or shared
+    auto finalize = [this](vk::CommandBuffer cmd) {
+        record_resolve(cmd, m_particle_count);
+        release_particle_buffer(cmd, *m_particle_buffer, m_context->queue_indices());
+    };
+
+    m_scheduler->submit(m_particle_count, record, finalize);
+    m_statistics_pending = auto_exposure();
+}
+
+void FlameIFS::wait_compute_complete() {
+    if (m_scheduler) {
+        m_scheduler->wait();
+    }
+    if (m_statistics_pending) {
+        m_statistics->collect(0);
+        m_statistics_pending = false;
+    }
+}
+
+const std::optional<StatisticsSummary>& FlameIFS::density_statistics() const {
+    static const std::optional<StatisticsSummary> none;
+    return m_statistics ? m_statistics->latest(0) : none;
+}
+
+std::vector<UICallback> FlameIFS::get_ui_callbacks() {
+    static constexpr std::size_t MAX_PARTICLES = (3.5 * 1024 * 1024 * 1024) / sizeof(Particle);
+    static constexpr int MAX_ITER = 500;
+
+    std::vector<UICallback> callbacks;
+
+    callbacks.emplace_back("Particle Count", DiscreteCallback{
+        .setter = [this](int v) {
+            uint32_t new_count = std::clamp<uint32_t>(static_cast<uint32_t>(v), 10000, MAX_PARTICLES);
+            if (new_count != m_particle_count) {
+                reallocate_particle_buffer(new_count);
+            }
+        },
+        .getter = [this]() { return static_cast<int>(m_particle_count); },
+        .min = 10000,
+        .max = MAX_PARTICLES
+    });
+    callbacks.emplace_back("Iteration Count", DiscreteCallback{
+        .setter = [this](int v) { m_iteration_count = static_cast<uint32_t>(std::clamp(v, 1, MAX_ITER)); },
+        .getter = [this]() { return static_cast<int>(m_iteration_count); },
+        .min = 1,
+        .max = MAX_ITER
+    });
+
+    // Preset index; -1 while the definition matches none (e.g. after editing)
+    auto names = FlameDefinition::preset_names();
+    callbacks.emplace_back("Preset", DiscreteCallback{
+        .setter = [this, names](int v) {
+            if (v >= 0 && v < static_cast<int>(names.size())) {
+                if (auto result = set_definition(*FlameDefinition::preset(names[v])); !result) {
+                    Logger::instance().error("Failed to load preset: {}", result.error());
+                }
+            }
+        },
+        .getter = [this, names]() {
+            for (size_t i = 0; i < names.size(); i++) {
+                if (FlameDefinition::preset(names[i]) == m_definition) {
+                    return static_cast<int>(i);
+                }
+            }
+            return -1;
+        },
+        .min = 0,
+        .max = static_cast<int>(names.size()) - 1
+    });
+    callbacks.emplace_back("Brightness", ContinuousCallback{
+        .setter = [this](float v) { m_brightness = v; },
+        .getter = [this]() { return m_brightness; },
+        .min = 0.05f,
+        .max = 20.0f,
+        .logarithmic = true
+    });
+    callbacks.emplace_back("Gamma", ContinuousCallback{
+        .setter = [this](float v) { m_gamma = v; },
+        .getter = [this]() { return m_gamma; },
+        .min = 0.5f,
+        .max = 5.0f
+    });
+    if (m_statistics) {
+        callbacks.emplace_back("Auto Exposure", ToggleCallback{
+            .setter = [this](bool v) { m_auto_exposure = v; },
+            .getter = [this]() { return m_auto_exposure; }
+        });
+        callbacks.emplace_back("Exposure Percentile", ContinuousCallback{
+            .setter = [this](float v) { m_exposure_percentile = v; },
+            .getter = [this]() { return m_exposure_percentile; },
+            .min = 0.5f,
+            .max = 0.9999f
+        });
+    }
+
+    // Transform editor; a variation leaving or joining the used set compiles (or reuses) a kernel
+    const auto transform_count = static_cast<int>(m_definition.transforms.size());
+    m_edit_transform = std::min(m_edit_transform, static_cast<uint32_t>(transform_count - 1));
+    callbacks.emplace_back("Edit Transform", DiscreteCallback{
+        .setter = [this](int v) {
+            m_edit_transform = static_cast<uint32_t>(std::clamp(v, 0, static_cast<int>(m_definition.transforms.size()) - 1));
+        },
+        .getter = [this]() { return static_cast<int>(m_edit_transform); },
+        .min = 0,
+        .max = transform_count - 1
+    });
+    auto edit_transform = [this](auto&& change) {
+        FlameDefinition definition = m_definition;
+        change(definition.transforms[m_edit_transform]);
+        if (auto result = set_definition(std::move(definition)); !result) {
+            Logger::instance().error("{}", result.error());
+        }
+    };
+    callbacks.emplace_back("Transform Weight", ContinuousCallback{
+        .setter = [edit_transform](float v) { edit_transform([v](FlameTransform& t) { t.weight = v; }); },
+        .getter = [this]() { return m_definition.transforms[m_edit_transform].weight; },
+        .min = 0.001f,
+        .max = 100.0f,
+        .logarithmic = true
+    });
+    callbacks.emplace_back("Transform Color", ContinuousCallback{
+        .setter = [edit_transform](float v) { edit_transform([v](FlameTransform& t) { t.color = v; }); },
+        .getter = [this]() { return m_definition.transforms[m_edit_transform].color; },
+        .min = 0.0f,
+        .max = 1.0f
+    });
+    for (uint32_t v = 0; v < variation_count; v++) {
+        const auto variation = static_cast<Variation>(v);
+        callbacks.emplace_back(std::format("Variation {}", to_string(variation)), ContinuousCallback{
+            .setter = [edit_transform, variation](float w) {
+                edit_transform([variation, w](FlameTransform& t) { t.variation(variation) = w; });
+            },
+            .getter = [this, variation]() { return m_definition.transforms[m_edit_transform].variation(variation); },
+            .min = -2.0f,
+            .max = 2.0f
+        });
+    }
+
+    return callbacks;
+}
+
+void FlameIFS::reallocate_particle_buffer(uint32_t new_count) {
+    Logger::instance().info("Reallocating particle buffer: {} -> {} particles", m_particle_count, new_count);
+
+    wait_compute_complete();
+    auto _ = m_device.waitIdle();
+
+    m_particle_count = new_count;
+
+    ParticleBufferConfig buffer_config{
+        .particle_count = m_particle_count,
+        .support_dynamic_resize = false
+    };
+
+    auto particle_buffer_result = ParticleBuffer::create(*m_context, m_device, buffer_config);
+    if (!particle_buffer_result) {
+        Logger::instance().error("Failed to reallocate particle buffer: {}", particle_buffer_result.error());
+        return;
+    }
+    m_particle_buffer = std::make_unique<ParticleBuffer>(std::move(particle_buffer_result.value()));
+
+    Logger::instance().info("Particle buffer reallocated successfully");
+}
+
+} // namespace ifs
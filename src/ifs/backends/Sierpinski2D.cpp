@@ -1,5 +1,6 @@
 #include <ifs/backends/Sierpinski2D.hpp>
 #include <ifs/Logger.hpp>
+#include <ifs/StartupTrace.hpp>
 #include <format>
 #include <random>
 
@@ -29,10 +30,7 @@ Sierpinski2D::Sierpinski2D(
     , m_descriptor_set(nullptr)
     , m_param_buffer(nullptr)
     , m_param_memory(nullptr)
-    , m_compute_command_pool(nullptr)
-    , m_compute_command_buffer(nullptr)
-    , m_compute_fence(nullptr)
-    , m_compute_queue(nullptr)
+    , m_scheduler(nullptr)
 {}
 
 std::expected<std::unique_ptr<Sierpinski2D>, std::string> Sierpinski2D::create(
@@ -66,10 +64,7 @@ Sierpinski2D::Sierpinski2D(Sierpinski2D&& other) noexcept
     , m_descriptor_set(std::exchange(other.m_descriptor_set, nullptr))
     , m_param_buffer(std::exchange(other.m_param_buffer, nullptr))
     , m_param_memory(std::exchange(other.m_param_memory, nullptr))
-    , m_compute_command_pool(std::exchange(other.m_compute_command_pool, nullptr))
-    , m_compute_command_buffer(std::exchange(other.m_compute_command_buffer, nullptr))
-    , m_compute_fence(std::exchange(other.m_compute_fence, nullptr))
-    , m_compute_queue(std::exchange(other.m_compute_queue, nullptr))
+    , m_scheduler(std::move(other.m_scheduler))
 {}
 
 Sierpinski2D& Sierpinski2D::operator=(Sierpinski2D&& other) noexcept {
@@ -88,10 +83,7 @@ Sierpinski2D& Sierpinski2D::operator=(Sierpinski2D&& other) noexcept {
         m_descriptor_set = std::exchange(other.m_descriptor_set, nullptr);
         m_param_buffer = std::exchange(other.m_param_buffer, nullptr);
         m_param_memory = std::exchange(other.m_param_memory, nullptr);
-        m_compute_command_pool = std::exchange(other.m_compute_command_pool, nullptr);
-        m_compute_command_buffer = std::exchange(other.m_compute_command_buffer, nullptr);
-        m_compute_fence = std::exchange(other.m_compute_fence, nullptr);
-        m_compute_queue = std::exchange(other.m_compute_queue, nullptr);
+        m_scheduler = std::move(other.m_scheduler);
 
 
     }
@@ -137,20 +129,9 @@ std::expected<void, std::string> Sierpinski2D::initialize() {
 
     // Allocate host-visible memory
     auto mem_reqs = m_device.getBufferMemoryRequirements(m_param_buffer);
-    auto mem_props = m_context->physical_device().getMemoryProperties();
-
-    uint32_t memory_type = UINT32_MAX;
-    for (uint32_t i = 0; i < mem_props.memoryTypeCount; i++) {
-        if ((mem_reqs.memoryTypeBits & (1 << i)) &&
-            (mem_props.memoryTypes[i].propertyFlags &
-             (vk::MemoryPropertyFlagBits::eHostVisible |
-              vk::MemoryPropertyFlagBits::eHostCoherent))) {
-            memory_type = i;
-            break;
-        }
-    }
-
-    if (memory_type == UINT32_MAX) {
+    auto memory_type = m_context->find_memory_type(mem_reqs.memoryTypeBits,
+        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+    if (!memory_type) {
         m_device.destroyBuffer(m_param_buffer);
         m_param_buffer = nullptr;
         return std::unexpected("Failed to find suitable memory type for parameter buffer");
@@ -158,7 +139,7 @@ std::expected<void, std::string> Sierpinski2D::initialize() {
 
     auto alloc_info = vk::MemoryAllocateInfo()
         .setAllocationSize(mem_reqs.size)
-        .setMemoryTypeIndex(memory_type);
+        .setMemoryTypeIndex(*memory_type);
 
 	auto alloc_res = m_device.allocateMemory(alloc_info);
     if (alloc_res.result != vk::Result::eSuccess)
@@ -220,44 +201,13 @@ std::expected<void, std::string> Sierpinski2D::initialize() {
 
     m_device.updateDescriptorSets(write, {});
 
-    // Phase 2: Create compute command infrastructure
-    m_compute_queue = m_context->compute_queue();
-
-    // Create command pool for compute queue
-    auto cmd_pool_info = vk::CommandPoolCreateInfo()
-        .setQueueFamilyIndex(m_context->queue_indices().compute)
-        .setFlags(vk::CommandPoolCreateFlagBits::eResetCommandBuffer);
-
-	auto cmd_pool_res = m_device.createCommandPool(cmd_pool_info);
-	if (cmd_pool_res.result != vk::Result::eSuccess)
-	{
-		return std::unexpected(std::format("Failed to create compute command pool: {}", to_string(cmd_pool_res.result)));
-	}
-	m_compute_command_pool = cmd_pool_res.value;
-
-    // Allocate command buffer
-    auto cmd_alloc_info = vk::CommandBufferAllocateInfo()
-        .setCommandPool(m_compute_command_pool)
-        .setLevel(vk::CommandBufferLevel::ePrimary)
-        .setCommandBufferCount(1);
-
-	auto cmd_buffers_res = m_device.allocateCommandBuffers(cmd_alloc_info);
-	if (cmd_buffers_res.result != vk::Result::eSuccess)
-	{
-		return std::unexpected(std::format("Failed to allocate compute command buffer: {}", to_string(cmd_buffers_res.result)));
-	}
-	m_compute_command_buffer = cmd_buffers_res.value[0];
-
-    // Create fence for synchronization
-    auto fence_info = vk::FenceCreateInfo()
-        .setFlags(vk::FenceCreateFlagBits::eSignaled);  // Start signaled
-
-	auto fence_res = m_device.createFence(fence_info);
-	if (fence_res.result != vk::Result::eSuccess)
-	{
-		return std::unexpected(std::format("Failed to create compute fence: {}", to_string(fence_res.result)));
-	}
-	m_compute_fence = fence_res.value;
+    // Compute submission (one lane per compute queue)
+    auto scheduler_result = ComputeScheduler::create(*m_context);
+    if (!scheduler_result) {
+        return std::unexpected(std::format("Failed to create compute scheduler: {}", scheduler_result.error()));
+    }
+    m_scheduler = std::move(*scheduler_result);
+    m_scheduler->set_granularity(256);  // numthreads(256) in the shader
 
     // Create particle buffer with initial particle count
     ParticleBufferConfig buffer_config{
@@ -324,13 +274,22 @@ std::expected<void, std::string> Sierpinski2D::create_descriptor_layout() {
 }
 
 std::expected<void, std::string> Sierpinski2D::create_pipeline() {
+    auto trace_scope = StartupTrace::instance().phase("pipeline:Sierpinski2D");
+
     if (!m_descriptor_layout) {
         return std::unexpected("Descriptor layout not created");
     }
 
     // Create pipeline layout
+    // Push constant: DispatchChunk (particle range of one chunk)
+    auto push_constant_range = vk::PushConstantRange()
+        .setStageFlags(vk::ShaderStageFlagBits::eCompute)
+        .setOffset(0)
+        .setSize(sizeof(ComputeChunk));
+
     auto pipeline_layout_info = vk::PipelineLayoutCreateInfo()
-        .setSetLayouts(m_descriptor_layout);
+        .setSetLayouts(m_descriptor_layout)
+        .setPushConstantRanges(push_constant_range);
 
 	auto pipeline_layout_res = m_device.createPipelineLayout(pipeline_layout_info);
 	if (pipeline_layout_res.result != vk::Result::eSuccess)
@@ -365,19 +324,8 @@ std::expected<void, std::string> Sierpinski2D::create_pipeline() {
 }
 
 void Sierpinski2D::cleanup() {
-    // Phase 2: Cleanup compute infrastructure
-    if (m_compute_fence) {
-        // Wait for any pending compute operations before cleanup
-        [[maybe_unused]] auto result = m_device.waitForFences(m_compute_fence, true, UINT64_MAX);
-        m_device.destroyFence(m_compute_fence);
-        m_compute_fence = nullptr;
-    }
-    if (m_compute_command_pool) {
-        // Command buffer is freed when pool is destroyed
-        m_device.destroyCommandPool(m_compute_command_pool);
-        m_compute_command_pool = nullptr;
-        m_compute_command_buffer = nullptr;
-    }
+    // Destroying the scheduler waits for pending compute work
+    m_scheduler.reset();
 
     if (m_descriptor_pool) {
         m_device.destroyDescriptorPool(m_descriptor_pool);
@@ -410,6 +358,15 @@ void Sierpinski2D::dispatch(
     vk::Buffer particle_buffer,
     uint32_t particle_count,
     const IFSParameters& params
+) {
+    update_params(particle_buffer, particle_count, params);
+    record_chunk(cmd, {.first = 0, .count = particle_count});
+}
+
+void Sierpinski2D::update_params(
+    vk::Buffer particle_buffer,
+    uint32_t particle_count,
+    const IFSParameters& params
 ) {
     // Update parameter buffer
     IFSShaderParams shader_params{
@@ -440,7 +397,9 @@ void Sierpinski2D::dispatch(
         .setBufferInfo(particle_buffer_info);
 
     m_device.updateDescriptorSets(write, {});
+}
 
+void Sierpinski2D::record_chunk(vk::CommandBuffer cmd, const ComputeChunk& chunk) const {
     // Bind pipeline and dispatch
     cmd.bindPipeline(vk::PipelineBindPoint::eCompute, m_compute_pipeline);
     cmd.bindDescriptorSets(
@@ -450,9 +409,10 @@ void Sierpinski2D::dispatch(
         m_descriptor_set,
         {}
     );
+    cmd.pushConstants<ComputeChunk>(m_pipeline_layout, vk::ShaderStageFlagBits::eCompute, 0, chunk);
 
     // Calculate dispatch size (256 threads per workgroup)
-    uint32_t workgroup_count = (particle_count + 255) / 256;
+    uint32_t workgroup_count = (chunk.count + 255) / 256;
     cmd.dispatch(workgroup_count, 1, 1);
 }
 
@@ -466,44 +426,27 @@ void Sierpinski2D::compute(
     (void)particle_buffer;
     (void)particle_count;
 
-    // Wait for previous compute to finish (if any)
+    // Wait for previous compute to finish (if any) before touching the shared parameters
     wait_compute_complete();
+    update_params(m_particle_buffer->buffer(), m_particle_count, params);
 
-    // Reset fence before recording
-    auto _ = m_device.resetFences(m_compute_fence);
-
-    // Reset and begin command buffer
-    auto _ = m_compute_command_buffer.reset();
-    auto _ = m_compute_command_buffer.begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
-
-    // Record dispatch using backend's own particle buffer
-    dispatch(m_compute_command_buffer, m_particle_buffer->buffer(), m_particle_count, params);
-
-    // Issue ownership release barrier if different queue families
-    bool different_queue_families = m_context->queue_indices().has_dedicated_compute();
-    if (different_queue_families) {
-        release_buffer_ownership(
-            m_compute_command_buffer,
-            m_particle_buffer->buffer(),
-            m_context->queue_indices().compute,
-            m_context->queue_indices().graphics
-        );
-    }
-
-    auto _ = m_compute_command_buffer.end();
-
-    // Submit to compute queue with fence
-    auto submit_info = vk::SubmitInfo()
-        .setCommandBuffers(m_compute_command_buffer);
+    auto record = [this](vk::CommandBuffer cmd, const ComputeChunk& chunk) {
+        record_chunk(cmd, chunk);
+    };
 
-    auto _ = m_compute_queue.submit(submit_info, m_compute_fence);
+    // Issue ownership release barrier if different queue families or shared
+    // (recorded on queue 0 once every chunk has finished)
+    auto finalize = [this](vk::CommandBuffer cmd) {
+        release_particle_buffer(cmd, *m_particle_buffer, m_context->queue_indices());
+    };
 
-    // Return immediately - asynchronous execution
+    // Submits to all compute queues and returns immediately - asynchronous execution
+    m_scheduler->submit(m_particle_count, record, finalize);
 }
 
 void Sierpinski2D::wait_compute_complete() {
-    if (m_compute_fence) {
-        [[maybe_unused]] auto result = m_device.waitForFences(m_compute_fence, true, UINT64_MAX);
+    if (m_scheduler) {
+        m_scheduler->wait();
     }
 }
 
@@ -1,8 +1,15 @@
 #include <ifs/frontends/ParticleRenderer.hpp>
 #include <ifs/Logger.hpp>
+#include <ifs/ParticleData.hpp>
+#include <ifs/StartupTrace.hpp>
 #include <imgui.h>
 #include <imgui_impl_vulkan.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <format>
+#include <span>
+#include <utility>
 
 namespace ifs {
 
@@ -11,7 +18,98 @@ struct alignas(16) ViewShaderParams {
     glm::mat4 view_projection;
     glm::vec2 screen_size;
     float point_size;
-    float padding;
+    float alpha_exponent;  ///< Point LOD: 1 / fraction of the particles drawn
+    glm::mat4 view_projections[MultiviewTarget::MAX_VIEWS];  ///< Split-screen views, indexed by SV_ViewID
+};
+
+// Fixed-function state of the point pipelines; info() points into it
+struct PointPipelineState {
+    // Vertex input (empty - using SSBO in shader)
+    vk::PipelineVertexInputStateCreateInfo vertex_input_info{};
+
+    // Input assembly
+    vk::PipelineInputAssemblyStateCreateInfo input_assembly = vk::PipelineInputAssemblyStateCreateInfo()
+        .setTopology(vk::PrimitiveTopology::ePointList)
+        .setPrimitiveRestartEnable(false);
+
+    // Viewport and scissor (dynamic)
+    vk::PipelineViewportStateCreateInfo viewport_state = vk::PipelineViewportStateCreateInfo()
+        .setViewportCount(1)
+        .setScissorCount(1);
+
+    // Rasterization
+    vk::PipelineRasterizationStateCreateInfo rasterizer = vk::PipelineRasterizationStateCreateInfo()
+        .setDepthClampEnable(false)
+        .setRasterizerDiscardEnable(false)
+        .setPolygonMode(vk::PolygonMode::eFill)
+        .setLineWidth(1.0f)
+        .setCullMode(vk::CullModeFlagBits::eNone)
+        .setFrontFace(vk::FrontFace::eCounterClockwise)
+        .setDepthBiasEnable(false);
+
+    // Multisampling
+    vk::PipelineMultisampleStateCreateInfo multisampling = vk::PipelineMultisampleStateCreateInfo()
+        .setSampleShadingEnable(false)
+        .setRasterizationSamples(vk::SampleCountFlagBits::e1);
+
+    // Color blending
+    vk::PipelineColorBlendAttachmentState color_blend_attachment = vk::PipelineColorBlendAttachmentState()
+        .setColorWriteMask(vk::ColorComponentFlagBits::eR |
+                          vk::ColorComponentFlagBits::eG |
+                          vk::ColorComponentFlagBits::eB |
+                          vk::ColorComponentFlagBits::eA)
+        .setBlendEnable(true)
+        .setSrcColorBlendFactor(vk::BlendFactor::eSrcAlpha)
+        .setDstColorBlendFactor(vk::BlendFactor::eOneMinusSrcAlpha)
+        .setColorBlendOp(vk::BlendOp::eAdd)
+        .setSrcAlphaBlendFactor(vk::BlendFactor::eOne)
+        .setDstAlphaBlendFactor(vk::BlendFactor::eZero)
+        .setAlphaBlendOp(vk::BlendOp::eAdd);
+
+    vk::PipelineColorBlendStateCreateInfo color_blending = vk::PipelineColorBlendStateCreateInfo()
+        .setLogicOpEnable(false)
+        .setAttachments(color_blend_attachment);
+
+    // Depth/stencil state
+    vk::PipelineDepthStencilStateCreateInfo depth_stencil = vk::PipelineDepthStencilStateCreateInfo()
+        .setDepthTestEnable(true)
+        .setDepthWriteEnable(true)
+        .setDepthCompareOp(vk::CompareOp::eLess)
+        .setDepthBoundsTestEnable(false)
+        .setStencilTestEnable(false);
+
+    // Dynamic state
+    std::array<vk::DynamicState, 2> dynamic_states = {
+        vk::DynamicState::eViewport,
+        vk::DynamicState::eScissor
+    };
+
+    vk::PipelineDynamicStateCreateInfo dynamic_state = vk::PipelineDynamicStateCreateInfo()
+        .setDynamicStates(dynamic_states);
+
+    PointPipelineState() = default;
+    PointPipelineState(const PointPipelineState&) = delete;
+    PointPipelineState& operator=(const PointPipelineState&) = delete;
+
+    [[nodiscard]] vk::GraphicsPipelineCreateInfo info(
+        std::span<const vk::PipelineShaderStageCreateInfo> stages,
+        vk::PipelineLayout layout,
+        vk::RenderPass render_pass
+    ) const {
+        return vk::GraphicsPipelineCreateInfo()
+            .setStages(stages)
+            .setPVertexInputState(&vertex_input_info)
+            .setPInputAssemblyState(&input_assembly)
+            .setPViewportState(&viewport_state)
+            .setPRasterizationState(&rasterizer)
+            .setPMultisampleState(&multisampling)
+            .setPDepthStencilState(&depth_stencil)
+            .setPColorBlendState(&color_blending)
+            .setPDynamicState(&dynamic_state)
+            .setLayout(layout)
+            .setRenderPass(render_pass)
+            .setSubpass(0);
+    }
 };
 
 ParticleRenderer::ParticleRenderer(
@@ -34,6 +132,7 @@ ParticleRenderer::ParticleRenderer(
     , m_view_buffer(nullptr)
     , m_view_memory(nullptr)
     , m_point_size(2.0f)
+    , m_multiview_pipeline(nullptr)
     , m_graphics_command_pool(nullptr)
     , m_graphics_queue(nullptr)
 {}
@@ -75,6 +174,19 @@ ParticleRenderer::ParticleRenderer(ParticleRenderer&& other) noexcept
     , m_view_buffer(other.m_view_buffer)
     , m_view_memory(other.m_view_memory)
     , m_point_size(other.m_point_size)
+    , m_statistics(std::move(other.m_statistics))
+    , m_overdraw(std::move(other.m_overdraw))
+    , m_show_overdraw(other.m_show_overdraw)
+    , m_multiview_vertex_shader(std::move(other.m_multiview_vertex_shader))
+    , m_multiview(std::move(other.m_multiview))
+    , m_multiview_pipeline(other.m_multiview_pipeline)
+    , m_multiview_failed(other.m_multiview_failed)
+    , m_lod_readbacks(std::move(other.m_lod_readbacks))
+    , m_lod_copied(std::move(other.m_lod_copied))
+    , m_lod_samples(std::move(other.m_lod_samples))
+    , m_point_lod(other.m_point_lod)
+    , m_lod_density(other.m_lod_density)
+    , m_lod_drawn(other.m_lod_drawn)
     , m_graphics_command_pool(other.m_graphics_command_pool)
     , m_command_buffers(std::move(other.m_command_buffers))
     , m_render_finished_semaphores(std::move(other.m_render_finished_semaphores))
@@ -89,6 +201,7 @@ ParticleRenderer::ParticleRenderer(ParticleRenderer&& other) noexcept
     other.m_descriptor_set = nullptr;
     other.m_view_buffer = nullptr;
     other.m_view_memory = nullptr;
+    other.m_multiview_pipeline = nullptr;
     other.m_graphics_command_pool = nullptr;
     other.m_graphics_queue = nullptr;
 }
@@ -111,6 +224,19 @@ ParticleRenderer& ParticleRenderer::operator=(ParticleRenderer&& other) noexcept
         m_view_buffer = other.m_view_buffer;
         m_view_memory = other.m_view_memory;
         m_point_size = other.m_point_size;
+        m_statistics = std::move(other.m_statistics);
+        m_overdraw = std::move(other.m_overdraw);
+        m_show_overdraw = other.m_show_overdraw;
+        m_multiview_vertex_shader = std::move(other.m_multiview_vertex_shader);
+        m_multiview = std::move(other.m_multiview);
+        m_multiview_pipeline = other.m_multiview_pipeline;
+        m_multiview_failed = other.m_multiview_failed;
+        m_lod_readbacks = std::move(other.m_lod_readbacks);
+        m_lod_copied = std::move(other.m_lod_copied);
+        m_lod_samples = std::move(other.m_lod_samples);
+        m_point_lod = other.m_point_lod;
+        m_lod_density = other.m_lod_density;
+        m_lod_drawn = other.m_lod_drawn;
         m_graphics_command_pool = other.m_graphics_command_pool;
         m_command_buffers = std::move(other.m_command_buffers);
         m_render_finished_semaphores = std::move(other.m_render_finished_semaphores);
@@ -125,6 +251,7 @@ ParticleRenderer& ParticleRenderer::operator=(ParticleRenderer&& other) noexcept
         other.m_descriptor_set = nullptr;
         other.m_view_buffer = nullptr;
         other.m_view_memory = nullptr;
+        other.m_multiview_pipeline = nullptr;
         other.m_graphics_command_pool = nullptr;
         other.m_graphics_queue = nullptr;
     }
@@ -179,20 +306,9 @@ std::expected<void, std::string> ParticleRenderer::initialize() {
 
     // Allocate host-visible memory
     auto mem_reqs = m_device.getBufferMemoryRequirements(m_view_buffer);
-    auto mem_props = m_context->physical_device().getMemoryProperties();
-
-    uint32_t memory_type = UINT32_MAX;
-    for (uint32_t i = 0; i < mem_props.memoryTypeCount; i++) {
-        if ((mem_reqs.memoryTypeBits & (1 << i)) &&
-            (mem_props.memoryTypes[i].propertyFlags &
-             (vk::MemoryPropertyFlagBits::eHostVisible |
-              vk::MemoryPropertyFlagBits::eHostCoherent))) {
-            memory_type = i;
-            break;
-        }
-    }
-
-    if (memory_type == UINT32_MAX) {
+    auto memory_type = m_context->find_memory_type(mem_reqs.memoryTypeBits,
+        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+    if (!memory_type) {
         m_device.destroyBuffer(m_view_buffer);
         m_view_buffer = nullptr;
         return std::unexpected("Failed to find suitable memory type for view buffer");
@@ -200,7 +316,7 @@ std::expected<void, std::string> ParticleRenderer::initialize() {
 
     auto alloc_info = vk::MemoryAllocateInfo()
         .setAllocationSize(mem_reqs.size)
-        .setMemoryTypeIndex(memory_type);
+        .setMemoryTypeIndex(*memory_type);
 
 	auto alloc_res = m_device.allocateMemory(alloc_info);
 	if (alloc_res.result != vk::Result::eSuccess)
@@ -292,6 +408,22 @@ std::expected<void, std::string> ParticleRenderer::initialize() {
 		m_in_flight_fences.push_back(fence_res.value);
     }
 
+    auto statistics_result = PipelineStatisticsQuery::create(*m_context, MAX_FRAMES_IN_FLIGHT);
+    if (!statistics_result) {
+        return std::unexpected(statistics_result.error());
+    }
+    m_statistics = std::move(*statistics_result);
+
+    // Point LOD sample readbacks, one per frame in flight
+    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+        auto readback = ReadbackBuffer::create(*m_context, LOD_SAMPLES * sizeof(Particle));
+        if (!readback) {
+            return std::unexpected(std::format("Failed to create LOD readback: {}", readback.error()));
+        }
+        m_lod_readbacks.push_back(std::move(*readback));
+    }
+    m_lod_copied.assign(MAX_FRAMES_IN_FLIGHT, 0);
+
     // Note: Command buffers and semaphores will be created when swapchain is known
     // They are NOT created here because we need to know the swapchain image count first
 
@@ -330,6 +462,8 @@ std::expected<void, std::string> ParticleRenderer::create_descriptor_layout() {
 }
 
 std::expected<void, std::string> ParticleRenderer::create_pipeline() {
+    auto trace_scope = StartupTrace::instance().phase("pipeline:ParticleRenderer");
+
     if (!m_descriptor_layout) {
         return std::unexpected("Descriptor layout not created");
     }
@@ -357,92 +491,99 @@ std::expected<void, std::string> ParticleRenderer::create_pipeline() {
             .setPName("main")
     };
 
-    // Vertex input (empty - using SSBO in shader)
-    auto vertex_input_info = vk::PipelineVertexInputStateCreateInfo();
+    // Create pipeline
+    const PointPipelineState state;
+    auto pipeline_info = state.info(shader_stages, m_pipeline_layout, m_render_pass);
 
-    // Input assembly
-    auto input_assembly = vk::PipelineInputAssemblyStateCreateInfo()
-        .setTopology(vk::PrimitiveTopology::ePointList)
-        .setPrimitiveRestartEnable(false);
+	auto pipeline_res = m_device.createGraphicsPipeline(nullptr, pipeline_info);
+	if (pipeline_res.result != vk::Result::eSuccess)
+	{
+		return std::unexpected(std::format("Failed to create graphics pipeline: {}", to_string(pipeline_res.result)));
+	}
+	m_graphics_pipeline = pipeline_res.value;
 
-    // Viewport and scissor (dynamic)
-    auto viewport_state = vk::PipelineViewportStateCreateInfo()
-        .setViewportCount(1)
-        .setScissorCount(1);
+    // Overdraw variant of this pipeline (optional debug feature)
+    if (OverdrawHeatmap::supported(*m_context)) {
+        auto overdraw_result = OverdrawHeatmap::create(*m_context, pipeline_info, m_descriptor_layout);
+        if (overdraw_result) {
+            m_overdraw = std::move(*overdraw_result);
+        } else {
+            Logger::instance().warn("Overdraw heatmap unavailable: {}", overdraw_result.error());
+        }
+    }
 
-    // Rasterization
-    auto rasterizer = vk::PipelineRasterizationStateCreateInfo()
-        .setDepthClampEnable(false)
-        .setRasterizerDiscardEnable(false)
-        .setPolygonMode(vk::PolygonMode::eFill)
-        .setLineWidth(1.0f)
-        .setCullMode(vk::CullModeFlagBits::eNone)
-        .setFrontFace(vk::FrontFace::eCounterClockwise)
-        .setDepthBiasEnable(false);
+    return {};
+}
 
-    // Multisampling
-    auto multisampling = vk::PipelineMultisampleStateCreateInfo()
-        .setSampleShadingEnable(false)
-        .setRasterizationSamples(vk::SampleCountFlagBits::e1);
+bool ParticleRenderer::ensure_multiview(uint32_t view_count) {
+    if (m_multiview && m_multiview->view_count() == view_count) {
+        return true;
+    }
+    if (m_multiview_failed || !MultiviewTarget::supported(*m_context)) {
+        return false;
+    }
 
-    // Color blending
-    auto color_blend_attachment = vk::PipelineColorBlendAttachmentState()
-        .setColorWriteMask(vk::ColorComponentFlagBits::eR |
-                          vk::ColorComponentFlagBits::eG |
-                          vk::ColorComponentFlagBits::eB |
-                          vk::ColorComponentFlagBits::eA)
-        .setBlendEnable(true)
-        .setSrcColorBlendFactor(vk::BlendFactor::eSrcAlpha)
-        .setDstColorBlendFactor(vk::BlendFactor::eOneMinusSrcAlpha)
-        .setColorBlendOp(vk::BlendOp::eAdd)
-        .setSrcAlphaBlendFactor(vk::BlendFactor::eOne)
-        .setDstAlphaBlendFactor(vk::BlendFactor::eZero)
-        .setAlphaBlendOp(vk::BlendOp::eAdd);
+    // A different split: the frame in flight may still use the old target
+    auto _ = m_device.waitIdle();
+    destroy_multiview();
 
-    auto color_blending = vk::PipelineColorBlendStateCreateInfo()
-        .setLogicOpEnable(false)
-        .setAttachments(color_blend_attachment);
+    auto fail = [this](const std::string& error) {
+        Logger::instance().warn("Multiview views unavailable: {}", error);
+        destroy_multiview();
+        m_multiview_failed = true;
+        return false;
+    };
 
-    // Depth/stencil state
-    auto depth_stencil = vk::PipelineDepthStencilStateCreateInfo()
-        .setDepthTestEnable(true)
-        .setDepthWriteEnable(true)
-        .setDepthCompareOp(vk::CompareOp::eLess)
-        .setDepthBoundsTestEnable(false)
-        .setStencilTestEnable(false);
+    if (!m_multiview_vertex_shader) {
+        auto vert_result = Shader::create_shader(
+            m_device,
+            "ifs_modular/frontends/particle/particle.vert.slang",
+            "main_multiview"
+        );
+        if (!vert_result) {
+            return fail(std::format("Failed to load multiview vertex shader: {}", vert_result.error()));
+        }
+        m_multiview_vertex_shader = std::make_unique<Shader>(std::move(*vert_result));
+    }
 
-    // Dynamic state
-    std::vector<vk::DynamicState> dynamic_states = {
-        vk::DynamicState::eViewport,
-        vk::DynamicState::eScissor
+    std::array shader_stages = {
+        vk::PipelineShaderStageCreateInfo()
+            .setStage(vk::ShaderStageFlagBits::eVertex)
+            .setModule(m_multiview_vertex_shader->get_shader_module())
+            .setPName("main_multiview"),
+        vk::PipelineShaderStageCreateInfo()
+            .setStage(vk::ShaderStageFlagBits::eFragment)
+            .setModule(m_fragment_shader->get_shader_module())
+            .setPName("main")
     };
 
-    auto dynamic_state = vk::PipelineDynamicStateCreateInfo()
-        .setDynamicStates(dynamic_states);
-
-    // Create pipeline
-    auto pipeline_info = vk::GraphicsPipelineCreateInfo()
-        .setStages(shader_stages)
-        .setPVertexInputState(&vertex_input_info)
-        .setPInputAssemblyState(&input_assembly)
-        .setPViewportState(&viewport_state)
-        .setPRasterizationState(&rasterizer)
-        .setPMultisampleState(&multisampling)
-        .setPDepthStencilState(&depth_stencil)
-        .setPColorBlendState(&color_blending)
-        .setPDynamicState(&dynamic_state)
-        .setLayout(m_pipeline_layout)
-        .setRenderPass(m_render_pass)
-        .setSubpass(0);
+    // The composite draws into the frontend's render pass, the points into the target's
+    const PointPipelineState state;
+    auto target_result = MultiviewTarget::create(
+        *m_context, state.info(shader_stages, m_pipeline_layout, m_render_pass), view_count);
+    if (!target_result) {
+        return fail(target_result.error());
+    }
+    m_multiview = std::move(*target_result);
 
-	auto pipeline_res = m_device.createGraphicsPipeline(nullptr, pipeline_info);
+	auto pipeline_res = m_device.createGraphicsPipeline(
+		nullptr, state.info(shader_stages, m_pipeline_layout, m_multiview->render_pass()));
 	if (pipeline_res.result != vk::Result::eSuccess)
 	{
-		return std::unexpected(std::format("Failed to create graphics pipeline: {}", to_string(pipeline_res.result)));
+		return fail(std::format("Failed to create multiview pipeline: {}", to_string(pipeline_res.result)));
 	}
-	m_graphics_pipeline = pipeline_res.value;
+	m_multiview_pipeline = pipeline_res.value;
 
-    return {};
+    Logger::instance().info("Drawing {} views with multiview", view_count);
+    return true;
+}
+
+void ParticleRenderer::destroy_multiview() {
+    if (m_multiview_pipeline) {
+        m_device.destroyPipeline(m_multiview_pipeline);
+        m_multiview_pipeline = nullptr;
+    }
+    m_multiview.reset();
 }
 
 void ParticleRenderer::cleanup() {
@@ -457,6 +598,11 @@ void ParticleRenderer::cleanup() {
     }
     m_in_flight_fences.clear();
 
+    m_overdraw.reset();
+    m_statistics.reset();
+    destroy_multiview();
+    m_lod_readbacks.clear();
+
     for (auto& sem : m_render_finished_semaphores) {
         m_device.destroySemaphore(sem);
     }
@@ -524,12 +670,44 @@ void ParticleRenderer::render(
 ) {
     // Use provided extent or fall back to stored extent
     const auto& render_extent = extent ? *extent : m_extent;
+    record_points(cmd, particle_count, camera, vk::Rect2D({0, 0}, render_extent));
+}
+
+void ParticleRenderer::render_views(
+    vk::CommandBuffer cmd,
+    [[maybe_unused]] vk::Buffer particle_buffer,
+    uint32_t particle_count,
+    std::span<const FrameView> views
+) {
+    if (views.size() == 1) {
+        record_points(cmd, particle_count, *views.front().camera, views.front().area);
+        return;
+    }
+
+    // Drawn by record_multiview() before the render pass: only the composites are left
+    if (!std::exchange(m_multiview_this_frame, false)) {
+        record_points(cmd, particle_count, *views.front().camera, views.front().area);
+        return;
+    }
+    for (uint32_t view = 0; view < views.size(); view++) {
+        m_multiview->record_composite(cmd, view, views[view].area);
+    }
+}
+
+void ParticleRenderer::record_points(
+    vk::CommandBuffer cmd,
+    uint32_t particle_count,
+    Camera& camera,
+    const vk::Rect2D& area
+) {
     // Update view parameters
+    m_lod_drawn = lod_count(particle_count, camera, area.extent);
     ViewShaderParams view_params{
         .view_projection = camera.view_projection_matrix(),
         .screen_size = glm::vec2(m_extent.width, m_extent.height),
         .point_size = m_point_size,
-        .padding = 0.0f
+        .alpha_exponent = m_lod_drawn > 0 ? static_cast<float>(particle_count) / static_cast<float>(m_lod_drawn) : 1.0f,
+        .view_projections = {}
     };
 
     auto data_res = m_device.mapMemory(m_view_memory, 0, sizeof(ViewShaderParams));
@@ -538,32 +716,193 @@ void ParticleRenderer::render(
     m_device.unmapMemory(m_view_memory);
 
     // Set dynamic viewport and scissor
+    auto viewport = vk::Viewport()
+        .setX(static_cast<float>(area.offset.x))
+        .setY(static_cast<float>(area.offset.y))
+        .setWidth(static_cast<float>(area.extent.width))
+        .setHeight(static_cast<float>(area.extent.height))
+        .setMinDepth(0.0f)
+        .setMaxDepth(1.0f);
+
+    cmd.setViewport(0, viewport);
+    cmd.setScissor(0, area);
+
+    // Bind pipeline and draw
+    if (m_overdraw_this_frame) {
+        m_overdraw->bind_count_pipeline(cmd, m_descriptor_set);
+    } else {
+        cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, m_graphics_pipeline);
+        cmd.bindDescriptorSets(
+            vk::PipelineBindPoint::eGraphics,
+            m_pipeline_layout,
+            0,
+            m_descriptor_set,
+            {}
+        );
+    }
+
+    cmd.draw(m_lod_drawn, 1, 0, 0);
+}
+
+void ParticleRenderer::record_multiview(vk::CommandBuffer cmd, const FrameRenderInfo& info) {
+    m_multiview_this_frame = false;
+    const auto view_count = static_cast<uint32_t>(info.views.size());
+    if (view_count < 2 || !ensure_multiview(view_count)) {
+        return;
+    }
+
+    // One layer size for all views: the largest, so no view is upscaled.
+    // The views share one draw, so it draws the prefix the most covered view needs
+    vk::Extent2D extent{};
+    m_lod_drawn = 0;
+    ViewShaderParams view_params{
+        .view_projection = info.views.front().camera->view_projection_matrix(),
+        .screen_size = {},
+        .point_size = m_point_size,
+        .alpha_exponent = 1.0f,
+        .view_projections = {}
+    };
+    for (uint32_t view = 0; view < view_count; view++) {
+        extent.width = std::max(extent.width, info.views[view].area.extent.width);
+        extent.height = std::max(extent.height, info.views[view].area.extent.height);
+        view_params.view_projections[view] = info.views[view].camera->view_projection_matrix();
+        m_lod_drawn = std::max(m_lod_drawn, lod_count(info.particle_count, *info.views[view].camera, info.views[view].area.extent));
+    }
+    view_params.screen_size = glm::vec2(extent.width, extent.height);
+    if (m_lod_drawn > 0) {
+        view_params.alpha_exponent = static_cast<float>(info.particle_count) / static_cast<float>(m_lod_drawn);
+    }
+
+    if (!m_multiview->begin(cmd, extent, info.clear_values[0].color)) {
+        return;
+    }
+
+    auto data_res = m_device.mapMemory(m_view_memory, 0, sizeof(ViewShaderParams));
+	auto data = data_res.value;
+    std::memcpy(data, &view_params, sizeof(ViewShaderParams));
+    m_device.unmapMemory(m_view_memory);
+
     auto viewport = vk::Viewport()
         .setX(0.0f)
         .setY(0.0f)
-        .setWidth(static_cast<float>(render_extent.width))
-        .setHeight(static_cast<float>(render_extent.height))
+        .setWidth(static_cast<float>(extent.width))
+        .setHeight(static_cast<float>(extent.height))
         .setMinDepth(0.0f)
         .setMaxDepth(1.0f);
 
-    auto scissor = vk::Rect2D()
-        .setOffset({0, 0})
-        .setExtent(render_extent);
-
     cmd.setViewport(0, viewport);
-    cmd.setScissor(0, scissor);
+    cmd.setScissor(0, vk::Rect2D({0, 0}, extent));
+    cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, m_multiview_pipeline);
+    cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_pipeline_layout, 0, m_descriptor_set, {});
 
-    // Bind pipeline and draw
-    cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, m_graphics_pipeline);
-    cmd.bindDescriptorSets(
-        vk::PipelineBindPoint::eGraphics,
-        m_pipeline_layout,
-        0,
-        m_descriptor_set,
-        {}
-    );
+    // One draw for every view; SV_ViewID picks each view's camera
+    cmd.draw(m_lod_drawn, 1, 0, 0);
+
+    m_multiview->end(cmd);
+    m_multiview_this_frame = true;
+}
+
+void ParticleRenderer::record_pre_pass(
+    vk::CommandBuffer cmd,
+    vk::Buffer particle_buffer,
+    uint32_t particle_count,
+    [[maybe_unused]] Camera& camera,
+    [[maybe_unused]] const vk::Extent2D& extent
+) {
+    // The slot's previous frame has completed (render_frame() waited on its fence)
+    auto& readback = *m_lod_readbacks[m_frame_slot];
+    if (const uint32_t copied = std::exchange(m_lod_copied[m_frame_slot], 0); copied > 0) {
+        readback.invalidate();
+        const auto* particles = static_cast<const Particle*>(readback.data());
+        m_lod_samples.resize(copied);
+        for (uint32_t i = 0; i < copied; i++) {
+            m_lod_samples[i] = particles[i].position;
+        }
+    }
+
+    if (!m_point_lod || !particle_buffer || particle_count == 0) {
+        return;
+    }
 
-    cmd.draw(particle_count, 1, 0, 0);
+    // The particle buffer was acquired for vertex input; order the copy after it
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eVertexInput, vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, {});
+
+    const uint32_t count = std::min(particle_count, LOD_SAMPLES);
+    cmd.copyBuffer(particle_buffer, readback.buffer(), vk::BufferCopy(0, 0, count * sizeof(Particle)));
+
+    auto barrier = vk::MemoryBarrier()
+        .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eHostRead);
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eHost, {}, barrier, {}, {});
+    m_lod_copied[m_frame_slot] = count;
+}
+
+uint32_t ParticleRenderer::lod_count(uint32_t particle_count, Camera& camera, const vk::Extent2D& extent) const {
+    if (!m_point_lod || m_lod_samples.empty()) {
+        return particle_count;
+    }
+    return lod_draw_count(m_lod_samples, camera.view_projection_matrix(), extent, particle_count, m_lod_density);
+}
+
+uint32_t ParticleRenderer::lod_draw_count(
+    std::span<const glm::vec3> samples,
+    const glm::mat4& view_projection,
+    const vk::Extent2D& extent,
+    uint32_t particle_count,
+    float density
+) {
+    if (samples.empty() || particle_count == 0) {
+        return particle_count;
+    }
+
+    // Screen-space bounds of the samples, in NDC
+    glm::vec2 lo(1.0f);
+    glm::vec2 hi(-1.0f);
+    for (const auto& sample : samples) {
+        const glm::vec4 clip = view_projection * glm::vec4(sample, 1.0f);
+        if (clip.w <= 0.0f) {
+            return particle_count;  // Behind the camera: the bounds are unbounded
+        }
+        const glm::vec2 ndc = glm::vec2(clip) / clip.w;
+        lo = glm::min(lo, ndc);
+        hi = glm::max(hi, ndc);
+    }
+
+    // Clipped to the viewport; at least one pixel, since the samples may all miss the rest
+    lo = glm::max(lo, glm::vec2(-1.0f));
+    hi = glm::min(hi, glm::vec2(1.0f));
+    const glm::vec2 size = glm::max(hi - lo, glm::vec2(0.0f)) * 0.5f * glm::vec2(extent.width, extent.height);
+    const double covered = std::max(static_cast<double>(size.x) * size.y, 1.0);
+
+    const double wanted = std::ceil(covered * density);
+    return wanted >= particle_count ? particle_count : std::max(static_cast<uint32_t>(wanted), 1u);
+}
+
+std::vector<UICallback> ParticleRenderer::get_ui_callbacks() {
+    std::vector<UICallback> callbacks;
+    callbacks.emplace_back("Point Size", ContinuousCallback{
+        .setter = [this](float v) { set_point_size(v); },
+        .getter = [this]() { return point_size(); },
+        .min = 1.0f,
+        .max = 10.0f,
+        .logarithmic = false
+    });
+    callbacks.emplace_back("Point LOD", ToggleCallback{
+        .setter = [this](bool v) { set_point_lod(v); },
+        .getter = [this]() { return point_lod(); }
+    });
+    callbacks.emplace_back("LOD Density", ContinuousCallback{
+        .setter = [this](float v) { set_lod_density(v); },
+        .getter = [this]() { return lod_density(); },
+        .min = 1.0f,
+        .max = 256.0f,
+        .logarithmic = true
+    });
+
+    for (auto& callback : diagnostics_ui_callbacks(m_statistics.get(), m_overdraw.get(), m_show_overdraw)) {
+        callbacks.push_back(std::move(callback));
+    }
+    return callbacks;
 }
 
 void ParticleRenderer::resize(const vk::Extent2D& new_extent) {
@@ -617,6 +956,11 @@ void ParticleRenderer::handle_swapchain_recreation(uint32_t new_image_count) {
     m_images_in_flight.clear();
     m_images_in_flight.resize(new_image_count, nullptr);
 
+    // Recreated at the new extent by the next frame that shows it
+    if (m_overdraw) {
+        m_overdraw->handle_swapchain_recreation();
+    }
+
     Logger::instance().info("Frontend swapchain resources recreated for {} images", new_image_count);
 }
 
@@ -640,6 +984,9 @@ vk::Semaphore ParticleRenderer::render_frame(
     // Now we can reset the fence for the current frame
     m_device.resetFences(m_in_flight_fences[info.current_frame]);
 
+    // The frame's previous statistics query has completed with its fence
+    m_statistics->collect(info.current_frame, info.extent.width * info.extent.height);
+
     // Record command buffer
     auto& cmd = m_command_buffers[info.image_index];
     auto _ = cmd.reset();
@@ -652,6 +999,20 @@ vk::Semaphore ParticleRenderer::render_frame(
             info.compute_queue_family, info.graphics_queue_family);
     }
 
+    // LOD samples of the particle buffer, read back when this slot comes around again
+    m_frame_slot = info.current_frame;
+    record_pre_pass(cmd, info.particle_buffer, info.particle_count, info.camera, info.extent);
+
+    // Split-screen views are drawn together before the render pass
+    record_multiview(cmd, info);
+
+    // Overdraw counters are cleared outside the render pass (not in split frames)
+    m_overdraw_this_frame = m_show_overdraw && m_overdraw && info.views.empty();
+    if (m_overdraw_this_frame) {
+        m_overdraw->record_clear(cmd, info.extent);
+        m_overdraw_this_frame = m_overdraw->ready();
+    }
+
     // Begin render pass
     auto render_pass_begin = vk::RenderPassBeginInfo()
         .setRenderPass(info.render_pass)
@@ -662,7 +1023,17 @@ vk::Semaphore ParticleRenderer::render_frame(
     cmd.beginRenderPass(render_pass_begin, vk::SubpassContents::eInline);
 
     // Render particles (pass the extent to ensure correct viewport/scissor)
-    render(cmd, info.particle_buffer, info.particle_count, info.camera, &info.extent);
+    m_statistics->begin(cmd, info.current_frame);
+    if (info.views.empty()) {
+        render(cmd, info.particle_buffer, info.particle_count, info.camera, &info.extent);
+    } else {
+        render_views(cmd, info.particle_buffer, info.particle_count, info.views);
+    }
+    m_statistics->end(cmd, info.current_frame);
+
+    if (m_overdraw_this_frame) {
+        m_overdraw->record_resolve(cmd);
+    }
 
     // Render ImGui if provided
     if (info.imgui_draw_data) {
@@ -1,71 +1,45 @@
 #include <ifs/frontends/SphereRenderer.hpp>
 #include <ifs/Logger.hpp>
+#include <ifs/StartupTrace.hpp>
 #include <imgui.h>
 #include <imgui_impl_vulkan.h>
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <format>
 #include <glm/gtc/matrix_transform.hpp>
+#include <limits>
 #include <unordered_map>
+#include <utility>
 
 namespace ifs {
 
-SphereRenderer::SphereRenderer(const VulkanContext& context, vk::Device device)
-    : m_context(&context)
-    , m_device(device)
-    , m_render_pass(nullptr)
-    , m_extent{}
-    , m_pipeline_layout(nullptr)
-    , m_graphics_pipeline(nullptr)
-    , m_descriptor_layout(nullptr)
-    , m_descriptor_pool(nullptr)
-    , m_descriptor_set(nullptr)
-    , m_vertex_buffer(nullptr)
-    , m_vertex_memory(nullptr)
-    , m_index_buffer(nullptr)
-    , m_index_memory(nullptr)
-    , m_view_buffer(nullptr)
-    , m_view_memory(nullptr)
-    , m_graphics_command_pool(nullptr)
-{}
+namespace {
 
-SphereRenderer::~SphereRenderer() {
-    // Cleanup graphics infrastructure (Phase 3: frontend owns these)
-    for (auto fence : m_in_flight_fences) {
-        m_device.destroyFence(fence);
-    }
-    for (auto sem : m_render_finished_semaphores) {
-        m_device.destroySemaphore(sem);
-    }
-    if (m_graphics_command_pool) {
-        m_device.destroyCommandPool(m_graphics_command_pool);
-    }
-
-    // Cleanup view buffer
-    if (m_view_memory) {
-        if (m_view_mapped) {
-            m_device.unmapMemory(m_view_memory);
-        }
-        m_device.freeMemory(m_view_memory);
-    }
-    if (m_view_buffer) {
-        m_device.destroyBuffer(m_view_buffer);
-    }
+// Projected radius (pixels) below which each LOD is drawn: points, octahedron,
+// icospheres 0-3; icosphere 4 takes the rest
+constexpr std::array<float, SphereRenderer::LOD_COUNT - 1> LOD_MAX_RADII = {1.0f, 2.0f, 4.0f, 8.0f, 16.0f, 32.0f};
 
-    // Cleanup sphere buffers
-    if (m_index_memory) m_device.freeMemory(m_index_memory);
-    if (m_index_buffer) m_device.destroyBuffer(m_index_buffer);
-    if (m_vertex_memory) m_device.freeMemory(m_vertex_memory);
-    if (m_vertex_buffer) m_device.destroyBuffer(m_vertex_buffer);
+// The point LOD and the first mesh after it
+constexpr uint32_t POINT_LOD = 0;
+constexpr uint32_t FIRST_ICOSPHERE_LOD = 2;
 
-    // Cleanup descriptor sets
-    if (m_descriptor_pool) m_device.destroyDescriptorPool(m_descriptor_pool);
-    if (m_descriptor_layout) m_device.destroyDescriptorSetLayout(m_descriptor_layout);
+struct UnitSphereMesh {
+    std::vector<glm::vec3> positions;
+    std::vector<uint32_t> indices;
+};
 
-    // Cleanup pipeline
-    if (m_graphics_pipeline) m_device.destroyPipeline(m_graphics_pipeline);
-    if (m_pipeline_layout) m_device.destroyPipelineLayout(m_pipeline_layout);
+UnitSphereMesh octahedron() {
+    return {
+        .positions = {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}},
+        .indices = {
+            0, 2, 4,   2, 1, 4,   1, 3, 4,   3, 0, 4,
+            2, 0, 5,   1, 2, 5,   3, 1, 5,   0, 3, 5
+        }
+    };
 }
 
-void SphereRenderer::generate_sphere_mesh(uint32_t subdivisions) {
+UnitSphereMesh icosphere(uint32_t subdivisions) {
     // Generate an icosphere using subdivision
     // Start with an icosahedron and subdivide
 
@@ -139,22 +113,100 @@ void SphereRenderer::generate_sphere_mesh(uint32_t subdivisions) {
         indices = std::move(new_indices);
     }
 
-    // Build final vertex buffer with positions and normals
-    m_sphere_vertices.clear();
-    m_sphere_vertices.reserve(positions.size());
-    for (const auto& pos : positions) {
-        m_sphere_vertices.push_back({pos, pos}); // normal = position for unit sphere
+    return {.positions = std::move(positions), .indices = std::move(indices)};
+}
+
+} // anonymous namespace
+
+SphereRenderer::SphereRenderer(const VulkanContext& context, vk::Device device)
+    : m_context(&context)
+    , m_device(device)
+    , m_render_pass(nullptr)
+    , m_extent{}
+    , m_pipeline_layout(nullptr)
+    , m_culled_pipeline_layout(nullptr)
+    , m_descriptor_layout(nullptr)
+    , m_descriptor_pool(nullptr)
+    , m_vertex_buffer(nullptr)
+    , m_vertex_memory(nullptr)
+    , m_index_buffer(nullptr)
+    , m_index_memory(nullptr)
+    , m_view_buffer(nullptr)
+    , m_view_memory(nullptr)
+    , m_graphics_command_pool(nullptr)
+{}
+
+SphereRenderer::~SphereRenderer() {
+    m_pipelines.reset();  // Waits for the optimizing links, which use the layouts
+    m_visibility.reset();
+    m_culler.reset();
+    m_overdraw.reset();
+    m_statistics.reset();
+
+    // Cleanup graphics infrastructure (Phase 3: frontend owns these)
+    for (auto fence : m_in_flight_fences) {
+        m_device.destroyFence(fence);
+    }
+    for (auto sem : m_render_finished_semaphores) {
+        m_device.destroySemaphore(sem);
     }
+    if (m_graphics_command_pool) {
+        m_device.destroyCommandPool(m_graphics_command_pool);
+    }
+
+    // Cleanup view buffer
+    if (m_view_memory) {
+        if (m_view_mapped) {
+            m_device.unmapMemory(m_view_memory);
+        }
+        m_device.freeMemory(m_view_memory);
+    }
+    if (m_view_buffer) {
+        m_device.destroyBuffer(m_view_buffer);
+    }
+
+    destroy_sphere_buffers();
 
-    m_sphere_indices = std::move(indices);
+    // Cleanup descriptor sets
+    if (m_descriptor_pool) m_device.destroyDescriptorPool(m_descriptor_pool);
+    if (m_descriptor_layout) m_device.destroyDescriptorSetLayout(m_descriptor_layout);
 
-    Logger::instance().info("Generated sphere mesh: {} vertices, {} indices",
-        m_sphere_vertices.size(), m_sphere_indices.size());
+    // Cleanup pipeline
+    if (m_pipeline_layout) m_device.destroyPipelineLayout(m_pipeline_layout);
+    if (m_culled_pipeline_layout) m_device.destroyPipelineLayout(m_culled_pipeline_layout);
 }
 
-std::expected<void, std::string> SphereRenderer::create_sphere_buffers() {
-    auto physical_device = m_context->physical_device();
+void SphereRenderer::generate_sphere_meshes() {
+    m_sphere_vertices.clear();
+    m_sphere_indices.clear();
+    m_lods.clear();
+
+    auto append = [this](const UnitSphereMesh& mesh, float max_radius) {
+        m_lods.push_back(LodMesh{
+            .first_index = static_cast<uint32_t>(m_sphere_indices.size()),
+            .index_count = static_cast<uint32_t>(mesh.indices.size()),
+            .vertex_offset = static_cast<int32_t>(m_sphere_vertices.size()),
+            .max_radius = max_radius
+        });
+        for (const auto& pos : mesh.positions) {
+            m_sphere_vertices.push_back({pos, pos}); // normal = position for unit sphere
+        }
+        m_sphere_indices.insert(m_sphere_indices.end(), mesh.indices.begin(), mesh.indices.end());
+    };
+
+    // Points: a single index (of the octahedron); main_culled_point ignores the vertex
+    m_lods.push_back(LodMesh{.index_count = 1, .max_radius = LOD_MAX_RADII[POINT_LOD]});
+    append(octahedron(), LOD_MAX_RADII[1]);
+    for (uint32_t subdivisions = 0; subdivisions <= MAX_SPHERE_SUBDIVISIONS; subdivisions++) {
+        const uint32_t lod = FIRST_ICOSPHERE_LOD + subdivisions;
+        append(icosphere(subdivisions), lod < LOD_MAX_RADII.size() ? LOD_MAX_RADII[lod] : std::numeric_limits<float>::infinity());
+    }
+
+    Logger::instance().info("Generated {} sphere LODs: {} vertices, {} indices",
+        m_lods.size(), m_sphere_vertices.size(), m_sphere_indices.size());
+}
 
+std::expected<void, std::string> SphereRenderer::create_sphere_buffers() {
     // Create vertex buffer
     vk::DeviceSize vertex_size = sizeof(Vertex) * m_sphere_vertices.size();
 
@@ -173,17 +225,7 @@ std::expected<void, std::string> SphereRenderer::create_sphere_buffers() {
     auto vertex_mem_reqs = m_device.getBufferMemoryRequirements(m_vertex_buffer);
     auto vertex_mem_props = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
 
-    auto find_memory_type = [&](uint32_t type_filter, vk::MemoryPropertyFlags properties) -> std::optional<uint32_t> {
-        auto mem_props = physical_device.getMemoryProperties();
-        for (uint32_t i = 0; i < mem_props.memoryTypeCount; i++) {
-            if ((type_filter & (1 << i)) && (mem_props.memoryTypes[i].propertyFlags & properties) == properties) {
-                return i;
-            }
-        }
-        return std::nullopt;
-    };
-
-    auto vertex_mem_type = find_memory_type(vertex_mem_reqs.memoryTypeBits, vertex_mem_props);
+    auto vertex_mem_type = m_context->find_memory_type(vertex_mem_reqs.memoryTypeBits, vertex_mem_props);
     if (!vertex_mem_type) {
         return std::unexpected("Failed to find suitable memory type for vertex buffer");
     }
@@ -227,7 +269,7 @@ std::expected<void, std::string> SphereRenderer::create_sphere_buffers() {
 	m_index_buffer = index_buffer_res.value;
 
     auto index_mem_reqs = m_device.getBufferMemoryRequirements(m_index_buffer);
-    auto index_mem_type = find_memory_type(index_mem_reqs.memoryTypeBits, vertex_mem_props);
+    auto index_mem_type = m_context->find_memory_type(index_mem_reqs.memoryTypeBits, vertex_mem_props);
     if (!index_mem_type) {
         return std::unexpected("Failed to find suitable memory type for index buffer");
     }
@@ -258,20 +300,50 @@ std::expected<void, std::string> SphereRenderer::create_sphere_buffers() {
     return {};
 }
 
+bool SphereRenderer::ensure_sphere_mesh() {
+    if (m_index_memory) {
+        return true;
+    }
+    if (m_sphere_mesh_attempted) {
+        return false;  // Failed before, already logged
+    }
+    m_sphere_mesh_attempted = true;
+
+    generate_sphere_meshes();
+    if (auto result = create_sphere_buffers(); !result) {
+        Logger::instance().error("Failed to create sphere mesh buffers: {}", result.error());
+        destroy_sphere_buffers();
+        return false;
+    }
+    return true;
+}
+
+void SphereRenderer::destroy_sphere_buffers() {
+    if (m_index_memory) m_device.freeMemory(m_index_memory);
+    if (m_index_buffer) m_device.destroyBuffer(m_index_buffer);
+    if (m_vertex_memory) m_device.freeMemory(m_vertex_memory);
+    if (m_vertex_buffer) m_device.destroyBuffer(m_vertex_buffer);
+    m_index_memory = nullptr;
+    m_index_buffer = nullptr;
+    m_vertex_memory = nullptr;
+    m_vertex_buffer = nullptr;
+}
+
 std::expected<void, std::string> SphereRenderer::create_descriptor_layout() {
-    // Binding 0: View parameters (uniform buffer)
+    // Binding 0: View parameters (uniform buffer); compute for the visibility shading pass
     auto view_binding = vk::DescriptorSetLayoutBinding()
         .setBinding(0)
         .setDescriptorType(vk::DescriptorType::eUniformBuffer)
         .setDescriptorCount(1)
-        .setStageFlags(vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment);
+        .setStageFlags(vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment |
+                       vk::ShaderStageFlagBits::eCompute);
 
     // Binding 1: Particle positions (storage buffer)
     auto particle_binding = vk::DescriptorSetLayoutBinding()
         .setBinding(1)
         .setDescriptorType(vk::DescriptorType::eStorageBuffer)
         .setDescriptorCount(1)
-        .setStageFlags(vk::ShaderStageFlagBits::eVertex);
+        .setStageFlags(vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eCompute);
 
     std::array bindings = {view_binding, particle_binding};
 
@@ -289,6 +361,8 @@ std::expected<void, std::string> SphereRenderer::create_descriptor_layout() {
 }
 
 std::expected<void, std::string> SphereRenderer::create_pipeline() {
+    auto trace_scope = StartupTrace::instance().phase("pipeline:SphereRenderer");
+
     // Pipeline layout
     auto pipeline_layout_info = vk::PipelineLayoutCreateInfo()
         .setSetLayouts(m_descriptor_layout);
@@ -404,25 +478,151 @@ std::expected<void, std::string> SphereRenderer::create_pipeline() {
         .setRenderPass(m_render_pass)
         .setSubpass(0);
 
-	auto pipeline_res = m_device.createGraphicsPipeline(nullptr, pipeline_info);
-	if (pipeline_res.result != vk::Result::eSuccess)
-	{
-		return std::unexpected(std::format("Failed to create graphics pipeline: {}", to_string(pipeline_res.result)));
-	}
-	m_graphics_pipeline = pipeline_res.value;
+    // Variants share parts with this one; each is fast-linked here and optimized in the background
+    auto library_result = PipelineLibrary::create(*m_context);
+    if (!library_result) {
+        return std::unexpected(library_result.error());
+    }
+    m_pipelines = std::move(*library_result);
+
+    auto pipeline_res = m_pipelines->add(pipeline_info);
+    if (!pipeline_res) {
+        return std::unexpected(pipeline_res.error());
+    }
+    m_graphics_pipeline = *pipeline_res;
+
+    // Culled variant: same state, the vertex stage reads the culler's draw list (set 1)
+    // at the LOD bucket given by the push constant
+    if (m_culler) {
+        std::array culled_set_layouts = {m_descriptor_layout, m_culler->draw_set_layout()};
+        auto lod_range = vk::PushConstantRange()
+            .setStageFlags(vk::ShaderStageFlagBits::eVertex)
+            .setOffset(0)
+            .setSize(sizeof(uint32_t));
+        auto culled_layout_info = vk::PipelineLayoutCreateInfo()
+            .setSetLayouts(culled_set_layouts)
+            .setPushConstantRanges(lod_range);
+
+		auto culled_layout_res = m_device.createPipelineLayout(culled_layout_info);
+		if (culled_layout_res.result != vk::Result::eSuccess)
+		{
+			return std::unexpected(std::format("Failed to create culled pipeline layout: {}", to_string(culled_layout_res.result)));
+		}
+		m_culled_pipeline_layout = culled_layout_res.value;
+
+        std::array culled_stages = {m_culled_vertex_shader->create_pipeline_shader_stage_create_info(), frag_stage};
+        auto culled_pipeline_info = pipeline_info;
+        culled_pipeline_info
+            .setStages(culled_stages)
+            .setLayout(m_culled_pipeline_layout);
+
+        auto culled_pipeline_res = m_pipelines->add(culled_pipeline_info);
+        if (!culled_pipeline_res) {
+            return std::unexpected(std::format("Failed to create culled graphics pipeline: {}", culled_pipeline_res.error()));
+        }
+        m_culled_pipeline = *culled_pipeline_res;
+
+        // Sub-pixel LOD: one point per instance
+        auto point_assembly = vk::PipelineInputAssemblyStateCreateInfo()
+            .setTopology(vk::PrimitiveTopology::ePointList)
+            .setPrimitiveRestartEnable(false);
+        std::array point_stages = {m_point_vertex_shader->create_pipeline_shader_stage_create_info(), frag_stage};
+        auto point_pipeline_info = culled_pipeline_info;
+        point_pipeline_info
+            .setStages(point_stages)
+            .setPInputAssemblyState(&point_assembly);
+
+        auto point_pipeline_res = m_pipelines->add(point_pipeline_info);
+        if (!point_pipeline_res) {
+            return std::unexpected(std::format("Failed to create point LOD pipeline: {}", point_pipeline_res.error()));
+        }
+        m_point_pipeline = *point_pipeline_res;
+    }
+
+    // Overdraw variant of this pipeline (optional debug feature)
+    if (OverdrawHeatmap::supported(*m_context)) {
+        auto overdraw_result = OverdrawHeatmap::create(*m_context, pipeline_info, m_descriptor_layout);
+        if (overdraw_result) {
+            m_overdraw = std::move(*overdraw_result);
+        } else {
+            Logger::instance().warn("Overdraw heatmap unavailable: {}", overdraw_result.error());
+        }
+    }
+
+    // Visibility-buffer variants (optional: without them shading stays forward)
+    if (auto result = create_visibility_pipelines(pipeline_info); !result) {
+        Logger::instance().warn("Visibility buffer unavailable: {}", result.error());
+    }
+
+    return {};
+}
+
+std::expected<void, std::string> SphereRenderer::create_visibility_pipelines(const vk::GraphicsPipelineCreateInfo& pipeline_info) {
+    auto visibility_result = VisibilityBuffer::create(
+        *m_context, pipeline_info, m_descriptor_layout, "ifs_modular/frontends/sphere/shade.slang");
+    if (!visibility_result) {
+        return std::unexpected(visibility_result.error());
+    }
+
+    auto frag_result = Shader::create_shader(m_device, "ifs_modular/frontends/sphere/visibility.frag.slang", "main");
+    if (!frag_result) {
+        return std::unexpected(std::format("Failed to load visibility fragment shader: {}", frag_result.error()));
+    }
+    m_visibility_fragment_shader = std::make_unique<Shader>(std::move(*frag_result));
+    auto frag_stage = m_visibility_fragment_shader->create_pipeline_shader_stage_create_info();
+
+    // Same geometry and depth state as the forward pipelines; only the fragment
+    // stage (particle index instead of color) and the render pass differ
+    auto point_assembly = vk::PipelineInputAssemblyStateCreateInfo()
+        .setTopology(vk::PrimitiveTopology::ePointList)
+        .setPrimitiveRestartEnable(false);
+
+    struct Variant {
+        PipelineLibrary::Handle* pipeline;
+        const Shader* vertex_shader;
+        vk::PipelineLayout layout;
+        const vk::PipelineInputAssemblyStateCreateInfo* input_assembly;
+    };
+    std::vector<Variant> variants = {
+        {&m_visibility_pipeline, m_vertex_shader.get(), m_pipeline_layout, pipeline_info.pInputAssemblyState}
+    };
+    if (m_culler) {
+        variants.push_back({&m_visibility_culled_pipeline, m_culled_vertex_shader.get(), m_culled_pipeline_layout,
+                            pipeline_info.pInputAssemblyState});
+        variants.push_back({&m_visibility_point_pipeline, m_point_vertex_shader.get(), m_culled_pipeline_layout,
+                            &point_assembly});
+    }
+
+    for (const auto& variant : variants) {
+        std::array stages = {variant.vertex_shader->create_pipeline_shader_stage_create_info(), frag_stage};
+        auto variant_info = pipeline_info;
+        variant_info
+            .setStages(stages)
+            .setPInputAssemblyState(variant.input_assembly)
+            .setLayout(variant.layout)
+            .setRenderPass((*visibility_result)->render_pass())
+            .setSubpass(0);
+
+        auto pipeline_res = m_pipelines->add(variant_info);
+        if (!pipeline_res) {
+            return std::unexpected(std::format("Failed to create visibility pipeline: {}", pipeline_res.error()));
+        }
+        *variant.pipeline = *pipeline_res;
+    }
 
+    m_visibility = std::move(*visibility_result);
     return {};
 }
 
 std::expected<void, std::string> SphereRenderer::create_descriptor_set() {
-    // Create descriptor pool
+    // Create descriptor pool: one set per split-screen view
     std::array pool_sizes = {
-        vk::DescriptorPoolSize(vk::DescriptorType::eUniformBuffer, 1),
-        vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, 1)
+        vk::DescriptorPoolSize(vk::DescriptorType::eUniformBuffer, MAX_FRAME_VIEWS),
+        vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, MAX_FRAME_VIEWS)
     };
 
     auto pool_info = vk::DescriptorPoolCreateInfo()
-        .setMaxSets(1)
+        .setMaxSets(MAX_FRAME_VIEWS)
         .setPoolSizes(pool_sizes);
 
 	auto descriptor_pool_res = m_device.createDescriptorPool(pool_info);
@@ -432,32 +632,36 @@ std::expected<void, std::string> SphereRenderer::create_descriptor_set() {
 	}
 	m_descriptor_pool = descriptor_pool_res.value;
 
-    // Allocate descriptor set
+    // Allocate descriptor sets
+    std::array<vk::DescriptorSetLayout, MAX_FRAME_VIEWS> set_layouts;
+    set_layouts.fill(m_descriptor_layout);
     auto alloc_info = vk::DescriptorSetAllocateInfo()
         .setDescriptorPool(m_descriptor_pool)
-        .setSetLayouts(m_descriptor_layout);
+        .setSetLayouts(set_layouts);
 
 	auto descriptor_set_res = m_device.allocateDescriptorSets(alloc_info);
 	if (descriptor_set_res.result != vk::Result::eSuccess)
 	{
 		return std::unexpected(std::format("Failed to allocate descriptor set: {}", to_string(descriptor_set_res.result)));
 	}
-	m_descriptor_set = descriptor_set_res.value[0];
-
-    // Update view buffer binding (particle buffer will be updated per frame)
-    auto view_buffer_info = vk::DescriptorBufferInfo()
-        .setBuffer(m_view_buffer)
-        .setOffset(0)
-        .setRange(sizeof(ViewParams));
-
-    auto view_write = vk::WriteDescriptorSet()
-        .setDstSet(m_descriptor_set)
-        .setDstBinding(0)
-        .setDstArrayElement(0)
-        .setDescriptorType(vk::DescriptorType::eUniformBuffer)
-        .setBufferInfo(view_buffer_info);
-
-    m_device.updateDescriptorSets(view_write, nullptr);
+    std::ranges::copy(descriptor_set_res.value, m_descriptor_sets.begin());
+
+    // Update view buffer binding, each set its view's slot (particle buffer will be updated per frame)
+    for (uint32_t view = 0; view < MAX_FRAME_VIEWS; view++) {
+        auto view_buffer_info = vk::DescriptorBufferInfo()
+            .setBuffer(m_view_buffer)
+            .setOffset(view * m_view_stride)
+            .setRange(sizeof(ViewParams));
+
+        auto view_write = vk::WriteDescriptorSet()
+            .setDstSet(m_descriptor_sets[view])
+            .setDstBinding(0)
+            .setDstArrayElement(0)
+            .setDescriptorType(vk::DescriptorType::eUniformBuffer)
+            .setBufferInfo(view_buffer_info);
+
+        m_device.updateDescriptorSets(view_write, nullptr);
+    }
 
     return {};
 }
@@ -472,14 +676,7 @@ std::expected<std::unique_ptr<SphereRenderer>, std::string> SphereRenderer::crea
     auto renderer = std::unique_ptr<SphereRenderer>(new SphereRenderer(context, device));
     renderer->m_render_pass = render_pass;
     renderer->m_extent = extent;
-
-    // Generate sphere mesh
-    renderer->generate_sphere_mesh(sphere_subdivisions);
-
-    // Create sphere buffers
-    if (auto result = renderer->create_sphere_buffers(); !result) {
-        return std::unexpected(result.error());
-    }
+    renderer->m_sphere_subdivisions = std::min(sphere_subdivisions, MAX_SPHERE_SUBDIVISIONS);  // Mesh is built on the first frame
 
     // Load shaders
     auto vert_result = Shader::create_shader(device, "ifs_modular/frontends/sphere/sphere.vert.slang", "main");
@@ -494,9 +691,11 @@ std::expected<std::unique_ptr<SphereRenderer>, std::string> SphereRenderer::crea
     }
     renderer->m_fragment_shader = std::make_unique<Shader>(std::move(*frag_result));
 
-    // Create view parameter buffer
+    // Create view parameter buffer: one ViewParams slot per split-screen view
+    const vk::DeviceSize alignment = context.physical_device().getProperties().limits.minUniformBufferOffsetAlignment;
+    renderer->m_view_stride = (sizeof(ViewParams) + alignment - 1) / alignment * alignment;
     auto buffer_info = vk::BufferCreateInfo()
-        .setSize(sizeof(ViewParams))
+        .setSize(MAX_FRAME_VIEWS * renderer->m_view_stride)
         .setUsage(vk::BufferUsageFlagBits::eUniformBuffer)
         .setSharingMode(vk::SharingMode::eExclusive);
 
@@ -509,18 +708,8 @@ std::expected<std::unique_ptr<SphereRenderer>, std::string> SphereRenderer::crea
 
     // Allocate and map view buffer memory
     auto mem_reqs = device.getBufferMemoryRequirements(renderer->m_view_buffer);
-    auto mem_props = context.physical_device().getMemoryProperties();
-
-    std::optional<uint32_t> memory_type;
-    auto required_props = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
-    for (uint32_t i = 0; i < mem_props.memoryTypeCount; i++) {
-        if ((mem_reqs.memoryTypeBits & (1 << i)) &&
-            (mem_props.memoryTypes[i].propertyFlags & required_props) == required_props) {
-            memory_type = i;
-            break;
-        }
-    }
-
+    auto memory_type = context.find_memory_type(mem_reqs.memoryTypeBits,
+        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
     if (!memory_type) {
         return std::unexpected("Failed to find suitable memory type for view buffer");
     }
@@ -540,7 +729,7 @@ std::expected<std::unique_ptr<SphereRenderer>, std::string> SphereRenderer::crea
 	{
 		return std::unexpected(std::format("Failed to bind view memory: {}", to_string(view_bind_res)));
 	}
-	auto view_map_res = device.mapMemory(renderer->m_view_memory, 0, sizeof(ViewParams));
+	auto view_map_res = device.mapMemory(renderer->m_view_memory, 0, VK_WHOLE_SIZE);
 	CHECK_VK_RESULT(view_map_res, "Failed to map memory for view {}");
 	renderer->m_view_mapped = view_map_res.value;
 
@@ -549,6 +738,23 @@ std::expected<std::unique_ptr<SphereRenderer>, std::string> SphereRenderer::crea
         return std::unexpected(result.error());
     }
 
+    // Occlusion culling and LOD (optional: without them every instance is drawn with one mesh)
+    auto culled_vert_result = Shader::create_shader(device, "ifs_modular/frontends/sphere/sphere.vert.slang", "main_culled");
+    auto point_vert_result = Shader::create_shader(device, "ifs_modular/frontends/sphere/sphere.vert.slang", "main_culled_point");
+    if (culled_vert_result && point_vert_result) {
+        auto culler_result = OcclusionCuller::create(context, SphereRenderer::MAX_FRAMES_IN_FLIGHT);
+        if (culler_result) {
+            renderer->m_culled_vertex_shader = std::make_unique<Shader>(std::move(*culled_vert_result));
+            renderer->m_point_vertex_shader = std::make_unique<Shader>(std::move(*point_vert_result));
+            renderer->m_culler = std::move(*culler_result);
+        } else {
+            Logger::instance().warn("Occlusion culling unavailable: {}", culler_result.error());
+        }
+    } else {
+        Logger::instance().warn("Occlusion culling unavailable: {}",
+            culled_vert_result ? point_vert_result.error() : culled_vert_result.error());
+    }
+
     // Create pipeline
     if (auto result = renderer->create_pipeline(); !result) {
         return std::unexpected(result.error());
@@ -603,6 +809,12 @@ std::expected<std::unique_ptr<SphereRenderer>, std::string> SphereRenderer::crea
 
     renderer->m_images_in_flight.resize(1, nullptr);  // Placeholder
 
+    auto statistics_result = PipelineStatisticsQuery::create(context, SphereRenderer::MAX_FRAMES_IN_FLIGHT);
+    if (!statistics_result) {
+        return std::unexpected(statistics_result.error());
+    }
+    renderer->m_statistics = std::move(*statistics_result);
+
     Logger::instance().info("SphereRenderer created successfully");
 
     return renderer;
@@ -619,59 +831,169 @@ void SphereRenderer::update_particle_buffer(vk::Buffer particle_buffer) {
         .setOffset(0)
         .setRange(VK_WHOLE_SIZE);
 
-    auto particle_write = vk::WriteDescriptorSet()
-        .setDstSet(m_descriptor_set)
-        .setDstBinding(1)
-        .setDstArrayElement(0)
-        .setDescriptorType(vk::DescriptorType::eStorageBuffer)
-        .setBufferInfo(particle_buffer_info);
+    for (auto set : m_descriptor_sets) {
+        auto particle_write = vk::WriteDescriptorSet()
+            .setDstSet(set)
+            .setDstBinding(1)
+            .setDstArrayElement(0)
+            .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+            .setBufferInfo(particle_buffer_info);
+
+        m_device.updateDescriptorSets(particle_write, nullptr);
+    }
 
-    m_device.updateDescriptorSets(particle_write, nullptr);
+    if (m_culler) {
+        m_culler->update_particle_buffer(particle_buffer);
+    }
 }
 
-void SphereRenderer::render(
+void SphereRenderer::record_pre_pass(
     vk::CommandBuffer cmd,
     [[maybe_unused]] vk::Buffer particle_buffer,
     uint32_t particle_count,
     Camera& camera,
-    const vk::Extent2D* extent
+    const vk::Extent2D& extent
 ) {
-    // Use provided extent or fallback to stored extent
-    vk::Extent2D render_extent = extent ? *extent : m_extent;
-    // Update view parameters
+    m_culled_this_frame = false;
+    m_visibility_this_frame = false;
+    if ((m_show_overdraw && m_overdraw) || !ensure_sphere_mesh()) {
+        return;
+    }
+
+    if (occlusion_culling() || sphere_lod()) {
+        // Without LOD, the one bucket draws the fixed mesh
+        m_culled_lod = sphere_lod();
+        auto lods = m_culled_lod ? std::span(m_lods)
+                                 : std::span(m_lods).subspan(FIRST_ICOSPHERE_LOD + m_sphere_subdivisions, 1);
+
+        // The slot's previous frame has completed (render_frame() waited on its fence)
+        m_culler->collect(m_frame_slot);
+        m_culled_this_frame = m_culler->record_cull(
+            cmd, m_frame_slot, particle_count, camera.view_projection_matrix(), m_sphere_radius, extent,
+            lods, occlusion_culling());
+    }
+
+    // Visibility pass and shading run before the frontend's render pass; render() composites
+    if (visibility_shading() && m_visibility->begin(cmd, extent)) {
+        update_view_params(camera);
+        set_viewport(cmd, vk::Rect2D({0, 0}, extent));
+        record_spheres(cmd, particle_count, true);
+        m_visibility->end_and_shade(cmd, m_descriptor_sets[0]);
+        m_visibility_this_frame = true;
+    }
+}
+
+void SphereRenderer::update_view_params(Camera& camera, uint32_t view) {
     ViewParams params{};
     params.view_projection = camera.view_projection_matrix();
     params.camera_pos = camera.position();
     params.sphere_radius = m_sphere_radius;
     params.light_dir = glm::normalize(glm::vec3(1.0f, 1.0f, 1.0f));
+    params.inverse_view_projection = glm::inverse(params.view_projection);
 
-    std::memcpy(m_view_mapped, &params, sizeof(ViewParams));
+    std::memcpy(static_cast<std::byte*>(m_view_mapped) + view * m_view_stride, &params, sizeof(ViewParams));
+}
 
-    // Set viewport and scissor
+void SphereRenderer::set_viewport(vk::CommandBuffer cmd, const vk::Rect2D& area) {
     // Use negative height to flip Y-axis (Vulkan convention)
     auto viewport = vk::Viewport()
-        .setX(0.0f)
-        .setY(static_cast<float>(render_extent.height))  // Start at bottom
-        .setWidth(static_cast<float>(render_extent.width))
-        .setHeight(-static_cast<float>(render_extent.height))  // Negative = Y-flip
+        .setX(static_cast<float>(area.offset.x))
+        .setY(static_cast<float>(area.offset.y + area.extent.height))  // Start at bottom
+        .setWidth(static_cast<float>(area.extent.width))
+        .setHeight(-static_cast<float>(area.extent.height))  // Negative = Y-flip
         .setMinDepth(0.0f)
         .setMaxDepth(1.0f);
 
-    auto scissor = vk::Rect2D()
-        .setOffset({0, 0})
-        .setExtent(render_extent);
-
     cmd.setViewport(0, viewport);
-    cmd.setScissor(0, scissor);
+    cmd.setScissor(0, area);
+}
 
-    // Bind pipeline and draw instanced
-    cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, m_graphics_pipeline);
-    cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_pipeline_layout, 0, m_descriptor_set, {});
+void SphereRenderer::record_spheres(vk::CommandBuffer cmd, uint32_t particle_count, bool visibility, uint32_t view) {
     cmd.bindVertexBuffers(0, m_vertex_buffer, vk::DeviceSize{0});
     cmd.bindIndexBuffer(m_index_buffer, 0, vk::IndexType::eUint32);
 
+    // Culled: draw the survivors of record_pre_pass(), one indirect draw per LOD bucket
+    if (m_culled_this_frame) {
+        cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_culled_pipeline_layout, 0, m_descriptor_sets[view], {});
+        const uint32_t bucket_count = m_culled_lod ? LOD_COUNT : 1;
+        for (uint32_t lod = 0; lod < bucket_count; lod++) {
+            if (lod == 0 || lod == POINT_LOD + 1) {
+                const bool points = m_culled_lod && lod == POINT_LOD;
+                auto pipeline = points ? (visibility ? m_visibility_point_pipeline : m_point_pipeline)
+                                       : (visibility ? m_visibility_culled_pipeline : m_culled_pipeline);
+                cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, m_pipelines->pipeline(pipeline));
+            }
+            cmd.pushConstants<uint32_t>(m_culled_pipeline_layout, vk::ShaderStageFlagBits::eVertex, 0, lod);
+            m_culler->record_draw(cmd, m_culled_pipeline_layout, lod);
+        }
+        return;
+    }
+
+    // Bind pipeline and draw instanced
+    if (m_overdraw_this_frame && !visibility) {
+        m_overdraw->bind_count_pipeline(cmd, m_descriptor_sets[view]);
+    } else {
+        cmd.bindPipeline(vk::PipelineBindPoint::eGraphics,
+                         m_pipelines->pipeline(visibility ? m_visibility_pipeline : m_graphics_pipeline));
+        cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_pipeline_layout, 0, m_descriptor_sets[view], {});
+    }
+
     // Draw instanced: one sphere instance per particle
-    cmd.drawIndexed(static_cast<uint32_t>(m_sphere_indices.size()), particle_count, 0, 0, 0);
+    const auto& mesh = m_lods[FIRST_ICOSPHERE_LOD + m_sphere_subdivisions];
+    cmd.drawIndexed(mesh.index_count, particle_count, mesh.first_index, mesh.vertex_offset, 0);
+}
+
+void SphereRenderer::render(
+    vk::CommandBuffer cmd,
+    [[maybe_unused]] vk::Buffer particle_buffer,
+    uint32_t particle_count,
+    Camera& camera,
+    const vk::Extent2D* extent
+) {
+    // Use provided extent or fallback to stored extent
+    vk::Extent2D render_extent = extent ? *extent : m_extent;
+    record_view(cmd, particle_count, camera, vk::Rect2D({0, 0}, render_extent));
+}
+
+void SphereRenderer::render_views(
+    vk::CommandBuffer cmd,
+    [[maybe_unused]] vk::Buffer particle_buffer,
+    uint32_t particle_count,
+    std::span<const FrameView> views
+) {
+    if (views.size() == 1) {
+        record_view(cmd, particle_count, *views.front().camera, views.front().area);
+        return;
+    }
+
+    // Split: no pre-pass ran, so each view draws every instance with its own view buffer slot
+    if (!ensure_sphere_mesh()) {
+        return;
+    }
+    for (uint32_t view = 0; view < views.size(); view++) {
+        update_view_params(*views[view].camera, view);
+        set_viewport(cmd, views[view].area);
+        record_spheres(cmd, particle_count, false, view);
+    }
+}
+
+void SphereRenderer::record_view(vk::CommandBuffer cmd, uint32_t particle_count, Camera& camera, const vk::Rect2D& area) {
+    update_view_params(camera);
+    set_viewport(cmd, area);
+
+    if (!ensure_sphere_mesh()) {
+        return;
+    }
+
+    // Shaded by record_pre_pass(): only the composite is left
+    if (std::exchange(m_visibility_this_frame, false)) {
+        m_culled_this_frame = false;
+        m_visibility->record_composite(cmd, area.offset);
+        return;
+    }
+
+    record_spheres(cmd, particle_count, false);
+    m_culled_this_frame = false;
 }
 
 vk::Semaphore SphereRenderer::render_frame(
@@ -689,6 +1011,10 @@ vk::Semaphore SphereRenderer::render_frame(
     m_images_in_flight[info.image_index] = m_in_flight_fences[info.current_frame];
     m_device.resetFences(m_in_flight_fences[info.current_frame]);
 
+    // The frame's previous statistics query has completed with its fence
+    m_statistics->collect(info.current_frame, info.extent.width * info.extent.height);
+    m_frame_slot = info.current_frame;
+
     // Record command buffer
     auto& cmd = m_command_buffers[info.image_index];
     auto _ = cmd.reset();
@@ -700,7 +1026,7 @@ vk::Semaphore SphereRenderer::render_frame(
         // Queue family ownership transfer barrier
         auto barrier = vk::BufferMemoryBarrier()
             .setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
-            .setDstAccessMask(vk::AccessFlagBits::eVertexAttributeRead)
+            .setDstAccessMask(vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eShaderRead)
             .setSrcQueueFamilyIndex(info.compute_queue_family)
             .setDstQueueFamilyIndex(info.graphics_queue_family)
             .setBuffer(info.particle_buffer)
@@ -709,7 +1035,8 @@ vk::Semaphore SphereRenderer::render_frame(
 
         cmd.pipelineBarrier(
             vk::PipelineStageFlagBits::eComputeShader,
-            vk::PipelineStageFlagBits::eVertexInput,
+            vk::PipelineStageFlagBits::eVertexInput | vk::PipelineStageFlagBits::eVertexShader |
+                vk::PipelineStageFlagBits::eComputeShader,
             {},
             nullptr,
             barrier,
@@ -717,6 +1044,24 @@ vk::Semaphore SphereRenderer::render_frame(
         );
     }
 
+    // Occlusion culling runs in compute, before the render pass. Culling and the
+    // visibility buffer follow one camera, so split frames skip them.
+    if (info.views.size() <= 1) {
+        auto& camera = info.views.empty() ? info.camera : *info.views.front().camera;
+        const auto extent = info.views.empty() ? info.extent : info.views.front().area.extent;
+        record_pre_pass(cmd, info.particle_buffer, info.particle_count, camera, extent);
+    } else {
+        m_culled_this_frame = false;
+        m_visibility_this_frame = false;
+    }
+
+    // Overdraw counters are cleared outside the render pass (not in split frames)
+    m_overdraw_this_frame = m_show_overdraw && m_overdraw && info.views.empty();
+    if (m_overdraw_this_frame) {
+        m_overdraw->record_clear(cmd, info.extent);
+        m_overdraw_this_frame = m_overdraw->ready();
+    }
+
     // Begin render pass
     auto render_pass_begin = vk::RenderPassBeginInfo()
         .setRenderPass(info.render_pass)
@@ -727,7 +1072,17 @@ vk::Semaphore SphereRenderer::render_frame(
     cmd.beginRenderPass(render_pass_begin, vk::SubpassContents::eInline);
 
     // Render spheres (pass the extent to ensure correct viewport/scissor)
-    render(cmd, info.particle_buffer, info.particle_count, info.camera, &info.extent);
+    m_statistics->begin(cmd, info.current_frame);
+    if (info.views.empty()) {
+        render(cmd, info.particle_buffer, info.particle_count, info.camera, &info.extent);
+    } else {
+        render_views(cmd, info.particle_buffer, info.particle_count, info.views);
+    }
+    m_statistics->end(cmd, info.current_frame);
+
+    if (m_overdraw_this_frame) {
+        m_overdraw->record_resolve(cmd);
+    }
 
     // Render ImGui if provided
     if (info.imgui_draw_data) {
@@ -753,6 +1108,27 @@ vk::Semaphore SphereRenderer::render_frame(
     return m_render_finished_semaphores[info.image_index];
 }
 
+std::vector<UICallback> SphereRenderer::get_ui_callbacks() {
+    auto callbacks = diagnostics_ui_callbacks(m_statistics.get(), m_overdraw.get(), m_show_overdraw);
+    if (m_culler) {
+        callbacks.emplace_back("Occlusion Culling", ToggleCallback{
+            .setter = [this](bool v) { m_occlusion_culling = v; },
+            .getter = [this]() { return m_occlusion_culling; }
+        });
+        callbacks.emplace_back("Sphere LOD", ToggleCallback{
+            .setter = [this](bool v) { m_sphere_lod = v; },
+            .getter = [this]() { return m_sphere_lod; }
+        });
+    }
+    if (m_visibility) {
+        callbacks.emplace_back("Visibility Buffer", ToggleCallback{
+            .setter = [this](bool v) { m_visibility_shading = v; },
+            .getter = [this]() { return m_visibility_shading; }
+        });
+    }
+    return callbacks;
+}
+
 void SphereRenderer::handle_swapchain_recreation(uint32_t new_image_count) {
     // Resize command buffers and per-image semaphores
     if (m_command_buffers.size() != new_image_count) {
@@ -785,6 +1161,11 @@ void SphereRenderer::handle_swapchain_recreation(uint32_t new_image_count) {
     }
 
     m_images_in_flight.resize(new_image_count, nullptr);
+
+    // Recreated at the new extent by the next frame that shows it
+    if (m_overdraw) {
+        m_overdraw->handle_swapchain_recreation();
+    }
 }
 
 } // namespace ifs
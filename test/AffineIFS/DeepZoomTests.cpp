@@ -0,0 +1,110 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <ifs/Camera3D.hpp>
+#include <ifs/HeadlessSession.hpp>
+#include <ifs/backends/AffineIFS.hpp>
+#include <cmath>
+#include <set>
+
+using namespace ifs;
+using Catch::Matchers::WithinAbs;
+
+TEST_CASE("Camera3D frame keeps the view while zooming", "[deepzoom]")
+{
+    Camera3D camera;
+    camera.set_target(glm::vec3(0.25f, 0.5f, 0.0f));
+    const glm::dvec3 world = camera.to_world(camera.target());
+
+    camera.zoom_frame(1e6);
+    REQUIRE(camera.target() == glm::vec3(0.0f));
+    REQUIRE(camera.anchor() == world);
+    REQUIRE(camera.extent() == 1e-6);
+    REQUIRE(camera.to_world(glm::vec3(1.0f, 0.0f, 0.0f)).x == world.x + 1e-6);
+    REQUIRE(camera.to_local(world + glm::dvec3(0.0, 2e-6, 0.0)) == glm::vec3(0.0f, 2.0f, 0.0f));
+
+    camera.reset();
+    REQUIRE(camera.anchor() == glm::dvec3(0.0));
+    REQUIRE(camera.extent() == 1.0);
+}
+
+TEST_CASE("deep_zoom_words keeps the pieces in view", "[deepzoom]")
+{
+    const auto triangle = AffineIFSDefinition::sierpinski_triangle();
+
+    SECTION("a wide view keeps the whole attractor")
+    {
+        auto words = deep_zoom_words(triangle, {}, {.anchor = {0.5, 0.4, 0.0}}, 256);
+        REQUIRE(words);
+        double total = 0.0;
+        for (const auto& word : *words) {
+            total += word.probability;
+        }
+        REQUIRE_THAT(total, WithinAbs(1.0, 1e-9));
+    }
+
+    SECTION("a deep view keeps a few small pieces")
+    {
+        const DeepZoomView view{.anchor = {0.3, 0.0, 0.0}, .extent = 1e-9};
+        auto words = deep_zoom_words(triangle, {}, view, 256);
+        REQUIRE(words);
+        REQUIRE_FALSE(words->empty());
+        REQUIRE(words->size() <= 256);
+        for (const auto& word : *words) {
+            // Pieces shrink by 2 per level: about the size of the view, not of the attractor
+            REQUIRE(word.linear[0][0] < 1e-7);
+            REQUIRE(word.probability < 1e-9);
+            // The corner (0, 0) of the piece lies near the anchor
+            REQUIRE(glm::length(word.offset - view.anchor) < 1e-7);
+        }
+    }
+
+    SECTION("views off the attractor keep nothing")
+    {
+        auto words = deep_zoom_words(triangle, {}, {.anchor = {0.5, -0.5, 0.0}, .extent = 1e-6}, 256);
+        REQUIRE(words);
+        REQUIRE(words->empty());
+    }
+
+    SECTION("expanding maps are rejected")
+    {
+        auto expanding = triangle;
+        expanding.maps[0].linear = glm::mat3(1.5f);
+        REQUIRE_FALSE(deep_zoom_words(expanding, {}, {}, 256));
+    }
+}
+
+TEST_CASE("AffineIFS deep zoom resolves detail below float precision", "[deepzoom][vulkan]")
+{
+    auto session = HeadlessSession::create({.backend = "affine", .frontend = "points", .width = 64, .height = 64});
+    REQUIRE(session);
+    auto* backend = dynamic_cast<AffineIFS*>(&(*session)->backend());
+    REQUIRE(backend);
+    REQUIRE((*session)->set_parameter("particle_count", 20000));
+
+    // The bottom edge of the triangle, 1e-9 wide: floats around 0.3 are 3e-8 apart
+    backend->set_deep_zoom(DeepZoomView{.anchor = {0.3, 0.0, 0.0}, .extent = 1e-9});
+    REQUIRE((*session)->compute({.scale = 1.0f, .random_seed = 1}));
+    REQUIRE(backend->deep_zoom_word_count() > 0);
+
+    auto particles = (*session)->read_particles();
+    REQUIRE(particles);
+    std::set<float> distinct_x;
+    uint32_t in_view = 0;
+    for (uint32_t i = 0; i < particles->count; i++) {
+        const auto& p = particles->particles[i].position;
+        REQUIRE(std::isfinite(p.x));
+        REQUIRE(p.y >= -1e-3f);  // Nothing below the edge
+        if (glm::length(p) <= 2.0f) {
+            in_view++;
+            distinct_x.insert(p.x);
+        }
+    }
+    // View-directed: most samples land in view, spread over a continuum of positions
+    REQUIRE(in_view > particles->count / 4);
+    REQUIRE(distinct_x.size() > 1000);
+
+    backend->set_deep_zoom(std::nullopt);
+    REQUIRE((*session)->compute({.scale = 1.0f, .random_seed = 1}));
+    REQUIRE(backend->deep_zoom_word_count() == 0);
+    REQUIRE_FALSE(backend->last_compute_was_warm());
+}
@@ -0,0 +1,99 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <ifs/HeadlessSession.hpp>
+#include <ifs/backends/AffineIFS.hpp>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+using namespace ifs;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+
+// Probability of each index under the table: its own share plus what aliases to it
+std::vector<double> alias_probabilities(const std::vector<AliasEntry>& table) {
+    std::vector<double> probabilities(table.size(), 0.0);
+    for (size_t i = 0; i < table.size(); i++) {
+        probabilities[i] += table[i].threshold;
+        probabilities[table[i].alias] += 1.0 - table[i].threshold;
+    }
+    for (auto& p : probabilities) {
+        p /= static_cast<double>(table.size());
+    }
+    return probabilities;
+}
+
+} // anonymous namespace
+
+TEST_CASE("build_alias_table reproduces the weights", "[affine]")
+{
+    SECTION("weighted")
+    {
+        const std::vector<float> weights = {0.01f, 0.85f, 0.07f, 0.07f, 0.0f, 2.0f};
+        const float total = std::accumulate(weights.begin(), weights.end(), 0.0f);
+        const auto table = build_alias_table(weights);
+        REQUIRE(table.size() == weights.size());
+        const auto probabilities = alias_probabilities(table);
+        for (size_t i = 0; i < weights.size(); i++) {
+            REQUIRE(table[i].alias < weights.size());
+            REQUIRE(table[i].threshold >= 0.0f);
+            REQUIRE(table[i].threshold <= 1.0f);
+            REQUIRE_THAT(probabilities[i], WithinAbs(weights[i] / total, 1e-6));
+        }
+        // Never selected, not even through an alias
+        REQUIRE(table[4].threshold == 0.0f);
+    }
+
+    SECTION("no positive weight is uniform")
+    {
+        const std::vector<float> weights = {0.0f, -1.0f, 0.0f};
+        for (double p : alias_probabilities(build_alias_table(weights))) {
+            REQUIRE_THAT(p, WithinAbs(1.0 / 3.0, 1e-6));
+        }
+    }
+
+    REQUIRE(build_alias_table({}).empty());
+}
+
+TEST_CASE("AffineIFS samples thousands of maps by weight", "[affine][vulkan]")
+{
+    auto session = HeadlessSession::create({.backend = "affine", .frontend = "points", .width = 64, .height = 64});
+    REQUIRE(session);
+    auto* backend = dynamic_cast<AffineIFS*>(&(*session)->backend());
+    REQUIRE(backend);
+    REQUIRE((*session)->set_parameter("particle_count", 20000));
+
+    // 16 tiles of copies of the triangle's maps. Without the top corner's copies,
+    // and with tile 5 switched off, orbits from the origin stay on the x axis.
+    const auto triangle = AffineIFSDefinition::sierpinski_triangle();
+    AffineIFSDefinition many;
+    for (uint32_t i = 0; i < 16 * AffineIFS::tile_map_count; i++) {
+        auto map = triangle.maps[i % 3];
+        const bool in_tile_5 = i / AffineIFS::tile_map_count == 5;
+        map.weight = i % 3 == 2 || in_tile_5 ? 0.0f : 1.0f + static_cast<float>(i % 7);
+        many.maps.push_back(map);
+    }
+    REQUIRE(backend->set_definition(many));
+    REQUIRE((*session)->compute({.scale = 1.0f, .random_seed = 3}));
+
+    auto particles = (*session)->read_particles();
+    REQUIRE(particles);
+    float max_x = 0.0f;
+    for (uint32_t i = 0; i < particles->count; i++) {
+        const auto& p = particles->particles[i].position;
+        REQUIRE(p.x >= -1e-5f);
+        REQUIRE(p.x <= 1.0f + 1e-5f);
+        REQUIRE_THAT(p.y, WithinAbs(0.0, 1e-5));
+        max_x = std::max(max_x, p.x);
+    }
+    REQUIRE(max_x > 0.9f);  // Both remaining corners are used
+
+    // One tile fits without the tile draw
+    many.maps.resize(3);
+    REQUIRE(backend->set_definition(many));
+    REQUIRE((*session)->compute({.scale = 1.0f, .random_seed = 3}));
+
+    many.maps.assign(AffineIFS::max_map_count + 1, triangle.maps[0]);
+    REQUIRE_FALSE(backend->set_definition(many));
+}
@@ -0,0 +1,124 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <ifs/HeadlessSession.hpp>
+#include <ifs/backends/AffineIFS.hpp>
+#include <cmath>
+
+using namespace ifs;
+using Catch::Matchers::WithinAbs;
+
+TEST_CASE("warm_start_iterations follows the parameter change", "[affine]")
+{
+    const auto triangle = AffineIFSDefinition::sierpinski_triangle();
+
+    SECTION("unchanged maps need no iterations")
+    {
+        REQUIRE(warm_start_iterations(triangle, triangle, 1e-3f) == 0u);
+    }
+
+    SECTION("larger nudges need more iterations")
+    {
+        auto small = triangle;
+        small.maps[0].offset.x += 0.001f;
+        auto large = triangle;
+        large.maps[0].offset.x += 0.1f;
+
+        const auto n_small = warm_start_iterations(triangle, small, 1e-3f);
+        const auto n_large = warm_start_iterations(triangle, large, 1e-3f);
+        REQUIRE(n_small);
+        REQUIRE(n_large);
+        // Rate 0.5: the attractor moves by at most 0.2, which takes ceil(log2(0.2 / 1e-3)) = 8 halvings
+        REQUIRE(*n_large == 8u);
+        REQUIRE(*n_small < *n_large);
+        // A looser tolerance settles sooner
+        REQUIRE(*warm_start_iterations(triangle, large, 1e-2f) < *n_large);
+    }
+
+    SECTION("the slowest map bounds the convergence")
+    {
+        auto slow = triangle;
+        slow.maps[0].linear = glm::mat3(0.9f);
+        auto nudged = slow;
+        nudged.maps[0].offset.x += 0.1f;
+
+        // The attractor moves by at least 0.1 / (1 - 0.9) = 1, shrinking by 0.9 per iteration
+        const auto n = warm_start_iterations(slow, nudged, 1e-3f);
+        REQUIRE(n);
+        REQUIRE(*n >= static_cast<uint32_t>(std::ceil(std::log(1e-3) / std::log(0.9))));
+    }
+
+    SECTION("weights and colors count")
+    {
+        auto reweighted = triangle;
+        reweighted.maps[1].weight = 2.0f;
+        REQUIRE(*warm_start_iterations(triangle, reweighted, 1e-3f) > 0u);
+
+        auto recolored = triangle;
+        recolored.maps[2].color = glm::vec3(0.0f);
+        REQUIRE(warm_start_iterations(triangle, recolored, 1e-3f) == static_cast<uint32_t>(std::ceil(std::log2(255.0f))));
+    }
+
+    SECTION("no estimate across map counts or without contraction")
+    {
+        REQUIRE_FALSE(warm_start_iterations(triangle, AffineIFSDefinition::sierpinski_tetrahedron(), 1e-3f));
+
+        auto expanding = triangle;
+        for (auto& map : expanding.maps) {
+            map.linear = glm::mat3(1.5f);
+        }
+        REQUIRE_FALSE(warm_start_iterations(triangle, expanding, 1e-3f));
+
+        // Contracting on average is not enough
+        auto one_expanding = triangle;
+        one_expanding.maps[0].linear = glm::mat3(1.1f);
+        REQUIRE_FALSE(warm_start_iterations(triangle, one_expanding, 1e-3f));
+    }
+}
+
+TEST_CASE("AffineIFS auto warm starts after small changes", "[affine][vulkan]")
+{
+    auto session = HeadlessSession::create({.backend = "affine", .frontend = "points", .width = 64, .height = 64});
+    REQUIRE(session);
+    auto* backend = dynamic_cast<AffineIFS*>(&(*session)->backend());
+    REQUIRE(backend);
+    REQUIRE((*session)->set_parameter("particle_count", 20000));
+    backend->set_auto_warm_start(true);
+
+    REQUIRE((*session)->compute({.scale = 1.0f, .random_seed = 1}));
+    REQUIRE_FALSE(backend->last_compute_was_warm());  // Nothing to continue yet
+    REQUIRE(backend->last_iteration_count() == backend->iteration_count());
+
+    SECTION("a nudged map re-iterates a few times")
+    {
+        auto definition = backend->definition();
+        definition.maps[1].offset.y += 0.01f;
+        REQUIRE(backend->set_definition(definition));
+        REQUIRE((*session)->compute({.scale = 1.0f, .random_seed = 1}));
+        REQUIRE(backend->last_compute_was_warm());
+        REQUIRE(backend->last_iteration_count() > 0u);
+        REQUIRE(backend->last_iteration_count() < backend->iteration_count());
+    }
+
+    SECTION("a scale change only reapplies the stages")
+    {
+        REQUIRE((*session)->compute({.scale = 2.0f, .random_seed = 1}));
+        REQUIRE(backend->last_compute_was_warm());
+        REQUIRE(backend->last_iteration_count() == 0u);
+
+        auto particles = (*session)->read_particles();
+        REQUIRE(particles);
+        for (uint32_t i = 0; i < particles->count; i++) {
+            REQUIRE_THAT(particles->particles[i].position.z, WithinAbs(0.5 - 0.5 * 2.0, 1e-5));
+        }
+    }
+
+    SECTION("a new seed or a new map count starts cold")
+    {
+        REQUIRE((*session)->compute({.scale = 1.0f, .random_seed = 2}));
+        REQUIRE_FALSE(backend->last_compute_was_warm());
+
+        REQUIRE(backend->set_definition(AffineIFSDefinition::sierpinski_tetrahedron()));
+        REQUIRE((*session)->compute({.scale = 1.0f, .random_seed = 2}));
+        REQUIRE_FALSE(backend->last_compute_was_warm());
+    }
+}
@@ -0,0 +1,158 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <ifs/Animation.hpp>
+#include <ifs/HeadlessSession.hpp>
+#include <ifs/backends/AffineIFS.hpp>
+#include <cmath>
+
+using namespace ifs;
+using Catch::Matchers::WithinAbs;
+
+TEST_CASE("parse_timeline reads incremental keyframes", "[animation]")
+{
+    SECTION("lines inherit from the previous keyframe")
+    {
+        auto timeline = parse_timeline(
+            "# comment\n"
+            "t=0 preset=sierpinski_triangle camera.azimuth=10 scale=1\n"
+            "\n"
+            "t=2 weight1=3 color2=1,0,0 camera.target=0,1,2\n"
+            "t=3 map3=0.5,0,0,0,0.5,0,0,0,0.5,0.1,0.2,0.3\n");
+        REQUIRE(timeline);
+        const auto& keys = timeline->keyframes();
+        REQUIRE(keys.size() == 3);
+        REQUIRE(keys[0].frame.ifs == AffineIFSDefinition::sierpinski_triangle());
+        REQUIRE(keys[1].frame.camera.azimuth == 10.0f);
+        REQUIRE(keys[1].frame.camera.target == glm::vec3(0.0f, 1.0f, 2.0f));
+        REQUIRE(keys[1].frame.ifs.maps[1].weight == 3.0f);
+        REQUIRE(keys[1].frame.ifs.maps[2].color == glm::vec3(1.0f, 0.0f, 0.0f));
+        REQUIRE(keys[2].frame.ifs.maps.size() == 4);
+        REQUIRE(keys[2].frame.ifs.maps[3].offset == glm::vec3(0.1f, 0.2f, 0.3f));
+        REQUIRE(keys[2].frame.ifs.maps[3].weight == 1.0f);  // Appended maps start at weight 1
+        REQUIRE(timeline->duration() == 3.0f);
+    }
+
+    SECTION("errors name the line")
+    {
+        auto unknown = parse_timeline("t=0 preset=sierpinski_triangle\nt=1 bogus=1\n");
+        REQUIRE_FALSE(unknown);
+        REQUIRE(unknown.error().starts_with("line 2"));
+
+        REQUIRE_FALSE(parse_timeline("preset=sierpinski_triangle\n"));                      // No time
+        REQUIRE_FALSE(parse_timeline("t=0\n"));                                             // No maps
+        REQUIRE_FALSE(parse_timeline("t=1 preset=menger_sponge\nt=1 scale=2\n"));          // Times must increase
+        REQUIRE_FALSE(parse_timeline("t=0 preset=sierpinski_triangle map5=1,0,0,0,1,0,0,0,1,0,0,0\n"));  // Gap
+        REQUIRE_FALSE(parse_timeline("t=0 preset=no_such_preset\n"));
+    }
+
+    SECTION("serialize round-trips")
+    {
+        Timeline timeline;
+        timeline.add({.time = 0.0f, .frame = {.ifs = AffineIFSDefinition::barnsley_fern(), .scale = 0.75f}});
+        timeline.add({.time = 1.5f, .frame = {
+            .ifs = AffineIFSDefinition::sierpinski_tetrahedron(),
+            .camera = {.target = {0.1f, 0.2f, 0.3f}, .distance = 2.0f, .azimuth = 45.0f, .elevation = 10.0f}
+        }});
+        auto parsed = parse_timeline(timeline.serialize());
+        REQUIRE(parsed);
+        REQUIRE(parsed->keyframes().size() == 2);
+        for (size_t i = 0; i < 2; i++) {
+            REQUIRE(parsed->keyframes()[i].time == timeline.keyframes()[i].time);
+            REQUIRE(parsed->keyframes()[i].frame.ifs == timeline.keyframes()[i].frame.ifs);
+            REQUIRE(parsed->keyframes()[i].frame.camera == timeline.keyframes()[i].frame.camera);
+            REQUIRE(parsed->keyframes()[i].frame.scale == timeline.keyframes()[i].frame.scale);
+        }
+    }
+}
+
+TEST_CASE("Timeline interpolates between keyframes", "[animation]")
+{
+    Timeline timeline;
+    REQUIRE_FALSE(timeline.sample(0.0f));
+
+    auto triangle = AffineIFSDefinition::sierpinski_triangle();
+    auto moved = triangle;
+    moved.maps[0].offset += glm::vec3(0.2f, 0.0f, 0.0f);
+
+    timeline.add({.time = 1.0f, .frame = {.ifs = moved, .camera = {.azimuth = -170.0f}, .scale = 2.0f}});
+    timeline.add({.time = 0.0f, .frame = {.ifs = triangle, .camera = {.azimuth = 170.0f}, .scale = 1.0f}});
+    REQUIRE(timeline.keyframes().front().time == 0.0f);
+
+    SECTION("keyframes are hit exactly and the ends are clamped")
+    {
+        REQUIRE(timeline.sample(-1.0f)->ifs == triangle);
+        REQUIRE(timeline.sample(0.0f)->ifs == triangle);
+        REQUIRE(timeline.sample(1.0f)->ifs == moved);
+        REQUIRE(timeline.sample(5.0f)->scale == 2.0f);
+    }
+
+    SECTION("values move smoothly and the azimuth takes the short way")
+    {
+        auto middle = timeline.sample(0.5f);
+        REQUIRE(middle);
+        REQUIRE_THAT(middle->scale, WithinAbs(1.5, 1e-5));
+        REQUIRE_THAT(middle->ifs.maps[0].offset.x, WithinAbs(triangle.maps[0].offset.x + 0.1f, 1e-5));
+        // 170 -> 190 (= -170) passes through 180, not through 0
+        REQUIRE_THAT(std::remainder(middle->camera.azimuth, 360.0f), WithinAbs(180.0, 1e-3));
+    }
+
+    SECTION("adding at an existing time replaces the keyframe")
+    {
+        timeline.add({.time = 1.0f, .frame = {.ifs = triangle}});
+        REQUIRE(timeline.keyframes().size() == 2);
+        REQUIRE(timeline.sample(1.0f)->ifs == triangle);
+    }
+
+    SECTION("maps missing from a keyframe fade in")
+    {
+        auto four = moved;
+        four.maps.push_back({.offset = {0.5f, 0.5f, 0.5f}, .weight = 2.0f});
+        timeline.add({.time = 2.0f, .frame = {.ifs = four}});
+
+        auto before = timeline.sample(1.0f);
+        auto during = timeline.sample(1.5f);
+        REQUIRE(before->ifs.maps.size() == 4);
+        REQUIRE(before->ifs.maps[3].weight == 0.0f);
+        REQUIRE(during->ifs.maps.size() == 4);
+        REQUIRE(during->ifs.maps[3].weight > 0.0f);
+        REQUIRE(during->ifs.maps[3].weight < 2.0f);
+        REQUIRE(during->ifs.maps[3].offset == glm::vec3(0.5f, 0.5f, 0.5f));
+    }
+}
+
+TEST_CASE("AffineIFS warm starts continue the previous orbits", "[animation][vulkan]")
+{
+    auto session = HeadlessSession::create({.backend = "affine", .frontend = "points", .width = 64, .height = 64});
+    REQUIRE(session);
+    auto* backend = dynamic_cast<AffineIFS*>(&(*session)->backend());
+    REQUIRE(backend);
+    REQUIRE((*session)->set_parameter("particle_count", 20000));
+
+    REQUIRE((*session)->compute({.scale = 1.0f, .random_seed = 1}));
+    REQUIRE_FALSE(backend->last_compute_was_warm());
+
+    // Nudge one map, then continue the orbits for a few iterations at a different scale
+    auto definition = backend->definition();
+    definition.maps[2].offset.x += 0.01f;
+    REQUIRE(backend->set_definition(definition));
+    backend->set_warm_start(4);
+    REQUIRE((*session)->compute({.scale = 2.0f, .random_seed = 1}));
+    REQUIRE(backend->last_compute_was_warm());
+
+    // Still on the (slightly moved) triangle: inside its bounding box around 0.5 at scale 2
+    auto particles = (*session)->read_particles();
+    REQUIRE(particles);
+    for (uint32_t i = 0; i < particles->count; i++) {
+        const auto& p = particles->particles[i].position;
+        REQUIRE(std::isfinite(p.x));
+        REQUIRE(p.x >= -0.5f - 1e-3f);
+        REQUIRE(p.x <= 1.5f + 0.03f);
+        REQUIRE(p.y >= -0.5f - 1e-3f);
+        REQUIRE(p.y <= 1.25f + 1e-3f);
+        REQUIRE_THAT(p.z, WithinAbs(0.5 - 0.5 * 2.0, 1e-5));
+    }
+
+    // Warm starts are one-shot
+    REQUIRE((*session)->compute({.scale = 2.0f, .random_seed = 1}));
+    REQUIRE_FALSE(backend->last_compute_was_warm());
+}
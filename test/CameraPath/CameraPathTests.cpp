@@ -0,0 +1,146 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <ifs/CameraPath.hpp>
+#include <ifs/HeadlessSession.hpp>
+
+using namespace ifs;
+using Catch::Matchers::WithinAbs;
+
+TEST_CASE("parse_camera_path reads incremental frames", "[camera_path]")
+{
+    SECTION("lines inherit the camera, seed and scale but not the parameters")
+    {
+        auto path = parse_camera_path(
+            "# comment\n"
+            "t=0 seed=7 scale=2 camera.target=0,1,2 camera.distance=3 param.Iteration_Count=40\n"
+            "\n"
+            "t=0.5 camera.azimuth=10\n"
+            "t=0.5 seed=8 param.Point_LOD=0\n");
+        REQUIRE(path);
+        const auto& frames = path->frames();
+        REQUIRE(frames.size() == 3);
+        REQUIRE(frames[0].parameters == std::vector<std::pair<std::string, float>>{{"Iteration_Count", 40.0f}});
+        REQUIRE(frames[1].time == 0.5);
+        REQUIRE(frames[1].random_seed == 7);
+        REQUIRE(frames[1].scale == 2.0f);
+        REQUIRE(frames[1].camera.target == glm::vec3(0.0f, 1.0f, 2.0f));
+        REQUIRE(frames[1].camera.distance == 3.0f);
+        REQUIRE(frames[1].camera.azimuth == 10.0f);
+        REQUIRE(frames[1].parameters.empty());
+        REQUIRE(frames[2].random_seed == 8);
+        REQUIRE(frames[2].camera.azimuth == 10.0f);
+        REQUIRE(path->duration() == 0.5);
+    }
+
+    SECTION("errors name the line")
+    {
+        auto missing_time = parse_camera_path("t=0\ncamera.azimuth=3\n");
+        REQUIRE_FALSE(missing_time);
+        REQUIRE(missing_time.error().starts_with("line 2"));
+        REQUIRE_FALSE(parse_camera_path("t=1\nt=0.5\n"));
+        REQUIRE_FALSE(parse_camera_path("t=0 seed=-1\n"));
+        REQUIRE_FALSE(parse_camera_path("t=0 camera.target=1,2\n"));
+        REQUIRE_FALSE(parse_camera_path("t=0 param.=1\n"));
+        REQUIRE_FALSE(parse_camera_path("t=0 zoom=2\n"));
+    }
+}
+
+TEST_CASE("CameraPathRecorder keeps only changes and round-trips", "[camera_path]")
+{
+    float iterations = 40.0f;
+    bool lod = true;
+    std::vector<UICallback> callbacks;
+    callbacks.emplace_back("Iteration Count", DiscreteCallback{
+        .setter = [&](int v) { iterations = static_cast<float>(v); },
+        .getter = [&]() { return static_cast<int>(iterations); },
+        .min = 1,
+        .max = 100
+    });
+    callbacks.emplace_back("Point LOD", ToggleCallback{
+        .setter = [&](bool v) { lod = v; },
+        .getter = [&]() { return lod; }
+    });
+
+    CameraPathRecorder recorder;
+    IFSParameters params{.scale = 1.5f, .random_seed = 3};
+    CameraPose pose;
+    recorder.record(0.0, pose, params, callbacks);
+    pose.azimuth = 0.25f;
+    recorder.record(1.0 / 60.0, pose, params, callbacks);
+    lod = false;
+    params.random_seed = 4;
+    recorder.record(2.0 / 60.0, pose, params, callbacks);
+
+    const auto& frames = recorder.path().frames();
+    REQUIRE(frames.size() == 3);
+    REQUIRE(frames[0].parameters.size() == 2);
+    REQUIRE(frames[1].parameters.empty());
+    REQUIRE(frames[2].parameters == std::vector<std::pair<std::string, float>>{{"Point LOD", 0.0f}});
+
+    auto path = recorder.take();
+    REQUIRE(recorder.path().empty());
+    auto parsed = parse_camera_path(path.serialize());
+    REQUIRE(parsed);
+    REQUIRE(parsed->frames().size() == 3);
+    for (size_t i = 0; i < 3; i++) {
+        const auto& a = path.frames()[i];
+        const auto& b = parsed->frames()[i];
+        REQUIRE(a.time == b.time);
+        REQUIRE(a.camera == b.camera);
+        REQUIRE(a.scale == b.scale);
+        REQUIRE(a.random_seed == b.random_seed);
+        REQUIRE(a.parameters.size() == b.parameters.size());
+    }
+
+    // Replaying the first frame restores the recorded values
+    iterations = 1.0f;
+    lod = true;
+    REQUIRE(apply_path_parameters(parsed->frames()[0].parameters, callbacks).empty());
+    REQUIRE(iterations == 40.0f);
+    REQUIRE(lod);
+    auto unmatched = apply_path_parameters(std::vector<std::pair<std::string, float>>{{"Gamma", 2.0f}}, callbacks);
+    REQUIRE(unmatched.size() == 1);
+}
+
+TEST_CASE("summarize_replay reports frame time percentiles", "[camera_path]")
+{
+    std::vector<FrameTiming> timings;
+    for (uint32_t i = 0; i < 100; i++) {
+        timings.push_back({.frame = i, .recomputed = i % 10 == 0, .frame_ms = static_cast<double>(i + 1)});
+    }
+    auto summary = summarize_replay(timings);
+    REQUIRE(summary.frames == 100);
+    REQUIRE(summary.recomputes == 10);
+    REQUIRE_THAT(summary.mean_ms, WithinAbs(50.5, 1e-9));
+    REQUIRE(summary.p50_ms == 50.0);
+    REQUIRE(summary.p95_ms == 95.0);
+    REQUIRE(summary.p99_ms == 99.0);
+    REQUIRE(summary.max_ms == 100.0);
+    REQUIRE(summarize_replay({}).frames == 0);
+}
+
+TEST_CASE("replay_camera_path recomputes only when the workload changes", "[camera_path][vulkan]")
+{
+    auto session = HeadlessSession::create({.backend = "affine", .frontend = "points", .width = 64, .height = 64});
+    REQUIRE(session);
+
+    auto path = parse_camera_path(
+        "t=0 seed=1 scale=1 param.Particle_Count=20000\n"
+        "t=0.016 camera.azimuth=-60\n"
+        "t=0.033 camera.azimuth=-30\n"
+        "t=0.05 seed=2\n");
+    REQUIRE(path);
+
+    auto timings = replay_camera_path(**session, *path);
+    REQUIRE(timings);
+    REQUIRE(timings->size() == 4);
+    REQUIRE((*timings)[0].recomputed);
+    REQUIRE_FALSE((*timings)[1].recomputed);
+    REQUIRE_FALSE((*timings)[2].recomputed);
+    REQUIRE((*timings)[3].recomputed);
+    for (const auto& timing : *timings) {
+        REQUIRE(timing.frame_ms > 0.0);
+        REQUIRE(timing.frame_ms >= timing.compute_ms);
+    }
+    REQUIRE((*session)->parameter("particle_count") == 20000.0f);
+}
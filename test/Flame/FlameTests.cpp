@@ -0,0 +1,92 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <ifs/HeadlessSession.hpp>
+#include <ifs/backends/FlameIFS.hpp>
+#include <cmath>
+
+using namespace ifs;
+using Catch::Matchers::WithinAbs;
+
+TEST_CASE("FlameDefinition specializes the kernel by the variations in use", "[flame]")
+{
+    SECTION("linear-only flames without a final transform")
+    {
+        auto specialization = FlameDefinition::sierpinski().kernel_specialization();
+        REQUIRE(specialization == std::vector<std::string>{"Add<Linear, NoVariations>", "NoVariations"});
+    }
+
+    SECTION("the union over all transforms, in Variation order")
+    {
+        FlameDefinition flame;
+        flame.transforms.resize(2);
+        flame.transforms[0].variation(Variation::Linear) = 0.0f;
+        flame.transforms[0].variation(Variation::Julia) = 1.0f;
+        flame.transforms[1].variation(Variation::Swirl) = 0.5f;
+        flame.final_transform = FlameTransform{};
+        flame.final_transform->variation(Variation::Heart) = 0.3f;
+
+        REQUIRE(flame.used_variations(false) == std::vector{Variation::Linear, Variation::Swirl, Variation::Julia});
+        auto specialization = flame.kernel_specialization();
+        REQUIRE(specialization[0] == "Add<Linear, Add<Swirl, Add<Julia, NoVariations>>>");
+        REQUIRE(specialization[1] == "Add<Linear, Add<Heart, NoVariations>>");
+    }
+
+    SECTION("every preset is reachable by name")
+    {
+        for (auto name : FlameDefinition::preset_names()) {
+            auto preset = FlameDefinition::preset(name);
+            REQUIRE(preset);
+            REQUIRE_FALSE(preset->transforms.empty());
+        }
+        REQUIRE_FALSE(FlameDefinition::preset("no_such_flame"));
+    }
+}
+
+TEST_CASE("FlameIFS plots and tone maps the flame", "[flame][vulkan]")
+{
+    auto session = HeadlessSession::create({.backend = "flame", .frontend = "points", .width = 64, .height = 64});
+    REQUIRE(session);
+    auto* backend = dynamic_cast<FlameIFS*>(&(*session)->backend());
+    REQUIRE(backend);
+    REQUIRE((*session)->set_parameter("particle_count", 20000));
+
+    SECTION("the Sierpinski flame stays in its triangle and is lit")
+    {
+        REQUIRE(backend->set_definition(FlameDefinition::sierpinski()));
+        REQUIRE((*session)->compute({.scale = 1.0f, .random_seed = 1}));
+
+        auto particles = (*session)->read_particles();
+        REQUIRE(particles);
+        uint32_t lit = 0;
+        for (uint32_t i = 0; i < particles->count; i++) {
+            const auto& particle = particles->particles[i];
+            REQUIRE(particle.position.x >= -1e-4f);
+            REQUIRE(particle.position.x <= 1.0f + 1e-4f);
+            REQUIRE(particle.position.y >= -1e-4f);
+            REQUIRE(particle.position.y <= 1.0f + 1e-4f);
+            REQUIRE(particle.position.z == 0.0f);
+            lit += particle.color.r + particle.color.g + particle.color.b > 0.0f;
+        }
+        REQUIRE(lit > particles->count / 2);
+    }
+
+    SECTION("nonlinear presets stay finite, and variation sets reuse their kernels")
+    {
+        for (auto name : FlameDefinition::preset_names()) {
+            REQUIRE(backend->set_definition(*FlameDefinition::preset(name)));
+            REQUIRE((*session)->compute({.scale = 1.0f, .random_seed = 7}));
+
+            auto particles = (*session)->read_particles();
+            REQUIRE(particles);
+            for (uint32_t i = 0; i < particles->count; i++) {
+                REQUIRE(std::isfinite(particles->particles[i].position.x));
+                REQUIRE(std::isfinite(particles->particles[i].position.y));
+                REQUIRE_THAT(particles->particles[i].color.a, WithinAbs(1.0, 1e-6));
+            }
+        }
+
+        const size_t kernels = backend->kernel_count();
+        REQUIRE(backend->set_definition(FlameDefinition::julia_swirl()));
+        REQUIRE(backend->kernel_count() == kernels);
+    }
+}
@@ -0,0 +1,78 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <ifs/FractalDimension.hpp>
+#include <ifs/HeadlessSession.hpp>
+#include <cmath>
+
+using namespace ifs;
+using Catch::Matchers::WithinAbs;
+
+TEST_CASE("fit_box_counting recovers exact power laws", "[dimension]")
+{
+    SECTION("a filled square has dimension 2")
+    {
+        std::vector<BoxCount> counts;
+        for (uint32_t level = 1; level <= 8; level++) {
+            counts.push_back({level, 1u << (2 * level)});
+        }
+        auto estimate = fit_box_counting(counts, 100'000'000);
+        REQUIRE(estimate);
+        REQUIRE_THAT(estimate->dimension, WithinAbs(2.0, 1e-9));
+        REQUIRE_THAT(estimate->standard_error, WithinAbs(0.0, 1e-9));
+        REQUIRE_THAT(estimate->r_squared, WithinAbs(1.0, 1e-9));
+        REQUIRE(estimate->fit_first == 2);
+        REQUIRE(estimate->fit_last == 8);
+        REQUIRE(estimate->counts.size() == 8);
+    }
+
+    SECTION("undersampled levels are left out")
+    {
+        std::vector<BoxCount> counts;
+        for (uint32_t level = 1; level <= 8; level++) {
+            counts.push_back({level, 1u << (2 * level)});
+        }
+        // 4^5 * 8 boxes fit 8192 particles, 4^6 * 8 do not
+        auto estimate = fit_box_counting(counts, 8192);
+        REQUIRE(estimate);
+        REQUIRE(estimate->fit_last == 5);
+    }
+
+    SECTION("noisy counts report an uncertainty")
+    {
+        std::vector<BoxCount> counts = {{1, 4}, {2, 9}, {3, 26}, {4, 80}, {5, 245}, {6, 720}};
+        auto estimate = fit_box_counting(counts, 1'000'000);
+        REQUIRE(estimate);
+        REQUIRE(estimate->standard_error > 0.0);
+        REQUIRE(estimate->r_squared < 1.0);
+        REQUIRE_THAT(estimate->dimension, WithinAbs(std::log2(3.0), 0.05));
+    }
+
+    SECTION("too few levels is an error")
+    {
+        std::vector<BoxCount> counts = {{1, 4}, {2, 16}, {3, 64}};
+        REQUIRE_FALSE(fit_box_counting(counts, 1'000'000));
+    }
+}
+
+TEST_CASE("FractalDimension estimates the Sierpinski triangle", "[dimension][vulkan]")
+{
+    auto session = HeadlessSession::create({.backend = "sierpinski", .frontend = "points", .width = 64, .height = 64});
+    REQUIRE(session);
+    REQUIRE((*session)->set_parameter("particle_count", 200000));
+    REQUIRE((*session)->compute({.random_seed = 3}));
+    // Leaves the particle buffer owned by the graphics queue
+    REQUIRE((*session)->read_particles());
+
+    auto estimator = FractalDimension::create((*session)->context());
+    REQUIRE(estimator);
+    auto& backend = (*session)->backend();
+    REQUIRE((*estimator)->estimate(backend.get_particle_buffer(), backend.get_particle_count()));
+    (*estimator)->wait_idle();
+
+    auto estimate = (*estimator)->poll();
+    REQUIRE(estimate);
+    REQUIRE(*estimate);
+    REQUIRE_THAT((*estimate)->dimension, WithinAbs(std::log2(3.0), 0.08));
+    REQUIRE((*estimate)->counts.front().boxes <= 8);
+    REQUIRE_FALSE((*estimator)->busy());
+}
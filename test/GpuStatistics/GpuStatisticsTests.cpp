@@ -0,0 +1,131 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <ifs/GpuStatistics.hpp>
+#include <ifs/HeadlessSession.hpp>
+#include <ifs/backends/FlameIFS.hpp>
+#include <bit>
+#include <numeric>
+
+using namespace ifs;
+using Catch::Matchers::WithinAbs;
+
+TEST_CASE("summarize_statistics decodes the GPU result", "[statistics]")
+{
+    StatisticsResult result{};
+
+    SECTION("an empty result has no range")
+    {
+        result.min_encoded = 0xffffffffu;
+        auto summary = summarize_statistics(result, 16);
+        REQUIRE(summary.count == 0);
+        REQUIRE(summary.min == 0.0f);
+        REQUIRE(summary.max == 0.0f);
+        REQUIRE(summary.bins.size() == 16);
+    }
+
+    SECTION("min and max are order-encoded, bins are cut to the bin count")
+    {
+        // Positive floats encode with the sign bit set, negative ones inverted
+        result.count = 10;
+        result.min_encoded = ~std::bit_cast<uint32_t>(-2.5f);
+        result.max_encoded = std::bit_cast<uint32_t>(4.0f) | 0x80000000u;
+        result.mean = 1.25f;
+        result.percentiles = {1.0f, 2.0f, 3.0f, 3.5f};
+        result.bins[0] = 4;
+        result.bins[2] = 6;
+        result.bins[3] = 99;
+
+        auto summary = summarize_statistics(result, 3);
+        REQUIRE(summary.count == 10);
+        REQUIRE(summary.min == -2.5f);
+        REQUIRE(summary.max == 4.0f);
+        REQUIRE(summary.mean == 1.25f);
+        REQUIRE(summary.percentiles[3] == 3.5f);
+        REQUIRE(summary.bins == std::vector<uint32_t>{4, 0, 6});
+    }
+}
+
+TEST_CASE("GpuStatistics bins particle attributes", "[statistics][vulkan]")
+{
+    auto session = HeadlessSession::create({.backend = "flame", .frontend = "points", .width = 64, .height = 64});
+    REQUIRE(session);
+    REQUIRE((*session)->set_parameter("particle_count", 50000));
+    REQUIRE((*session)->compute({.scale = 1.0f, .random_seed = 5}));
+    // Leaves the particle buffer owned by the graphics queue
+    REQUIRE((*session)->read_particles());
+
+    auto statistics = GpuStatistics::create((*session)->context(), 2);
+    if (!statistics) {
+        SKIP(statistics.error());
+    }
+    auto& backend = (*session)->backend();
+    constexpr uint32_t words = sizeof(Particle) / sizeof(uint32_t);
+
+    // Alpha is 1 everywhere; x spans the unit square of the view
+    std::array jobs = {
+        GpuStatistics::Job{.slot = 0, .source = backend.get_particle_buffer(), .element_count = backend.get_particle_count(),
+                           .spec = {.stride = words, .offset = 7, .is_float = true}},
+        GpuStatistics::Job{.slot = 1, .source = backend.get_particle_buffer(), .element_count = backend.get_particle_count(),
+                           .spec = {.stride = words, .offset = 0, .is_float = true, .bin_count = 64}},
+    };
+    REQUIRE((*statistics)->submit(jobs));
+    (*statistics)->wait_idle();
+    REQUIRE((*statistics)->poll());
+    REQUIRE_FALSE((*statistics)->busy());
+
+    const auto& alpha = (*statistics)->latest(0);
+    REQUIRE(alpha);
+    REQUIRE(alpha->count == backend.get_particle_count());
+    REQUIRE(alpha->min == 1.0f);
+    REQUIRE(alpha->max == 1.0f);
+    REQUIRE(alpha->bins.back() == alpha->count);
+    for (float percentile : alpha->percentiles) {
+        REQUIRE(percentile == 1.0f);
+    }
+
+    const auto& x = (*statistics)->latest(1);
+    REQUIRE(x);
+    REQUIRE(x->bins.size() == 64);
+    REQUIRE(std::accumulate(x->bins.begin(), x->bins.end(), 0u) == x->count);
+    REQUIRE(x->min >= -1e-4f);
+    REQUIRE(x->max <= 1.0f + 1e-4f);
+    REQUIRE(x->min <= x->percentiles[0]);
+    for (size_t i = 1; i < x->percentiles.size(); i++) {
+        REQUIRE(x->percentiles[i - 1] <= x->percentiles[i]);
+    }
+    REQUIRE(x->percentiles.back() <= x->max);
+}
+
+TEST_CASE("FlameIFS auto-exposure normalizes by the density percentile", "[statistics][flame][vulkan]")
+{
+    auto session = HeadlessSession::create({.backend = "flame", .frontend = "points", .width = 64, .height = 64});
+    REQUIRE(session);
+    auto* backend = dynamic_cast<FlameIFS*>(&(*session)->backend());
+    REQUIRE(backend);
+    REQUIRE((*session)->set_parameter("particle_count", 50000));
+    REQUIRE_FALSE(backend->density_statistics());
+
+    backend->set_auto_exposure(true);
+    if (!backend->auto_exposure()) {
+        SKIP("Subgroup arithmetic unavailable on this device");
+    }
+    REQUIRE((*session)->compute({.scale = 1.0f, .random_seed = 1}));
+
+    const auto& density = backend->density_statistics();
+    REQUIRE(density);
+    REQUIRE(density->count > 0);
+    REQUIRE(density->count <= FlameIFS::grid_size * FlameIFS::grid_size);
+    // Occupied cells hold at least one hit: log2(1 + 1)
+    REQUIRE_THAT(density->min, WithinAbs(1.0, 1e-6));
+    REQUIRE(density->percentiles[0] >= density->percentiles[1]);
+    REQUIRE(density->percentiles[0] <= density->max);
+
+    auto particles = (*session)->read_particles();
+    REQUIRE(particles);
+    uint32_t lit = 0;
+    for (uint32_t i = 0; i < particles->count; i++) {
+        const auto& color = particles->particles[i].color;
+        lit += color.r + color.g + color.b > 0.0f;
+    }
+    REQUIRE(lit > particles->count / 2);
+}
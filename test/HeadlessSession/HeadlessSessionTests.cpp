@@ -0,0 +1,46 @@
+#include <catch2/catch_test_macros.hpp>
+#include <ifs/HeadlessSession.hpp>
+
+using namespace ifs;
+
+TEST_CASE("HeadlessSession computes and reads back without a window", "[headless][vulkan]")
+{
+    auto session = HeadlessSession::create({.backend = "sierpinski", .frontend = "points", .width = 64, .height = 64});
+    REQUIRE(session);
+
+    SECTION("readback before compute is an error")
+    {
+        REQUIRE_FALSE((*session)->read_particles());
+        REQUIRE_FALSE((*session)->render());
+    }
+
+    SECTION("parameters are found by scripted names")
+    {
+        REQUIRE((*session)->set_parameter("particle_count", 20000));
+        auto count = (*session)->parameter("Particle Count");
+        REQUIRE(count);
+        REQUIRE(*count == 20000.0f);
+        REQUIRE_FALSE((*session)->set_parameter("no_such_parameter", 1));
+    }
+
+    SECTION("particles and image are mapped in place")
+    {
+        REQUIRE((*session)->set_parameter("particle_count", 10000));
+        REQUIRE((*session)->compute({.random_seed = 1}));
+
+        auto particles = (*session)->read_particles();
+        REQUIRE(particles);
+        REQUIRE(particles->count == (*session)->backend().get_particle_count());
+        REQUIRE(particles->particles == particles->owner->data());
+
+        // Sierpinski2D writes 2D positions
+        for (uint32_t i = 0; i < particles->count; i++) {
+            REQUIRE(particles->particles[i].position.z == 0.0f);
+        }
+
+        auto image = (*session)->render();
+        REQUIRE(image);
+        REQUIRE(image->width == 64);
+        REQUIRE(image->height == 64);
+    }
+}
@@ -0,0 +1,117 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <ifs/LatencyTracker.hpp>
+
+using namespace ifs;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+
+LatencyTracker::Clock::time_point at_ms(double ms) {
+    return LatencyTracker::Clock::time_point{} + std::chrono::duration_cast<LatencyTracker::Clock::duration>(
+        std::chrono::duration<double, std::milli>(ms));
+}
+
+} // anonymous namespace
+
+TEST_CASE("LatencyTracker times the stages of a frame", "[latency]")
+{
+    LatencyTracker tracker;
+
+    SECTION("frames end at the present call without present wait")
+    {
+        tracker.begin_frame(at_ms(0.0));
+        tracker.input(at_ms(1.0));
+        tracker.input(at_ms(2.0));  // Only the earliest counts
+        tracker.submitted(at_ms(5.0));
+        REQUIRE(tracker.presented(at_ms(6.0), false) == 1);
+        REQUIRE_FALSE(tracker.oldest_pending());
+
+        REQUIRE(tracker.samples().size() == 1);
+        const auto& sample = tracker.samples().front();
+        REQUIRE(sample.has_input);
+        REQUIRE_FALSE(sample.displayed);
+        REQUIRE_THAT(sample.input_to_end_ms, WithinAbs(5.0, 1e-6));
+        REQUIRE_THAT(sample.start_to_submit_ms, WithinAbs(5.0, 1e-6));
+        REQUIRE_THAT(sample.submit_to_present_ms, WithinAbs(1.0, 1e-6));
+        REQUIRE(sample.present_to_display_ms == 0.0);
+    }
+
+    SECTION("displayed() completes every pending frame up to its id")
+    {
+        tracker.begin_frame(at_ms(0.0));
+        tracker.input(at_ms(1.0));
+        tracker.submitted(at_ms(4.0));
+        const auto first = tracker.presented(at_ms(5.0), true);
+        tracker.begin_frame(at_ms(10.0));
+        tracker.submitted(at_ms(14.0));
+        const auto second = tracker.presented(at_ms(15.0), true);
+        REQUIRE(second > first);
+        REQUIRE(tracker.oldest_pending() == first);
+        REQUIRE(tracker.newest_pending() == second);
+        REQUIRE(tracker.samples().empty());
+
+        tracker.displayed(second, at_ms(21.0));
+        REQUIRE_FALSE(tracker.oldest_pending());
+        REQUIRE(tracker.samples().size() == 2);
+        REQUIRE(tracker.samples()[0].displayed);
+        REQUIRE_THAT(tracker.samples()[0].input_to_end_ms, WithinAbs(20.0, 1e-6));
+        REQUIRE_THAT(tracker.samples()[0].present_to_display_ms, WithinAbs(16.0, 1e-6));
+        REQUIRE_FALSE(tracker.samples()[1].has_input);
+
+        const auto summary = tracker.summary();
+        REQUIRE(summary.displayed);
+        REQUIRE(summary.input_frames == 1);
+        REQUIRE_THAT(summary.present_to_display_ms, WithinAbs(11.0, 1e-6));
+    }
+
+    SECTION("input of a dropped frame carries over to the next one")
+    {
+        tracker.begin_frame(at_ms(0.0));
+        tracker.input(at_ms(1.0));
+        tracker.begin_frame(at_ms(3.0));  // Swapchain recreated: the first frame never submitted
+        tracker.submitted(at_ms(7.0));
+        tracker.presented(at_ms(8.0), false);
+        REQUIRE(tracker.samples().size() == 1);
+        REQUIRE_THAT(tracker.samples().front().input_to_end_ms, WithinAbs(7.0, 1e-6));
+    }
+
+    SECTION("discarded frames never complete")
+    {
+        tracker.begin_frame(at_ms(0.0));
+        tracker.submitted(at_ms(1.0));
+        const auto id = tracker.presented(at_ms(2.0), true);
+        tracker.discard_pending();
+        tracker.displayed(id, at_ms(9.0));
+        REQUIRE(tracker.samples().empty());
+    }
+}
+
+TEST_CASE("LatencyTracker summarizes a rolling window", "[latency]")
+{
+    LatencyTracker tracker(100);
+    for (int i = 0; i < 150; i++) {
+        const double start = i * 20.0;
+        tracker.begin_frame(at_ms(start));
+        if (i % 2 == 0) {
+            tracker.input(at_ms(start + 1.0));
+        }
+        // The last 100 frames take 1..100 ms from start to present
+        const double length = i < 50 ? 1000.0 : static_cast<double>(i - 49);
+        tracker.submitted(at_ms(start + length));
+        tracker.presented(at_ms(start + length), false);
+    }
+
+    const auto summary = tracker.summary();
+    REQUIRE(summary.frames == 100);
+    REQUIRE(summary.input_frames == 50);
+    REQUIRE_FALSE(summary.displayed);
+    REQUIRE_THAT(summary.start_to_submit_ms, WithinAbs(50.5, 1e-6));
+    // Input frames are the odd lengths 1, 3, ..., 99, each seen 1 ms late
+    REQUIRE_THAT(summary.input_mean_ms, WithinAbs(49.0, 1e-6));
+    REQUIRE_THAT(summary.input_p50_ms, WithinAbs(48.0, 1e-6));
+    REQUIRE_THAT(summary.input_max_ms, WithinAbs(98.0, 1e-6));
+
+    tracker.clear();
+    REQUIRE(tracker.summary().frames == 0);
+}
@@ -0,0 +1,147 @@
+#include <catch2/catch_test_macros.hpp>
+#include <ifs/Metrics.hpp>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ifs;
+
+TEST_CASE("MetricsRegistry registers and updates metrics", "[metrics]")
+{
+    MetricsRegistry registry;
+
+    SECTION("counter accumulates")
+    {
+        auto& counter = registry.counter("test_events_total", "Events");
+        counter.add();
+        counter.add(2.0);
+        REQUIRE(counter.value() == 3.0);
+    }
+
+    SECTION("gauge is overwritten")
+    {
+        auto& gauge = registry.gauge("test_level", "Level");
+        gauge.set(5.0);
+        gauge.set(1.5);
+        REQUIRE(gauge.value() == 1.5);
+    }
+
+    SECTION("same name returns the same metric")
+    {
+        auto& first = registry.counter("test_events_total");
+        auto& second = registry.counter("test_events_total");
+        REQUIRE(&first == &second);
+    }
+
+    SECTION("references stay valid while more metrics are registered")
+    {
+        auto& first = registry.counter("test_first_total");
+        for (int i = 0; i < 1000; i++) {
+            registry.gauge("test_gauge_" + std::to_string(i));
+        }
+        first.add();
+        REQUIRE(registry.counter("test_first_total").value() == 1.0);
+    }
+
+    SECTION("snapshot keeps registration order")
+    {
+        registry.counter("test_b_total").add(4.0);
+        registry.gauge("test_a").set(2.0);
+        auto samples = registry.snapshot();
+        REQUIRE(samples.size() == 2);
+        REQUIRE(samples[0].name == "test_b_total");
+        REQUIRE(samples[0].type == MetricType::Counter);
+        REQUIRE(samples[0].value == 4.0);
+        REQUIRE(samples[1].name == "test_a");
+        REQUIRE(samples[1].type == MetricType::Gauge);
+    }
+
+    SECTION("concurrent updates are not lost")
+    {
+        auto& counter = registry.counter("test_concurrent_total");
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; t++) {
+            threads.emplace_back([&counter] {
+                for (int i = 0; i < 10000; i++) {
+                    counter.add();
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        REQUIRE(counter.value() == 40000.0);
+    }
+}
+
+TEST_CASE("MetricsExporter formats snapshots", "[metrics]")
+{
+    std::vector<MetricSample> samples = {
+        {"ifs_frames_total", "Frames presented", MetricType::Counter, 42.0},
+        {"ifs_vram_usage_bytes{heap=\"0\"}", "Heap usage", MetricType::Gauge, 1024.0},
+        {"ifs_vram_usage_bytes{heap=\"1\"}", "Heap usage", MetricType::Gauge, 2048.0},
+    };
+
+    SECTION("JSON line")
+    {
+        auto line = MetricsExporter::format_json_line(samples, 1000);
+        REQUIRE(line ==
+            "{\"timestamp_ms\":1000,\"metrics\":{"
+            "\"ifs_frames_total\":42,"
+            "\"ifs_vram_usage_bytes{heap=\\\"0\\\"}\":1024,"
+            "\"ifs_vram_usage_bytes{heap=\\\"1\\\"}\":2048}}\n");
+    }
+
+    SECTION("Prometheus text describes each family once")
+    {
+        auto text = MetricsExporter::format_prometheus(samples);
+        REQUIRE(text ==
+            "# HELP ifs_frames_total Frames presented\n"
+            "# TYPE ifs_frames_total counter\n"
+            "ifs_frames_total 42\n"
+            "# HELP ifs_vram_usage_bytes Heap usage\n"
+            "# TYPE ifs_vram_usage_bytes gauge\n"
+            "ifs_vram_usage_bytes{heap=\"0\"} 1024\n"
+            "ifs_vram_usage_bytes{heap=\"1\"} 2048\n");
+    }
+
+    SECTION("Prometheus text groups families registered interleaved")
+    {
+        std::vector<MetricSample> per_heap = {
+            {"ifs_vram_usage_bytes{heap=\"0\"}", "Heap usage", MetricType::Gauge, 1.0},
+            {"ifs_vram_budget_bytes{heap=\"0\"}", "Heap budget", MetricType::Gauge, 2.0},
+            {"ifs_vram_usage_bytes{heap=\"1\"}", "Heap usage", MetricType::Gauge, 3.0},
+            {"ifs_vram_budget_bytes{heap=\"1\"}", "Heap budget", MetricType::Gauge, 4.0},
+        };
+        auto text = MetricsExporter::format_prometheus(per_heap);
+        REQUIRE(text ==
+            "# HELP ifs_vram_usage_bytes Heap usage\n"
+            "# TYPE ifs_vram_usage_bytes gauge\n"
+            "ifs_vram_usage_bytes{heap=\"0\"} 1\n"
+            "ifs_vram_usage_bytes{heap=\"1\"} 3\n"
+            "# HELP ifs_vram_budget_bytes Heap budget\n"
+            "# TYPE ifs_vram_budget_bytes gauge\n"
+            "ifs_vram_budget_bytes{heap=\"0\"} 2\n"
+            "ifs_vram_budget_bytes{heap=\"1\"} 4\n");
+    }
+
+    SECTION("Prometheus text spells non-finite values and escapes help")
+    {
+        std::vector<MetricSample> non_finite = {
+            {"ifs_fractal_dimension", "Box-counting\\estimate\nof the attractor", MetricType::Gauge,
+             std::numeric_limits<double>::infinity()},
+            {"ifs_latency_ms", "", MetricType::Gauge, -std::numeric_limits<double>::infinity()},
+            {"ifs_fit_r2", "", MetricType::Gauge, std::numeric_limits<double>::quiet_NaN()},
+        };
+        auto text = MetricsExporter::format_prometheus(non_finite);
+        REQUIRE(text ==
+            "# HELP ifs_fractal_dimension Box-counting\\\\estimate\\nof the attractor\n"
+            "# TYPE ifs_fractal_dimension gauge\n"
+            "ifs_fractal_dimension +Inf\n"
+            "# TYPE ifs_latency_ms gauge\n"
+            "ifs_latency_ms -Inf\n"
+            "# TYPE ifs_fit_r2 gauge\n"
+            "ifs_fit_r2 NaN\n");
+    }
+}
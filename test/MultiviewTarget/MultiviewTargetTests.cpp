@@ -0,0 +1,219 @@
+#include <catch2/catch_test_macros.hpp>
+#include <ifs/HeadlessSession.hpp>
+#include <ifs/MultiviewTarget.hpp>
+#include <ifs/ReadbackBuffer.hpp>
+#include <array>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+using namespace ifs;
+
+namespace {
+
+constexpr vk::Format TARGET_FORMAT = vk::Format::eR8G8B8A8Unorm;
+
+/// Frontend-like render pass and color target the views are composited into
+struct FrontendTarget {
+    vk::Device device;
+    vk::RenderPass render_pass;
+    vk::Image image;
+    vk::DeviceMemory memory;
+    vk::ImageView view;
+    vk::Framebuffer framebuffer;
+    vk::Extent2D extent;
+
+    FrontendTarget(const VulkanContext& context, vk::Extent2D target_extent)
+        : device(context.device())
+        , extent(target_extent)
+    {
+        auto attachment = vk::AttachmentDescription()
+            .setFormat(TARGET_FORMAT)
+            .setSamples(vk::SampleCountFlagBits::e1)
+            .setLoadOp(vk::AttachmentLoadOp::eClear)
+            .setStoreOp(vk::AttachmentStoreOp::eStore)
+            .setStencilLoadOp(vk::AttachmentLoadOp::eDontCare)
+            .setStencilStoreOp(vk::AttachmentStoreOp::eDontCare)
+            .setInitialLayout(vk::ImageLayout::eUndefined)
+            .setFinalLayout(vk::ImageLayout::eTransferSrcOptimal);
+        auto color_ref = vk::AttachmentReference(0, vk::ImageLayout::eColorAttachmentOptimal);
+        auto subpass = vk::SubpassDescription()
+            .setPipelineBindPoint(vk::PipelineBindPoint::eGraphics)
+            .setColorAttachments(color_ref);
+        auto [pass_result, pass] = device.createRenderPass(
+            vk::RenderPassCreateInfo().setAttachments(attachment).setSubpasses(subpass));
+        REQUIRE(pass_result == vk::Result::eSuccess);
+        render_pass = pass;
+
+        auto [image_result, created] = device.createImage(vk::ImageCreateInfo()
+            .setImageType(vk::ImageType::e2D)
+            .setFormat(TARGET_FORMAT)
+            .setExtent(vk::Extent3D(extent.width, extent.height, 1))
+            .setMipLevels(1)
+            .setArrayLayers(1)
+            .setSamples(vk::SampleCountFlagBits::e1)
+            .setTiling(vk::ImageTiling::eOptimal)
+            .setUsage(vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc));
+        REQUIRE(image_result == vk::Result::eSuccess);
+        image = created;
+
+        auto mem_reqs = device.getImageMemoryRequirements(image);
+        auto memory_type = context.find_memory_type(mem_reqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
+        REQUIRE(memory_type);
+        auto [alloc_result, allocated] = device.allocateMemory(vk::MemoryAllocateInfo(mem_reqs.size, *memory_type));
+        REQUIRE(alloc_result == vk::Result::eSuccess);
+        memory = allocated;
+        REQUIRE(device.bindImageMemory(image, memory, 0) == vk::Result::eSuccess);
+
+        auto [view_result, created_view] = device.createImageView(vk::ImageViewCreateInfo()
+            .setImage(image)
+            .setViewType(vk::ImageViewType::e2D)
+            .setFormat(TARGET_FORMAT)
+            .setSubresourceRange(vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1)));
+        REQUIRE(view_result == vk::Result::eSuccess);
+        view = created_view;
+
+        auto [framebuffer_result, created_framebuffer] = device.createFramebuffer(vk::FramebufferCreateInfo()
+            .setRenderPass(render_pass)
+            .setAttachments(view)
+            .setWidth(extent.width)
+            .setHeight(extent.height)
+            .setLayers(1));
+        REQUIRE(framebuffer_result == vk::Result::eSuccess);
+        framebuffer = created_framebuffer;
+    }
+
+    ~FrontendTarget() {
+        device.destroyFramebuffer(framebuffer);
+        device.destroyImageView(view);
+        device.destroyImage(image);
+        device.freeMemory(memory);
+        device.destroyRenderPass(render_pass);
+    }
+};
+
+/// Record and run commands on the graphics queue, blocking until they complete
+void run_commands(const VulkanContext& context, const std::function<void(vk::CommandBuffer)>& record) {
+    auto device = context.device();
+    auto [pool_result, pool] = device.createCommandPool(
+        vk::CommandPoolCreateInfo({}, context.queue_indices().graphics));
+    REQUIRE(pool_result == vk::Result::eSuccess);
+    auto [alloc_result, cmds] = device.allocateCommandBuffers(
+        vk::CommandBufferAllocateInfo(pool, vk::CommandBufferLevel::ePrimary, 1));
+    REQUIRE(alloc_result == vk::Result::eSuccess);
+    auto [fence_result, fence] = device.createFence({});
+    REQUIRE(fence_result == vk::Result::eSuccess);
+
+    auto _ = cmds[0].begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+    record(cmds[0]);
+    auto _ = cmds[0].end();
+    auto _ = context.graphics_queue().submit(vk::SubmitInfo().setCommandBuffers(cmds[0]), fence);
+    REQUIRE(device.waitForFences(fence, vk::True, UINT64_MAX) == vk::Result::eSuccess);
+
+    device.destroyFence(fence);
+    device.destroyCommandPool(pool);
+}
+
+} // anonymous namespace
+
+TEST_CASE("MultiviewTarget is only created where multiview is supported", "[multiview][vulkan]")
+{
+    auto session = HeadlessSession::create({.backend = "affine", .frontend = "particles", .width = 64, .height = 64});
+    REQUIRE(session);
+    const auto& context = (*session)->context();
+
+    // Without multiview the particle frontend draws one view per render() call
+    const bool supported = MultiviewTarget::supported(context);
+    REQUIRE(supported == context.has_multiview());
+    REQUIRE((*session)->frontend().max_views() == (supported ? MultiviewTarget::MAX_VIEWS : 1));
+
+    if (!supported) {
+        auto target = MultiviewTarget::create(context, vk::GraphicsPipelineCreateInfo(), 2);
+        REQUIRE_FALSE(target);
+        SKIP("VK_KHR_multiview unsupported");
+    }
+}
+
+TEST_CASE("MultiviewTarget composites each view into its area", "[multiview][vulkan]")
+{
+    VulkanContext context("Multiview Test");
+    if (!MultiviewTarget::supported(context)) {
+        SKIP("VK_KHR_multiview unsupported");
+    }
+
+    // A wide target with an uncovered gap between the views and on the right
+    FrontendTarget frontend(context, {80, 32});
+
+    auto viewport_state = vk::PipelineViewportStateCreateInfo().setViewportCount(1).setScissorCount(1);
+    auto multisample = vk::PipelineMultisampleStateCreateInfo().setRasterizationSamples(vk::SampleCountFlagBits::e1);
+    std::array dynamic_states = {vk::DynamicState::eViewport, vk::DynamicState::eScissor};
+    auto dynamic_state = vk::PipelineDynamicStateCreateInfo().setDynamicStates(dynamic_states);
+    auto frontend_pipeline = vk::GraphicsPipelineCreateInfo()
+        .setPViewportState(&viewport_state)
+        .setPMultisampleState(&multisample)
+        .setPDynamicState(&dynamic_state)
+        .setRenderPass(frontend.render_pass)
+        .setSubpass(0);
+
+    SECTION("view counts outside 2 to MAX_VIEWS are rejected")
+    {
+        REQUIRE_FALSE(MultiviewTarget::create(context, frontend_pipeline, 1));
+        REQUIRE_FALSE(MultiviewTarget::create(context, frontend_pipeline, MultiviewTarget::MAX_VIEWS + 1));
+    }
+
+    SECTION("layers land in their view rects, clamped to the layer's edge")
+    {
+        auto target = MultiviewTarget::create(context, frontend_pipeline, 2);
+        REQUIRE(target);
+        REQUIRE((*target)->view_count() == 2);
+
+        // View 1 is a pixel wider than the layers, like the odd half of a split
+        const std::array areas = {
+            vk::Rect2D({0, 0}, {32, 32}),
+            vk::Rect2D({40, 0}, {33, 32})
+        };
+
+        auto readback = ReadbackBuffer::create(context, frontend.extent.width * frontend.extent.height * 4);
+        REQUIRE(readback);
+        run_commands(context, [&](vk::CommandBuffer cmd) {
+            REQUIRE((*target)->begin(cmd, {32, 32}, vk::ClearColorValue(std::array{1.0f, 0.0f, 0.0f, 1.0f})));
+            (*target)->end(cmd);
+
+            vk::ClearValue background(vk::ClearColorValue(std::array{0.0f, 0.0f, 0.0f, 1.0f}));
+            cmd.beginRenderPass(vk::RenderPassBeginInfo()
+                .setRenderPass(frontend.render_pass)
+                .setFramebuffer(frontend.framebuffer)
+                .setRenderArea(vk::Rect2D({0, 0}, frontend.extent))
+                .setClearValues(background), vk::SubpassContents::eInline);
+            for (uint32_t view = 0; view < areas.size(); view++) {
+                (*target)->record_composite(cmd, view, areas[view]);
+            }
+            cmd.endRenderPass();
+
+            auto region = vk::BufferImageCopy()
+                .setImageSubresource(vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, 1))
+                .setImageExtent(vk::Extent3D(frontend.extent.width, frontend.extent.height, 1));
+            cmd.copyImageToBuffer(frontend.image, vk::ImageLayout::eTransferSrcOptimal, (*readback)->buffer(), region);
+        });
+        (*readback)->invalidate();
+
+        std::vector<uint8_t> pixels((*readback)->size());
+        std::memcpy(pixels.data(), (*readback)->data(), pixels.size());
+
+        auto covered = [&](int32_t x) {
+            for (const auto& area : areas) {
+                if (x >= area.offset.x && x < area.offset.x + static_cast<int32_t>(area.extent.width)) {
+                    return true;
+                }
+            }
+            return false;
+        };
+        for (uint32_t y = 0; y < frontend.extent.height; y++) {
+            for (uint32_t x = 0; x < frontend.extent.width; x++) {
+                const uint8_t red = pixels[(y * frontend.extent.width + x) * 4];
+                INFO("pixel " << x << ", " << y);
+                REQUIRE(red == (covered(static_cast<int32_t>(x)) ? 255 : 0));
+            }
+        }
+    }
+}
@@ -0,0 +1,66 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <ifs/HeadlessSession.hpp>
+#include <ifs/Sweep.hpp>
+#include <ifs/frontends/ParticleRenderer.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <vector>
+
+using namespace ifs;
+
+TEST_CASE("Point LOD draws density points per covered pixel", "[lod]")
+{
+    // Orthographic unit square: NDC x,y equal the world x,y
+    const glm::mat4 identity(1.0f);
+    const std::vector<glm::vec3> quarter = {{-0.5f, -0.5f, 0.5f}, {0.5f, 0.5f, 0.5f}};
+
+    // Half the viewport on each axis: 50x50 of 100x100 pixels
+    REQUIRE(ParticleRenderer::lod_draw_count(quarter, identity, {100, 100}, 1'000'000, 4.0f) == 10000);
+
+    // Few particles: all of them
+    REQUIRE(ParticleRenderer::lod_draw_count(quarter, identity, {100, 100}, 5000, 4.0f) == 5000);
+
+    // Bounds are clipped to the viewport
+    const std::vector<glm::vec3> wide = {{-3.0f, -0.5f, 0.5f}, {3.0f, 0.5f, 0.5f}};
+    REQUIRE(ParticleRenderer::lod_draw_count(wide, identity, {100, 100}, 1'000'000, 1.0f) == 5000);
+
+    // A sample behind the camera, or no samples, can't bound the draw
+    const glm::mat4 perspective = glm::perspective(glm::radians(60.0f), 1.0f, 0.1f, 10.0f);
+    const std::vector<glm::vec3> behind = {{0.0f, 0.0f, -1.0f}, {0.0f, 0.0f, 1.0f}};
+    REQUIRE(ParticleRenderer::lod_draw_count(behind, perspective, {100, 100}, 1'000'000, 1.0f) == 1'000'000);
+    REQUIRE(ParticleRenderer::lod_draw_count({}, identity, {100, 100}, 1'000'000, 1.0f) == 1'000'000);
+
+    // A point-sized attractor still draws a pixel's worth
+    const std::vector<glm::vec3> point = {{0.0f, 0.0f, 0.5f}};
+    REQUIRE(ParticleRenderer::lod_draw_count(point, identity, {100, 100}, 1'000'000, 8.0f) == 8);
+}
+
+TEST_CASE("Point LOD draws a prefix that keeps the image", "[lod][vulkan]")
+{
+    auto session = HeadlessSession::create({.backend = "sierpinski", .frontend = "points", .width = 32, .height = 32});
+    REQUIRE(session);
+    auto* points = dynamic_cast<ParticleRenderer*>(&(*session)->frontend());
+    REQUIRE(points);
+
+    REQUIRE((*session)->set_parameter("particle_count", 500000));
+    REQUIRE((*session)->compute({.random_seed = 3}));
+    const uint32_t particle_count = (*session)->backend().get_particle_count();
+
+    REQUIRE((*session)->set_parameter("Point LOD", 0.0f));
+    auto full = (*session)->render();
+    REQUIRE(full);
+    REQUIRE(points->lod_drawn() == particle_count);
+    const auto reference = compute_image_statistics(full->pixels, full->width, full->height);
+
+    // The first frame copies the samples; the next one draws with them
+    REQUIRE((*session)->set_parameter("Point LOD", 1.0f));
+    REQUIRE((*session)->render());
+    auto reduced = (*session)->render();
+    REQUIRE(reduced);
+    REQUIRE(points->lod_drawn() < particle_count);
+    REQUIRE(points->lod_drawn() <= static_cast<uint32_t>(32 * 32 * points->lod_density()));
+
+    const auto stats = compute_image_statistics(reduced->pixels, reduced->width, reduced->height);
+    REQUIRE(stats.coverage == Catch::Approx(reference.coverage).margin(0.02));
+    REQUIRE(stats.mean_luminance == Catch::Approx(reference.mean_luminance).margin(0.02));
+}
@@ -0,0 +1,185 @@
+#include <catch2/catch_test_macros.hpp>
+#include <ifs/ParticleShare.hpp>
+#include <ifs/ReadbackBuffer.hpp>
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <vector>
+
+using namespace ifs;
+
+namespace {
+
+/// Record and run commands on the graphics queue, blocking until they complete
+void run_commands(const VulkanContext& context, const std::function<void(vk::CommandBuffer)>& record) {
+    auto device = context.device();
+    auto [pool_result, pool] = device.createCommandPool(
+        vk::CommandPoolCreateInfo({}, context.queue_indices().graphics));
+    REQUIRE(pool_result == vk::Result::eSuccess);
+    auto [alloc_result, cmds] = device.allocateCommandBuffers(
+        vk::CommandBufferAllocateInfo(pool, vk::CommandBufferLevel::ePrimary, 1));
+    REQUIRE(alloc_result == vk::Result::eSuccess);
+    auto [fence_result, fence] = device.createFence({});
+    REQUIRE(fence_result == vk::Result::eSuccess);
+
+    auto _ = cmds[0].begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+    record(cmds[0]);
+    auto _ = cmds[0].end();
+    auto _ = context.graphics_queue().submit(vk::SubmitInfo().setCommandBuffers(cmds[0]), fence);
+    REQUIRE(device.waitForFences(fence, vk::True, UINT64_MAX) == vk::Result::eSuccess);
+
+    device.destroyFence(fence);
+    device.destroyCommandPool(pool);
+}
+
+/// Write the buffer and release it to the importers, like a backend's compute
+void fill(const VulkanContext& context, const ParticleBuffer& buffer, float value) {
+    run_commands(context, [&](vk::CommandBuffer cmd) {
+        cmd.fillBuffer(buffer.buffer(), 0, VK_WHOLE_SIZE, std::bit_cast<uint32_t>(value));
+        auto release = vk::BufferMemoryBarrier()
+            .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+            .setSrcQueueFamilyIndex(context.queue_indices().graphics)
+            .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_EXTERNAL)
+            .setBuffer(buffer.buffer())
+            .setOffset(0)
+            .setSize(VK_WHOLE_SIZE);
+        cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eBottomOfPipe,
+                            {}, {}, release, {});
+    });
+}
+
+/// Connect while the server accepts on this thread
+std::expected<std::unique_ptr<ParticleShareClient>, std::string> connect(
+    const VulkanContext& context, ParticleShareServer& server) {
+    auto pending = std::async(std::launch::async, [&] {
+        return ParticleShareClient::connect(context, server.socket_path());
+    });
+    while (pending.wait_for(std::chrono::milliseconds(1)) != std::future_status::ready) {
+        server.poll();
+    }
+    return pending.get();
+}
+
+/// Copy the client's buffer to the host, inside a read
+std::vector<float> read_shared(const VulkanContext& context, ParticleShareClient& client) {
+    auto readback = ReadbackBuffer::create(context, client.particle_count() * sizeof(Particle));
+    REQUIRE(readback);
+    run_commands(context, [&](vk::CommandBuffer cmd) {
+        cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTransfer,
+                            {}, {}, client.acquire_barrier(context.queue_indices().graphics), {});
+        cmd.copyBuffer(client.buffer().buffer(), (*readback)->buffer(),
+                       vk::BufferCopy(0, 0, (*readback)->size()));
+    });
+    (*readback)->invalidate();
+
+    std::vector<float> values((*readback)->size() / sizeof(float));
+    std::memcpy(values.data(), (*readback)->data(), (*readback)->size());
+    return values;
+}
+
+} // anonymous namespace
+
+TEST_CASE("ParticleShare hands the particle buffer to another context", "[share][vulkan]")
+{
+    VulkanContext producer("Share Producer");
+    if (!producer.has_external_fd()) {
+        SKIP("VK_KHR_external_memory_fd or VK_KHR_external_semaphore_fd unsupported");
+    }
+    VulkanContext consumer("Share Consumer");
+
+    auto buffer = ParticleBuffer::create(producer, producer.device(), {.particle_count = 1024, .exportable = true});
+    REQUIRE(buffer);
+    REQUIRE(buffer->external());
+
+    auto server = ParticleShareServer::create(producer, std::filesystem::temp_directory_path() / "ifs_share_test.sock");
+    REQUIRE(server);
+    REQUIRE((*server)->publish(*buffer));
+    (*server)->begin_write();
+    fill(producer, *buffer, 1.5f);
+    (*server)->end_write();
+    REQUIRE((*server)->generation() == 1);
+
+    auto client = connect(consumer, **server);
+    REQUIRE(client);
+    REQUIRE((*server)->client_count() == 1);
+    REQUIRE((*client)->particle_count() == 1024);
+
+    SECTION("reads see the producer's writes")
+    {
+        auto generation = (*client)->begin_read();
+        REQUIRE(generation);
+        REQUIRE(*generation == 1);
+        auto values = read_shared(consumer, **client);
+        (*client)->end_read();
+        REQUIRE(values.size() == 1024 * sizeof(Particle) / sizeof(float));
+        REQUIRE(std::ranges::all_of(values, [](float v) { return v == 1.5f; }));
+
+        (*server)->begin_write();
+        fill(producer, *buffer, -2.0f);
+        (*server)->end_write();
+
+        generation = (*client)->begin_read();
+        REQUIRE(generation);
+        REQUIRE(*generation == 2);
+        values = read_shared(consumer, **client);
+        (*client)->end_read();
+        REQUIRE(values.front() == -2.0f);
+    }
+
+    SECTION("a reallocated buffer replaces the import")
+    {
+        const auto first_id = (*client)->buffer_id();
+        auto reallocated = ParticleBuffer::create(producer, producer.device(), {.particle_count = 2048, .exportable = true});
+        REQUIRE(reallocated);
+        REQUIRE((*server)->publish(*reallocated));
+
+        auto imported = (*client)->poll();
+        REQUIRE(imported);
+        REQUIRE(*imported);
+        REQUIRE((*client)->buffer_id() != first_id);
+        REQUIRE((*client)->particle_count() == 2048);
+
+        // Publishing the same allocation again sends nothing
+        REQUIRE((*server)->publish(*reallocated));
+        imported = (*client)->poll();
+        REQUIRE(imported);
+        REQUIRE_FALSE(*imported);
+    }
+
+    SECTION("a client stuck in a read is dropped instead of stalling writes")
+    {
+        REQUIRE((*client)->begin_read());
+        (*server)->begin_write(1'000'000);
+        (*server)->end_write();
+        REQUIRE((*server)->client_count() == 0);
+    }
+}
+
+TEST_CASE("ParticleShareServer only replaces sockets", "[share][vulkan]")
+{
+    VulkanContext context("Share Path");
+    if (!context.has_external_fd()) {
+        SKIP("VK_KHR_external_memory_fd or VK_KHR_external_semaphore_fd unsupported");
+    }
+
+    // A mistyped path to a regular file is an error, and the file survives
+    const auto path = std::filesystem::temp_directory_path() / "ifs_share_test.txt";
+    std::ofstream(path) << "user data";
+    REQUIRE_FALSE(ParticleShareServer::create(context, path));
+    REQUIRE(std::filesystem::is_regular_file(path));
+    REQUIRE(std::filesystem::file_size(path) == 9);
+    std::filesystem::remove(path);
+
+    // A socket left behind by a previous server is replaced, and removed with the new one
+    const auto socket_path = std::filesystem::temp_directory_path() / "ifs_share_path_test.sock";
+    {
+        auto first = ParticleShareServer::create(context, socket_path);
+        REQUIRE(first);
+        auto second = ParticleShareServer::create(context, socket_path);
+        REQUIRE(second);
+    }
+    REQUIRE_FALSE(std::filesystem::exists(socket_path));
+}
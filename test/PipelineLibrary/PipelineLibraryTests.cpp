@@ -0,0 +1,67 @@
+#include <catch2/catch_test_macros.hpp>
+#include <ifs/HeadlessSession.hpp>
+#include <ifs/PipelineLibrary.hpp>
+#include <ifs/frontends/SphereRenderer.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+using namespace ifs;
+
+TEST_CASE("Sphere pipeline variants share library parts", "[pipeline_library][vulkan]")
+{
+    auto session = HeadlessSession::create({.backend = "affine", .frontend = "spheres", .width = 64, .height = 64});
+    REQUIRE(session);
+    auto* spheres = dynamic_cast<SphereRenderer*>(&(*session)->frontend());
+    REQUIRE(spheres);
+    auto& library = spheres->pipeline_library();
+    REQUIRE(library.variant_count() >= 1);
+
+    if (!library.uses_libraries()) {
+        REQUIRE(library.part_count() == 0);
+        SKIP("VK_EXT_graphics_pipeline_library unavailable on this device");
+    }
+
+    // The variants differ in one or two parts; the rest are compiled once
+    REQUIRE(library.part_count() >= 4);
+    if (library.variant_count() > 1) {
+        REQUIRE(library.part_count() < 4 * library.variant_count());
+    }
+}
+
+TEST_CASE("Optimized pipelines replace the fast-linked ones without changing the image", "[pipeline_library][vulkan]")
+{
+    auto session = HeadlessSession::create({.backend = "affine", .frontend = "spheres", .width = 128, .height = 128});
+    REQUIRE(session);
+    auto* spheres = dynamic_cast<SphereRenderer*>(&(*session)->frontend());
+    REQUIRE(spheres);
+    auto& library = spheres->pipeline_library();
+
+    // One plain instanced draw, so both frames rasterize the same triangles in the same order
+    REQUIRE((*session)->set_parameter("particle_count", 20000));
+    REQUIRE((*session)->compute({.scale = 1.0f, .random_seed = 11}));
+    REQUIRE((*session)->set_parameter("Occlusion Culling", 0.0f));
+    REQUIRE((*session)->set_parameter("Sphere LOD", 0.0f));
+    spheres->set_sphere_radius(0.02f);
+
+    auto first = (*session)->render({});
+    REQUIRE(first);
+    const std::vector<uint8_t> reference(first->pixels, first->pixels + first->width * first->height * 4);
+
+    library.wait_optimized();
+    REQUIRE(library.optimized_count() == (library.uses_libraries() ? library.variant_count() : 0));
+
+    auto second = (*session)->render({});
+    REQUIRE(second);
+
+    // Link-time optimization may reorder floating-point math
+    size_t differing = 0;
+    for (size_t i = 0; i < reference.size(); i += 4) {
+        int largest = 0;
+        for (size_t c = 0; c < 3; c++) {
+            largest = std::max(largest, std::abs(int(reference[i + c]) - int(second->pixels[i + c])));
+        }
+        differing += largest > 2;
+    }
+    REQUIRE(differing <= reference.size() / 4 / 200);
+}
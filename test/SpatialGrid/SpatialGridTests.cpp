@@ -0,0 +1,91 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <ifs/HeadlessSession.hpp>
+#include <ifs/SpatialGrid.hpp>
+#include <glm/glm.hpp>
+#include <algorithm>
+
+using namespace ifs;
+
+namespace {
+
+SpatialQueryResult wait_result(SpatialGrid& grid) {
+    while (true) {
+        grid.wait_idle();
+        if (auto result = grid.poll()) {
+            return *result;
+        }
+    }
+}
+
+} // anonymous namespace
+
+TEST_CASE("SpatialGrid answers queries like a brute-force scan", "[spatial][vulkan]")
+{
+    auto session = HeadlessSession::create({.backend = "sierpinski", .frontend = "points", .width = 64, .height = 64});
+    REQUIRE(session);
+    REQUIRE((*session)->set_parameter("particle_count", 20000));
+    REQUIRE((*session)->compute({.random_seed = 7}));
+
+    // Leaves the particle buffer owned by the graphics queue, as the grid requires
+    auto particles = (*session)->read_particles();
+    REQUIRE(particles);
+
+    auto grid = SpatialGrid::create((*session)->context(), {.resolution = 64, .max_results = 32768});
+    REQUIRE(grid);
+    auto& backend = (*session)->backend();
+    REQUIRE((*grid)->build(backend.get_particle_buffer(), backend.get_particle_count()));
+    (*grid)->wait_idle();
+    REQUIRE((*grid)->ready());
+
+    const auto& info = (*grid)->info();
+    REQUIRE(info);
+    REQUIRE(info->dims.x == 64);
+    REQUIRE(info->dims.z == 1);  // Sierpinski2D is flat
+
+    const glm::vec3 center = particles->particles[123].position;
+
+    SECTION("radius query matches the CPU count")
+    {
+        const float radius = 0.05f;
+        uint32_t expected = 0;
+        for (uint32_t i = 0; i < particles->count; i++) {
+            glm::vec3 offset = particles->particles[i].position - center;
+            expected += glm::dot(offset, offset) <= radius * radius ? 1 : 0;
+        }
+
+        REQUIRE((*grid)->query_radius(center, radius));
+        auto result = wait_result(**grid);
+        REQUIRE(result.kind == SpatialQueryKind::Radius);
+        REQUIRE(result.total == expected);
+        REQUIRE(result.hits.size() == expected);
+        REQUIRE(std::ranges::any_of(result.hits, [](const SpatialHit& hit) { return hit.index == 123; }));
+    }
+
+    SECTION("nearest neighbours are sorted and start at the query point")
+    {
+        REQUIRE((*grid)->query_nearest(center, 8));
+        auto result = wait_result(**grid);
+        REQUIRE(result.kind == SpatialQueryKind::Nearest);
+        REQUIRE(result.hits.size() == 8);
+        REQUIRE_THAT(result.hits.front().distance, Catch::Matchers::WithinAbs(0.0, 1e-6));
+        REQUIRE(std::ranges::is_sorted(result.hits, {}, &SpatialHit::distance));
+    }
+
+    SECTION("a ray through a particle picks it")
+    {
+        const glm::vec3 origin = center + glm::vec3(0.0f, 0.0f, 2.0f);
+        REQUIRE((*grid)->pick(origin, glm::vec3(0.0f, 0.0f, -1.0f), 1e-4f));
+        auto result = wait_result(**grid);
+        REQUIRE(result.kind == SpatialQueryKind::Pick);
+        REQUIRE(result.hits.size() == 1);
+        REQUIRE_THAT(result.hits.front().distance, Catch::Matchers::WithinAbs(2.0, 1e-3));
+    }
+
+    SECTION("one query at a time")
+    {
+        REQUIRE((*grid)->query_radius(center, 0.01f));
+        REQUIRE_FALSE((*grid)->query_radius(center, 0.01f));
+        wait_result(**grid);
+    }
+}
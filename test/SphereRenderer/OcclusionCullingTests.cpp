@@ -0,0 +1,127 @@
+#include <catch2/catch_test_macros.hpp>
+#include <ifs/HeadlessSession.hpp>
+#include <ifs/OcclusionCuller.hpp>
+#include <ifs/backends/AffineIFS.hpp>
+#include <ifs/frontends/SphereRenderer.hpp>
+#include <vector>
+
+using namespace ifs;
+
+TEST_CASE("The depth pyramid halves each level down to one texel", "[occlusion]")
+{
+    auto levels = OcclusionCuller::pyramid_levels({64, 48});
+    REQUIRE(levels.size() == 7);
+    REQUIRE(levels[1] == vk::Extent2D(32, 24));
+    REQUIRE(levels[5] == vk::Extent2D(2, 2));
+    REQUIRE(levels.back() == vk::Extent2D(1, 1));
+
+    // Odd edges round up, so every pixel has a texel on every level
+    levels = OcclusionCuller::pyramid_levels({5, 3});
+    REQUIRE(levels == std::vector<vk::Extent2D>{{5, 3}, {3, 2}, {2, 1}, {1, 1}});
+
+    REQUIRE(OcclusionCuller::pyramid_levels({1, 1}).size() == 1);
+}
+
+TEST_CASE("Occlusion culling skips hidden spheres without changing the image", "[occlusion][vulkan]")
+{
+    auto session = HeadlessSession::create({.backend = "affine", .frontend = "spheres", .width = 128, .height = 128});
+    REQUIRE(session);
+    auto* backend = dynamic_cast<AffineIFS*>(&(*session)->backend());
+    auto* spheres = dynamic_cast<SphereRenderer*>(&(*session)->frontend());
+    REQUIRE(backend);
+    REQUIRE(spheres);
+    if (!spheres->occlusion_culling()) {
+        SKIP("Occlusion culling unavailable on this device");
+    }
+
+    // A dense sponge of large spheres: most of them are behind the front faces
+    REQUIRE(backend->set_definition(AffineIFSDefinition::menger_sponge()));
+    REQUIRE((*session)->set_parameter("particle_count", 50000));
+    REQUIRE((*session)->compute({.scale = 1.0f, .random_seed = 5}));
+    spheres->set_sphere_radius(0.04f);
+
+    REQUIRE((*session)->set_parameter("Occlusion Culling", 0.0f));
+    auto unculled = (*session)->render({});
+    REQUIRE(unculled);
+    const std::vector<uint8_t> reference(unculled->pixels, unculled->pixels + unculled->width * unculled->height * 4);
+
+    // The first culled frame has no previous pyramid; the second tests against it
+    REQUIRE((*session)->set_parameter("Occlusion Culling", 1.0f));
+    REQUIRE((*session)->render({}));
+    auto culled = (*session)->render({});
+    REQUIRE(culled);
+
+    // Equal-depth ties may resolve differently in the reordered draw list
+    size_t differing = 0;
+    for (size_t i = 0; i < reference.size(); i += 4) {
+        differing += reference[i] != culled->pixels[i] ||
+                     reference[i + 1] != culled->pixels[i + 1] ||
+                     reference[i + 2] != culled->pixels[i + 2];
+    }
+    REQUIRE(differing <= reference.size() / 4 / 200);
+
+    // Statistics are read back when the slot is reused, i.e. by the next frame
+    REQUIRE((*session)->render({}));
+    const auto* stats = spheres->occlusion_statistics();
+    REQUIRE(stats);
+    REQUIRE(stats->instance_count == 50000);
+    REQUIRE(stats->occluded > 0);
+    REQUIRE(stats->drawn() + stats->occluded <= stats->instance_count);
+    REQUIRE(stats->drawn() < stats->instance_count);
+}
+
+TEST_CASE("Sphere LOD bins instances by projected radius", "[occlusion][lod][vulkan]")
+{
+    auto session = HeadlessSession::create({.backend = "affine", .frontend = "spheres", .width = 128, .height = 128});
+    REQUIRE(session);
+    auto* spheres = dynamic_cast<SphereRenderer*>(&(*session)->frontend());
+    REQUIRE(spheres);
+    if (!spheres->sphere_lod()) {
+        SKIP("Sphere LOD unavailable on this device");
+    }
+
+    REQUIRE((*session)->set_parameter("particle_count", 20000));
+    REQUIRE((*session)->compute({.scale = 1.0f, .random_seed = 3}));
+    REQUIRE((*session)->set_parameter("Occlusion Culling", 0.0f));
+
+    // Statistics are read back when the slot is reused, i.e. by the next frame
+    auto lod_counts = [&](float radius) {
+        spheres->set_sphere_radius(radius);
+        for (int frame = 0; frame < 3; frame++) {
+            REQUIRE((*session)->render({}));
+        }
+        const auto* stats = spheres->occlusion_statistics();
+        REQUIRE(stats);
+        REQUIRE(stats->occluded == 0);
+        REQUIRE(stats->lod_count == SphereRenderer::LOD_COUNT);
+        uint32_t binned = 0;
+        for (uint32_t lod = 0; lod < stats->lod_count; lod++) {
+            binned += stats->lod_instances[lod];
+        }
+        REQUIRE(binned == stats->drawn());
+        REQUIRE(stats->drawn() > 0);
+        return *stats;
+    };
+
+    SECTION("the meshes refine with the radius limit")
+    {
+        REQUIRE((*session)->render({}));
+        auto lods = spheres->lod_meshes();
+        REQUIRE(lods.size() == SphereRenderer::LOD_COUNT);
+        REQUIRE(lods[0].index_count == 1);
+        REQUIRE(lods[1].index_count == 24);
+        for (uint32_t lod = 2; lod < lods.size(); lod++) {
+            REQUIRE(lods[lod].index_count == 60u << (2 * (lod - 2)));
+            REQUIRE(lods[lod].max_radius > lods[lod - 1].max_radius);
+        }
+    }
+
+    SECTION("tiny spheres are all points, larger ones use finer meshes")
+    {
+        auto tiny = lod_counts(1e-5f);
+        REQUIRE(tiny.lod_instances[0] == tiny.drawn());
+
+        auto large = lod_counts(0.05f);
+        REQUIRE(large.lod_instances[0] < large.drawn());
+    }
+}
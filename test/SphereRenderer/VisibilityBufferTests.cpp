@@ -0,0 +1,165 @@
+#include <catch2/catch_test_macros.hpp>
+#include <ifs/Camera3D.hpp>
+#include <ifs/HeadlessSession.hpp>
+#include <ifs/OffscreenTarget.hpp>
+#include <ifs/backends/AffineIFS.hpp>
+#include <ifs/frontends/SphereRenderer.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+using namespace ifs;
+
+TEST_CASE("Visibility-buffer shading matches forward shading", "[visibility][vulkan]")
+{
+    auto session = HeadlessSession::create({.backend = "affine", .frontend = "spheres", .width = 128, .height = 128});
+    REQUIRE(session);
+    auto* backend = dynamic_cast<AffineIFS*>(&(*session)->backend());
+    auto* spheres = dynamic_cast<SphereRenderer*>(&(*session)->frontend());
+    REQUIRE(backend);
+    REQUIRE(spheres);
+    spheres->set_visibility_shading(true);
+    if (!spheres->visibility_shading()) {
+        SKIP("Visibility buffer unavailable on this device");
+    }
+
+    // Overlapping spheres, so most pixels are covered several times
+    REQUIRE(backend->set_definition(AffineIFSDefinition::menger_sponge()));
+    REQUIRE((*session)->set_parameter("particle_count", 20000));
+    REQUIRE((*session)->compute({.scale = 1.0f, .random_seed = 7}));
+    spheres->set_sphere_radius(0.03f);
+
+    auto render = [&](bool visibility) {
+        REQUIRE((*session)->set_parameter("Visibility Buffer", visibility ? 1.0f : 0.0f));
+        REQUIRE((*session)->render({}));
+        auto frame = (*session)->render({});
+        REQUIRE(frame);
+        return std::vector<uint8_t>(frame->pixels, frame->pixels + frame->width * frame->height * 4);
+    };
+
+    auto check = [&] {
+        const auto forward = render(false);
+        const auto deferred = render(true);
+        REQUIRE(forward.size() == deferred.size());
+
+        // The forward pass lights the interpolated mesh normal, the shading pass the
+        // exact sphere normal: small differences everywhere, large ones only on edges
+        size_t differing = 0;
+        size_t covered = 0;
+        for (size_t i = 0; i < forward.size(); i += 4) {
+            int largest = 0;
+            for (size_t c = 0; c < 3; c++) {
+                largest = std::max(largest, std::abs(int(forward[i + c]) - int(deferred[i + c])));
+            }
+            differing += largest > 32;
+            covered += forward[i] != forward[0] || forward[i + 1] != forward[1] || forward[i + 2] != forward[2];
+        }
+        REQUIRE(covered > 0);
+        REQUIRE(differing <= forward.size() / 4 / 50);
+    };
+
+    SECTION("every instance with one mesh")
+    {
+        REQUIRE((*session)->set_parameter("Occlusion Culling", 0.0f));
+        REQUIRE((*session)->set_parameter("Sphere LOD", 0.0f));
+        check();
+    }
+
+    SECTION("culled LOD buckets")
+    {
+        if (!spheres->sphere_lod()) {
+            SKIP("Sphere LOD unavailable on this device");
+        }
+        check();
+    }
+}
+
+TEST_CASE("Spheres drawn after the composite test against its depth", "[visibility][vulkan]")
+{
+    auto session = HeadlessSession::create({.backend = "affine", .frontend = "spheres", .width = 128, .height = 128});
+    REQUIRE(session);
+    auto* backend = dynamic_cast<AffineIFS*>(&(*session)->backend());
+    auto* spheres = dynamic_cast<SphereRenderer*>(&(*session)->frontend());
+    REQUIRE(backend);
+    REQUIRE(spheres);
+    spheres->set_visibility_shading(true);
+    if (!spheres->visibility_shading()) {
+        SKIP("Visibility buffer unavailable on this device");
+    }
+
+    REQUIRE(backend->set_definition(AffineIFSDefinition::menger_sponge()));
+    REQUIRE((*session)->set_parameter("particle_count", 20000));
+    REQUIRE((*session)->compute({.scale = 1.0f, .random_seed = 7}));
+    spheres->set_sphere_radius(0.03f);
+    REQUIRE((*session)->set_parameter("Occlusion Culling", 0.0f));
+    REQUIRE((*session)->set_parameter("Sphere LOD", 0.0f));
+    REQUIRE((*session)->render({}));  // Acquires the particle buffer for graphics
+
+    // A target of the same shape as the session's, so the frontend's pipelines draw into it
+    const auto& context = (*session)->context();
+    auto target = OffscreenTarget::create(context, {128, 128}, 1);
+    REQUIRE(target);
+    Camera3D camera;
+    camera.handle_resize(128, 128);
+
+    auto device = context.device();
+    auto [pool_result, pool] = device.createCommandPool(
+        vk::CommandPoolCreateInfo({}, context.queue_indices().graphics));
+    REQUIRE(pool_result == vk::Result::eSuccess);
+    auto [fence_result, fence] = device.createFence({});
+    REQUIRE(fence_result == vk::Result::eSuccess);
+
+    // One frame with the visibility pass; draw_again runs the forward draw after the composite
+    auto render = [&](bool draw_again) {
+        auto [alloc_result, cmds] = device.allocateCommandBuffers(
+            vk::CommandBufferAllocateInfo(pool, vk::CommandBufferLevel::ePrimary, 1));
+        REQUIRE(alloc_result == vk::Result::eSuccess);
+        auto cmd = cmds[0];
+        const auto buffer = backend->get_particle_buffer();
+        const auto count = backend->get_particle_count();
+        const auto clear_values = (*target)->clear_values();
+
+        auto _ = cmd.begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+        spheres->record_pre_pass(cmd, buffer, count, camera, (*target)->extent());
+        cmd.beginRenderPass(vk::RenderPassBeginInfo()
+            .setRenderPass((*target)->render_pass())
+            .setFramebuffer((*target)->framebuffer())
+            .setRenderArea(vk::Rect2D({0, 0}, (*target)->extent()))
+            .setClearValues(clear_values), vk::SubpassContents::eInline);
+        spheres->render(cmd, buffer, count, camera, &(*target)->extent());
+        if (draw_again) {
+            // The composite used up the shaded frame, so this draws every sphere forward
+            spheres->render(cmd, buffer, count, camera, &(*target)->extent());
+        }
+        cmd.endRenderPass();
+        (*target)->record_readback(cmd, 0);
+        auto _ = cmd.end();
+        auto _ = context.graphics_queue().submit(vk::SubmitInfo().setCommandBuffers(cmd), fence);
+        REQUIRE(device.waitForFences(fence, vk::True, UINT64_MAX) == vk::Result::eSuccess);
+        REQUIRE(device.resetFences(fence) == vk::Result::eSuccess);
+        device.freeCommandBuffers(pool, cmd);
+
+        const auto* pixels = (*target)->pixels(0);
+        return std::vector<uint8_t>(pixels, pixels + (*target)->image_size());
+    };
+
+    const auto composited = render(false);
+    const auto redrawn = render(true);
+
+    // The forward spheres lie at the composited depth, not in front of it, so the
+    // less-than test rejects them and the deferred shading stays; without the
+    // composite's depth they would overwrite every covered pixel
+    size_t covered = 0;
+    size_t differing = 0;
+    for (size_t i = 0; i < composited.size(); i += 4) {
+        covered += composited[i] != composited[0] || composited[i + 1] != composited[1] ||
+                   composited[i + 2] != composited[2];
+        differing += composited[i] != redrawn[i] || composited[i + 1] != redrawn[i + 1] ||
+                     composited[i + 2] != redrawn[i + 2];
+    }
+    REQUIRE(covered > 0);
+    REQUIRE(differing <= covered / 50);
+
+    device.destroyFence(fence);
+    device.destroyCommandPool(pool);
+}
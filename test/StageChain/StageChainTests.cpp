@@ -0,0 +1,130 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <ifs/HeadlessSession.hpp>
+#include <ifs/StageChain.hpp>
+#include <ifs/backends/AffineIFS.hpp>
+#include <algorithm>
+#include <cmath>
+
+using namespace ifs;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+
+// CPU mirror of Spherical in stages.slang
+glm::vec3 invert_sphere(glm::vec3 p) {
+    const glm::vec3 q = p - glm::vec3(0.5f);
+    return q * (0.25f / std::max(glm::dot(q, q), 1e-12f)) + glm::vec3(0.5f);
+}
+
+} // anonymous namespace
+
+TEST_CASE("StageChain names the specialized kernel", "[stages]")
+{
+    StageChain chain;
+    REQUIRE(chain.specialization() == std::vector<std::string>{"GlobalScale", "OrbitColor", "WriteParticle"});
+
+    chain.post = {PostStage::FinalAffine, PostStage::Swirl, PostStage::GlobalScale};
+    chain.color = ColorStage::PositionPalette;
+    chain.write = WriteStage::Position;
+    REQUIRE(chain.specialization() == std::vector<std::string>{
+        "Then<FinalAffine, Then<Swirl, GlobalScale>>", "PositionPalette", "WritePosition"});
+    REQUIRE(chain.describe() == "FinalAffine > Swirl > GlobalScale | PositionPalette | WritePosition");
+
+    chain.post.clear();
+    REQUIRE(chain.specialization().front() == "NoPost");
+    REQUIRE(chain.describe() == "NoPost | PositionPalette | WritePosition");
+}
+
+TEST_CASE("make_stage_params packs the final transform and its inverse", "[stages]")
+{
+    StageSettings settings;
+    settings.final_linear = glm::mat3(glm::vec3(2.0f, 0.0f, 0.0f), glm::vec3(1.0f, 0.5f, 0.0f), glm::vec3(0.0f, 0.0f, 4.0f));
+    settings.final_offset = glm::vec3(0.1f, -0.2f, 0.3f);
+    auto params = make_stage_params(settings, 0.0f);
+    REQUIRE(params.scale == 1.0f);  // A zero scale would not be invertible
+    REQUIRE(params.swirl == settings.swirl);
+
+    const glm::vec3 p(0.3f, 0.7f, -0.4f);
+    auto apply = [](const glm::vec4 (&rows)[3], glm::vec3 v) {
+        const glm::vec4 h(v, 1.0f);
+        return glm::vec3(glm::dot(rows[0], h), glm::dot(rows[1], h), glm::dot(rows[2], h));
+    };
+    const glm::vec3 forward = apply(params.final_rows, p);
+    const glm::vec3 expected = settings.final_linear * p + settings.final_offset;
+    const glm::vec3 back = apply(params.final_inverse, forward);
+    for (int i = 0; i < 3; i++) {
+        REQUIRE_THAT(forward[i], WithinAbs(expected[i], 1e-5));
+        REQUIRE_THAT(back[i], WithinAbs(p[i], 1e-5));
+    }
+}
+
+TEST_CASE("AffineIFS runs a fused final transform", "[stages][vulkan]")
+{
+    auto session = HeadlessSession::create({.backend = "affine", .frontend = "points", .width = 64, .height = 64});
+    REQUIRE(session);
+    auto* backend = dynamic_cast<AffineIFS*>(&(*session)->backend());
+    REQUIRE(backend);
+    REQUIRE((*session)->set_parameter("particle_count", 20000));
+    REQUIRE(backend->set_definition(AffineIFSDefinition::sierpinski_triangle()));
+
+    REQUIRE(backend->set_stage_chain({.post = {PostStage::Spherical, PostStage::GlobalScale}}));
+    REQUIRE(backend->stage_chain().describe() == "Spherical > GlobalScale | OrbitColor | WriteParticle");
+    REQUIRE((*session)->compute({.scale = 1.0f, .random_seed = 1}));
+
+    // Warm start at another scale: the kernel undoes the previous chain before continuing
+    backend->set_warm_start(4);
+    REQUIRE((*session)->compute({.scale = 2.0f, .random_seed = 1}));
+    REQUIRE(backend->last_compute_was_warm());
+
+    auto particles = (*session)->read_particles();
+    REQUIRE(particles);
+    for (uint32_t i = 0; i < particles->count; i++) {
+        const auto& p = particles->particles[i].position;
+        REQUIRE(std::isfinite(p.x));
+        // The triangle lies in z = 0, outside the sphere; inverted, it is inside
+        const glm::vec3 inverted = (p - glm::vec3(0.5f)) / 2.0f + glm::vec3(0.5f);
+        REQUIRE(glm::length(inverted - glm::vec3(0.5f)) <= 0.5f + 1e-4f);
+        const glm::vec3 orbit = invert_sphere(inverted);
+        REQUIRE_THAT(orbit.z, WithinAbs(0.0, 1e-3));
+        REQUIRE(orbit.x >= -1e-3f);
+        REQUIRE(orbit.x <= 1.0f + 1e-3f);
+        REQUIRE(orbit.y >= -1e-3f);
+        REQUIRE(orbit.y <= 1.0f + 1e-3f);
+    }
+}
+
+TEST_CASE("Compact particles carry the transform history", "[stages][vulkan]")
+{
+    REQUIRE(StageChain{.color = ColorStage::History, .write = WriteStage::Indexed}.specialization()
+            == std::vector<std::string>{"GlobalScale", "HistoryColor", "WriteIndexed"});
+
+    auto session = HeadlessSession::create({.backend = "affine", .frontend = "points", .width = 64, .height = 64});
+    REQUIRE(session);
+    auto* backend = dynamic_cast<AffineIFS*>(&(*session)->backend());
+    REQUIRE(backend);
+    REQUIRE((*session)->set_parameter("particle_count", 20000));
+    REQUIRE(backend->set_definition(AffineIFSDefinition::sierpinski_triangle()));
+    REQUIRE(backend->set_stage_chain({.color = ColorStage::History, .write = WriteStage::Indexed}));
+    REQUIRE((*session)->compute({.scale = 1.0f, .random_seed = 1}));
+
+    auto particles = (*session)->read_particles();
+    REQUIRE(particles);
+    uint32_t checked = 0;
+    for (uint32_t i = 0; i < particles->count; i++) {
+        const auto& particle = particles->particles[i];
+        REQUIRE((particle.palette_index & particle_palette_indexed) != 0);
+        REQUIRE(particle_color(particle).a == 1.0f);
+
+        // The first base-3 digit is the last map applied, i.e. the corner triangle the point is in
+        const float digits = 3.0f * static_cast<float>(particle.palette_index & 0xffffu) / 65536.0f;
+        const auto& p = particle.position;
+        if (std::abs(digits - std::round(digits)) < 1e-3f || std::abs(p.y - 0.433f) < 1e-3f || std::abs(p.x - 0.5f) < 1e-3f) {
+            continue;  // On a boundary
+        }
+        const int corner = p.y > 0.433f ? 2 : p.x > 0.5f ? 1 : 0;
+        REQUIRE(static_cast<int>(digits) == corner);
+        checked++;
+    }
+    REQUIRE(checked > particles->count / 2);
+}
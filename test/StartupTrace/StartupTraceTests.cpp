@@ -0,0 +1,49 @@
+#include <catch2/catch_test_macros.hpp>
+#include <ifs/StartupTrace.hpp>
+#include <thread>
+
+using namespace ifs;
+
+TEST_CASE("StartupTrace records phases until finished", "[startup]")
+{
+    StartupTrace trace;
+    MetricsRegistry registry;
+
+    {
+        auto _ = trace.phase("first");
+    }
+    std::thread worker([&trace] {
+        auto _ = trace.phase("worker");
+    });
+    worker.join();
+    {
+        auto _ = trace.phase("second");
+    }
+
+    SECTION("phases are ordered and tagged by thread")
+    {
+        auto phases = trace.phases();
+        REQUIRE(phases.size() == 3);
+        REQUIRE(phases[0].name == "first");
+        REQUIRE(phases[0].main_thread);
+        REQUIRE(phases[1].name == "worker");
+        REQUIRE_FALSE(phases[1].main_thread);
+        REQUIRE(phases[2].name == "second");
+        REQUIRE(phases[0].begin_ms <= phases[2].begin_ms);
+    }
+
+    SECTION("finish publishes metrics and stops recording")
+    {
+        double first_frame_ms = trace.finish(registry);
+        REQUIRE(trace.finished());
+        REQUIRE(first_frame_ms >= 0.0);
+        REQUIRE(registry.gauge("ifs_time_to_first_frame_ms").value() == first_frame_ms);
+        REQUIRE(registry.snapshot().size() == 4);
+
+        {
+            auto _ = trace.phase("after");
+        }
+        REQUIRE(trace.phases().size() == 3);
+        REQUIRE(trace.finish(registry) == first_frame_ms);
+    }
+}
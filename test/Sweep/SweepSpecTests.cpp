@@ -0,0 +1,107 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+#include <ifs/Sweep.hpp>
+#include <vector>
+
+using namespace ifs;
+using Catch::Matchers::WithinAbs;
+using Catch::Matchers::ContainsSubstring;
+
+TEST_CASE("Sweep spec expands lists into a cartesian product", "[sweep]")
+{
+    auto jobs = parse_sweep_spec(
+        "# comment\n"
+        "\n"
+        "name=fern seed=1..2 scale=0.5,2 param.Iteration_Count=50\n"
+        "seed=7 camera.azimuth=0:90:3\n");
+    REQUIRE(jobs);
+    REQUIRE(jobs->size() == 7);
+
+    SECTION("first key varies slowest")
+    {
+        REQUIRE((*jobs)[0].name == "fern_0000");
+        REQUIRE((*jobs)[0].params.random_seed == 1);
+        REQUIRE((*jobs)[0].params.scale == 0.5f);
+        REQUIRE((*jobs)[1].params.random_seed == 1);
+        REQUIRE((*jobs)[1].params.scale == 2.0f);
+        REQUIRE((*jobs)[2].params.random_seed == 2);
+        REQUIRE((*jobs)[3].name == "fern_0003");
+    }
+
+    SECTION("UI parameters are carried as settings")
+    {
+        REQUIRE((*jobs)[0].settings.size() == 1);
+        REQUIRE((*jobs)[0].settings[0].first == "Iteration_Count");
+        REQUIRE((*jobs)[0].settings[0].second == 50.0f);
+    }
+
+    SECTION("linspace and default names")
+    {
+        REQUIRE((*jobs)[4].name == "job4_0000");
+        REQUIRE((*jobs)[4].params.random_seed == 7);
+        REQUIRE_THAT(*(*jobs)[4].camera.azimuth, WithinAbs(0.0, 1e-6));
+        REQUIRE_THAT(*(*jobs)[5].camera.azimuth, WithinAbs(45.0, 1e-6));
+        REQUIRE_THAT(*(*jobs)[6].camera.azimuth, WithinAbs(90.0, 1e-6));
+        REQUIRE_FALSE((*jobs)[4].camera.distance);
+    }
+}
+
+TEST_CASE("Single-job lines keep their name", "[sweep]")
+{
+    auto jobs = parse_sweep_spec("name=single seed=3 camera.target_z=1");
+    REQUIRE(jobs);
+    REQUIRE(jobs->size() == 1);
+    REQUIRE((*jobs)[0].name == "single");
+    REQUIRE((*jobs)[0].camera.target);
+    REQUIRE((*jobs)[0].camera.target->z == 1.0f);
+}
+
+TEST_CASE("Sweep spec errors name the line", "[sweep]")
+{
+    auto unknown = parse_sweep_spec("seed=1\nbogus=2\n");
+    REQUIRE_FALSE(unknown);
+    REQUIRE_THAT(unknown.error(), ContainsSubstring("line 2") && ContainsSubstring("bogus"));
+
+    auto bad_range = parse_sweep_spec("seed=5..1");
+    REQUIRE_FALSE(bad_range);
+    REQUIRE_THAT(bad_range.error(), ContainsSubstring("line 1"));
+
+    REQUIRE_FALSE(parse_sweep_spec("scale=abc"));
+    REQUIRE_FALSE(parse_sweep_spec("scale=0:1"));
+    REQUIRE_FALSE(parse_sweep_spec("seed"));
+    REQUIRE_FALSE(parse_sweep_spec("name=a seed=1\nname=a seed=2\n"));
+
+    // Names stay inside the output directory
+    auto escaping = parse_sweep_spec("seed=1\nname=../out seed=2\n");
+    REQUIRE_FALSE(escaping);
+    REQUIRE_THAT(escaping.error(), ContainsSubstring("line 2"));
+    REQUIRE_FALSE(parse_sweep_spec("name=runs/a"));
+    REQUIRE_FALSE(parse_sweep_spec("name=runs\\a"));
+    REQUIRE_FALSE(parse_sweep_spec("name=.."));
+}
+
+TEST_CASE("Image statistics cover non-black pixels", "[sweep]")
+{
+    // 4x2 image with two white pixels at (1,0) and (2,1)
+    std::vector<uint8_t> rgba(4 * 2 * 4, 0);
+    for (auto index : {1u, 6u}) {
+        rgba[index * 4 + 0] = 255;
+        rgba[index * 4 + 1] = 255;
+        rgba[index * 4 + 2] = 255;
+        rgba[index * 4 + 3] = 255;
+    }
+
+    auto stats = compute_image_statistics(rgba.data(), 4, 2);
+    REQUIRE_THAT(stats.coverage, WithinAbs(0.25, 1e-9));
+    REQUIRE_THAT(stats.mean_luminance, WithinAbs(0.25, 1e-6));
+    REQUIRE(stats.min_x == 1);
+    REQUIRE(stats.min_y == 0);
+    REQUIRE(stats.max_x == 2);
+    REQUIRE(stats.max_y == 1);
+
+    std::vector<uint8_t> black(16, 0);
+    auto empty = compute_image_statistics(black.data(), 2, 2);
+    REQUIRE(empty.coverage == 0.0);
+    REQUIRE(empty.max_x == 0);
+}
@@ -73,6 +73,17 @@ TEST_CASE("VulkanContext queue indices are reasonable", "[vulkan]")
         auto flags = queue_families[indices.compute].queueFlags;
         REQUIRE((flags & vk::QueueFlagBits::eCompute));
     }
+
+    SECTION("every queue of the compute family is exposed")
+    {
+        REQUIRE(indices.compute_queue_count == queue_families[indices.compute].queueCount);
+        REQUIRE(ctx.compute_queues().size() == indices.compute_queue_count);
+        for (auto queue : ctx.compute_queues())
+        {
+            REQUIRE(queue);
+        }
+        REQUIRE(ctx.compute_queues().front() == ctx.compute_queue());
+    }
 }
 
 TEST_CASE("VulkanContext physical device properties", "[vulkan]")